@@ -79,6 +79,10 @@
 #include "E3GeometryTriangle.h"
 #include "E3GeometryTriGrid.h"
 #include "E3GeometryTriMesh.h"
+#include "E3Trace.h"
+
+#include <map>
+#include <cstring>
 
 
 
@@ -88,6 +92,34 @@
 //      Internal constants
 //-----------------------------------------------------------------------------
 #define		kWorldSpaceTolerance	1.0e-5f
+#define		kMaxGeometryTemplates	256
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+struct E3GeometryTemplateLess
+{
+	bool	operator()( const TE3GeometryTemplateKey& a, const TE3GeometryTemplateKey& b ) const
+			{
+				return memcmp( &a, &b, sizeof(TE3GeometryTemplateKey) ) < 0;
+			}
+};
+
+typedef std::map< TE3GeometryTemplateKey, TQ3Object, E3GeometryTemplateLess >	E3GeometryTemplateMap;
+
+
+
+
+
+//=============================================================================
+//      Internal variables
+//-----------------------------------------------------------------------------
+static E3GeometryTemplateMap	sGeometryTemplates;
+static TQ3Uns32					sDecomposeDepth = 0;
 
 
 
@@ -629,6 +661,15 @@ e3geometry_cache_update(TQ3ViewObject theView,
 	// If we can create a cached geometry, create it
 	if ( theClass->cacheNew != nullptr )
 	{
+		Q3_TRACE_SCOPE_TYPE( "CacheRebuild", objectType );
+		
+		TQ3ViewFrameStatistics* frameStatistics = E3View_AccessFrameStatistics( theView );
+		if ( frameStatistics != nullptr )
+		{
+			frameStatistics->cacheRebuilds++;
+			E3View_AccessFrameTypeStatistics( theView, objectType )->cacheRebuilds++;
+		}
+
 		try
 		{
 			*cachedGeom = theClass->cacheNew( theView, theGeom, geomData );
@@ -649,6 +690,28 @@ e3geometry_cache_update(TQ3ViewObject theView,
 
 
 
+//=============================================================================
+//      e3geometry_templates_flush : Release the shared tessellation templates.
+//-----------------------------------------------------------------------------
+//		Note :	Geometry caches which use a template hold their own reference,
+//				so flushing only drops the shared copy.
+//-----------------------------------------------------------------------------
+static void
+e3geometry_templates_flush( void )
+{
+	for (E3GeometryTemplateMap::iterator i = sGeometryTemplates.begin();
+		i != sGeometryTemplates.end(); ++i)
+	{
+		Q3Object_Dispose( i->second );
+	}
+	
+	sGeometryTemplates.clear();
+}
+
+
+
+
+
 //=============================================================================
 //      e3geometry_metahandler : Geometry metahandler.
 //-----------------------------------------------------------------------------
@@ -805,6 +868,11 @@ E3Geometry_UnregisterClass(void)
 
 
 
+	// Release the templates while the TriMesh class still exists
+	e3geometry_templates_flush();
+
+
+
 	// Unregister the geometry classes
 	E3GeometryBox_UnregisterClass();
 	E3GeometryCone_UnregisterClass();
@@ -958,7 +1026,14 @@ E3Geometry_GetDecomposed( TQ3GeometryObject theGeom, TQ3ViewObject view )
 
 
 	// Build the decomposed object
-	return cacheNew ( view, theGeom, leafInstanceData ) ;
+	//
+	// The caller owns the result and may edit it, so it must not contain any
+	// shared templates.
+	sDecomposeDepth++;
+	TQ3Object theDecomposed = cacheNew ( view, theGeom, leafInstanceData ) ;
+	sDecomposeDepth--;
+
+	return theDecomposed ;
 	}
 
 
@@ -1034,3 +1109,173 @@ E3Geometry_IsOfMyClass ( TQ3Object object )
 		
 	return kQ3False ;
 	}
+
+
+
+
+
+//=============================================================================
+//      E3Geometry_CanShareTemplates : Can a cache use shared templates?
+//-----------------------------------------------------------------------------
+//		Note :	Decomposed geometry is returned to the application, so it must
+//				be built from private objects.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Geometry_CanShareTemplates( void )
+{
+	return (sDecomposeDepth == 0) ? kQ3True : kQ3False;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Geometry_GetTemplateFrame : Find the frame of a quadric template.
+//-----------------------------------------------------------------------------
+//		Note :	Templates are built with an origin of 0, a major radius of
+//				(1, 0, 0), a minor radius of (0, 1, 0), and an orientation of
+//				(0, 0, 1) if the axes are right-handed or (0, 0, -1) if not.
+//
+//				The matrix maps the template into the local frame. Its
+//				determinant is always positive, so the vertex and face normals
+//				of the template transform to those of the original surface.
+//
+//				Returns kQ3True if the axes are right-handed.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Geometry_GetTemplateFrame( const TQ3Point3D* origin, const TQ3Vector3D* orientation,
+							const TQ3Vector3D* majorRadius, const TQ3Vector3D* minorRadius,
+							TQ3Matrix4x4* templateToLocal )
+{
+	TQ3Vector3D		majXMinor;
+	TQ3Boolean		isRightHanded;
+	float			orientSign;
+
+
+
+	// Find the handedness of the axes
+	Q3FastVector3D_Cross( majorRadius, minorRadius, &majXMinor );
+	isRightHanded = (Q3FastVector3D_Dot( &majXMinor, orientation ) > 0.0f) ? kQ3True : kQ3False;
+	orientSign    = isRightHanded ? 1.0f : -1.0f;
+
+
+
+	// Map the template axes onto ours
+	templateToLocal->value[0][0] = majorRadius->x;
+	templateToLocal->value[0][1] = majorRadius->y;
+	templateToLocal->value[0][2] = majorRadius->z;
+	templateToLocal->value[0][3] = 0.0f;
+
+	templateToLocal->value[1][0] = minorRadius->x;
+	templateToLocal->value[1][1] = minorRadius->y;
+	templateToLocal->value[1][2] = minorRadius->z;
+	templateToLocal->value[1][3] = 0.0f;
+
+	templateToLocal->value[2][0] = orientSign * orientation->x;
+	templateToLocal->value[2][1] = orientSign * orientation->y;
+	templateToLocal->value[2][2] = orientSign * orientation->z;
+	templateToLocal->value[2][3] = 0.0f;
+
+	templateToLocal->value[3][0] = origin->x;
+	templateToLocal->value[3][1] = origin->y;
+	templateToLocal->value[3][2] = origin->z;
+	templateToLocal->value[3][3] = 1.0f;
+
+	return isRightHanded;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Geometry_FindTemplate : Find a shared tessellation template.
+//-----------------------------------------------------------------------------
+//		Note :	Returns a new reference to the template, or nullptr if it has
+//				not been built yet.
+//-----------------------------------------------------------------------------
+TQ3Object
+E3Geometry_FindTemplate( const TE3GeometryTemplateKey* theKey )
+{
+	E3GeometryTemplateMap::iterator		theItem = sGeometryTemplates.find( *theKey );
+
+	if (theItem == sGeometryTemplates.end())
+		return nullptr;
+
+	return Q3Shared_GetReference( theItem->second );
+}
+
+
+
+
+
+//=============================================================================
+//      E3Geometry_AddTemplate : Share a tessellation template.
+//-----------------------------------------------------------------------------
+//		Note :	The keys include the u/v limits of the surface, so a geometry
+//				whose limits are animated would fill the table without bound.
+//				Once the table is full we start again, which only costs the
+//				time to rebuild the templates which are still being drawn.
+//-----------------------------------------------------------------------------
+void
+E3Geometry_AddTemplate( const TE3GeometryTemplateKey* theKey, TQ3Object theTemplate )
+{
+	Q3_ASSERT( sGeometryTemplates.find( *theKey ) == sGeometryTemplates.end() );
+
+
+
+	// Make space for the template
+	if (sGeometryTemplates.size() >= kMaxGeometryTemplates)
+		e3geometry_templates_flush();
+
+
+
+	// And save a reference to it
+	sGeometryTemplates[ *theKey ] = Q3Shared_GetReference( theTemplate );
+}
+
+
+
+
+
+//=============================================================================
+//      E3Geometry_NewTemplateInstance : Create an instance of a template.
+//-----------------------------------------------------------------------------
+//		Note :	The instance is a display group holding the attributes of the
+//				part, the transform from the template frame, and the template.
+//				Since the group is not inline, the transform does not affect
+//				any other parts of the cached geometry.
+//-----------------------------------------------------------------------------
+TQ3GroupObject
+E3Geometry_NewTemplateInstance( TQ3Object theTemplate, const TQ3Matrix4x4* templateToLocal,
+								TQ3AttributeSet theAttributes )
+{
+	TQ3TransformObject		theTransform;
+	TQ3GroupObject			theGroup;
+
+
+
+	// Create the group
+	theGroup = Q3DisplayGroup_New();
+	if (theGroup == nullptr)
+		return nullptr;
+
+
+
+	// Add the attributes, transform, and template
+	if (theAttributes != nullptr)
+		Q3Group_AddObject( theGroup, theAttributes );
+
+	theTransform = Q3MatrixTransform_New( templateToLocal );
+	if (theTransform == nullptr)
+	{
+		Q3Object_Dispose( theGroup );
+		return nullptr;
+	}
+
+	Q3Group_AddObjectAndDispose( theGroup, &theTransform );
+	Q3Group_AddObject( theGroup, theTemplate );
+
+	return theGroup;
+}
@@ -101,6 +101,23 @@ struct E3GeometryData
 
 
 
+// Tessellation template key
+//
+// Quadrics which are an affine image of a canonical shape can share one
+// tessellation of that shape. The key holds everything which changes the
+// triangulation, and must be cleared before it is filled in so that it can
+// be compared bytewise.
+typedef struct TE3GeometryTemplateKey {
+	TQ3ObjectType				geomType;
+	TQ3Uns32					partType;
+	TQ3Uns32					uSegments;
+	TQ3Uns32					vSegments;
+	TQ3Uns32					theFlags;
+	float						theParams[5];
+} TE3GeometryTemplateKey;
+
+
+
 // This prototype needs to precede the friend declaration in E3Geometry to make some
 // compilers happy.
 TQ3Status			E3Geometry_RegisterClass(void);
@@ -148,6 +165,19 @@ TQ3Boolean			E3Geometry_IsDegenerateTriple( const TQ3Vector3D* orientation,
 												const TQ3Vector3D* minorAxis );
 TQ3Boolean			E3Geometry_IsOfMyClass ( TQ3Object object ) ;
 
+TQ3Boolean			E3Geometry_CanShareTemplates( void );
+TQ3Boolean			E3Geometry_GetTemplateFrame( const TQ3Point3D* origin,
+												const TQ3Vector3D* orientation,
+												const TQ3Vector3D* majorRadius,
+												const TQ3Vector3D* minorRadius,
+												TQ3Matrix4x4* templateToLocal );
+TQ3Object			E3Geometry_FindTemplate( const TE3GeometryTemplateKey* theKey );
+void				E3Geometry_AddTemplate( const TE3GeometryTemplateKey* theKey,
+												TQ3Object theTemplate );
+TQ3GroupObject		E3Geometry_NewTemplateInstance( TQ3Object theTemplate,
+												const TQ3Matrix4x4* templateToLocal,
+												TQ3AttributeSet theAttributes );
+
 
 //=============================================================================
 //		C++ postamble
@@ -53,6 +53,17 @@
 
 
 
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+#define kTemplatePartFace						0
+#define kTemplateFlagRightHanded				(1 << 0)
+#define kTemplateFlagTip						(1 << 1)
+
+
+
+
+
 //=============================================================================
 //      Internal types
 //-----------------------------------------------------------------------------
@@ -226,7 +237,7 @@ e3geom_cone_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 //=============================================================================
 //      e3geom_cone_create_face : Helper for e3geom_cone_cache_new.
 //-----------------------------------------------------------------------------
-static void e3geom_cone_create_face( TQ3GroupObject ioGroup, const TQ3ConeData* inData,
+static TQ3GeometryObject e3geom_cone_create_face( const TQ3ConeData* inData,
 	TQ3Uns32 inNumSides, TQ3Uns32 inNumBands, TQ3Boolean inTipPresent )
 {
 	float				ang, dang, cosAngle, sinAngle;
@@ -314,7 +325,7 @@ static void e3geom_cone_create_face( TQ3GroupObject ioGroup, const TQ3ConeData*
 		Q3Memory_Free(&uvs);
 		Q3Memory_Free(&triangles);
 		
-		return;
+		return nullptr;
 	}
 
 
@@ -431,13 +442,10 @@ static void e3geom_cone_create_face( TQ3GroupObject ioGroup, const TQ3ConeData*
 
 
 
-	// Create the TriMesh and add to the group
+	// Create the TriMesh
 	theTriMesh = Q3TriMesh_New(&triMeshData);
 	if (theTriMesh != nullptr)
-		{
 		E3TriMesh_AddTriangleNormals(theTriMesh, kQ3OrientationStyleCounterClockwise);
-		Q3Group_AddObjectAndDispose( ioGroup, &theTriMesh );
-		}
 
 
 
@@ -446,6 +454,88 @@ static void e3geom_cone_create_face( TQ3GroupObject ioGroup, const TQ3ConeData*
 	Q3Memory_Free(&normals);
 	Q3Memory_Free(&uvs);
 	Q3Memory_Free(&triangles);
+
+	return theTriMesh;
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_cone_create_face_template : Create the face from a template.
+//-----------------------------------------------------------------------------
+//		Note :	A cone face is the image of a cone with unit axes under the
+//				affine map given by its axes, so we tessellate the unit cone
+//				once for each set of limits and subdivisions and share it.
+//
+//				The face attribute set is put in the instance rather than the
+//				shared TriMesh.
+//-----------------------------------------------------------------------------
+static TQ3GroupObject e3geom_cone_create_face_template( const TQ3ConeData* inData,
+	TQ3Uns32 inNumSides, TQ3Uns32 inNumBands, TQ3Boolean inTipPresent )
+{
+	TE3GeometryTemplateKey	theKey;
+	TQ3ConeData				templateData;
+	TQ3Matrix4x4			templateToLocal;
+	TQ3GeometryObject		theTemplate;
+	TQ3GroupObject			theInstance;
+	TQ3Boolean				isRightHanded;
+
+
+
+	// Find the template frame
+	isRightHanded = E3Geometry_GetTemplateFrame( &inData->origin, &inData->orientation,
+		&inData->majorRadius, &inData->minorRadius, &templateToLocal );
+
+	templateData = *inData;
+	templateData.origin.x      = 0.0f;
+	templateData.origin.y      = 0.0f;
+	templateData.origin.z      = 0.0f;
+	templateData.orientation.x = 0.0f;
+	templateData.orientation.y = 0.0f;
+	templateData.orientation.z = isRightHanded ? 1.0f : -1.0f;
+	templateData.majorRadius.x = 1.0f;
+	templateData.majorRadius.y = 0.0f;
+	templateData.majorRadius.z = 0.0f;
+	templateData.minorRadius.x = 0.0f;
+	templateData.minorRadius.y = 1.0f;
+	templateData.minorRadius.z = 0.0f;
+	templateData.faceAttributeSet = nullptr;
+
+
+
+	// Find or build the template
+	Q3Memory_Clear( &theKey, sizeof(theKey) );
+	theKey.geomType     = kQ3GeometryTypeCone;
+	theKey.partType     = kTemplatePartFace;
+	theKey.uSegments    = inNumSides;
+	theKey.vSegments    = inNumBands;
+	theKey.theFlags     = (isRightHanded ? kTemplateFlagRightHanded : 0) |
+						  (inTipPresent  ? kTemplateFlagTip         : 0);
+	theKey.theParams[0] = inData->uMin;
+	theKey.theParams[1] = inData->uMax;
+	theKey.theParams[2] = inData->vMin;
+	theKey.theParams[3] = inData->vMax;
+
+	theTemplate = E3Geometry_FindTemplate( &theKey );
+	if (theTemplate == nullptr)
+	{
+		theTemplate = e3geom_cone_create_face( &templateData, inNumSides, inNumBands, inTipPresent );
+		if (theTemplate == nullptr)
+			return nullptr;
+
+		E3Geometry_AddTemplate( &theKey, theTemplate );
+	}
+
+
+
+	// Create an instance of it
+	theInstance = E3Geometry_NewTemplateInstance( theTemplate, &templateToLocal,
+		inData->faceAttributeSet );
+	Q3Object_Dispose( theTemplate );
+
+	return theInstance;
 }
 
 
@@ -809,7 +899,16 @@ e3geom_cone_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom, const vo
 	faceData.uMax = uMax;
 	faceData.vMin = vMin;
 	faceData.vMax = vMax;
-	e3geom_cone_create_face( theGroup, &faceData, sides, bands, isTipPresent );
+
+	TQ3Object	theFace = nullptr;
+	if (E3Geometry_CanShareTemplates())
+		theFace = e3geom_cone_create_face_template( &faceData, sides, bands, isTipPresent );
+
+	if (theFace == nullptr)
+		theFace = e3geom_cone_create_face( &faceData, sides, bands, isTipPresent );
+
+	if (theFace != nullptr)
+		Q3Group_AddObjectAndDispose( theGroup, &theFace );
 
 
 
@@ -53,6 +53,16 @@
 
 
 
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+#define kTemplatePartFace						0
+#define kTemplateFlagRightHanded				(1 << 0)
+
+
+
+
+
 //=============================================================================
 //      Internal types
 //-----------------------------------------------------------------------------
@@ -233,30 +243,22 @@ e3geom_cylinder_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 
 
 //=============================================================================
-//      e3geom_cylinder_cache_new : Cylinder cache new method.
+//      e3geom_cylinder_create_face : Create the side of the cylinder.
 //-----------------------------------------------------------------------------
-static TQ3Object
-e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
-	const void *geomDataParam)
+static TQ3GeometryObject
+e3geom_cylinder_create_face( const TQ3CylinderData* inData,
+	float startAngle, float angleRange, float vMin, float vMax, TQ3Uns32 sides )
 {
-	const TQ3CylinderData* geomData = (const TQ3CylinderData*) geomDataParam;
 	float						ang=0.0f, dang, cosAngle, sinAngle;
-	float						startAngle, endAngle, angleRange;
 	TQ3Vector3D					orientCrossMaj, orientCrossMin;
-	float						uMin, uMax, vMin, vMax;
-	TQ3Point3D					bottomCenter, topCenter;
+	TQ3Point3D					bottomCenter;
 	TQ3TriMeshAttributeData		vertexAttributes[2];
-	TQ3Boolean					isPartAngleRange;
-	TQ3SubdivisionStyleData		subdivisionData;
 	TQ3Vector3D					workVec, sideVec;
 	TQ3TriMeshData				triMeshData;
 	TQ3GeometryObject			theTriMesh;
-	TQ3Uns32					sides = 10;
 	TQ3TriMeshTriangleData		*triangles;
 	TQ3Uns32					numpoints;
 	TQ3Vector3D					*normals;
-	TQ3StyleObject				theStyle;
-	TQ3GroupObject				theGroup;
 	TQ3Point3D					*points;
 	TQ3Param2D					*uvs;
 	TQ3Uns32					i;
@@ -264,80 +266,11 @@ e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 
 
 
-	// Get the UV limits and make sure they are valid
-	uMin  = E3Num_Clamp(geomData->uMin, 0.0f, 1.0f);
-	uMax  = E3Num_Clamp(geomData->uMax, 0.0f, 1.0f);
-	vMin  = E3Num_Clamp(geomData->vMin, 0.0f, 1.0f);
-	vMax  = E3Num_Clamp(geomData->vMax, 0.0f, 1.0f);
-	// It is possible for uMin to be greater than uMax, so that
-	// we can specify which way to wrap around the circle.
-	// But it doesn't make sense for vMin to be greater than vMax.
-	if (vMin > vMax)
-		E3Float_Swap( vMin, vMax );
-	
-	
-	
-	// Turn the u limits into an angle range in radians.
-	startAngle = uMin * kQ32Pi;
-	endAngle   = uMax * kQ32Pi;
-	if (startAngle > endAngle)
-		startAngle -= kQ32Pi;
-	angleRange = endAngle - startAngle;
-	isPartAngleRange = E3Float_Abs( angleRange - kQ32Pi ) > kQ3RealZero?
-		kQ3True : kQ3False;
-
-
-
-	// Find the center of the top and the bottom.
-	Q3Vector3D_Scale( &geomData->orientation, vMin, &workVec );
-	Q3Point3D_Vector3D_Add( &geomData->origin, &workVec, &bottomCenter );
-	Q3Vector3D_Scale( &geomData->orientation, vMax - vMin, &sideVec );
-	Q3Point3D_Vector3D_Add( &bottomCenter, &sideVec, &topCenter );
-	
-
-
-	// Get the subdivision style, to figure out how many sides we should have.
-	if (Q3View_GetSubdivisionStyleState( theView, &subdivisionData ) == kQ3Success) {
-		switch (subdivisionData.method) {
-			case kQ3SubdivisionMethodConstant:
-				// for a cylinder, parameter c1 is the number of sides and c2 is unused
-				sides = (TQ3Uns32) subdivisionData.c1;
-				break;
-			
-			case kQ3SubdivisionMethodWorldSpace:
-				// keep the length of any side less than or equal to c1
-				{
-					TQ3Matrix4x4	localToWorld;
-					TQ3Vector3D		bigRadius;
-					
-					// Find the longer of the two radius vectors.
-					bigRadius = geomData->majorRadius;
-					if (Q3Vector3D_LengthSquared( &geomData->majorRadius ) <
-						Q3Vector3D_LengthSquared( &geomData->minorRadius ) )
-					{
-						bigRadius = geomData->minorRadius;
-					}
-
-					// divide the circumference by c1
-					Q3View_GetLocalToWorldMatrixState( theView, &localToWorld );
-					Q3Vector3D_Transform( &bigRadius, &localToWorld, &workVec );
-					sides = (TQ3Uns32) ((kQ32Pi * Q3Vector3D_Length(&workVec))
-							/ subdivisionData.c1);
-				}
-				break;
-
-			case kQ3SubdivisionMethodScreenSpace:
-				// Not implemented
-				break;
-			
-			default:
-				Q3_ASSERT(!"Unknown subdivision method");
-				break;
-		}
-	}
-	sides = E3Num_Clamp(sides, 3, 256);	// sanity checking
+	// Find the center of the bottom, and the vector along the side
+	Q3Vector3D_Scale( &inData->orientation, vMin, &workVec );
+	Q3Point3D_Vector3D_Add( &inData->origin, &workVec, &bottomCenter );
+	Q3Vector3D_Scale( &inData->orientation, vMax - vMin, &sideVec );
 
-	numpoints = sides*2;
 
 
 	// In order to have proper uv parameterization we need an extra set of vertices
@@ -345,33 +278,7 @@ e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 	// have multiple uvs for a vertex)
 	//
 	// So, we add on 2 more points to hold these two duplicate vertices
-	numpoints += 2;
-
-
-
-	// Create a group to hold the cached geometry
-	theGroup = Q3DisplayGroup_New();
-	if (theGroup == nullptr)
-	{
-		E3ErrorManager_PostError( kQ3ErrorOutOfMemory, kQ3False );
-		return nullptr;
-	}
-
-
-
-	// Add the orientation style
-	//
-	// All of the TriMeshes which form the cylinder have triangle normals created in a CCW style,
-	// so we need to add an orientation to our group to ensure they are always treated as such.
-	theStyle = Q3OrientationStyle_New(kQ3OrientationStyleCounterClockwise);
-	Q3Group_AddObjectAndDispose(theGroup, &theStyle);
-
-
-
-	// Add the cone attributes
-	TQ3AttributeSet atts = geomData->cylinderAttributeSet;
-	if (atts != nullptr)
-		Q3Group_AddObject( theGroup, atts );
+	numpoints = sides*2 + 2;
 
 
 
@@ -388,7 +295,7 @@ e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 		Q3Memory_Free(&uvs);
 		Q3Memory_Free(&triangles);
 		
-		return(theGroup);
+		return(nullptr);
 		}
 
 
@@ -405,18 +312,8 @@ e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 	//		-sin(t)(orientation x majorRadius) + cos(t)(orientation x minorRadius) .
 	// If (majorRadius, minorRadius, orientation) forms a right-handed system, then
 	// this normal points inward, so will need to be negated.
-	Q3Vector3D_Cross( &geomData->orientation, &geomData->minorRadius, &orientCrossMin );
-	Q3Vector3D_Cross( &geomData->orientation, &geomData->majorRadius, &orientCrossMaj );
-	
-	
-	
-	// Test whether the geometry is degenerate.
-	if (E3Geometry_IsDegenerateTriple( &geomData->orientation, &geomData->majorRadius,
-		&geomData->minorRadius ))
-	{
-		E3ErrorManager_PostError( kQ3ErrorDegenerateGeometry, kQ3False );
-		return theGroup;
-	}
+	Q3Vector3D_Cross( &inData->orientation, &inData->minorRadius, &orientCrossMin );
+	Q3Vector3D_Cross( &inData->orientation, &inData->majorRadius, &orientCrossMaj );
 
 
 
@@ -429,9 +326,9 @@ e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 		sinAngle = (float) sin(ang);
 
 		// bottom point is bottomCenter + cos(major) + sin(minor)
-		Q3Vector3D_Scale( &geomData->majorRadius, cosAngle, &v );
+		Q3Vector3D_Scale( &inData->majorRadius, cosAngle, &v );
 		Q3Point3D_Vector3D_Add( &bottomCenter, &v, &points[i] );
-		Q3Vector3D_Scale( &geomData->minorRadius, sinAngle, &v );
+		Q3Vector3D_Scale( &inData->minorRadius, sinAngle, &v );
 		Q3Point3D_Vector3D_Add( &points[i], &v, &points[i] );
 
 		// compute normal of bottom point
@@ -489,7 +386,7 @@ e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 	triMeshData.edgeAttributeTypes        = nullptr;
 	triMeshData.numVertexAttributeTypes   = 2;
 	triMeshData.vertexAttributeTypes      = vertexAttributes;
-	triMeshData.triMeshAttributeSet = geomData->faceAttributeSet;
+	triMeshData.triMeshAttributeSet = inData->faceAttributeSet;
 
 	Q3BoundingBox_SetFromPoints3D(&triMeshData.bBox,
 									triMeshData.points,
@@ -498,13 +395,253 @@ e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 
 
 
-	// finally, create the TriMesh and add to the group
+	// finally, create the TriMesh
 	theTriMesh = Q3TriMesh_New(&triMeshData);
 	if (theTriMesh != nullptr)
-		{
 		E3TriMesh_AddTriangleNormals(theTriMesh, kQ3OrientationStyleCounterClockwise);
-		Q3Group_AddObjectAndDispose(theGroup, &theTriMesh);
+
+
+
+	// Clean up
+	Q3Memory_Free(&points);
+	Q3Memory_Free(&normals);
+	Q3Memory_Free(&uvs);
+	Q3Memory_Free(&triangles);
+
+	return(theTriMesh);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_cylinder_create_face_template : Create the side from a template.
+//-----------------------------------------------------------------------------
+//		Note :	The side of a cylinder is the image of the side of a cylinder
+//				with unit axes under the affine map given by its axes, so we
+//				tessellate the unit cylinder once for each set of limits and
+//				subdivisions and share it.
+//
+//				The face attribute set is put in the instance rather than the
+//				shared TriMesh.
+//-----------------------------------------------------------------------------
+static TQ3GroupObject
+e3geom_cylinder_create_face_template( const TQ3CylinderData* inData,
+	float startAngle, float angleRange, float vMin, float vMax, TQ3Uns32 sides )
+{
+	TE3GeometryTemplateKey	theKey;
+	TQ3CylinderData			templateData;
+	TQ3Matrix4x4			templateToLocal;
+	TQ3GeometryObject		theTemplate;
+	TQ3GroupObject			theInstance;
+	TQ3Boolean				isRightHanded;
+
+
+
+	// Find the template frame
+	isRightHanded = E3Geometry_GetTemplateFrame( &inData->origin, &inData->orientation,
+		&inData->majorRadius, &inData->minorRadius, &templateToLocal );
+
+	templateData = *inData;
+	templateData.origin.x      = 0.0f;
+	templateData.origin.y      = 0.0f;
+	templateData.origin.z      = 0.0f;
+	templateData.orientation.x = 0.0f;
+	templateData.orientation.y = 0.0f;
+	templateData.orientation.z = isRightHanded ? 1.0f : -1.0f;
+	templateData.majorRadius.x = 1.0f;
+	templateData.majorRadius.y = 0.0f;
+	templateData.majorRadius.z = 0.0f;
+	templateData.minorRadius.x = 0.0f;
+	templateData.minorRadius.y = 1.0f;
+	templateData.minorRadius.z = 0.0f;
+	templateData.faceAttributeSet = nullptr;
+
+
+
+	// Find or build the template
+	Q3Memory_Clear( &theKey, sizeof(theKey) );
+	theKey.geomType     = kQ3GeometryTypeCylinder;
+	theKey.partType     = kTemplatePartFace;
+	theKey.uSegments    = sides;
+	theKey.theFlags     = isRightHanded ? kTemplateFlagRightHanded : 0;
+	theKey.theParams[0] = startAngle;
+	theKey.theParams[1] = angleRange;
+	theKey.theParams[2] = vMin;
+	theKey.theParams[3] = vMax;
+
+	theTemplate = E3Geometry_FindTemplate( &theKey );
+	if (theTemplate == nullptr)
+	{
+		theTemplate = e3geom_cylinder_create_face( &templateData,
+			startAngle, angleRange, vMin, vMax, sides );
+		if (theTemplate == nullptr)
+			return(nullptr);
+
+		E3Geometry_AddTemplate( &theKey, theTemplate );
+	}
+
+
+
+	// Create an instance of it
+	theInstance = E3Geometry_NewTemplateInstance( theTemplate, &templateToLocal,
+		inData->faceAttributeSet );
+	Q3Object_Dispose( theTemplate );
+
+	return(theInstance);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_cylinder_cache_new : Cylinder cache new method.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
+	const void *geomDataParam)
+{
+	const TQ3CylinderData* geomData = (const TQ3CylinderData*) geomDataParam;
+	float						ang=0.0f, cosAngle, sinAngle;
+	float						startAngle, endAngle, angleRange;
+	float						uMin, uMax, vMin, vMax;
+	TQ3Point3D					bottomCenter, topCenter;
+	TQ3Boolean					isPartAngleRange;
+	TQ3SubdivisionStyleData		subdivisionData;
+	TQ3Vector3D					workVec, sideVec;
+	TQ3GeometryObject			theFace;
+	TQ3Uns32					sides = 10;
+	TQ3StyleObject				theStyle;
+	TQ3GroupObject				theGroup;
+	TQ3Vector3D					v;
+
+
+
+	// Get the UV limits and make sure they are valid
+	uMin  = E3Num_Clamp(geomData->uMin, 0.0f, 1.0f);
+	uMax  = E3Num_Clamp(geomData->uMax, 0.0f, 1.0f);
+	vMin  = E3Num_Clamp(geomData->vMin, 0.0f, 1.0f);
+	vMax  = E3Num_Clamp(geomData->vMax, 0.0f, 1.0f);
+	// It is possible for uMin to be greater than uMax, so that
+	// we can specify which way to wrap around the circle.
+	// But it doesn't make sense for vMin to be greater than vMax.
+	if (vMin > vMax)
+		E3Float_Swap( vMin, vMax );
+	
+	
+	
+	// Turn the u limits into an angle range in radians.
+	startAngle = uMin * kQ32Pi;
+	endAngle   = uMax * kQ32Pi;
+	if (startAngle > endAngle)
+		startAngle -= kQ32Pi;
+	angleRange = endAngle - startAngle;
+	isPartAngleRange = E3Float_Abs( angleRange - kQ32Pi ) > kQ3RealZero?
+		kQ3True : kQ3False;
+
+
+
+	// Find the center of the top and the bottom.
+	Q3Vector3D_Scale( &geomData->orientation, vMin, &workVec );
+	Q3Point3D_Vector3D_Add( &geomData->origin, &workVec, &bottomCenter );
+	Q3Vector3D_Scale( &geomData->orientation, vMax - vMin, &sideVec );
+	Q3Point3D_Vector3D_Add( &bottomCenter, &sideVec, &topCenter );
+	
+
+
+	// Get the subdivision style, to figure out how many sides we should have.
+	if (Q3View_GetSubdivisionStyleState( theView, &subdivisionData ) == kQ3Success) {
+		switch (subdivisionData.method) {
+			case kQ3SubdivisionMethodConstant:
+				// for a cylinder, parameter c1 is the number of sides and c2 is unused
+				sides = (TQ3Uns32) subdivisionData.c1;
+				break;
+			
+			case kQ3SubdivisionMethodWorldSpace:
+				// keep the length of any side less than or equal to c1
+				{
+					TQ3Matrix4x4	localToWorld;
+					TQ3Vector3D		bigRadius;
+					
+					// Find the longer of the two radius vectors.
+					bigRadius = geomData->majorRadius;
+					if (Q3Vector3D_LengthSquared( &geomData->majorRadius ) <
+						Q3Vector3D_LengthSquared( &geomData->minorRadius ) )
+					{
+						bigRadius = geomData->minorRadius;
+					}
+
+					// divide the circumference by c1
+					Q3View_GetLocalToWorldMatrixState( theView, &localToWorld );
+					Q3Vector3D_Transform( &bigRadius, &localToWorld, &workVec );
+					sides = (TQ3Uns32) ((kQ32Pi * Q3Vector3D_Length(&workVec))
+							/ subdivisionData.c1);
+				}
+				break;
+
+			case kQ3SubdivisionMethodScreenSpace:
+				// Not implemented
+				break;
+			
+			default:
+				Q3_ASSERT(!"Unknown subdivision method");
+				break;
 		}
+	}
+	sides = E3Num_Clamp(sides, 3, 256);	// sanity checking
+
+
+
+	// Create a group to hold the cached geometry
+	theGroup = Q3DisplayGroup_New();
+	if (theGroup == nullptr)
+	{
+		E3ErrorManager_PostError( kQ3ErrorOutOfMemory, kQ3False );
+		return nullptr;
+	}
+
+
+
+	// Add the orientation style
+	//
+	// All of the TriMeshes which form the cylinder have triangle normals created in a CCW style,
+	// so we need to add an orientation to our group to ensure they are always treated as such.
+	theStyle = Q3OrientationStyle_New(kQ3OrientationStyleCounterClockwise);
+	Q3Group_AddObjectAndDispose(theGroup, &theStyle);
+
+
+
+	// Add the cone attributes
+	TQ3AttributeSet atts = geomData->cylinderAttributeSet;
+	if (atts != nullptr)
+		Q3Group_AddObject( theGroup, atts );
+
+
+
+	// Test whether the geometry is degenerate.
+	if (E3Geometry_IsDegenerateTriple( &geomData->orientation, &geomData->majorRadius,
+		&geomData->minorRadius ))
+	{
+		E3ErrorManager_PostError( kQ3ErrorDegenerateGeometry, kQ3False );
+		return theGroup;
+	}
+
+
+
+	// Create the side, sharing the tessellation with other cylinders if we can
+	theFace = nullptr;
+	if (E3Geometry_CanShareTemplates())
+		theFace = e3geom_cylinder_create_face_template( geomData,
+			startAngle, angleRange, vMin, vMax, sides );
+
+	if (theFace == nullptr)
+		theFace = e3geom_cylinder_create_face( geomData,
+			startAngle, angleRange, vMin, vMax, sides );
+
+	if (theFace != nullptr)
+		Q3Group_AddObjectAndDispose(theGroup, &theFace);
 
 
 
@@ -667,14 +804,6 @@ e3geom_cylinder_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 
 
 
-	// Clean up
-	Q3Memory_Free(&points);
-	Q3Memory_Free(&normals);
-	Q3Memory_Free(&uvs);
-	Q3Memory_Free(&triangles);
-
-
-
 	// Return the cached geometry
 	return(theGroup);
 }
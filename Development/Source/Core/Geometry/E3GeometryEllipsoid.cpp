@@ -56,6 +56,24 @@
 
 
 
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Template parts
+#define kTemplatePartFace						0
+#define kTemplatePartCaps						1
+
+
+// Template flags
+#define kTemplateFlagRightHanded				(1 << 0)
+#define kTemplateFlagTopCap						(1 << 1)
+#define kTemplateFlagBottomCap					(1 << 2)
+#define kTemplateFlagInteriorCap				(1 << 3)
+
+
+
+
+
 //=============================================================================
 //      Internal types
 //-----------------------------------------------------------------------------
@@ -856,6 +874,127 @@ e3geom_ellipsoid_create_face( const TQ3EllipsoidData& geomData,
 
 
 
+//=============================================================================
+//      e3geom_ellipsoid_add_templates : Add the surface and caps as templates.
+//-----------------------------------------------------------------------------
+//		Note :	An ellipsoid is the image of a unit sphere under the affine map
+//				given by its axes, so we tessellate the unit sphere once for
+//				each set of limits and subdivisions and share the result.
+//
+//				The caps use the interior attribute set, which is put in the
+//				instance rather than the shared TriMesh.
+//-----------------------------------------------------------------------------
+static void
+e3geom_ellipsoid_add_templates( TQ3GroupObject ioGroup,
+								const TQ3EllipsoidData& geomData,
+								float uMin, float uMax,
+								float vMin, float vMax,
+								bool isNorthPolePresent,
+								bool isSouthPolePresent,
+								TQ3Uns32 uSegments,
+								TQ3Uns32 vSegments,
+								bool isTopCapNeeded,
+								bool isBottomCapNeeded,
+								bool isInteriorCapNeeded )
+{
+	TE3GeometryTemplateKey	theKey;
+	TQ3EllipsoidData		templateData;
+	TQ3Matrix4x4			templateToLocal;
+	bool					isRightHanded;
+
+
+
+	// Find the template frame
+	isRightHanded = (E3Geometry_GetTemplateFrame( &geomData.origin, &geomData.orientation,
+		&geomData.majorRadius, &geomData.minorRadius, &templateToLocal ) == kQ3True);
+
+	templateData = geomData;
+	templateData.origin.x      = 0.0f;
+	templateData.origin.y      = 0.0f;
+	templateData.origin.z      = 0.0f;
+	templateData.orientation.x = 0.0f;
+	templateData.orientation.y = 0.0f;
+	templateData.orientation.z = isRightHanded ? 1.0f : -1.0f;
+	templateData.majorRadius.x = 1.0f;
+	templateData.majorRadius.y = 0.0f;
+	templateData.majorRadius.z = 0.0f;
+	templateData.minorRadius.x = 0.0f;
+	templateData.minorRadius.y = 1.0f;
+	templateData.minorRadius.z = 0.0f;
+	templateData.interiorAttributeSet  = nullptr;
+	templateData.ellipsoidAttributeSet = nullptr;
+
+
+
+	// Set up the key
+	Q3Memory_Clear( &theKey, sizeof(theKey) );
+	theKey.geomType     = kQ3GeometryTypeEllipsoid;
+	theKey.uSegments    = uSegments;
+	theKey.vSegments    = vSegments;
+	theKey.theFlags     = isRightHanded ? kTemplateFlagRightHanded : 0;
+	theKey.theParams[0] = uMin;
+	theKey.theParams[1] = uMax;
+	theKey.theParams[2] = vMin;
+	theKey.theParams[3] = vMax;
+
+
+
+	// Add the main surface
+	theKey.partType = kTemplatePartFace;
+	CQ3ObjectRef	theFace( E3Geometry_FindTemplate( &theKey ) );
+	if (! theFace.isvalid())
+	{
+		theFace = e3geom_ellipsoid_create_face( templateData,
+			uMin, uMax, vMin, vMax, isNorthPolePresent, isSouthPolePresent,
+			uSegments, vSegments );
+
+		if (theFace.isvalid())
+			E3Geometry_AddTemplate( &theKey, theFace.get() );
+	}
+
+	if (theFace.isvalid())
+	{
+		CQ3ObjectRef	theInstance( E3Geometry_NewTemplateInstance(
+			theFace.get(), &templateToLocal, nullptr ) );
+		if (theInstance.isvalid())
+			Q3Group_AddObject( ioGroup, (TQ3Object _Nonnull) theInstance.get() );
+	}
+
+
+
+	// Add the caps
+	if (isTopCapNeeded || isBottomCapNeeded || isInteriorCapNeeded)
+	{
+		theKey.partType  = kTemplatePartCaps;
+		theKey.theFlags |= (isTopCapNeeded      ? kTemplateFlagTopCap      : 0) |
+						   (isBottomCapNeeded   ? kTemplateFlagBottomCap   : 0) |
+						   (isInteriorCapNeeded ? kTemplateFlagInteriorCap : 0);
+
+		CQ3ObjectRef	theCaps( E3Geometry_FindTemplate( &theKey ) );
+		if (! theCaps.isvalid())
+		{
+			theCaps = e3geom_ellipsoid_create_caps( templateData,
+				uMin, uMax, vMin, vMax, uSegments, vSegments,
+				isTopCapNeeded, isBottomCapNeeded, isInteriorCapNeeded );
+
+			if (theCaps.isvalid())
+				E3Geometry_AddTemplate( &theKey, theCaps.get() );
+		}
+
+		if (theCaps.isvalid())
+		{
+			CQ3ObjectRef	theInstance( E3Geometry_NewTemplateInstance(
+				theCaps.get(), &templateToLocal, geomData.interiorAttributeSet ) );
+			if (theInstance.isvalid())
+				Q3Group_AddObject( ioGroup, (TQ3Object _Nonnull) theInstance.get() );
+		}
+	}
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_ellipsoid_cache_new : Ellipsoid cache new method.
 //-----------------------------------------------------------------------------
@@ -990,6 +1129,27 @@ e3geom_ellipsoid_cache_new( TQ3ViewObject theView, TQ3GeometryObject theGeom,
 	
 	
 	
+	// Do we need to add caps?
+	bool	isTopCapNeeded = (! isNorthPolePresent) &&
+		((geomData->caps & kQ3EndCapMaskTop) != 0);
+	bool	isBottomCapNeeded = (! isSouthPolePresent) &&
+		((geomData->caps & kQ3EndCapMaskBottom) != 0);
+	bool	isInteriarCapNeeded = (! isCircleComplete) &&
+		((geomData->caps & kQ3EndCapMaskInterior) != 0);
+
+
+	// Share the tessellation with other ellipsoids if we can
+	if (E3Geometry_CanShareTemplates())
+	{
+		e3geom_ellipsoid_add_templates( (TQ3Object _Nonnull) resultGroup.get(), *geomData,
+			uMin, uMax, vMin, vMax, isNorthPolePresent, isSouthPolePresent,
+			uSegments, vSegments,
+			isTopCapNeeded, isBottomCapNeeded, isInteriarCapNeeded );
+
+		return Q3Shared_GetReference( (TQ3Object _Nonnull) resultGroup.get() );
+	}
+
+
 	// Make the main surface geometry
 	CQ3ObjectRef	theTriMesh( e3geom_ellipsoid_create_face( *geomData,
 		uMin, uMax, vMin, vMax, isNorthPolePresent, isSouthPolePresent,
@@ -998,13 +1158,7 @@ e3geom_ellipsoid_cache_new( TQ3ViewObject theView, TQ3GeometryObject theGeom,
 		(TQ3Object _Nonnull) theTriMesh.get() );
 
 
-	// Do we need to add caps?
-	bool	isTopCapNeeded = (! isNorthPolePresent) &&
-		((geomData->caps & kQ3EndCapMaskTop) != 0);
-	bool	isBottomCapNeeded = (! isSouthPolePresent) &&
-		((geomData->caps & kQ3EndCapMaskBottom) != 0);
-	bool	isInteriarCapNeeded = (! isCircleComplete) &&
-		((geomData->caps & kQ3EndCapMaskInterior) != 0);
+	// Add the caps
 	if (isTopCapNeeded || isBottomCapNeeded || isInteriarCapNeeded)
 	{
 		CQ3ObjectRef	theCaps( e3geom_ellipsoid_create_caps( *geomData,
@@ -44,11 +44,17 @@
 //      Include files
 //-----------------------------------------------------------------------------
 #include "E3Prefix.h"
+#include "E3Set.h"
 #include "E3View.h"
 #include "E3Geometry.h"
 #include "E3GeometryMesh.h"
 #include "E3ArrayOrList.h"
 #include "E3Pool.h"
+#include "E3GeometryTriMesh.h"
+#include "E3Parallel.h"
+
+#include <vector>
+#include <map>
 
 
 
@@ -68,6 +74,19 @@
 
 
 
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Relative tolerance for a turn to count as convex in the fan fast path
+#define kMeshConvexTolerance							1.0e-5f
+
+// Minimum number of faces worth classifying on another thread
+#define kMeshParallelFacesPerThread						2048
+
+
+
+
+
 //=============================================================================
 //      Internal types
 //-----------------------------------------------------------------------------
@@ -216,6 +235,21 @@ public :
 	} ;
 	
 
+
+
+// Flattened TriMesh data for the convex faces which share an attribute set
+typedef std::pair<const TE3MeshVertexData*, const TE3MeshCornerData*> TE3MeshPointKey;
+
+typedef struct TE3MeshTriMeshBatch {
+	TQ3AttributeSet							faceAttributeSet;
+	std::vector<TQ3Point3D>					points;
+	std::vector<TQ3AttributeSet>			vertexSets;
+	std::vector<TQ3AttributeSet>			cornerSets;
+	std::vector<TQ3TriMeshTriangleData>		triangles;
+	std::vector<TQ3TriMeshEdgeData>			edges;
+	std::map<TE3MeshPointKey, TQ3Uns32>		pointIndices;
+} TE3MeshTriMeshBatch;
+
 //=============================================================================
 //      Internal functions
 //-----------------------------------------------------------------------------
@@ -3501,10 +3535,407 @@ e3geom_mesh_duplicate(
 
 
 //=============================================================================
-//      e3geom_mesh_cache_new_as_polys : Mesh cache new method.
+//      e3geom_mesh_face_is_convex : Is a face a convex polygon?
+//-----------------------------------------------------------------------------
+//		Note :	Faces with a single, simple, convex contour can be fanned
+//				directly into a TriMesh. We project the contour onto the
+//				plane of its Newell normal and require that every turn has
+//				the same sense, and that the contour only doubles back on
+//				itself twice along one axis (which rejects stars, whose turns
+//				are all the same sense but which wind more than once).
+//
+//				thePoints is scratch space, passed in to avoid reallocating
+//				it for every face.
+//-----------------------------------------------------------------------------
+static TQ3Boolean
+e3geom_mesh_face_is_convex(const TE3MeshFaceData* facePtr, std::vector<TQ3Point3D>& thePoints)
+{	const TE3MeshContourData*		contourPtr;
+	const TE3MeshVertexPtr*			vertexHdl;
+	TQ3Uns32						n, numPoints, axisA, axisB, numFlips;
+	float							normal[3], edgeA, edgeB, prevA, prevB, lastA, lastSign, theCross;
+	const float						*p0, *p1;
+
+
+
+	// Only single contour faces are candidates
+	if (e3meshFace_NumContours(facePtr) != 1)
+		return(kQ3False);
+
+	contourPtr = e3meshContourArrayOrList_FirstItemConst(&facePtr->contourArrayOrList);
+	numPoints  = e3meshContour_NumVertices(contourPtr);
+	if (numPoints < 3)
+		return(kQ3False);
+
+
+
+	// Collect the points and find the Newell normal
+	thePoints.clear();
+	for (vertexHdl = e3meshVertexPtrArray_FirstItemConst(&contourPtr->vertexPtrArray);
+		vertexHdl != nullptr;
+		vertexHdl = e3meshVertexPtrArray_NextItemConst(&contourPtr->vertexPtrArray, vertexHdl))
+		thePoints.push_back((*vertexHdl)->point);
+
+	normal[0] = normal[1] = normal[2] = 0.0f;
+	for (n = 0; n < numPoints; n++)
+		{
+		const TQ3Point3D& a = thePoints[n];
+		const TQ3Point3D& b = thePoints[(n + 1) % numPoints];
+		
+		normal[0] += (a.y - b.y) * (a.z + b.z);
+		normal[1] += (a.z - b.z) * (a.x + b.x);
+		normal[2] += (a.x - b.x) * (a.y + b.y);
+		}
+
+
+
+	// Project onto the plane which drops the dominant axis, keeping the
+	// contour anti-clockwise when seen down the normal
+	if (fabsf(normal[0]) >= fabsf(normal[1]) && fabsf(normal[0]) >= fabsf(normal[2]))
+		{
+		axisA = 1;
+		axisB = 2;
+		}
+	else if (fabsf(normal[1]) >= fabsf(normal[2]))
+		{
+		axisA = 2;
+		axisB = 0;
+		}
+	else
+		{
+		axisA = 0;
+		axisB = 1;
+		}
+
+	lastSign = normal[3 - axisA - axisB];
+	if (fabsf(lastSign) <= kQ3RealZero)
+		return(kQ3False);
+
+
+
+	// Check each turn
+	p0       = &thePoints[numPoints - 1].x;
+	p1       = &thePoints[0].x;
+	prevA    = p1[axisA] - p0[axisA];
+	prevB    = p1[axisB] - p0[axisB];
+	lastA    = prevA;
+	numFlips = 0;
+
+	for (n = 0; n < numPoints; n++)
+		{
+		p0    = &thePoints[n].x;
+		p1    = &thePoints[(n + 1) % numPoints].x;
+		edgeA = p1[axisA] - p0[axisA];
+		edgeB = p1[axisB] - p0[axisB];
+		
+		if (edgeA == 0.0f && edgeB == 0.0f)
+			return(kQ3False);
+
+		theCross = prevA * edgeB - prevB * edgeA;
+		if (lastSign < 0.0f)
+			theCross = -theCross;
+
+		if (theCross < -kMeshConvexTolerance * (fabsf(prevA) + fabsf(prevB)) * (fabsf(edgeA) + fabsf(edgeB)))
+			return(kQ3False);
+
+		if (edgeA != 0.0f)
+			{
+			if (lastA != 0.0f && ((edgeA < 0.0f) != (lastA < 0.0f)))
+				numFlips++;
+
+			lastA = edgeA;
+			}
+
+		prevA = edgeA;
+		prevB = edgeB;
+		}
+
+	return((TQ3Boolean) (numFlips <= 2));
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_mesh_batch_add_face : Fan a convex face into a batch.
+//-----------------------------------------------------------------------------
+//		Note :	Corners with attributes need their own TriMesh point, the
+//				other uses of a vertex within the batch share a point.
+//-----------------------------------------------------------------------------
+static void
+e3geom_mesh_batch_add_face(TE3MeshTriMeshBatch& theBatch, const TE3MeshFaceData* facePtr)
+{	const TE3MeshContourData*		contourPtr;
+	const TE3MeshVertexPtr*			vertexHdl;
+	const TE3MeshCornerData*		cornerPtr;
+	TQ3Uns32						n, numPoints, firstPoint, firstTriangle, pointIndex;
+	TQ3TriMeshTriangleData			theTriangle;
+	TQ3TriMeshEdgeData				theEdge;
+	std::vector<TQ3Uns32>			faceIndices;
+
+
+
+	// Find the TriMesh points for the contour
+	contourPtr = e3meshContourArrayOrList_FirstItemConst(&facePtr->contourArrayOrList);
+	numPoints  = e3meshContour_NumVertices(contourPtr);
+	faceIndices.reserve(numPoints);
+
+	for (vertexHdl = e3meshVertexPtrArray_FirstItemConst(&contourPtr->vertexPtrArray);
+		vertexHdl != nullptr;
+		vertexHdl = e3meshVertexPtrArray_NextItemConst(&contourPtr->vertexPtrArray, vertexHdl))
+		{
+		cornerPtr = e3meshVertex_FaceCorner(*vertexHdl, facePtr);
+		if (cornerPtr != nullptr && cornerPtr->attributeSet == nullptr)
+			cornerPtr = nullptr;
+
+		TE3MeshPointKey theKey(*vertexHdl, cornerPtr);
+		std::map<TE3MeshPointKey, TQ3Uns32>::const_iterator theIter = theBatch.pointIndices.find(theKey);
+
+		if (theIter != theBatch.pointIndices.end())
+			pointIndex = theIter->second;
+		else
+			{
+			pointIndex = (TQ3Uns32) theBatch.points.size();
+			theBatch.pointIndices[theKey] = pointIndex;
+			theBatch.points.push_back((*vertexHdl)->point);
+			theBatch.vertexSets.push_back((*vertexHdl)->attributeSet);
+			theBatch.cornerSets.push_back(cornerPtr != nullptr ? cornerPtr->attributeSet : nullptr);
+			}
+
+		faceIndices.push_back(pointIndex);
+		}
+
+
+
+	// Fan the triangles, and add the contour as the edges
+	firstPoint    = faceIndices[0];
+	firstTriangle = (TQ3Uns32) theBatch.triangles.size();
+
+	for (n = 1; n < numPoints - 1; n++)
+		{
+		theTriangle.pointIndices[0] = firstPoint;
+		theTriangle.pointIndices[1] = faceIndices[n];
+		theTriangle.pointIndices[2] = faceIndices[n + 1];
+		theBatch.triangles.push_back(theTriangle);
+		}
+
+	for (n = 0; n < numPoints; n++)
+		{
+		theEdge.pointIndices[0]    = faceIndices[n];
+		theEdge.pointIndices[1]    = faceIndices[(n + 1) % numPoints];
+		theEdge.triangleIndices[0] = firstTriangle + ((n == 0) ? 0 : E3Num_Min(n - 1, numPoints - 3));
+		theEdge.triangleIndices[1] = kQ3ArrayIndexNULL;
+		theBatch.edges.push_back(theEdge);
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_mesh_gather_vertex_set : Gather vertex attributes.
+//-----------------------------------------------------------------------------
+static TQ3AttributeSet
+e3geom_mesh_gather_vertex_set(const void *userData, TQ3Uns32 setIndex)
+{	const TE3MeshTriMeshBatch	*theBatch = (const TE3MeshTriMeshBatch *) userData;
+
+
+
+	// Return the appropriate attribute set
+	return(theBatch->vertexSets[setIndex]);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_mesh_gather_corner_set : Gather corner attributes.
+//-----------------------------------------------------------------------------
+static TQ3AttributeSet
+e3geom_mesh_gather_corner_set(const void *userData, TQ3Uns32 setIndex)
+{	const TE3MeshTriMeshBatch	*theBatch = (const TE3MeshTriMeshBatch *) userData;
+
+
+
+	// Return the appropriate attribute set
+	return(theBatch->cornerSets[setIndex]);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_mesh_gather_point_attribute : Gather a TriMesh point attribute.
+//-----------------------------------------------------------------------------
+//		Note :	Corner attributes override vertex attributes, as if the two
+//				sets had been combined with Q3AttributeSet_Inherit, but
+//				without creating a new set for every corner.
 //-----------------------------------------------------------------------------
-static TQ3GroupObject
-e3geom_mesh_cache_new_as_polys(const TE3MeshData * meshPtr)
+static TQ3Boolean
+e3geom_mesh_gather_point_attribute(const TE3MeshTriMeshBatch& theBatch,
+									TQ3TriMeshAttributeData *theAttribute,
+									TQ3AttributeType attributeType)
+{	TQ3Uns32					n, numPoints, attributeSize;
+	TQ3TriMeshAttributeData		cornerAttribute;
+	TQ3Boolean					haveVertex, haveCorner;
+
+
+
+	// Gather the vertex and the corner values
+	numPoints  = (TQ3Uns32) theBatch.points.size();
+	haveVertex = E3TriMeshAttribute_GatherArray(numPoints, e3geom_mesh_gather_vertex_set, &theBatch,
+												theAttribute, attributeType);
+	haveCorner = E3TriMeshAttribute_GatherArray(numPoints, e3geom_mesh_gather_corner_set, &theBatch,
+												&cornerAttribute, attributeType);
+
+	if (!haveCorner)
+		return(haveVertex);
+
+	if (!haveVertex)
+		{
+		*theAttribute = cornerAttribute;
+		return(kQ3True);
+		}
+
+
+
+	// Merge the corner values over the vertex values
+	attributeSize = E3ClassTree::GetClass(E3Attribute_AttributeToClassType(attributeType))->GetInstanceSize();
+
+	for (n = 0; n < numPoints; n++)
+		{
+		if (cornerAttribute.attributeUseArray == nullptr || cornerAttribute.attributeUseArray[n])
+			{
+			Q3Memory_Copy(((TQ3Uns8 *) cornerAttribute.data) + (n * attributeSize),
+						  ((TQ3Uns8 *) theAttribute->data)   + (n * attributeSize),
+						  attributeSize);
+
+			if (theAttribute->attributeUseArray != nullptr)
+				theAttribute->attributeUseArray[n] = (char) kQ3True;
+			}
+		}
+
+	if (cornerAttribute.attributeUseArray == nullptr)
+		Q3Memory_Free(&theAttribute->attributeUseArray);
+
+	Q3Memory_Free(&cornerAttribute.data);
+	Q3Memory_Free(&cornerAttribute.attributeUseArray);
+
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_mesh_batch_to_trimesh : Create a TriMesh from a batch.
+//-----------------------------------------------------------------------------
+static TQ3GeometryObject
+e3geom_mesh_batch_to_trimesh(const TE3MeshTriMeshBatch& theBatch, TQ3OrientationStyle theOrientation)
+{	TQ3TriMeshAttributeData		vertexAttributes[kQ3AttributeTypeNumTypes];
+	TQ3TriMeshData				triMeshData;
+	TQ3GeometryObject			theTriMesh;
+	TQ3Uns32					n;
+
+
+
+	// Initialise the TriMesh data
+	triMeshData.numPoints                 = (TQ3Uns32) theBatch.points.size();
+	triMeshData.points                    = E3_CONST_CAST(TQ3Point3D *, theBatch.points.data());
+	triMeshData.numTriangles              = (TQ3Uns32) theBatch.triangles.size();
+	triMeshData.triangles                 = E3_CONST_CAST(TQ3TriMeshTriangleData *, theBatch.triangles.data());
+	triMeshData.numTriangleAttributeTypes = 0;
+	triMeshData.triangleAttributeTypes    = nullptr;
+	triMeshData.numEdges                  = (TQ3Uns32) theBatch.edges.size();
+	triMeshData.edges                     = E3_CONST_CAST(TQ3TriMeshEdgeData *, theBatch.edges.data());
+	triMeshData.numEdgeAttributeTypes     = 0;
+	triMeshData.edgeAttributeTypes        = nullptr;
+	triMeshData.numVertexAttributeTypes   = 0;
+	triMeshData.vertexAttributeTypes      = nullptr;
+	triMeshData.triMeshAttributeSet       = theBatch.faceAttributeSet;
+
+	Q3BoundingBox_SetFromPoints3D(&triMeshData.bBox, triMeshData.points, triMeshData.numPoints, sizeof(TQ3Point3D));
+
+
+
+	// Set up the vertex attributes
+	n = 0;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeSurfaceUV))
+		n++;
+	else
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeShadingUV))
+		n++;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeNormal))
+		n++;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeAmbientCoefficient))
+		n++;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeDiffuseColor))
+		n++;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeSpecularColor))
+		n++;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeSpecularControl))
+		n++;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeTransparencyColor))
+		n++;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeSurfaceTangent))
+		n++;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeHighlightState))
+		n++;
+
+	if (e3geom_mesh_gather_point_attribute(theBatch, &vertexAttributes[n], kQ3AttributeTypeSurfaceShader))
+		n++;
+
+	Q3_ASSERT(n < (sizeof(vertexAttributes) / sizeof(TQ3TriMeshAttributeData)));
+	if (n != 0)
+		{
+		triMeshData.numVertexAttributeTypes = n;
+		triMeshData.vertexAttributeTypes    = vertexAttributes;
+		}
+
+
+
+	// Create the TriMesh
+	theTriMesh = Q3TriMesh_New(&triMeshData);
+	if (theTriMesh != nullptr)
+		E3TriMesh_AddTriangleNormals(theTriMesh, theOrientation);
+
+
+
+	// Clean up
+	for (n = 0; n < triMeshData.numVertexAttributeTypes; n++)
+		{
+		Q3Memory_Free(&triMeshData.vertexAttributeTypes[n].data);
+		Q3Memory_Free(&triMeshData.vertexAttributeTypes[n].attributeUseArray);
+		}
+
+	return(theTriMesh);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_mesh_cache_add_polys : Add faces to the cache as polygons.
+//-----------------------------------------------------------------------------
+//		Note :	Used for the faces which can't take the fan fast path, each
+//				face becomes a general polygon with its corner attributes
+//				inherited into its vertex attributes.
+//-----------------------------------------------------------------------------
+static void
+e3geom_mesh_cache_add_polys(const std::vector<const TE3MeshFaceData*>& theFaces, TQ3GroupObject thePolysGroup)
 {
 #define _MESH_AS_POLYS_OBJECTS_TO_DELETE_GROW 16
 
@@ -3513,14 +3944,13 @@ e3geom_mesh_cache_new_as_polys(const TE3MeshData * meshPtr)
 	const TE3MeshVertexPtr* 		vertexHdl;
 	const TE3MeshCornerData* 		cornerPtr;
 	
-	TQ3GroupObject 					thePolysGroup = nullptr;
 	TQ3GeneralPolygonData			polyData;
 	TQ3Object						*objectsToDelete;
 	TQ3Uns32						numObjectsToDelete;
 	TQ3Uns32						allocatedObjectsToDelete;
 	TQ3Vertex3D						*currentVertex;
 	TQ3Object 						thePoly;
-	TQ3Uns32						i,j;
+	TQ3Uns32						i,j,n;
 	
 	
     polyData.contours = nullptr;
@@ -3529,27 +3959,18 @@ e3geom_mesh_cache_new_as_polys(const TE3MeshData * meshPtr)
     
 
 
-	thePolysGroup = Q3OrderedDisplayGroup_New ();
-	if(thePolysGroup == nullptr)
-		return nullptr;
-	
 	objectsToDelete = (TQ3Object*) Q3Memory_Allocate(_MESH_AS_POLYS_OBJECTS_TO_DELETE_GROW * sizeof(TQ3Object));
 	if(objectsToDelete == nullptr)
-		return thePolysGroup;
+		return;
 		
 	allocatedObjectsToDelete = _MESH_AS_POLYS_OBJECTS_TO_DELETE_GROW;
 	
-	// add the mesh attribute Set to the group
-	if(meshPtr->attributeSet != nullptr)
-		Q3Group_AddObject(thePolysGroup,meshPtr->attributeSet);
-		
 	numObjectsToDelete = 0;
 		
 	
-	for (facePtr = e3meshFaceArrayOrList_FirstItemConst(&meshPtr->faceArrayOrList);
-		facePtr != nullptr;
-		facePtr = e3meshFaceArrayOrList_NextItemConst(&meshPtr->faceArrayOrList, facePtr))
+	for (n = 0; n < theFaces.size(); n++)
 		{
+		facePtr = theFaces[n];
 		numObjectsToDelete = 0;
 		
 		polyData.numContours = e3meshFace_NumContours(facePtr);
@@ -3661,8 +4082,6 @@ cleanup:
 			}
 		Q3Memory_Free(&polyData.contours);
 		}
-	
-	return thePolysGroup;
 
 #undef _MESH_AS_POLYS_OBJECTS_TO_DELETE_GROW
 
@@ -3675,12 +4094,30 @@ cleanup:
 //=============================================================================
 //      e3geom_mesh_cache_new : Mesh cache new method.
 //-----------------------------------------------------------------------------
+//		Note :	Convex faces are fanned straight into one TriMesh per face
+//				attribute set, and only the non-convex or holed faces are
+//				passed to the general polygon tessellator.
+//
+//				Testing a face for convexity only reads the mesh, so large
+//				meshes classify their faces on several threads. Fanning and
+//				tessellation stay on the calling thread, since they create
+//				attribute sets and geometries and the object system is not
+//				thread safe.
+//-----------------------------------------------------------------------------
 static TQ3Object
 e3geom_mesh_cache_new(TQ3ViewObject view, TQ3GeometryObject meshObject, const void *geomData)
 {
 	const TE3MeshData* meshPtr = (const TE3MeshData*) geomData;
+	const TE3MeshFaceData*						facePtr;
+	std::vector<TE3MeshTriMeshBatch>			theBatches;
+	std::map<TQ3AttributeSet, TQ3Uns32>			batchIndices;
+	std::vector<const TE3MeshFaceData*>			theFaces, complexFaces;
+	std::vector<TQ3Uns8>						isConvex;
+	TQ3OrientationStyle							theOrientation;
+	TQ3GeometryObject							theTriMesh;
+	TQ3GroupObject								theGroup;
+	TQ3Uns32									n, m;
 #pragma unused(meshObject)
-#pragma unused(view)
 
 
 
@@ -3689,8 +4126,81 @@ e3geom_mesh_cache_new(TQ3ViewObject view, TQ3GeometryObject meshObject, const vo
 		return nullptr;
 
 
-	// Create an appropriate representation
-	TQ3Object theGroup = e3geom_mesh_cache_new_as_polys(meshPtr);
+
+	// Create the group
+	theGroup = Q3OrderedDisplayGroup_New();
+	if (theGroup == nullptr)
+		return nullptr;
+
+	if (meshPtr->attributeSet != nullptr)
+		Q3Group_AddObject(theGroup, meshPtr->attributeSet);
+
+
+
+	// Classify the faces
+	theFaces.reserve(e3mesh_NumFaces(meshPtr));
+
+	for (facePtr = e3meshFaceArrayOrList_FirstItemConst(&meshPtr->faceArrayOrList);
+		facePtr != nullptr;
+		facePtr = e3meshFaceArrayOrList_NextItemConst(&meshPtr->faceArrayOrList, facePtr))
+		theFaces.push_back(facePtr);
+
+	isConvex.resize(theFaces.size());
+
+	E3Parallel_For((TQ3Uns32) theFaces.size(), kMeshParallelFacesPerThread,
+		[&](TQ3Uns32 firstFace, TQ3Uns32 endFace)
+		{
+		std::vector<TQ3Point3D>		scratchPoints;
+
+		for (TQ3Uns32 f = firstFace; f < endFace; f++)
+			isConvex[f] = (TQ3Uns8) e3geom_mesh_face_is_convex(theFaces[f], scratchPoints);
+		});
+
+
+
+	// Sort the faces into batches of convex faces, and complex faces
+	for (m = 0; m < theFaces.size(); m++)
+		{
+		facePtr = theFaces[m];
+
+		if (!isConvex[m])
+			{
+			complexFaces.push_back(facePtr);
+			continue;
+			}
+
+		std::map<TQ3AttributeSet, TQ3Uns32>::const_iterator theIter = batchIndices.find(facePtr->attributeSet);
+		if (theIter != batchIndices.end())
+			n = theIter->second;
+		else
+			{
+			n = (TQ3Uns32) theBatches.size();
+			batchIndices[facePtr->attributeSet] = n;
+
+			theBatches.push_back(TE3MeshTriMeshBatch());
+			theBatches.back().faceAttributeSet = facePtr->attributeSet;
+			}
+
+		e3geom_mesh_batch_add_face(theBatches[n], facePtr);
+		}
+
+
+
+	// Create a TriMesh for each batch
+	theOrientation = E3View_State_GetStyleOrientation(view);
+
+	for (n = 0; n < theBatches.size(); n++)
+		{
+		theTriMesh = e3geom_mesh_batch_to_trimesh(theBatches[n], theOrientation);
+		if (theTriMesh != nullptr)
+			Q3Group_AddObjectAndDispose(theGroup, &theTriMesh);
+		}
+
+
+
+	// Tessellate the remaining faces
+	if (!complexFaces.empty())
+		e3geom_mesh_cache_add_polys(complexFaces, theGroup);
 
 	return(theGroup);
 }
@@ -3804,6 +4314,10 @@ e3geom_mesh_metahandler(
 		case kQ3XMethodTypeGeomGetAttribute:
 			theMethod = (TQ3XFunctionPointer) e3geom_mesh_get_attribute;
 			break;
+
+		case kQ3XMethodTypeGeomUsesOrientation:
+			theMethod = (TQ3XFunctionPointer) kQ3True;
+			break;
 		}
 
 	return(theMethod);
@@ -48,14 +48,25 @@
 #include "E3Geometry.h"
 #include "E3GeometryNURBCurve.h"
 
+#include <vector>
+
 
 
 
 
 //=============================================================================
-//      Internal types
+//      Internal constants
 //-----------------------------------------------------------------------------
+// Maximum number of segments in a knot span
+#define		kMaxSpanSubdivision			256
+
+
+
 
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
 class E3NURBCurve : public E3Geometry // This is a leaf class so no other classes use this,
 								// so it can be here in the .c file rather than in
 								// the .h file, hence all the fields can be public
@@ -66,6 +77,11 @@ public :
 
 	TQ3NURBCurveData			instanceData ;
 
+	// Bézier form of instanceData, valid while bezierEditIndex matches the
+	// edit index of the object
+	TE3NURBCurveBezierData		bezierData ;
+	TQ3Uns32					bezierEditIndex ;
+
 	} ;
 	
 
@@ -163,12 +179,12 @@ e3geom_nurbcurve_new(TQ3Object theObject, void *privateData, const void *paramDa
 static void
 e3geom_nurbcurve_delete(TQ3Object theObject, void *privateData)
 {	TQ3NURBCurveData		*instanceData = (TQ3NURBCurveData *) privateData;
-#pragma unused(theObject)
 
 
 
 	// Dispose of our instance data
 	e3geom_curve_disposedata(instanceData);
+	Q3Memory_Free( &((E3NURBCurve*) theObject)->bezierData.controlPoints );
 }
 
 
@@ -210,43 +226,31 @@ e3geom_nurbcurve_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 
 
 //=============================================================================
-//      e3geom_nurbcurve_evaluate_N_i_k : Evaluate N_i_k.
+//      e3geom_nurbcurve_interesting_knots : Find the interesting knots.
 //-----------------------------------------------------------------------------
-//		Note :	As described in QD3D Programming book "NURB Curves and Patches"
-//				This is very slow and used as a reference implementation only.
+//		Note :	Interesting == non-repetitive knots.
 //-----------------------------------------------------------------------------
-static float
-e3geom_nurbcurve_evaluate_N_i_k(
-			float 			u,
-			TQ3Uns32		i,
-			TQ3Uns32		k,
-			TQ3Uns32		inOrder,
-			TQ3Uns32		inNumPoints,
-			float			inKnots[])
+static TQ3Uns32
+e3geom_nurbcurve_interesting_knots( const float * inKnots, TQ3Uns32 numPoints, TQ3Uns32 order, float * interestingK )
 {
-	if (k == 1)
-	{
-		if ((inKnots[i] <= u) && (u <= inKnots[i+1]))
-			return 1.0f;
-		else
-			return 0.0f;
-	}
+	TQ3Uns32 count, n ;
+	interestingK[0] = inKnots[order - 1] ;
 	
-	{
-		float div;
-		float sum = 0.0f;
+	count = 1 ;
+	for( n = order ; n <= numPoints ; n++ ) {
 		
-		div = inKnots[i+k-1]-inKnots[i];
-		if (div != 0.0f)
-			sum += ((u-inKnots[i])*e3geom_nurbcurve_evaluate_N_i_k(u,i,k-1,inOrder,inNumPoints,inKnots))/div;
-
+		// if current knot differs from the previous, add this knot
+		if( inKnots[n] != inKnots[n-1] ) {
+			interestingK[ count ] = inKnots[n] ;
+			count++ ;
+		}
 		
-		div = inKnots[i+k]-inKnots[i+1];
-		if (div != 0.0f)
-			sum += ((inKnots[i+k]-u)*e3geom_nurbcurve_evaluate_N_i_k(u,i+1,k-1,inOrder,inNumPoints,inKnots))/div;
-			
-		return sum;
-	}
+	} // ~for( n in knot vector )
+	
+#if Q3_DEBUG
+	Q3_ASSERT( count <= numPoints - order + 2 ) ;
+#endif
+	return (TQ3Uns32) count ;
 }
 
 
@@ -254,34 +258,53 @@ e3geom_nurbcurve_evaluate_N_i_k(
 
 
 //=============================================================================
-//      e3geom_nurbcurve_evaluate_nurbs_curve : Evaluate the curve.
+//      e3geom_nurbcurve_find_span : Find the knot span containing a parameter.
 //-----------------------------------------------------------------------------
-//		Note :	Brute force evaluation of the NURB curve as found in the QD3D
-//				programming book.
+//		Note :	Returns the index s of the span knots[s] <= u < knots[s+1],
+//				with s in [order-1, numPoints-1].  The end of the parameter
+//				range is assigned to the last non-empty span.
 //-----------------------------------------------------------------------------
-static void 
-e3geom_nurbcurve_evaluate_nurbs_curve(
-			float				inU,
-			TQ3Uns32			inOrder,
-			TQ3Uns32			inNumPoints,
-			float				inKnots[],
-			TQ3RationalPoint4D	inControlPoints[],
-			TQ3RationalPoint4D	*outPoint)
-{
-	TQ3Uns32 i;
-	outPoint->x = 0.0f;
-	outPoint->y = 0.0f;
-	outPoint->z = 0.0f;
-	outPoint->w = 0.0f;
-	
-	for (i = 0; i < inNumPoints; i++)
-	{
-		float coeff = e3geom_nurbcurve_evaluate_N_i_k(inU,i,inOrder,inOrder,inNumPoints,inKnots);
-		outPoint->x += coeff*inControlPoints[i].x;
-		outPoint->y += coeff*inControlPoints[i].y;
-		outPoint->z += coeff*inControlPoints[i].z;
-		outPoint->w += coeff*inControlPoints[i].w;
-	}
+static TQ3Uns32
+e3geom_nurbcurve_find_span( float u, TQ3Uns32 numPoints, TQ3Uns32 order, const float *knots )
+{	TQ3Uns32	low, high, mid;
+
+
+
+	// Handle the ends of the range
+	if (u >= knots[numPoints])
+		{
+		mid = numPoints - 1;
+		while (mid > order - 1 && knots[mid] >= knots[numPoints])
+			mid--;
+		return(mid);
+		}
+
+	if (u <= knots[order - 1])
+		{
+		mid = order - 1;
+		while (mid < numPoints - 1 && knots[mid + 1] <= knots[order - 1])
+			mid++;
+		return(mid);
+		}
+
+
+
+	// Binary search for the span
+	low  = order - 1;
+	high = numPoints;
+	mid  = (low + high) / 2;
+
+	while (u < knots[mid] || u >= knots[mid + 1])
+		{
+		if (u < knots[mid])
+			high = mid;
+		else
+			low = mid;
+
+		mid = (low + high) / 2;
+		}
+
+	return(mid);
 }
 
 
@@ -289,63 +312,48 @@ e3geom_nurbcurve_evaluate_nurbs_curve(
 
 
 //=============================================================================
-//      e3geom_nurbcurve_evaluate_nurbs_curve_u : Evaluate the curve.
+//      e3geom_nurbcurve_insert_knot : Insert a knot into a curve.
 //-----------------------------------------------------------------------------
-//		Note :	Calls e3geom_nurbcurve_evaluate_nurbs_curve and takes care of
-//				converting down to a TQ3Vertex
+//		Note :	Boehm's algorithm, inserting the knot once without changing
+//				the shape of the curve. The control points are in homogeneous
+//				form, as in TQ3NURBCurveData.
 //-----------------------------------------------------------------------------
 static void
-e3geom_nurbcurve_evaluate_nurbs_curve_u( float theUParam, const TQ3NURBCurveData *geomData, TQ3Point3D *thePoint )
-{
-	TQ3RationalPoint4D	evalPoint;
-	float				oow;
-
-	e3geom_nurbcurve_evaluate_nurbs_curve(
-							theUParam,
-							geomData->order,
-							geomData->numPoints,
-							geomData->knots,
-							geomData->controlPoints,
-							&evalPoint);
-
-	// Divide by w:
-	oow = 1.0f/evalPoint.w;
-
-	thePoint->x = evalPoint.x*oow;
-	thePoint->y = evalPoint.y*oow;
-	thePoint->z = evalPoint.z*oow;
-}
+e3geom_nurbcurve_insert_knot( float u, TQ3Uns32 order,
+							  std::vector<float>& knots,
+							  std::vector<TQ3RationalPoint4D>& controlPoints )
+{	TQ3Uns32			numPoints, span, i;
+	TQ3RationalPoint4D	newPoints[kQ3NURBCurveMaxOrder];
+	float				alpha;
 
 
 
+	// Find the span, and blend the control points which it affects
+	numPoints = (TQ3Uns32) controlPoints.size();
+	span      = e3geom_nurbcurve_find_span( u, numPoints, order, &knots[0] );
 
+	for (i = span + 2 - order; i <= span; i++)
+		{
+		const TQ3RationalPoint4D&	prevPoint = controlPoints[i - 1];
+		const TQ3RationalPoint4D&	thePoint  = controlPoints[i];
 
-//=============================================================================
-//      e3geom_nurbcurve_interesting_knots : Find the interesting knots.
-//-----------------------------------------------------------------------------
-//		Note :	Interesting == non-repetitive knots.
-//-----------------------------------------------------------------------------
-static TQ3Uns32
-e3geom_nurbcurve_interesting_knots( const float * inKnots, TQ3Uns32 numPoints, TQ3Uns32 order, float * interestingK )
-{
-	TQ3Uns32 count, n ;
-	interestingK[0] = inKnots[order - 1] ;
-	
-	count = 1 ;
-	for( n = order ; n <= numPoints ; n++ ) {
-		
-		// if current knot differs from the previous, add this knot
-		if( inKnots[n] != inKnots[n-1] ) {
-			interestingK[ count ] = inKnots[n] ;
-			count++ ;
+		alpha = (u - knots[i]) / (knots[i + order - 1] - knots[i]);
+
+		newPoints[i - (span + 2 - order)].x = (1.0f - alpha) * prevPoint.x + alpha * thePoint.x;
+		newPoints[i - (span + 2 - order)].y = (1.0f - alpha) * prevPoint.y + alpha * thePoint.y;
+		newPoints[i - (span + 2 - order)].z = (1.0f - alpha) * prevPoint.z + alpha * thePoint.z;
+		newPoints[i - (span + 2 - order)].w = (1.0f - alpha) * prevPoint.w + alpha * thePoint.w;
 		}
-		
-	} // ~for( n in knot vector )
-	
-#if Q3_DEBUG
-	Q3_ASSERT( count <= numPoints - order + 2 ) ;
-#endif
-	return (TQ3Uns32) count ;
+
+
+
+	// Replace the order-2 affected points with order-1 new ones
+	controlPoints.insert( controlPoints.begin() + span, controlPoints[span] );
+
+	for (i = 0; i < order - 1; i++)
+		controlPoints[span + 2 - order + i] = newPoints[i];
+
+	knots.insert( knots.begin() + span + 1, u );
 }
 
 
@@ -353,64 +361,44 @@ e3geom_nurbcurve_interesting_knots( const float * inKnots, TQ3Uns32 numPoints, T
 
 
 //=============================================================================
-//      e3geom_nurbcurve_constant_subdiv : Subdivide the given NURB curve into
-//										   the some number of segments.
+//      e3geom_nurbcurve_bezier_evaluate : Evaluate a Bézier span.
 //-----------------------------------------------------------------------------
-//		Note :	If the vertex array is non-nullptr on return, be sure to free it
-//				with Q3Memory_Free(). If it is nullptr, then an error has occured.
+//		Note :	De Casteljau's algorithm on homogeneous control points,
+//				returning x, y, z, w in outPoint.
+//
+//				This is done in double precision since the points seed a
+//				forward difference table, where rounding errors in the
+//				start points are amplified with every step.
 //-----------------------------------------------------------------------------
 static void
-e3geom_nurbcurve_constant_subdiv( TQ3Vertex3D** theVertices, TQ3Uns32* numPoints, float subdivU, const TQ3NURBCurveData *geomData )
-{	float		*interestingU, increment, ooSubdivU ;
-	TQ3Uns32	n, i, numInt, numSubdivU ;
-	
-	numSubdivU = (TQ3Uns32) subdivU ;
-	ooSubdivU = 1.0f / subdivU ;
-	
-	// Find the interesting knots (ie skip the repeated knots)
-	interestingU = (float *) Q3Memory_Allocate(static_cast<TQ3Uns32>((geomData->numPoints - geomData->order + 2) * sizeof(float)));
-	if (interestingU == nullptr) {
-		*theVertices = nullptr ;
-		return ;
-	}
-	numInt = e3geom_nurbcurve_interesting_knots( geomData->knots, geomData->numPoints, geomData->order, interestingU );
-	/*
-	// we don't need to find the interesting knots, we can expend useless effort ;)
-	// NOTE: if you uncomment this code, be sure to comment out the Q3Memory_Free at the end of this function
-	interestingU = geomData->knots ;
-	numInt = geomData->numPoints + geomData->order ;
-	*/
-	*numPoints = (numInt - 1) * numSubdivU + 1 ;
-	
-	// We may want to limit the number of points at some point
-	//numPoints = E3Num_Clamp(numPoints, 3, 256);
-	
-	
-	// Allocate the memory we need (zeroed since we don't need the attribute set field, and want it cleared)
-	*theVertices = (TQ3Vertex3D *) Q3Memory_AllocateClear(static_cast<TQ3Uns32>(*numPoints * sizeof(TQ3Vertex3D)));
-	if (*theVertices == nullptr)
-		return ;
-	
-	// Now calculate the vertices of the polyLine
-	for( n = 0 ; n < numInt - 1 ; n++ ) {
-		increment = (interestingU[n+1] - interestingU[n]) * ooSubdivU ;
-		
-		for( i = 0 ; i < numSubdivU ; i++ ) {
-				e3geom_nurbcurve_evaluate_nurbs_curve_u(
-										interestingU[n] + ((float)i)*increment,
-										geomData,
-										&(*theVertices)[n*numSubdivU + i].point
-										) ;
+e3geom_nurbcurve_bezier_evaluate( const TQ3RationalPoint4D *spanPoints, TQ3Uns32 order, double t, double *outPoint )
+{	double		thePoints[kQ3NURBCurveMaxOrder][4];
+	TQ3Uns32	i, r;
+
+
+
+	// Repeatedly interpolate between the control points
+	for (i = 0; i < order; i++)
+		{
+		thePoints[i][0] = spanPoints[i].x;
+		thePoints[i][1] = spanPoints[i].y;
+		thePoints[i][2] = spanPoints[i].z;
+		thePoints[i][3] = spanPoints[i].w;
 		}
-	} // ~for( n in numInt )
-	
-	// Final evaluation
-	e3geom_nurbcurve_evaluate_nurbs_curve_u(
-										interestingU[numInt - 1],
-										geomData,
-										&(*theVertices)[*numPoints - 1].point);
-	
-	Q3Memory_Free(&interestingU);
+
+	for (r = 1; r < order; r++)
+		{
+		for (i = 0; i < order - r; i++)
+			{
+			thePoints[i][0] += t * (thePoints[i + 1][0] - thePoints[i][0]);
+			thePoints[i][1] += t * (thePoints[i + 1][1] - thePoints[i][1]);
+			thePoints[i][2] += t * (thePoints[i + 1][2] - thePoints[i][2]);
+			thePoints[i][3] += t * (thePoints[i + 1][3] - thePoints[i][3]);
+			}
+		}
+
+	for (i = 0; i < 4; i++)
+		outPoint[i] = thePoints[0][i];
 }
 
 
@@ -418,321 +406,155 @@ e3geom_nurbcurve_constant_subdiv( TQ3Vertex3D** theVertices, TQ3Uns32* numPoints
 
 
 //=============================================================================
-//      e3geom_nurbcurve_world_subdiv : Subdivide the given NURB curve into
-//										segments of a fixed world-space length.
+//      e3geom_nurbcurve_span_length : Length of a span's control polygon.
 //-----------------------------------------------------------------------------
-//		Note :	If the vertex array is non-nullptr on return, be sure to free it
-//				with Q3Memory_Free(). If it is nullptr, then an error has occured.
+//		Note :	The control polygon of a Bézier span is never shorter than
+//				the span itself, so it gives a cheap bound on how many
+//				segments the span needs.
 //-----------------------------------------------------------------------------
-#define REALLOC_VERTS 5
-static void
-e3geom_nurbcurve_world_subdiv( TQ3Vertex3D** theVertices, TQ3Uns32* numPoints, float subdivU, const TQ3NURBCurveData *geomData, TQ3ViewObject theView )
-{	float		*interestingU, a, b, last, lengthDiff, step ;
-	TQ3Point3D	Ua, Ub, WorldUa, WorldUb ;
-	TQ3Uns32	numInt, numVerts = 0, maxVerts, n ;
-	TQ3Boolean	attained, increasing ;
-	// To cache the local -> world matrix
-	TQ3Matrix4x4	localToWorld ;
-
-	*theVertices = nullptr ;
-	*numPoints = 0 ;
-	
-	// Sanity check subdivU
-	if( subdivU < 0.001f )
-		subdivU = 0.001f ;
-	
-	// square subdivU to save a bunch of sqrt's later
-	subdivU *= subdivU ;
-	
-	// cache the localToWorld matrix for theView
-	Q3View_GetLocalToWorldMatrixState(theView, &localToWorld);
-	
-	// Find the interesting knots (ie skip the repeated knots)
-	interestingU = (float *) Q3Memory_Allocate(static_cast<TQ3Uns32>((geomData->numPoints - geomData->order + 2) * sizeof(float)));
-	if (interestingU == nullptr) {
-		*theVertices = nullptr ;
-		return ;
-	}
-	numInt = e3geom_nurbcurve_interesting_knots( geomData->knots, geomData->numPoints, geomData->order, interestingU );
-	a = interestingU[0] ;
-	last = interestingU[numInt - 1] ;
-	
-	// Allocate the memory we need for the PolyLine (zeroed since we don't
-	// need the attribute set field, and want it cleared to nullptr).
-	// Because we don't know how many points we will have in our subdivision, we
-	// will allocate a projected number of vertices and reallocate in chunks as we need more.
-	maxVerts = (TQ3Uns32)( numInt + ( last - a ) / subdivU )  + REALLOC_VERTS;
-	if( maxVerts > 1000 ) maxVerts = 1000 ;
-	*theVertices = (TQ3Vertex3D *) Q3Memory_AllocateClear( static_cast<TQ3Uns32>(maxVerts * sizeof(TQ3Vertex3D)) );
-	if (*theVertices == nullptr) {
-		return ;
-	}
-	
-	// Now calculate the vertices of the polyLine
-	e3geom_nurbcurve_evaluate_nurbs_curve_u( a,
-											 geomData,
-											 &Ua ) ;
-	Ub = Ua ;
-	
-	Q3Point3D_Transform( &Ua, &localToWorld, &WorldUa ) ;
-	WorldUb = WorldUa ;
-	
-	for( n = 0 ; n < numInt -1 ; n++ ) {
-		a = interestingU[ n ] ;
-		last = interestingU[ n + 1 ] ;
-		
-		step = ( last - a ) ; //* 0.5f ;
-		
-		do {
-		
-	#if Q3_DEBUG
-		Q3_ASSERT( numVerts <= maxVerts ) ;
-	#endif
-			if( numVerts > maxVerts -2 ) {
-				maxVerts += REALLOC_VERTS ;
-				if( kQ3Failure == Q3Memory_Reallocate( theVertices, static_cast<TQ3Uns32>(maxVerts * sizeof(TQ3Vertex3D)) ) ) {
-					*theVertices = nullptr ;
-					Q3Memory_Free(&interestingU);
-					return ;
-				}
-				Q3Memory_Clear( (*theVertices) + numVerts, static_cast<TQ3Uns32>((maxVerts - numVerts) * sizeof(TQ3Vertex3D)) ) ;
-			}
-			
-			(*theVertices)[ numVerts++ ].point = Ua = Ub ;
-			WorldUa = WorldUb ;
-
-			increasing = kQ3True ;		
-			b = a + step ;
-
-			attained = kQ3False ;		
-			do{
-				
-				if( b > last )
-					b = last ;
-				else
-				if( b < a )
-					b = a ;
-				
-				e3geom_nurbcurve_evaluate_nurbs_curve_u( b,
-														 geomData,
-														 &Ub );
-				
-				// This distance calculation is the difference between world and screen subdivision
-				Q3Point3D_Transform( &Ub, &localToWorld, &WorldUb ) ;
-				lengthDiff = Q3Point3D_DistanceSquared( &WorldUa, &WorldUb ) - subdivU ;
-				
-				
-				if( b == a ) {
-					step /= 2.0f ;
-					
-					increasing = kQ3True ;
-					b = a + step ;
-				}
-				else if( lengthDiff > 0 ) { //= threshold ) {
-					
-					// If last iteration we overstepped,
-					// half the step and go the other direction
-					if( increasing )
-						step /= 2.0f ;
-					
-					increasing = kQ3False ;				
-					b -= step ;
-				}
-				else {
-					attained = kQ3True ;
-				}
-			
-			// How small does step get?
-			//Q3_ASSERT( step > 0.00001 ) ;
-			
-			} while( !attained ) ;
-			
-			step = ( last - b ) ; //* 0.5 ;
-			a = b ;
-			
-		} while( b < last ) ;
-		
-		(*theVertices)[ numVerts++ ].point = Ub ;
-		
-	}
-	
-#if Q3_DEBUG
-	Q3_ASSERT( numVerts <= maxVerts ) ;
-#endif
-	
-	*numPoints = numVerts ;
-	
-	Q3Memory_Free(&interestingU);
+static float
+e3geom_nurbcurve_span_length( const TQ3RationalPoint4D *spanPoints, TQ3Uns32 order,
+							  const TQ3Matrix4x4 *localToTarget, TQ3Boolean isScreenSpace )
+{	TQ3Point3D		thePoint, prevPoint;
+	float			theLength, oow;
+	TQ3Uns32		i;
+
+
+
+	// Sum the lengths of the control polygon edges
+	theLength = 0.0f;
+	prevPoint.x = prevPoint.y = prevPoint.z = 0.0f;
+
+	for (i = 0; i < order; i++)
+		{
+		oow = 1.0f / spanPoints[i].w;
+		thePoint.x = spanPoints[i].x * oow;
+		thePoint.y = spanPoints[i].y * oow;
+		thePoint.z = spanPoints[i].z * oow;
+
+		Q3Point3D_Transform( &thePoint, localToTarget, &thePoint );
+		if (isScreenSpace)
+			thePoint.z = 0.0f;
+
+		if (i != 0)
+			theLength += Q3Point3D_Distance( &prevPoint, &thePoint );
+
+		prevPoint = thePoint;
+		}
+
+	return(theLength);
 }
-#undef REALLOC_VERTS
 
 
 
 
 
 //=============================================================================
-//      e3geom_nurbcurve_screen_subdiv : Subdivide the given NURB curve into
-//										 segments of a fixed screen length.
+//      e3geom_nurbcurve_subdivide : Subdivide the curve into a PolyLine.
 //-----------------------------------------------------------------------------
-//		Note :	If the vertex array is non-nullptr on return, be sure to free it
-//				with Q3Memory_Free(). If it is nullptr, then an error has occured.
+//		Note :	For constant subdivision, each span is split into subdivU
+//				segments. For world and screen subdivision, each span is
+//				split so that its segments are at most subdivU long in world
+//				or window coordinates.
+//
+//				If the vertex array is non-nullptr on return, be sure to free
+//				it with Q3Memory_Free(). If it is nullptr, then an error has
+//				occurred.
 //-----------------------------------------------------------------------------
-#define REALLOC_VERTS 5
 static void
-e3geom_nurbcurve_screen_subdiv( TQ3Vertex3D** theVertices, TQ3Uns32* numPoints, float subdivU, const TQ3NURBCurveData *geomData, TQ3ViewObject theView )
-{	float			*interestingU, a, b, last, lengthDiff, step ;
-	TQ3Point3D		Ua, Ub, transformPoint ;
-	TQ3Point2D		ScreenUa, ScreenUb ;
-	TQ3Uns32		numInt, numVerts = 0, maxVerts, n ;
-	TQ3Boolean		attained, increasing ;
-	// To cache the local -> screen matrix
-	TQ3Matrix4x4	localToWorld, worldToFrustum, frustumToWindow, localToWindow ;
-	
-	*theVertices = nullptr ;
-	*numPoints = 0 ;
-	
-	// Sanity check subdivU
-	if( subdivU < 1.0f )
-		subdivU = 1.0f ;
-	
-	// truncate subdivU as per the spec
-	subdivU = (float) floor( subdivU ) ;
-	// square subdivU to save a bunch of sqrt's later
-	subdivU *= subdivU ;
-	
-	
-	// cache the localToWindow matrix for theView
-	Q3View_GetLocalToWorldMatrixState(theView, &localToWorld);
-	Q3View_GetWorldToFrustumMatrixState(theView,  &worldToFrustum);
-	Q3View_GetFrustumToWindowMatrixState(theView, &frustumToWindow);
-	
-	Q3Matrix4x4_Multiply(&localToWorld, &worldToFrustum, &localToWindow);
-	Q3Matrix4x4_Multiply(&localToWindow, &frustumToWindow, &localToWindow);
-	
-	
-	// Find the interesting knots (ie skip the repeated knots)
-	interestingU = (float *) Q3Memory_Allocate(static_cast<TQ3Uns32>((geomData->numPoints - geomData->order + 2) * sizeof(float)));
-	if (interestingU == nullptr) {
-		*theVertices = nullptr ;
-		return ;
-	}
-	numInt = e3geom_nurbcurve_interesting_knots( geomData->knots, geomData->numPoints, geomData->order, interestingU );
-	a = interestingU[0] ;
-	last = interestingU[numInt - 1] ;
-	
-	// Allocate the memory we need for the PolyLine (zeroed since we don't
-	// need the attribute set field, and want it cleared to nullptr).
-	// Because we don't know how many points we will have in our subdivision, we
-	// will allocate a projected number of vertices and reallocate in chunks as we need more.
-	maxVerts = (TQ3Uns32)( numInt + ( last - a ) / subdivU )  + REALLOC_VERTS ;
-	if( maxVerts > 1000 ) maxVerts = 1000 ;
-	*theVertices = (TQ3Vertex3D *) Q3Memory_AllocateClear( static_cast<TQ3Uns32>(maxVerts * sizeof(TQ3Vertex3D)) );
-	if (*theVertices == nullptr) {
-		return ;
-	}
-	
-	// Now calculate the vertices of the polyLine
-	e3geom_nurbcurve_evaluate_nurbs_curve_u( a,
-											 geomData,
-											 &Ua ) ;
-	Ub = Ua ;
-	
-	Q3Point3D_Transform( &Ua, &localToWindow, &transformPoint ) ;
-	ScreenUa.x = transformPoint.x ;
-	ScreenUa.y = transformPoint.y ;
-	
-	ScreenUb = ScreenUa ;
-	
-	for( n = 0 ; n < numInt -1 ; n++ ) {
-		a = interestingU[ n ] ;
-		last = interestingU[ n + 1 ] ;
-		
-		step = ( last - a ) ;
-		
-		do {
-		
-	#if Q3_DEBUG
-		Q3_ASSERT( numVerts <= maxVerts ) ;
-	#endif
-			if( numVerts > maxVerts -2 ) {
-				maxVerts += REALLOC_VERTS ;
-				if( kQ3Failure == Q3Memory_Reallocate( theVertices, static_cast<TQ3Uns32>(maxVerts * sizeof(TQ3Vertex3D)) ) ) {
-					*theVertices = nullptr ;
-					Q3Memory_Free(&interestingU);
-					return ;
-				}
-				Q3Memory_Clear( (*theVertices) + numVerts, static_cast<TQ3Uns32>((maxVerts - numVerts) * sizeof(TQ3Vertex3D)) ) ;
+e3geom_nurbcurve_subdivide( TQ3Vertex3D** theVertices, TQ3Uns32* numPoints,
+							const TQ3SubdivisionStyleData *subdivisionData,
+							const TE3NURBCurveBezierData *bezierData, TQ3ViewObject theView )
+{	std::vector<TQ3Uns32>	numSegments( bezierData->numSpans );
+	TQ3Matrix4x4			localToTarget, worldToFrustum, frustumToWindow;
+	TQ3Boolean				isScreenSpace;
+	TQ3RationalPoint4D		spanSamples[kMaxSpanSubdivision];
+	float					subdivU, theLength, oow;
+	TQ3Uns32				n, i, numVerts;
+	const TQ3RationalPoint4D	*spanPoints;
+
+
+
+	// Work out the matrix to measure lengths in
+	*theVertices  = nullptr;
+	*numPoints    = 0;
+	subdivU       = subdivisionData->c1;
+	isScreenSpace = (TQ3Boolean) (subdivisionData->method == kQ3SubdivisionMethodScreenSpace);
+
+	if (subdivisionData->method != kQ3SubdivisionMethodConstant)
+		{
+		Q3View_GetLocalToWorldMatrixState(theView, &localToTarget);
+
+		if (isScreenSpace)
+			{
+			// truncate subdivU as per the spec
+			subdivU = (float) floor( E3Num_Max(subdivU, 1.0f) );
+
+			Q3View_GetWorldToFrustumMatrixState(theView,  &worldToFrustum);
+			Q3View_GetFrustumToWindowMatrixState(theView, &frustumToWindow);
+
+			Q3Matrix4x4_Multiply(&localToTarget, &worldToFrustum,  &localToTarget);
+			Q3Matrix4x4_Multiply(&localToTarget, &frustumToWindow, &localToTarget);
 			}
-			
-			(*theVertices)[ numVerts++ ].point = Ua = Ub ;
-			ScreenUa = ScreenUb ;
-			
-			increasing = kQ3True ;
-			b = a + step ;
-			
-			attained = kQ3False ;
-			do{
-				
-				if( b > last )
-					b = last ;
-				else
-				if( b < a )
-					b = a ;
-				
-				e3geom_nurbcurve_evaluate_nurbs_curve_u( b,
-														 geomData,
-														 &Ub );
-				
-				// This distance calculation is the difference between world and screen subdivision
-				Q3Point3D_Transform( &Ub, &localToWindow, &transformPoint ) ;
-				ScreenUb.x = transformPoint.x ;
-				ScreenUb.y = transformPoint.y ;
-				lengthDiff = Q3Point2D_DistanceSquared( &ScreenUa, &ScreenUb ) - subdivU ;
-				
-				
-				if( b == a ) {
-					step /= 2.0f ;
-					
-					increasing = kQ3True ;
-					b = a + step ;
-				}
-				else if( lengthDiff > 0 ) { //= threshold ) {
-					
-					// If last iteration we overstepped,
-					// half the step and go the other direction
-					if( increasing )
-						step /= 2.0f ;
-					
-					increasing = kQ3False ;				
-					b -= step ;
-				}
-				else {
-					attained = kQ3True ;
-				}
-			
-			// How small does step get?
-			//Q3_ASSERT( step > 0.00001 ) ;
-			
-			} while( !attained ) ;
-			
-			step = last - b ;
-			a = b ;
-			
-		} while( b < last ) ;
-		
-		(*theVertices)[ numVerts++ ].point = Ub ;
-		
-	}
-	
-#if Q3_DEBUG
-	Q3_ASSERT( numVerts <= maxVerts ) ;
-#endif
-	
-	*numPoints = numVerts ;
-	
-	Q3Memory_Free(&interestingU);
+		else
+			subdivU = E3Num_Max(subdivU, 0.001f);
+		}
+
+
+
+	// Choose the number of segments for each span
+	numVerts = 1;
+
+	for (n = 0; n < bezierData->numSpans; n++)
+		{
+		spanPoints = &bezierData->controlPoints[n * bezierData->order];
+
+		if (subdivisionData->method == kQ3SubdivisionMethodConstant)
+			numSegments[n] = (TQ3Uns32) E3Num_Clamp(subdivU, 1.0f, (float) kMaxSpanSubdivision);
+		else
+			{
+			theLength      = e3geom_nurbcurve_span_length( spanPoints, bezierData->order, &localToTarget, isScreenSpace );
+			numSegments[n] = (TQ3Uns32) E3Num_Clamp(ceil( theLength / subdivU ), 1.0f, (float) kMaxSpanSubdivision);
+			}
+
+		numVerts += numSegments[n];
+		}
+
+
+
+	// Allocate the vertices (zeroed since we don't need the attribute set field, and want it cleared)
+	*theVertices = (TQ3Vertex3D *) Q3Memory_AllocateClear( static_cast<TQ3Uns32>(numVerts * sizeof(TQ3Vertex3D)) );
+	if (*theVertices == nullptr)
+		return;
+
+
+
+	// Sample each span, and finally the end of the curve
+	numVerts = 0;
+
+	for (n = 0; n < bezierData->numSpans; n++)
+		{
+		spanPoints = &bezierData->controlPoints[n * bezierData->order];
+
+		E3NURBCurve_BezierSample( spanPoints, bezierData->order, numSegments[n], spanSamples );
+
+		for (i = 0; i < numSegments[n]; i++, numVerts++)
+			{
+			oow = 1.0f / spanSamples[i].w;
+			(*theVertices)[numVerts].point.x = spanSamples[i].x * oow;
+			(*theVertices)[numVerts].point.y = spanSamples[i].y * oow;
+			(*theVertices)[numVerts].point.z = spanSamples[i].z * oow;
+			}
+		}
+
+	spanPoints = &bezierData->controlPoints[(bezierData->numSpans - 1) * bezierData->order];
+
+	(*theVertices)[numVerts].point.x = spanPoints[bezierData->order - 1].x / spanPoints[bezierData->order - 1].w;
+	(*theVertices)[numVerts].point.y = spanPoints[bezierData->order - 1].y / spanPoints[bezierData->order - 1].w;
+	(*theVertices)[numVerts].point.z = spanPoints[bezierData->order - 1].z / spanPoints[bezierData->order - 1].w;
+
+	*numPoints = numVerts + 1;
 }
-#undef REALLOC_VERTS
 
 
 
@@ -741,44 +563,69 @@ e3geom_nurbcurve_screen_subdiv( TQ3Vertex3D** theVertices, TQ3Uns32* numPoints,
 //=============================================================================
 //      e3geom_nurbcurve_cache_new : NURBCurve cache new method.
 //-----------------------------------------------------------------------------
+//		Note :	The piecewise Bézier form of a curve object is kept with the
+//				object and only rebuilt when the object is edited, since
+//				world and screen subdivision rebuild the cache whenever the
+//				camera moves.
+//-----------------------------------------------------------------------------
 static TQ3Object
 e3geom_nurbcurve_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 							const void *geomDataParam)
 {
 	const TQ3NURBCurveData* geomData = (const TQ3NURBCurveData*) geomDataParam;
 	TQ3SubdivisionStyleData			subdivisionData;
-	float							subdivU = 10.0f;
+	TE3NURBCurveBezierData			tempBezier = { 0, 0, nullptr };
+	TE3NURBCurveBezierData			*bezierData;
 	TQ3Vertex3D						*theVertices = nullptr;
 	TQ3PolyLineData					polyLineData;
 	TQ3GeometryObject				thePolyLine;
-	TQ3Status						theStatus;
 	TQ3Uns32						numPoints = 0;
 
 
 
-	// Get the subdivision style, and calculate our vertices
-	theStatus = Q3View_GetSubdivisionStyleState(theView, &subdivisionData) ;
-	if( theStatus == kQ3Success )
+	// Find the piecewise Bézier form, converting the curve if it was edited
+	if (theGeom != nullptr)
 		{
-		subdivU = subdivisionData.c1 ;
-		switch( subdivisionData.method ) {
-			case kQ3SubdivisionMethodScreenSpace:
-				e3geom_nurbcurve_screen_subdiv( &theVertices, &numPoints, subdivU, geomData, theView ) ;
-				break ;
-			
-			case kQ3SubdivisionMethodWorldSpace:
-				e3geom_nurbcurve_world_subdiv( &theVertices, &numPoints, subdivU, geomData, theView ) ;
-				break ;
-			
-			case kQ3SubdivisionMethodConstant:
-				e3geom_nurbcurve_constant_subdiv( &theVertices, &numPoints, subdivU, geomData ) ;
-				break ;
-			
-			default:
-				Q3_ASSERT(!"Unknown subdivision method");
-				break;
+		E3NURBCurve*	nurbCurve = (E3NURBCurve*) theGeom;
+
+		bezierData = &nurbCurve->bezierData;
+		if (bezierData->controlPoints == nullptr || nurbCurve->bezierEditIndex != Q3Shared_GetEditIndex( theGeom ))
+			{
+			if (E3NURBCurve_BezierBuild( geomData, bezierData ) != kQ3Success)
+				return(nullptr);
+
+			nurbCurve->bezierEditIndex = Q3Shared_GetEditIndex( theGeom );
 			}
 		}
+	else
+		{
+		bezierData = &tempBezier;
+		if (E3NURBCurve_BezierBuild( geomData, bezierData ) != kQ3Success)
+			return(nullptr);
+		}
+
+	if (bezierData->numSpans == 0)
+		{
+		E3NURBCurve_BezierDispose( &tempBezier );
+		return(nullptr);
+		}
+
+
+
+	// Get the subdivision style, and calculate our vertices
+	if (Q3View_GetSubdivisionStyleState(theView, &subdivisionData) != kQ3Success)
+		{
+		subdivisionData.method = kQ3SubdivisionMethodConstant;
+		subdivisionData.c1     = 10.0f;
+		}
+
+	Q3_ASSERT(subdivisionData.method == kQ3SubdivisionMethodConstant   ||
+			  subdivisionData.method == kQ3SubdivisionMethodWorldSpace ||
+			  subdivisionData.method == kQ3SubdivisionMethodScreenSpace);
+
+	e3geom_nurbcurve_subdivide( &theVertices, &numPoints, &subdivisionData, bezierData, theView );
+
+	E3NURBCurve_BezierDispose( &tempBezier );
 
 	if ( theVertices == nullptr )
 		return(nullptr);
@@ -797,7 +644,7 @@ e3geom_nurbcurve_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 
 	// Clean up
 	Q3Memory_Free(&theVertices);
-	
+
 	return(thePolyLine);
 }
 
@@ -1157,3 +1004,153 @@ E3NURBCurve_IsOfMyClass ( TQ3Object object )
 
 
 
+//=============================================================================
+//      E3NURBCurve_BezierDispose : Dispose of a piecewise Bézier form.
+//-----------------------------------------------------------------------------
+void
+E3NURBCurve_BezierDispose( TE3NURBCurveBezierData *bezierData )
+{
+	Q3Memory_Free( &bezierData->controlPoints );
+
+	bezierData->order    = 0;
+	bezierData->numSpans = 0;
+}
+
+
+
+
+
+//=============================================================================
+//      E3NURBCurve_BezierBuild : Convert a curve to piecewise Bézier form.
+//-----------------------------------------------------------------------------
+//		Note :	Every interesting knot is inserted until it has multiplicity
+//				order-1, at which point the order control points of each
+//				non-empty span are the Bézier control points of that span.
+//				This also handles unclamped knot vectors.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3NURBCurve_BezierBuild( const TQ3NURBCurveData *geomData, TE3NURBCurveBezierData *bezierData )
+{	std::vector<float>					knots( geomData->knots, geomData->knots + geomData->numPoints + geomData->order );
+	std::vector<TQ3RationalPoint4D>		controlPoints( geomData->controlPoints, geomData->controlPoints + geomData->numPoints );
+	std::vector<float>					interestingU( geomData->numPoints - geomData->order + 2 );
+	TQ3Uns32							numInt, n, k, multiplicity, order, numSpans;
+
+
+
+	// Raise the multiplicity of every interesting knot to order-1
+	order  = geomData->order;
+	numInt = e3geom_nurbcurve_interesting_knots( geomData->knots, geomData->numPoints, geomData->order, &interestingU[0] );
+
+	for (n = 0; n < numInt; n++)
+		{
+		multiplicity = 0;
+		for (k = 0; k < knots.size(); k++)
+			{
+			if (knots[k] == interestingU[n])
+				multiplicity++;
+			}
+
+		for (; multiplicity < order - 1; multiplicity++)
+			e3geom_nurbcurve_insert_knot( interestingU[n], order, knots, controlPoints );
+		}
+
+
+
+	// Collect the control points of the non-empty spans
+	E3NURBCurve_BezierDispose( bezierData );
+
+	bezierData->controlPoints = (TQ3RationalPoint4D *) Q3Memory_Allocate( static_cast<TQ3Uns32>((numInt - 1) * order * sizeof(TQ3RationalPoint4D)) );
+	if (bezierData->controlPoints == nullptr)
+		return(kQ3Failure);
+
+	numSpans = 0;
+	for (k = order - 1; k < controlPoints.size(); k++)
+		{
+		if (knots[k] < knots[k + 1] && knots[k] >= interestingU[0] && knots[k + 1] <= interestingU[numInt - 1])
+			{
+			Q3_ASSERT(numSpans < numInt - 1);
+			Q3Memory_Copy( &controlPoints[k + 1 - order], &bezierData->controlPoints[numSpans * order],
+						   static_cast<TQ3Uns32>(order * sizeof(TQ3RationalPoint4D)) );
+			numSpans++;
+			}
+		}
+
+	bezierData->order    = order;
+	bezierData->numSpans = numSpans;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3NURBCurve_BezierSample : Sample a Bézier span at equal steps.
+//-----------------------------------------------------------------------------
+//		Note :	Writes numSegments homogeneous points at t = 0 ..
+//				(numSegments-1)/numSegments, the end of the span being the
+//				start of the next one.
+//
+//				The first order points are found with de Casteljau, and the
+//				rest by forward differencing, so each subsequent point costs
+//				order-1 additions rather than a full evaluation.
+//-----------------------------------------------------------------------------
+void
+E3NURBCurve_BezierSample( const TQ3RationalPoint4D *spanPoints, TQ3Uns32 order, TQ3Uns32 numSegments,
+							TQ3RationalPoint4D *outPoints )
+{	double				theDiffs[kQ3NURBCurveMaxOrder][4];
+	TQ3Uns32			i, r, numStart;
+
+
+
+	// Evaluate the start of the span directly
+	numStart = E3Num_Min(order, numSegments);
+
+	for (i = 0; i < numStart; i++)
+		e3geom_nurbcurve_bezier_evaluate( spanPoints, order, (double) i / (double) numSegments, theDiffs[i] );
+
+
+
+	// Build the forward difference table in place, theDiffs[r] = delta^r P(0)
+	if (numStart == order)
+		{
+		for (r = 1; r < order; r++)
+			{
+			for (i = order - 1; i >= r; i--)
+				{
+				theDiffs[i][0] -= theDiffs[i - 1][0];
+				theDiffs[i][1] -= theDiffs[i - 1][1];
+				theDiffs[i][2] -= theDiffs[i - 1][2];
+				theDiffs[i][3] -= theDiffs[i - 1][3];
+				}
+			}
+		}
+
+
+
+	// Output the points, stepping the difference table as we go
+	for (i = 0; i < numSegments; i++)
+		{
+		if (numStart < order)
+			r = i;
+		else
+			r = 0;
+
+		outPoints[i].x = (float) theDiffs[r][0];
+		outPoints[i].y = (float) theDiffs[r][1];
+		outPoints[i].z = (float) theDiffs[r][2];
+		outPoints[i].w = (float) theDiffs[r][3];
+
+		if (numStart == order)
+			{
+			for (r = 0; r < order - 1; r++)
+				{
+				theDiffs[r][0] += theDiffs[r + 1][0];
+				theDiffs[r][1] += theDiffs[r + 1][1];
+				theDiffs[r][2] += theDiffs[r + 1][2];
+				theDiffs[r][3] += theDiffs[r + 1][3];
+				}
+			}
+		}
+}
@@ -62,6 +62,21 @@ extern "C" {
 
 
 
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+// Piecewise Bézier form of a NURB curve, with order homogeneous control
+// points for each non-empty knot span.
+typedef struct TE3NURBCurveBezierData {
+	TQ3Uns32					order;
+	TQ3Uns32					numSpans;
+	TQ3RationalPoint4D			*controlPoints;
+} TE3NURBCurveBezierData;
+
+
+
+
+
 //=============================================================================
 //      Function prototypes
 //-----------------------------------------------------------------------------
@@ -80,6 +95,10 @@ TQ3Status			E3NURBCurve_GetKnot(TQ3GeometryObject theCurve, TQ3Uns32 knotIndex,
 TQ3Status			E3NURBCurve_GetNumPoints ( TQ3GeometryObject theCurve, TQ3Uns32* numPoints ) ;
 TQ3Boolean			E3NURBCurve_IsOfMyClass ( TQ3Object object ) ;
 
+TQ3Status			E3NURBCurve_BezierBuild(const TQ3NURBCurveData *curveData, TE3NURBCurveBezierData *bezierData);
+void				E3NURBCurve_BezierDispose(TE3NURBCurveBezierData *bezierData);
+void				E3NURBCurve_BezierSample(const TQ3RationalPoint4D *spanPoints, TQ3Uns32 order, TQ3Uns32 numSegments, TQ3RationalPoint4D *outPoints);
+
 
 
 
@@ -47,7 +47,11 @@
 #include "E3View.h"
 #include "E3Geometry.h"
 #include "E3GeometryTriMesh.h"
+#include "E3GeometryNURBCurve.h"
 #include "E3GeometryNURBPatch.h"
+#include "E3Parallel.h"
+
+#include <vector>
 
 
 
@@ -56,7 +60,14 @@
 //=============================================================================
 //      Internal constants
 //-----------------------------------------------------------------------------
-#define		kFiniteSubdivision		32
+// Number of samples per knot span used to estimate world/screen subdivisions
+#define		kEstimateSamplesPerSpan		4
+
+// Maximum number of segments in a knot span
+#define		kMaxSpanSubdivision			256
+
+// Minimum number of grid vertices worth evaluating on another thread
+#define		kParallelVerticesPerThread	4096
 
 
 
@@ -77,7 +88,50 @@ public :
 	TQ3NURBPatchData			instanceData ;
 
 	} ;
-	
+
+
+
+// Basis functions precomputed for a list of parameter values. For each
+// parameter we store the index of the first non-zero basis function, and
+// the order values (and optionally derivatives) of the non-zero functions.
+typedef struct TE3NURBPatchBasisTable {
+	TQ3Uns32					order;
+	std::vector<TQ3Uns32>		firstIndex;
+	std::vector<float>			values;
+	std::vector<float>			derivs;
+} TE3NURBPatchBasisTable;
+
+
+// Piecewise Bézier form of a patch in u. Each row of control points is
+// replaced by uOrder homogeneous Bézier control points for each non-empty
+// u knot span, so an iso-curve at any v is a blend of vOrder of these rows.
+typedef struct TE3NURBPatchBezierRows {
+	TQ3Uns32							numSpans;
+	TQ3Uns32							rowSize;
+	std::vector<TQ3RationalPoint4D>		controlPoints;
+} TE3NURBPatchBezierRows;
+
+
+// Number of segments for each knot span, for the interior of the patch
+// and for each of its four boundary edges.
+typedef struct TE3NURBPatchSubdivision {
+	std::vector<TQ3Uns32>		uSpans;
+	std::vector<TQ3Uns32>		vSpans;
+	std::vector<TQ3Uns32>		bottomSpans;
+	std::vector<TQ3Uns32>		topSpans;
+	std::vector<TQ3Uns32>		leftSpans;
+	std::vector<TQ3Uns32>		rightSpans;
+} TE3NURBPatchSubdivision;
+
+
+// Tessellated patch
+typedef struct TE3NURBPatchTessellation {
+	std::vector<TQ3Point3D>				points;
+	std::vector<TQ3Vector3D>			normals;
+	std::vector<TQ3Param2D>				uvs;
+	std::vector<TQ3TriMeshTriangleData>	triangles;
+} TE3NURBPatchTessellation;
+
 
 
 //=============================================================================
@@ -282,47 +336,53 @@ e3geom_nurbpatch_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 
 
 //=============================================================================
-//      e3geom_nurbpatch_evaluate_basis : Evaluate the basis.
+//      e3geom_nurbpatch_find_span : Find the knot span containing a parameter.
 //-----------------------------------------------------------------------------
-//		Note :	This is the recursive definition, as in the Schneider article.
-//				fracR = 1 - fracL.  That's why non-recursive versions are so
-//				fast, they take one-minus over and over again.
+//		Note :	Returns the index s of the span knots[s] <= u < knots[s+1],
+//				with s in [order-1, numPoints-1].  The end of the parameter
+//				range is assigned to the last non-empty span.
 //-----------------------------------------------------------------------------
-static float
-e3geom_nurbpatch_evaluate_basis( float u, TQ3Uns32 i, TQ3Uns32 k, float *knots )
-{	float bottomL, bottomR, fracL, fracR, theResult;
+static TQ3Uns32
+e3geom_nurbpatch_find_span( float u, TQ3Uns32 numPoints, TQ3Uns32 order, const float *knots )
+{	TQ3Uns32	low, high, mid;
+
 
 
-	if ( k == 1 ) {
-		if ( u >= knots[i] && u <= knots[i+1] )
-			theResult = 1.0f ;
+	// Handle the ends of the range
+	if (u >= knots[numPoints])
+		{
+		mid = numPoints - 1;
+		while (mid > order - 1 && knots[mid] >= knots[numPoints])
+			mid--;
+		return(mid);
+		}
+
+	if (u <= knots[order - 1])
+		{
+		mid = order - 1;
+		while (mid < numPoints - 1 && knots[mid + 1] <= knots[order - 1])
+			mid++;
+		return(mid);
+		}
+
+
+
+	// Binary search for the span
+	low  = order - 1;
+	high = numPoints;
+	mid  = (low + high) / 2;
+
+	while (u < knots[mid] || u >= knots[mid + 1])
+		{
+		if (u < knots[mid])
+			high = mid;
 		else
-			theResult = 0.0f ;
-	}
-	
-	else {
-		bottomL = ( knots[i+k-1] - knots[i] ) ;
-		fracL =
-			( bottomL <= kQ3RealZero ) ? 0.0f : // floating point inaccuracies
-			( u - knots[i] ) / bottomL ;
-		bottomR = ( knots[i+k] - knots[i+1] ) ;
-		fracR =
-			( bottomR <= kQ3RealZero ) ? 0.0f : // fp inaccuracies
-			( knots[i+k] - u ) / bottomR ;
-			
-		// stops recursing if we already know the result will be 0
-		if ( fracL > kQ3RealZero ) // fp inaccuracies
-			fracL *= e3geom_nurbpatch_evaluate_basis(u,i,k-1,knots) ;
-		else fracL = 0.0f ;
-			
-		if ( fracR > kQ3RealZero ) // fp inaccuracies
-			fracR *= e3geom_nurbpatch_evaluate_basis(u,i+1,k-1,knots) ;
-		else fracR = 0.0f ;
-		
-		theResult = fracL + fracR ;
-	}
-	
-	return theResult;
+			low = mid;
+
+		mid = (low + high) / 2;
+		}
+
+	return(mid);
 }
 
 
@@ -330,36 +390,90 @@ e3geom_nurbpatch_evaluate_basis( float u, TQ3Uns32 i, TQ3Uns32 k, float *knots )
 
 
 //=============================================================================
-//      e3geom_nurbpatch_evaluate_basis_deriv : Evaluate the basis derivative.
+//      e3geom_nurbpatch_basis_funcs : Evaluate the non-zero basis functions.
 //-----------------------------------------------------------------------------
-//		Note : Also lifted from the B,B,&B book.
+//		Note :	Fills outBasis[0..order-1] with the values of the basis
+//				functions span-order+1 .. span at u, and outDeriv with their
+//				first derivatives.
+//
+//				This is the triangular scheme from Piegl & Tiller's "The NURBS
+//				Book" (A2.2), which only touches the order functions that can
+//				be non-zero rather than recursing over every control point.
 //-----------------------------------------------------------------------------
-static float
-e3geom_nurbpatch_evaluate_basis_deriv( float u, TQ3Uns32 i, TQ3Uns32 k, float *knots )
-{
-	
-	//float theResult ;
-	float bottomL, bottomR, fracL, fracR ;
-	
-	bottomL = ( knots[i+k-1] - knots[i] ) ;
-	fracL =
-		( bottomL <= kQ3RealZero ) ? 0.0f : // floating point inaccuracies
-		1.0f / bottomL ;
-	bottomR = ( knots[i+k] - knots[i+1] ) ;
-	fracR =
-		( bottomR <= kQ3RealZero ) ? 0.0f : // fp inaccuracies
-		1.0f / bottomR ;
-		
-	// stops recursing if we already know the result will be 0
-	if ( fracL > kQ3RealZero )	// fp inaccuracies
-		fracL *= e3geom_nurbpatch_evaluate_basis(u,i,k-1,knots) ;
-	else fracL = 0.0f ;
-		
-	if ( fracR > kQ3RealZero ) // fp inaccuracies
-		fracR *= e3geom_nurbpatch_evaluate_basis(u,i+1,k-1,knots) ;
-	else fracR = 0.0f ;
-	
-	return (k-1)*(fracL - fracR) ;
+static void
+e3geom_nurbpatch_basis_funcs( float u, TQ3Uns32 span, TQ3Uns32 order, const float *knots,
+								float *outBasis, float *outDeriv )
+{	float		left[kQ3NURBPatchMaxOrder], right[kQ3NURBPatchMaxOrder];
+	float		lower[kQ3NURBPatchMaxOrder];
+	float		saved, temp, denom, theDegree;
+	TQ3Uns32	j, r, k;
+
+
+
+	// Evaluate the basis functions of increasing degree
+	outBasis[0] = 1.0f;
+	lower[0]    = 1.0f;
+
+	for (j = 1; j < order; j++)
+		{
+		// Remember the degree-1 values, we need them for the derivatives
+		if (j == order - 1)
+			{
+			for (r = 0; r < j; r++)
+				lower[r] = outBasis[r];
+			}
+
+		left[j]  = u - knots[span + 1 - j];
+		right[j] = knots[span + j] - u;
+		saved    = 0.0f;
+
+		for (r = 0; r < j; r++)
+			{
+			denom = right[r + 1] + left[j - r];
+			temp  = (denom <= kQ3RealZero) ? 0.0f : outBasis[r] / denom;
+
+			outBasis[r] = saved + right[r + 1] * temp;
+			saved       = left[j - r] * temp;
+			}
+
+		outBasis[j] = saved;
+		}
+
+
+
+	// Evaluate the derivatives from the degree-1 basis functions
+	if (outDeriv == nullptr)
+		return;
+
+	if (order == 1)
+		{
+		outDeriv[0] = 0.0f;
+		return;
+		}
+
+	theDegree = (float) (order - 1);
+	for (k = 0; k < order; k++)
+		{
+		TQ3Uns32	i = span + 1 - order + k;
+
+		outDeriv[k] = 0.0f;
+
+		if (k > 0)
+			{
+			denom = knots[i + order - 1] - knots[i];
+			if (denom > kQ3RealZero)
+				outDeriv[k] += lower[k - 1] / denom;
+			}
+
+		if (k < order - 1)
+			{
+			denom = knots[i + order] - knots[i + 1];
+			if (denom > kQ3RealZero)
+				outDeriv[k] -= lower[k] / denom;
+			}
+
+		outDeriv[k] *= theDegree;
+		}
 }
 
 
@@ -367,106 +481,95 @@ e3geom_nurbpatch_evaluate_basis_deriv( float u, TQ3Uns32 i, TQ3Uns32 k, float *k
 
 
 //=============================================================================
-//      e3geom_nurbpatch_evaluate_uv : Evaluate the NURB patch data, computing
-//									   the normal.
+//      e3geom_nurbpatch_basis_table_build : Precompute the basis functions.
 //-----------------------------------------------------------------------------
-//		Note :	Returns the coordinates into outPoint and the normal into
-//				outNormal.
+//		Note :	Fills a basis table for a list of parameter values, so that a
+//				grid of samples only evaluates each u or v basis once.
 //-----------------------------------------------------------------------------
 static void
-e3geom_nurbpatch_evaluate_uv( float u, float v, const TQ3NURBPatchData * patchData, TQ3Vector3D * outNormal, TQ3Point3D * outPoint,
-	float* uBasisValues, float* vBasisValues, float* uBasisDerivValues, float* vBasisDerivValues )
-{
-	
-	TQ3Uns32		iU, jV ;
-	float			xTop, yTop, zTop, xTopDu, yTopDu, zTopDu, xTopDv, yTopDv, zTopDv ;
-	float			OneOverBottom, bottom, bottom_squared, bottomDu, bottomDv ;
-	TQ3Vector3D		dU, dV ;
-	
-	// Let's...
-	xTop = yTop = zTop = bottom = xTopDu = xTopDv = yTopDu = yTopDv = zTopDu = zTopDv = bottomDu = bottomDv = 0.0f ;
-	// Go
-	for ( iU = 0; iU < patchData->numColumns; iU++ ) {
-		uBasisValues[iU] = e3geom_nurbpatch_evaluate_basis( u, iU, patchData->uOrder, patchData->uKnots) ;
-		uBasisDerivValues[iU] = e3geom_nurbpatch_evaluate_basis_deriv( u, iU, patchData->uOrder, patchData->uKnots) ;
-	}
+e3geom_nurbpatch_basis_table_build( const std::vector<float>& theParams,
+									TQ3Uns32 numPoints, TQ3Uns32 order, const float *knots,
+									TQ3Boolean wantDerivs, TE3NURBPatchBasisTable& theTable )
+{	TQ3Uns32	n, span;
 
-	// Again
-	for ( jV = 0; jV < patchData->numRows; jV++ ) {
-		vBasisValues[jV] = e3geom_nurbpatch_evaluate_basis( v, jV, patchData->vOrder, patchData->vKnots) ;
-		vBasisDerivValues[jV] = e3geom_nurbpatch_evaluate_basis_deriv( v, jV, patchData->vOrder, patchData->vKnots) ;
-	}
 
-	// Now some summation rotation recreation, like p. 46-47 in Bartels, Beatty, & Barsky
-	for ( jV = 0; jV < patchData->numRows; jV++ ) {
-		for ( iU = 0; iU < patchData->numColumns; iU++ ) {
-			// First the point
-			xTop += patchData->controlPoints[patchData->numColumns*jV + iU].x * uBasisValues[iU] * vBasisValues[jV] ;
-			yTop += patchData->controlPoints[patchData->numColumns*jV + iU].y * uBasisValues[iU] * vBasisValues[jV] ;
-			zTop += patchData->controlPoints[patchData->numColumns*jV + iU].z * uBasisValues[iU] * vBasisValues[jV] ;
-			bottom += patchData->controlPoints[patchData->numColumns*jV + iU].w * uBasisValues[iU] * vBasisValues[jV] ;
-			/* Now let's take care of the derivatives */
-			/*
-			 * To do the derivative, we must use the chain rule:
-			 * ((low * Dhigh) - (high * Dlow)) / low^2.
-			 *
-			 * So for this upcoming loop, we are building the Du of the individual Top's and the bottom, as well as the Dv of the Top's
-			 * and bottom.
-			 * Then later I will put it together with that chain rule to get my answer.
-			 */
-			// So first Du
-			xTopDu += patchData->controlPoints[patchData->numColumns*jV + iU].x * uBasisDerivValues[iU] * vBasisValues[jV] ;
-			yTopDu += patchData->controlPoints[patchData->numColumns*jV + iU].y * uBasisDerivValues[iU] * vBasisValues[jV] ;
-			zTopDu += patchData->controlPoints[patchData->numColumns*jV + iU].z * uBasisDerivValues[iU] * vBasisValues[jV] ;
-			bottomDu += patchData->controlPoints[patchData->numColumns*jV + iU].w * uBasisDerivValues[iU] * vBasisValues[jV] ;
-			// And next Dv
-			xTopDv += patchData->controlPoints[patchData->numColumns*jV + iU].x * uBasisValues[iU] * vBasisDerivValues[jV] ;
-			yTopDv += patchData->controlPoints[patchData->numColumns*jV + iU].y * uBasisValues[iU] * vBasisDerivValues[jV] ;
-			zTopDv += patchData->controlPoints[patchData->numColumns*jV + iU].z * uBasisValues[iU] * vBasisDerivValues[jV] ;
-			bottomDv += patchData->controlPoints[patchData->numColumns*jV + iU].w * uBasisValues[iU] * vBasisDerivValues[jV] ;
-	}	}
-	
-	
-	// Calculate bottom squared
+
+	// Size the table
+	theTable.order = order;
+	theTable.firstIndex.resize( theParams.size() );
+	theTable.values.resize( theParams.size() * order );
+	theTable.derivs.resize( wantDerivs ? theParams.size() * order : 0 );
+
+
+
+	// Evaluate the non-zero basis functions for each parameter
+	for (n = 0; n < theParams.size(); n++)
+		{
+		span = e3geom_nurbpatch_find_span( theParams[n], numPoints, order, knots );
+		theTable.firstIndex[n] = span + 1 - order;
+
+		e3geom_nurbpatch_basis_funcs( theParams[n], span, order, knots,
+									  &theTable.values[n * order],
+									  wantDerivs ? &theTable.derivs[n * order] : nullptr );
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_nurbpatch_project : Find a point and normal from homogeneous
+//								   derivatives.
+//-----------------------------------------------------------------------------
+//		Note :	theTop is the homogeneous point, and theTopDu and theTopDv
+//				its partial derivatives. See p. 46-47 in Bartels, Beatty, &
+//				Barsky for the derivation of the rational derivatives.
+//-----------------------------------------------------------------------------
+static void
+e3geom_nurbpatch_project( const TQ3RationalPoint4D *theTop,
+						  const TQ3RationalPoint4D *theTopDu,
+						  const TQ3RationalPoint4D *theTopDv,
+						  TQ3Point3D *outPoint, TQ3Vector3D *outNormal )
+{	float			bottom, oneOverBottom;
+	TQ3Vector3D		dU, dV;
+
+
+
+	// Find the point
+	bottom = theTop->w;
+
 	Q3_ASSERT(bottom != 0.0f);
-	bottom_squared = bottom * bottom ;
+	oneOverBottom = 1.0f / bottom;
+	outPoint->x   = theTop->x * oneOverBottom;
+	outPoint->y   = theTop->y * oneOverBottom;
+	outPoint->z   = theTop->z * oneOverBottom;
+
+
+
+	// ((low * Dhigh) - (high * Dlow)) / low^2
+	oneOverBottom = oneOverBottom * oneOverBottom;
+	dU.x = ((bottom * theTopDu->x) - (theTop->x * theTopDu->w)) * oneOverBottom;
+	dU.y = ((bottom * theTopDu->y) - (theTop->y * theTopDu->w)) * oneOverBottom;
+	dU.z = ((bottom * theTopDu->z) - (theTop->z * theTopDu->w)) * oneOverBottom;
+
+	dV.x = ((bottom * theTopDv->x) - (theTop->x * theTopDv->w)) * oneOverBottom;
+	dV.y = ((bottom * theTopDv->y) - (theTop->y * theTopDv->w)) * oneOverBottom;
+	dV.z = ((bottom * theTopDv->z) - (theTop->z * theTopDv->w)) * oneOverBottom;
+
+	Q3FastVector3D_Cross(&dU, &dV, outNormal);
+
 
 
-	// The point
-	OneOverBottom = 1.0f / bottom ;
-	outPoint->x = xTop * OneOverBottom ;
-	outPoint->y = yTop * OneOverBottom ;
-	outPoint->z = zTop * OneOverBottom ;
-	
-	/* The Du vector */
-	// low^2 = bottom^2
-	OneOverBottom = 1.0f / bottom_squared ;
-	// ((low * Dhigh) - (high * Dlow)) / bottom^2
-	dU.x = ((bottom * xTopDu) - (xTop * bottomDu))*OneOverBottom ;
-	dU.y = ((bottom * yTopDu) - (yTop * bottomDu))*OneOverBottom ;
-	dU.z = ((bottom * zTopDu) - (zTop * bottomDu))*OneOverBottom ;
-	
-	/* The Dv vector */
-	// low^2 = bottom^2
-	// OneOverBottom = same as above
-	// ((low * Dhigh) - (high * Dlow)) / bottom^2
-	dV.x = ((bottom * xTopDv) - (xTop * bottomDv))*OneOverBottom ;
-	dV.y = ((bottom * yTopDv) - (yTop * bottomDv))*OneOverBottom ;
-	dV.z = ((bottom * zTopDv) - (zTop * bottomDv))*OneOverBottom ;
-	
-	Q3Vector3D_Cross(&dU, &dV, outNormal);
-	
 	// Normalize the normal vector
 	if (Q3FastVector3D_LengthSquared(outNormal) < kQ3RealZero)
-	{
+		{
 		outNormal->x = 1.0f;	// arbitrary unit vector
 		outNormal->y = 0.0f;
 		outNormal->z = 0.0f;
-	}
+		}
 	else
-	{
 		Q3FastVector3D_Normalize( outNormal, outNormal );
-	}
 }
 
 
@@ -474,48 +577,279 @@ e3geom_nurbpatch_evaluate_uv( float u, float v, const TQ3NURBPatchData * patchDa
 
 
 //=============================================================================
-//      e3geom_nurbpatch_evaluate_uv_no_deriv : Evaluate the NURB patch data
-//												without computing the normal.
+//      e3geom_nurbpatch_evaluate_table : Evaluate the patch from basis tables.
 //-----------------------------------------------------------------------------
-//		Note :	Returns the coordinates into outPoint
+//		Note :	Evaluates the point at (uTable[uIndex], vTable[vIndex]). If
+//				outNormal is non-nullptr, the tables must contain derivatives
+//				and the unit normal is returned as well.
+//
+//				Only the uOrder x vOrder control points which influence the
+//				point are visited.
 //-----------------------------------------------------------------------------
 static void
-e3geom_nurbpatch_evaluate_uv_no_deriv( float u, float v, const TQ3NURBPatchData * patchData, TQ3Point3D * outPoint,
-	float* uBasisValues, float* vBasisValues )
-{
-	
-	TQ3Uns32		iU, jV ;
-	float			xTop, yTop, zTop ;
-	float			OneOverBottom, bottom ;
-	
-	// Let's...
-	xTop = yTop = zTop = bottom = 0.0f ;
-	// Go
-	for ( iU = 0; iU < patchData->numColumns; iU++ ) {
-		uBasisValues[iU] = e3geom_nurbpatch_evaluate_basis( u, iU, patchData->uOrder, patchData->uKnots) ;
-	}
+e3geom_nurbpatch_evaluate_table( const TQ3NURBPatchData *patchData,
+								 const TE3NURBPatchBasisTable& uTable, TQ3Uns32 uIndex,
+								 const TE3NURBPatchBasisTable& vTable, TQ3Uns32 vIndex,
+								 TQ3Point3D *outPoint, TQ3Vector3D *outNormal )
+{	float						xTop, yTop, zTop, xTopDu, yTopDu, zTopDu, xTopDv, yTopDv, zTopDv;
+	float						bottom, bottomDu, bottomDv, oneOverBottom;
+	float						bu, bv, du, dv;
+	const TQ3RationalPoint4D	*thePoint;
+	const float					*uBasis, *vBasis, *uDeriv, *vDeriv;
+	TQ3Uns32					i, j, uFirst, vFirst;
+	TQ3RationalPoint4D			theTop, theTopDu, theTopDv;
 
-	// Again
-	for ( jV = 0; jV < patchData->numRows; jV++ ) {
-		vBasisValues[jV] = e3geom_nurbpatch_evaluate_basis( v, jV, patchData->vOrder, patchData->vKnots) ;
-	}
 
-	// Now some summation rotation recreation, like p. 46-47 in Bartels, Beatty, & Barsky
-	for ( jV = 0; jV < patchData->numRows; jV++ ) {
-		for ( iU = 0; iU < patchData->numColumns; iU++ ) {
-			// First the point
-			xTop += patchData->controlPoints[patchData->numColumns*jV + iU].x * uBasisValues[iU] * vBasisValues[jV] ;
-			yTop += patchData->controlPoints[patchData->numColumns*jV + iU].y * uBasisValues[iU] * vBasisValues[jV] ;
-			zTop += patchData->controlPoints[patchData->numColumns*jV + iU].z * uBasisValues[iU] * vBasisValues[jV] ;
-			bottom += patchData->controlPoints[patchData->numColumns*jV + iU].w * uBasisValues[iU] * vBasisValues[jV] ;
-	}	}
-	
-	
-	// The point
-	OneOverBottom = 1.0f / bottom ;
-	outPoint->x = xTop * OneOverBottom ;
-	outPoint->y = yTop * OneOverBottom ;
-	outPoint->z = zTop * OneOverBottom ;
+
+	// Find our basis values
+	uFirst = uTable.firstIndex[uIndex];
+	vFirst = vTable.firstIndex[vIndex];
+	uBasis = &uTable.values[uIndex * uTable.order];
+	vBasis = &vTable.values[vIndex * vTable.order];
+
+
+
+	// Evaluate the point
+	if (outNormal == nullptr)
+		{
+		xTop = yTop = zTop = bottom = 0.0f;
+
+		for (j = 0; j < vTable.order; j++)
+			{
+			bv       = vBasis[j];
+			thePoint = &patchData->controlPoints[patchData->numColumns * (vFirst + j) + uFirst];
+
+			for (i = 0; i < uTable.order; i++, thePoint++)
+				{
+				bu      = uBasis[i] * bv;
+				xTop   += thePoint->x * bu;
+				yTop   += thePoint->y * bu;
+				zTop   += thePoint->z * bu;
+				bottom += thePoint->w * bu;
+				}
+			}
+
+		Q3_ASSERT(bottom != 0.0f);
+		oneOverBottom = 1.0f / bottom;
+		outPoint->x   = xTop * oneOverBottom;
+		outPoint->y   = yTop * oneOverBottom;
+		outPoint->z   = zTop * oneOverBottom;
+		return;
+		}
+
+
+
+	// Evaluate the point and the partial derivatives
+	uDeriv = &uTable.derivs[uIndex * uTable.order];
+	vDeriv = &vTable.derivs[vIndex * vTable.order];
+
+	xTop   = yTop   = zTop   = bottom   = 0.0f;
+	xTopDu = yTopDu = zTopDu = bottomDu = 0.0f;
+	xTopDv = yTopDv = zTopDv = bottomDv = 0.0f;
+
+	for (j = 0; j < vTable.order; j++)
+		{
+		thePoint = &patchData->controlPoints[patchData->numColumns * (vFirst + j) + uFirst];
+
+		for (i = 0; i < uTable.order; i++, thePoint++)
+			{
+			bu = uBasis[i] * vBasis[j];
+			du = uDeriv[i] * vBasis[j];
+			dv = uBasis[i] * vDeriv[j];
+
+			xTop     += thePoint->x * bu;
+			yTop     += thePoint->y * bu;
+			zTop     += thePoint->z * bu;
+			bottom   += thePoint->w * bu;
+
+			xTopDu   += thePoint->x * du;
+			yTopDu   += thePoint->y * du;
+			zTopDu   += thePoint->z * du;
+			bottomDu += thePoint->w * du;
+
+			xTopDv   += thePoint->x * dv;
+			yTopDv   += thePoint->y * dv;
+			zTopDv   += thePoint->z * dv;
+			bottomDv += thePoint->w * dv;
+			}
+		}
+
+	theTop.x   = xTop;   theTop.y   = yTop;   theTop.z   = zTop;   theTop.w   = bottom;
+	theTopDu.x = xTopDu; theTopDu.y = yTopDu; theTopDu.z = zTopDu; theTopDu.w = bottomDu;
+	theTopDv.x = xTopDv; theTopDv.y = yTopDv; theTopDv.z = zTopDv; theTopDv.w = bottomDv;
+
+	e3geom_nurbpatch_project( &theTop, &theTopDu, &theTopDv, outPoint, outNormal );
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_nurbpatch_bezier_rows_build : Convert a patch to piecewise
+//											 Bézier form in u.
+//-----------------------------------------------------------------------------
+//		Note :	Each row of control points is a NURB curve in u over the
+//				patch's u knots, so is converted by knot insertion as for a
+//				NURB curve.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_nurbpatch_bezier_rows_build( const TQ3NURBPatchData *geomData, TE3NURBPatchBezierRows& bezierRows )
+{	TE3NURBCurveBezierData		rowBezier = { 0, 0, nullptr };
+	TQ3NURBCurveData			rowCurve;
+	TQ3Uns32					row;
+
+
+
+	// Convert each row
+	rowCurve.order             = geomData->uOrder;
+	rowCurve.numPoints         = geomData->numColumns;
+	rowCurve.knots             = geomData->uKnots;
+	rowCurve.curveAttributeSet = nullptr;
+
+	for (row = 0; row < geomData->numRows; row++)
+		{
+		rowCurve.controlPoints = &geomData->controlPoints[row * geomData->numColumns];
+
+		if (E3NURBCurve_BezierBuild( &rowCurve, &rowBezier ) != kQ3Success)
+			{
+			E3NURBCurve_BezierDispose( &rowBezier );
+			return(kQ3Failure);
+			}
+
+		if (row == 0)
+			{
+			bezierRows.numSpans = rowBezier.numSpans;
+			bezierRows.rowSize  = rowBezier.numSpans * rowBezier.order;
+			bezierRows.controlPoints.resize( geomData->numRows * bezierRows.rowSize );
+			}
+
+		Q3_ASSERT(rowBezier.numSpans == bezierRows.numSpans);
+		Q3Memory_Copy( rowBezier.controlPoints, &bezierRows.controlPoints[row * bezierRows.rowSize],
+					   static_cast<TQ3Uns32>(bezierRows.rowSize * sizeof(TQ3RationalPoint4D)) );
+		}
+
+	E3NURBCurve_BezierDispose( &rowBezier );
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_nurbpatch_evaluate_row : Evaluate a row of the patch from its
+//										Bézier form.
+//-----------------------------------------------------------------------------
+//		Note :	Evaluates the points at v = vTable[vIndex], with each u
+//				span split into uSpans[n] equal steps as in
+//				e3geom_nurbpatch_span_params.
+//
+//				The Bézier rows are blended into the iso-curve at v and its
+//				v derivative, and the u derivative is the hodograph of the
+//				iso-curve. All three are sampled along each span by forward
+//				differencing, so each vertex costs a few additions rather
+//				than visiting uOrder x vOrder control points.
+//-----------------------------------------------------------------------------
+static void
+e3geom_nurbpatch_evaluate_row( const TQ3NURBPatchData *geomData,
+							   const TE3NURBPatchBezierRows& bezierRows,
+							   const std::vector<float>& interestingU,
+							   const std::vector<TQ3Uns32>& uSpans,
+							   const TE3NURBPatchBasisTable& vTable, TQ3Uns32 vIndex,
+							   std::vector<TQ3RationalPoint4D>& isoCurve,
+							   TQ3Point3D *outPoints, TQ3Vector3D *outNormals )
+{	TQ3RationalPoint4D			theTop[kMaxSpanSubdivision], theTopDu[kMaxSpanSubdivision], theTopDv[kMaxSpanSubdivision];
+	TQ3RationalPoint4D			hodograph[kQ3NURBPatchMaxOrder];
+	const TQ3RationalPoint4D	*rowPoints, *spanPoints, *spanPointsDv;
+	TQ3RationalPoint4D			*curvePoints, *curvePointsDv;
+	const float					*vBasis, *vDeriv;
+	TQ3Uns32					uOrder, rowSize, vFirst, i, j, k, n, numOut;
+	float						bv, dv, theScale;
+
+
+
+	// Blend the rows which influence v, giving the iso-curve and its v derivative
+	uOrder  = geomData->uOrder;
+	rowSize = bezierRows.rowSize;
+	vFirst  = vTable.firstIndex[vIndex];
+	vBasis  = &vTable.values[vIndex * vTable.order];
+	vDeriv  = &vTable.derivs[vIndex * vTable.order];
+
+	isoCurve.assign( rowSize * 2, TQ3RationalPoint4D() );
+	curvePoints   = &isoCurve[0];
+	curvePointsDv = &isoCurve[rowSize];
+
+	for (j = 0; j < vTable.order; j++)
+		{
+		bv        = vBasis[j];
+		dv        = vDeriv[j];
+		rowPoints = &bezierRows.controlPoints[(vFirst + j) * rowSize];
+
+		for (i = 0; i < rowSize; i++)
+			{
+			curvePoints[i].x   += rowPoints[i].x * bv;
+			curvePoints[i].y   += rowPoints[i].y * bv;
+			curvePoints[i].z   += rowPoints[i].z * bv;
+			curvePoints[i].w   += rowPoints[i].w * bv;
+
+			curvePointsDv[i].x += rowPoints[i].x * dv;
+			curvePointsDv[i].y += rowPoints[i].y * dv;
+			curvePointsDv[i].z += rowPoints[i].z * dv;
+			curvePointsDv[i].w += rowPoints[i].w * dv;
+			}
+		}
+
+
+
+	// Sample each span
+	numOut = 0;
+
+	for (n = 0; n < bezierRows.numSpans; n++)
+		{
+		spanPoints   = &curvePoints[n * uOrder];
+		spanPointsDv = &curvePointsDv[n * uOrder];
+
+		E3NURBCurve_BezierSample( spanPoints,   uOrder, uSpans[n], theTop   );
+		E3NURBCurve_BezierSample( spanPointsDv, uOrder, uSpans[n], theTopDv );
+
+		if (uOrder > 1)
+			{
+			theScale = (float) (uOrder - 1) / (interestingU[n + 1] - interestingU[n]);
+			for (k = 0; k < uOrder - 1; k++)
+				{
+				hodograph[k].x = (spanPoints[k + 1].x - spanPoints[k].x) * theScale;
+				hodograph[k].y = (spanPoints[k + 1].y - spanPoints[k].y) * theScale;
+				hodograph[k].z = (spanPoints[k + 1].z - spanPoints[k].z) * theScale;
+				hodograph[k].w = (spanPoints[k + 1].w - spanPoints[k].w) * theScale;
+				}
+
+			E3NURBCurve_BezierSample( hodograph, uOrder - 1, uSpans[n], theTopDu );
+			}
+		else
+			{
+			for (k = 0; k < uSpans[n]; k++)
+				theTopDu[k] = TQ3RationalPoint4D();
+			}
+
+		for (k = 0; k < uSpans[n]; k++, numOut++)
+			e3geom_nurbpatch_project( &theTop[k], &theTopDu[k], &theTopDv[k], &outPoints[numOut], &outNormals[numOut] );
+		}
+
+
+
+	// Finish with the end of the last span
+	spanPoints   = &curvePoints[rowSize - uOrder];
+	spanPointsDv = &curvePointsDv[rowSize - uOrder];
+
+	if (uOrder > 1)
+		hodograph[0] = hodograph[uOrder - 2];
+	else
+		hodograph[0] = TQ3RationalPoint4D();
+
+	e3geom_nurbpatch_project( &spanPoints[uOrder - 1], &hodograph[0], &spanPointsDv[uOrder - 1],
+							  &outPoints[numOut], &outNormals[numOut] );
 }
 
 
@@ -532,18 +866,18 @@ e3geom_nurbpatch_interesting_knots( float * inKnots, TQ3Uns32 numPoints, TQ3Uns3
 {
 	TQ3Uns32 count, n ;
 	interestingK[0] = inKnots[order - 1] ;
-	
+
 	count = 1 ;
 	for( n = order ; n <= numPoints ; n++ ) {
-		
+
 		// if current knot differs from the previous, add this knot
 		if( inKnots[n] != inKnots[n-1] ) {
 			interestingK[ count ] = inKnots[n] ;
 			count++ ;
 		}
-		
+
 	} // ~for( n in knot vector )
-	
+
 #if Q3_DEBUG
 	Q3_ASSERT( count <= numPoints - order + 2 ) ;
 #endif
@@ -555,113 +889,33 @@ e3geom_nurbpatch_interesting_knots( float * inKnots, TQ3Uns32 numPoints, TQ3Uns3
 
 
 //=============================================================================
-//      e3geom_nurbpatch_recursive_quad_world_subdivide : Recursively subdivide
-//														  a patch into 4
-//														  parametrically square
-//														  sections.
+//      e3geom_nurbpatch_span_params : Build the parameters for a subdivision.
 //-----------------------------------------------------------------------------
-//		Note : Returns the maximum depth of recursion.
+//		Note :	Each span between interesting knots is split into
+//				spanCounts[n] equal parametric steps. Knots are always
+//				included, and the last knot is included exactly once.
 //-----------------------------------------------------------------------------
-static TQ3Uns32
-e3geom_nurbpatch_recursive_quad_world_subdivide( TQ3Uns32 depth, float subdiv, float fu, float lu, float fv, float lv,
-												  const TQ3Point3D* Pfufv, const TQ3Point3D* Plufv, const TQ3Point3D* Pfulv, const TQ3Point3D* Plulv,
-								  				  const TQ3NURBPatchData *geomData, const TQ3Matrix4x4* localToWorld,
-								  				  float* uBasisValues, float* vBasisValues )
-{
-	float hu, hv ;
-	TQ3Point3D Phufv, Pfuhv, Phuhv, Pluhv, Phulv ;
-	
-	TQ3Uns32 recurseDepth, maxRecurseDepth ;
-	
-	depth++ ;
-	maxRecurseDepth = 0 ;
-	
-	#define a Q3Point3D_DistanceSquared( Pfufv, Plufv )
-	#define b Q3Point3D_DistanceSquared( Plufv, Plulv )
-	#define c Q3Point3D_DistanceSquared( Pfulv, Plulv )
-	#define d Q3Point3D_DistanceSquared( Pfufv, Pfulv )
-	
-	if( a > subdiv || b > subdiv || c > subdiv || d > subdiv ) {
-		
-		hu = (fu + lu)*0.5f ;
-		hv = (fv + lv)*0.5f ;
-		
-		e3geom_nurbpatch_evaluate_uv_no_deriv( hu,
-											   fv,
-											   geomData,
-											   &Phufv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Phufv, localToWorld, &Phufv ) ;
-		
-		e3geom_nurbpatch_evaluate_uv_no_deriv( fu,
-											   hv,
-											   geomData,
-											   &Pfuhv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Pfuhv, localToWorld, &Pfuhv ) ;
-		
-		e3geom_nurbpatch_evaluate_uv_no_deriv( hu,
-											   hv,
-											   geomData,
-											   &Phuhv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Phuhv, localToWorld, &Phuhv ) ;
-		
-		e3geom_nurbpatch_evaluate_uv_no_deriv( lu,
-											   hv,
-											   geomData,
-											   &Pluhv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Pluhv, localToWorld, &Pluhv ) ;
-
-		e3geom_nurbpatch_evaluate_uv_no_deriv( hu,
-											   lv,
-											   geomData,
-											   &Phulv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Phulv, localToWorld, &Phulv ) ;
-		
-		// Top-left square
-		recurseDepth = e3geom_nurbpatch_recursive_quad_world_subdivide( depth,
-														subdiv, fu, hu, fv, hv,
-														Pfufv, &Phufv, &Pfuhv, &Phuhv,
-														geomData, localToWorld,
-														uBasisValues, vBasisValues ) ;
-		maxRecurseDepth = maxRecurseDepth > recurseDepth ? maxRecurseDepth : recurseDepth ;
-		
-		// Top-right square
-		recurseDepth = e3geom_nurbpatch_recursive_quad_world_subdivide( depth,
-														 subdiv, hu, lu, fv, hv,
-														 &Phufv, Plufv, &Phuhv, &Pluhv,
-														 geomData, localToWorld,
-														 uBasisValues, vBasisValues ) ;
-		maxRecurseDepth = maxRecurseDepth > recurseDepth ? maxRecurseDepth : recurseDepth ;
-
-		// Bottom-left square
-		recurseDepth = e3geom_nurbpatch_recursive_quad_world_subdivide( depth,
-														 subdiv, fu, hu, hv, lv,
-														 &Pfuhv, &Phuhv, Pfulv, &Phulv,
-														 geomData, localToWorld,
-														 uBasisValues, vBasisValues ) ;
-		maxRecurseDepth = maxRecurseDepth > recurseDepth ? maxRecurseDepth : recurseDepth ;
-
-		// Bottom-right square
-		recurseDepth = e3geom_nurbpatch_recursive_quad_world_subdivide( depth,
-														 subdiv, hu, lu, hv, lv,
-														 &Phuhv, &Pluhv, &Phulv, Plulv,
-														 geomData, localToWorld,
-														 uBasisValues, vBasisValues ) ;
-		maxRecurseDepth = maxRecurseDepth > recurseDepth ? maxRecurseDepth : recurseDepth ;
-	}
-	
-	depth = depth > maxRecurseDepth ? depth : maxRecurseDepth ;
-	
-	return depth ;
-	
-	#undef a
-	#undef b
-	#undef c
-	#undef d
+static void
+e3geom_nurbpatch_span_params( const std::vector<float>& interestingK,
+							  const std::vector<TQ3Uns32>& spanCounts,
+							  std::vector<float>& theParams )
+{	TQ3Uns32	n, k;
+	float		theStep;
+
+
+
+	// Step through each span
+	theParams.clear();
+
+	for (n = 0; n < spanCounts.size(); n++)
+		{
+		theStep = (interestingK[n + 1] - interestingK[n]) / (float) spanCounts[n];
+
+		for (k = 0; k < spanCounts[n]; k++)
+			theParams.push_back( interestingK[n] + theStep * (float) k );
+		}
+
+	theParams.push_back( interestingK.back() );
 }
 
 
@@ -669,124 +923,17 @@ e3geom_nurbpatch_recursive_quad_world_subdivide( TQ3Uns32 depth, float subdiv, f
 
 
 //=============================================================================
-//      e3geom_nurbpatch_recursive_quad_screen_subdivide : Recursively subdivide
-//														   a patch into 4
-//														   parametrically square
-//														   sections.
+//      e3geom_nurbpatch_ensure_interior : Ensure a direction has a vertex
+//										   strictly inside the patch.
 //-----------------------------------------------------------------------------
-//		Note : If *points == nullptr, an error has occurred (memory).
+//		Note :	The boundary stitching in e3geom_nurbpatch_tessellate needs
+//				at least one row and column of interior vertices.
 //-----------------------------------------------------------------------------
-static TQ3Uns32
-e3geom_nurbpatch_recursive_quad_screen_subdivide( TQ3Uns32 depth, float subdiv, float fu, float lu, float fv, float lv,
-												  const TQ3Point2D* Pfufv2, const TQ3Point2D* Plufv2, const TQ3Point2D* Pfulv2, const TQ3Point2D* Plulv2,
-								  				  const TQ3NURBPatchData *geomData, const TQ3Matrix4x4* localToWindow,
-								  				  float* uBasisValues, float* vBasisValues )
+static void
+e3geom_nurbpatch_ensure_interior( std::vector<TQ3Uns32>& spanCounts )
 {
-	float hu, hv ;
-	TQ3Point3D Phufv, Pfuhv, Phuhv, Pluhv, Phulv, transformPoint ;
-	TQ3Point2D Phufv2, Pfuhv2, Phuhv2, Pluhv2, Phulv2 ;
-	
-	TQ3Uns32 recurseDepth, maxRecurseDepth ;
-	
-	depth++ ;
-	maxRecurseDepth = 0 ;
-	
-	#define a Q3Point2D_DistanceSquared( Pfufv2, Plufv2 )
-	#define b Q3Point2D_DistanceSquared( Plufv2, Plulv2 )
-	#define c Q3Point2D_DistanceSquared( Pfulv2, Plulv2 )
-	#define d Q3Point2D_DistanceSquared( Pfufv2, Pfulv2 )
-	
-	if( a > subdiv || b > subdiv || c > subdiv || d > subdiv ) {
-		
-		hu = (fu + lu)*0.5f ;
-		hv = (fv + lv)*0.5f ;
-		
-		e3geom_nurbpatch_evaluate_uv_no_deriv( hu,
-											   fv,
-											   geomData,
-											   &Phufv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Phufv, localToWindow, &transformPoint ) ;
-		Phufv2.x = transformPoint.x ;
-		Phufv2.y = transformPoint.y ;
-		
-		e3geom_nurbpatch_evaluate_uv_no_deriv( fu,
-											   hv,
-											   geomData,
-											   &Pfuhv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Pfuhv, localToWindow, &transformPoint ) ;
-		Pfuhv2.x = transformPoint.x ;
-		Pfuhv2.y = transformPoint.y ;
-		
-		e3geom_nurbpatch_evaluate_uv_no_deriv( hu,
-											   hv,
-											   geomData,
-											   &Phuhv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Phuhv, localToWindow, &transformPoint ) ;
-		Phuhv2.x = transformPoint.x ;
-		Phuhv2.y = transformPoint.y ;
-		
-		e3geom_nurbpatch_evaluate_uv_no_deriv( lu,
-											   hv,
-											   geomData,
-											   &Pluhv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Pluhv, localToWindow, &transformPoint ) ;
-		Pluhv2.x = transformPoint.x ;
-		Pluhv2.y = transformPoint.y ;
-
-		e3geom_nurbpatch_evaluate_uv_no_deriv( hu,
-											   lv,
-											   geomData,
-											   &Phulv,
-											   uBasisValues, vBasisValues );
-		Q3Point3D_Transform( &Phulv, localToWindow, &transformPoint ) ;
-		Phulv2.x = transformPoint.x ;
-		Phulv2.y = transformPoint.y ;
-		
-		// Top-left square
-		recurseDepth = e3geom_nurbpatch_recursive_quad_screen_subdivide( depth,
-														subdiv, fu, hu, fv, hv,
-														Pfufv2, &Phufv2, &Pfuhv2, &Phuhv2,
-														geomData, localToWindow,
-														uBasisValues, vBasisValues ) ;
-		maxRecurseDepth = maxRecurseDepth > recurseDepth ? maxRecurseDepth : recurseDepth ;
-		
-		// Top-right square
-		recurseDepth = e3geom_nurbpatch_recursive_quad_screen_subdivide( depth,
-														 subdiv, hu, lu, fv, hv,
-														 &Phufv2, Plufv2, &Phuhv2, &Pluhv2,
-														 geomData, localToWindow,
-														 uBasisValues, vBasisValues ) ;
-		maxRecurseDepth = maxRecurseDepth > recurseDepth ? maxRecurseDepth : recurseDepth ;
-
-		// Bottom-left square
-		recurseDepth = e3geom_nurbpatch_recursive_quad_screen_subdivide( depth,
-														 subdiv, fu, hu, hv, lv,
-														 &Pfuhv2, &Phuhv2, Pfulv2, &Phulv2,
-														 geomData, localToWindow,
-														 uBasisValues, vBasisValues ) ;
-		maxRecurseDepth = maxRecurseDepth > recurseDepth ? maxRecurseDepth : recurseDepth ;
-
-		// Bottom-right square
-		recurseDepth = e3geom_nurbpatch_recursive_quad_screen_subdivide( depth,
-														 subdiv, hu, lu, hv, lv,
-														 &Phuhv2, &Pluhv2, &Phulv2, Plulv2,
-														 geomData, localToWindow,
-														 uBasisValues, vBasisValues ) ;
-		maxRecurseDepth = maxRecurseDepth > recurseDepth ? maxRecurseDepth : recurseDepth ;
-	}
-	
-	depth = depth > maxRecurseDepth ? depth : maxRecurseDepth ;
-	
-	return depth ;
-	
-	#undef a
-	#undef b
-	#undef c
-	#undef d
+	if (spanCounts.size() == 1 && spanCounts[0] < 2)
+		spanCounts[0] = 2;
 }
 
 
@@ -794,175 +941,187 @@ e3geom_nurbpatch_recursive_quad_screen_subdivide( TQ3Uns32 depth, float subdiv,
 
 
 //=============================================================================
-//      e3geom_nurbcurve_worldscreen_subdiv : Subdivide the given NURB curve
-//											  into triangles whose edges have
-//											  at most the given world or
-//											  screen-space length. Vertices are
-//											  guaranteed at knots.
-//-----------------------------------------------------------------------------
-//		Note :	Calls through to e3geom_nurbcurve_constant_subdiv.
-//				If the points array is non-nullptr on return, be sure to free it
-//				with Q3Memory_Free(). If it is nullptr, then an error has occurred.
+//      e3geom_nurbpatch_constant_subdiv : Subdivide each knot span into a
+//										   constant number of segments.
 //-----------------------------------------------------------------------------
-// I need the function declaration for constant subdivision since I call through to it
 static void
-e3geom_nurbpatch_constant_subdiv( TQ3Point3D** thePoints, TQ3Uns32* numPoints,
-								  TQ3Param2D** theUVs, TQ3Vector3D** theNormals,
-								  TQ3TriMeshTriangleData** theTriangles, TQ3Uns32* numTriangles,
-								  float subdivU, float subdivV,
-								  const TQ3NURBPatchData *geomData,
-								  float* uBasisValues, float* vBasisValues, float* uBasisDerivValues, float* vBasisDerivValues ) ;
+e3geom_nurbpatch_constant_subdiv( float subdivU, float subdivV,
+								  const std::vector<float>& interestingU,
+								  const std::vector<float>& interestingV,
+								  TE3NURBPatchSubdivision& theSubdiv )
+{	TQ3Uns32	countU, countV;
+
+
+
+	// First some sanity checking on subdivisionData
+	countU = (TQ3Uns32) E3Num_Clamp(subdivU, 1.0f, (float) kMaxSpanSubdivision);
+	countV = (TQ3Uns32) E3Num_Clamp(subdivV, 1.0f, (float) kMaxSpanSubdivision);
+
+
+
+	// Every span, including the boundary spans, gets the same count
+	theSubdiv.uSpans.assign( interestingU.size() - 1, countU );
+	theSubdiv.vSpans.assign( interestingV.size() - 1, countV );
+
+	e3geom_nurbpatch_ensure_interior( theSubdiv.uSpans );
+	e3geom_nurbpatch_ensure_interior( theSubdiv.vSpans );
+
+	theSubdiv.bottomSpans = theSubdiv.uSpans;
+	theSubdiv.topSpans    = theSubdiv.uSpans;
+	theSubdiv.leftSpans   = theSubdiv.vSpans;
+	theSubdiv.rightSpans  = theSubdiv.vSpans;
+}
 
+
+
+
+
+//=============================================================================
+//      e3geom_nurbpatch_worldscreen_subdiv : Choose per-span subdivisions so
+//											  that edges have at most the
+//											  given world or screen-space
+//											  length.
+//-----------------------------------------------------------------------------
+//		Note :	The patch is sampled at kEstimateSamplesPerSpan points per
+//				knot span, and the length of each iso-curve across a span
+//				is measured in world or window coordinates.
+//
+//				The interior of a span is split according to the longest
+//				iso-curve crossing it, which keeps the grid free of
+//				T-junctions. Each boundary edge is split according to the
+//				length of that edge alone, so two patches sharing a
+//				boundary curve produce the same boundary vertices and no
+//				cracks appear between them.
+//-----------------------------------------------------------------------------
 static void
-e3geom_nurbpatch_worldscreen_subdiv( TQ3Point3D** thePoints, TQ3Uns32* numPoints,
-									 TQ3Param2D** theUVs, TQ3Vector3D** theNormals,
-									 TQ3TriMeshTriangleData** theTriangles, TQ3Uns32* numTriangles,
-									 float subdiv,
+e3geom_nurbpatch_worldscreen_subdiv( float subdiv,
 									 const TQ3NURBPatchData *geomData, TQ3ViewObject theView, TQ3Boolean isScreenSpaceSubdivision,
-									 float* uBasisValues, float* vBasisValues, float* uBasisDerivValues, float* vBasisDerivValues )
-{	float			*interestingU, *interestingV ;
-	TQ3Uns32		nu, nv,
-					maxdepth, somedepth,
-					numIntU, numIntV ;
-	TQ3Point3D		u0v0, u1v0, u0v1, u1v1 ;
-	TQ3Point2D		u0v02, u1v02, u0v12, u1v12 ;
-	// To cache the local -> world and local -> screen matrices
-	TQ3Matrix4x4	localToWorld, worldToFrustum, frustumToWindow, localToWindow ;
-	
-#if Q3_DEBUG
-	Q3_ASSERT( thePoints != nullptr && numPoints != nullptr && theUVs != nullptr && theNormals != nullptr
-			   && theTriangles != nullptr && numTriangles != nullptr ) ;
-#endif
-	
-	// For the error handler
-	interestingU = interestingV = nullptr ;
-	
-	// First some sanity checking on subdivisionData
-	subdiv = E3Num_Max(subdiv, 0.001f) ;
-	
-	// Find the interesting knots (ie skip the repeated knots)
-	interestingU = (float *) Q3Memory_Allocate(static_cast<TQ3Uns32>((geomData->numColumns - geomData->uOrder + 2) * sizeof(float)));
-	if (interestingU == nullptr) {
-		goto nurbpatch_world_subdiv_error_handler ;
-	}
-	numIntU = e3geom_nurbpatch_interesting_knots( geomData->uKnots, geomData->numColumns, geomData->uOrder, interestingU );
-	
-	interestingV = (float *) Q3Memory_Allocate(static_cast<TQ3Uns32>((geomData->numRows - geomData->vOrder + 2) * sizeof(float)));
-	if (interestingV == nullptr) {
-		goto nurbpatch_world_subdiv_error_handler ;
-	}
-	numIntV = e3geom_nurbpatch_interesting_knots( geomData->vKnots, geomData->numRows, geomData->vOrder, interestingV );
-	
-	// we need the localToWorld matrix for both world and screen subdivisions
-	Q3View_GetLocalToWorldMatrixState(theView, &localToWorld);
-	// if we are doing a screen subdivision,
-	// truncate subdiv into an integer and cache the worldToWindow matrix
-	if( isScreenSpaceSubdivision ) {
-		// truncate subdiv
-		subdiv = (float) floor( subdiv ) ;
-		// cache the localToWindow matrix for theView
+									 const std::vector<float>& interestingU,
+									 const std::vector<float>& interestingV,
+									 TE3NURBPatchSubdivision& theSubdiv )
+{	TQ3Uns32					numSpansU, numSpansV, numSamplesU, numSamplesV;
+	TQ3Uns32					i, j, n, k;
+	std::vector<TQ3Uns32>		sampleCountsU, sampleCountsV;
+	std::vector<float>			sampleU, sampleV;
+	std::vector<TQ3Point3D>		thePoints;
+	TE3NURBPatchBasisTable		uTable, vTable;
+	TQ3Matrix4x4				localToTarget, worldToFrustum, frustumToWindow;
+	float						theLength;
+	TQ3Uns32					theCount;
+
+
+
+	// Find the matrix to measure lengths in
+	Q3View_GetLocalToWorldMatrixState(theView, &localToTarget);
+
+	if (isScreenSpaceSubdivision)
+		{
+		// Screen space subdivision is measured in whole pixels
+		subdiv = (float) floor( E3Num_Max(subdiv, 1.0f) );
+
 		Q3View_GetWorldToFrustumMatrixState(theView,  &worldToFrustum);
 		Q3View_GetFrustumToWindowMatrixState(theView, &frustumToWindow);
-		
-		Q3Matrix4x4_Multiply(&localToWorld, &worldToFrustum, &localToWindow);
-		Q3Matrix4x4_Multiply(&localToWindow, &frustumToWindow, &localToWindow);
-	}
-	
-	
-	// square subdiv now to save a whole lot of sqrt's later (in the distance comparison)
-	subdiv *= subdiv ;
-	
-	maxdepth = 0 ;
-	
-	// Iterate over every 'square' of the grid resulting from (u-knots) x (v-knots)
-	for( nv = 0 ; nv < numIntV -1 ; nv++ ) {
-		for( nu = 0 ; nu < numIntU -1 ; nu++ ) {
-			
-			e3geom_nurbpatch_evaluate_uv_no_deriv( interestingU[ nu ],
-												   interestingV[ nv ],
-												   geomData,
-												   &u0v0,
-												   uBasisValues, vBasisValues );
-			e3geom_nurbpatch_evaluate_uv_no_deriv( interestingU[ nu +1 ],
-												   interestingV[ nv ],
-												   geomData,
-												   &u1v0,
-												   uBasisValues, vBasisValues );
-			e3geom_nurbpatch_evaluate_uv_no_deriv( interestingU[ nu ],
-												   interestingV[ nv +1 ],
-												   geomData,
-												   &u0v1,
-												   uBasisValues, vBasisValues );
-			e3geom_nurbpatch_evaluate_uv_no_deriv( interestingU[ nu +1 ],
-												   interestingV[ nv +1 ],
-												   geomData,
-												   &u1v1,
-												   uBasisValues, vBasisValues );
-			
-			if( kQ3False == isScreenSpaceSubdivision ) {
-				Q3Point3D_Transform(&u0v0, &localToWorld, &u0v0) ;
-				Q3Point3D_Transform(&u1v0, &localToWorld, &u1v0) ;
-				Q3Point3D_Transform(&u0v1, &localToWorld, &u0v1) ;
-				Q3Point3D_Transform(&u1v1, &localToWorld, &u1v1) ;
-				somedepth = e3geom_nurbpatch_recursive_quad_world_subdivide( 0, subdiv,
-																 interestingU[ nu ], interestingU[ nu +1 ],
-																 interestingV[ nv ], interestingV[ nv +1 ],
-																 &u0v0, &u1v0, &u0v1, &u1v1,
-																 geomData, &localToWorld,
-																 uBasisValues, vBasisValues ) ;
-			} else {
-				Q3Point3D_Transform(&u0v0, &localToWorld, &u0v0) ;
-				u0v02.x = u0v0.x ;
-				u0v02.y = u0v0.y ;
-				Q3Point3D_Transform(&u1v0, &localToWorld, &u1v0) ;
-				u1v02.x = u1v0.x ;
-				u1v02.y = u1v0.y ;
-				Q3Point3D_Transform(&u0v1, &localToWorld, &u0v1) ;
-				u0v12.x = u0v1.x ;
-				u0v12.y = u0v1.y ;
-				Q3Point3D_Transform(&u1v1, &localToWorld, &u1v1) ;
-				u1v12.x = u1v1.x ;
-				u1v12.y = u1v1.y ;
-				somedepth = e3geom_nurbpatch_recursive_quad_screen_subdivide( 0, subdiv,
-																  interestingU[ nu ], interestingU[ nu +1 ],
-																  interestingV[ nv ], interestingV[ nv +1 ],
-																  &u0v02, &u1v02, &u0v12, &u1v12,
-																  geomData, &localToWindow,
-																  uBasisValues, vBasisValues ) ;
+
+		Q3Matrix4x4_Multiply(&localToTarget, &worldToFrustum,  &localToTarget);
+		Q3Matrix4x4_Multiply(&localToTarget, &frustumToWindow, &localToTarget);
+		}
+
+	subdiv = E3Num_Max(subdiv, 0.001f);
+
+
+
+	// Sample the patch on a regular grid within each span
+	numSpansU = (TQ3Uns32) interestingU.size() - 1;
+	numSpansV = (TQ3Uns32) interestingV.size() - 1;
+
+	sampleCountsU.assign( numSpansU, kEstimateSamplesPerSpan );
+	sampleCountsV.assign( numSpansV, kEstimateSamplesPerSpan );
+
+	e3geom_nurbpatch_span_params( interestingU, sampleCountsU, sampleU );
+	e3geom_nurbpatch_span_params( interestingV, sampleCountsV, sampleV );
+
+	numSamplesU = (TQ3Uns32) sampleU.size();
+	numSamplesV = (TQ3Uns32) sampleV.size();
+
+	e3geom_nurbpatch_basis_table_build( sampleU, geomData->numColumns, geomData->uOrder, geomData->uKnots, kQ3False, uTable );
+	e3geom_nurbpatch_basis_table_build( sampleV, geomData->numRows,    geomData->vOrder, geomData->vKnots, kQ3False, vTable );
+
+	thePoints.resize( numSamplesU * numSamplesV );
+
+	for (j = 0; j < numSamplesV; j++)
+		{
+		for (i = 0; i < numSamplesU; i++)
+			{
+			TQ3Point3D&	thePoint = thePoints[j * numSamplesU + i];
+
+			e3geom_nurbpatch_evaluate_table( geomData, uTable, i, vTable, j, &thePoint, nullptr );
+			Q3Point3D_Transform( &thePoint, &localToTarget, &thePoint );
+
+			if (isScreenSpaceSubdivision)
+				thePoint.z = 0.0f;
 			}
-			
-			maxdepth = maxdepth > somedepth ? maxdepth : somedepth ;
-			
-		} // ~for( nu )
-	} // ~for( nv )
-	Q3Memory_Free( &interestingU ) ;
-	Q3Memory_Free( &interestingV ) ;
-	
-	subdiv = (float)pow( 2.0, (int)maxdepth -1 ) ;
-	
-	
-	// I am not sure what causes subdiv to become infinite or what the value should really be,
-	// but I am sure that we do not want infinity here.
-	if (!isfinite( subdiv ))
-		subdiv = kFiniteSubdivision;
-	
-	
-	e3geom_nurbpatch_constant_subdiv( thePoints, numPoints, theUVs, theNormals,
-									  theTriangles, numTriangles,
-									  subdiv, subdiv,
-									  geomData,
-									  uBasisValues, vBasisValues, uBasisDerivValues, vBasisDerivValues ) ;
-	
-	return ;
-	
-   nurbpatch_world_subdiv_error_handler:
-	Q3Memory_Free( &interestingU ) ;
-	Q3Memory_Free( &interestingV ) ;
-	
-	if (thePoints != nullptr)
-	{
-		*thePoints = nullptr ;
-	}
+		}
+
+
+
+	// Measure the u iso-curves across each u span
+	theSubdiv.uSpans.assign( numSpansU, 1 );
+	theSubdiv.bottomSpans.assign( numSpansU, 1 );
+	theSubdiv.topSpans.assign( numSpansU, 1 );
+
+	for (n = 0; n < numSpansU; n++)
+		{
+		for (j = 0; j < numSamplesV; j++)
+			{
+			theLength = 0.0f;
+			for (k = 0; k < kEstimateSamplesPerSpan; k++)
+				{
+				i = n * kEstimateSamplesPerSpan + k;
+				theLength += Q3Point3D_Distance( &thePoints[j * numSamplesU + i], &thePoints[j * numSamplesU + i + 1] );
+				}
+
+			theCount = (TQ3Uns32) E3Num_Clamp(ceil( theLength / subdiv ), 1.0, (double) kMaxSpanSubdivision);
+			theSubdiv.uSpans[n] = E3Num_Max(theSubdiv.uSpans[n], theCount);
+
+			if (j == 0)
+				theSubdiv.bottomSpans[n] = theCount;
+
+			if (j == numSamplesV - 1)
+				theSubdiv.topSpans[n] = theCount;
+			}
+		}
+
+
+
+	// Measure the v iso-curves across each v span
+	theSubdiv.vSpans.assign( numSpansV, 1 );
+	theSubdiv.leftSpans.assign( numSpansV, 1 );
+	theSubdiv.rightSpans.assign( numSpansV, 1 );
+
+	for (n = 0; n < numSpansV; n++)
+		{
+		for (i = 0; i < numSamplesU; i++)
+			{
+			theLength = 0.0f;
+			for (k = 0; k < kEstimateSamplesPerSpan; k++)
+				{
+				j = n * kEstimateSamplesPerSpan + k;
+				theLength += Q3Point3D_Distance( &thePoints[j * numSamplesU + i], &thePoints[(j + 1) * numSamplesU + i] );
+				}
+
+			theCount = (TQ3Uns32) E3Num_Clamp(ceil( theLength / subdiv ), 1.0, (double) kMaxSpanSubdivision);
+			theSubdiv.vSpans[n] = E3Num_Max(theSubdiv.vSpans[n], theCount);
+
+			if (i == 0)
+				theSubdiv.leftSpans[n] = theCount;
+
+			if (i == numSamplesU - 1)
+				theSubdiv.rightSpans[n] = theCount;
+			}
+		}
+
+	e3geom_nurbpatch_ensure_interior( theSubdiv.uSpans );
+	e3geom_nurbpatch_ensure_interior( theSubdiv.vSpans );
 }
 
 
@@ -970,182 +1129,332 @@ e3geom_nurbpatch_worldscreen_subdiv( TQ3Point3D** thePoints, TQ3Uns32* numPoints
 
 
 //=============================================================================
-//      e3geom_nurbpatch_constant_subdiv : Subdivide the given NURB curve into
-//										   the some number of segments.
+//      e3geom_nurbpatch_add_vertex : Evaluate and append a vertex.
 //-----------------------------------------------------------------------------
-//		Note :	If the points array is non-nullptr on return, be sure to free it
-//				with Q3Memory_Free(). If it is nullptr, then an error has occured.
+static TQ3Uns32
+e3geom_nurbpatch_add_vertex( const TQ3NURBPatchData *geomData,
+							 const TE3NURBPatchBasisTable& uTable, TQ3Uns32 uIndex, float u,
+							 const TE3NURBPatchBasisTable& vTable, TQ3Uns32 vIndex, float v,
+							 TE3NURBPatchTessellation& theTess )
+{	TQ3Point3D		thePoint;
+	TQ3Vector3D		theNormal;
+	TQ3Param2D		theUV;
+
+
+
+	// Evaluate the vertex
+	e3geom_nurbpatch_evaluate_table( geomData, uTable, uIndex, vTable, vIndex, &thePoint, &theNormal );
+
+	theUV.u = u;
+	theUV.v = v;
+
+	theTess.points.push_back( thePoint );
+	theTess.normals.push_back( theNormal );
+	theTess.uvs.push_back( theUV );
+
+	return((TQ3Uns32) theTess.points.size() - 1);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_nurbpatch_add_triangle : Append a counter-clockwise triangle.
+//-----------------------------------------------------------------------------
+//		Note :	Triangles are oriented counter-clockwise in (u,v), to match
+//				the regular grid. Triangles which are degenerate in (u,v)
+//				are dropped.
 //-----------------------------------------------------------------------------
 static void
-e3geom_nurbpatch_constant_subdiv( TQ3Point3D** thePoints, TQ3Uns32* numPoints,
-								  TQ3Param2D** theUVs, TQ3Vector3D** theNormals,
-								  TQ3TriMeshTriangleData** theTriangles, TQ3Uns32* numTriangles,
-								  float subdivU, float subdivV,
-								  const TQ3NURBPatchData *geomData,
-								  float* uBasisValues, float* vBasisValues, float* uBasisDerivValues, float* vBasisDerivValues )
-{	float		incrementU, incrementV, curIncrU, curIncrV, curU, curV ;
-	float		*interestingU, *interestingV;
-	TQ3Uns32	curKnotU, curKnotV, u, v, ptInd, trInd,
-				numIntU, numIntV, numrows, numcolumns, numpts, numtris ;
+e3geom_nurbpatch_add_triangle( TQ3Uns32 a, TQ3Uns32 b, TQ3Uns32 c, TE3NURBPatchTessellation& theTess )
+{	TQ3TriMeshTriangleData	theTriangle;
+	float					theArea;
 
-#if Q3_DEBUG
-	Q3_ASSERT( thePoints != nullptr && numPoints != nullptr && theUVs != nullptr && theNormals != nullptr
-			   && theTriangles != nullptr && numTriangles != nullptr ) ;
-#endif
-	
-	// First some sanity checking on subdivisionData
-	subdivU = (float) ((TQ3Uns32) E3Num_Clamp(subdivU, 1.0f, 256.0f));
-	subdivV = (float) ((TQ3Uns32) E3Num_Clamp(subdivV, 1.0f, 256.0f));
-	
-	// Find the interesting knots (ie skip the repeated knots)
-	interestingU = (float *) Q3Memory_Allocate(static_cast<TQ3Uns32>((geomData->numColumns - geomData->uOrder + 2) * sizeof(float)));
-	if (interestingU == nullptr) {
-		*thePoints = nullptr ;
-		return ;
-	}
-	numIntU = e3geom_nurbpatch_interesting_knots( geomData->uKnots, geomData->numColumns, geomData->uOrder, interestingU );
-	numcolumns = (numIntU-1)*((TQ3Uns32)subdivU) + 1;
-	
-	interestingV = (float *) Q3Memory_Allocate(static_cast<TQ3Uns32>((geomData->numRows - geomData->vOrder + 2) * sizeof(float)));
-	if (interestingV == nullptr) {
-		Q3Memory_Free( &interestingU ) ;
-		
-		*thePoints = nullptr ;
-		return ;
-	}
-	numIntV = e3geom_nurbpatch_interesting_knots( geomData->vKnots, geomData->numRows, geomData->vOrder, interestingV );
-	numrows = (numIntV-1)*((TQ3Uns32)subdivV) + 1;
-							
-	// Number of points, number of triangles
-	numpts = numrows * numcolumns;
-	numtris = (numrows - 1)*(numcolumns - 1)*2;
-	
-	// Allocate some memory for the TriMesh
-	*thePoints    = (TQ3Point3D *)             Q3Memory_Allocate(static_cast<TQ3Uns32>(numpts    * sizeof(TQ3Point3D)));
-	*theNormals   = (TQ3Vector3D *)            Q3Memory_Allocate(static_cast<TQ3Uns32>(numpts    * sizeof(TQ3Vector3D)));
-	*theUVs       = (TQ3Param2D  *)            Q3Memory_Allocate(static_cast<TQ3Uns32>(numpts    * sizeof(TQ3Param2D)));
-	*theTriangles = (TQ3TriMeshTriangleData *) Q3Memory_Allocate(static_cast<TQ3Uns32>(numtris * sizeof(TQ3TriMeshTriangleData)));
-
-	if (*thePoints == nullptr || *theNormals == nullptr || *theUVs == nullptr || *theTriangles == nullptr) {
-		Q3Memory_Free( &interestingU ) ;
-		Q3Memory_Free( &interestingV ) ;
-		
-		*thePoints = nullptr ;
-		return ;
-	}
-	// Outer V loop
-	for (curKnotV = 0; curKnotV < numIntV - 1; curKnotV++ ) {
-		incrementV = (interestingV[curKnotV+1] - interestingV[curKnotV]) / subdivV;
-		
-		for (curIncrV = 0.0f; curIncrV < subdivV; curIncrV+=1.0f ) {
-			curV = interestingV[curKnotV] + curIncrV*incrementV;
-			
-			// Inner U loop
-			for (curKnotU = 0; curKnotU < numIntU - 1; curKnotU++ ) {
-				incrementU = (interestingU[curKnotU+1] - interestingU[curKnotU]) / subdivU;
-				
-				for (curIncrU = 0.0f; curIncrU < subdivU; curIncrU+=1.0f ) {
-						curU = interestingU[curKnotU] + curIncrU*incrementU;
-						
-						ptInd =  ( curKnotV*(TQ3Uns32)subdivV+(TQ3Uns32)curIncrV )*numcolumns + 
-								curKnotU*(TQ3Uns32)subdivU+(TQ3Uns32)curIncrU ;
-						// Let's try this for our uv's
-						(*theUVs)[ptInd].u = curU ;
-						(*theUVs)[ptInd].v = curV ;
-						
-						e3geom_nurbpatch_evaluate_uv(
-												curU,
-												curV,
-												geomData,
-												&(*theNormals)[ptInd],
-												&(*thePoints)[ptInd],
-												uBasisValues, vBasisValues, uBasisDerivValues, vBasisDerivValues );
+
+
+	// Check the orientation
+	const TQ3Param2D&	uvA = theTess.uvs[a];
+	const TQ3Param2D&	uvB = theTess.uvs[b];
+	const TQ3Param2D&	uvC = theTess.uvs[c];
+
+	theArea = (uvB.u - uvA.u) * (uvC.v - uvA.v) - (uvB.v - uvA.v) * (uvC.u - uvA.u);
+	if (theArea == 0.0f)
+		return;
+
+
+
+	// Add the triangle
+	theTriangle.pointIndices[0] = a;
+	theTriangle.pointIndices[1] = (theArea > 0.0f) ? b : c;
+	theTriangle.pointIndices[2] = (theArea > 0.0f) ? c : b;
+
+	theTess.triangles.push_back( theTriangle );
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_nurbpatch_stitch : Triangulate between a boundary edge and the
+//								  adjacent row of interior vertices.
+//-----------------------------------------------------------------------------
+//		Note :	Both rows run in the same direction, and are merged by
+//				always advancing along the row with the nearer next
+//				parameter value.
+//-----------------------------------------------------------------------------
+static void
+e3geom_nurbpatch_stitch( const std::vector<TQ3Uns32>& outerIndices, const std::vector<float>& outerParams,
+						 const std::vector<TQ3Uns32>& innerIndices, const std::vector<float>& innerParams,
+						 TE3NURBPatchTessellation& theTess )
+{	TQ3Uns32	i, j, lastI, lastJ;
+
+
+
+	// Zip the two rows together
+	i     = 0;
+	j     = 0;
+	lastI = (TQ3Uns32) outerIndices.size() - 1;
+	lastJ = (TQ3Uns32) innerIndices.size() - 1;
+
+	while (i < lastI || j < lastJ)
+		{
+		if (j == lastJ || (i < lastI && outerParams[i + 1] <= innerParams[j + 1]))
+			{
+			e3geom_nurbpatch_add_triangle( outerIndices[i], outerIndices[i + 1], innerIndices[j], theTess );
+			i++;
+			}
+		else
+			{
+			e3geom_nurbpatch_add_triangle( outerIndices[i], innerIndices[j + 1], innerIndices[j], theTess );
+			j++;
+			}
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_nurbpatch_tessellate : Tessellate the patch.
+//-----------------------------------------------------------------------------
+//		Note :	If every boundary edge uses the interior subdivision, the
+//				patch is a regular grid. Otherwise the interior grid is
+//				stitched to separately subdivided boundary edges.
+//-----------------------------------------------------------------------------
+static void
+e3geom_nurbpatch_tessellate( const TQ3NURBPatchData *geomData,
+							 const std::vector<float>& interestingU,
+							 const std::vector<float>& interestingV,
+							 const TE3NURBPatchSubdivision& theSubdiv,
+							 TE3NURBPatchTessellation& theTess )
+{	std::vector<float>			paramsU, paramsV, bottomU, topU, leftV, rightV;
+	std::vector<float>			innerU, innerV;
+	std::vector<TQ3Uns32>		theGrid, outerIndices, innerIndices;
+	TE3NURBPatchBasisTable		uTable, vTable, bottomTable, topTable, leftTable, rightTable;
+	TE3NURBPatchBezierRows		bezierRows;
+	TQ3Uns32					numU, numV, i, j, firstI, lastI, firstJ, lastJ, gridU, gridV, theIndex;
+	TQ3Boolean					isRegular, hasBezier;
+
+
+
+	// Find the parameters of the grid, and precompute their basis functions
+	e3geom_nurbpatch_span_params( interestingU, theSubdiv.uSpans, paramsU );
+	e3geom_nurbpatch_span_params( interestingV, theSubdiv.vSpans, paramsV );
+
+	numU = (TQ3Uns32) paramsU.size();
+	numV = (TQ3Uns32) paramsV.size();
+
+	e3geom_nurbpatch_basis_table_build( paramsU, geomData->numColumns, geomData->uOrder, geomData->uKnots, kQ3True, uTable );
+	e3geom_nurbpatch_basis_table_build( paramsV, geomData->numRows,    geomData->vOrder, geomData->vKnots, kQ3True, vTable );
+
+	isRegular = (TQ3Boolean) (theSubdiv.bottomSpans == theSubdiv.uSpans &&
+							  theSubdiv.topSpans    == theSubdiv.uSpans &&
+							  theSubdiv.leftSpans   == theSubdiv.vSpans &&
+							  theSubdiv.rightSpans  == theSubdiv.vSpans);
+
+	theTess.points.reserve( numU * numV );
+	theTess.normals.reserve( numU * numV );
+	theTess.uvs.reserve( numU * numV );
+	theTess.triangles.reserve( (numU - 1) * (numV - 1) * 2 );
+
+
+
+	// Evaluate the grid, omitting the boundary if it is subdivided separately.
+	// Rows are evaluated from the Bézier form if we have it, and otherwise
+	// from the basis tables. Each row is independent, so large grids are
+	// split into bands of rows which are evaluated on separate threads.
+	firstI = isRegular ? 0        : 1;
+	lastI  = isRegular ? numU - 1 : numU - 2;
+	firstJ = isRegular ? 0        : 1;
+	lastJ  = isRegular ? numV - 1 : numV - 2;
+
+	theGrid.resize( numU * numV );
+
+	gridU = lastI - firstI + 1;
+	gridV = lastJ - firstJ + 1;
+
+	theTess.points.resize( gridU * gridV );
+	theTess.normals.resize( gridU * gridV );
+	theTess.uvs.resize( gridU * gridV );
+
+	for (j = firstJ; j <= lastJ; j++)
+		{
+		for (i = firstI; i <= lastI; i++)
+			theGrid[j * numU + i] = (j - firstJ) * gridU + (i - firstI);
+		}
+
+	hasBezier = (TQ3Boolean) (e3geom_nurbpatch_bezier_rows_build( geomData, bezierRows ) == kQ3Success &&
+							  bezierRows.numSpans == theSubdiv.uSpans.size());
+
+	E3Parallel_For( gridV, E3Num_Max( kParallelVerticesPerThread / gridU, (TQ3Uns32) 1 ),
+		[&]( TQ3Uns32 firstRow, TQ3Uns32 endRow )
+		{
+		std::vector<TQ3RationalPoint4D>		isoCurve;
+		std::vector<TQ3Point3D>				rowPoints( hasBezier ? numU : 0 );
+		std::vector<TQ3Vector3D>			rowNormals( hasBezier ? numU : 0 );
+
+		for (TQ3Uns32 row = firstRow; row < endRow; row++)
+			{
+			if (hasBezier)
+				e3geom_nurbpatch_evaluate_row( geomData, bezierRows, interestingU, theSubdiv.uSpans,
+											   vTable, firstJ + row, isoCurve, &rowPoints[0], &rowNormals[0] );
+
+			for (TQ3Uns32 col = 0; col < gridU; col++)
+				{
+				TQ3Uns32	theVertex = row * gridU + col;
+
+				if (hasBezier)
+					{
+					theTess.points[theVertex]  = rowPoints[firstI + col];
+					theTess.normals[theVertex] = rowNormals[firstI + col];
+					}
+				else
+					e3geom_nurbpatch_evaluate_table( geomData, uTable, firstI + col, vTable, firstJ + row,
+													 &theTess.points[theVertex], &theTess.normals[theVertex] );
+
+				theTess.uvs[theVertex].u = paramsU[firstI + col];
+				theTess.uvs[theVertex].v = paramsV[firstJ + row];
 				}
 			}
-			// Cap evaluation for u
-			ptInd = ( curKnotV*(TQ3Uns32)subdivV+(TQ3Uns32)curIncrV )*numcolumns +
-					numcolumns - 1;
-			// Let's try this for our uv's
-			(*theUVs)[ptInd].u = interestingU[numIntU - 1] ;
-			(*theUVs)[ptInd].v = curV ;
-			e3geom_nurbpatch_evaluate_uv(
-										interestingU[numIntU - 1],
-										curV,
-										geomData,
-										&(*theNormals)[ptInd],
-										&(*thePoints)[ptInd],
-										uBasisValues, vBasisValues, uBasisDerivValues, vBasisDerivValues );
+		} );
 
+	for (j = firstJ; j < lastJ; j++)
+		{
+		for (i = firstI; i < lastI; i++)
+			{
+			e3geom_nurbpatch_add_triangle( theGrid[j * numU + i],
+										   theGrid[j * numU + i + 1],
+										   theGrid[(j + 1) * numU + i], theTess );
+
+			e3geom_nurbpatch_add_triangle( theGrid[j * numU + i + 1],
+										   theGrid[(j + 1) * numU + i + 1],
+										   theGrid[(j + 1) * numU + i], theTess );
+			}
 		}
-	}
-	// Final evaluation loop (on the v-cap)
-	for (curKnotU = 0; curKnotU < numIntU - 1; curKnotU++ ) {
-		incrementU = (interestingU[curKnotU+1] - interestingU[curKnotU]) / subdivU;
-		
-		for (curIncrU = 0.0f; curIncrU < subdivU; curIncrU+=1.0f ) {
-				curU = interestingU[curKnotU] + curIncrU*incrementU;
-				
-				ptInd =  (numrows - 1)*numcolumns + 
-						curKnotU*(TQ3Uns32)subdivU+(TQ3Uns32)curIncrU ;
-				// Let's try this for our uv's
-				(*theUVs)[ptInd].u = curU ;
-				(*theUVs)[ptInd].v = interestingV[numIntV - 1] ;
-				
-				e3geom_nurbpatch_evaluate_uv(
-										curU,
-										interestingV[numIntV - 1],
-										geomData,
-										&(*theNormals)[ptInd],
-										&(*thePoints)[ptInd],
-										uBasisValues, vBasisValues, uBasisDerivValues, vBasisDerivValues );
+
+	if (isRegular)
+		return;
+
+
+
+	// Find the parameters of the boundary edges
+	e3geom_nurbpatch_span_params( interestingU, theSubdiv.bottomSpans, bottomU );
+	e3geom_nurbpatch_span_params( interestingU, theSubdiv.topSpans,    topU    );
+	e3geom_nurbpatch_span_params( interestingV, theSubdiv.leftSpans,   leftV   );
+	e3geom_nurbpatch_span_params( interestingV, theSubdiv.rightSpans,  rightV  );
+
+	e3geom_nurbpatch_basis_table_build( bottomU, geomData->numColumns, geomData->uOrder, geomData->uKnots, kQ3True, bottomTable );
+	e3geom_nurbpatch_basis_table_build( topU,    geomData->numColumns, geomData->uOrder, geomData->uKnots, kQ3True, topTable    );
+	e3geom_nurbpatch_basis_table_build( leftV,   geomData->numRows,    geomData->vOrder, geomData->vKnots, kQ3True, leftTable   );
+	e3geom_nurbpatch_basis_table_build( rightV,  geomData->numRows,    geomData->vOrder, geomData->vKnots, kQ3True, rightTable  );
+
+	innerU.assign( paramsU.begin() + 1, paramsU.end() - 1 );
+	innerV.assign( paramsV.begin() + 1, paramsV.end() - 1 );
+
+
+
+	// Bottom edge, v = v0
+	outerIndices.clear();
+	innerIndices.clear();
+
+	for (i = 0; i < bottomU.size(); i++)
+		outerIndices.push_back( e3geom_nurbpatch_add_vertex( geomData, bottomTable, i, bottomU[i],
+																	   vTable, 0, paramsV[0], theTess ) );
+
+	for (i = 1; i <= numU - 2; i++)
+		innerIndices.push_back( theGrid[1 * numU + i] );
+
+	e3geom_nurbpatch_stitch( outerIndices, bottomU, innerIndices, innerU, theTess );
+
+	const TQ3Uns32	cornerU0V0 = outerIndices.front();
+	const TQ3Uns32	cornerU1V0 = outerIndices.back();
+
+
+
+	// Top edge, v = v1
+	outerIndices.clear();
+	innerIndices.clear();
+
+	for (i = 0; i < topU.size(); i++)
+		outerIndices.push_back( e3geom_nurbpatch_add_vertex( geomData, topTable, i, topU[i],
+																	   vTable, numV - 1, paramsV[numV - 1], theTess ) );
+
+	for (i = 1; i <= numU - 2; i++)
+		innerIndices.push_back( theGrid[(numV - 2) * numU + i] );
+
+	e3geom_nurbpatch_stitch( outerIndices, topU, innerIndices, innerU, theTess );
+
+	const TQ3Uns32	cornerU0V1 = outerIndices.front();
+	const TQ3Uns32	cornerU1V1 = outerIndices.back();
+
+
+
+	// Left edge, u = u0, sharing the corners with the bottom and top edges
+	outerIndices.clear();
+	innerIndices.clear();
+
+	for (j = 0; j < leftV.size(); j++)
+		{
+		if (j == 0)
+			theIndex = cornerU0V0;
+		else if (j == leftV.size() - 1)
+			theIndex = cornerU0V1;
+		else
+			theIndex = e3geom_nurbpatch_add_vertex( geomData, uTable, 0, paramsU[0],
+															  leftTable, j, leftV[j], theTess );
+		outerIndices.push_back( theIndex );
 		}
-	}
-	// The grande finale cap evaluation
-	ptInd = numpts - 1;
-	// Let's try this for our uv's
-	(*theUVs)[ptInd].u = interestingU[numIntU - 1] ;
-	(*theUVs)[ptInd].v = interestingV[numIntV - 1] ;
-
-	e3geom_nurbpatch_evaluate_uv(
-								interestingU[numIntU - 1],
-								interestingV[numIntV - 1],
-								geomData,
-								&(*theNormals)[ptInd],
-								&(*thePoints)[numpts - 1],
-								uBasisValues, vBasisValues, uBasisDerivValues, vBasisDerivValues );
-
-	// Make triangles from the points
-	for ( v = 0; v < numrows - 1; v++ )
-		for ( u = 0; u < (numcolumns - 1)*2; u+=2 ) {
-			// The first triangle
-			trInd = v*(numcolumns-1)*2 + u;
-															ptInd = v*numcolumns + u/2;
-			(*theTriangles)[trInd].pointIndices[0] = ptInd;
-															ptInd = v*numcolumns + u/2 +1;
-			(*theTriangles)[trInd].pointIndices[1] = ptInd;
-															ptInd = (v+1)*numcolumns + u/2;
-			(*theTriangles)[trInd].pointIndices[2] = ptInd;
-			// The second triangle
-			trInd = v*(numcolumns-1)*2 + u+1;
-															ptInd = v*numcolumns + u/2 +1;
-			(*theTriangles)[trInd].pointIndices[0] = ptInd;
-															ptInd = (v+1)*numcolumns + u/2 +1;
-			(*theTriangles)[trInd].pointIndices[1] = ptInd;
-															ptInd = (v+1)*numcolumns + u/2;
-			(*theTriangles)[trInd].pointIndices[2] = ptInd;
-	}
 
-	//  Uncomment this and get a big flat square approximating the surface.
-	//	Not very interesting if what is supposed to work does ;)
-	//	(*theTriangles)[0].pointIndices[0] = 0;
-	//	(*theTriangles)[0].pointIndices[1] = numpts-1;//numcolumns - 1;
-	//	(*theTriangles)[0].pointIndices[2] = (numrows-1)*(numcolumns);
-	//	(*theTriangles)[1].pointIndices[0] = numrows - 1;
-	//	(*theTriangles)[1].pointIndices[1] = numpts - 1;
-	//	(*theTriangles)[1].pointIndices[2] = (numrows-1)*(numcolumns);
-	
-	*numPoints = numpts ;
-	*numTriangles = numtris ;
+	for (j = 1; j <= numV - 2; j++)
+		innerIndices.push_back( theGrid[j * numU + 1] );
+
+	e3geom_nurbpatch_stitch( outerIndices, leftV, innerIndices, innerV, theTess );
+
+
+
+	// Right edge, u = u1, sharing the corners with the bottom and top edges
+	outerIndices.clear();
+	innerIndices.clear();
+
+	for (j = 0; j < rightV.size(); j++)
+		{
+		if (j == 0)
+			theIndex = cornerU1V0;
+		else if (j == rightV.size() - 1)
+			theIndex = cornerU1V1;
+		else
+			theIndex = e3geom_nurbpatch_add_vertex( geomData, uTable, numU - 1, paramsU[numU - 1],
+															  rightTable, j, rightV[j], theTess );
+		outerIndices.push_back( theIndex );
+		}
+
+	for (j = 1; j <= numV - 2; j++)
+		innerIndices.push_back( theGrid[j * numU + numU - 2] );
+
+	e3geom_nurbpatch_stitch( outerIndices, rightV, innerIndices, innerV, theTess );
 }
 
 
@@ -1163,109 +1472,81 @@ e3geom_nurbpatch_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 	TQ3TriMeshData			triMeshData;
 	TQ3GeometryObject		theTriMesh;
 	TQ3GroupObject			theGroup;
-	TQ3Point3D 				*points;
-	TQ3Vector3D 			*normals;
-	TQ3Param2D				*uvs;
-	TQ3TriMeshTriangleData	*triangles;
 	TQ3SubdivisionStyleData	subdivisionData;
 	TQ3TriMeshAttributeData	vertexAttributes[2];
-	float					subdivU = 10.0f, subdivV = 10.0f;
-	TQ3Uns32				numpoints = 0, numtriangles = 0;
-	float					*uBasisValues, *vBasisValues, *uBasisDerivValues, *vBasisDerivValues ;
-	
-	theGroup = nullptr;
-	points = nullptr ;
-	normals = nullptr ;
-	uvs = nullptr ;
-	triangles = nullptr ;
-	uBasisValues = vBasisValues = uBasisDerivValues = vBasisDerivValues = nullptr ;
-	
-	// Set nullptr initially so that return value is nullptr if we goto the error label
-	Q3Memory_Clear(&triMeshData, sizeof(triMeshData));
-	theTriMesh = nullptr;
-	
-	uBasisValues = (float*) Q3Memory_Allocate( static_cast<TQ3Uns32>(geomData->numColumns * sizeof(float)) ) ;
-	if( uBasisValues == nullptr )
-		goto surface_cache_new_error_cleanup ;
-	vBasisValues = (float*) Q3Memory_Allocate( static_cast<TQ3Uns32>(geomData->numRows * sizeof(float)) ) ;
-	if( vBasisValues == nullptr )
-		goto surface_cache_new_error_cleanup ;
-	
-	uBasisDerivValues = (float*) Q3Memory_Allocate( static_cast<TQ3Uns32>(geomData->numColumns * sizeof(float)) ) ;
-	if( uBasisDerivValues == nullptr )
-		goto surface_cache_new_error_cleanup ;
-	vBasisDerivValues = (float*) Q3Memory_Allocate( static_cast<TQ3Uns32>(geomData->numRows * sizeof(float)) ) ;
-	if( vBasisDerivValues == nullptr )
-		goto surface_cache_new_error_cleanup ;
-	
-	// Get the subdivision style, figure out how to tessellate.
-	if (Q3View_GetSubdivisionStyleState( theView, &subdivisionData ) == kQ3Success) {
-		subdivU = subdivisionData.c1;
-		subdivV = subdivisionData.c2;
-
-		switch (subdivisionData.method) {
-			case kQ3SubdivisionMethodScreenSpace:
-				e3geom_nurbpatch_worldscreen_subdiv( &points, &numpoints, &uvs, &normals,
-												  	 &triangles, &numtriangles,
-												  	 subdivU,
-												  	 geomData, theView, kQ3True,
-												  	 uBasisValues, vBasisValues, uBasisDerivValues, vBasisDerivValues ) ;
-
-				if( points == nullptr )
-					goto surface_cache_new_error_cleanup ;
-				
-				break;
+	std::vector<float>		interestingU, interestingV;
+	TE3NURBPatchSubdivision	theSubdiv;
+	TE3NURBPatchTessellation	theTess;
+	TQ3Uns32				numIntU, numIntV;
 
-			case kQ3SubdivisionMethodWorldSpace:
-				e3geom_nurbpatch_worldscreen_subdiv( &points, &numpoints, &uvs, &normals,
-												  	 &triangles, &numtriangles,
-												  	 subdivU,
-												  	 geomData, theView, kQ3False,
-												  	 uBasisValues, vBasisValues, uBasisDerivValues, vBasisDerivValues ) ;
 
-				if( points == nullptr )
-					goto surface_cache_new_error_cleanup ;
-				
-				break;
-
-			case kQ3SubdivisionMethodConstant:
-				e3geom_nurbpatch_constant_subdiv( &points, &numpoints, &uvs, &normals,
-												  &triangles, &numtriangles,
-												  subdivU, subdivV,
-												  geomData,
-												  uBasisValues, vBasisValues, uBasisDerivValues, vBasisDerivValues ) ;
-				
-				if( points == nullptr )
-					goto surface_cache_new_error_cleanup ;
-				
-				break;
-			
-			default:
-				Q3_ASSERT(!"Unknown subdivision method");
-				break;
+
+	// Find the interesting knots (ie skip the repeated knots)
+	interestingU.resize( geomData->numColumns - geomData->uOrder + 2 );
+	numIntU = e3geom_nurbpatch_interesting_knots( geomData->uKnots, geomData->numColumns, geomData->uOrder, &interestingU[0] );
+	interestingU.resize( numIntU );
+
+	interestingV.resize( geomData->numRows - geomData->vOrder + 2 );
+	numIntV = e3geom_nurbpatch_interesting_knots( geomData->vKnots, geomData->numRows, geomData->vOrder, &interestingV[0] );
+	interestingV.resize( numIntV );
+
+	if (numIntU < 2 || numIntV < 2)
+		return(nullptr);
+
+
+
+	// Get the subdivision style, figure out how to tessellate.
+	if (Q3View_GetSubdivisionStyleState( theView, &subdivisionData ) != kQ3Success)
+		{
+		subdivisionData.method = kQ3SubdivisionMethodConstant;
+		subdivisionData.c1     = 10.0f;
+		subdivisionData.c2     = 10.0f;
 		}
+
+	switch (subdivisionData.method) {
+		case kQ3SubdivisionMethodScreenSpace:
+			e3geom_nurbpatch_worldscreen_subdiv( subdivisionData.c1,
+												 geomData, theView, kQ3True,
+												 interestingU, interestingV, theSubdiv );
+			break;
+
+		case kQ3SubdivisionMethodWorldSpace:
+			e3geom_nurbpatch_worldscreen_subdiv( subdivisionData.c1,
+												 geomData, theView, kQ3False,
+												 interestingU, interestingV, theSubdiv );
+			break;
+
+		case kQ3SubdivisionMethodConstant:
+		default:
+			Q3_ASSERT(subdivisionData.method == kQ3SubdivisionMethodConstant);
+			e3geom_nurbpatch_constant_subdiv( subdivisionData.c1, subdivisionData.c2,
+											  interestingU, interestingV, theSubdiv );
+			break;
 	}
-	Q3_ASSERT( normals != nullptr );
-	
-	
+
+	e3geom_nurbpatch_tessellate( geomData, interestingU, interestingV, theSubdiv, theTess );
+
+
+
 	// set up the attributes
+	Q3Memory_Clear(&triMeshData, sizeof(triMeshData));
 	E3AttributeSet_Combine(geomData->patchAttributeSet, nullptr, &triMeshData.triMeshAttributeSet);
 
 
 
 	// set up remaining trimesh data
 	vertexAttributes[0].attributeType     = kQ3AttributeTypeNormal;
-	vertexAttributes[0].data              = normals;
+	vertexAttributes[0].data              = &theTess.normals[0];
 	vertexAttributes[0].attributeUseArray = nullptr;
-	
+
 	vertexAttributes[1].attributeType     = kQ3AttributeTypeSurfaceUV;
-	vertexAttributes[1].data              = uvs;
+	vertexAttributes[1].data              = &theTess.uvs[0];
 	vertexAttributes[1].attributeUseArray = nullptr;
-	
-	triMeshData.numPoints                 = numpoints;
-	triMeshData.points                    = points;
-	triMeshData.numTriangles              = numtriangles;
-	triMeshData.triangles                 = triangles;
+
+	triMeshData.numPoints                 = (TQ3Uns32) theTess.points.size();
+	triMeshData.points                    = &theTess.points[0];
+	triMeshData.numTriangles              = (TQ3Uns32) theTess.triangles.size();
+	triMeshData.triangles                 = theTess.triangles.empty() ? nullptr : &theTess.triangles[0];
 	triMeshData.numTriangleAttributeTypes = 0;
 	triMeshData.triangleAttributeTypes    = nullptr;
 	triMeshData.numEdges                  = 0;
@@ -1274,10 +1555,10 @@ e3geom_nurbpatch_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 	triMeshData.edgeAttributeTypes        = nullptr;
 	triMeshData.numVertexAttributeTypes   = 2;
 	triMeshData.vertexAttributeTypes      = vertexAttributes;
-	
+
 	Q3BoundingBox_SetFromPoints3D(&triMeshData.bBox,
 									triMeshData.points,
-									numpoints,
+									triMeshData.numPoints,
 									sizeof(TQ3Point3D));
 
 
@@ -1289,19 +1570,8 @@ e3geom_nurbpatch_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 
 
 	// Clean up
-surface_cache_new_error_cleanup:
-	
 	Q3Object_CleanDispose(&triMeshData.triMeshAttributeSet);
-	Q3Memory_Free(&points);
-	Q3Memory_Free(&normals);
-	Q3Memory_Free(&uvs);
-	Q3Memory_Free(&triangles);
-	
-	Q3Memory_Free(&uBasisValues);
-	Q3Memory_Free(&vBasisValues);
-	Q3Memory_Free(&uBasisDerivValues);
-	Q3Memory_Free(&vBasisDerivValues);
-	
+
 	return(theGroup);
 }
 
@@ -56,6 +56,17 @@
 
 
 
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+#define kTemplatePartSurface					0
+#define kTemplateFlagRightHanded				(1 << 0)
+#define kCircularTolerance						1.0e-5f
+
+
+
+
+
 //=============================================================================
 //      Internal types
 //-----------------------------------------------------------------------------
@@ -515,6 +526,104 @@ e3geom_torus_create_surface( const TQ3TorusData& geomData,
 
 
 
+//=============================================================================
+//      e3geom_torus_create_template : Create the surface from a template.
+//-----------------------------------------------------------------------------
+//		Note :	The surface of a torus scales the minor radius by the length of
+//				axis(u), so it is only an affine image of a template when the
+//				major and minor radii are perpendicular and of equal length. In
+//				that case the template is a torus with unit radii, whose ratio
+//				is ratio * |orientation| / |majorRadius|.
+//
+//				Returns an invalid reference if the torus is not circular.
+//-----------------------------------------------------------------------------
+static CQ3ObjectRef
+e3geom_torus_create_template( const TQ3TorusData& geomData,
+							float uMin, float uMax,
+							float vMin, float vMax,
+							TQ3Uns32 uSegments,
+							TQ3Uns32 vSegments )
+{
+	TE3GeometryTemplateKey	theKey;
+	TQ3TorusData			templateData;
+	TQ3Matrix4x4			templateToLocal;
+	float					majLen, minLen;
+	bool					isRightHanded;
+
+
+
+	// Check that the torus is circular
+	majLen = Q3FastVector3D_Length( &geomData.majorRadius );
+	minLen = Q3FastVector3D_Length( &geomData.minorRadius );
+
+	if ( (majLen < kQ3RealZero) ||
+		(E3Float_Abs( majLen - minLen ) > kCircularTolerance * majLen) ||
+		(E3Float_Abs( Q3FastVector3D_Dot( &geomData.majorRadius, &geomData.minorRadius ) ) >
+			kCircularTolerance * majLen * minLen) )
+	{
+		return CQ3ObjectRef();
+	}
+
+
+
+	// Find the template frame
+	isRightHanded = (E3Geometry_GetTemplateFrame( &geomData.origin, &geomData.orientation,
+		&geomData.majorRadius, &geomData.minorRadius, &templateToLocal ) == kQ3True);
+
+	templateData = geomData;
+	templateData.origin.x      = 0.0f;
+	templateData.origin.y      = 0.0f;
+	templateData.origin.z      = 0.0f;
+	templateData.orientation.x = 0.0f;
+	templateData.orientation.y = 0.0f;
+	templateData.orientation.z = isRightHanded ? 1.0f : -1.0f;
+	templateData.majorRadius.x = 1.0f;
+	templateData.majorRadius.y = 0.0f;
+	templateData.majorRadius.z = 0.0f;
+	templateData.minorRadius.x = 0.0f;
+	templateData.minorRadius.y = 1.0f;
+	templateData.minorRadius.z = 0.0f;
+	templateData.ratio = geomData.ratio * Q3FastVector3D_Length( &geomData.orientation ) / majLen;
+	templateData.torusAttributeSet = nullptr;
+
+
+
+	// Find or build the template
+	Q3Memory_Clear( &theKey, sizeof(theKey) );
+	theKey.geomType     = kQ3GeometryTypeTorus;
+	theKey.partType     = kTemplatePartSurface;
+	theKey.uSegments    = uSegments;
+	theKey.vSegments    = vSegments;
+	theKey.theFlags     = isRightHanded ? kTemplateFlagRightHanded : 0;
+	theKey.theParams[0] = uMin;
+	theKey.theParams[1] = uMax;
+	theKey.theParams[2] = vMin;
+	theKey.theParams[3] = vMax;
+	theKey.theParams[4] = templateData.ratio;
+
+	CQ3ObjectRef	theTemplate( E3Geometry_FindTemplate( &theKey ) );
+	if (! theTemplate.isvalid())
+	{
+		theTemplate = e3geom_torus_create_surface( templateData,
+			uMin, uMax, vMin, vMax, uSegments, vSegments );
+
+		if (! theTemplate.isvalid())
+			return theTemplate;
+
+		E3Geometry_AddTemplate( &theKey, theTemplate.get() );
+	}
+
+
+
+	// Return an instance of it
+	return CQ3ObjectRef( E3Geometry_NewTemplateInstance( theTemplate.get(),
+		&templateToLocal, nullptr ) );
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_torus_cache_new : Torus cache new method.
 //-----------------------------------------------------------------------------
@@ -563,8 +672,16 @@ e3geom_torus_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom,
 	}
 	
 
-	CQ3ObjectRef	theTriMesh( e3geom_torus_create_surface( *geomData,
-		uMin, uMax, vMin, vMax, upts, vpts ) );
+	// Share the tessellation with other tori if we can
+	CQ3ObjectRef	theTriMesh;
+	if (E3Geometry_CanShareTemplates())
+		theTriMesh = e3geom_torus_create_template( *geomData,
+			uMin, uMax, vMin, vMax, upts, vpts );
+
+	if (! theTriMesh.isvalid())
+		theTriMesh = e3geom_torus_create_surface( *geomData,
+			uMin, uMax, vMin, vMax, upts, vpts );
+
 	if (theTriMesh.isvalid())
 	{
 		Q3Group_AddObject( (TQ3GroupObject _Nonnull) resultGroup.get(),
@@ -1173,6 +1173,21 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 	}
 
 
+	// If the pick only wants its nearest hit, skip meshes which lie beyond it
+	TQ3Point3D	viewerLocation;
+	float		closestDistance;
+	bool		haveClosestLimit = E3Pick_GetClosestHitLimit( thePick, theView,
+		&viewerLocation, &closestDistance );
+	if (haveClosestLimit)
+	{
+		E3BoundingBox_Transform( &geomData->bBox, localToWorld, &worldBounds );
+		if (E3Pick_IsBoundsBeyondClosestHit( thePick, theView, &worldBounds ))
+		{
+			return kQ3Success;
+		}
+	}
+
+
 	// Transform our points from local to world coordinates
 	numPoints   = geomData->numPoints;
 	worldPoints = (TQ3Point3D *) Q3Memory_Allocate(static_cast<TQ3Uns32>(numPoints * sizeof(TQ3Point3D)));
@@ -1245,6 +1260,19 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 				p0, p1, p2, cullBackface, theHit );
 		}
 
+		// Skip hits which are no nearer than the pick's nearest hit, before
+		// the work of interpolating their attributes
+		if (didHit && haveClosestLimit)
+		{
+			TQ3Point3D triHitPt = (1.0f - theHit.u - theHit.v) * p0 +
+				theHit.u * p1 + theHit.v * p2;
+			
+			if (Q3LengthSquared3D( triHitPt - viewerLocation ) >= closestDistance * closestDistance)
+			{
+				didHit = kQ3False;
+			}
+		}
+
 		if (didHit)
 		{
 			// Create the triangle, and update the vertices to the transformed coordinates
@@ -1264,6 +1292,8 @@ e3geom_trimesh_pick_with_ray( TQ3ViewObject				theView,
 			// Record the hit
 			qd3dStatus = E3Pick_RecordHit(thePick, theView, &hitXYZ, &hitNormal,
 				resultUV, nullptr, &theHit, n );
+			haveClosestLimit = E3Pick_GetClosestHitLimit( thePick, theView,
+				&viewerLocation, &closestDistance );
 
 
 			// Clean up
@@ -1507,6 +1537,8 @@ e3geom_trimesh_pick_window_rect(TQ3ViewObject theView, TQ3PickObject thePick, co
 {	TQ3Area						windowBounds;
 	TQ3Status					qd3dStatus = kQ3Success;
 	TQ3WindowRectPickData		pickData;
+	TQ3BackfacingStyle			backfacingStyle;
+	TQ3Boolean					cullBackface;
 
 
 
@@ -1515,6 +1547,25 @@ e3geom_trimesh_pick_window_rect(TQ3ViewObject theView, TQ3PickObject thePick, co
 
 
 
+	// If the pick only wants visible objects, draw ourselves into its ID buffer.
+	// The buffer clips to the rect, so we only need to be in the frustum.
+	if (E3WindowRectPick_UsesIDBuffer(thePick, theView))
+	{
+		if (E3View_IsBoundingBoxVisible(theView, &geomData->bBox))
+		{
+			qd3dStatus   = E3View_GetBackfacingStyleState(theView, &backfacingStyle);
+			cullBackface = (TQ3Boolean)(qd3dStatus == kQ3Success && backfacingStyle == kQ3BackfacingStyleRemove);
+
+			qd3dStatus = E3WindowRectPick_RasterizeTriangles(thePick, theView,
+							geomData->numTriangles, geomData->triangles,
+							geomData->numPoints, geomData->points, cullBackface, kQ3True);
+		}
+
+		return(qd3dStatus);
+	}
+
+
+
 	// Obtain our window bounding rectangle
 	e3geom_trimesh_pick_screen_bounds(theView, geomData, &windowBounds);
 
@@ -1561,6 +1612,69 @@ e3geom_trimesh_pick_world_ray(TQ3ViewObject theView, TQ3PickObject thePick, cons
 
 
 
+
+//=============================================================================
+//      e3geom_trimesh_pick_world_ray_batch : TriMesh world-ray batch picking method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_trimesh_pick_world_ray_batch(TQ3ViewObject theView, TQ3PickObject thePick, const TQ3TriMeshData *geomData)
+{	TQ3BackfacingStyle			backfacingStyle;
+	TQ3BoundingBox				worldBounds;
+	TQ3Boolean					cullBackface;
+	TQ3Point3D					*worldPoints;
+	TQ3Status					qd3dStatus;
+
+
+
+	// Find the rays which can hit the mesh
+	const TQ3Matrix4x4* localToWorld = E3View_State_GetMatrixLocalToWorld(theView);
+	E3BoundingBox_Transform( &geomData->bBox, localToWorld, &worldBounds );
+	if (! E3WorldRayBatchPick_PushBounds( thePick, &worldBounds ))
+		return(kQ3Success);
+
+
+
+	// Transform our points from local to world coordinates
+	worldPoints = (TQ3Point3D *) Q3Memory_Allocate(static_cast<TQ3Uns32>(geomData->numPoints * sizeof(TQ3Point3D)));
+	if (worldPoints == nullptr)
+		{
+		E3WorldRayBatchPick_PopBounds( thePick );
+		return(kQ3Failure);
+		}
+
+	Q3Point3D_To3DTransformArray(geomData->points,
+								 localToWorld,
+								 worldPoints,
+								 geomData->numPoints,
+								 sizeof(TQ3Point3D),
+								 sizeof(TQ3Point3D));
+
+
+
+	// Determine if we should cull back-facing triangles or not
+	qd3dStatus   = E3View_GetBackfacingStyleState(theView, &backfacingStyle);
+	cullBackface = (TQ3Boolean)(qd3dStatus == kQ3Success && backfacingStyle == kQ3BackfacingStyleRemove);
+
+
+
+	// Test the rays against the triangles
+	qd3dStatus = E3WorldRayBatchPick_PickTriangles( thePick, theView,
+					geomData->numTriangles, geomData->triangles, worldPoints,
+					cullBackface, kQ3True );
+
+
+
+	// Clean up
+	Q3Memory_Free(&worldPoints);
+	E3WorldRayBatchPick_PopBounds( thePick );
+
+	return(qd3dStatus);
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_trimesh_pick : TriMesh picking method.
 //-----------------------------------------------------------------------------
@@ -1595,6 +1709,10 @@ e3geom_trimesh_pick(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object t
 			qd3dStatus = e3geom_trimesh_pick_world_ray(theView, thePick, geomData);
 			break;
 
+		case kQ3PickTypeWorldRayBatch:
+			qd3dStatus = e3geom_trimesh_pick_world_ray_batch(theView, thePick, geomData);
+			break;
+
 		default:
 			qd3dStatus = kQ3Failure;
 			break;
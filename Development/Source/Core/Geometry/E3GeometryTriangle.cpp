@@ -303,6 +303,26 @@ e3geom_triangle_pick_window_rect(TQ3ViewObject theView, TQ3PickObject thePick, T
 
 
 
+	// If the pick only wants visible objects, draw ourselves into its ID buffer
+	if (E3WindowRectPick_UsesIDBuffer(thePick, theView))
+	{
+		TQ3TriMeshTriangleData	theTriangle = { { 0, 1, 2 } };
+		TQ3Point3D				localPoints[3];
+		TQ3BackfacingStyle		backfacingStyle;
+		TQ3Boolean				cullBackface;
+
+		for (n = 0; n < 3; n++)
+			localPoints[n] = instanceData->vertices[n].point;
+
+		qd3dStatus   = E3View_GetBackfacingStyleState(theView, &backfacingStyle);
+		cullBackface = (TQ3Boolean)(qd3dStatus == kQ3Success && backfacingStyle == kQ3BackfacingStyleRemove);
+
+		return(E3WindowRectPick_RasterizeTriangles(thePick, theView, 1, &theTriangle,
+					3, localPoints, cullBackface, kQ3False));
+	}
+
+
+
 	// Transform our points from local to window space
 	for (n = 0; n < 3; n++)
 	{
@@ -361,6 +381,47 @@ e3geom_triangle_pick_world_ray(TQ3ViewObject theView, TQ3PickObject thePick, TQ3
 
 
 
+
+//=============================================================================
+//      e3geom_triangle_pick_world_ray_batch : Triangle world-ray batch picking method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_triangle_pick_world_ray_batch(TQ3ViewObject theView, TQ3PickObject thePick, TQ3Object theObject, const void *objectData)
+{	const TQ3TriangleData		*instanceData = (const TQ3TriangleData *) objectData;
+	TQ3TriMeshTriangleData		theTriangle = { { 0, 1, 2 } };
+	TQ3BackfacingStyle			backfacingStyle;
+	TQ3Point3D					worldPoints[3];
+	TQ3Boolean					cullBackface;
+	TQ3Status					qd3dStatus;
+	TQ3Uns32					n;
+#pragma unused(theObject)
+
+
+
+	// Transform our points
+	for (n = 0; n < 3; n++)
+		Q3View_TransformLocalToWorld(theView, &instanceData->vertices[n].point,
+			&worldPoints[n]);
+
+
+
+	// Determine if we should cull back-facing triangles or not
+	qd3dStatus   = E3View_GetBackfacingStyleState(theView, &backfacingStyle);
+	cullBackface = (TQ3Boolean)(qd3dStatus == kQ3Success && backfacingStyle == kQ3BackfacingStyleRemove);
+
+
+
+	// Test the rays against the triangle
+	qd3dStatus = E3WorldRayBatchPick_PickTriangles(thePick, theView, 1, &theTriangle,
+					worldPoints, cullBackface, kQ3False);
+
+	return(qd3dStatus);
+}
+
+
+
+
+
 //=============================================================================
 //      e3geom_triangle_pick : Triangle picking method.
 //-----------------------------------------------------------------------------
@@ -386,6 +447,10 @@ e3geom_triangle_pick(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object
 			qd3dStatus = e3geom_triangle_pick_world_ray(theView, thePick, theObject, objectData);
 			break;
 
+		case kQ3PickTypeWorldRayBatch:
+			qd3dStatus = e3geom_triangle_pick_world_ray_batch(theView, thePick, theObject, objectData);
+			break;
+
 		default:
 			qd3dStatus = kQ3Failure;
 			break;
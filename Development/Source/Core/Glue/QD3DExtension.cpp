@@ -46,6 +46,7 @@
 //-----------------------------------------------------------------------------
 #include "E3Prefix.h"
 #include "E3Extension.h"
+#include "E3View.h"
 
 
 
@@ -380,6 +381,35 @@ Q3XObject_GetClass(TQ3Object object)
 
 
 
+//=============================================================================
+//      Q3XView_SubmitImmediateClass : Quesa API entry point.
+//-----------------------------------------------------------------------------
+//		Note :	This is a fast path for trusted callers, so validation is
+//				limited to debug builds and the bottleneck is not called.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3XView_SubmitImmediateClass(TQ3ViewObject view, TQ3XObjectClass objectClass, const void *objectData)
+{
+
+
+	// Release build checks
+
+
+
+	// Debug build checks
+	Q3_ASSERT(E3View_IsOfMyClass(view));
+	Q3_ASSERT(Q3_VALID_PTR(objectClass));
+
+
+
+	// Call our implementation
+	return(E3View_SubmitImmediateClass(view, objectClass, objectData));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3XSharedLibrary_Register : Quesa API entry point.
 //-----------------------------------------------------------------------------
@@ -1040,6 +1040,35 @@ Q3Uns8_Write(TQ3Uns8 data, TQ3FileObject theFile)
 
 
 
+//=============================================================================
+//      Q3Uns8_WriteArray : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Uns8_WriteArray (
+	TQ3Uns32					numNums,
+	const TQ3Uns8*				intArray,
+	TQ3FileObject            	theFile
+)
+{
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(intArray), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_IsType(theFile, (kQ3SharedTypeFile)), kQ3Failure);
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return (E3Uns8_WriteArray( numNums, intArray, (E3File*) theFile ));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3Uns16_Read : Quesa API entry point.
 //-----------------------------------------------------------------------------
@@ -1130,6 +1159,35 @@ Q3Uns16_Write(TQ3Uns16 data, TQ3FileObject theFile)
 
 
 
+//=============================================================================
+//      Q3Uns16_WriteArray : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Uns16_WriteArray (
+	TQ3Uns32					numNums,
+	const TQ3Uns16*				intArray,
+	TQ3FileObject            	theFile
+)
+{
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(intArray), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_IsType(theFile, (kQ3SharedTypeFile)), kQ3Failure);
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return (E3Uns16_WriteArray( numNums, intArray, (E3File*) theFile ));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3Uns32_Read : Quesa API entry point.
 //-----------------------------------------------------------------------------
@@ -1220,6 +1278,35 @@ Q3Uns32_Write(TQ3Uns32 data, TQ3FileObject theFile)
 
 
 
+//=============================================================================
+//      Q3Uns32_WriteArray : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Uns32_WriteArray (
+	TQ3Uns32					numNums,
+	const TQ3Uns32*				intArray,
+	TQ3FileObject            	theFile
+)
+{
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(intArray), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_IsType(theFile, (kQ3SharedTypeFile)), kQ3Failure);
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return (E3Uns32_WriteArray( numNums, intArray, (E3File*) theFile ));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3Int8_Read : Quesa API entry point.
 //-----------------------------------------------------------------------------
@@ -1615,6 +1702,35 @@ Q3Float32_Write(TQ3Float32 data, TQ3FileObject theFile)
 
 
 
+//=============================================================================
+//      Q3Float32_WriteArray : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Float32_WriteArray (
+	TQ3Uns32					numFloats,
+	const TQ3Float32*				floatArray,
+	TQ3FileObject            	theFile
+)
+{
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(floatArray), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_IsType(theFile, (kQ3SharedTypeFile)), kQ3Failure);
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return (E3Float32_WriteArray( numFloats, floatArray, (E3File*) theFile ));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3Float64_Read : Quesa API entry point.
 //-----------------------------------------------------------------------------
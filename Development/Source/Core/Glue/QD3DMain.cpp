@@ -49,6 +49,8 @@
 #include "E3CustomElements.h"
 #include "E3Set.h"
 #include "E3View.h"
+#include "E3Storage.h"
+#include "E3Trace.h"
 
 
 extern int gDebugMode;
@@ -1905,3 +1907,121 @@ Q3Bitmap_SetBit(TQ3Bitmap *theBitmap, TQ3Uns32 x, TQ3Uns32 y, TQ3Boolean theStat
 
 
 
+//=============================================================================
+//      Q3Trace_SetState : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Trace_SetState(TQ3Boolean isEnabled)
+{
+
+
+	// Release build checks
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Trace_SetState(isEnabled));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Trace_GetState : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+Q3Trace_GetState(void)
+{
+
+
+	// Release build checks
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Trace_GetState());
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Trace_Clear : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Trace_Clear(void)
+{
+
+
+	// Release build checks
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Trace_Clear());
+}
+
+
+
+
+
+//=============================================================================
+//      Q3Trace_Write : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Trace_Write(TQ3StorageObject storage, TQ3Uns32 *bytesWritten)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Storage::IsOfMyClass ( storage ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(bytesWritten), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3Trace_Write(storage, bytesWritten));
+}
+
+
+
+
+
@@ -47,6 +47,7 @@
 #include "E3Prefix.h"
 #include "E3Renderer.h"
 #include "E3DrawContext.h"
+#include "E3View.h"
 
 
 
@@ -753,6 +754,34 @@ Q3XView_EndFrame(TQ3ViewObject view)
 
 
 
+//=============================================================================
+//      Q3XView_RecordUpload : Quesa API entry point.
+//-----------------------------------------------------------------------------
+//		Note :	Renderers call this for every upload, so the bottleneck is
+//				not called.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3XView_RecordUpload(TQ3ViewObject view, TQ3XViewUploadType uploadType, TQ3Uns32 numBytes)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3View_IsOfMyClass ( view ), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call our implementation
+	return(E3View_RecordUpload(view, uploadType, numBytes));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3XDrawContext_ClearValidationFlags : Quesa API entry point.
 //-----------------------------------------------------------------------------
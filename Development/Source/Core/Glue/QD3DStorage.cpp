@@ -203,6 +203,98 @@ Q3Storage_SetData(TQ3StorageObject storage, TQ3Uns32 offset, TQ3Uns32 dataSize,
 
 
 
+
+//=============================================================================
+//      Q3Storage_GetSize64 : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Storage_GetSize64(TQ3StorageObject storage, uint64_t *size)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Storage::IsOfMyClass ( storage ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(size), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return ( (E3Storage*) storage )->GetSize64 ( size ) ;
+}
+
+
+
+
+//=============================================================================
+//      Q3Storage_GetData64 : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Storage_GetData64(TQ3StorageObject storage, uint64_t offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Storage::IsOfMyClass ( storage ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(data), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(sizeRead), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return ( (E3Storage*) storage )->GetData64 ( offset, dataSize, data, sizeRead ) ;
+}
+
+
+
+
+//=============================================================================
+//      Q3Storage_SetData64 : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3Storage_SetData64(TQ3StorageObject storage, uint64_t offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Storage::IsOfMyClass ( storage ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(data), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(sizeWritten), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return ( (E3Storage*) storage )->SetData64 ( offset, dataSize, data, sizeWritten ) ;
+}
+
+
+
 /*!
 	@function			Q3Storage_Open
 	@abstract			Open a storage for reading or writing of raw data.
@@ -734,6 +826,151 @@ Q3FileStreamStorage_Get(TQ3StorageObject theStorage, FILE** theStream )
 
 
 
+//=============================================================================
+//      Q3ReadAheadStorage_New : Quesa API entry point.
+//-----------------------------------------------------------------------------
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+TQ3StorageObject
+Q3ReadAheadStorage_New( TQ3StorageObject theSource, TQ3Uns32 chunkSize, TQ3Uns32 numChunks )
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Storage::IsOfMyClass ( theSource ), nullptr);
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3ReadAheadStorage_New(theSource, chunkSize, numChunks));
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      Q3ReadAheadStorage_GetSource : Quesa API entry point.
+//-----------------------------------------------------------------------------
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+TQ3Status
+Q3ReadAheadStorage_GetSource( TQ3StorageObject theStorage, TQ3StorageObject* theSource )
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Storage::IsOfMyClass ( theStorage ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_GetLeafType(theStorage) == kQ3StorageTypeReadAhead, kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(theSource), kQ3Failure);
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3ReadAheadStorage_GetSource(theStorage, theSource));
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      Q3ReadAheadStorage_Hint : Quesa API entry point.
+//-----------------------------------------------------------------------------
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+TQ3Status
+Q3ReadAheadStorage_Hint( TQ3StorageObject theStorage, uint64_t offset, TQ3Uns32 dataSize )
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Storage::IsOfMyClass ( theStorage ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_GetLeafType(theStorage) == kQ3StorageTypeReadAhead, kQ3Failure);
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3ReadAheadStorage_Hint(theStorage, offset, dataSize));
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      Q3CompressedStorage_New : Quesa API entry point.
+//-----------------------------------------------------------------------------
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+TQ3StorageObject
+Q3CompressedStorage_New( TQ3StorageObject theSource, TQ3Uns32 blockSize )
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Storage::IsOfMyClass ( theSource ), nullptr);
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3CompressedStorage_New(theSource, blockSize));
+}
+#endif
+
+
+
+
+
+//=============================================================================
+//      Q3CompressedStorage_GetSource : Quesa API entry point.
+//-----------------------------------------------------------------------------
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+TQ3Status
+Q3CompressedStorage_GetSource( TQ3StorageObject theStorage, TQ3StorageObject* theSource )
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3Storage::IsOfMyClass ( theStorage ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3Object_GetLeafType(theStorage) == kQ3StorageTypeCompressed, kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(theSource), kQ3Failure);
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3CompressedStorage_GetSource(theStorage, theSource));
+}
+#endif
+
+
+
+
+
 
 
 
@@ -1012,6 +1012,98 @@ Q3View_AllowAllGroupCulling(TQ3ViewObject view, TQ3Boolean allowCulling)
 
 
 
+//=============================================================================
+//      Q3View_SetFrameStatisticsState : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3View_SetFrameStatisticsState(TQ3ViewObject view, TQ3Boolean isEnabled)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3View_IsOfMyClass ( view ), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3View_SetFrameStatisticsState(view, isEnabled));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3View_GetFrameStatistics : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3View_GetFrameStatistics(TQ3ViewObject view, TQ3ViewFrameStatistics *statistics)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3View_IsOfMyClass ( view ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(statistics), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3View_GetFrameStatistics(view, statistics));
+}
+
+
+
+
+
+//=============================================================================
+//      Q3View_GetFrameTypeStatistics : Quesa API entry point.
+//-----------------------------------------------------------------------------
+TQ3Status
+Q3View_GetFrameTypeStatistics(TQ3ViewObject view, TQ3Uns32 maxTypes, TQ3Uns32 *numTypes, TQ3ViewTypeStatistics *typeStatistics)
+{
+
+
+	// Release build checks
+	Q3_REQUIRE_OR_RESULT( E3View_IsOfMyClass ( view ), kQ3Failure);
+	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(numTypes), kQ3Failure);
+
+
+
+	// Debug build checks
+
+
+
+	// Call the bottleneck
+	E3System_Bottleneck();
+
+
+
+	// Call our implementation
+	return(E3View_GetFrameTypeStatistics(view, maxTypes, numTypes, typeStatistics));
+}
+
+
+
+
+
 //=============================================================================
 //      Q3View_TransformLocalToWorld : Quesa API entry point.
 //-----------------------------------------------------------------------------
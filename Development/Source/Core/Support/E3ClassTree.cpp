@@ -76,6 +76,10 @@
 //-----------------------------------------------------------------------------
 #define kClassHashTableSize							512
 #define kMethodHashTableSize						64
+#define kInstancePoolBlockSize						(16 * 1024)
+#define kInstancePoolMinBlockLength					16
+#define kInstancePoolTrimBlocks						2
+#define kHotMethodNone								kQ3HotMethodCount
 
 static TQ3Uns8	sDummyPlaceholder;
 
@@ -85,6 +89,44 @@ static void* const	sMissingMethodPlaceholder	= (void*) &sDummyPlaceholder;
 // method in the method table.
 
 
+// Method types held in the fixed table of each class, in table order. These are
+// the methods looked up by type on every submit, rather than cached in fields.
+static const TQ3XMethodType sHotMethodTypes[kQ3HotMethodCount] = {
+	kQ3XMethodTypeViewSubmitRetainedRender,
+	kQ3XMethodTypeViewSubmitImmediateRender,
+	kQ3XMethodTypeViewSubmitRetainedPick,
+	kQ3XMethodTypeViewSubmitImmediatePick,
+	kQ3XMethodTypeViewSubmitRetainedBound,
+	kQ3XMethodTypeViewSubmitImmediateBound,
+	kQ3XMethodTypeViewSubmitRetainedWrite,
+	kQ3XMethodTypeViewSubmitImmediateWrite,
+	kQ3XMethodTypeGeomUsesSubdivision,
+	kQ3XMethodTypeGeomUsesOrientation,
+	kQ3XMethodTypeRendererMethodsCached,
+	kQ3XMethodTypeRendererStartFrame,
+	kQ3XMethodTypeRendererStartPass,
+	kQ3XMethodTypeRendererEndPass,
+	kQ3XMethodTypeRendererEndFrame,
+	kQ3XMethodTypeRendererFlushFrame,
+	kQ3XMethodTypeRendererIsBoundingBoxVisible,
+	kQ3XMethodTypeRendererUpdateMatrixLocalToWorld,
+	kQ3XMethodTypeRendererUpdateMatrixLocalToWorldInverse,
+	kQ3XMethodTypeRendererUpdateMatrixLocalToWorldInverseTranspose,
+	kQ3XMethodTypeRendererUpdateMatrixLocalToCamera,
+	kQ3XMethodTypeRendererUpdateMatrixLocalToFrustum,
+	kQ3XMethodTypeRendererUpdateMatrixWorldToCamera,
+	kQ3XMethodTypeRendererUpdateMatrixWorldToFrustum,
+	kQ3XMethodTypeRendererUpdateMatrixCameraToFrustum,
+	kQ3XMethodTypeAttributeInherit,
+	kQ3XMethodTypeAttributeCopyInherit,
+	kQ3XMethodTypeObjectTraverse,
+	kQ3XMethodTypeObjectWrite,
+	kQ3XMethodTypeObjectReadData,
+	kQ3XMethodTypeStorageReadData,
+	kQ3XMethodTypeStorageWriteData
+};
+
+
 
 
 //=============================================================================
@@ -139,6 +181,74 @@ OpaqueTQ3Object::Verify ()
 
 
 
+//=============================================================================
+//      e3class_hot_method_index : Index of a method type in the fixed table.
+//-----------------------------------------------------------------------------
+//		Note :	Returns kHotMethodNone if the method type is not in the table.
+//				Must agree with the order of sHotMethodTypes.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3class_hot_method_index ( TQ3XMethodType methodType )
+	{
+	switch ( methodType )
+		{
+		case kQ3XMethodTypeViewSubmitRetainedRender:						return 0 ;
+		case kQ3XMethodTypeViewSubmitImmediateRender:						return 1 ;
+		case kQ3XMethodTypeViewSubmitRetainedPick:							return 2 ;
+		case kQ3XMethodTypeViewSubmitImmediatePick:							return 3 ;
+		case kQ3XMethodTypeViewSubmitRetainedBound:							return 4 ;
+		case kQ3XMethodTypeViewSubmitImmediateBound:						return 5 ;
+		case kQ3XMethodTypeViewSubmitRetainedWrite:							return 6 ;
+		case kQ3XMethodTypeViewSubmitImmediateWrite:						return 7 ;
+		case kQ3XMethodTypeGeomUsesSubdivision:								return 8 ;
+		case kQ3XMethodTypeGeomUsesOrientation:								return 9 ;
+		case kQ3XMethodTypeRendererMethodsCached:							return 10 ;
+		case kQ3XMethodTypeRendererStartFrame:								return 11 ;
+		case kQ3XMethodTypeRendererStartPass:								return 12 ;
+		case kQ3XMethodTypeRendererEndPass:									return 13 ;
+		case kQ3XMethodTypeRendererEndFrame:								return 14 ;
+		case kQ3XMethodTypeRendererFlushFrame:								return 15 ;
+		case kQ3XMethodTypeRendererIsBoundingBoxVisible:					return 16 ;
+		case kQ3XMethodTypeRendererUpdateMatrixLocalToWorld:				return 17 ;
+		case kQ3XMethodTypeRendererUpdateMatrixLocalToWorldInverse:			return 18 ;
+		case kQ3XMethodTypeRendererUpdateMatrixLocalToWorldInverseTranspose:	return 19 ;
+		case kQ3XMethodTypeRendererUpdateMatrixLocalToCamera:				return 20 ;
+		case kQ3XMethodTypeRendererUpdateMatrixLocalToFrustum:				return 21 ;
+		case kQ3XMethodTypeRendererUpdateMatrixWorldToCamera:				return 22 ;
+		case kQ3XMethodTypeRendererUpdateMatrixWorldToFrustum:				return 23 ;
+		case kQ3XMethodTypeRendererUpdateMatrixCameraToFrustum:				return 24 ;
+		case kQ3XMethodTypeAttributeInherit:								return 25 ;
+		case kQ3XMethodTypeAttributeCopyInherit:							return 26 ;
+		case kQ3XMethodTypeObjectTraverse:									return 27 ;
+		case kQ3XMethodTypeObjectWrite:										return 28 ;
+		case kQ3XMethodTypeObjectReadData:									return 29 ;
+		case kQ3XMethodTypeStorageReadData:									return 30 ;
+		case kQ3XMethodTypeStorageWriteData:								return 31 ;
+		}
+
+	return kHotMethodNone ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3class_pool_block_length : Number of items per instance pool block.
+//-----------------------------------------------------------------------------
+//		Note :	Blocks are roughly kInstancePoolBlockSize bytes, so that large
+//				instances don't make a single block excessively big.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3class_pool_block_length ( TQ3Uns32 itemSize )
+	{
+	return E3Num_Max<TQ3Uns32> ( kInstancePoolBlockSize / itemSize, kInstancePoolMinBlockLength ) ;
+	}
+
+
+
+
+
 //=============================================================================
 //      E3ClassInfo::E3ClassInfo : Constructor for class info of root class.
 //-----------------------------------------------------------------------------
@@ -152,10 +262,15 @@ E3ClassInfo::E3ClassInfo	(
 	classType = 0 ;
 	className = nullptr ;
 	methodTable = nullptr ;
+	for ( TQ3Uns32 n = 0 ; n < kQ3HotMethodCount ; ++n )
+		hotMethods [ n ] = nullptr ;
 	abstract = kQ3False ;
 	numInstances = 0 ;
 	instanceSize = 0 ;
 	deltaInstanceSize = 0;
+	deltaInstanceOffset = 0;
+	instancePool = nullptr ;
+	instancePoolItemSize = 0 ;
 	numChildren = 0 ;
 	theChildren = nullptr ;
 	for ( TQ3Int32 i = kQ3MaxBuiltInClassHierarchyDepth - 1 ; i >= 0 ; --i )
@@ -327,6 +442,28 @@ E3ClassInfo::Find_Method ( TQ3XMethodType methodType, TQ3Boolean canInherit )
 
 
 
+//=============================================================================
+//      E3ClassInfo::FillHotMethods : Resolve the methods of the fixed table.
+//-----------------------------------------------------------------------------
+//		Note :	Called when the class is registered. Methods which are missing
+//				stay nullptr, so unlike the hash table the fixed table never
+//				needs to call the metahandler again.
+//-----------------------------------------------------------------------------
+void
+E3ClassInfo::FillHotMethods ( void )
+	{
+	for ( TQ3Uns32 n = 0 ; n < kQ3HotMethodCount ; ++n )
+		{
+		Q3_ASSERT ( e3class_hot_method_index ( sHotMethodTypes [ n ] ) == n ) ;
+
+		hotMethods [ n ] = Find_Method ( sHotMethodTypes [ n ], kQ3True ) ;
+		}
+	}
+
+
+
+
+
 //=============================================================================
 //      e3class_dump_class : Dump some stats on a class.
 //-----------------------------------------------------------------------------
@@ -435,6 +572,20 @@ E3ClassTree::Destroy ( void )
 		E3HashTable_Destroy(&theGlobals->classTree);
 		theGlobals->classTreeRoot = nullptr;
 		}
+
+
+
+	// Release the instance pools
+	for (TQ3Uns32 n = 0; n < kQ3InstancePoolCount; ++n)
+		{
+		E3InstancePool* thePool = &theGlobals->classInstancePools[n];
+
+		E3Pool_Destroy(&thePool->thePool);
+		E3Pool_Create(&thePool->thePool);
+		thePool->numBlocks     = 0;
+		thePool->numAllocated  = 0;
+		thePool->trimFreeItems = 0;
+		}
 	}
 
 
@@ -568,8 +719,18 @@ E3ClassTree::RegisterClass (	TQ3ObjectType		parentClassType,
 	newClass->deltaInstanceSize = deltaInstanceSize;
 	newClass->deltaInstanceOffset = deltaInstanceOffset;
 	
+	TQ3Uns32 poolItemSize = totalInstanceSize + (TQ3Uns32) sizeof( TQ3ObjectType ) ;
+	poolItemSize = (poolItemSize + kQ3InstancePoolGranularity - 1) & ~(TQ3Uns32)(kQ3InstancePoolGranularity - 1) ;
+	if ( poolItemSize <= kQ3InstancePoolMaxItemSize )
+		{
+		newClass->instancePool         = &theGlobals->classInstancePools[ poolItemSize / kQ3InstancePoolGranularity - 1 ] ;
+		newClass->instancePoolItemSize = poolItemSize ;
+		}
+	
 
 	SAFE_STRCPY( newClass->className, className, nameSize );
+	
+	newClass->FillHotMethods () ;
 
 
 
@@ -788,6 +949,115 @@ OpaqueTQ3Object::InitialiseInstanceData (	E3ClassInfoPtr	inClass,
 
 
 
+//=============================================================================
+//      E3ClassInfo::AllocateInstance : Allocate the memory for an instance.
+//-----------------------------------------------------------------------------
+//		Note :	Returns a cleared object of this class, with its tag and
+//				trailer set, but without any instance data initialised.
+//
+//				Instances which fit are taken from the slab pool for their
+//				size, which is far cheaper than a trip through malloc and
+//				keeps the many small objects of a scene packed together.
+//-----------------------------------------------------------------------------
+TQ3Object
+E3ClassInfo::AllocateInstance ( void )
+	{
+	TQ3Object theObject ;
+
+
+
+	// Allocate the object
+	if ( instancePool != nullptr )
+		{
+		TQ3Boolean needsBlock = (TQ3Boolean) ! E3Pool_HasFreeItems ( &instancePool->thePool ) ;
+		theObject = (TQ3Object) E3Pool_AllocateTagged ( &instancePool->thePool,
+														kQ3InstancePoolGranularity,
+														instancePoolItemSize,
+														e3class_pool_block_length ( instancePoolItemSize ),
+														nullptr ) ;
+		if ( theObject == nullptr )
+			return nullptr ;
+
+		if ( needsBlock )
+			instancePool->numBlocks++ ;
+
+		instancePool->numAllocated++ ;
+		Q3Memory_Clear ( theObject, instancePoolItemSize ) ;
+		}
+	else
+		{
+		theObject = (TQ3Object) Q3Memory_AllocateClear ( instanceSize + (TQ3Uns32)sizeof( TQ3ObjectType ) ) ;
+		if ( theObject == nullptr )
+			return nullptr ;
+		}
+
+
+
+	// Initialise the object and its trailer
+	theObject->quesaTag = kQ3ObjectTypeQuesa ;
+	theObject->theClass = this ;
+	
+	TQ3ObjectType* instanceTrailer = (TQ3ObjectType *)(void*) (((TQ3Uns8 *) theObject) + instanceSize ) ;
+	*instanceTrailer = kQ3ObjectTypeQuesa ;
+
+	return theObject ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassInfo::FreeInstance : Release the memory for an instance.
+//-----------------------------------------------------------------------------
+//		Note :	Once a pool has too many free items, its empty blocks are
+//				returned to the system. The next trim waits for as many frees
+//				as there were free items left, or as there are instances left
+//				if that is fewer, so that a pool whose free items are scattered
+//				over partly used blocks isn't rescanned on every free, but one
+//				which is emptied completely is always trimmed.
+//
+//				The pools are shared by every thread without any caching,
+//				since Quesa objects may only be created and disposed by one
+//				thread at a time: reference counts, the class tree and the
+//				error manager are not guarded by any lock.
+//-----------------------------------------------------------------------------
+void
+E3ClassInfo::FreeInstance ( TQ3Object theObject )
+	{
+	if ( instancePool != nullptr )
+		{
+		Q3_ASSERT ( instancePool->numAllocated > 0 ) ;
+		instancePool->numAllocated-- ;
+
+		TE3PoolItem* theItem = (TE3PoolItem*) (void*) theObject ;
+		E3Pool_Free ( &instancePool->thePool, &theItem ) ;
+
+
+
+		// Release any empty blocks
+		TQ3Uns32 blockLength = e3class_pool_block_length ( instancePoolItemSize ) ;
+		TQ3Uns32 numFree     = instancePool->numBlocks * blockLength - instancePool->numAllocated ;
+		
+		if ( numFree >= E3Num_Max<TQ3Uns32> ( instancePool->trimFreeItems, kInstancePoolTrimBlocks * blockLength ) )
+			{
+			instancePool->numBlocks -= E3Pool_ReleaseEmptyBlocks ( &instancePool->thePool,
+																	kQ3InstancePoolGranularity,
+																	instancePoolItemSize,
+																	blockLength ) ;
+
+			numFree = instancePool->numBlocks * blockLength - instancePool->numAllocated ;
+			instancePool->trimFreeItems = numFree + E3Num_Min ( numFree, instancePool->numAllocated ) ;
+			}
+		}
+	else
+		Q3Memory_Free ( &theObject ) ;
+	}
+
+
+
+
+
 //=============================================================================
 //      E3ClassTree_CreateInstance : Create an instance of a class.
 //-----------------------------------------------------------------------------
@@ -839,22 +1109,15 @@ E3ClassInfo::CreateInstance (	TQ3Boolean		sharedParams,
 		return nullptr ; // Cannot create an object of an abstract class, the required methods are missing (pure virtual)
 		
 	// Allocate and initialise the object
-	TQ3Object theObject = (TQ3Object) Q3Memory_AllocateClear ( instanceSize + (TQ3Uns32)sizeof( TQ3ObjectType ) ) ;
+	TQ3Object theObject = AllocateInstance () ;
 	if ( theObject == nullptr )
 		return nullptr ;
 
-	theObject->quesaTag = kQ3ObjectTypeQuesa ;
-	theObject->theClass = this ;
-	
-	// Initialise the trailer
-	TQ3ObjectType* instanceTrailer = (TQ3ObjectType *)(void*) (((TQ3Uns8 *) theObject) + instanceSize ) ;
-	*instanceTrailer = kQ3ObjectTypeQuesa ;
-		
 	TQ3Status qd3dStatus = theObject->InitialiseInstanceData ( this, sharedParams, paramData ) ;
 
 	if ( qd3dStatus == kQ3Failure )
 		{
-		Q3Memory_Free ( &theObject ) ;
+		FreeInstance ( theObject ) ;
 		return nullptr ;
 		}
 		
@@ -936,8 +1199,7 @@ OpaqueTQ3Object::DestroyInstance ( void )
 
 
 	// Dispose of the object
-	TQ3Object theObject = (TQ3Object) this ;		
-	Q3Memory_Free ( & theObject ) ;
+	theClass->FreeInstance ( (TQ3Object) this ) ;
 	
 	
 	
@@ -1028,22 +1290,15 @@ OpaqueTQ3Object::DuplicateInstance ( void )
 
 
 	// Allocate and initialise the object
-	TQ3Object newObject = (TQ3Object) Q3Memory_AllocateClear ( theClass->instanceSize + (TQ3Uns32)sizeof( TQ3ObjectType ) ) ;
+	TQ3Object newObject = theClass->AllocateInstance () ;
 	if ( newObject == nullptr )
 		return nullptr ;
 
-	newObject->quesaTag = kQ3ObjectTypeQuesa ;
-	newObject->theClass = theClass;
-
-	// Initialise the trailer
-	TQ3ObjectType* instanceTrailer = (TQ3ObjectType *)(void*) (((TQ3Uns8 *) newObject) + theClass->instanceSize ) ;
-	*instanceTrailer = kQ3ObjectTypeQuesa ;
-
 
 	TQ3Status qd3dStatus = DuplicateInstanceData ( newObject , theClass ) ;
 	if ( qd3dStatus == kQ3Failure )
 		{
-		Q3Memory_Free ( &newObject ) ;
+		theClass->FreeInstance ( newObject ) ;
 		return nullptr ;
 		}
 	
@@ -1458,8 +1713,11 @@ E3ClassInfo::GetNumInstances ( void )
 //=============================================================================
 //      E3ClassTree_GetMethod : Get a method for a class.
 //-----------------------------------------------------------------------------
-//		Note :	When looking for methods, we first check the method table for
-//				the class. If this fails, we call the class metahandler.
+//		Note :	Frequently used method types are resolved when the class is
+//				registered, and are returned directly from the fixed table.
+//
+//				For other methods, we first check the method table for the
+//				class. If this fails, we call the class metahandler.
 //
 //				When calling the metahandler, we inherit methods that the class
 //				does't implement from the parent of the class.
@@ -1475,9 +1733,17 @@ E3ClassInfo::GetMethod ( TQ3XMethodType methodType )
 
 
 
+	// Frequently used methods are resolved at registration, and live in the
+	// fixed table for the class
+	TQ3Uns32 hotIndex = e3class_hot_method_index ( methodType ) ;
+	if ( hotIndex != kHotMethodNone )
+		return hotMethods [ hotIndex ] ;
+
+
+
 	// Find the method
 	//
-	// We first check the hash table for the class. If this fails, we invoke the
+	// Otherwise we check the hash table for the class. If this fails, we invoke the
 	// metahandler for the class to obtain the method and store it away in the
 	// hash table for future use.
 	//
@@ -1541,6 +1807,16 @@ E3ClassInfo::AddMethod ( TQ3XMethodType methodType, TQ3XFunctionPointer theMetho
 
 
 
+	// Replace the method in the fixed table, if it lives there
+	TQ3Uns32 hotIndex = e3class_hot_method_index ( methodType ) ;
+	if ( hotIndex != kHotMethodNone )
+	{
+		hotMethods [ hotIndex ] = theMethod ;
+		return;
+	}
+
+
+
 	// Add the method to the hash table for the class
 	if (theMethod == nullptr)
 	{
@@ -1622,6 +1898,21 @@ E3ClassTree::Dump ( void )
 
 
 
+	// Print the occupancy of the instance pools
+	for (TQ3Uns32 n = 0; n < kQ3InstancePoolCount; ++n)
+		{
+		const E3InstancePool* thePool = &theGlobals->classInstancePools[n];
+		TQ3Uns32 itemSize = (n + 1) * kQ3InstancePoolGranularity;
+
+		if (thePool->numBlocks != 0)
+			fprintf(theFile, "instance pool %4lu bytes, %lu of %lu items used\n",
+						(unsigned long) itemSize,
+						(unsigned long) thePool->numAllocated,
+						(unsigned long) (thePool->numBlocks * e3class_pool_block_length(itemSize)));
+		}
+
+
+
 	// Dump the class tree, starting at the root
 	theGlobals->classTreeRoot->Dump_Class ( theFile, 1 ) ;
 
@@ -1630,3 +1921,40 @@ E3ClassTree::Dump ( void )
 	// Clean up
 	fclose(theFile);
 	}
+
+
+
+
+
+//=============================================================================
+//      E3ClassTree::GetPoolStatistics : Get the occupancy of the instance pools.
+//-----------------------------------------------------------------------------
+//		Note :	Returns the number of instances allocated from the pools, the
+//				number of items the pool blocks can hold, and the total size
+//				of the pool blocks in bytes.
+//-----------------------------------------------------------------------------
+void
+E3ClassTree::GetPoolStatistics (	TQ3Uns32	*numAllocated,
+									TQ3Uns32	*numItems,
+									int64_t		*numBytes )
+	{
+	E3GlobalsPtr theGlobals = E3Globals_Get () ;
+
+
+
+	// Total up the pools
+	*numAllocated = 0 ;
+	*numItems     = 0 ;
+	*numBytes     = 0 ;
+
+	for (TQ3Uns32 n = 0; n < kQ3InstancePoolCount; ++n)
+		{
+		const E3InstancePool* thePool = &theGlobals->classInstancePools[n];
+		TQ3Uns32 itemSize    = (n + 1) * kQ3InstancePoolGranularity;
+		TQ3Uns32 blockLength = e3class_pool_block_length(itemSize);
+
+		*numAllocated += thePool->numAllocated;
+		*numItems     += thePool->numBlocks * blockLength;
+		*numBytes     += (int64_t) thePool->numBlocks * (kQ3InstancePoolGranularity + itemSize * blockLength);
+		}
+	}
@@ -49,6 +49,7 @@
 
 
 #include "E3HashTable.h"
+#include "E3Pool.h"
 
 
 //=============================================================================
@@ -73,6 +74,24 @@ enum
 	} ;
 
 
+// Instances of up to kQ3InstancePoolMaxItemSize bytes (including the trailer)
+// are allocated from slab pools, in size steps of kQ3InstancePoolGranularity.
+enum
+	{
+	kQ3InstancePoolGranularity = 16,
+	kQ3InstancePoolMaxItemSize = 512,
+	kQ3InstancePoolCount = kQ3InstancePoolMaxItemSize / kQ3InstancePoolGranularity
+	} ;
+
+
+// Number of frequently used method types which are held in a fixed table in
+// each class, rather than in the class's method hash table.
+enum
+	{
+	kQ3HotMethodCount = 32
+	} ;
+
+
 
 //=============================================================================
 //      Types
@@ -85,6 +104,16 @@ class OpaqueTQ3Object ;
 typedef class E3ClassInfo *E3ClassInfoPtr ;
 
 
+// A slab pool of equally sized instances, shared by all classes of that size.
+// Empty blocks are released once the free items reach trimFreeItems.
+typedef struct E3InstancePool {
+	TE3Pool				thePool ;
+	TQ3Uns32			numBlocks ;
+	TQ3Uns32			numAllocated ;
+	TQ3Uns32			trimFreeItems ;
+} E3InstancePool, *E3InstancePoolPtr ;
+
+
 typedef Q3_CALLBACK_API_C ( E3ClassInfo*, TQ3XObjectRegisterMethod ) (	TQ3XMetaHandler	newClassMetaHandler,
 																		E3ClassInfo*	newParent ) ;
 
@@ -97,6 +126,7 @@ class E3ClassInfo
 	char				*className ;
 	TQ3XMetaHandler		classMetaHandler ;
 	E3HashTablePtr		methodTable ;
+	TQ3XFunctionPointer	hotMethods [ kQ3HotMethodCount ] ;
 	
 	TQ3Boolean			abstract ;	// If set, class is 'abstract' in the C++ sense, in that no instances of the class can be created
 									// It gets set because the class has necessary methods missing (= 0 or pure virtual in C++ parlance)
@@ -115,6 +145,10 @@ class E3ClassInfo
 	TQ3Uns32			deltaInstanceOffset;
 	// Offset in bytes from the beginning of the object to the child instance
 	// data.  This is not necessarily the same as the parent's instanceSize.
+	E3InstancePoolPtr	instancePool ;
+	TQ3Uns32			instancePoolItemSize ;
+	// Slab pool for instances of this class, or nullptr if the instances are
+	// too large and are allocated directly.
 
 
 	// Parent/children
@@ -134,6 +168,9 @@ class E3ClassInfo
 	void				Detach ( void ) ;	
 	E3ClassInfoPtr		Find ( const char *className ) ;
 	void				Dump_Class ( FILE *theFile, TQ3Uns32 indent ) ;
+	void				FillHotMethods ( void ) ;
+	TQ3Object			AllocateInstance ( void ) ;
+	void				FreeInstance ( TQ3Object theObject ) ;
 						E3ClassInfo ( void ) ; // Not used. Private so nobody can forget to call the normal constructor
 public :
 
@@ -207,6 +244,12 @@ public :
 	static void				Dump ( void ) ;
 
 
+	// Retrieve the occupancy of the instance pools
+	static void				GetPoolStatistics (	TQ3Uns32	*numAllocated,
+												TQ3Uns32	*numItems,
+												int64_t		*numBytes ) ;
+
+
 	
 	friend class E3ClassInfo ;
 	} ;
@@ -0,0 +1,348 @@
+/*  NAME:
+        E3Compress.cpp
+
+    DESCRIPTION:
+        Block compression in the LZ4 block format.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2021, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+#include "E3Compress.h"
+
+#include <vector>
+#include <string.h>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Format limits, from the LZ4 block format description
+const TQ3Uns32 kE3CompressMinMatch							= 4;
+const TQ3Uns32 kE3CompressLastLiterals						= 5;
+const TQ3Uns32 kE3CompressMatchFindLimit					= 12;
+const TQ3Uns32 kE3CompressMaxOffset							= 65535;
+const TQ3Uns32 kE3CompressRunMask							= 15;
+
+
+// Match finder
+const TQ3Uns32 kE3CompressHashBits							= 12;
+const TQ3Uns32 kE3CompressHashSize							= 1 << kE3CompressHashBits;
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      e3compress_read32 : Read 4 unaligned bytes.
+//-----------------------------------------------------------------------------
+static inline TQ3Uns32
+e3compress_read32( const TQ3Uns8 *src )
+{
+	return( (TQ3Uns32) src[0]         | ((TQ3Uns32) src[1] << 8) |
+		   ((TQ3Uns32) src[2] << 16) | ((TQ3Uns32) src[3] << 24) );
+}
+
+
+
+
+
+//=============================================================================
+//      e3compress_hash : Hash 4 bytes for the match finder.
+//-----------------------------------------------------------------------------
+static inline TQ3Uns32
+e3compress_hash( const TQ3Uns8 *src )
+{
+	return( (e3compress_read32( src ) * 2654435761U) >> (32 - kE3CompressHashBits) );
+}
+
+
+
+
+
+//=============================================================================
+//      e3compress_write_length : Write the extra bytes of a length.
+//-----------------------------------------------------------------------------
+//		Note :	Lengths of 15 or more spill into a run of 255s and a final
+//				byte, after the 4 bits in the token.
+//-----------------------------------------------------------------------------
+static inline TQ3Uns8 *
+e3compress_write_length( TQ3Uns8 *dst, TQ3Uns32 theLength )
+{
+	theLength -= kE3CompressRunMask;
+
+	while (theLength >= 255)
+	{
+		*dst++     = 255;
+		theLength -= 255;
+	}
+
+	*dst++ = (TQ3Uns8) theLength;
+	return(dst);
+}
+
+
+
+
+
+//=============================================================================
+//      e3compress_write_sequence : Write a sequence of literals and a match.
+//-----------------------------------------------------------------------------
+//		Note :	A match length of 0 writes the final literals of the block,
+//				which have no match after them.
+//-----------------------------------------------------------------------------
+static TQ3Uns8 *
+e3compress_write_sequence( TQ3Uns8 *dst, const TQ3Uns8 *literals, TQ3Uns32 numLiterals,
+							TQ3Uns32 matchOffset, TQ3Uns32 matchLength )
+{	TQ3Uns8		*theToken = dst++;
+	TQ3Uns32	matchCode = (matchLength == 0) ? 0 : matchLength - kE3CompressMinMatch;
+
+
+
+	// Write the token and the literals
+	*theToken = (TQ3Uns8) (E3Num_Min( numLiterals, kE3CompressRunMask ) << 4);
+	if (numLiterals >= kE3CompressRunMask)
+		dst = e3compress_write_length( dst, numLiterals );
+
+	memcpy( dst, literals, numLiterals );
+	dst += numLiterals;
+
+	if (matchLength == 0)
+		return(dst);
+
+
+
+	// Write the match
+	*dst++ = (TQ3Uns8) (matchOffset & 0xFF);
+	*dst++ = (TQ3Uns8) (matchOffset >> 8);
+
+	*theToken |= (TQ3Uns8) E3Num_Min( matchCode, kE3CompressRunMask );
+	if (matchCode >= kE3CompressRunMask)
+		dst = e3compress_write_length( dst, matchCode );
+
+	return(dst);
+}
+
+
+
+
+
+//=============================================================================
+//      e3compress_read_length : Read the extra bytes of a length.
+//-----------------------------------------------------------------------------
+static inline TQ3Status
+e3compress_read_length( const TQ3Uns8 *&src, const TQ3Uns8 *srcEnd, TQ3Uns32 &theLength )
+{	TQ3Uns8		theByte;
+
+
+
+	do
+	{
+		if (src == srcEnd)
+			return(kQ3Failure);
+
+		theByte    = *src++;
+		theLength += theByte;
+	}
+	while (theByte == 255);
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3Compress_Bound : Get the largest compressed size of a block.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3Compress_Bound( TQ3Uns32 srcSize )
+{
+	return( srcSize + (srcSize / 255) + 16 );
+}
+
+
+
+
+
+//=============================================================================
+//      E3Compress_Block : Compress a block.
+//-----------------------------------------------------------------------------
+//		Note :	Returns the compressed size, or 0 if dstCapacity is less than
+//				E3Compress_Bound(srcSize). Safe to call from any thread.
+//
+//				This is a greedy single-probe match finder, which trades some
+//				ratio for speed. The output is a plain LZ4 block, so any LZ4
+//				decoder can expand it.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3Compress_Block( const TQ3Uns8 *src, TQ3Uns32 srcSize, TQ3Uns8 *dst, TQ3Uns32 dstCapacity )
+{	std::vector<TQ3Uns32>	hashTable( kE3CompressHashSize, 0 );
+	TQ3Uns32				thePos, theAnchor, theCandidate, matchLength, hashValue;
+	TQ3Uns8					*dstPos = dst;
+
+
+
+	// Validate our parameters
+	if (dstCapacity < E3Compress_Bound( srcSize ))
+		return(0);
+
+
+
+	// Find matches, leaving the end of the block as literals
+	thePos    = 0;
+	theAnchor = 0;
+
+	if (srcSize > kE3CompressMatchFindLimit)
+	{
+		TQ3Uns32	matchFindLimit = srcSize - kE3CompressMatchFindLimit;
+		TQ3Uns32	matchEndLimit  = srcSize - kE3CompressLastLiterals;
+
+		while (thePos < matchFindLimit)
+		{
+			hashValue            = e3compress_hash( src + thePos );
+			theCandidate         = hashTable[hashValue];
+			hashTable[hashValue] = thePos;
+
+			if (theCandidate >= thePos || thePos - theCandidate > kE3CompressMaxOffset ||
+				e3compress_read32( src + theCandidate ) != e3compress_read32( src + thePos ))
+			{
+				thePos++;
+				continue;
+			}
+
+
+			// Extend the match, and write the sequence
+			matchLength = kE3CompressMinMatch;
+			while (thePos + matchLength < matchEndLimit &&
+				   src[theCandidate + matchLength] == src[thePos + matchLength])
+				matchLength++;
+
+			dstPos = e3compress_write_sequence( dstPos, src + theAnchor, thePos - theAnchor,
+												thePos - theCandidate, matchLength );
+
+			thePos   += matchLength;
+			theAnchor = thePos;
+		}
+	}
+
+
+
+	// Write the final literals
+	dstPos = e3compress_write_sequence( dstPos, src + theAnchor, srcSize - theAnchor, 0, 0 );
+
+	return( (TQ3Uns32) (dstPos - dst) );
+}
+
+
+
+
+
+//=============================================================================
+//      E3Compress_Expand : Expand a compressed block.
+//-----------------------------------------------------------------------------
+//		Note :	Fails unless the block expands to exactly dstSize bytes. Every
+//				length and offset is checked, so corrupt data can't read or
+//				write outside the buffers. Safe to call from any thread.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Compress_Expand( const TQ3Uns8 *src, TQ3Uns32 srcSize, TQ3Uns8 *dst, TQ3Uns32 dstSize )
+{	const TQ3Uns8		*srcEnd = src + srcSize;
+	TQ3Uns8				*dstPos = dst;
+	TQ3Uns8				*dstEnd = dst + dstSize;
+	TQ3Uns32			theToken, numLiterals, matchOffset, matchLength;
+
+
+
+	while (src < srcEnd)
+	{
+		// Copy the literals
+		theToken    = *src++;
+		numLiterals = theToken >> 4;
+
+		if (numLiterals == kE3CompressRunMask &&
+			e3compress_read_length( src, srcEnd, numLiterals ) != kQ3Success)
+			return(kQ3Failure);
+
+		if (numLiterals > (TQ3Uns32) (srcEnd - src) || numLiterals > (TQ3Uns32) (dstEnd - dstPos))
+			return(kQ3Failure);
+
+		memcpy( dstPos, src, numLiterals );
+		src    += numLiterals;
+		dstPos += numLiterals;
+
+
+		// The last sequence has no match
+		if (src == srcEnd)
+			break;
+
+
+		// Copy the match, a byte at a time since it may overlap itself
+		if (srcEnd - src < 2)
+			return(kQ3Failure);
+
+		matchOffset = (TQ3Uns32) src[0] | ((TQ3Uns32) src[1] << 8);
+		src        += 2;
+
+		matchLength = theToken & kE3CompressRunMask;
+		if (matchLength == kE3CompressRunMask &&
+			e3compress_read_length( src, srcEnd, matchLength ) != kQ3Success)
+			return(kQ3Failure);
+
+		matchLength += kE3CompressMinMatch;
+
+		if (matchOffset == 0 || matchOffset > (TQ3Uns32) (dstPos - dst) ||
+			matchLength > (TQ3Uns32) (dstEnd - dstPos))
+			return(kQ3Failure);
+
+		const TQ3Uns8	*matchPos = dstPos - matchOffset;
+		while (matchLength-- != 0)
+			*dstPos++ = *matchPos++;
+	}
+
+	return( (dstPos == dstEnd) ? kQ3Success : kQ3Failure );
+}
@@ -63,6 +63,7 @@ E3Globals gE3Globals = {
 	nullptr,				// classTree
 	nullptr,				// classTreeRoot
 	0,						// classNextType
+	{ },					// classInstancePools
 	0,						// sharedLibraryCount
 	nullptr,				// sharedLibraryInfo
 	kQ3False,				// errMgrClearError
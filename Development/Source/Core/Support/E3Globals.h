@@ -180,6 +180,7 @@ extern "C" {
 #define kQ3ClassNamePickWindowPoint					"WindowPointPick"
 #define kQ3ClassNamePickWindowRect					"WindowRectPick"
 #define kQ3ClassNamePickWorldRay					"WorldRayPick"
+#define kQ3ClassNamePickWorldRayBatch				"WorldRayBatchPick"
 #define kQ3ClassNameRenderer						"Renderer"
 #define kQ3ClassNameRendererGeneric					"GenericRenderer"
 #define kQ3ClassNameRendererInteractive				"InteractiveRenderer"
@@ -244,6 +245,9 @@ extern "C" {
 #define kQ3ClassNameStorageWin32					"Win32Storage"
 #define kQ3ClassNameAttributeSetList				"AttributeSetList"
 #define kQ3ClassNameAttributeArray					"AttributeArray"
+#define kQ3ClassNamePackedAttributeArray			"Quesa:PackedAttributeArray"
+#define kQ3ClassNamePackedTriMesh					"Quesa:PackedTriMesh"
+#define kQ3ClassNameLazyGeometry					"Quesa:LazyGeometry"
 #define kQ3ClassNameAttributeSetListGeometry		"GeometryAttributeSetList"
 #define kQ3ClassNameAttributeSetListFace			"FaceAttributeSetList"
 #define kQ3ClassNameAttributeSetListVertex			"VertexAttributeSetList"
@@ -258,6 +262,8 @@ extern "C" {
 #define kQ3ClassNameShaderUVTransform				"ShaderUVTransform"
 #define kQ3ClassNameStoragePath						"Quesa:Storage:Path"
 #define kQ3ClassNameStorageStream					"Quesa:Storage:Stream"
+#define kQ3ClassNameStorageReadAhead				"Quesa:Storage:ReadAhead"
+#define kQ3ClassNameStorageCompressed				"Quesa:Storage:Compressed"
 #define kQ3ClassNameStorageBe						"Quesa:Storage:Be"
 #define kQ3ClassNameDrawContextBe					"Quesa:DrawContext:Be"
 #define kQ3ClassName3DMF							"Metafile"
@@ -324,6 +330,9 @@ extern "C" {
 #define kQ3XMethodTypeStorageOpen					Q3_METHOD_TYPE('Q', 'O', 'p', 'n')
 #define kQ3XMethodTypeStorageClose					Q3_METHOD_TYPE('Q', 'C', 'l', 's')
 #define kQ3XMethodTypeStorageGetOpenness			Q3_METHOD_TYPE('Q', 's', 'g', 'o')
+#define kQ3XMethodTypeStorageReadData64				Q3_METHOD_TYPE('Q', 'r', 'e', '8')
+#define kQ3XMethodTypeStorageWriteData64			Q3_METHOD_TYPE('Q', 'w', 'r', '8')
+#define kQ3XMethodTypeStorageGetSize64				Q3_METHOD_TYPE('Q', 'G', 's', '8')
 
 
 // 3DMF object types
@@ -346,8 +355,11 @@ extern "C" {
 #define kQ3ObjectTypeDisplayGroupBBox				Q3_OBJECT_TYPE('d', 'g', 'b', 'b')
 #define kQ3ObjectTypeGeneralPolygonHint				Q3_OBJECT_TYPE('g', 'p', 'l', 'h')
 #define kQ3ObjectTypeGeometryCaps					Q3_OBJECT_TYPE('c', 'a', 'p', 's')
+#define kQ3ObjectTypeLazyGeometry					Q3_OBJECT_TYPE('Q', 'l', 'z', 'g')
 #define kQ3ObjectTypeMeshCorners					Q3_OBJECT_TYPE('c', 'r', 'n', 'r')
 #define kQ3ObjectTypeMeshEdges						Q3_OBJECT_TYPE('e', 'd', 'g', 'e')
+#define kQ3ObjectTypePackedAttributeArray			Q3_OBJECT_TYPE('Q', 'p', 'a', 'a')
+#define kQ3ObjectTypePackedTriMesh					Q3_OBJECT_TYPE('Q', 'p', 't', 'm')
 #define kQ3ObjectTypeShaderTransform				Q3_OBJECT_TYPE('s', 'd', 'x', 'f')
 #define kQ3ObjectTypeShaderUVTransform				Q3_OBJECT_TYPE('s', 'd', 'u', 'v')
 #define kQ3ObjectTypeTOC							Q3_OBJECT_TYPE('t', 'o', 'c', ' ')
@@ -417,6 +429,20 @@ typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XStorageGetOpennessMethod)(TQ3StorageObj
 																	TQ3StorageOpenness* outOpenness );
 
 
+// 64-bit storage methods, optional for classes which can't exceed 4GB
+typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XStorageReadData64Method)(TQ3StorageObject storage,
+																uint64_t		offset,
+																TQ3Uns32		dataSize,
+																TQ3Uns8			*data,
+																TQ3Uns32		*sizeRead);
+typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XStorageWriteData64Method)(TQ3StorageObject storage,
+																uint64_t		offset,
+																TQ3Uns32		dataSize,
+																const TQ3Uns8	*data,
+																TQ3Uns32		*sizeWritten);
+typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XStorageGetSize64Method)(TQ3StorageObject storage, uint64_t *size);
+
+
 // Definition of TQ3Object
 #if !QUESA_OBJECTS_ARE_OPAQUE
 
@@ -455,6 +481,7 @@ typedef struct E3Globals {
 	E3HashTablePtr			classTree;
 	E3ClassInfoPtr			classTreeRoot;
 	TQ3ObjectType			classNextType;
+	E3InstancePool			classInstancePools[kQ3InstancePoolCount];
 	
 
 	// Shared libraries
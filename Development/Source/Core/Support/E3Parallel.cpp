@@ -0,0 +1,295 @@
+/*  NAME:
+        E3Parallel.cpp
+
+    DESCRIPTION:
+        Split a loop across several threads.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2021, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+#include "E3Parallel.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <vector>
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+// The worker threads, and the loop they are working on.
+//
+// Slices are handed out under mLock, so a worker which wakes up late simply
+// finds no slices left. Only one loop runs at a time, callers which find
+// mRunLock held run their loop by themselves.
+class E3ParallelWorkers
+{
+public:
+						~E3ParallelWorkers();
+
+	void				Run( TQ3Uns32 inCount, TQ3Uns32 inNumSlices,
+							TE3ParallelSliceMethod inMethod, void *inContext );
+
+private:
+	void				StartThreads( TQ3Uns32 inNumThreads );
+	bool				RunNextSlice( std::unique_lock<std::mutex>& ioLock );
+	void				ThreadMain();
+
+	std::mutex					mRunLock;
+	std::mutex					mLock;
+	std::condition_variable		mWorkReady;
+	std::condition_variable		mLoopDone;
+	std::vector<std::thread>	mThreads;
+	bool						mStopping = false;
+
+	TE3ParallelSliceMethod		mMethod = nullptr;
+	void*						mContext = nullptr;
+	TQ3Uns32					mCount = 0;
+	TQ3Uns32					mNumSlices = 0;
+	TQ3Uns32					mNextSlice = 0;
+	TQ3Uns32					mSlicesDone = 0;
+};
+
+
+
+
+
+//=============================================================================
+//      Static variables
+//-----------------------------------------------------------------------------
+// Created when first needed, and never destroyed if Q3Exit isn't called, so
+// that no joinable thread is destroyed at static destruction time.
+static E3ParallelWorkers*	sWorkers = nullptr;
+static std::mutex			sWorkersLock;
+
+
+
+
+
+//=============================================================================
+//      E3ParallelWorkers::~E3ParallelWorkers : Stop the worker threads.
+//-----------------------------------------------------------------------------
+E3ParallelWorkers::~E3ParallelWorkers()
+{
+	{
+		std::lock_guard<std::mutex>	lock( mLock );
+		mStopping = true;
+	}
+	mWorkReady.notify_all();
+
+	for (std::thread& theThread : mThreads)
+		theThread.join();
+}
+
+
+
+
+
+//=============================================================================
+//      E3ParallelWorkers::StartThreads : Start more worker threads if needed.
+//-----------------------------------------------------------------------------
+//		Note :	If a thread can't be started we make do with those we have.
+//-----------------------------------------------------------------------------
+void
+E3ParallelWorkers::StartThreads( TQ3Uns32 inNumThreads )
+{
+	try
+		{
+		while (mThreads.size() < inNumThreads)
+			mThreads.emplace_back( &E3ParallelWorkers::ThreadMain, this );
+		}
+	catch (std::system_error&)
+		{
+		}
+	catch (std::bad_alloc&)
+		{
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      E3ParallelWorkers::RunNextSlice : Run the next slice of the loop.
+//-----------------------------------------------------------------------------
+//		Note :	Called with ioLock held, which is released while the slice
+//				runs. Returns false if there was no slice left.
+//-----------------------------------------------------------------------------
+bool
+E3ParallelWorkers::RunNextSlice( std::unique_lock<std::mutex>& ioLock )
+{
+	if (mNextSlice >= mNumSlices)
+		return false;
+
+	TQ3Uns32					n         = mNextSlice++;
+	TQ3Uns32					firstItem = (TQ3Uns32) (((uint64_t) mCount * n)       / mNumSlices);
+	TQ3Uns32					endItem   = (TQ3Uns32) (((uint64_t) mCount * (n + 1)) / mNumSlices);
+	TE3ParallelSliceMethod		theMethod = mMethod;
+	void*						theContext = mContext;
+
+	ioLock.unlock();
+	theMethod( theContext, firstItem, endItem );
+	ioLock.lock();
+
+	if (++mSlicesDone == mNumSlices)
+		mLoopDone.notify_all();
+
+	return true;
+}
+
+
+
+
+
+//=============================================================================
+//      E3ParallelWorkers::ThreadMain : Worker thread.
+//-----------------------------------------------------------------------------
+void
+E3ParallelWorkers::ThreadMain()
+{
+	std::unique_lock<std::mutex>	lock( mLock );
+
+	while (!mStopping)
+		{
+		if (!RunNextSlice( lock ))
+			mWorkReady.wait( lock );
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      E3ParallelWorkers::Run : Run a loop on the worker threads.
+//-----------------------------------------------------------------------------
+void
+E3ParallelWorkers::Run( TQ3Uns32 inCount, TQ3Uns32 inNumSlices,
+						TE3ParallelSliceMethod inMethod, void *inContext )
+{
+	std::unique_lock<std::mutex>	runLock( mRunLock, std::try_to_lock );
+
+	if (runLock.owns_lock())
+		StartThreads( inNumSlices - 1 );
+
+	if (!runLock.owns_lock() || mThreads.empty())
+		{
+		inMethod( inContext, 0, inCount );
+		return;
+		}
+
+
+
+	// Hand out the slices, and run them with the workers until all are done
+	std::unique_lock<std::mutex>	lock( mLock );
+
+	mMethod     = inMethod;
+	mContext    = inContext;
+	mCount      = inCount;
+	mNumSlices  = inNumSlices;
+	mNextSlice  = 0;
+	mSlicesDone = 0;
+	mWorkReady.notify_all();
+
+	while (RunNextSlice( lock ))
+		{
+		}
+
+	while (mSlicesDone < mNumSlices)
+		mLoopDone.wait( lock );
+
+	mNumSlices = 0;
+	mNextSlice = 0;
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3Parallel_Run : Run a loop on the worker threads.
+//-----------------------------------------------------------------------------
+void
+E3Parallel_Run( TQ3Uns32 inCount, TQ3Uns32 inNumSlices,
+				TE3ParallelSliceMethod inMethod, void *inContext )
+{
+	E3ParallelWorkers*	theWorkers;
+
+
+
+	// Create the workers if we need to
+	{
+		std::lock_guard<std::mutex>	lock( sWorkersLock );
+
+		if (sWorkers == nullptr)
+			sWorkers = new(std::nothrow) E3ParallelWorkers;
+
+		theWorkers = sWorkers;
+	}
+
+	if (theWorkers == nullptr)
+		inMethod( inContext, 0, inCount );
+	else
+		theWorkers->Run( inCount, inNumSlices, inMethod, inContext );
+}
+
+
+
+
+
+//=============================================================================
+//      E3Parallel_Terminate : Stop the worker threads.
+//-----------------------------------------------------------------------------
+void
+E3Parallel_Terminate( void )
+{
+	std::lock_guard<std::mutex>	lock( sWorkersLock );
+
+	delete sWorkers;
+	sWorkers = nullptr;
+}
@@ -0,0 +1,130 @@
+/*  NAME:
+        E3Parallel.h
+
+    DESCRIPTION:
+        Split a loop across several threads.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2021, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef E3PARALLEL_HDR
+#define E3PARALLEL_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include <thread>
+
+
+
+
+
+//=============================================================================
+//      Types
+//-----------------------------------------------------------------------------
+// Called on one slice [inFirst, inEnd) of a parallel loop
+typedef void (*TE3ParallelSliceMethod)( void *inContext, TQ3Uns32 inFirst, TQ3Uns32 inEnd );
+
+
+
+
+
+//=============================================================================
+//      Function prototypes
+//-----------------------------------------------------------------------------
+/*!
+	@function	E3Parallel_Run
+	@abstract	Call inMethod over inNumSlices contiguous slices of the range
+				[0, inCount), using the worker threads.
+	@discussion	The calling thread runs slices too, and returns once every
+				slice is done. If the workers are busy with another loop, or
+				could not be started, every slice is run on the calling thread.
+*/
+void
+E3Parallel_Run( TQ3Uns32 inCount, TQ3Uns32 inNumSlices,
+				TE3ParallelSliceMethod inMethod, void *inContext );
+
+
+
+/*!
+	@function	E3Parallel_Terminate
+	@abstract	Stop the worker threads, called by Q3Exit.
+*/
+void
+E3Parallel_Terminate( void );
+
+
+
+/*!
+	@function	E3Parallel_For
+	@abstract	Call inFunction( first, end ) over contiguous slices of the
+				range [0, inCount), one slice per thread.
+	@discussion	The range is only split if every thread gets at least
+				inMinPerThread items, otherwise inFunction is simply called
+				once on the calling thread.
+
+				Slices are run by a set of worker threads which is started the
+				first time it is needed and kept until Q3Exit, but callers
+				should still choose inMinPerThread so that a slice is well
+				worth handing to another thread. The function must only touch
+				its own slice of any output, and must not call the Quesa API,
+				since errors and the bottleneck are not thread safe.
+*/
+template <typename Function>
+void
+E3Parallel_For( TQ3Uns32 inCount, TQ3Uns32 inMinPerThread, const Function& inFunction )
+{
+	struct Slice
+		{
+		static void Run( void *inContext, TQ3Uns32 inFirst, TQ3Uns32 inEnd )
+			{
+			(*static_cast<const Function*>( inContext ))( inFirst, inEnd );
+			}
+		};
+
+	TQ3Uns32	numThreads = std::thread::hardware_concurrency();
+	TQ3Uns32	maxThreads = inCount / (inMinPerThread > 0 ? inMinPerThread : 1);
+
+	if (numThreads > maxThreads)
+		numThreads = maxThreads;
+
+	if (numThreads <= 1)
+		inFunction( 0, inCount );
+	else
+		E3Parallel_Run( inCount, numThreads, Slice::Run,
+						const_cast<Function*>( &inFunction ) );
+}
+
+#endif
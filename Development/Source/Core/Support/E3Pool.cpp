@@ -70,6 +70,9 @@
 #include "E3Prefix.h"
 #include "E3Pool.h"
 
+#include <algorithm>
+#include <vector>
+
 
 
 
@@ -247,6 +250,101 @@ E3Pool_Free(
 
 
 
+//=============================================================================
+//		E3Pool_ReleaseEmptyBlocks : Free the blocks with no allocated items.
+//-----------------------------------------------------------------------------
+//		Note :	Only for untagged pools, since a tag item is never free. The
+//				free items are counted per block, and the items of the empty
+//				blocks are unlinked from the free list before those blocks are
+//				freed. The order of the remaining free items is preserved.
+//
+//				Returns the number of blocks that were freed.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3Pool_ReleaseEmptyBlocks(
+	TE3Pool* poolPtr,
+	TQ3Uns32 itemOffset,
+	TQ3Uns32 itemSize,
+	TQ3Uns32 blockLength)
+{
+	std::vector<TE3PoolBlock*> theBlocks;
+	std::vector<TQ3Uns32> freeCounts;
+	TE3PoolBlock* blockPtr;
+	TE3PoolItem* itemPtr;
+	TE3PoolItem** linkPtr;
+	TE3PoolBlock** blockLinkPtr;
+	TQ3Uns32 blockBytes, numReleased;
+
+	// Validate our parameters
+	Q3_ASSERT_VALID_PTR(poolPtr);
+	Q3_ASSERT(itemOffset >= sizeof(TE3PoolBlock));
+	Q3_ASSERT(itemSize >= sizeof(TE3PoolItem));
+
+	// Sort the blocks by address
+	for (blockPtr = poolPtr->headBlockPtr_private; blockPtr != nullptr; blockPtr = blockPtr->nextBlockPtr_private)
+		theBlocks.push_back(blockPtr);
+
+	if (theBlocks.empty())
+		return(0);
+
+	std::sort(theBlocks.begin(), theBlocks.end());
+	freeCounts.resize(theBlocks.size(), 0);
+	blockBytes = itemOffset + itemSize*blockLength;
+
+	// Count the free items in each block
+	#define E3POOL_BLOCK_INDEX(_item)												\
+		((std::upper_bound(theBlocks.begin(), theBlocks.end(), (TE3PoolBlock*) (void*) (_item))	\
+			- theBlocks.begin()) - 1)
+
+	for (itemPtr = poolPtr->headFreeItemPtr_private; itemPtr != nullptr; itemPtr = itemPtr->nextFreeItemPtr_private)
+	{
+		ptrdiff_t n = E3POOL_BLOCK_INDEX(itemPtr);
+		Q3_ASSERT(n >= 0 && (char*) itemPtr < ((char*) theBlocks[n]) + blockBytes);
+		freeCounts[n]++;
+	}
+
+	// Unlink the free items of the empty blocks
+	numReleased = 0;
+	for (size_t n = 0; n < theBlocks.size(); n++)
+	{
+		if (freeCounts[n] == blockLength)
+			numReleased++;
+	}
+
+	if (numReleased == 0)
+		return(0);
+
+	for (linkPtr = &poolPtr->headFreeItemPtr_private; *linkPtr != nullptr; )
+	{
+		if (freeCounts[E3POOL_BLOCK_INDEX(*linkPtr)] == blockLength)
+			*linkPtr = (*linkPtr)->nextFreeItemPtr_private;
+		else
+			linkPtr = &(*linkPtr)->nextFreeItemPtr_private;
+	}
+
+	#undef E3POOL_BLOCK_INDEX
+
+	// Unlink and free the empty blocks
+	for (blockLinkPtr = &poolPtr->headBlockPtr_private; *blockLinkPtr != nullptr; )
+	{
+		blockPtr = *blockLinkPtr;
+
+		if (freeCounts[std::lower_bound(theBlocks.begin(), theBlocks.end(), blockPtr) - theBlocks.begin()] == blockLength)
+		{
+			*blockLinkPtr = blockPtr->nextBlockPtr_private;
+			Q3Memory_Free(&blockPtr);
+		}
+		else
+			blockLinkPtr = &blockPtr->nextBlockPtr_private;
+	}
+
+	return(numReleased);
+}
+
+
+
+
+
 //=============================================================================
 //		E3PoolItem_Tag : Return tag item for pool containing this item.
 //-----------------------------------------------------------------------------
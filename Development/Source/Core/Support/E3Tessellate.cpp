@@ -51,181 +51,137 @@
 #include "E3GeometryTriMeshOptimize.h"
 #include "E3GeometryTriMesh.h"
 
-#include "glu-mesa.h"
-
-
-//=============================================================================
-//      Internal types
-//-----------------------------------------------------------------------------
-
-// GLU callback
-#ifndef CALLBACK
-	#define CALLBACK
-#endif
-
-typedef GLvoid (*GLcallback)( void );
-
-
-// Tessellator state
-typedef struct E3TessellateState {
-	TQ3TriMeshData		triMeshData;
-
-	TQ3Uns32			numTriMeshVertices;
-	TQ3Vertex3D			**triMeshVertexList;
-
-	TQ3Uns32			numTempVertices;
-	TQ3Vertex3D			**tempVertexList;
-
-	GLenum				errorState;
-	TQ3Boolean			edgeState;
-
-	TQ3Uns32			vertexInTriangle;
-	TQ3Boolean			vertexEdgeState[3];
-	TQ3Uns32			vertexIndices[3];
-	
-} E3TessellateState;
-
-
-// Vertex attribute state
-typedef struct E3CombinedAttribute {
-	TQ3Uns32			attributeMask;
-	TQ3Param2D			surfaceUV;
-	TQ3Param2D			shadingUV;
-	TQ3Vector3D			normal;
-	float				ambientCoefficient;
-	TQ3ColorRGB			diffuseColour;
-	TQ3ColorRGB			specularColour;
-	float				specularControl;
-	TQ3ColorRGB			transparencyColour;
-	TQ3Tangent2D		surfaceTangent;
-} E3CombinedAttribute;
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cmath>
 
 
 
 
 
 //=============================================================================
-//      Internal functions
-//-----------------------------------------------------------------------------
-//      e3tessellate_add_vertex : Add or locate a vertex within the list.
+//      Internal constants
 //-----------------------------------------------------------------------------
-static TQ3Uns32
-e3tessellate_add_vertex(E3TessellateState *theState, TQ3Vertex3D *theVertex)
-{	TQ3Uns32		vertexIndex, theSize;
-	TQ3Status		qd3dStatus;
-
-
-
-	// Search the list for this vertex
-	for (vertexIndex = 0; vertexIndex < theState->numTriMeshVertices; vertexIndex++)
-		{
-		if (theState->triMeshVertexList[vertexIndex] == theVertex)
-			break;
-		}
-
-
-
-	// If we found it, return the index
-	if (vertexIndex < theState->numTriMeshVertices)
-		return(vertexIndex);
+// Relative tolerance for edge intersections
+#define kIntersectTolerance						1.0e-9
 
 
+// Relative distance of the nesting test point from the edge of its loop
+#define kTestPointOffset						1.0e-6
 
-	// Grow the vertex array - handle failure by punting to the first vertex
-	theSize    = static_cast<TQ3Uns32>((theState->numTriMeshVertices + 1) * sizeof(TQ3Vertex3D*));
-	qd3dStatus = Q3Memory_Reallocate(&theState->triMeshVertexList, theSize);
-	if (qd3dStatus != kQ3Success)
-		return(0);
 
+// Polygons with more points than this use a z-order index to find ears
+#define kZOrderThreshold						80
 
 
-	// Save the latest vertex
-	vertexIndex                              = theState->numTriMeshVertices;
-	theState->triMeshVertexList[vertexIndex] = theVertex;
-	theState->numTriMeshVertices++;
-	
-	return(vertexIndex);
-}
+// Size of the z-order grid
+#define kZOrderGridSize							32767.0
 
 
 
 
 
 //=============================================================================
-//      e3tessellate_add_triangle : Add a triangle to the list.
+//      Internal types
 //-----------------------------------------------------------------------------
-static TQ3Boolean
-e3tessellate_add_triangle(E3TessellateState *theState, TQ3Uns32 vertexIndices[3])
-{	TQ3TriMeshTriangleData		*theTriangle;
-	TQ3Status					qd3dStatus;
-	TQ3Uns32					theSize, n;
-
-
-
-	// Grow the triangle array
-	theSize    = static_cast<TQ3Uns32>((theState->triMeshData.numTriangles + 1) * sizeof(TQ3TriMeshTriangleData));
-	qd3dStatus = Q3Memory_Reallocate(&theState->triMeshData.triangles, theSize);
-	if (qd3dStatus != kQ3Success)
-		return(kQ3False);
-
-
-
-	// Grab the latest triangle and update the count
-	theTriangle = &theState->triMeshData.triangles[theState->triMeshData.numTriangles];
-	theState->triMeshData.numTriangles++;
-
-
-
-	// Initialise the new triangle
-	for (n = 0; n < 3; n++)
-		theTriangle->pointIndices[n] = vertexIndices[n];
-
-	return(kQ3True);
-}
+// Projected vertex
+//
+// Each vertex of the polygon is projected onto its plane, and refers to the
+// Quesa vertex which supplies its point and attributes. Vertices created at
+// edge intersections refer to a vertex in our combined list.
+typedef struct TE3TessVertex {
+	double					x;
+	double					y;
+	const TQ3Vertex3D		*theVertex;
+} TE3TessVertex;
 
 
+// Polygon edge
+typedef struct TE3TessEdge {
+	TQ3Uns32				v0;
+	TQ3Uns32				v1;
+	double					minX, maxX;
+	double					minY, maxY;
+} TE3TessEdge;
 
 
+// Point at which an edge must be split
+typedef struct TE3TessSplit {
+	TQ3Uns32				theEdge;
+	double					t;
+	TQ3Uns32				theVertex;
+} TE3TessSplit;
 
-//=============================================================================
-//      e3tessellate_add_edge : Add an edge to the list.
-//-----------------------------------------------------------------------------
-static TQ3Boolean
-e3tessellate_add_edge(E3TessellateState *theState, TQ3Uns32 vertexIndex0, TQ3Uns32 vertexIndex1)
-{	TQ3Status				qd3dStatus;
-	TQ3TriMeshEdgeData		*theEdge;
-	TQ3Uns32				theSize;
 
+// Closed loop of vertices which does not cross any other loop
+typedef struct TE3TessLoop {
+	std::vector<TQ3Uns32>	vertices;
+	double					theArea;
+	double					minX, maxX;
+	double					minY, maxY;
+	double					testX, testY;
+	TQ3Uns32				depth;
+	TQ3Int32				parent;
+} TE3TessLoop;
 
 
-	// Grow the edge array
-	theSize    = static_cast<TQ3Uns32>((theState->triMeshData.numEdges + 1) * sizeof(TQ3TriMeshEdgeData));
-	qd3dStatus = Q3Memory_Reallocate(&theState->triMeshData.edges, theSize);
-	if (qd3dStatus != kQ3Success)
-		return(kQ3False);
+// Ear clipping node
+//
+// Nodes form a doubly linked list around a polygon, plus a second list in
+// z-order for large polygons. isBoundary is set if the edge from the node
+// to the next node is part of the polygon boundary, rather than a bridge
+// to a hole or a diagonal.
+typedef struct TE3TessNode {
+	TQ3Uns32				i;
+	double					x;
+	double					y;
+	struct TE3TessNode		*prev;
+	struct TE3TessNode		*next;
+	struct TE3TessNode		*prevZ;
+	struct TE3TessNode		*nextZ;
+	TQ3Uns32				z;
+	bool					steiner;
+	bool					isBoundary;
+} TE3TessNode;
 
 
+// Tessellator state
+typedef struct E3TessellateState {
+	std::vector<TE3TessVertex>				vertices;
+	std::vector<TQ3Vertex3D*>				combinedVertices;
+	std::deque<TE3TessNode>					nodes;
+	std::vector<TQ3Uns32>					vertexUses;
 
-	// Grab the latest edge and update the count
-	theEdge = &theState->triMeshData.edges[theState->triMeshData.numEdges];
-	theState->triMeshData.numEdges++;
+	std::vector<TQ3TriMeshTriangleData>		triangles;
+	std::vector<TQ3TriMeshEdgeData>			edges;
 
+	std::vector<const TQ3Vertex3D*>			triMeshVertexList;
+	TQ3TriMeshData							triMeshData;
+} E3TessellateState;
 
 
-	// Initialise the new edge
-	theEdge->pointIndices[0]    = vertexIndex0;
-	theEdge->pointIndices[1]    = vertexIndex1;
-	theEdge->triangleIndices[0] = theState->triMeshData.numTriangles - 1;
-	theEdge->triangleIndices[1] = kQ3ArrayIndexNULL;
-	
-	return(kQ3True);
-}
+// Vertex attribute state
+typedef struct E3CombinedAttribute {
+	TQ3Uns32			attributeMask;
+	TQ3Param2D			surfaceUV;
+	TQ3Param2D			shadingUV;
+	TQ3Vector3D			normal;
+	float				ambientCoefficient;
+	TQ3ColorRGB			diffuseColour;
+	TQ3ColorRGB			specularColour;
+	float				specularControl;
+	TQ3ColorRGB			transparencyColour;
+	TQ3Tangent2D		surfaceTangent;
+} E3CombinedAttribute;
 
 
 
 
 
 //=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
 //      e3tessellate_attribute_get : Get vertex attribute data.
 //-----------------------------------------------------------------------------
 static void
@@ -449,46 +405,89 @@ e3tessellate_attribute_blend(E3CombinedAttribute *dstState, const E3CombinedAttr
 
 
 //=============================================================================
-//      e3tessellate_gather_vertex_attribute : Gather vertex attributes.
+//      e3tessellate_combine_vertex : Create a vertex at an intersection.
 //-----------------------------------------------------------------------------
-static TQ3AttributeSet
-e3tessellate_gather_vertex_attribute(const void *userData, TQ3Uns32 setIndex)
-{	const E3TessellateState		*theState = (const E3TessellateState *) userData;
+//		Note :	The new vertex is a weighted blend of the end points of the
+//				two edges which cross, and is owned by the tessellator state.
+//
+//				Hilights, surface shaders, and custom attributes can't be
+//				interpolated so we just have to skip them.
+//-----------------------------------------------------------------------------
+static const TQ3Vertex3D *
+e3tessellate_combine_vertex(E3TessellateState *theState, const TQ3Vertex3D *theVertices[4], const float theWeights[4])
+{	E3CombinedAttribute		combinedState, vertexState[4];
+	TQ3Vertex3D				*newVertex;
+	TQ3Uns32				n;
 
 
 
-	// Validate our parameters
-	Q3_REQUIRE_OR_RESULT(setIndex < theState->numTriMeshVertices, nullptr);
+	// Collect the attribute state that can be interpolated
+	Q3Memory_Clear(vertexState, sizeof(vertexState));
 
+	for (n = 0; n < 4; n++)
+		{
+		if (theVertices[n]->attributeSet != nullptr)
+			{
+			e3tessellate_attribute_get(theVertices[n], &vertexState[n], kQ3AttributeTypeSurfaceUV);
+			e3tessellate_attribute_get(theVertices[n], &vertexState[n], kQ3AttributeTypeShadingUV);
+			e3tessellate_attribute_get(theVertices[n], &vertexState[n], kQ3AttributeTypeNormal);
+			e3tessellate_attribute_get(theVertices[n], &vertexState[n], kQ3AttributeTypeAmbientCoefficient);
+			e3tessellate_attribute_get(theVertices[n], &vertexState[n], kQ3AttributeTypeDiffuseColor);
+			e3tessellate_attribute_get(theVertices[n], &vertexState[n], kQ3AttributeTypeSpecularColor);
+			e3tessellate_attribute_get(theVertices[n], &vertexState[n], kQ3AttributeTypeSpecularControl);
+			e3tessellate_attribute_get(theVertices[n], &vertexState[n], kQ3AttributeTypeTransparencyColor);
+			e3tessellate_attribute_get(theVertices[n], &vertexState[n], kQ3AttributeTypeSurfaceTangent);
+			}
+		}
 
 
-	// Return the appropriate attribute set
-	return(theState->triMeshVertexList[setIndex]->attributeSet);
-}
 
+	// Blend the four vertices together to form the combined vertex
+	//
+	// We blend by using the supplied weights, however we don't redistribute weights if
+	// an attribute isn't present. Since we blend by addition, we reply on vertexState
+	// being cleared to 0 above so that attributes which aren't present will have no
+	// effect on the output.
+	Q3Memory_Clear(&combinedState, sizeof(combinedState));
 
+	for (n = 0; n < 4; n++)
+		e3tessellate_attribute_blend(&combinedState, &vertexState[n], theWeights[n]);
 
 
 
-//=============================================================================
-//      e3tessellate_callback_begin : Begin a new triangle.
-//-----------------------------------------------------------------------------
-static void CALLBACK
-e3tessellate_callback_begin(GLenum which, void *userData)
-{	E3TessellateState		*theState = (E3TessellateState *) userData;
+	// Allocate another vertex
+	newVertex = (TQ3Vertex3D *) Q3Memory_AllocateClear(sizeof(TQ3Vertex3D));
+	if (newVertex == nullptr)
+		return(theVertices[0]);
 
+	theState->combinedVertices.push_back(newVertex);
 
 
-	// Validate our state - since we asked for edge data, we should only see triangles
-	Q3_ASSERT(which == GL_TRIANGLES);
 
+	// Set up the vertex
+	for (n = 0; n < 4; n++)
+		{
+		newVertex->point.x += theWeights[n] * theVertices[n]->point.x;
+		newVertex->point.y += theWeights[n] * theVertices[n]->point.y;
+		newVertex->point.z += theWeights[n] * theVertices[n]->point.z;
+		}
 
+	newVertex->attributeSet = (combinedState.attributeMask == 0 ? nullptr : Q3AttributeSet_New());
 
-	// Start a new triangle
-	theState->vertexInTriangle = 0;
+	if (newVertex->attributeSet != nullptr)
+		{
+		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeSurfaceUV);
+		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeShadingUV);
+		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeNormal);
+		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeAmbientCoefficient);
+		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeDiffuseColor);
+		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeSpecularColor);
+		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeSpecularControl);
+		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeTransparencyColor);
+		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeSurfaceTangent);
+		}
 
-	Q3Memory_Clear(theState->vertexEdgeState, sizeof(theState->vertexEdgeState));
-	Q3Memory_Clear(theState->vertexIndices,   sizeof(theState->vertexIndices));
+	return(newVertex);
 }
 
 
@@ -496,105 +495,228 @@ e3tessellate_callback_begin(GLenum which, void *userData)
 
 
 //=============================================================================
-//      e3tessellate_callback_end : End the current triangle.
+//      e3tessellate_project_contours : Project the contours onto their plane.
+//-----------------------------------------------------------------------------
+//		Note :	The plane normal is found with Newell's method over every
+//				contour, so that the net signed area of the polygon is positive
+//				in the projected coordinates. The triangles we produce are
+//				counter-clockwise in those coordinates, and so keep the
+//				orientation of the original polygon.
+//
+//				Coincident vertices are merged, and each contour is returned
+//				as a loop of vertex indices. Returns false if the polygon has
+//				no area.
 //-----------------------------------------------------------------------------
-static void CALLBACK
-e3tessellate_callback_end(void *userData)
-{	E3TessellateState	*theState = (E3TessellateState *) userData;
-	TQ3Boolean			wasAdded;
+static bool
+e3tessellate_project_contours(E3TessellateState *theState, TQ3Uns32 numContours,
+								const TQ3GeneralPolygonContourData *theContours,
+								std::vector<TE3TessLoop> &theLoops, bool &hasSharedVertices)
+{	double						nx, ny, nz, ux, uy, uz, vx, vy, vz, theLength;
+	std::vector<TQ3Uns32>		sortedIndices, vertexRemap;
+	const TQ3Point3D			*p0, *p1;
+	TQ3Uns32					n, m, k, numVertices;
 
 
 
-	// Add the triangle, and then any edges
-	wasAdded = e3tessellate_add_triangle(theState, theState->vertexIndices);
-	if (wasAdded)
+	// Find the polygon normal
+	nx = ny = nz = 0.0;
+	numVertices  = 0;
+
+	for (n = 0; n < numContours; n++)
 		{
-		// Add an edge between vertex 0 and 1 if required
-		if (theState->vertexEdgeState[0])
-			e3tessellate_add_edge(theState, theState->vertexIndices[0], theState->vertexIndices[1]);
+		for (m = 0; m < theContours[n].numVertices; m++)
+			{
+			p0  = &theContours[n].vertices[m].point;
+			p1  = &theContours[n].vertices[(m + 1) % theContours[n].numVertices].point;
+			nx += ((double) p0->y - p1->y) * ((double) p0->z + p1->z);
+			ny += ((double) p0->z - p1->z) * ((double) p0->x + p1->x);
+			nz += ((double) p0->x - p1->x) * ((double) p0->y + p1->y);
+			}
 
+		numVertices += theContours[n].numVertices;
+		}
+
+	if (numVertices < 3)
+		return(false);
 
-		// Add an edge between vertex 1 and 2 if required
-		if (theState->vertexEdgeState[1])
-			e3tessellate_add_edge(theState, theState->vertexIndices[1], theState->vertexIndices[2]);
 
 
-		// Add an edge between vertex 2 and 0 if required
-		if (theState->vertexEdgeState[2])
-			e3tessellate_add_edge(theState, theState->vertexIndices[2], theState->vertexIndices[0]);
+	// If the contours cancel out, fall back to the plane of the largest triangle
+	//
+	// That plane is turned to agree with whatever is left of the Newell normal,
+	// so that a self-intersecting polygon whose lobes nearly cancel keeps the
+	// orientation given by its net area, as it does with GLU. The orientation
+	// is only arbitrary if the contours cancel exactly.
+	p0 = &theContours[0].vertices[0].point;
+	p1 = p0;
+	theLength = 0.0;
+
+	for (n = 0; n < numContours; n++)
+		{
+		for (m = 0; m < theContours[n].numVertices; m++)
+			{
+			const TQ3Point3D	*thePoint = &theContours[n].vertices[m].point;
+			double				dx = (double) thePoint->x - p0->x;
+			double				dy = (double) thePoint->y - p0->y;
+			double				dz = (double) thePoint->z - p0->z;
+
+			if (dx * dx + dy * dy + dz * dz > theLength)
+				{
+				theLength = dx * dx + dy * dy + dz * dz;
+				p1        = thePoint;
+				}
+			}
 		}
-}
 
+	if (nx * nx + ny * ny + nz * nz <= kIntersectTolerance * theLength * theLength)
+		{
+		double	newellX = nx, newellY = ny, newellZ = nz;
 
+		nx = ny = nz = 0.0;
 
+		for (n = 0; n < numContours; n++)
+			{
+			for (m = 0; m < theContours[n].numVertices; m++)
+				{
+				const TQ3Point3D	*thePoint = &theContours[n].vertices[m].point;
+				double				ax = (double) p1->x - p0->x, bx = (double) thePoint->x - p0->x;
+				double				ay = (double) p1->y - p0->y, by = (double) thePoint->y - p0->y;
+				double				az = (double) p1->z - p0->z, bz = (double) thePoint->z - p0->z;
+				double				cx = ay * bz - az * by;
+				double				cy = az * bx - ax * bz;
+				double				cz = ax * by - ay * bx;
+
+				if (cx * cx + cy * cy + cz * cz > nx * nx + ny * ny + nz * nz)
+					{
+					nx = cx;
+					ny = cy;
+					nz = cz;
+					}
+				}
+			}
 
+		if (nx * nx + ny * ny + nz * nz <= kIntersectTolerance * theLength * theLength)
+			return(false);
 
-//=============================================================================
-//      e3tessellate_callback_edge : Update the edge state.
-//-----------------------------------------------------------------------------
-static void CALLBACK
-e3tessellate_callback_edge(GLboolean isEdge, void *userData)
-{	E3TessellateState		*theState = (E3TessellateState *) userData;
+		if (nx * newellX + ny * newellY + nz * newellZ < 0.0)
+			{
+			nx = -nx;
+			ny = -ny;
+			nz = -nz;
+			}
+		}
 
+	theLength = sqrt(nx * nx + ny * ny + nz * nz);
 
+	nx /= theLength;
+	ny /= theLength;
+	nz /= theLength;
 
-	// Update the current edge state
-	theState->edgeState = (TQ3Boolean) isEdge;
-}
 
 
+	// Build an orthonormal basis (u, v, n) for the plane
+	if (fabs(nx) < 0.5)
+		{
+		ux = 0.0;
+		uy =  nz;
+		uz = -ny;
+		}
+	else
+		{
+		ux = -nz;
+		uy = 0.0;
+		uz =  nx;
+		}
 
+	theLength = sqrt(ux * ux + uy * uy + uz * uz);
+	ux /= theLength;
+	uy /= theLength;
+	uz /= theLength;
 
+	vx = ny * uz - nz * uy;
+	vy = nz * ux - nx * uz;
+	vz = nx * uy - ny * ux;
 
-//=============================================================================
-//      e3tessellate_callback_vertex : Process another vertex.
-//-----------------------------------------------------------------------------
-static void CALLBACK
-e3tessellate_callback_vertex(GLvoid *vertex, void *userData)
-{	E3TessellateState		*theState  = (E3TessellateState *) userData;
-	TQ3Vertex3D				*theVertex = (TQ3Vertex3D       *) vertex;
-	TQ3Uns32				vertexIndex;
 
 
+	// Project the vertices
+	theState->vertices.resize(numVertices);
+	k = 0;
 
-	// If we're not getting individual begin/end callbacks for each triangle,
-	// our index will eventually overflow - once this happens, we need to
-	// close this triangle and start the next one ourselves.
-	if (theState->vertexInTriangle == 3)
+	for (n = 0; n < numContours; n++)
 		{
-		e3tessellate_callback_end(userData);
-		e3tessellate_callback_begin(GL_TRIANGLES, userData);
+		for (m = 0; m < theContours[n].numVertices; m++, k++)
+			{
+			const TQ3Vertex3D	*theVertex = &theContours[n].vertices[m];
+
+			theState->vertices[k].x         = ux * theVertex->point.x + uy * theVertex->point.y + uz * theVertex->point.z;
+			theState->vertices[k].y         = vx * theVertex->point.x + vy * theVertex->point.y + vz * theVertex->point.z;
+			theState->vertices[k].theVertex = theVertex;
+			}
 		}
 
 
 
-	// Add the vertex to the list
-	vertexIndex = e3tessellate_add_vertex(theState, theVertex);
+	// Merge coincident vertices, keeping the first
+	sortedIndices.resize(numVertices);
+	vertexRemap.resize(numVertices);
 
+	for (k = 0; k < numVertices; k++)
+		sortedIndices[k] = vertexRemap[k] = k;
 
+	const std::vector<TE3TessVertex>	&theVertices = theState->vertices;
+	std::sort(sortedIndices.begin(), sortedIndices.end(),
+				[&theVertices](TQ3Uns32 a, TQ3Uns32 b)
+				{
+					if (theVertices[a].x != theVertices[b].x)
+						return(theVertices[a].x < theVertices[b].x);
 
-	// Update the triangle state
-	theState->vertexEdgeState[theState->vertexInTriangle] = theState->edgeState;
-	theState->vertexIndices[  theState->vertexInTriangle] = vertexIndex;
+					if (theVertices[a].y != theVertices[b].y)
+						return(theVertices[a].y < theVertices[b].y);
 
-	theState->vertexInTriangle++;
-}
+					return(a < b);
+				});
+
+	hasSharedVertices = false;
+	for (k = 1; k < numVertices; k++)
+		{
+		const TE3TessVertex		&thisVertex = theVertices[sortedIndices[k]];
+		const TE3TessVertex		&prevVertex = theVertices[sortedIndices[k - 1]];
 
+		if (thisVertex.x == prevVertex.x && thisVertex.y == prevVertex.y)
+			{
+			vertexRemap[sortedIndices[k]] = vertexRemap[sortedIndices[k - 1]];
+			hasSharedVertices = true;
+			}
+		}
 
 
 
+	// Build the loops, dropping repeated vertices
+	theLoops.clear();
+	theLoops.reserve(numContours);
+	k = 0;
 
-//=============================================================================
-//      e3tessellate_callback_error : Store an error code in the tessellator state.
-//-----------------------------------------------------------------------------
-static void CALLBACK
-e3tessellate_callback_error(GLenum errorCode, void *userData)
-{	E3TessellateState		*theState = (E3TessellateState *) userData;
+	for (n = 0; n < numContours; n++)
+		{
+		TE3TessLoop		theLoop;
+
+		for (m = 0; m < theContours[n].numVertices; m++, k++)
+			{
+			TQ3Uns32	theIndex = vertexRemap[k];
+
+			if (theLoop.vertices.empty() || theLoop.vertices.back() != theIndex)
+				theLoop.vertices.push_back(theIndex);
+			}
 
+		while (theLoop.vertices.size() > 1 && theLoop.vertices.back() == theLoop.vertices.front())
+			theLoop.vertices.pop_back();
 
+		if (theLoop.vertices.size() >= 3)
+			theLoops.push_back(theLoop);
+		}
 
-	// Set the error state
-	theState->errorState = errorCode;	
+	return(!theLoops.empty());
 }
 
 
@@ -602,114 +724,153 @@ e3tessellate_callback_error(GLenum errorCode, void *userData)
 
 
 //=============================================================================
-//      e3tessellate_callback_combine : Combine vertices to form a new vertex.
+//      e3tessellate_cross : Return the 2D cross product of two vectors.
 //-----------------------------------------------------------------------------
-static void CALLBACK
-e3tessellate_callback_combine(const GLdouble		pointIn[3],
-								const void			*dataIn[4],
-								const GLfloat		theWeights[4],
-								void				**dataOut,
-								void				*userData)
-{	E3TessellateState		*theState = (E3TessellateState *) userData;
-	E3CombinedAttribute		combinedState, vertexState[4];
-	TQ3Point3D				combinedPoint;
-	const TQ3Vertex3D		*theVertex;
-	TQ3Vertex3D				*newVertex;
-	TQ3Uns32				n, theSize;
-	TQ3Status				qd3dStatus;
+static inline double
+e3tessellate_cross(double ax, double ay, double bx, double by)
+{
+	return(ax * by - ay * bx);
+}
 
 
 
-	// Initialise the result
-	*dataOut = nullptr;
 
 
+//=============================================================================
+//      e3tessellate_intersect_edges : Find where two edges must be split.
+//-----------------------------------------------------------------------------
+//		Note :	Edges which cross at interior points are both split at a new
+//				combined vertex, with GLU-style weights of half the linear
+//				interpolation along each edge. An edge which is touched in its
+//				interior by a vertex of the other is split at that vertex.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_intersect_edges(E3TessellateState *theState,
+								const std::vector<TE3TessEdge> &theEdges,
+								TQ3Uns32 edge1, TQ3Uns32 edge2,
+								std::vector<TE3TessSplit> &theSplits)
+{	double					rx, ry, sx, sy, qx, qy, theDenom, t, u, rLen, sLen;
+	const TE3TessVertex		*a, *b, *c, *d;
+	TE3TessSplit			theSplit;
+	TE3TessVertex			newVertex;
+	const TQ3Vertex3D		*combineVertices[4];
+	float					combineWeights[4];
 
-	// Collect the attribute state that can be interpolated
-	//
-	// Hilights, surface shaders, and custom attributes can't be interpolated so we just
-	// have to skip them - custom attributes could be extended to handle interpolation?
-	Q3Memory_Clear(vertexState, sizeof(vertexState));
 
-	for (n = 0; n < 4; n++)
-		{
-		theVertex = (const TQ3Vertex3D *) dataIn[n];
-		if (theVertex != nullptr && theVertex->attributeSet != nullptr)
-			{
-			e3tessellate_attribute_get(theVertex, &vertexState[n], kQ3AttributeTypeSurfaceUV);
-			e3tessellate_attribute_get(theVertex, &vertexState[n], kQ3AttributeTypeShadingUV);
-			e3tessellate_attribute_get(theVertex, &vertexState[n], kQ3AttributeTypeNormal);
-			e3tessellate_attribute_get(theVertex, &vertexState[n], kQ3AttributeTypeAmbientCoefficient);
-			e3tessellate_attribute_get(theVertex, &vertexState[n], kQ3AttributeTypeDiffuseColor);
-			e3tessellate_attribute_get(theVertex, &vertexState[n], kQ3AttributeTypeSpecularColor);
-			e3tessellate_attribute_get(theVertex, &vertexState[n], kQ3AttributeTypeSpecularControl);
-			e3tessellate_attribute_get(theVertex, &vertexState[n], kQ3AttributeTypeTransparencyColor);
-			e3tessellate_attribute_get(theVertex, &vertexState[n], kQ3AttributeTypeSurfaceTangent);
-			}
-		}
 
+	// Edges which share a vertex can't cross
+	const TE3TessEdge	&e1 = theEdges[edge1];
+	const TE3TessEdge	&e2 = theEdges[edge2];
 
+	if (e1.v0 == e2.v0 || e1.v0 == e2.v1 || e1.v1 == e2.v0 || e1.v1 == e2.v1)
+		return;
 
-	// Blend the four vertices together to form the combined vertex
-	//
-	// We blend by using the supplied weights, however we don't redistribute weights if
-	// an attribute isn't present. Since we blend by addition, we reply on vertexState
-	// being cleared to 0 above so that attributes which aren't present will have no
-	// effect on the output.
-	//
-	// We might get better results if we redistribute the weights based on the presence of
-	// the corresponding attribute (e.g., if only 3 vertices have a colour, should the
-	// weight for the 4th vertex be redistributed amongst the other 3?). To be decided.
-	Q3Memory_Clear(&combinedState, sizeof(combinedState));
+	a = &theState->vertices[e1.v0];
+	b = &theState->vertices[e1.v1];
+	c = &theState->vertices[e2.v0];
+	d = &theState->vertices[e2.v1];
 
-	combinedPoint.x = (float) pointIn[0];
-	combinedPoint.y = (float) pointIn[1];
-	combinedPoint.z = (float) pointIn[2];
+	rx = b->x - a->x;
+	ry = b->y - a->y;
+	sx = d->x - c->x;
+	sy = d->y - c->y;
+	qx = c->x - a->x;
+	qy = c->y - a->y;
 
-	for (n = 0; n < 4; n++)
-		e3tessellate_attribute_blend(&combinedState, &vertexState[n], theWeights[n]);
+	rLen     = sqrt(rx * rx + ry * ry);
+	sLen     = sqrt(sx * sx + sy * sy);
+	theDenom = e3tessellate_cross(rx, ry, sx, sy);
 
 
 
-	// Allocate another vertex
-	newVertex = (TQ3Vertex3D *) Q3Memory_Allocate(sizeof(TQ3Vertex3D));
-	if (newVertex == nullptr)
+	// Parallel edges only meet if a vertex of one lies inside the other
+	if (fabs(theDenom) <= kIntersectTolerance * rLen * sLen)
+		{
+		if (fabs(e3tessellate_cross(qx, qy, rx, ry)) > kIntersectTolerance * rLen * (rLen + sLen))
+			return;
+
+		const TE3TessVertex		*theEnds[4]   = { c, d, a, b };
+		const TQ3Uns32			endIndices[4] = { e2.v0, e2.v1, e1.v0, e1.v1 };
+
+		for (TQ3Uns32 n = 0; n < 4; n++)
+			{
+			const TE3TessVertex	*p0 = (n < 2) ? a : c;
+			const TE3TessVertex	*p1 = (n < 2) ? b : d;
+			double				dx  = p1->x - p0->x;
+			double				dy  = p1->y - p0->y;
+
+			t = ((theEnds[n]->x - p0->x) * dx + (theEnds[n]->y - p0->y) * dy) / (dx * dx + dy * dy);
+			if (t > kIntersectTolerance && t < 1.0 - kIntersectTolerance)
+				{
+				theSplit.theEdge   = (n < 2) ? edge1 : edge2;
+				theSplit.t         = t;
+				theSplit.theVertex = endIndices[n];
+				theSplits.push_back(theSplit);
+				}
+			}
 		return;
+		}
 
 
 
-	// Grow the temporary vertex array, and save the new vertex
-	theSize    = static_cast<TQ3Uns32>((theState->numTempVertices + 1) * sizeof(TQ3Vertex3D*));
-	qd3dStatus = Q3Memory_Reallocate(&theState->tempVertexList, theSize);
-	if (qd3dStatus != kQ3Success)
-		{
-		Q3Memory_Free(&newVertex);
+	// Find the parameters of the intersection along each edge
+	t = e3tessellate_cross(qx, qy, sx, sy) / theDenom;
+	u = e3tessellate_cross(qx, qy, rx, ry) / theDenom;
+
+	if (t < -kIntersectTolerance || t > 1.0 + kIntersectTolerance ||
+		u < -kIntersectTolerance || u > 1.0 + kIntersectTolerance)
 		return;
-		}
 
-	theState->tempVertexList[theState->numTempVertices] = newVertex;
-	theState->numTempVertices++;
+	bool	isInside1 = (t > kIntersectTolerance && t < 1.0 - kIntersectTolerance);
+	bool	isInside2 = (u > kIntersectTolerance && u < 1.0 - kIntersectTolerance);
 
 
 
-	// Set up the vertex, and return it
-	newVertex->point        = combinedPoint;
-	newVertex->attributeSet = (combinedState.attributeMask == 0 ? nullptr : Q3AttributeSet_New());
+	// If the edges cross, split both at a new vertex
+	if (isInside1 && isInside2)
+		{
+		combineVertices[0] = a->theVertex;
+		combineVertices[1] = b->theVertex;
+		combineVertices[2] = c->theVertex;
+		combineVertices[3] = d->theVertex;
+		combineWeights[0]  = (float) (0.5 * (1.0 - t));
+		combineWeights[1]  = (float) (0.5 * t);
+		combineWeights[2]  = (float) (0.5 * (1.0 - u));
+		combineWeights[3]  = (float) (0.5 * u);
+
+		newVertex.x         = a->x + t * rx;
+		newVertex.y         = a->y + t * ry;
+		newVertex.theVertex = e3tessellate_combine_vertex(theState, combineVertices, combineWeights);
+		theState->vertices.push_back(newVertex);
+
+		theSplit.theVertex = (TQ3Uns32) (theState->vertices.size() - 1);
+		theSplit.theEdge   = edge1;
+		theSplit.t         = t;
+		theSplits.push_back(theSplit);
+
+		theSplit.theEdge   = edge2;
+		theSplit.t         = u;
+		theSplits.push_back(theSplit);
+		}
 
-	if (newVertex->attributeSet != nullptr)
+
+
+	// Otherwise, if a vertex touches the inside of an edge, split the edge there
+	else if (isInside1)
 		{
-		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeSurfaceUV);
-		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeShadingUV);
-		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeNormal);
-		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeAmbientCoefficient);
-		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeDiffuseColor);
-		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeSpecularColor);
-		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeSpecularControl);
-		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeTransparencyColor);
-		e3tessellate_attribute_set(newVertex, &combinedState, kQ3AttributeTypeSurfaceTangent);
+		theSplit.theEdge   = edge1;
+		theSplit.t         = t;
+		theSplit.theVertex = (u < 0.5) ? e2.v0 : e2.v1;
+		theSplits.push_back(theSplit);
 		}
 
-	*dataOut = newVertex;
+	else if (isInside2)
+		{
+		theSplit.theEdge   = edge2;
+		theSplit.t         = u;
+		theSplit.theVertex = (t < 0.5) ? e1.v0 : e1.v1;
+		theSplits.push_back(theSplit);
+		}
 }
 
 
@@ -717,37 +878,1943 @@ e3tessellate_callback_combine(const GLdouble		pointIn[3],
 
 
 //=============================================================================
-//      e3tessellate_create_trimesh : Create the TriMesh from the tessellator.
+//      e3tessellate_find_vertex : Find the vertex a vertex was merged with.
 //-----------------------------------------------------------------------------
-static TQ3GeometryObject
-e3tessellate_create_trimesh(E3TessellateState *theState, TQ3AttributeSet triMeshAttributes)
-{	TQ3TriMeshAttributeData		*theAttributes;
-	TQ3Uns32					n, numPoints;
-	TQ3Point3D					*thePoints;
-	TQ3GeometryObject			theTriMesh;
+static TQ3Uns32
+e3tessellate_find_vertex(const std::vector<TQ3Uns32> &vertexRemap, TQ3Uns32 theIndex)
+{
+	while (vertexRemap[theIndex] != theIndex)
+		theIndex = vertexRemap[theIndex];
 
+	return(theIndex);
+}
 
 
-	// Allocate the vertex points and attributes arrays
-	thePoints     = (TQ3Point3D              *) Q3Memory_Allocate(static_cast<TQ3Uns32>(theState->numTriMeshVertices * sizeof(TQ3Point3D)));
-	
-	if (thePoints == nullptr)
-		return nullptr;
-	
-	theAttributes = (TQ3TriMeshAttributeData *) Q3Memory_Allocate(kQ3AttributeTypeNumTypes     * sizeof(TQ3TriMeshAttributeData));
-	
-	if (theAttributes == nullptr)
-		{
-		Q3Memory_Free( &thePoints );
-		return(nullptr);
-		}
 
 
 
-	// Set up the points
-	numPoints                       = theState->numTriMeshVertices;
-	theState->triMeshData.numPoints = numPoints;
-	theState->triMeshData.points    = thePoints;
+//=============================================================================
+//      e3tessellate_find_splits : Find the intersections between edges.
+//-----------------------------------------------------------------------------
+//		Note :	The edges are swept in order of their minimum x, so each edge
+//				is only tested against the edges which overlap it in x.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_find_splits(E3TessellateState *theState, const std::vector<TE3TessLoop> &theLoops,
+							std::vector<TE3TessEdge> &theEdges, std::vector<TE3TessSplit> &theSplits)
+{	std::vector<TQ3Uns32>		sortedEdges;
+	TQ3Uns32					n, m, numEdges, numVertices;
+	TE3TessEdge					theEdge;
+
+
+
+	// Collect the edges
+	numVertices = (TQ3Uns32) theState->vertices.size();
+	theEdges.clear();
+
+	for (n = 0; n < theLoops.size(); n++)
+		{
+		const std::vector<TQ3Uns32>	&loopVertices = theLoops[n].vertices;
+
+		for (m = 0; m < loopVertices.size(); m++)
+			{
+			theEdge.v0   = loopVertices[m];
+			theEdge.v1   = loopVertices[(m + 1) % loopVertices.size()];
+			theEdge.minX = std::min(theState->vertices[theEdge.v0].x, theState->vertices[theEdge.v1].x);
+			theEdge.maxX = std::max(theState->vertices[theEdge.v0].x, theState->vertices[theEdge.v1].x);
+			theEdge.minY = std::min(theState->vertices[theEdge.v0].y, theState->vertices[theEdge.v1].y);
+			theEdge.maxY = std::max(theState->vertices[theEdge.v0].y, theState->vertices[theEdge.v1].y);
+			theEdges.push_back(theEdge);
+			}
+		}
+
+
+
+	// Sort them by x
+	numEdges = (TQ3Uns32) theEdges.size();
+	sortedEdges.resize(numEdges);
+
+	for (n = 0; n < numEdges; n++)
+		sortedEdges[n] = n;
+
+	std::sort(sortedEdges.begin(), sortedEdges.end(),
+				[&theEdges](TQ3Uns32 a, TQ3Uns32 b) { return(theEdges[a].minX < theEdges[b].minX); });
+
+
+
+	// And test the edges which overlap
+	theSplits.clear();
+
+	for (n = 0; n < numEdges; n++)
+		{
+		const TE3TessEdge	&edge1 = theEdges[sortedEdges[n]];
+
+		for (m = n + 1; m < numEdges && theEdges[sortedEdges[m]].minX <= edge1.maxX; m++)
+			{
+			const TE3TessEdge	&edge2 = theEdges[sortedEdges[m]];
+
+			if (edge2.minY <= edge1.maxY && edge2.maxY >= edge1.minY)
+				e3tessellate_intersect_edges(theState, theEdges, sortedEdges[n], sortedEdges[m], theSplits);
+			}
+		}
+
+
+
+	// Merge the new vertices with any vertex at the same place, since several
+	// edges may pass through one point
+	if (theState->vertices.size() > numVertices)
+		{
+		std::vector<TQ3Uns32>		vertexRemap(theState->vertices.size());
+		std::vector<bool>			isUsed(theState->vertices.size(), true);
+		double						minX, maxX, minY, maxY, theTolerance;
+		const std::vector<TE3TessVertex>	&theVertices = theState->vertices;
+
+		minX = maxX = theVertices[0].x;
+		minY = maxY = theVertices[0].y;
+
+		for (n = 0; n < vertexRemap.size(); n++)
+			{
+			vertexRemap[n] = n;
+			minX = std::min(minX, theVertices[n].x);
+			maxX = std::max(maxX, theVertices[n].x);
+			minY = std::min(minY, theVertices[n].y);
+			maxY = std::max(maxY, theVertices[n].y);
+			}
+
+		theTolerance = kIntersectTolerance * std::max(maxX - minX, maxY - minY);
+
+
+
+		// Skip the original vertices which were merged when they were projected
+		for (n = 0; n < numVertices; n++)
+			isUsed[n] = false;
+
+		for (n = 0; n < theEdges.size(); n++)
+			isUsed[theEdges[n].v0] = isUsed[theEdges[n].v1] = true;
+
+		std::vector<TQ3Uns32>	sortedVertices;
+		for (n = 0; n < vertexRemap.size(); n++)
+			{
+			if (isUsed[n])
+				sortedVertices.push_back(n);
+			}
+
+		std::sort(sortedVertices.begin(), sortedVertices.end(),
+					[&theVertices](TQ3Uns32 a, TQ3Uns32 b) { return(theVertices[a].x < theVertices[b].x); });
+
+		for (n = 0; n < sortedVertices.size(); n++)
+			{
+			TQ3Uns32	thisIndex = sortedVertices[n];
+
+			for (m = n + 1; m < sortedVertices.size() && theVertices[sortedVertices[m]].x - theVertices[thisIndex].x <= theTolerance; m++)
+				{
+				TQ3Uns32	otherIndex = sortedVertices[m];
+
+				if (fabs(theVertices[otherIndex].y - theVertices[thisIndex].y) <= theTolerance)
+					{
+					// Join the two groups, keeping the lowest index - since the
+					// original vertices come first, they are never remapped
+					TQ3Uns32	index1 = e3tessellate_find_vertex(vertexRemap, thisIndex);
+					TQ3Uns32	index2 = e3tessellate_find_vertex(vertexRemap, otherIndex);
+
+					if (std::max(index1, index2) >= numVertices)
+						vertexRemap[std::max(index1, index2)] = std::min(index1, index2);
+					}
+				}
+			}
+
+		for (n = 0; n < theSplits.size(); n++)
+			theSplits[n].theVertex = e3tessellate_find_vertex(vertexRemap, theSplits[n].theVertex);
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_rebuild_loops : Rebuild the loops so they don't cross.
+//-----------------------------------------------------------------------------
+//		Note :	The edges are split at their intersections, and at every
+//				vertex the edges are paired with their neighbours in angular
+//				order. Walking these pairs gives loops which may touch but
+//				never cross, and since the edges are unchanged the odd winding
+//				rule gives the same region as before.
+//
+//				A loop which visits a vertex twice is split in two at it.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_rebuild_loops(E3TessellateState *theState, std::vector<TE3TessLoop> &theLoops,
+							const std::vector<TE3TessEdge> &theEdges, std::vector<TE3TessSplit> &theSplits)
+{	std::vector<TQ3Uns32>		subEdges, firstSlot, slotEdge, edgeSlot, pairSlot, thePath;
+	std::vector<TQ3Int32>		pathPosition;
+	std::vector<bool>			edgeUsed;
+	TQ3Uns32					n, m, numVertices, numSubEdges, prevVertex;
+
+
+
+	// Split each edge at its intersections, in order along the edge
+	std::sort(theSplits.begin(), theSplits.end(),
+				[](const TE3TessSplit &a, const TE3TessSplit &b)
+				{
+					if (a.theEdge != b.theEdge)
+						return(a.theEdge < b.theEdge);
+
+					return(a.t < b.t);
+				});
+
+	m = 0;
+	for (n = 0; n < theEdges.size(); n++)
+		{
+		prevVertex = theEdges[n].v0;
+
+		for ( ; m < theSplits.size() && theSplits[m].theEdge == n; m++)
+			{
+			if (theSplits[m].theVertex != prevVertex)
+				{
+				subEdges.push_back(prevVertex);
+				subEdges.push_back(theSplits[m].theVertex);
+				prevVertex = theSplits[m].theVertex;
+				}
+			}
+
+		if (theEdges[n].v1 != prevVertex)
+			{
+			subEdges.push_back(prevVertex);
+			subEdges.push_back(theEdges[n].v1);
+			}
+		}
+
+
+
+
+	// Remove pairs of identical edges, which cancel out under the odd winding rule
+	std::vector<TQ3Uns32>	sortedEdges(subEdges.size() / 2);
+
+	for (n = 0; n < sortedEdges.size(); n++)
+		{
+		sortedEdges[n] = n;
+		if (subEdges[2 * n] > subEdges[2 * n + 1])
+			std::swap(subEdges[2 * n], subEdges[2 * n + 1]);
+		}
+
+	std::sort(sortedEdges.begin(), sortedEdges.end(),
+				[&subEdges](TQ3Uns32 a, TQ3Uns32 b)
+				{
+					if (subEdges[2 * a] != subEdges[2 * b])
+						return(subEdges[2 * a] < subEdges[2 * b]);
+
+					return(subEdges[2 * a + 1] < subEdges[2 * b + 1]);
+				});
+
+	std::vector<TQ3Uns32>	keptEdges;
+	for (n = 0; n < sortedEdges.size(); n++)
+		{
+		TQ3Uns32	theEdge = sortedEdges[n];
+
+		if (n + 1 < sortedEdges.size() &&
+			subEdges[2 * theEdge]     == subEdges[2 * sortedEdges[n + 1]] &&
+			subEdges[2 * theEdge + 1] == subEdges[2 * sortedEdges[n + 1] + 1])
+			{
+			n++;
+			continue;
+			}
+
+		keptEdges.push_back(subEdges[2 * theEdge]);
+		keptEdges.push_back(subEdges[2 * theEdge + 1]);
+		}
+
+	subEdges.swap(keptEdges);
+	numSubEdges = (TQ3Uns32) (subEdges.size() / 2);
+	numVertices = (TQ3Uns32) theState->vertices.size();
+
+
+
+	// Find the edges at each vertex
+	firstSlot.assign(numVertices + 1, 0);
+
+	for (n = 0; n < subEdges.size(); n++)
+		firstSlot[subEdges[n] + 1]++;
+
+	for (n = 0; n < numVertices; n++)
+		firstSlot[n + 1] += firstSlot[n];
+
+	std::vector<TQ3Uns32>	nextSlot(firstSlot.begin(), firstSlot.end() - 1);
+	slotEdge.resize(subEdges.size());
+	edgeSlot.resize(subEdges.size());
+
+	for (n = 0; n < subEdges.size(); n++)
+		{
+		TQ3Uns32	theSlot = nextSlot[subEdges[n]]++;
+
+		slotEdge[theSlot] = n;
+		edgeSlot[n]       = theSlot;
+		}
+
+
+
+	// Pair the edges at each vertex with their angular neighbours
+	pairSlot.assign(subEdges.size(), kQ3ArrayIndexNULL);
+
+	for (n = 0; n < numVertices; n++)
+		{
+		TQ3Uns32	slotStart = firstSlot[n];
+		TQ3Uns32	slotEnd   = firstSlot[n + 1];
+
+		if (slotEnd - slotStart > 2)
+			{
+			const TE3TessVertex		&theCentre = theState->vertices[n];
+			std::vector<double>		theAngles(slotEnd - slotStart);
+			std::vector<TQ3Uns32>	theOrder(slotEnd - slotStart);
+
+			for (m = slotStart; m < slotEnd; m++)
+				{
+				const TE3TessVertex	&theOther = theState->vertices[subEdges[slotEdge[m] ^ 1]];
+
+				theAngles[m - slotStart] = atan2(theOther.y - theCentre.y, theOther.x - theCentre.x);
+				theOrder[ m - slotStart] = slotEdge[m];
+				}
+
+			std::vector<TQ3Uns32>	sortedOrder(theOrder.size());
+			for (m = 0; m < sortedOrder.size(); m++)
+				sortedOrder[m] = m;
+
+			std::sort(sortedOrder.begin(), sortedOrder.end(),
+						[&theAngles](TQ3Uns32 a, TQ3Uns32 b) { return(theAngles[a] < theAngles[b]); });
+
+			for (m = slotStart; m < slotEnd; m++)
+				{
+				slotEdge[m] = theOrder[sortedOrder[m - slotStart]];
+				edgeSlot[slotEdge[m]] = m;
+				}
+			}
+
+		for (m = slotStart; m + 1 < slotEnd; m += 2)
+			{
+			pairSlot[m]     = m + 1;
+			pairSlot[m + 1] = m;
+			}
+		}
+
+
+
+	// Walk the pairs to form loops
+	theLoops.clear();
+	edgeUsed.assign(numSubEdges, false);
+	pathPosition.assign(numVertices, -1);
+
+	for (n = 0; n < numSubEdges; n++)
+		{
+		if (edgeUsed[n])
+			continue;
+
+		TQ3Uns32	theEnd = 2 * n + 1;
+		bool		isClosed = false;
+
+		thePath.clear();
+		thePath.push_back(subEdges[2 * n]);
+		edgeUsed[n] = true;
+
+		while (true)
+			{
+			TQ3Uns32	theSlot = pairSlot[edgeSlot[theEnd]];
+			if (theSlot == kQ3ArrayIndexNULL)
+				break;
+
+			TQ3Uns32	nextEnd  = slotEdge[theSlot];
+			TQ3Uns32	nextEdge = nextEnd / 2;
+			if (nextEdge == n)
+				{
+				isClosed = true;
+				break;
+				}
+
+			if (edgeUsed[nextEdge])
+				break;
+
+			thePath.push_back(subEdges[theEnd]);
+			edgeUsed[nextEdge] = true;
+			theEnd = nextEnd ^ 1;
+			}
+
+		if (!isClosed || thePath.size() < 3)
+			continue;
+
+
+
+		// Split the path wherever it revisits a vertex
+		std::vector<TQ3Uns32>	theStack;
+
+		for (m = 0; m < thePath.size(); m++)
+			{
+			TQ3Uns32	theVertex = thePath[m];
+			TQ3Int32	thePos    = pathPosition[theVertex];
+
+			if (thePos >= 0)
+				{
+				TE3TessLoop		subLoop;
+
+				subLoop.vertices.assign(theStack.begin() + thePos, theStack.end());
+				for (TQ3Uns32 k = 1; k < subLoop.vertices.size(); k++)
+					pathPosition[subLoop.vertices[k]] = -1;
+
+				theStack.resize(thePos + 1);
+
+				if (subLoop.vertices.size() >= 3)
+					theLoops.push_back(subLoop);
+				}
+			else
+				{
+				pathPosition[theVertex] = (TQ3Int32) theStack.size();
+				theStack.push_back(theVertex);
+				}
+			}
+
+		for (m = 0; m < theStack.size(); m++)
+			pathPosition[theStack[m]] = -1;
+
+		if (theStack.size() >= 3)
+			{
+			TE3TessLoop		theLoop;
+
+			theLoop.vertices.swap(theStack);
+			theLoops.push_back(theLoop);
+			}
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_point_in_loop : Is a point inside a loop?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_point_in_loop(const E3TessellateState *theState, const TE3TessLoop &theLoop, double px, double py)
+{	TQ3Uns32		n, numVertices;
+	bool			isInside;
+
+
+
+	// Count the crossings of a ray to the right of the point
+	numVertices = (TQ3Uns32) theLoop.vertices.size();
+	isInside    = false;
+
+	for (n = 0; n < numVertices; n++)
+		{
+		const TE3TessVertex	&p0 = theState->vertices[theLoop.vertices[n]];
+		const TE3TessVertex	&p1 = theState->vertices[theLoop.vertices[(n + 1) % numVertices]];
+
+		if (((p0.y > py) != (p1.y > py)) &&
+			(px < (p1.x - p0.x) * (py - p0.y) / (p1.y - p0.y) + p0.x))
+			isInside = !isInside;
+		}
+
+	return(isInside);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_nest_loops : Find the nesting of the loops.
+//-----------------------------------------------------------------------------
+//		Note :	Since the loops don't cross, each loop is inside a chain of
+//				larger loops. Under the odd winding rule, loops at an even
+//				depth bound the outside of a region, and loops at an odd depth
+//				are holes in the region of their parent.
+//
+//				Each loop is tested at a point just inside the middle of its
+//				longest edge, which keeps the test away from the vertices that
+//				loops may share.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_nest_loops(const E3TessellateState *theState, std::vector<TE3TessLoop> &theLoops)
+{	double					theLength, maxLength, testDX = 0.0, testDY = 0.0;
+	TQ3Uns32				n, m, numVertices;
+	std::vector<TE3TessLoop>	keptLoops;
+
+
+
+	// Measure each loop
+	for (n = 0; n < theLoops.size(); n++)
+		{
+		TE3TessLoop		&theLoop = theLoops[n];
+
+		numVertices     = (TQ3Uns32) theLoop.vertices.size();
+		theLoop.theArea = 0.0;
+		theLoop.minX    = theLoop.maxX = theState->vertices[theLoop.vertices[0]].x;
+		theLoop.minY    = theLoop.maxY = theState->vertices[theLoop.vertices[0]].y;
+		theLoop.depth   = 0;
+		theLoop.parent  = -1;
+		maxLength       = -1.0;
+
+		for (m = 0; m < numVertices; m++)
+			{
+			const TE3TessVertex	&p0 = theState->vertices[theLoop.vertices[m]];
+			const TE3TessVertex	&p1 = theState->vertices[theLoop.vertices[(m + 1) % numVertices]];
+
+			theLoop.theArea += e3tessellate_cross(p0.x, p0.y, p1.x, p1.y);
+			theLoop.minX     = std::min(theLoop.minX, p0.x);
+			theLoop.maxX     = std::max(theLoop.maxX, p0.x);
+			theLoop.minY     = std::min(theLoop.minY, p0.y);
+			theLoop.maxY     = std::max(theLoop.maxY, p0.y);
+
+			theLength = (p1.x - p0.x) * (p1.x - p0.x) + (p1.y - p0.y) * (p1.y - p0.y);
+			if (theLength > maxLength)
+				{
+				maxLength     = theLength;
+				theLoop.testX = 0.5 * (p0.x + p1.x);
+				theLoop.testY = 0.5 * (p0.y + p1.y);
+				testDX        = p1.x - p0.x;
+				testDY        = p1.y - p0.y;
+				}
+			}
+
+		theLoop.theArea *= 0.5;
+
+
+
+		// Move the test point just inside the loop, so it can't land on another loop
+		theLength      = (theLoop.theArea > 0.0) ? kTestPointOffset : -kTestPointOffset;
+		theLoop.testX -= testDY * theLength;
+		theLoop.testY += testDX * theLength;
+		}
+
+
+
+	// Drop loops with no area, and sort the rest from largest to smallest
+	for (n = 0; n < theLoops.size(); n++)
+		{
+		if (theLoops[n].theArea != 0.0)
+			{
+			keptLoops.push_back(TE3TessLoop());
+			keptLoops.back() = theLoops[n];
+			}
+		}
+
+	std::stable_sort(keptLoops.begin(), keptLoops.end(),
+				[](const TE3TessLoop &a, const TE3TessLoop &b)
+				{ return(fabs(a.theArea) > fabs(b.theArea)); });
+
+	theLoops.swap(keptLoops);
+
+
+
+	// Find the loops which contain each loop - the last one is the parent
+	for (n = 1; n < theLoops.size(); n++)
+		{
+		TE3TessLoop		&theLoop = theLoops[n];
+
+		for (m = 0; m < n; m++)
+			{
+			const TE3TessLoop	&theOther = theLoops[m];
+
+			if (theOther.minX <= theLoop.minX && theOther.maxX >= theLoop.maxX &&
+				theOther.minY <= theLoop.minY && theOther.maxY >= theLoop.maxY &&
+				e3tessellate_point_in_loop(theState, theOther, theLoop.testX, theLoop.testY))
+				{
+				theLoop.depth++;
+				theLoop.parent = (TQ3Int32) m;
+				}
+			}
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_node_area : Return twice the signed area of a triangle.
+//-----------------------------------------------------------------------------
+//		Note :	The ear clipping follows the conventions of the earcut
+//				algorithm, where this is negative for counter-clockwise
+//				triangles.
+//-----------------------------------------------------------------------------
+static inline double
+e3tessellate_node_area(const TE3TessNode *p, const TE3TessNode *q, const TE3TessNode *r)
+{
+	return((q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y));
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_node_equals : Are two nodes at the same position?
+//-----------------------------------------------------------------------------
+static inline bool
+e3tessellate_node_equals(const TE3TessNode *p1, const TE3TessNode *p2)
+{
+	return(p1->x == p2->x && p1->y == p2->y);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_point_in_triangle : Is a point inside a triangle?
+//-----------------------------------------------------------------------------
+static inline bool
+e3tessellate_point_in_triangle(double ax, double ay, double bx, double by,
+								double cx, double cy, double px, double py)
+{
+	return((cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+		   (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+		   (bx - px) * (cy - py) >= (cx - px) * (by - py));
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_node_insert : Insert a node after another.
+//-----------------------------------------------------------------------------
+static TE3TessNode *
+e3tessellate_node_insert(E3TessellateState *theState, TQ3Uns32 theIndex, TE3TessNode *lastNode)
+{	TE3TessNode		*theNode;
+
+
+
+	// Create the node
+	theState->nodes.push_back(TE3TessNode());
+	theNode = &theState->nodes.back();
+
+	theNode->i          = theIndex;
+	theNode->x          = theState->vertices[theIndex].x;
+	theNode->y          = theState->vertices[theIndex].y;
+	theNode->prevZ      = nullptr;
+	theNode->nextZ      = nullptr;
+	theNode->z          = 0;
+	theNode->steiner    = false;
+	theNode->isBoundary = true;
+
+	theState->vertexUses[theIndex]++;
+
+
+
+	// Link it in
+	if (lastNode == nullptr)
+		{
+		theNode->prev = theNode;
+		theNode->next = theNode;
+		}
+	else
+		{
+		theNode->next        = lastNode->next;
+		theNode->prev        = lastNode;
+		lastNode->next->prev = theNode;
+		lastNode->next       = theNode;
+		}
+
+	return(theNode);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_node_remove : Unlink a node.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_node_remove(E3TessellateState *theState, TE3TessNode *p)
+{
+	theState->vertexUses[p->i]--;
+
+	p->next->prev = p->prev;
+	p->prev->next = p->next;
+
+	if (p->prevZ != nullptr)
+		p->prevZ->nextZ = p->nextZ;
+
+	if (p->nextZ != nullptr)
+		p->nextZ->prevZ = p->prevZ;
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_linked_list : Create a linked list from a loop.
+//-----------------------------------------------------------------------------
+//		Note :	Outer loops are linked counter-clockwise, and holes clockwise.
+//-----------------------------------------------------------------------------
+static TE3TessNode *
+e3tessellate_linked_list(E3TessellateState *theState, const TE3TessLoop &theLoop, bool isOuter)
+{	TE3TessNode		*lastNode = nullptr;
+	TQ3Uns32		n, numVertices;
+
+
+
+	// Link the vertices in the appropriate order
+	numVertices = (TQ3Uns32) theLoop.vertices.size();
+
+	if (isOuter == (theLoop.theArea > 0.0))
+		{
+		for (n = 0; n < numVertices; n++)
+			lastNode = e3tessellate_node_insert(theState, theLoop.vertices[n], lastNode);
+		}
+	else
+		{
+		for (n = numVertices; n > 0; n--)
+			lastNode = e3tessellate_node_insert(theState, theLoop.vertices[n - 1], lastNode);
+		}
+
+	if (lastNode != nullptr && e3tessellate_node_equals(lastNode, lastNode->next))
+		{
+		e3tessellate_node_remove(theState, lastNode);
+		lastNode = lastNode->next;
+		}
+
+	return(lastNode);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_filter_points : Remove duplicate and collinear points.
+//-----------------------------------------------------------------------------
+//		Note :	Removing a collinear point merges its two edges, which are on
+//				the boundary only if both of them were.
+//
+//				If keepEdges is set, a collinear point between a boundary edge
+//				and a diagonal is kept so that the boundary edge survives, as
+//				is a collinear point where the polygon touches itself. These
+//				are removed if the ear clipping later gets stuck.
+//-----------------------------------------------------------------------------
+static TE3TessNode *
+e3tessellate_filter_points(E3TessellateState *theState, TE3TessNode *start, TE3TessNode *end, bool keepEdges)
+{	TE3TessNode		*p;
+	bool			again;
+
+
+
+	// Check each point in turn
+	if (start == nullptr)
+		return(start);
+
+	if (end == nullptr)
+		end = start;
+
+	p = start;
+	do
+		{
+		again = false;
+
+		if (!p->steiner && (e3tessellate_node_equals(p, p->next) ||
+							(e3tessellate_node_area(p->prev, p, p->next) == 0.0 &&
+							 (!keepEdges || (p->prev->isBoundary == p->isBoundary && theState->vertexUses[p->i] == 1)))))
+			{
+			if (!e3tessellate_node_equals(p, p->next))
+				p->prev->isBoundary = p->prev->isBoundary && p->isBoundary;
+
+			e3tessellate_node_remove(theState, p);
+			p = end = p->prev;
+
+			if (p == p->next)
+				break;
+
+			again = true;
+			}
+		else
+			p = p->next;
+		}
+	while (again || p != end);
+
+	return(end);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_add_triangle : Add a triangle, and its boundary edges.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_add_triangle(E3TessellateState *theState,
+							const TE3TessNode *a, const TE3TessNode *b, const TE3TessNode *c,
+							bool isEdgeAB, bool isEdgeBC, bool isEdgeCA)
+{	TQ3TriMeshTriangleData		theTriangle;
+	TQ3TriMeshEdgeData			theEdge;
+
+
+
+	// Add the triangle
+	theTriangle.pointIndices[0] = a->i;
+	theTriangle.pointIndices[1] = b->i;
+	theTriangle.pointIndices[2] = c->i;
+	theState->triangles.push_back(theTriangle);
+
+
+
+	// Add the boundary edges
+	theEdge.triangleIndices[0] = (TQ3Uns32) (theState->triangles.size() - 1);
+	theEdge.triangleIndices[1] = kQ3ArrayIndexNULL;
+
+	if (isEdgeAB)
+		{
+		theEdge.pointIndices[0] = a->i;
+		theEdge.pointIndices[1] = b->i;
+		theState->edges.push_back(theEdge);
+		}
+
+	if (isEdgeBC)
+		{
+		theEdge.pointIndices[0] = b->i;
+		theEdge.pointIndices[1] = c->i;
+		theState->edges.push_back(theEdge);
+		}
+
+	if (isEdgeCA)
+		{
+		theEdge.pointIndices[0] = c->i;
+		theEdge.pointIndices[1] = a->i;
+		theState->edges.push_back(theEdge);
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_z_order : Find the z-order of a point.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3tessellate_z_order(double px, double py, double minX, double minY, double invSize)
+{	TQ3Uns32	x, y;
+
+
+
+	// Interleave the bits of the grid coordinates
+	x = (TQ3Uns32) ((px - minX) * invSize);
+	y = (TQ3Uns32) ((py - minY) * invSize);
+
+	x = (x | (x << 8)) & 0x00FF00FF;
+	x = (x | (x << 4)) & 0x0F0F0F0F;
+	x = (x | (x << 2)) & 0x33333333;
+	x = (x | (x << 1)) & 0x55555555;
+
+	y = (y | (y << 8)) & 0x00FF00FF;
+	y = (y | (y << 4)) & 0x0F0F0F0F;
+	y = (y | (y << 2)) & 0x33333333;
+	y = (y | (y << 1)) & 0x55555555;
+
+	return(x | (y << 1));
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_sort_linked : Sort the z-order list.
+//-----------------------------------------------------------------------------
+//		Note :	Simon Tatham's linked list merge sort.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_sort_linked(TE3TessNode *theList)
+{	TE3TessNode		*p, *q, *e, *tail;
+	TQ3Uns32		i, numMerges, pSize, qSize, inSize;
+
+
+
+	// Merge runs of increasing size
+	inSize = 1;
+
+	do
+		{
+		p         = theList;
+		theList   = nullptr;
+		tail      = nullptr;
+		numMerges = 0;
+
+		while (p != nullptr)
+			{
+			numMerges++;
+			q     = p;
+			pSize = 0;
+
+			for (i = 0; i < inSize; i++)
+				{
+				pSize++;
+				q = q->nextZ;
+				if (q == nullptr)
+					break;
+				}
+
+			qSize = inSize;
+
+			while (pSize > 0 || (qSize > 0 && q != nullptr))
+				{
+				if (pSize != 0 && (qSize == 0 || q == nullptr || p->z <= q->z))
+					{
+					e = p;
+					p = p->nextZ;
+					pSize--;
+					}
+				else
+					{
+					e = q;
+					q = q->nextZ;
+					qSize--;
+					}
+
+				if (tail != nullptr)
+					tail->nextZ = e;
+				else
+					theList = e;
+
+				e->prevZ = tail;
+				tail     = e;
+				}
+
+			p = q;
+			}
+
+		tail->nextZ = nullptr;
+		inSize *= 2;
+		}
+	while (numMerges > 1);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_index_curve : Link the nodes in z-order.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_index_curve(TE3TessNode *start, double minX, double minY, double invSize)
+{	TE3TessNode		*p;
+
+
+
+	// Find the z-order of each node
+	p = start;
+	do
+		{
+		if (p->z == 0)
+			p->z = e3tessellate_z_order(p->x, p->y, minX, minY, invSize);
+
+		p->prevZ = p->prev;
+		p->nextZ = p->next;
+		p        = p->next;
+		}
+	while (p != start);
+
+
+
+	// And sort them
+	p->prevZ->nextZ = nullptr;
+	p->prevZ        = nullptr;
+
+	e3tessellate_sort_linked(p);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_is_ear : Is a node an ear?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_is_ear(const TE3TessNode *ear)
+{	const TE3TessNode	*a = ear->prev, *b = ear, *c = ear->next, *p;
+	double				x0, y0, x1, y1;
+
+
+
+	// Reflex nodes can't be ears
+	if (e3tessellate_node_area(a, b, c) >= 0.0)
+		return(false);
+
+
+
+	// Make sure no other points are inside the ear
+	x0 = std::min(a->x, std::min(b->x, c->x));
+	y0 = std::min(a->y, std::min(b->y, c->y));
+	x1 = std::max(a->x, std::max(b->x, c->x));
+	y1 = std::max(a->y, std::max(b->y, c->y));
+
+	for (p = c->next; p != a; p = p->next)
+		{
+		if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 && !e3tessellate_node_equals(p, a) &&
+			e3tessellate_point_in_triangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+			e3tessellate_node_area(p->prev, p, p->next) >= 0.0)
+			return(false);
+		}
+
+	return(true);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_is_ear_hashed : Is a node an ear, using the z-order list?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_is_ear_hashed(const TE3TessNode *ear, double minX, double minY, double invSize)
+{	const TE3TessNode	*a = ear->prev, *b = ear, *c = ear->next, *p, *n;
+	double				x0, y0, x1, y1;
+	TQ3Uns32			minZ, maxZ;
+
+
+
+	// Reflex nodes can't be ears
+	if (e3tessellate_node_area(a, b, c) >= 0.0)
+		return(false);
+
+
+
+	// Find the z-order range of the triangle
+	x0 = std::min(a->x, std::min(b->x, c->x));
+	y0 = std::min(a->y, std::min(b->y, c->y));
+	x1 = std::max(a->x, std::max(b->x, c->x));
+	y1 = std::max(a->y, std::max(b->y, c->y));
+
+	minZ = e3tessellate_z_order(x0, y0, minX, minY, invSize);
+	maxZ = e3tessellate_z_order(x1, y1, minX, minY, invSize);
+
+
+
+	// Look for points inside the triangle in both directions
+	#define E3TESSELLATE_IS_INSIDE(_p)																			\
+			((_p)->x >= x0 && (_p)->x <= x1 && (_p)->y >= y0 && (_p)->y <= y1 && (_p) != a && (_p) != c &&		\
+			 !e3tessellate_node_equals((_p), a) &&																\
+			 e3tessellate_point_in_triangle(a->x, a->y, b->x, b->y, c->x, c->y, (_p)->x, (_p)->y) &&			\
+			 e3tessellate_node_area((_p)->prev, (_p), (_p)->next) >= 0.0)
+
+	p = ear->prevZ;
+	n = ear->nextZ;
+
+	while (p != nullptr && p->z >= minZ && n != nullptr && n->z <= maxZ)
+		{
+		if (E3TESSELLATE_IS_INSIDE(p))
+			return(false);
+		p = p->prevZ;
+
+		if (E3TESSELLATE_IS_INSIDE(n))
+			return(false);
+		n = n->nextZ;
+		}
+
+	while (p != nullptr && p->z >= minZ)
+		{
+		if (E3TESSELLATE_IS_INSIDE(p))
+			return(false);
+		p = p->prevZ;
+		}
+
+	while (n != nullptr && n->z <= maxZ)
+		{
+		if (E3TESSELLATE_IS_INSIDE(n))
+			return(false);
+		n = n->nextZ;
+		}
+
+	#undef E3TESSELLATE_IS_INSIDE
+
+	return(true);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_segments_intersect : Do two segments intersect?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_segments_intersect(const TE3TessNode *p1, const TE3TessNode *q1,
+								const TE3TessNode *p2, const TE3TessNode *q2)
+{	double		o1, o2, o3, o4;
+
+
+
+	// Find the orientation of each point relative to the other segment
+	o1 = e3tessellate_node_area(p1, q1, p2);
+	o2 = e3tessellate_node_area(p1, q1, q2);
+	o3 = e3tessellate_node_area(p2, q2, p1);
+	o4 = e3tessellate_node_area(p2, q2, q1);
+
+	#define E3TESSELLATE_SIGN(_x)				(((_x) > 0.0) ? 1 : (((_x) < 0.0) ? -1 : 0))
+	#define E3TESSELLATE_ON_SEGMENT(_p, _q, _r)	((_q)->x <= std::max((_p)->x, (_r)->x) && (_q)->x >= std::min((_p)->x, (_r)->x) && \
+												 (_q)->y <= std::max((_p)->y, (_r)->y) && (_q)->y >= std::min((_p)->y, (_r)->y))
+
+	bool	doesIntersect = (E3TESSELLATE_SIGN(o1) != E3TESSELLATE_SIGN(o2) && E3TESSELLATE_SIGN(o3) != E3TESSELLATE_SIGN(o4)) ||
+							(o1 == 0.0 && E3TESSELLATE_ON_SEGMENT(p1, p2, q1)) ||
+							(o2 == 0.0 && E3TESSELLATE_ON_SEGMENT(p1, q2, q1)) ||
+							(o3 == 0.0 && E3TESSELLATE_ON_SEGMENT(p2, p1, q2)) ||
+							(o4 == 0.0 && E3TESSELLATE_ON_SEGMENT(p2, q1, q2));
+
+	#undef E3TESSELLATE_SIGN
+	#undef E3TESSELLATE_ON_SEGMENT
+
+	return(doesIntersect);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_locally_inside : Is a diagonal locally inside the polygon?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_locally_inside(const TE3TessNode *a, const TE3TessNode *b)
+{
+	if (e3tessellate_node_area(a->prev, a, a->next) < 0.0)
+		return(e3tessellate_node_area(a, b, a->next) >= 0.0 && e3tessellate_node_area(a, a->prev, b) >= 0.0);
+
+	return(e3tessellate_node_area(a, b, a->prev) < 0.0 || e3tessellate_node_area(a, a->next, b) < 0.0);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_middle_inside : Is the middle of a diagonal inside?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_middle_inside(const TE3TessNode *a, const TE3TessNode *b)
+{	const TE3TessNode	*p = a;
+	double				px, py;
+	bool				isInside;
+
+
+
+	// Count the crossings of a ray to the right of the middle point
+	px       = 0.5 * (a->x + b->x);
+	py       = 0.5 * (a->y + b->y);
+	isInside = false;
+
+	do
+		{
+		if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+			(px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+			isInside = !isInside;
+
+		p = p->next;
+		}
+	while (p != a);
+
+	return(isInside);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_is_valid_diagonal : Can two nodes be joined by a diagonal?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_is_valid_diagonal(const TE3TessNode *a, const TE3TessNode *b)
+{	const TE3TessNode	*p;
+
+
+
+	// The diagonal must not be an edge
+	if (a->next->i == b->i || a->prev->i == b->i)
+		return(false);
+
+
+
+	// It must not intersect any other edge
+	p = a;
+	do
+		{
+		if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+			e3tessellate_segments_intersect(p, p->next, a, b))
+			return(false);
+
+		p = p->next;
+		}
+	while (p != a);
+
+
+
+	// And it must be visible from both ends, without creating opposite-facing
+	// sectors, or be a zero-length join between two convex nodes
+	return((e3tessellate_locally_inside(a, b) && e3tessellate_locally_inside(b, a) &&
+			e3tessellate_middle_inside(a, b) &&
+			(e3tessellate_node_area(a->prev, a, b->prev) != 0.0 || e3tessellate_node_area(a, b->prev, b) != 0.0)) ||
+		   (e3tessellate_node_equals(a, b) &&
+			e3tessellate_node_area(a->prev, a, a->next) > 0.0 && e3tessellate_node_area(b->prev, b, b->next) > 0.0));
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_split_polygon : Split a polygon along a diagonal.
+//-----------------------------------------------------------------------------
+//		Note :	Links a to b, and a copy of b back to a copy of a. The result
+//				is either two polygons, or a single polygon bridged to a hole.
+//				The new edges along the diagonal are not on the boundary.
+//-----------------------------------------------------------------------------
+static TE3TessNode *
+e3tessellate_split_polygon(E3TessellateState *theState, TE3TessNode *a, TE3TessNode *b)
+{	TE3TessNode		*a2, *b2, *an, *bp;
+
+
+
+	// Copy the nodes
+	theState->nodes.push_back(*a);
+	a2 = &theState->nodes.back();
+
+	theState->nodes.push_back(*b);
+	b2 = &theState->nodes.back();
+
+	a2->prevZ = a2->nextZ = nullptr;
+	b2->prevZ = b2->nextZ = nullptr;
+	a2->z     = b2->z     = 0;
+
+	theState->vertexUses[a->i]++;
+	theState->vertexUses[b->i]++;
+
+
+
+	// Link them in
+	an = a->next;
+	bp = b->prev;
+
+	a->next  = b;
+	b->prev  = a;
+	a2->next = an;
+	an->prev = a2;
+	b2->next = a2;
+	a2->prev = b2;
+	bp->next = b2;
+	b2->prev = bp;
+
+	a->isBoundary  = false;
+	b2->isBoundary = false;
+
+	return(b2);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_cure_local_intersections : Clip small self-intersections.
+//-----------------------------------------------------------------------------
+static TE3TessNode *
+e3tessellate_cure_local_intersections(E3TessellateState *theState, TE3TessNode *start)
+{	TE3TessNode		*p, *a, *b;
+
+
+
+	// Cut off the triangle at each local self-intersection
+	p = start;
+	do
+		{
+		a = p->prev;
+		b = p->next->next;
+
+		if (!e3tessellate_node_equals(a, b) && e3tessellate_segments_intersect(a, p, p->next, b) &&
+			e3tessellate_locally_inside(a, b) && e3tessellate_locally_inside(b, a))
+			{
+			e3tessellate_add_triangle(theState, a, p, b, a->isBoundary, false, b->next == a && b->isBoundary);
+
+			e3tessellate_node_remove(theState, p);
+			e3tessellate_node_remove(theState, p->next);
+			a->isBoundary = false;
+
+			p = start = b;
+			}
+
+		p = p->next;
+		}
+	while (p != start);
+
+	return(e3tessellate_filter_points(theState, p, nullptr, false));
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_earcut_linked : Clip the ears from a polygon.
+//-----------------------------------------------------------------------------
+//		Note :	If we run out of ears, we try again after removing collinear
+//				points, then after curing local self-intersections, and
+//				finally by splitting the polygon in two.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_split_earcut(E3TessellateState *theState, TE3TessNode *start, double minX, double minY, double invSize);
+
+static void
+e3tessellate_earcut_linked(E3TessellateState *theState, TE3TessNode *ear,
+							double minX, double minY, double invSize, TQ3Uns32 thePass)
+{	TE3TessNode		*stop, *prev, *next;
+
+
+
+	// Index the polygon in z-order if it's large
+	if (ear == nullptr)
+		return;
+
+	if (thePass == 0 && invSize != 0.0)
+		e3tessellate_index_curve(ear, minX, minY, invSize);
+
+
+
+	// Clip the ears one by one
+	stop = ear;
+
+	while (ear->prev != ear->next)
+		{
+		prev = ear->prev;
+		next = ear->next;
+
+		if ((invSize != 0.0) ? e3tessellate_is_ear_hashed(ear, minX, minY, invSize) : e3tessellate_is_ear(ear))
+			{
+			e3tessellate_add_triangle(theState, prev, ear, next,
+										prev->isBoundary, ear->isBoundary,
+										next->next == prev && next->isBoundary);
+
+			e3tessellate_node_remove(theState, ear);
+			prev->isBoundary = false;
+
+
+			// Skipping the next vertex leads to fewer sliver triangles
+			ear  = next->next;
+			stop = next->next;
+			continue;
+			}
+
+		ear = next;
+
+
+		// If we've been all the way around without finding an ear, fall back
+		if (ear == stop)
+			{
+			if (thePass == 0)
+				e3tessellate_earcut_linked(theState, e3tessellate_filter_points(theState, ear, nullptr, false), minX, minY, invSize, 1);
+
+			else if (thePass == 1)
+				{
+				ear = e3tessellate_cure_local_intersections(theState, e3tessellate_filter_points(theState, ear, nullptr, false));
+				e3tessellate_earcut_linked(theState, ear, minX, minY, invSize, 2);
+				}
+
+			else if (thePass == 2)
+				e3tessellate_split_earcut(theState, ear, minX, minY, invSize);
+
+			break;
+			}
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_split_earcut : Split a polygon in two and clip each half.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_split_earcut(E3TessellateState *theState, TE3TessNode *start, double minX, double minY, double invSize)
+{	TE3TessNode		*a, *b, *c;
+
+
+
+	// Look for a diagonal which divides the polygon in two
+	a = start;
+	do
+		{
+		for (b = a->next->next; b != a->prev; b = b->next)
+			{
+			if (a->i != b->i && e3tessellate_is_valid_diagonal(a, b))
+				{
+				c = e3tessellate_split_polygon(theState, a, b);
+
+				a = e3tessellate_filter_points(theState, a, a->next, true);
+				c = e3tessellate_filter_points(theState, c, c->next, true);
+
+				e3tessellate_earcut_linked(theState, a, minX, minY, invSize, 0);
+				e3tessellate_earcut_linked(theState, c, minX, minY, invSize, 0);
+				return;
+				}
+			}
+
+		a = a->next;
+		}
+	while (a != start);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_sector_contains_sector : Does one sector contain another?
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_sector_contains_sector(const TE3TessNode *m, const TE3TessNode *p)
+{
+	return(e3tessellate_node_area(m->prev, m, p->prev) < 0.0 && e3tessellate_node_area(p->next, m, m->next) < 0.0);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_find_hole_bridge : Find a node to bridge a hole to.
+//-----------------------------------------------------------------------------
+//		Note :	David Eberly's algorithm: cast a ray left from the leftmost
+//				point of the hole, and connect to the end of the nearest edge
+//				it hits, unless another reflex vertex blocks the view.
+//-----------------------------------------------------------------------------
+static TE3TessNode *
+e3tessellate_find_hole_bridge(TE3TessNode *hole, TE3TessNode *outerNode)
+{	TE3TessNode		*p, *m, *stop;
+	double			hx, hy, qx, x, mx, my, tanMin, theTan;
+
+
+
+	// Find the nearest edge to the left of the hole
+	p  = outerNode;
+	m  = nullptr;
+	hx = hole->x;
+	hy = hole->y;
+	qx = -HUGE_VAL;
+
+	do
+		{
+		if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+			{
+			x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+			if (x <= hx && x > qx)
+				{
+				qx = x;
+				m  = (p->x < p->next->x) ? p : p->next;
+
+				if (x == hx)
+					return(m);
+				}
+			}
+
+		p = p->next;
+		}
+	while (p != outerNode);
+
+	if (m == nullptr)
+		return(nullptr);
+
+
+
+	// Look for points inside the triangle of the hole point, the intersection,
+	// and the end point; if there are any, use the one at the smallest angle
+	stop   = m;
+	mx     = m->x;
+	my     = m->y;
+	tanMin = HUGE_VAL;
+	p      = m;
+
+	do
+		{
+		if (hx >= p->x && p->x >= mx && hx != p->x &&
+			e3tessellate_point_in_triangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+			{
+			theTan = fabs(hy - p->y) / (hx - p->x);
+
+			if (e3tessellate_locally_inside(p, hole) &&
+				(theTan < tanMin || (theTan == tanMin && (p->x > m->x || (p->x == m->x && e3tessellate_sector_contains_sector(m, p))))))
+				{
+				m      = p;
+				tanMin = theTan;
+				}
+			}
+
+		p = p->next;
+		}
+	while (p != stop);
+
+	return(m);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_splice_hole : Splice a hole in where it touches the outline.
+//-----------------------------------------------------------------------------
+//		Note :	Holes which share a vertex with the outline are joined to it at
+//				that vertex with a zero-length bridge, since a bridge from their
+//				leftmost point could pass through the shared vertex.
+//
+//				Returns false if the hole doesn't touch the outline.
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_splice_hole(E3TessellateState *theState, TE3TessNode *&outerNode,
+							TE3TessNode *theHole, std::vector<bool> &isOnOuter)
+{	TE3TessNode		*p, *q, *theBridge, *bridgeReverse;
+
+
+
+	// Find a vertex of the hole which is on the outline
+	q = theHole;
+	while (!isOnOuter[q->i])
+		{
+		q = q->next;
+		if (q == theHole)
+			return(false);
+		}
+
+
+
+	// Find where it occurs on the outline - if the outline passes through it
+	// more than once, use the sector which contains the hole
+	theBridge = nullptr;
+	p         = outerNode;
+
+	do
+		{
+		if (p->i == q->i)
+			{
+			if (theBridge == nullptr ||
+				(e3tessellate_locally_inside(p, q->next) && e3tessellate_locally_inside(p, q->prev)))
+				theBridge = p;
+			}
+
+		p = p->next;
+		}
+	while (p != outerNode);
+
+	if (theBridge == nullptr)
+		return(false);
+
+
+
+	// Mark the hole as part of the outline, and splice it in
+	p = theHole;
+	do
+		{
+		isOnOuter[p->i] = true;
+		p = p->next;
+		}
+	while (p != theHole);
+
+	bridgeReverse = e3tessellate_split_polygon(theState, theBridge, q);
+	e3tessellate_filter_points(theState, bridgeReverse, bridgeReverse->next, true);
+	outerNode = e3tessellate_filter_points(theState, theBridge, theBridge->next, true);
+
+	return(true);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_eliminate_holes : Bridge the holes into the outer polygon.
+//-----------------------------------------------------------------------------
+static TE3TessNode *
+e3tessellate_eliminate_holes(E3TessellateState *theState, const std::vector<TE3TessLoop> &theLoops,
+								const std::vector<TQ3Uns32> &theHoles, TE3TessNode *outerNode)
+{	std::vector<TE3TessNode*>		theLists, theQueue;
+	TE3TessNode						*leftMost, *p, *theBridge, *bridgeReverse;
+	std::vector<bool>				isOnOuter;
+	bool							didSplice;
+	TQ3Uns32						n;
+
+
+
+	// Link each hole
+	for (n = 0; n < theHoles.size(); n++)
+		{
+		p = e3tessellate_linked_list(theState, theLoops[theHoles[n]], false);
+		if (p == nullptr)
+			continue;
+
+		if (p == p->next)
+			p->steiner = true;
+
+		theLists.push_back(p);
+		}
+
+
+
+	// Splice in the holes which touch the outline, until none are left
+	isOnOuter.assign(theState->vertices.size(), false);
+
+	p = outerNode;
+	do
+		{
+		isOnOuter[p->i] = true;
+		p = p->next;
+		}
+	while (p != outerNode);
+
+	do
+		{
+		didSplice = false;
+
+		for (n = 0; n < theLists.size(); n++)
+			{
+			if (theLists[n] != nullptr && e3tessellate_splice_hole(theState, outerNode, theLists[n], isOnOuter))
+				{
+				theLists[n] = nullptr;
+				didSplice   = true;
+				}
+			}
+		}
+	while (didSplice);
+
+
+
+	// Find the leftmost point of the remaining holes
+	for (n = 0; n < theLists.size(); n++)
+		{
+		if (theLists[n] == nullptr)
+			continue;
+
+		leftMost = p = theLists[n];
+		do
+			{
+			if (p->x < leftMost->x || (p->x == leftMost->x && p->y < leftMost->y))
+				leftMost = p;
+
+			p = p->next;
+			}
+		while (p != theLists[n]);
+
+		theQueue.push_back(leftMost);
+		}
+
+
+
+	// Bridge them from left to right
+	std::sort(theQueue.begin(), theQueue.end(),
+				[](const TE3TessNode *a, const TE3TessNode *b) { return(a->x < b->x); });
+
+	for (n = 0; n < theQueue.size(); n++)
+		{
+		theBridge = e3tessellate_find_hole_bridge(theQueue[n], outerNode);
+		if (theBridge == nullptr)
+			continue;
+
+		bridgeReverse = e3tessellate_split_polygon(theState, theBridge, theQueue[n]);
+		e3tessellate_filter_points(theState, bridgeReverse, bridgeReverse->next, true);
+		outerNode = e3tessellate_filter_points(theState, theBridge, theBridge->next, true);
+		}
+
+	return(outerNode);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_can_split_pinch : Can a polygon be split at a pinch?
+//-----------------------------------------------------------------------------
+//		Note :	Splitting at a and b gives one polygon which leaves the point
+//				along a's next edge and returns along b's previous edge, and
+//				another using the other two edges. They must not cross, so
+//				the edges of one can't interleave with those of the other
+//				around the point.
+//-----------------------------------------------------------------------------
+static bool
+e3tessellate_can_split_pinch(const TE3TessNode *a, const TE3TessNode *b)
+{	double		theStart, theEnd, angle1, angle2;
+
+
+
+	// Measure the angles counter-clockwise from a's next edge
+	theStart = atan2(a->next->y - a->y, a->next->x - a->x);
+	theEnd   = atan2(b->prev->y - b->y, b->prev->x - b->x) - theStart;
+	angle1   = atan2(b->next->y - b->y, b->next->x - b->x) - theStart;
+	angle2   = atan2(a->prev->y - a->y, a->prev->x - a->x) - theStart;
+
+	if (theEnd < 0.0)
+		theEnd += 2.0 * kQ3Pi;
+
+	if (angle1 < 0.0)
+		angle1 += 2.0 * kQ3Pi;
+
+	if (angle2 < 0.0)
+		angle2 += 2.0 * kQ3Pi;
+
+
+
+	// The other polygon's edges must both be on the same side
+	return((angle1 < theEnd) == (angle2 < theEnd));
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_split_pinches : Split a polygon where it touches itself.
+//-----------------------------------------------------------------------------
+//		Note :	Loops which meet at a vertex leave the polygon pinched at that
+//				vertex after the holes are joined in. Where both sides of the
+//				pinch enclose area, they are split into separate polygons that
+//				the ear clipping can handle independently.
+//
+//				A side which is a hole spliced in at the vertex has negative
+//				area and is left alone.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_split_pinches(TE3TessNode *outerNode, std::vector<TE3TessNode*> &thePolygons)
+{	std::vector<std::pair<TQ3Uns32, TQ3Uns32> >	theVisits;
+	std::vector<TE3TessNode*>					theNodes, pendingPolygons;
+	std::vector<double>							theAreas;
+	TE3TessNode									*start, *p, *a, *b, *aPrev;
+	TQ3Uns32									n, m, numNodes;
+	double										theArea;
+
+
+
+	// Check each polygon in turn
+	pendingPolygons.push_back(outerNode);
+
+	while (!pendingPolygons.empty())
+		{
+		start = pendingPolygons.back();
+		pendingPolygons.pop_back();
+
+
+
+		// Collect the nodes, and the area swept out up to each one
+		theNodes.clear();
+		theAreas.clear();
+		theVisits.clear();
+
+		theArea = 0.0;
+		p       = start;
+
+		do
+			{
+			theVisits.push_back(std::make_pair(p->i, (TQ3Uns32) theNodes.size()));
+			theNodes.push_back(p);
+			theAreas.push_back(theArea);
+
+			theArea += e3tessellate_cross(p->x, p->y, p->next->x, p->next->y);
+			p        = p->next;
+			}
+		while (p != start);
+
+		numNodes = (TQ3Uns32) theNodes.size();
+		theAreas.push_back(theArea);
+
+
+
+		// Look for a vertex which is visited twice with area on both sides
+		//
+		// Since both visits are at the same point, the area swept out between
+		// them is the area of the polygon they cut off.
+		std::sort(theVisits.begin(), theVisits.end());
+		a = b = nullptr;
+
+		for (n = 0; n < numNodes && a == nullptr; n++)
+			{
+			for (m = n + 1; m < numNodes && theVisits[m].first == theVisits[n].first; m++)
+				{
+				theArea = theAreas[theVisits[m].second] - theAreas[theVisits[n].second];
+
+				if (theArea > 0.0 && theAreas[numNodes] - theArea > 0.0 &&
+					e3tessellate_can_split_pinch(theNodes[theVisits[n].second], theNodes[theVisits[m].second]))
+					{
+					a = theNodes[theVisits[n].second];
+					b = theNodes[theVisits[m].second];
+					break;
+					}
+				}
+			}
+
+
+
+		// Split the polygon in two if we found one
+		if (a == nullptr)
+			thePolygons.push_back(start);
+		else
+			{
+			aPrev          = a->prev;
+			b->prev->next  = a;
+			a->prev        = b->prev;
+			aPrev->next    = b;
+			b->prev        = aPrev;
+
+			pendingPolygons.push_back(a);
+			pendingPolygons.push_back(b);
+			}
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_triangulate_region : Triangulate a region and its holes.
+//-----------------------------------------------------------------------------
+static void
+e3tessellate_triangulate_region(E3TessellateState *theState, const std::vector<TE3TessLoop> &theLoops,
+								TQ3Uns32 theOuter, const std::vector<TQ3Uns32> &theHoles)
+{	double						minX, minY, maxX, maxY, invSize;
+	std::vector<TE3TessNode*>	thePolygons;
+	TE3TessNode					*outerNode;
+	TQ3Uns32					n, numPoints;
+
+
+
+	// Link the outer loop and bridge in the holes
+	outerNode = e3tessellate_linked_list(theState, theLoops[theOuter], true);
+	if (outerNode == nullptr || outerNode->next == outerNode->prev)
+		return;
+
+	numPoints = (TQ3Uns32) theLoops[theOuter].vertices.size();
+	for (n = 0; n < theHoles.size(); n++)
+		numPoints += (TQ3Uns32) theLoops[theHoles[n]].vertices.size();
+
+	if (!theHoles.empty())
+		outerNode = e3tessellate_eliminate_holes(theState, theLoops, theHoles, outerNode);
+
+
+
+	// Use a z-order index for large polygons
+	invSize = 0.0;
+	minX    = minY = 0.0;
+
+	if (numPoints > kZOrderThreshold)
+		{
+		minX    = theLoops[theOuter].minX;
+		minY    = theLoops[theOuter].minY;
+		maxX    = theLoops[theOuter].maxX;
+		maxY    = theLoops[theOuter].maxY;
+		invSize = std::max(maxX - minX, maxY - minY);
+		invSize = (invSize != 0.0) ? kZOrderGridSize / invSize : 0.0;
+		}
+
+
+
+	// Clip the ears
+	e3tessellate_split_pinches(outerNode, thePolygons);
+
+	for (n = 0; n < thePolygons.size(); n++)
+		e3tessellate_earcut_linked(theState, thePolygons[n], minX, minY, invSize, 0);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_gather_vertex_attribute : Gather vertex attributes.
+//-----------------------------------------------------------------------------
+static TQ3AttributeSet
+e3tessellate_gather_vertex_attribute(const void *userData, TQ3Uns32 setIndex)
+{	const E3TessellateState		*theState = (const E3TessellateState *) userData;
+
+
+
+	// Validate our parameters
+	Q3_REQUIRE_OR_RESULT(setIndex < theState->triMeshVertexList.size(), nullptr);
+
+
+
+	// Return the appropriate attribute set
+	return(theState->triMeshVertexList[setIndex]->attributeSet);
+}
+
+
+
+
+
+//=============================================================================
+//      e3tessellate_create_trimesh : Create the TriMesh from the triangles.
+//-----------------------------------------------------------------------------
+//		Note :	Only the vertices used by the triangles are kept.
+//-----------------------------------------------------------------------------
+static TQ3GeometryObject
+e3tessellate_create_trimesh(E3TessellateState *theState, TQ3AttributeSet triMeshAttributes)
+{	std::vector<TQ3Uns32>		vertexRemap;
+	TQ3TriMeshAttributeData		*theAttributes;
+	TQ3Uns32					n, m, numPoints;
+	TQ3Point3D					*thePoints;
+	TQ3GeometryObject			theTriMesh;
+
+
+
+	// Number the vertices which are in use
+	vertexRemap.assign(theState->vertices.size(), kQ3ArrayIndexNULL);
+
+	for (n = 0; n < theState->triangles.size(); n++)
+		{
+		for (m = 0; m < 3; m++)
+			{
+			TQ3Uns32	&theIndex = theState->triangles[n].pointIndices[m];
+
+			if (vertexRemap[theIndex] == kQ3ArrayIndexNULL)
+				{
+				vertexRemap[theIndex] = (TQ3Uns32) theState->triMeshVertexList.size();
+				theState->triMeshVertexList.push_back(theState->vertices[theIndex].theVertex);
+				}
+
+			theIndex = vertexRemap[theIndex];
+			}
+		}
+
+	for (n = 0; n < theState->edges.size(); n++)
+		{
+		theState->edges[n].pointIndices[0] = vertexRemap[theState->edges[n].pointIndices[0]];
+		theState->edges[n].pointIndices[1] = vertexRemap[theState->edges[n].pointIndices[1]];
+		}
+
+
+
+	// Allocate the vertex points and attributes arrays
+	numPoints = (TQ3Uns32) theState->triMeshVertexList.size();
+	thePoints = (TQ3Point3D *) Q3Memory_Allocate(static_cast<TQ3Uns32>(numPoints * sizeof(TQ3Point3D)));
+	
+	if (thePoints == nullptr)
+		return nullptr;
+	
+	theAttributes = (TQ3TriMeshAttributeData *) Q3Memory_Allocate(kQ3AttributeTypeNumTypes     * sizeof(TQ3TriMeshAttributeData));
+	
+	if (theAttributes == nullptr)
+		{
+		Q3Memory_Free( &thePoints );
+		return(nullptr);
+		}
+
+
+
+	// Set up the triangles, edges, and points
+	theState->triMeshData.numTriangles = (TQ3Uns32) theState->triangles.size();
+	theState->triMeshData.triangles    = &theState->triangles[0];
+	theState->triMeshData.numEdges     = (TQ3Uns32) theState->edges.size();
+	theState->triMeshData.edges        = theState->edges.empty() ? nullptr : &theState->edges[0];
+	theState->triMeshData.numPoints    = numPoints;
+	theState->triMeshData.points       = thePoints;
 
 	for (n = 0; n < numPoints; n++)
 		theState->triMeshData.points[n] = theState->triMeshVertexList[n]->point;
@@ -759,39 +2826,39 @@ e3tessellate_create_trimesh(E3TessellateState *theState, TQ3AttributeSet triMesh
 	// Set up the attributes
 	n = 0;
 	
-	if (E3TriMeshAttribute_GatherArray(theState->numTriMeshVertices, e3tessellate_gather_vertex_attribute, theState,
+	if (E3TriMeshAttribute_GatherArray(numPoints, e3tessellate_gather_vertex_attribute, theState,
 											&theAttributes[n], kQ3AttributeTypeSurfaceUV))
 		n++;
 	else
-	if (E3TriMeshAttribute_GatherArray(theState->numTriMeshVertices, e3tessellate_gather_vertex_attribute, theState,
+	if (E3TriMeshAttribute_GatherArray(numPoints, e3tessellate_gather_vertex_attribute, theState,
 											&theAttributes[n], kQ3AttributeTypeShadingUV))
 		n++;
 
-	if (E3TriMeshAttribute_GatherArray(theState->numTriMeshVertices, e3tessellate_gather_vertex_attribute, theState,
+	if (E3TriMeshAttribute_GatherArray(numPoints, e3tessellate_gather_vertex_attribute, theState,
 											&theAttributes[n], kQ3AttributeTypeNormal))
 		n++;
 
-	if (E3TriMeshAttribute_GatherArray(theState->numTriMeshVertices, e3tessellate_gather_vertex_attribute, theState,
+	if (E3TriMeshAttribute_GatherArray(numPoints, e3tessellate_gather_vertex_attribute, theState,
 											&theAttributes[n], kQ3AttributeTypeAmbientCoefficient))
 		n++;
 
-	if (E3TriMeshAttribute_GatherArray(theState->numTriMeshVertices, e3tessellate_gather_vertex_attribute, theState,
+	if (E3TriMeshAttribute_GatherArray(numPoints, e3tessellate_gather_vertex_attribute, theState,
 											&theAttributes[n], kQ3AttributeTypeDiffuseColor))
 		n++;
 		
-	if (E3TriMeshAttribute_GatherArray(theState->numTriMeshVertices, e3tessellate_gather_vertex_attribute, theState,
+	if (E3TriMeshAttribute_GatherArray(numPoints, e3tessellate_gather_vertex_attribute, theState,
 											&theAttributes[n], kQ3AttributeTypeSpecularColor))
 		n++;
 		
-	if (E3TriMeshAttribute_GatherArray(theState->numTriMeshVertices, e3tessellate_gather_vertex_attribute, theState,
+	if (E3TriMeshAttribute_GatherArray(numPoints, e3tessellate_gather_vertex_attribute, theState,
 											&theAttributes[n], kQ3AttributeTypeSpecularControl))
 		n++;
 		
-	if (E3TriMeshAttribute_GatherArray(theState->numTriMeshVertices, e3tessellate_gather_vertex_attribute, theState,
+	if (E3TriMeshAttribute_GatherArray(numPoints, e3tessellate_gather_vertex_attribute, theState,
 											&theAttributes[n], kQ3AttributeTypeTransparencyColor))
 		n++;
 		
-	if (E3TriMeshAttribute_GatherArray(theState->numTriMeshVertices, e3tessellate_gather_vertex_attribute, theState,
+	if (E3TriMeshAttribute_GatherArray(numPoints, e3tessellate_gather_vertex_attribute, theState,
 											&theAttributes[n], kQ3AttributeTypeSurfaceTangent))
 		n++;
 	
@@ -822,18 +2889,6 @@ e3tessellate_dispose_state(E3TessellateState *theState)
 
 
 	// Dispose of the TriMesh attributes
-	for (n = 0; n < theState->triMeshData.numTriangleAttributeTypes; n++)
-		{
-		Q3Memory_Free(&theState->triMeshData.triangleAttributeTypes[n].data);
-		Q3Memory_Free(&theState->triMeshData.triangleAttributeTypes[n].attributeUseArray);
-		}
-	
-	for (n = 0; n < theState->triMeshData.numEdgeAttributeTypes; n++)
-		{
-		Q3Memory_Free(&theState->triMeshData.edgeAttributeTypes[n].data);
-		Q3Memory_Free(&theState->triMeshData.edgeAttributeTypes[n].attributeUseArray);
-		}
-
 	for (n = 0; n < theState->triMeshData.numVertexAttributeTypes; n++)
 		{
 		Q3Memory_Free(&theState->triMeshData.vertexAttributeTypes[n].data);
@@ -843,27 +2898,20 @@ e3tessellate_dispose_state(E3TessellateState *theState)
 
 
 	// Dispose of the TriMesh data
-	Q3Memory_Free(&theState->triMeshData.triangles);
-	Q3Memory_Free(&theState->triMeshData.triangleAttributeTypes);
-	Q3Memory_Free(&theState->triMeshData.edges);
-	Q3Memory_Free(&theState->triMeshData.edgeAttributeTypes);
 	Q3Memory_Free(&theState->triMeshData.points);
 	Q3Memory_Free(&theState->triMeshData.vertexAttributeTypes);
 
 
 
-	// Dispose of the tessellator state
-	for (n = 0; n < theState->numTempVertices; n++)
+	// Dispose of the combined vertices
+	for (n = 0; n < theState->combinedVertices.size(); n++)
 	{
-		TQ3AttributeSet atts = theState->tempVertexList[n]->attributeSet;
+		TQ3AttributeSet atts = theState->combinedVertices[n]->attributeSet;
 		if (atts != nullptr)
 			Q3Object_Dispose( atts );
 		
-		Q3Memory_Free(&theState->tempVertexList[n]);
+		Q3Memory_Free(&theState->combinedVertices[n]);
 	}
-	
-	Q3Memory_Free(&theState->triMeshVertexList);
-	Q3Memory_Free(&theState->tempVertexList);
 }
 
 
@@ -881,6 +2929,12 @@ e3tessellate_dispose_state(E3TessellateState *theState)
 //
 //				Overlapping contours form holes, with the even-odd rule used to
 //				determine which portion of the polygon is to be removed.
+//
+//				Where edges cross, we rebuild the contours into loops which
+//				don't cross and create new vertices at the intersections. The
+//				loops are then nested to find the holes in each region, and
+//				the holes are bridged into their region before it is ear
+//				clipped.
 //-----------------------------------------------------------------------------
 TQ3Object
 E3Tessellate_Contours(TQ3Uns32 numContours,
@@ -891,72 +2945,68 @@ E3Tessellate_Contours(TQ3Uns32 numContours,
 	Q3_REQUIRE_OR_RESULT(numContours >= 1,          nullptr);
 	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(theContours), nullptr);
 
-	GLdouble				vertCoords[3];
-	TQ3Vertex3D				*theVertex;
-	TQ3GeometryObject		theTriMesh;
-	GLUtriangulatorObj		*theTess;
-	E3TessellateState		theState;
-	TQ3Uns32				n, m;
+	std::vector<TE3TessLoop>		theLoops;
+	std::vector<TE3TessEdge>		theEdges;
+	std::vector<TE3TessSplit>		theSplits;
+	std::vector<TQ3Uns32>			theHoles;
+	std::vector< std::vector<TQ3Uns32> >	regionHoles;
+	TQ3GeometryObject				theTriMesh;
+	E3TessellateState				theState;
+	bool							hasSharedVertices;
+	TQ3Uns32						n;
 
 
 
+	// Set up our state
+	Q3Memory_Clear(&theState.triMeshData, sizeof(theState.triMeshData));
+	theTriMesh = nullptr;
 
 
 
-	// Create the tessellator
-	theTess = gluNewTess();
-	if (theTess == nullptr)
-		{
-		E3ErrorManager_PostError(kQ3ErrorOutOfMemory, kQ3False);
+	// Project the contours onto their plane
+	if (!e3tessellate_project_contours(&theState, numContours, theContours, theLoops, hasSharedVertices))
 		return(nullptr);
-		}
 
-	// Set it up
-	gluTessProperty(theTess, GLU_TESS_WINDING_RULE,   GLU_TESS_WINDING_ODD);
-	gluTessCallback(theTess, GLU_TESS_BEGIN_DATA,     (_GLUfuncptr) e3tessellate_callback_begin);
-	gluTessCallback(theTess, GLU_TESS_END_DATA,       (_GLUfuncptr) e3tessellate_callback_end);
-	gluTessCallback(theTess, GLU_TESS_EDGE_FLAG_DATA, (_GLUfuncptr) e3tessellate_callback_edge);
-	gluTessCallback(theTess, GLU_TESS_VERTEX_DATA,    (_GLUfuncptr) e3tessellate_callback_vertex);
-	gluTessCallback(theTess, GLU_TESS_ERROR_DATA,     (_GLUfuncptr) e3tessellate_callback_error);
-	gluTessCallback(theTess, GLU_TESS_COMBINE_DATA,   (_GLUfuncptr) e3tessellate_callback_combine);
 
 
+	// Split any edges which intersect, and rebuild the loops so they don't cross
+	e3tessellate_find_splits(&theState, theLoops, theEdges, theSplits);
 
-	// Set up our state
-	Q3Memory_Clear(&theState, sizeof(theState));
-	theTriMesh = nullptr;
+	if (!theSplits.empty() || hasSharedVertices)
+		e3tessellate_rebuild_loops(&theState, theLoops, theEdges, theSplits);
 
 
 
-	// Feed the contours into the tessellator
-	gluTessBeginPolygon(theTess, &theState);
-	for (n = 0; n < numContours; n++)
+	// Find the holes in each region
+	e3tessellate_nest_loops(&theState, theLoops);
+	theState.vertexUses.assign(theState.vertices.size(), 0);
+
+	regionHoles.resize(theLoops.size());
+	for (n = 0; n < theLoops.size(); n++)
 		{
-         gluTessBeginContour(theTess);
-         for (m = 0; m < theContours[n].numVertices; m++)
-         	{
-         	theVertex     = &theContours[n].vertices[m];
-         	vertCoords[0] = (GLdouble) theVertex->point.x;
-         	vertCoords[1] = (GLdouble) theVertex->point.y;
-         	vertCoords[2] = (GLdouble) theVertex->point.z;
+		if ((theLoops[n].depth % 2) != 0)
+			regionHoles[theLoops[n].parent].push_back(n);
+		}
 
-			gluTessVertex(theTess, vertCoords, theVertex);
-			}
-		gluTessEndContour(theTess);
+
+
+	// Triangulate the regions
+	for (n = 0; n < theLoops.size(); n++)
+		{
+		if ((theLoops[n].depth % 2) == 0)
+			e3tessellate_triangulate_region(&theState, theLoops, n, regionHoles[n]);
 		}
-	gluTessEndPolygon(theTess);
 
 
 
 	// Create the TriMesh if all went well
-	if ( (theState.errorState == GL_NO_ERROR) && (theState.numTriMeshVertices > 0) )
+	if (!theState.triangles.empty())
 		theTriMesh = e3tessellate_create_trimesh(&theState, theAttributes);
 
 
 
 	// Clean up
 	e3tessellate_dispose_state(&theState);
-	gluDeleteTess(theTess);
 	
 	return(theTriMesh);
 }
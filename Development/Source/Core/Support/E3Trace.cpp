@@ -0,0 +1,362 @@
+/*  NAME:
+        E3Trace.cpp
+
+    DESCRIPTION:
+        Quesa trace event recording.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2021, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+#include "E3Trace.h"
+#include "E3ClassTree.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <functional>
+#include <cstdio>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Number of events held in the ring buffer, must be a power of 2
+const TQ3Uns32 kTraceBufferSize								= 65536;
+const TQ3Uns32 kTraceBufferMask								= kTraceBufferSize - 1;
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+// A completed event, times are in nanoseconds since sBaseTime.
+//
+// The sequence is 0 while the event is being filled in, and 1 more than the
+// index the event was recorded at once it is complete.
+struct TE3TraceEvent
+{
+	std::atomic<uint64_t>	sequence;
+	const char*			name;
+	TQ3ObjectType		objectType;
+	TQ3Uns32			threadID;
+	uint64_t			startTime;
+	uint64_t			duration;
+};
+
+
+
+
+
+//=============================================================================
+//      Global variables
+//-----------------------------------------------------------------------------
+std::atomic_bool		gE3TraceEnabled( false );
+
+
+
+
+
+//=============================================================================
+//      Static variables
+//-----------------------------------------------------------------------------
+// Writers claim a slot by incrementing sNextEvent, so recording never blocks.
+// Once the buffer wraps the oldest events are overwritten. Indices are never
+// reused, clearing just moves sFirstEvent up to sNextEvent.
+//
+// The base time is reset when recording is turned on with an empty buffer,
+// and is held in nanoseconds of the steady clock.
+static TE3TraceEvent							sEvents[ kTraceBufferSize ];
+static std::atomic<uint64_t>					sNextEvent( 0 );
+static std::atomic<uint64_t>					sFirstEvent( 0 );
+static std::atomic<int64_t>						sBaseTime( 0 );
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      e3trace_thread_id : Get a small ID for the current thread.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3trace_thread_id( void )
+{
+	return (TQ3Uns32) ( std::hash<std::thread::id>()( std::this_thread::get_id() ) & 0x7FFFFFFF );
+}
+
+
+
+
+
+//=============================================================================
+//      e3trace_clock_now : Get the steady clock time in nanoseconds.
+//-----------------------------------------------------------------------------
+static int64_t
+e3trace_clock_now( void )
+{
+	return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+
+
+
+//=============================================================================
+//      e3trace_copy_event : Copy a complete event out of the buffer.
+//-----------------------------------------------------------------------------
+//		Note :	Returns false if the event at that index has not been completed
+//				yet, or has since been overwritten by a later event.
+//-----------------------------------------------------------------------------
+static bool
+e3trace_copy_event( uint64_t inIndex, TE3TraceEvent& outEvent )
+{
+	const TE3TraceEvent&	theEvent = sEvents[ inIndex & kTraceBufferMask ];
+
+
+
+	// Check the event is complete, then check it was not replaced as we copied it
+	if (theEvent.sequence.load( std::memory_order_acquire ) != inIndex + 1)
+		return false;
+
+	outEvent.name       = theEvent.name;
+	outEvent.objectType = theEvent.objectType;
+	outEvent.threadID   = theEvent.threadID;
+	outEvent.startTime  = theEvent.startTime;
+	outEvent.duration   = theEvent.duration;
+
+	std::atomic_thread_fence( std::memory_order_acquire );
+	return (theEvent.sequence.load( std::memory_order_relaxed ) == inIndex + 1) &&
+		   (outEvent.name != nullptr);
+}
+
+
+
+
+
+//=============================================================================
+//      e3trace_event_name : Append the display name of an event.
+//-----------------------------------------------------------------------------
+static void
+e3trace_event_name( const TE3TraceEvent& theEvent, std::string& ioJSON )
+{
+	ioJSON += theEvent.name;
+	
+	if (theEvent.objectType != 0)
+	{
+		E3ClassInfoPtr theClass = E3ClassTree::GetClass( theEvent.objectType );
+		
+		ioJSON += ": ";
+		if (theClass != nullptr)
+			ioJSON += theClass->GetName();
+		else
+		{
+			char	typeBuffer[16];
+			snprintf( typeBuffer, sizeof(typeBuffer), "0x%08X", (unsigned int) theEvent.objectType );
+			ioJSON += typeBuffer;
+		}
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3Trace_SetState : Turn event recording on or off.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Trace_SetState( TQ3Boolean isEnabled )
+{
+	// Start the clock for a new trace
+	if (isEnabled && ! E3Trace_IsEnabled() && sFirstEvent.load() == sNextEvent.load())
+		sBaseTime.store( e3trace_clock_now() );
+
+	gE3TraceEnabled.store( isEnabled != kQ3False );
+	return kQ3Success;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Trace_GetState : Test whether events are being recorded.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Trace_GetState( void )
+{
+	return E3Trace_IsEnabled() ? kQ3True : kQ3False;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Trace_Clear : Discard the recorded events.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Trace_Clear( void )
+{
+	sFirstEvent.store( sNextEvent.load() );
+	return kQ3Success;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Trace_Now : Get the current trace time.
+//-----------------------------------------------------------------------------
+uint64_t
+E3Trace_Now( void )
+{
+	return (uint64_t) (e3trace_clock_now() - sBaseTime.load( std::memory_order_relaxed ));
+}
+
+
+
+
+
+//=============================================================================
+//      E3Trace_Record : Record an event.
+//-----------------------------------------------------------------------------
+void
+E3Trace_Record( const char *inName, TQ3ObjectType inObjectType, uint64_t inStartTime )
+{
+	uint64_t		endTime  = E3Trace_Now();
+	uint64_t		theIndex = sNextEvent.fetch_add( 1, std::memory_order_relaxed );
+	TE3TraceEvent&	theEvent = sEvents[ theIndex & kTraceBufferMask ];
+
+
+
+	// Mark the slot as incomplete while we fill it in
+	theEvent.sequence.store( 0, std::memory_order_relaxed );
+	std::atomic_thread_fence( std::memory_order_release );
+
+	theEvent.name       = inName;
+	theEvent.objectType = inObjectType;
+	theEvent.threadID   = e3trace_thread_id();
+	theEvent.startTime  = inStartTime;
+	theEvent.duration   = (endTime > inStartTime) ? endTime - inStartTime : 0;
+
+	theEvent.sequence.store( theIndex + 1, std::memory_order_release );
+}
+
+
+
+
+
+//=============================================================================
+//      E3Trace_Write : Write the recorded events as Chrome trace JSON.
+//-----------------------------------------------------------------------------
+//		Note :	The output can be loaded by chrome://tracing or Perfetto.
+//
+//				Events which are still being recorded, or are overwritten
+//				while we are writing, are skipped. Tracing should normally be
+//				turned off first so that the trace is complete.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Trace_Write( TQ3StorageObject storage, TQ3Uns32 *bytesWritten )
+{
+	uint64_t		lastEvent, firstEvent, n;
+	TE3TraceEvent	theEvent;
+	char			eventBuffer[128];
+	const char*		separator = "";
+	std::string		theJSON;
+
+
+
+	// Find the events still held in the buffer
+	*bytesWritten = 0;
+	lastEvent     = sNextEvent.load();
+	firstEvent    = sFirstEvent.load();
+	if (lastEvent - firstEvent > kTraceBufferSize)
+		firstEvent = lastEvent - kTraceBufferSize;
+
+
+
+	// Build the JSON. Times are in microseconds.
+	try
+	{
+		theJSON.reserve( (size_t) (lastEvent - firstEvent) * 100 + 32 );
+		theJSON += "{\"traceEvents\":[";
+
+		for (n = firstEvent; n < lastEvent; ++n)
+		{
+			if (! e3trace_copy_event( n, theEvent ))
+				continue;
+
+			theJSON += separator;
+			theJSON += "\n{\"name\":\"";
+			e3trace_event_name( theEvent, theJSON );
+
+			snprintf( eventBuffer, sizeof(eventBuffer),
+				"\",\"cat\":\"quesa\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+				(double) theEvent.startTime / 1000.0, (double) theEvent.duration / 1000.0,
+				(unsigned int) theEvent.threadID );
+			theJSON += eventBuffer;
+			separator = ",";
+		}
+
+		theJSON += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	}
+	catch (std::bad_alloc&)
+	{
+		E3ErrorManager_PostError( kQ3ErrorOutOfMemory, kQ3False );
+		return kQ3Failure;
+	}
+
+
+
+	// Write it out
+	return Q3Storage_SetData( storage, 0, (TQ3Uns32) theJSON.size(),
+		(const unsigned char *) theJSON.data(), bytesWritten );
+}
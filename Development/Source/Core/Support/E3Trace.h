@@ -0,0 +1,133 @@
+/*  NAME:
+        E3Trace.h
+
+    DESCRIPTION:
+        Header file for E3Trace.cpp.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2021, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef E3TRACE_HDR
+#define E3TRACE_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <stdint.h>
+
+
+
+
+
+//=============================================================================
+//      Function prototypes
+//-----------------------------------------------------------------------------
+TQ3Status			E3Trace_SetState( TQ3Boolean isEnabled );
+TQ3Boolean			E3Trace_GetState( void );
+TQ3Status			E3Trace_Clear( void );
+TQ3Status			E3Trace_Write( TQ3StorageObject storage, TQ3Uns32 *bytesWritten );
+
+
+// Record an event which started at inStartTime and ends now
+uint64_t			E3Trace_Now( void );
+void				E3Trace_Record( const char *inName, TQ3ObjectType inObjectType, uint64_t inStartTime );
+
+
+// Test whether events are being recorded, without a function call
+extern std::atomic_bool	gE3TraceEnabled;
+
+inline bool			E3Trace_IsEnabled( void )
+						{ return gE3TraceEnabled.load( std::memory_order_relaxed ); }
+
+
+
+
+
+//=============================================================================
+//      Class declaration
+//-----------------------------------------------------------------------------
+/*!
+	@class		E3TraceScope
+	@abstract	Record a trace event covering the lifetime of the object.
+	@discussion	The name must be a string constant, since only the pointer is
+				recorded. If tracing is off, construction is a single test.
+*/
+class E3TraceScope
+{
+public:
+						E3TraceScope( const char *inName, TQ3ObjectType inObjectType = 0 )
+							: mName( nullptr )
+							, mObjectType( inObjectType )
+							, mStartTime( 0 )
+							{
+								if (E3Trace_IsEnabled())
+								{
+									mName      = inName;
+									mStartTime = E3Trace_Now();
+								}
+							}
+
+						~E3TraceScope()
+							{
+								if (mName != nullptr)
+									E3Trace_Record( mName, mObjectType, mStartTime );
+							}
+
+	// Set the object type, if it was not known when the scope began
+	void				SetObjectType( TQ3ObjectType inObjectType )
+							{ mObjectType = inObjectType; }
+
+private:
+	const char*			mName;
+	TQ3ObjectType		mObjectType;
+	uint64_t			mStartTime;
+};
+
+
+
+
+
+//=============================================================================
+//      Macros
+//-----------------------------------------------------------------------------
+// Trace the rest of the enclosing block
+#define Q3_TRACE_SCOPE( _name )						\
+			E3TraceScope	traceScope_( (_name) )
+
+#define Q3_TRACE_SCOPE_TYPE( _name, _objectType )	\
+			E3TraceScope	traceScope_( (_name), (_objectType) )
+
+#endif
@@ -0,0 +1,1373 @@
+/*  NAME:
+        E3CompressedStorage.cpp
+
+    DESCRIPTION:
+        Block-compressed storage, which compresses the data of another
+        storage in independently expandable blocks.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2021, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+#include "E3Storage.h"
+#include "E3Compress.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string.h>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Container layout. All values are little-endian.
+//
+//		Header		'Q3CB', version, block size, reserved				16 bytes
+//		Blocks		Compressed or stored blocks, in any order
+//		Index		Per block: offset (8), stored size, length			16 bytes each
+//		Footer		Index offset (8), logical size (8), block count, 'Q3CB'	24 bytes
+//
+// A stored size of 0 means the block was never written, and reads as zeros.
+// A stored size equal to the length means the block is stored uncompressed.
+const TQ3Uns8  kE3CompressedStorageMagic[4]					= { 'Q', '3', 'C', 'B' };
+const TQ3Uns32 kE3CompressedStorageVersion					= 1;
+const TQ3Uns32 kE3CompressedStorageHeaderSize				= 16;
+const TQ3Uns32 kE3CompressedStorageEntrySize				= 16;
+const TQ3Uns32 kE3CompressedStorageFooterSize				= 24;
+const TQ3Uns32 kE3CompressedStorageDefaultBlockSize			= 64 * 1024;
+const TQ3Uns32 kE3CompressedStorageMinBlockSize				= 4 * 1024;
+const TQ3Uns32 kE3CompressedStorageMaxBlockSize				= 16 * 1024 * 1024;
+const TQ3Uns32 kE3CompressedStorageNoBlock					= 0xFFFFFFFF;
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+// An entry in the block index
+struct TE3CompressedBlockEntry
+{
+	uint64_t						offset;
+	TQ3Uns32						storedSize;
+	TQ3Uns32						length;
+};
+
+
+// The blocks of an open container.
+//
+// When writing, one block at a time is held expanded. Blocks are appended
+// to the source as we move off them, and a block which is written again
+// (e.g., to patch a size) is appended again, with the index pointing at
+// the newest copy.
+//
+// When reading, the block after the current one is expanded on a worker
+// thread, so sequential reads overlap decoding the data with expanding it.
+// The worker is started by the first read ahead and lives until the blocks
+// are destroyed. Only this thread touches the source, and the worker only
+// touches mNextPacked and mNextBlock while mNextPending is set.
+class E3CompressedBlocks
+{
+public:
+									E3CompressedBlocks( TQ3StorageObject inSource, TQ3Uns32 inBlockSize );
+									~E3CompressedBlocks();
+
+	TQ3Status						OpenRead( void );
+	TQ3Status						OpenWrite( void );
+	TQ3Status						Close( void );
+
+	TQ3Status						Read( uint64_t offset, TQ3Uns32 dataSize,
+										unsigned char *data, TQ3Uns32 *sizeRead );
+	TQ3Status						Write( uint64_t offset, TQ3Uns32 dataSize,
+										const unsigned char *data, TQ3Uns32 *sizeWritten );
+	uint64_t						GetSize( void ) const
+										{ return mLogicalSize; }
+
+private:
+	TQ3Uns32						BlockLength( TQ3Uns32 blockIndex ) const;
+	TQ3Status						ReadPacked( TQ3Uns32 blockIndex, std::vector<TQ3Uns8>& outPacked );
+	TQ3Status						LoadBlock( TQ3Uns32 blockIndex, std::vector<TQ3Uns8>& outData );
+	TQ3Status						SelectBlock( TQ3Uns32 blockIndex );
+	TQ3Status						FlushBlock( void );
+	void							StartNextBlock( TQ3Uns32 blockIndex );
+	TQ3Status						WaitNextBlock( void );
+	void							FinishNextBlock( void );
+	void							StopWorker( void );
+	void							ThreadMain( void );
+
+	E3Storage*						mSource;
+	TQ3Uns32						mBlockSize;
+	bool							mForWriting;
+	uint64_t						mLogicalSize;
+	uint64_t						mAppendOffset;
+	std::vector<TE3CompressedBlockEntry>	mIndex;
+
+	std::vector<TQ3Uns8>			mBlock;				// The current block, expanded
+	TQ3Uns32						mBlockIndex;
+	TQ3Uns32						mBlockLength;
+	bool							mBlockDirty;
+
+	std::vector<TQ3Uns8>			mNextPacked;		// The next block, being expanded
+	std::vector<TQ3Uns8>			mNextBlock;
+	TQ3Uns32						mNextIndex;			// Owned by this thread
+	TQ3Uns32						mNextStoredSize;
+	TQ3Uns32						mNextLength;
+	TQ3Status						mNextStatus;
+	bool							mNextPending;		// Guarded by mLock
+	bool							mStopping;
+	std::mutex						mLock;
+	std::condition_variable			mWorkReady;
+	std::condition_variable			mBlockDone;
+	std::thread						mThread;
+};
+
+
+// Compressed storage
+typedef struct TQ3CompressedStorageData {
+	TQ3StorageObject				source;
+	TQ3Uns32						blockSize;
+	TQ3Boolean						isOpen;
+	E3CompressedBlocks*				blocks;			// Only while open
+} TQ3CompressedStorageData;
+
+
+class E3CompressedStorage : public E3Storage  // This is a leaf class so no other classes use this,
+								// so it can be here in the .cpp file rather than in
+								// the .h file, hence all the fields can be public
+								// as nobody should be including this file
+	{
+	Q3_CLASS_ENUMS( kQ3StorageTypeCompressed, E3CompressedStorage, E3Storage );
+
+public :
+	TQ3CompressedStorageData				instanceData ;
+	} ;
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      e3storage_compressed_get32 : Read a little-endian 32-bit value.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3storage_compressed_get32( const TQ3Uns8 *src )
+{
+	return( (TQ3Uns32) src[0]         | ((TQ3Uns32) src[1] << 8) |
+		   ((TQ3Uns32) src[2] << 16) | ((TQ3Uns32) src[3] << 24) );
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_get64 : Read a little-endian 64-bit value.
+//-----------------------------------------------------------------------------
+static uint64_t
+e3storage_compressed_get64( const TQ3Uns8 *src )
+{
+	return( (uint64_t) e3storage_compressed_get32( src ) |
+		   ((uint64_t) e3storage_compressed_get32( src + 4 ) << 32) );
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_put32 : Write a little-endian 32-bit value.
+//-----------------------------------------------------------------------------
+static void
+e3storage_compressed_put32( TQ3Uns8 *dst, TQ3Uns32 theValue )
+{
+	dst[0] = (TQ3Uns8) (theValue);
+	dst[1] = (TQ3Uns8) (theValue >> 8);
+	dst[2] = (TQ3Uns8) (theValue >> 16);
+	dst[3] = (TQ3Uns8) (theValue >> 24);
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_put64 : Write a little-endian 64-bit value.
+//-----------------------------------------------------------------------------
+static void
+e3storage_compressed_put64( TQ3Uns8 *dst, uint64_t theValue )
+{
+	e3storage_compressed_put32( dst,     (TQ3Uns32) (theValue & 0xFFFFFFFF) );
+	e3storage_compressed_put32( dst + 4, (TQ3Uns32) (theValue >> 32) );
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_read_all : Read an exact amount from a storage.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_read_all( E3Storage *theStorage, uint64_t offset, TQ3Uns32 dataSize, TQ3Uns8 *data )
+{	TQ3Uns32	sizeRead = 0;
+
+
+
+	if (theStorage->GetData64( offset, dataSize, data, &sizeRead ) != kQ3Success)
+		return(kQ3Failure);
+
+	if (sizeRead != dataSize)
+	{
+		E3ErrorManager_PostError( kQ3ErrorReadLessThanSize, kQ3False );
+		return(kQ3Failure);
+	}
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_write_all : Write an exact amount to a storage.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_write_all( E3Storage *theStorage, uint64_t offset, TQ3Uns32 dataSize, const TQ3Uns8 *data )
+{	TQ3Uns32	sizeWritten = 0;
+
+
+
+	if (theStorage->SetData64( offset, dataSize, data, &sizeWritten ) != kQ3Success)
+		return(kQ3Failure);
+
+	return( (sizeWritten == dataSize) ? kQ3Success : kQ3Failure );
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::E3CompressedBlocks : Constructor.
+//-----------------------------------------------------------------------------
+E3CompressedBlocks::E3CompressedBlocks( TQ3StorageObject inSource, TQ3Uns32 inBlockSize )
+	: mSource( (E3Storage*) inSource )
+	, mBlockSize( inBlockSize )
+	, mForWriting( false )
+	, mLogicalSize( 0 )
+	, mAppendOffset( 0 )
+	, mBlockIndex( kE3CompressedStorageNoBlock )
+	, mBlockLength( 0 )
+	, mBlockDirty( false )
+	, mNextIndex( kE3CompressedStorageNoBlock )
+	, mNextStoredSize( 0 )
+	, mNextLength( 0 )
+	, mNextStatus( kQ3Success )
+	, mNextPending( false )
+	, mStopping( false )
+{
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::~E3CompressedBlocks : Destructor.
+//-----------------------------------------------------------------------------
+E3CompressedBlocks::~E3CompressedBlocks()
+{
+	FinishNextBlock();
+	StopWorker();
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::OpenRead : Read the header, footer, and index.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::OpenRead( void )
+{	TQ3Uns8					theHeader[kE3CompressedStorageHeaderSize];
+	TQ3Uns8					theFooter[kE3CompressedStorageFooterSize];
+	std::vector<TQ3Uns8>	theEntries;
+	uint64_t				sourceSize, indexOffset;
+	TQ3Uns32				numBlocks, n;
+
+
+
+	// Read the header and footer
+	if (mSource->GetSize64( &sourceSize ) != kQ3Success)
+		return(kQ3Failure);
+
+	if (sourceSize < kE3CompressedStorageHeaderSize + kE3CompressedStorageFooterSize ||
+		e3storage_compressed_read_all( mSource, 0, kE3CompressedStorageHeaderSize, theHeader ) != kQ3Success ||
+		e3storage_compressed_read_all( mSource, sourceSize - kE3CompressedStorageFooterSize,
+										kE3CompressedStorageFooterSize, theFooter ) != kQ3Success)
+	{
+		E3ErrorManager_PostError( kQ3ErrorInvalidMetafile, kQ3False );
+		return(kQ3Failure);
+	}
+
+	mBlockSize   = e3storage_compressed_get32( theHeader + 8 );
+	indexOffset  = e3storage_compressed_get64( theFooter );
+	mLogicalSize = e3storage_compressed_get64( theFooter + 8 );
+	numBlocks    = e3storage_compressed_get32( theFooter + 16 );
+
+
+
+	// Check it's a container we understand
+	if (memcmp( theHeader, kE3CompressedStorageMagic, 4 ) != 0 ||
+		memcmp( theFooter + 20, kE3CompressedStorageMagic, 4 ) != 0 ||
+		e3storage_compressed_get32( theHeader + 4 ) != kE3CompressedStorageVersion ||
+		mBlockSize < kE3CompressedStorageMinBlockSize || mBlockSize > kE3CompressedStorageMaxBlockSize ||
+		(uint64_t) numBlocks * mBlockSize < mLogicalSize ||
+		indexOffset + (uint64_t) numBlocks * kE3CompressedStorageEntrySize > sourceSize - kE3CompressedStorageFooterSize)
+	{
+		E3ErrorManager_PostError( kQ3ErrorInvalidMetafile, kQ3False );
+		return(kQ3Failure);
+	}
+
+
+
+	// Read the index
+	theEntries.resize( (size_t) numBlocks * kE3CompressedStorageEntrySize );
+	if (numBlocks != 0 &&
+		e3storage_compressed_read_all( mSource, indexOffset, (TQ3Uns32) theEntries.size(), &theEntries[0] ) != kQ3Success)
+		return(kQ3Failure);
+
+	mIndex.resize( numBlocks );
+	for (n = 0; n < numBlocks; ++n)
+	{
+		const TQ3Uns8	*theEntry = &theEntries[ (size_t) n * kE3CompressedStorageEntrySize ];
+
+		mIndex[n].offset     = e3storage_compressed_get64( theEntry );
+		mIndex[n].storedSize = e3storage_compressed_get32( theEntry + 8 );
+		mIndex[n].length     = e3storage_compressed_get32( theEntry + 12 );
+
+		if (mIndex[n].length > mBlockSize || mIndex[n].storedSize > mIndex[n].length ||
+			mIndex[n].offset + mIndex[n].storedSize > indexOffset)
+		{
+			E3ErrorManager_PostError( kQ3ErrorInvalidMetafile, kQ3False );
+			return(kQ3Failure);
+		}
+	}
+
+	mBlock.resize( mBlockSize );
+	mNextBlock.resize( mBlockSize );
+	mForWriting = false;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::OpenWrite : Start a new container.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::OpenWrite( void )
+{	TQ3Uns8		theHeader[kE3CompressedStorageHeaderSize];
+
+
+
+	// Write the header
+	memcpy( theHeader, kE3CompressedStorageMagic, 4 );
+	e3storage_compressed_put32( theHeader + 4,  kE3CompressedStorageVersion );
+	e3storage_compressed_put32( theHeader + 8,  mBlockSize );
+	e3storage_compressed_put32( theHeader + 12, 0 );
+
+	if (e3storage_compressed_write_all( mSource, 0, kE3CompressedStorageHeaderSize, theHeader ) != kQ3Success)
+		return(kQ3Failure);
+
+	mAppendOffset = kE3CompressedStorageHeaderSize;
+	mBlock.resize( mBlockSize );
+	mForWriting = true;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::Close : Finish the container.
+//-----------------------------------------------------------------------------
+//		Note :	When writing, the last block is flushed and the index and
+//				footer are written after the blocks.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::Close( void )
+{	std::vector<TQ3Uns8>	theEntries;
+	TQ3Uns8					theFooter[kE3CompressedStorageFooterSize];
+	TQ3Uns32				numBlocks, n;
+
+
+
+	// Stop any expansion in progress
+	FinishNextBlock();
+
+	if (! mForWriting)
+		return(kQ3Success);
+
+
+
+	// Flush the last block, and make sure there's an entry for every block
+	if (FlushBlock() != kQ3Success)
+		return(kQ3Failure);
+
+	numBlocks = (TQ3Uns32) ((mLogicalSize + mBlockSize - 1) / mBlockSize);
+	if (mIndex.size() < numBlocks)
+	{
+		TE3CompressedBlockEntry		emptyEntry = { 0, 0, 0 };
+		mIndex.resize( numBlocks, emptyEntry );
+	}
+
+
+
+	// Write the index and footer
+	theEntries.resize( (size_t) numBlocks * kE3CompressedStorageEntrySize + kE3CompressedStorageFooterSize );
+	for (n = 0; n < numBlocks; ++n)
+	{
+		TQ3Uns8		*theEntry = &theEntries[ (size_t) n * kE3CompressedStorageEntrySize ];
+
+		e3storage_compressed_put64( theEntry,      mIndex[n].offset );
+		e3storage_compressed_put32( theEntry + 8,  mIndex[n].storedSize );
+		e3storage_compressed_put32( theEntry + 12, mIndex[n].length );
+	}
+
+	e3storage_compressed_put64( theFooter,      mAppendOffset );
+	e3storage_compressed_put64( theFooter + 8,  mLogicalSize );
+	e3storage_compressed_put32( theFooter + 16, numBlocks );
+	memcpy( theFooter + 20, kE3CompressedStorageMagic, 4 );
+
+	memcpy( &theEntries[ (size_t) numBlocks * kE3CompressedStorageEntrySize ], theFooter, kE3CompressedStorageFooterSize );
+
+	return(e3storage_compressed_write_all( mSource, mAppendOffset, (TQ3Uns32) theEntries.size(), &theEntries[0] ));
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::BlockLength : Get the logical length of a block.
+//-----------------------------------------------------------------------------
+TQ3Uns32
+E3CompressedBlocks::BlockLength( TQ3Uns32 blockIndex ) const
+{	uint64_t	blockStart = (uint64_t) blockIndex * mBlockSize;
+
+
+
+	if (blockStart >= mLogicalSize)
+		return(0);
+
+	return( (TQ3Uns32) E3Num_Min( (uint64_t) mBlockSize, mLogicalSize - blockStart ) );
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::ReadPacked : Read the stored bytes of a block.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::ReadPacked( TQ3Uns32 blockIndex, std::vector<TQ3Uns8>& outPacked )
+{
+	const TE3CompressedBlockEntry&	theEntry = mIndex[blockIndex];
+
+
+
+	outPacked.resize( theEntry.storedSize );
+	if (theEntry.storedSize == 0)
+		return(kQ3Success);
+
+	return(e3storage_compressed_read_all( mSource, theEntry.offset, theEntry.storedSize, &outPacked[0] ));
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::LoadBlock : Read and expand a block.
+//-----------------------------------------------------------------------------
+//		Note :	Anything past the data written for the block reads as zeros.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::LoadBlock( TQ3Uns32 blockIndex, std::vector<TQ3Uns8>& outData )
+{	std::vector<TQ3Uns8>	thePacked;
+	TQ3Uns32				theLength = 0;
+
+
+
+	// Expand the data we have
+	if (blockIndex < mIndex.size() && mIndex[blockIndex].storedSize != 0)
+	{
+		const TE3CompressedBlockEntry&	theEntry = mIndex[blockIndex];
+
+		if (ReadPacked( blockIndex, thePacked ) != kQ3Success)
+			return(kQ3Failure);
+
+		if (theEntry.storedSize == theEntry.length)
+			memcpy( &outData[0], &thePacked[0], theEntry.length );
+
+		else if (E3Compress_Expand( &thePacked[0], theEntry.storedSize, &outData[0], theEntry.length ) != kQ3Success)
+		{
+			E3ErrorManager_PostError( kQ3ErrorInvalidMetafile, kQ3False );
+			return(kQ3Failure);
+		}
+
+		theLength = theEntry.length;
+	}
+
+
+
+	// And zero the rest
+	memset( &outData[theLength], 0, mBlockSize - theLength );
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::SelectBlock : Make a block current for writing.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::SelectBlock( TQ3Uns32 blockIndex )
+{
+	if (blockIndex == mBlockIndex)
+		return(kQ3Success);
+
+	if (FlushBlock() != kQ3Success)
+		return(kQ3Failure);
+
+	mBlockIndex = kE3CompressedStorageNoBlock;
+	if (LoadBlock( blockIndex, mBlock ) != kQ3Success)
+		return(kQ3Failure);
+
+	mBlockIndex  = blockIndex;
+	mBlockLength = BlockLength( blockIndex );
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::FlushBlock : Append the current block if changed.
+//-----------------------------------------------------------------------------
+//		Note :	Blocks which don't compress are stored as they are.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::FlushBlock( void )
+{	std::vector<TQ3Uns8>	thePacked;
+	TE3CompressedBlockEntry	theEntry;
+
+
+
+	if (! mBlockDirty)
+		return(kQ3Success);
+
+
+
+	// Compress the block
+	thePacked.resize( E3Compress_Bound( mBlockLength ) );
+
+	theEntry.offset     = mAppendOffset;
+	theEntry.length     = mBlockLength;
+	theEntry.storedSize = E3Compress_Block( &mBlock[0], mBlockLength, &thePacked[0], (TQ3Uns32) thePacked.size() );
+
+	const TQ3Uns8	*theData = &thePacked[0];
+	if (theEntry.storedSize == 0 || theEntry.storedSize >= mBlockLength)
+	{
+		theEntry.storedSize = mBlockLength;
+		theData             = &mBlock[0];
+	}
+
+
+
+	// Append it, and update the index
+	if (e3storage_compressed_write_all( mSource, mAppendOffset, theEntry.storedSize, theData ) != kQ3Success)
+		return(kQ3Failure);
+
+	if (mIndex.size() <= mBlockIndex)
+	{
+		TE3CompressedBlockEntry		emptyEntry = { 0, 0, 0 };
+		mIndex.resize( mBlockIndex + 1, emptyEntry );
+	}
+
+	mIndex[mBlockIndex] = theEntry;
+	mAppendOffset      += theEntry.storedSize;
+	mBlockDirty         = false;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::StartNextBlock : Start expanding a block.
+//-----------------------------------------------------------------------------
+//		Note :	The stored bytes are read on this thread, and only the
+//				expansion runs on the worker.
+//-----------------------------------------------------------------------------
+void
+E3CompressedBlocks::StartNextBlock( TQ3Uns32 blockIndex )
+{
+	FinishNextBlock();
+
+	if (blockIndex >= mIndex.size())
+		return;
+
+	const TE3CompressedBlockEntry&	theEntry = mIndex[blockIndex];
+	if (theEntry.storedSize == 0 || theEntry.storedSize == theEntry.length)
+		return;
+
+	if (ReadPacked( blockIndex, mNextPacked ) != kQ3Success)
+		return;
+
+
+
+	// Hand the block to the worker, starting it if need be
+	if (! mThread.joinable())
+		mThread = std::thread( &E3CompressedBlocks::ThreadMain, this );
+
+	{
+		std::lock_guard<std::mutex>	guard( mLock );
+		mNextStoredSize = theEntry.storedSize;
+		mNextLength     = theEntry.length;
+		mNextPending    = true;
+	}
+
+	mNextIndex = blockIndex;
+	mWorkReady.notify_one();
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::WaitNextBlock : Wait for the next block.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::WaitNextBlock( void )
+{
+	std::unique_lock<std::mutex>	lock( mLock );
+
+	mBlockDone.wait( lock, [this]() { return ! mNextPending; } );
+
+	return(mNextStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::FinishNextBlock : Wait for and drop the next block.
+//-----------------------------------------------------------------------------
+void
+E3CompressedBlocks::FinishNextBlock( void )
+{
+	if (mNextIndex != kE3CompressedStorageNoBlock)
+		WaitNextBlock();
+
+	mNextIndex = kE3CompressedStorageNoBlock;
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::StopWorker : Stop the worker thread.
+//-----------------------------------------------------------------------------
+void
+E3CompressedBlocks::StopWorker( void )
+{
+	if (! mThread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex>	guard( mLock );
+		mStopping = true;
+	}
+
+	mWorkReady.notify_all();
+	mThread.join();
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::ThreadMain : Expand blocks as they are started.
+//-----------------------------------------------------------------------------
+void
+E3CompressedBlocks::ThreadMain( void )
+{
+	std::unique_lock<std::mutex>	lock( mLock );
+
+	while (true)
+	{
+		mWorkReady.wait( lock, [this]() { return mStopping || mNextPending; } );
+		if (mStopping)
+			break;
+
+
+		// Expand the block without holding the lock
+		TQ3Uns32	storedSize = mNextStoredSize;
+		TQ3Uns32	theLength  = mNextLength;
+		TQ3Status	theStatus;
+
+		lock.unlock();
+
+		theStatus = E3Compress_Expand( &mNextPacked[0], storedSize, &mNextBlock[0], theLength );
+		if (theStatus == kQ3Success)
+			memset( &mNextBlock[theLength], 0, mBlockSize - theLength );
+
+		lock.lock();
+
+
+		// Publish the result
+		mNextStatus  = theStatus;
+		mNextPending = false;
+		mBlockDone.notify_all();
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::Read : Read data from the container.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::Read( uint64_t offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+{	TQ3Uns32	numCopied = 0;
+
+
+
+	while (numCopied < dataSize && offset < mLogicalSize)
+	{
+		TQ3Uns32	blockIndex  = (TQ3Uns32) (offset / mBlockSize);
+		TQ3Uns32	blockOffset = (TQ3Uns32) (offset % mBlockSize);
+
+
+		// Find the block
+		if (mForWriting)
+		{
+			if (SelectBlock( blockIndex ) != kQ3Success)
+				return(kQ3Failure);
+		}
+		else if (blockIndex != mBlockIndex)
+		{
+			// Take the block from the worker if it has it, else expand it here
+			bool	haveBlock = false;
+
+			if (blockIndex == mNextIndex)
+			{
+				haveBlock = (WaitNextBlock() == kQ3Success);
+				mNextIndex = kE3CompressedStorageNoBlock;
+
+				if (haveBlock)
+					mBlock.swap( mNextBlock );
+			}
+
+			mBlockIndex = kE3CompressedStorageNoBlock;
+			if (! haveBlock && LoadBlock( blockIndex, mBlock ) != kQ3Success)
+				return(kQ3Failure);
+
+			mBlockIndex  = blockIndex;
+			mBlockLength = BlockLength( blockIndex );
+
+			StartNextBlock( blockIndex + 1 );
+		}
+
+
+		// Copy what we need
+		TQ3Uns32	theCopy = E3Num_Min( dataSize - numCopied, mBlockLength - blockOffset );
+		Q3Memory_Copy( &mBlock[blockOffset], data + numCopied, theCopy );
+
+		numCopied += theCopy;
+		offset    += theCopy;
+	}
+
+	*sizeRead = numCopied;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedBlocks::Write : Write data to the container.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedBlocks::Write( uint64_t offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+{	TQ3Uns32	numCopied = 0;
+
+
+
+	// Make sure we're writing
+	*sizeWritten = 0;
+
+	if (! mForWriting)
+	{
+		E3ErrorManager_PostError( kQ3ErrorFileModeRestriction, kQ3False );
+		return(kQ3Failure);
+	}
+
+
+
+	// Copy into each block in turn
+	while (numCopied < dataSize)
+	{
+		TQ3Uns32	blockIndex  = (TQ3Uns32) (offset / mBlockSize);
+		TQ3Uns32	blockOffset = (TQ3Uns32) (offset % mBlockSize);
+
+		if (SelectBlock( blockIndex ) != kQ3Success)
+			return(kQ3Failure);
+
+		TQ3Uns32	theCopy = E3Num_Min( dataSize - numCopied, mBlockSize - blockOffset );
+		Q3Memory_Copy( data + numCopied, &mBlock[blockOffset], theCopy );
+
+		mBlockLength = E3Num_Max( mBlockLength, blockOffset + theCopy );
+		mBlockDirty  = true;
+		mLogicalSize = E3Num_Max( mLogicalSize, offset + theCopy );
+
+		numCopied += theCopy;
+		offset    += theCopy;
+	}
+
+	*sizeWritten = numCopied;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_new : Compressed storage new method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_new(TQ3Object theObject, void *privateData, const void *paramData)
+{	TQ3CompressedStorageData			*instanceData = (TQ3CompressedStorageData *) privateData;
+	const TQ3CompressedStorageData		*initData     = (const TQ3CompressedStorageData *) paramData;
+
+
+
+	// Initialise our instance data
+	instanceData->source    = Q3Shared_GetReference( initData->source );
+	instanceData->blockSize = initData->blockSize;
+	instanceData->isOpen    = kQ3False;
+	instanceData->blocks    = nullptr;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_delete : Compressed storage delete method.
+//-----------------------------------------------------------------------------
+static void
+e3storage_compressed_delete(TQ3Object storage, void *privateData)
+{	TQ3CompressedStorageData		*instanceData = (TQ3CompressedStorageData *) privateData;
+#pragma unused(storage)
+
+
+
+	// Make sure the storage isn't open
+	if (instanceData->isOpen)
+		{
+		E3ErrorManager_PostError(kQ3ErrorFileIsOpen, kQ3False);
+		delete instanceData->blocks;
+		}
+
+
+
+	// Dispose of our instance data
+	Q3Object_CleanDispose(&instanceData->source);
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_duplicate : Compressed storage duplicate method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_duplicate(	TQ3Object fromObject, const void *fromPrivateData,
+								TQ3Object toObject,   void       *toPrivateData)
+{	const TQ3CompressedStorageData	*fromInstanceData = (const TQ3CompressedStorageData *) fromPrivateData;
+	TQ3CompressedStorageData		*toInstanceData   = (TQ3CompressedStorageData *) toPrivateData;
+#pragma unused(fromObject)
+#pragma unused(toObject)
+
+
+
+	// Make sure the storage isn't open
+	toInstanceData->isOpen = kQ3False;
+	toInstanceData->blocks = nullptr;
+
+	if (fromInstanceData->isOpen)
+		{
+		toInstanceData->source = nullptr;
+		E3ErrorManager_PostError(kQ3ErrorFileIsOpen, kQ3False);
+		return(kQ3Failure);
+		}
+
+
+
+	// Duplicate the source
+	toInstanceData->source = Q3Object_Duplicate(fromInstanceData->source);
+	if (toInstanceData->source == nullptr)
+		return(kQ3Failure);
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_open : Open the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_open ( E3CompressedStorage* storage, TQ3Boolean forWriting )
+	{
+	TQ3CompressedStorageData*	instanceData = &storage->instanceData ;
+	E3Storage*					theSource    = (E3Storage*) instanceData->source ;
+	TQ3Status					qd3dStatus ;
+
+
+
+	// Make sure the storage isn't already open
+	if ( instanceData->isOpen )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorFileAlreadyOpen, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+
+
+	// Open the source, and start or load the container
+	if ( theSource->Open ( forWriting ) != kQ3Success )
+		return kQ3Failure ;
+
+	instanceData->blocks = new(std::nothrow) E3CompressedBlocks ( instanceData->source, instanceData->blockSize ) ;
+	if ( instanceData->blocks == nullptr )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorOutOfMemory, kQ3False ) ;
+		qd3dStatus = kQ3Failure ;
+		}
+	else if ( forWriting )
+		qd3dStatus = instanceData->blocks->OpenWrite () ;
+	else
+		qd3dStatus = instanceData->blocks->OpenRead () ;
+
+	if ( qd3dStatus != kQ3Success )
+		{
+		delete instanceData->blocks ;
+		instanceData->blocks = nullptr ;
+		theSource->Close () ;
+		return kQ3Failure ;
+		}
+
+	instanceData->isOpen = kQ3True ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_close : Close the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_close ( E3CompressedStorage* storage )
+	{
+	TQ3CompressedStorageData*	instanceData = &storage->instanceData ;
+	TQ3Status					qd3dStatus ;
+
+
+
+	// Make sure the storage is open
+	if ( ! instanceData->isOpen )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorFileNotOpen, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+
+
+	// Finish the container, and close the source
+	qd3dStatus = instanceData->blocks->Close () ;
+
+	delete instanceData->blocks ;
+	instanceData->blocks = nullptr ;
+	instanceData->isOpen = kQ3False ;
+
+	if ( ( (E3Storage*) instanceData->source )->Close () != kQ3Success )
+		qd3dStatus = kQ3Failure ;
+
+	return qd3dStatus ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_getopenness : Check openness of the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_getopenness ( E3CompressedStorage* storage, TQ3StorageOpenness* outOpenness )
+	{
+	*outOpenness = storage->instanceData.isOpen ? kQ3StorageOpenness_Open : kQ3StorageOpenness_Closed ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_getsize64 : Get the size of the storage object.
+//-----------------------------------------------------------------------------
+//		Note :	This is the size of the uncompressed data, which is only known
+//				while the storage is open.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_getsize64 ( E3CompressedStorage* storage, uint64_t *size )
+	{
+	if ( storage->instanceData.blocks == nullptr )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorFileNotOpen, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+	*size = storage->instanceData.blocks->GetSize () ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_getsize : Get the size of the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_getsize ( E3CompressedStorage* storage, TQ3Uns32 *size )
+	{
+	uint64_t	fullSize ;
+
+
+
+	if ( e3storage_compressed_getsize64 ( storage, &fullSize ) != kQ3Success )
+		return kQ3Failure ;
+
+	if ( fullSize > 0xFFFFFFFF )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorNotSupported, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+	*size = (TQ3Uns32) fullSize ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_read64 : Read data from the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_read64 ( E3CompressedStorage* storage, uint64_t offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+	{
+	if ( storage->instanceData.blocks == nullptr )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorFileNotOpen, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+	return storage->instanceData.blocks->Read ( offset, dataSize, data, sizeRead ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_read : Read data from the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_read ( E3CompressedStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+	{
+	return e3storage_compressed_read64 ( storage, offset, dataSize, data, sizeRead ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_write64 : Write data to the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_write64 ( E3CompressedStorage* storage, uint64_t offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+	{
+	if ( storage->instanceData.blocks == nullptr )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorFileNotOpen, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+	return storage->instanceData.blocks->Write ( offset, dataSize, data, sizeWritten ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_write : Write data to the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_compressed_write ( E3CompressedStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+	{
+	return e3storage_compressed_write64 ( storage, offset, dataSize, data, sizeWritten ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_compressed_metahandler : Compressed storage metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3storage_compressed_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+		case kQ3XMethodTypeObjectNew:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_new;
+			break;
+
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_delete;
+			break;
+
+		case kQ3XMethodTypeObjectDuplicate:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_duplicate;
+			break;
+
+		case kQ3XMethodTypeStorageOpen:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_open;
+			break;
+
+		case kQ3XMethodTypeStorageClose:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_close;
+			break;
+
+		case kQ3XMethodTypeStorageGetOpenness:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_getopenness;
+			break;
+
+		case kQ3XMethodTypeStorageGetSize:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_getsize;
+			break;
+
+		case kQ3XMethodTypeStorageReadData:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_read;
+			break;
+
+		case kQ3XMethodTypeStorageWriteData:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_write;
+			break;
+
+		case kQ3XMethodTypeStorageGetSize64:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_getsize64;
+			break;
+
+		case kQ3XMethodTypeStorageReadData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_read64;
+			break;
+
+		case kQ3XMethodTypeStorageWriteData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_compressed_write64;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3CompressedStorage_RegisterClass : Register the class.
+//-----------------------------------------------------------------------------
+#pragma mark -
+TQ3Status
+E3CompressedStorage_RegisterClass(void)
+{	TQ3Status		qd3dStatus;
+
+
+
+	// Register the class
+	qd3dStatus = Q3_REGISTER_CLASS( kQ3ClassNameStorageCompressed, e3storage_compressed_metahandler,
+		E3CompressedStorage );
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedStorage_UnregisterClass : Unregister the class.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedStorage_UnregisterClass(void)
+{	TQ3Status		qd3dStatus;
+
+
+
+	// Unregister the class
+	qd3dStatus = E3ClassTree::UnregisterClass(kQ3StorageTypeCompressed, kQ3True);
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedStorage_New : Create a compressed storage object.
+//-----------------------------------------------------------------------------
+TQ3StorageObject
+E3CompressedStorage_New(TQ3StorageObject source, TQ3Uns32 blockSize)
+	{
+	TQ3CompressedStorageData	initData ;
+
+
+
+	// Fill in the defaults
+	if ( blockSize == 0 )
+		blockSize = kE3CompressedStorageDefaultBlockSize ;
+
+	initData.source    = source ;
+	initData.blockSize = E3Num_Clamp ( blockSize, kE3CompressedStorageMinBlockSize, kE3CompressedStorageMaxBlockSize ) ;
+	initData.isOpen    = kQ3False ;
+	initData.blocks    = nullptr ;
+
+
+
+	// Create the object
+	return E3ClassTree::CreateInstance ( kQ3StorageTypeCompressed, kQ3False, &initData ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3CompressedStorage_GetSource : Get the storage holding the container.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3CompressedStorage_GetSource(TQ3StorageObject storage, TQ3StorageObject *source)
+	{
+	// Return a new reference to the source
+	*source = Q3Shared_GetReference ( ( (E3CompressedStorage*) storage )->instanceData.source ) ;
+
+	return kQ3Success ;
+	}
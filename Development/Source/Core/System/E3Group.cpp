@@ -47,6 +47,8 @@
 #include "E3Group.h"
 #include "E3IOFileFormat.h"
 #include "E3View.h"
+#include "E3Pick.h"
+#include "E3Math.h"
 #include "E3ClassTree.h"
 #include "E3Renderer.h"
 #include "E3Style.h"
@@ -1357,6 +1359,13 @@ e3group_display_submit_render(TQ3ViewObject theView, TQ3ObjectType objectType,
 		(kQ3Success == ((E3DisplayGroup*)theObject)->GetBoundingBox( &theBBox )) )
 	{
 		shouldSubmit = E3Renderer_Method_IsBBoxVisible( theView, &theBBox );
+		
+		if ( ! shouldSubmit )
+		{
+			TQ3ViewFrameStatistics* frameStatistics = E3View_AccessFrameStatistics( theView );
+			if ( frameStatistics != nullptr )
+				frameStatistics->groupsCulled++;
+		}
 	}
 
 
@@ -1364,6 +1373,10 @@ e3group_display_submit_render(TQ3ViewObject theView, TQ3ObjectType objectType,
 	// If we need to submit the group, do so
 	if ( shouldSubmit )
 	{
+		TQ3ViewFrameStatistics* frameStatistics = E3View_AccessFrameStatistics( theView );
+		if ( frameStatistics != nullptr )
+			frameStatistics->groupsSubmitted++;
+
 		// If the group isn't inline, push the view state and reset the matrix
 		TQ3Boolean isInline = E3Bit_AnySet( theState, kQ3DisplayGroupStateMaskIsInline );
 		if ( ! isInline )
@@ -1454,6 +1467,27 @@ e3group_display_submit_pick(TQ3ViewObject theView, TQ3ObjectType objectType,
 
 
 
+	// If the pick only wants its nearest hit, skip groups which lie beyond it.
+	// A batch pick only carries the rays which can hit the group into it.
+	TQ3PickObject	thePick = E3View_AccessPick( theView );
+	TQ3BoundingBox	localBounds, worldBounds;
+	bool			pushedRayBounds = false;
+	if ( shouldSubmit &&
+		E3Bit_IsSet( theState, kQ3DisplayGroupStateMaskUseBoundingBox ) &&
+		(kQ3Success == ((E3DisplayGroup*)theObject)->GetBoundingBox( &localBounds )) )
+	{
+		E3BoundingBox_Transform( &localBounds, E3View_State_GetMatrixLocalToWorld( theView ), &worldBounds );
+		if (E3Pick_GetType( thePick ) == kQ3PickTypeWorldRayBatch)
+		{
+			pushedRayBounds = (E3WorldRayBatchPick_PushBounds( thePick, &worldBounds ) == kQ3True);
+			shouldSubmit    = pushedRayBounds ? kQ3True : kQ3False;
+		}
+		else if (E3Pick_IsBoundsBeyondClosestHit( thePick, theView, &worldBounds ))
+			shouldSubmit = kQ3False;
+	}
+
+
+
 	// If we need to submit the group, do so
 	if ( shouldSubmit )
 	{
@@ -1463,18 +1497,22 @@ e3group_display_submit_pick(TQ3ViewObject theView, TQ3ObjectType objectType,
 			qd3dStatus = E3Push_Submit ( theView ) ;
 
 
-		if ( qd3dStatus == kQ3Failure ) return qd3dStatus;
-		
-		
-		// Submit the group, using the generic group submit method
-		qd3dStatus = e3group_submit_pick ( theView, objectType, (E3Group*) theObject, objectData ) ;
+		// Submit the group, using the generic group submit method, then
+		// pop the view state if the group isn't inline
+		if ( qd3dStatus != kQ3Failure )
+		{
+			qd3dStatus = e3group_submit_pick ( theView, objectType, (E3Group*) theObject, objectData ) ;
+
+			if ( ! isInline )
+				E3Pop_Submit ( theView ) ;
+		}
+	}
 
 
 
-		// If the group isn't inline, pop the view state
-		if ( ! isInline )
-			E3Pop_Submit ( theView ) ;
-	}
+	// Restore the rays of a batch pick
+	if ( pushedRayBounds )
+		E3WorldRayBatchPick_PopBounds( thePick ) ;
 	
 	return qd3dStatus ;
 }
@@ -47,6 +47,7 @@
 #include "E3IO.h"
 #include "E3IOData.h"
 #include "E3FFR_3DMF.h"
+#include "E3Trace.h"
 
 
 
@@ -69,7 +70,7 @@ e3file_format_attach ( E3File* theFile,TQ3FileFormatObject theFileFormat )
 
 	if ( theFileFormat != nullptr)
 		{
-		E3FileFormat_Init ( theFileFormat, theFile->instanceData.storage ) ;
+		return E3FileFormat_Init ( theFileFormat, theFile->instanceData.storage ) ;
 		}
 		
 	return kQ3Success ;
@@ -349,10 +350,15 @@ E3File::OpenRead ( TQ3FileMode* mode )
 		TQ3FileFormatObject format = Q3FileFormat_NewFromType ( formatType ) ;
 		
 		
+		if ( format != nullptr && e3file_format_attach ( this, format ) == kQ3Failure )
+			{
+			E3Shared_Replace ( & instanceData.format, nullptr ) ;
+			Q3Object_Dispose ( format ) ;
+			format = nullptr ;
+			}
+		
 		if ( format != nullptr )
 			{
-			e3file_format_attach ( this, format ) ;
-			
 			instanceData.status = kE3_File_Status_Reading ;
 			instanceData.reason = kE3_File_Reason_OK ;
 			// lets the fileFormat orient itself;
@@ -698,10 +704,19 @@ E3File::ReadObject ()
 						
 	CallIdle () ;
 
-	if ( readObject != nullptr )
-		return readObject ( this ) ;
+	if ( readObject == nullptr )
+		return nullptr ;
+
+
+
+	// Read the object, tracing it under its type once we know what it is
+	Q3_TRACE_SCOPE ( "FileRead" ) ;
+	TQ3Object theObject = readObject ( this ) ;
+
+	if ( theObject != nullptr )
+		traceScope_.SetObjectType ( theObject->GetLeafType () ) ;
 	
-	return nullptr ;
+	return theObject ;
 	}
 
 
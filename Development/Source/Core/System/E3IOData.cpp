@@ -555,6 +555,52 @@ E3Uns8_Write(TQ3Uns8 data, E3File* theFile)
 
 
 
+//=============================================================================
+//      E3Uns8_WriteArray : Write an array of TQ3Uns8.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Uns8_WriteArray(TQ3Uns32 numNums, const TQ3Uns8 *data, E3File* theFile)
+{
+	TQ3FileFormatObject				format = theFile->GetFileFormat () ;
+	TQ3XFFormatInt8WriteMethod 		int8Write;
+	TQ3XFFormatInt8WriteArrayMethod	int8ArrayWrite;
+	TQ3Uns32						n;
+	TQ3Status						status = kQ3Success;
+
+	Q3_REQUIRE_OR_RESULT(( theFile->GetFileStatus () == kE3_File_Status_Writing),kQ3Failure);
+	Q3_REQUIRE_OR_RESULT((format != nullptr),kQ3Failure);
+
+	
+	int8ArrayWrite = (TQ3XFFormatInt8WriteArrayMethod) format->GetMethod ( kQ3XMethodTypeFFormatInt8WriteArray);
+
+	if (int8ArrayWrite == nullptr)
+	{
+		int8Write = (TQ3XFFormatInt8WriteMethod) format->GetMethod ( kQ3XMethodTypeFFormatInt8Write);
+		Q3_REQUIRE_OR_RESULT((int8Write != nullptr),kQ3Failure);
+		
+		
+		for (n = 0; n < numNums; ++n)
+		{
+			status = int8Write( format, (const TQ3Int8*)&data[n] );
+			if (status == kQ3Failure)
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+		status = int8ArrayWrite( format, numNums, (const TQ3Int8*)data );
+	}
+
+	
+	return status;
+}
+
+
+
+
+
 //=============================================================================
 //      E3Uns16_Read : Read a TQ3Uns16.
 //-----------------------------------------------------------------------------
@@ -627,6 +673,52 @@ E3Uns16_Write(TQ3Uns16 data, E3File* theFile)
 
 
 
+//=============================================================================
+//      E3Uns16_WriteArray : Write an array of TQ3Uns16.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Uns16_WriteArray(TQ3Uns32 numNums, const TQ3Uns16 *data, E3File* theFile)
+{
+	TQ3FileFormatObject				format = theFile->GetFileFormat () ;
+	TQ3XFFormatInt16WriteMethod 		int16Write;
+	TQ3XFFormatInt16WriteArrayMethod	int16ArrayWrite;
+	TQ3Uns32						n;
+	TQ3Status						status = kQ3Success;
+
+	Q3_REQUIRE_OR_RESULT(( theFile->GetFileStatus () == kE3_File_Status_Writing),kQ3Failure);
+	Q3_REQUIRE_OR_RESULT((format != nullptr),kQ3Failure);
+
+	
+	int16ArrayWrite = (TQ3XFFormatInt16WriteArrayMethod) format->GetMethod ( kQ3XMethodTypeFFormatInt16WriteArray);
+
+	if (int16ArrayWrite == nullptr)
+	{
+		int16Write = (TQ3XFFormatInt16WriteMethod) format->GetMethod ( kQ3XMethodTypeFFormatInt16Write);
+		Q3_REQUIRE_OR_RESULT((int16Write != nullptr),kQ3Failure);
+		
+		
+		for (n = 0; n < numNums; ++n)
+		{
+			status = int16Write( format, (const TQ3Int16*)&data[n] );
+			if (status == kQ3Failure)
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+		status = int16ArrayWrite( format, numNums, (const TQ3Int16*)data );
+	}
+
+	
+	return status;
+}
+
+
+
+
+
 //=============================================================================
 //      E3Uns32_Read : Read a TQ3Uns32.
 //-----------------------------------------------------------------------------
@@ -653,6 +745,52 @@ E3Uns32_Write(TQ3Uns32 data, E3File* theFile)
 
 
 
+//=============================================================================
+//      E3Uns32_WriteArray : Write an array of TQ3Uns32.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Uns32_WriteArray(TQ3Uns32 numNums, const TQ3Uns32 *data, E3File* theFile)
+{
+	TQ3FileFormatObject				format = theFile->GetFileFormat () ;
+	TQ3XFFormatInt32WriteMethod 		int32Write;
+	TQ3XFFormatInt32WriteArrayMethod	int32ArrayWrite;
+	TQ3Uns32						n;
+	TQ3Status						status = kQ3Success;
+
+	Q3_REQUIRE_OR_RESULT(( theFile->GetFileStatus () == kE3_File_Status_Writing),kQ3Failure);
+	Q3_REQUIRE_OR_RESULT((format != nullptr),kQ3Failure);
+
+	
+	int32ArrayWrite = (TQ3XFFormatInt32WriteArrayMethod) format->GetMethod ( kQ3XMethodTypeFFormatInt32WriteArray);
+
+	if (int32ArrayWrite == nullptr)
+	{
+		int32Write = (TQ3XFFormatInt32WriteMethod) format->GetMethod ( kQ3XMethodTypeFFormatInt32Write);
+		Q3_REQUIRE_OR_RESULT((int32Write != nullptr),kQ3Failure);
+		
+		
+		for (n = 0; n < numNums; ++n)
+		{
+			status = int32Write( format, (const TQ3Int32*)&data[n] );
+			if (status == kQ3Failure)
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+		status = int32ArrayWrite( format, numNums, (const TQ3Int32*)data );
+	}
+
+	
+	return status;
+}
+
+
+
+
+
 //=============================================================================
 //      E3Int8_Read : Read a TQ3Int8.
 //-----------------------------------------------------------------------------
@@ -1016,6 +1154,52 @@ E3Float32_Write(TQ3Float32 data, E3File* theFile)
 
 
 
+//=============================================================================
+//      E3Float32_WriteArray : Write an array of TQ3Float32.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Float32_WriteArray(TQ3Uns32 numNums, const TQ3Float32 *data, E3File* theFile)
+{
+	TQ3FileFormatObject				format = theFile->GetFileFormat () ;
+	TQ3XFFormatFloat32WriteMethod 		float32Write;
+	TQ3XFFormatFloat32WriteArrayMethod	float32ArrayWrite;
+	TQ3Uns32						n;
+	TQ3Status						status = kQ3Success;
+
+	Q3_REQUIRE_OR_RESULT(( theFile->GetFileStatus () == kE3_File_Status_Writing),kQ3Failure);
+	Q3_REQUIRE_OR_RESULT((format != nullptr),kQ3Failure);
+
+	
+	float32ArrayWrite = (TQ3XFFormatFloat32WriteArrayMethod) format->GetMethod ( kQ3XMethodTypeFFormatFloat32WriteArray);
+
+	if (float32ArrayWrite == nullptr)
+	{
+		float32Write = (TQ3XFFormatFloat32WriteMethod) format->GetMethod ( kQ3XMethodTypeFFormatFloat32Write);
+		Q3_REQUIRE_OR_RESULT((float32Write != nullptr),kQ3Failure);
+		
+		
+		for (n = 0; n < numNums; ++n)
+		{
+			status = float32Write( format, &data[n] );
+			if (status == kQ3Failure)
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+		status = float32ArrayWrite( format, numNums, data );
+	}
+
+	
+	return status;
+}
+
+
+
+
+
 //=============================================================================
 //      E3Float64_Read : Read a TQ3Float64.
 //-----------------------------------------------------------------------------
@@ -1246,27 +1430,8 @@ E3RawData_Write(const unsigned char *data, TQ3Uns32 size, E3File* theFile)
 TQ3Status
 E3Point2D_Read(TQ3Point2D *point2D, E3File* theFile)
 {
-	TQ3Status						result        = kQ3Failure;
-	TQ3XFFormatFloat32ReadMethod 	float32Read;
-
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileStatus () == kE3_File_Status_Reading),kQ3Failure);
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileFormat () != nullptr),kQ3Failure);
-
-	float32Read = (TQ3XFFormatFloat32ReadMethod) theFile->GetFileFormat ()->GetMethod ( kQ3XMethodTypeFFormatFloat32Read);
-
-	if(float32Read != nullptr){
-		result = float32Read( theFile->GetFileFormat (),&point2D->x);
-		if(result == kQ3Success)
-			result = float32Read( theFile->GetFileFormat (),&point2D->y);
-		}
-		
-	if (result == kQ3Success)
-		{
-		e3float32_validate( &point2D->x );
-		e3float32_validate( &point2D->y );
-		}
-
-	return(result);
+	// Read the coordinates as a single array of floats
+	return(E3Float32_ReadArray(2, (TQ3Float32 *) point2D, theFile));
 }
 
 
@@ -1306,31 +1471,8 @@ E3Point2D_Write(const TQ3Point2D *point2D, E3File* theFile)
 TQ3Status
 E3Point3D_Read(TQ3Point3D *point3D, E3File* theFile)
 {
-	TQ3Status						result = kQ3Failure;
-	TQ3XFFormatFloat32ReadMethod 	float32Read;
-
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileStatus () == kE3_File_Status_Reading),kQ3Failure);
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileFormat () != nullptr),kQ3Failure);
-
-	float32Read = (TQ3XFFormatFloat32ReadMethod) theFile->GetFileFormat ()->GetMethod ( kQ3XMethodTypeFFormatFloat32Read);
-
-	if(float32Read != nullptr){
-		result = float32Read( theFile->GetFileFormat (),&point3D->x);
-		if(result == kQ3Success)
-			result = float32Read( theFile->GetFileFormat (),&point3D->y);
-		if(result == kQ3Success)
-			result = float32Read( theFile->GetFileFormat (),&point3D->z);
-			
-		if (result == kQ3Success)
-			{
-			e3float32_validate( &point3D->x );
-			e3float32_validate( &point3D->y );
-			e3float32_validate( &point3D->z );
-			}
-		}
-		
-
-	return(result);
+	// Read the coordinates as a single array of floats
+	return(E3Float32_ReadArray(3, (TQ3Float32 *) point3D, theFile));
 }
 
 
@@ -1372,30 +1514,8 @@ E3Point3D_Write(const TQ3Point3D *point3D, E3File* theFile)
 TQ3Status
 E3RationalPoint3D_Read(TQ3RationalPoint3D *point3D, E3File* theFile)
 {
-	TQ3Status						result = kQ3Failure;
-	TQ3XFFormatFloat32ReadMethod 	float32Read;
-
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileStatus () == kE3_File_Status_Reading),kQ3Failure);
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileFormat () != nullptr),kQ3Failure);
-
-	float32Read = (TQ3XFFormatFloat32ReadMethod) theFile->GetFileFormat ()->GetMethod ( kQ3XMethodTypeFFormatFloat32Read);
-
-	if(float32Read != nullptr){
-		result = float32Read( theFile->GetFileFormat (),&point3D->x);
-		if(result == kQ3Success)
-			result = float32Read( theFile->GetFileFormat (),&point3D->y);
-		if(result == kQ3Success)
-			result = float32Read( theFile->GetFileFormat (),&point3D->w);
-
-		if (result == kQ3Success)
-			{
-			e3float32_validate( &point3D->x );
-			e3float32_validate( &point3D->y );
-			e3float32_validate( &point3D->w );
-			}
-		}
-
-	return(result);
+	// Read the coordinates as a single array of floats
+	return(E3Float32_ReadArray(3, (TQ3Float32 *) point3D, theFile));
 }
 
 
@@ -1437,33 +1557,8 @@ E3RationalPoint3D_Write(const TQ3RationalPoint3D *point3D, E3File* theFile)
 TQ3Status
 E3RationalPoint4D_Read(TQ3RationalPoint4D *point4D, E3File* theFile)
 {
-	TQ3Status						result = kQ3Failure;
-	TQ3XFFormatFloat32ReadMethod 	float32Read;
-
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileStatus () == kE3_File_Status_Reading),kQ3Failure);
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileFormat () != nullptr),kQ3Failure);
-
-	float32Read = (TQ3XFFormatFloat32ReadMethod) theFile->GetFileFormat ()->GetMethod ( kQ3XMethodTypeFFormatFloat32Read);
-
-	if(float32Read != nullptr){
-		result = float32Read( theFile->GetFileFormat (),&point4D->x);
-		if(result == kQ3Success)
-			result = float32Read( theFile->GetFileFormat (),&point4D->y);
-		if(result == kQ3Success)
-			result = float32Read( theFile->GetFileFormat (),&point4D->z);
-		if(result == kQ3Success)
-			result = float32Read( theFile->GetFileFormat (),&point4D->w);
-
-		if (result == kQ3Success)
-			{
-			e3float32_validate( &point4D->x );
-			e3float32_validate( &point4D->y );
-			e3float32_validate( &point4D->z );
-			e3float32_validate( &point4D->w );
-			}
-		}
-
-	return(result);
+	// Read the coordinates as a single array of floats
+	return(E3Float32_ReadArray(4, (TQ3Float32 *) point4D, theFile));
 }
 
 
@@ -1507,7 +1602,7 @@ E3RationalPoint4D_Write(const TQ3RationalPoint4D *point4D, E3File* theFile)
 TQ3Status
 E3Vector2D_Read(TQ3Vector2D *vector2D, E3File* theFile)
 {
-	return Q3Point2D_Read ((TQ3Point2D*)vector2D, theFile);
+	return E3Point2D_Read ((TQ3Point2D*)vector2D, theFile);
 }
 
 
@@ -1559,28 +1654,8 @@ E3Vector3D_Write(const TQ3Vector3D *vector3D, E3File* theFile)
 TQ3Status
 E3Matrix4x4_Read(TQ3Matrix4x4 *matrix4x4, E3File* theFile)
 {
-	TQ3Status						result = kQ3Failure;
-	TQ3XFFormatFloat32ReadMethod 	float32Read;
-	TQ3Uns32						i,j;
-
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileStatus () == kE3_File_Status_Reading),kQ3Failure);
-	Q3_REQUIRE_OR_RESULT(( theFile->GetFileFormat () != nullptr),kQ3Failure);
-
-	float32Read = (TQ3XFFormatFloat32ReadMethod) theFile->GetFileFormat ()->GetMethod ( kQ3XMethodTypeFFormatFloat32Read);
-
-	if(float32Read != nullptr){
-		result = kQ3Success;
-		
-		for( i = 0; ((i< 4) && (result == kQ3Success)); i++)
-			for( j = 0; ((j< 4) && (result == kQ3Success)); j++)
-				{
-				result = float32Read( theFile->GetFileFormat (),&matrix4x4->value[i][j]);
-				if (result == kQ3Success)
-					e3float32_validate( &matrix4x4->value[i][j] );
-				}
-		}
-
-	return(result);
+	// Read the rows as a single array of floats
+	return(E3Float32_ReadArray(16, (TQ3Float32 *) matrix4x4->value, theFile));
 }
 
 
@@ -1623,13 +1698,8 @@ E3Matrix4x4_Write(const TQ3Matrix4x4 *matrix4x4, E3File* theFile)
 TQ3Status
 E3Tangent2D_Read(TQ3Tangent2D *tangent2D, E3File* theFile)
 {
-	TQ3Status result = kQ3Failure;
-	
-	result = E3Vector3D_Read (&tangent2D->uTangent, theFile);
-	if(result == kQ3Success)
-		result = E3Vector3D_Read (&tangent2D->vTangent, theFile);
-
-	return(result);
+	// Read the tangents as a single array of floats
+	return(E3Float32_ReadArray(6, (TQ3Float32 *) tangent2D, theFile));
 }
 
 
@@ -1661,15 +1731,8 @@ E3Tangent2D_Write(const TQ3Tangent2D *tangent2D, E3File* theFile)
 TQ3Status
 E3Tangent3D_Read(TQ3Tangent3D *tangent3D, E3File* theFile)
 {
-	TQ3Status result = kQ3Failure;
-	
-	result = E3Vector3D_Read (&tangent3D->uTangent, theFile);
-	if(result == kQ3Success)
-		result = E3Vector3D_Read (&tangent3D->vTangent, theFile);
-	if(result == kQ3Success)
-		result = E3Vector3D_Read (&tangent3D->wTangent, theFile);
-
-	return(result);
+	// Read the tangents as a single array of floats
+	return(E3Float32_ReadArray(9, (TQ3Float32 *) tangent3D, theFile));
 }
 
 
@@ -143,12 +143,15 @@ TQ3Status			E3NewLine_Write(E3File* theFile);
 TQ3Status			E3Uns8_Read(TQ3Uns8 *data, E3File* theFile);
 TQ3Status			E3Uns8_ReadArray(TQ3Uns32 numNums, TQ3Uns8 *data, E3File* theFile);
 TQ3Status			E3Uns8_Write(TQ3Uns8 data, E3File* theFile);
+TQ3Status			E3Uns8_WriteArray(TQ3Uns32 numNums, const TQ3Uns8 *data, E3File* theFile);
 TQ3Status			E3Uns16_Read(TQ3Uns16 *data, E3File* theFile);
 TQ3Status			E3Uns16_ReadArray(TQ3Uns32 numNums, TQ3Uns16 *data, E3File* theFile);
 TQ3Status			E3Uns16_Write(TQ3Uns16 data, E3File* theFile);
+TQ3Status			E3Uns16_WriteArray(TQ3Uns32 numNums, const TQ3Uns16 *data, E3File* theFile);
 TQ3Status			E3Uns32_Read(TQ3Uns32 *data, E3File* theFile);
 TQ3Status			E3Uns32_ReadArray(TQ3Uns32 numNums, TQ3Uns32 *data, E3File* theFile);
 TQ3Status			E3Uns32_Write(TQ3Uns32 data, E3File* theFile);
+TQ3Status			E3Uns32_WriteArray(TQ3Uns32 numNums, const TQ3Uns32 *data, E3File* theFile);
 TQ3Status			E3Int8_Read(TQ3Int8 *data, E3File* theFile);
 TQ3Status			E3Int8_Write(TQ3Int8 data, E3File* theFile);
 TQ3Status			E3Int16_Read(TQ3Int16 *data, E3File* theFile);
@@ -162,6 +165,7 @@ TQ3Status			E3Int64_Write(TQ3Int64 data, E3File* theFile);
 TQ3Status			E3Float32_Read(TQ3Float32 *data, E3File* theFile);
 TQ3Status			E3Float32_ReadArray( TQ3Uns32 numFloats, TQ3Float32* theFloats, E3File* theFile);
 TQ3Status			E3Float32_Write(TQ3Float32 data, E3File* theFile);
+TQ3Status			E3Float32_WriteArray(TQ3Uns32 numNums, const TQ3Float32 *data, E3File* theFile);
 TQ3Status			E3Float64_Read(TQ3Float64 *data, E3File* theFile);
 TQ3Status			E3Float64_Write(TQ3Float64 data, E3File* theFile);
 TQ3Size				E3Size_Pad(TQ3Size size);
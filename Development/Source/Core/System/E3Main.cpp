@@ -58,6 +58,7 @@
 #include "E3Style.h"
 #include "E3String.h"
 #include "E3Transform.h"
+#include "E3Parallel.h"
 #include "E3Main.h"
 #include "E3Memory.h"
 #include "E3Storage.h"
@@ -981,6 +982,7 @@ E3Exit(void)
 
 
 		// Terminate Quesa
+		E3Parallel_Terminate();
 		E3CustomElements_UnregisterClass();
 		E3Pick_UnregisterClass();
 		E3File_UnregisterClass();
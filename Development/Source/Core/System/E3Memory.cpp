@@ -957,7 +957,7 @@ TQ3Status		E3Memory_GetStatistics( TQ3MemoryStatistics* info )
 	#if Q3_MEMORY_DEBUG
 		TQ3Status	theResult;
 
-		if (info->structureVersion == kQ3MemoryStatisticsStructureVersion)
+		if (info->structureVersion == 1 || info->structureVersion == kQ3MemoryStatisticsStructureVersion)
 		{
 			info->currentAllocations = sActiveAllocCount;
 			int64_t activeAllocBytes = sActiveAllocBytes;
@@ -968,6 +968,15 @@ TQ3Status		E3Memory_GetStatistics( TQ3MemoryStatistics* info )
 			info->maxBytes.hi = (maxAllocBytes >> 32);
 			info->maxAllocations = sMaxAllocCount;
 			
+			if (info->structureVersion >= 2)
+			{
+				int64_t poolBytes;
+				E3ClassTree::GetPoolStatistics( &info->poolAllocations,
+					&info->poolCapacity, &poolBytes );
+				info->poolBytes.lo = poolBytes & 0xFFFFFFFF;
+				info->poolBytes.hi = (poolBytes >> 32);
+			}
+			
 			theResult = kQ3Success;
 		}
 		else
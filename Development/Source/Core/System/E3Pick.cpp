@@ -48,12 +48,33 @@
 #include "E3View.h"
 #include "E3Group.h"
 #include "E3Pick.h"
+#include "E3Math.h"
+#include "E3Math_Intersect.h"
 #include "CQ3ObjectRef.h"
 #include "QuesaMathOperators.hpp"
 
 #include <algorithm>
 #include <vector>
-#include <memory>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Packet flags for a world ray batch pick
+#define kRayBatchFlagHit								0x01
+#define kRayBatchFlagParallel							0x02
+
+// Inverse direction used for a zero direction component
+#define kRayBatchInfiniteInverse						1.0e30f
+
+// Largest number of ID buffer cells along each side of a window rect pick
+#define kIDBufferMaxCells								128
+
+// Largest polygon produced by clipping a triangle to the near and far planes
+#define kIDBufferMaxClipPoints							5
 
 
 
@@ -66,9 +87,7 @@
 // Pick hit result
 struct TQ3PickHit
 {
-								TQ3PickHit() : validMask(kQ3PickDetailNone) {}
-								
-								~TQ3PickHit();
+								TQ3PickHit() : validMask(kQ3PickDetailNone), sourceIndex(kQ3ArrayIndexNULL) {}
 								
 								
 	// Mask indicating valid fields for this hit
@@ -76,9 +95,8 @@ struct TQ3PickHit
 
 	// Data for this hit
 	TQ3Uns32					pickedID;
-	TQ3HitPath					pickedPath;
+	TQ3Uns32					sourceIndex;
 	TQ3PickParts				pickedPart;
-	CQ3ObjectRef				pickedObject;
 	CQ3ObjectRef				pickedShape;
 	TQ3Point3D					hitXYZ;
 	TQ3Param2D					hitUV;
@@ -89,6 +107,24 @@ struct TQ3PickHit
 	TQ3Param3D					hitBarycentric;
 };
 
+// Traversal position a run of hits came from, shared between those hits
+struct TQ3PickHitSource
+{
+	CQ3ObjectRef				rootGroup;
+	CQ3ObjectRef				pickedObject;
+	TQ3Uns32					firstPosition;
+	TQ3Uns32					depth;
+};
+
+// Hit storage owned by a pick, reused from one pick to the next
+struct TQ3PickHitStore
+{
+	std::vector<TQ3PickHit>			hits;
+	std::vector<TQ3Uns32>			order;
+	std::vector<TQ3PickHitSource>	sources;
+	std::vector<TQ3GroupPosition>	positions;
+};
+
 struct TQ3WindowPointPickSpecificData
 {
 	TQ3Point2D	point;
@@ -99,17 +135,80 @@ struct TQ3WorldRayPickSpecificData
 	TQ3Ray3D	ray;
 };
 
+// Rays and nearest hits of a world ray batch pick. The rays are held as one
+// array per coordinate, so that a triangle can be tested against many rays
+// by a single loop which the compiler can vectorise.
+struct TQ3WorldRayBatchStore
+{
+	std::vector<float>					originX, originY, originZ;
+	std::vector<float>					dirX, dirY, dirZ;
+	std::vector<float>					invDirX, invDirY, invDirZ;
+	std::vector<float>					bestDistance;
+	std::vector<TQ3WorldRayBatchHit>	hits;
+
+	// Stack of active ray lists, with one level for each bounding box that
+	// the traversal is inside. Each level holds the rays which can still
+	// find a nearer hit within that box.
+	std::vector<TQ3Uns32>				activeRays;
+	std::vector<TQ3Uns32>				levelStarts;
+
+	// Scratch space for the rays being tested against a set of triangles
+	std::vector<float>					packetOX, packetOY, packetOZ;
+	std::vector<float>					packetDX, packetDY, packetDZ;
+	std::vector<float>					packetBest;
+	std::vector<float>					packetT, packetU, packetV;
+	std::vector<TQ3Uns8>				packetFlags;
+};
+
+struct TQ3WorldRayBatchPickSpecificData
+{
+	TQ3WorldRayBatchStore*	rayStore;
+};
+
+// A cell of the ID buffer of a visible-only window rect pick
+struct TQ3PickIDCell
+{
+	float		depth;
+	TQ3Uns32	hitIndex;
+	TQ3Uns32	faceIndex;
+};
+
+// ID buffer of a visible-only window rect pick. The pick rect is covered by
+// a grid of cells, each of which holds the nearest surface drawn into it and
+// the hit that surface belongs to. Hits are recorded as surfaces are drawn,
+// and those which are hidden are removed at the end of the pick.
+struct TQ3PickIDBuffer
+{
+	bool							isReady;
+	TQ3Uns32						numColumns;
+	TQ3Uns32						numRows;
+	float							cellSize;
+	TQ3Point2D						origin;
+	TQ3Matrix4x4					frustumToWindow;
+	TQ3Matrix4x4					windowToFrustum;
+	TQ3Matrix4x4					frustumToWorld;
+	TQ3Point3D						viewerLocation;
+	std::vector<TQ3PickIDCell>		cells;
+	std::vector<TQ3Uns32>			bufferedHits;
+	std::vector<TQ3RationalPoint4D>	clipPoints;
+};
+
 struct TQ3WindowRectPickSpecificData
 {
-	TQ3Area		rect;
+	TQ3Area				rect;
+	TQ3Boolean			visibleOnly;
+	TQ3PickIDBuffer*	idBuffer;
 };
 
 
 struct TQ3PickBaseData
 {
 	TQ3PickData							commonData;
-	std::vector<TQ3PickHit*>*			pickHits;
+	TQ3PickHitStore*					pickHits;
 	bool								isSorted;
+	bool								closestHitOnly;
+	bool								usesIDBuffer;
+	float								closestHitDistance;
 	float								vertexTolerance;
 	float								edgeTolerance;
 	float								faceTolerance;
@@ -118,13 +217,21 @@ struct TQ3PickBaseData
 
 struct CompPickNearToFar
 {
-	bool operator()( TQ3PickHit* inOne, TQ3PickHit* inTwo ) const;
+								CompPickNearToFar( const std::vector<TQ3PickHit>& inHits ) : hits( inHits ) {}
+
+	bool operator()( TQ3Uns32 inOne, TQ3Uns32 inTwo ) const;
+	
+	const std::vector<TQ3PickHit>&	hits;
 };
 
 
 struct CompPickFarToNear
 {
-	bool operator()( TQ3PickHit* inOne, TQ3PickHit* inTwo ) const;
+								CompPickFarToNear( const std::vector<TQ3PickHit>& inHits ) : hits( inHits ) {}
+
+	bool operator()( TQ3Uns32 inOne, TQ3Uns32 inTwo ) const;
+	
+	const std::vector<TQ3PickHit>&	hits;
 };
 
 
@@ -180,6 +287,19 @@ public :
 	
 
 
+class E3WorldRayBatchPick : public E3Pick  // This is a leaf class so no other classes use this,
+								// so it can be here in the .c file rather than in
+								// the .h file, hence all the fields can be public
+								// as nobody should be including this file
+{
+Q3_CLASS_ENUMS ( kQ3PickTypeWorldRayBatch, E3WorldRayBatchPick, E3Pick )
+public :
+
+	TQ3WorldRayBatchPickSpecificData	instanceData ;
+} ;
+	
+
+
 class E3ShapePart : public E3Shared // This is not a leaf class, but only classes in this,
 								// file inherit from it, so it can be declared here in
 								// the .c file rather than in the .h file, hence all
@@ -251,15 +371,7 @@ public :
 //      Internal functions
 //-----------------------------------------------------------------------------
 
-TQ3PickHit::~TQ3PickHit()
-{
-	if ((validMask & kQ3PickDetailMaskPath) != 0)
-	{
-		Q3HitPath_EmptyData( &pickedPath );
-	}
-}
-
-static float e3pick_hit_distance( TQ3PickHit* inHit )
+static float e3pick_hit_distance( const TQ3PickHit* inHit )
 {
 	float	theDistance = 0.0f;
 	if ( (inHit->validMask & kQ3PickDetailMaskDistance) != 0 )
@@ -269,14 +381,14 @@ static float e3pick_hit_distance( TQ3PickHit* inHit )
 	return theDistance;
 }
 
-bool CompPickNearToFar::operator()( TQ3PickHit* inOne, TQ3PickHit* inTwo ) const
+bool CompPickNearToFar::operator()( TQ3Uns32 inOne, TQ3Uns32 inTwo ) const
 {
-	return e3pick_hit_distance( inOne ) < e3pick_hit_distance( inTwo );
+	return e3pick_hit_distance( &hits[ inOne ] ) < e3pick_hit_distance( &hits[ inTwo ] );
 }
 
-bool CompPickFarToNear::operator()( TQ3PickHit* inOne, TQ3PickHit* inTwo ) const
+bool CompPickFarToNear::operator()( TQ3Uns32 inOne, TQ3Uns32 inTwo ) const
 {
-	return e3pick_hit_distance( inOne ) < e3pick_hit_distance( inTwo );
+	return e3pick_hit_distance( &hits[ inOne ] ) < e3pick_hit_distance( &hits[ inTwo ] );
 }
 
 //-----------------------------------------------------------------------------
@@ -328,11 +440,151 @@ e3pick_hit_duplicate_path(TQ3HitPath *pickedPath, TQ3HitPath *newPath)
 
 
 
+//=============================================================================
+//      e3pick_hit_intern_source : Find the source entry for the current hit.
+//-----------------------------------------------------------------------------
+//		Note :	Successive hits normally come from the same object, at the
+//				same position in the same groups. Rather than duplicating the
+//				hit path and taking a reference to the object for every hit,
+//				we keep one entry per traversal position in the hit store.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3pick_hit_intern_source(TQ3PickHitStore *theStore, TQ3ViewObject theView)
+{	TQ3HitPath				*currentPath;
+	TQ3Uns32				theDepth;
+
+
+
+	// Get the current position
+	currentPath = E3View_PickStack_GetPickedPath(theView);
+	CQ3ObjectRef	pickedObject( E3View_PickStack_GetPickedObject(theView) );
+
+	theDepth = 0;
+	if (currentPath->positions != nullptr && currentPath->rootGroup != nullptr)
+		theDepth = currentPath->depth;
+
+
+
+	// Reuse the last entry if it matches
+	if (!theStore->sources.empty())
+		{
+		const TQ3PickHitSource& lastSource = theStore->sources.back();
+
+		if (lastSource.pickedObject.get() == pickedObject.get() &&
+			lastSource.depth              == theDepth           &&
+			(theDepth == 0 ||
+				(lastSource.rootGroup.get() == currentPath->rootGroup &&
+				 memcmp(&theStore->positions[lastSource.firstPosition], currentPath->positions,
+						theDepth * sizeof(TQ3GroupPosition)) == 0)))
+			return(static_cast<TQ3Uns32>(theStore->sources.size() - 1));
+		}
+
+
+
+	// Otherwise add a new entry
+	TQ3PickHitSource	newSource;
+	newSource.pickedObject  = pickedObject;
+	newSource.firstPosition = static_cast<TQ3Uns32>(theStore->positions.size());
+	newSource.depth         = theDepth;
+
+	if (theDepth != 0)
+		{
+		newSource.rootGroup = CQ3ObjectRef( Q3Shared_GetReference(currentPath->rootGroup) );
+		theStore->positions.insert(theStore->positions.end(), currentPath->positions,
+									currentPath->positions + theDepth);
+		}
+
+	theStore->sources.push_back(newSource);
+
+	return(static_cast<TQ3Uns32>(theStore->sources.size() - 1));
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_viewer_location : Get the point pick distances are measured from.
+//-----------------------------------------------------------------------------
+//		Note :	World ray picks measure from the origin of the ray, window
+//				picks measure from the camera.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3pick_viewer_location(TQ3PickObject thePick, TQ3ViewObject theView, TQ3Point3D *viewerLocation)
+{	TQ3CameraPlacement		cameraPlacement;
+	TQ3CameraObject			theCamera;
+	TQ3Ray3D				pickRay;
+
+
+
+	// Use the origin of a world ray
+	if (Q3Pick_GetType( thePick ) == kQ3PickTypeWorldRay)
+		{
+		Q3WorldRayPick_GetRay( thePick, &pickRay );
+		*viewerLocation = pickRay.origin;
+		return(kQ3Success);
+		}
+
+
+
+	// Otherwise use the camera location
+	if (Q3View_GetCamera(theView, &theCamera) != kQ3Success)
+		return(kQ3Failure);
+
+	Q3Camera_GetPlacement(theCamera, &cameraPlacement);
+	Q3Object_Dispose(theCamera);
+
+	*viewerLocation = cameraPlacement.cameraLocation;
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_update_closest_mode : Update the closest-hit-only state.
+//-----------------------------------------------------------------------------
+//		Note :	A pick which only returns its nearest hit never needs the hits
+//				behind it, so we keep a single hit and publish its distance
+//				to let geometries skip anything which is farther away.
+//-----------------------------------------------------------------------------
+static void
+e3pick_update_closest_mode(TQ3PickBaseData *instanceData)
+{	float		theDistance;
+
+
+
+	// Closest-hit-only mode is used if we only want the nearest hit. An ID
+	// buffer refers to its hits by index, so it needs every hit to be kept
+	// until the end of the pick.
+	instanceData->closestHitOnly = (instanceData->commonData.sort            == kQ3PickSortNearToFar &&
+									instanceData->commonData.numHitsToReturn == 1 &&
+									!instanceData->usesIDBuffer);
+
+
+
+	// Find the distance to beat
+	instanceData->closestHitDistance = kQ3MaxFloat;
+
+	for (const TQ3PickHit& theHit : instanceData->pickHits->hits)
+		{
+		theDistance = e3pick_hit_distance( &theHit );
+		if (theDistance < instanceData->closestHitDistance)
+			instanceData->closestHitDistance = theDistance;
+		}
+}
+
+
+
+
+
 //=============================================================================
 //      e3pick_hit_initialise : Initialise a TQ3PickHit.
 //-----------------------------------------------------------------------------
 static void
 e3pick_hit_initialise(TQ3PickHit				*theHit,
+						TQ3PickHitStore			*theStore,
 						TQ3PickObject			thePick,
 						TQ3ViewObject			theView,
 						const TQ3Point3D		*hitXYZ,
@@ -341,14 +593,10 @@ e3pick_hit_initialise(TQ3PickHit				*theHit,
 						TQ3ShapePartObject		hitShape,
 						const TQ3Param3D*		hitBarycentric,
 						TQ3Uns32				hitFaceIndex )
-{	TQ3CameraPlacement		cameraPlacement;
-	TQ3HitPath				*currentPath;
-	TQ3Status				qd3dStatus;
-	TQ3CameraObject			theCamera;
-	TQ3Vector3D				eyeVector = { 0.0f, 0.0f, 0.0f };
+{	TQ3Status				qd3dStatus;
+	TQ3Point3D				viewerLocation;
 	TQ3PickData				pickData;
 	TQ3ObjectType			theType;
-	TQ3Ray3D				pickRay;
 
 
 
@@ -376,22 +624,19 @@ e3pick_hit_initialise(TQ3PickHit				*theHit,
 
 
 
-	// Save the path to the hit object
-	if (E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskPath))
+	// Save the path to the hit object, and the hit object. These are kept
+	// once per traversal position, and only turned into a TQ3HitPath or a
+	// new reference if they're asked for.
+	if (E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskPath) ||
+		E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskObject))
 		{
-		currentPath = E3View_PickStack_GetPickedPath(theView);
-		qd3dStatus  = e3pick_hit_duplicate_path(currentPath, &theHit->pickedPath);
-		if (qd3dStatus == kQ3Success)
-			theHit->validMask |= kQ3PickDetailMaskPath;
-		}
-
+		theHit->sourceIndex = e3pick_hit_intern_source(theStore, theView);
+		const TQ3PickHitSource& theSource = theStore->sources[theHit->sourceIndex];
 
+		if (E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskPath) && theSource.depth != 0)
+			theHit->validMask |= kQ3PickDetailMaskPath;
 
-	// Save the hit object
-	if (E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskObject))
-		{
-		theHit->pickedObject = CQ3ObjectRef( E3View_PickStack_GetPickedObject(theView) );
-		if (theHit->pickedObject.isvalid())
+		if (E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskObject) && theSource.pickedObject.isvalid())
 			theHit->validMask |= kQ3PickDetailMaskObject;
 		}
 
@@ -419,23 +664,10 @@ e3pick_hit_initialise(TQ3PickHit				*theHit,
 	// Save the distance to the viewer
 	if (E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskDistance) && hitXYZ != nullptr)
 		{
-		if (Q3Pick_GetType( thePick ) == kQ3PickTypeWorldRay)
-			{
-			Q3WorldRayPick_GetRay( thePick, &pickRay );
-			Q3Point3D_Subtract(hitXYZ, &pickRay.origin, &eyeVector);
-			}
-		else
-			{
-			qd3dStatus = Q3View_GetCamera(theView, &theCamera);
-			if (qd3dStatus == kQ3Success)
-				{
-				Q3Camera_GetPlacement(theCamera, &cameraPlacement);
-				Q3Point3D_Subtract(hitXYZ, &cameraPlacement.cameraLocation, &eyeVector);
-				Q3Object_Dispose(theCamera);
+		if (e3pick_viewer_location(thePick, theView, &viewerLocation) != kQ3Success)
+			viewerLocation = *hitXYZ;
 
-				}
-			}
-		theHit->hitDistance = Q3Vector3D_Length(&eyeVector);
+		theHit->hitDistance = Q3Point3D_Distance(hitXYZ, &viewerLocation);
 		theHit->validMask  |= kQ3PickDetailMaskDistance;
 		}
 
@@ -549,8 +781,12 @@ e3pick_hit_initialise(TQ3PickHit				*theHit,
 static TQ3PickHit *
 e3pick_hit_find(TQ3PickBaseData *pickInstanceData, TQ3Uns32 n)
 {
+	TQ3PickHitStore		*theStore = pickInstanceData->pickHits;
+
+
+
 	// Check we're not out of range
-	if (n >= pickInstanceData->pickHits->size())
+	if (n >= theStore->hits.size())
 		return(nullptr);
 	
 	if (pickInstanceData->commonData.numHitsToReturn != kQ3ReturnAllHits)
@@ -566,13 +802,13 @@ e3pick_hit_find(TQ3PickBaseData *pickInstanceData, TQ3Uns32 n)
 		switch (pickInstanceData->commonData.sort)
 		{
 			case kQ3PickSortNearToFar:
-				std::sort( pickInstanceData->pickHits->begin(),
-					pickInstanceData->pickHits->end(), CompPickNearToFar() );
+				std::sort( theStore->order.begin(),
+					theStore->order.end(), CompPickNearToFar( theStore->hits ) );
 				break;
 			
 			case kQ3PickSortFarToNear:
-				std::sort( pickInstanceData->pickHits->begin(),
-					pickInstanceData->pickHits->end(), CompPickFarToNear() );
+				std::sort( theStore->order.begin(),
+					theStore->order.end(), CompPickFarToNear( theStore->hits ) );
 				break;
 			
 			default:
@@ -583,7 +819,7 @@ e3pick_hit_find(TQ3PickBaseData *pickInstanceData, TQ3Uns32 n)
 
 
 	// Return the one we want
-	return (*pickInstanceData->pickHits)[ n ];
+	return &theStore->hits[ theStore->order[ n ] ];
 }
 
 
@@ -621,14 +857,16 @@ e3pick_new(TQ3Object theObject, void *privateData, const void *paramData)
 
 
 	// Initialise our instance data
-	instanceData->pickHits = new std::vector<TQ3PickHit*>;
+	instanceData->pickHits = new TQ3PickHitStore;
 	instanceData->commonData = *pickData;
 	instanceData->isSorted = false;
+	instanceData->usesIDBuffer = false;
 	instanceData->vertexTolerance = 0.0f;
 	instanceData->edgeTolerance = 0.0f;
 	instanceData->faceTolerance = 0.0f;
 
 	e3pick_set_sort_mask( &instanceData->commonData );
+	e3pick_update_closest_mode( instanceData );
 	
 	return(kQ3Success);
 }
@@ -754,13 +992,15 @@ e3pick_windowpoint_metahandler(TQ3XMethodType methodType)
 static TQ3Status
 e3pick_windowrect_new(TQ3Object theObject, void *privateData, const void *paramData)
 {
-	TQ3Area				*instanceData = (TQ3Area *) privateData;
+	TQ3WindowRectPickSpecificData	*instanceData = (TQ3WindowRectPickSpecificData *) privateData;
 	const TQ3WindowRectPickData		*pickData     = (const TQ3WindowRectPickData *) paramData;
 
 
 
 	// Initialise our instance data
-	*instanceData = pickData->rect;
+	instanceData->rect        = pickData->rect;
+	instanceData->visibleOnly = kQ3False;
+	instanceData->idBuffer    = nullptr;
 
 	return(kQ3Success);
 }
@@ -775,6 +1015,14 @@ e3pick_windowrect_new(TQ3Object theObject, void *privateData, const void *paramD
 static void
 e3pick_windowrect_delete(TQ3Object theObject, void *privateData)
 {
+	TQ3WindowRectPickSpecificData* instanceData = (TQ3WindowRectPickSpecificData *) privateData;
+#pragma unused(theObject)
+
+
+
+	// Dispose of our instance data
+	delete instanceData->idBuffer;
+	instanceData->idBuffer = nullptr;
 }
 
 
@@ -807,37 +1055,48 @@ e3pick_windowrect_metahandler(TQ3XMethodType methodType)
 
 
 
-#pragma mark -
+
 //=============================================================================
-//      e3pick_worldray_new : World ray pick new method.
+//      e3pick_idbuffer_setup : Prepare the ID buffer for a pick.
 //-----------------------------------------------------------------------------
-static TQ3Status
-e3pick_worldray_new(TQ3Object theObject, void *privateData, const void *paramData)
-{
-	TQ3WorldRayPickSpecificData* instanceData = (TQ3WorldRayPickSpecificData *) privateData;
-	const TQ3WorldRayPickData	*pickData     = (const TQ3WorldRayPickData *) paramData;
-	E3Pick* parentOb = (E3Pick*) theObject;
+//		Note :	The buffer covers the pick rect with square cells of at least
+//				one pixel, and at most kIDBufferMaxCells along each side.
+//-----------------------------------------------------------------------------
+static void
+e3pick_idbuffer_setup(TQ3PickIDBuffer *theBuffer, const TQ3Area *theRect, TQ3PickObject thePick, TQ3ViewObject theView)
+{	TQ3Matrix4x4		worldToView;
+	TQ3PickIDCell		emptyCell;
+	float				theWidth, theHeight;
 
 
 
-	// Initialise our instance data
-	instanceData->ray = pickData->ray;
-	parentOb->baseInstanceData.vertexTolerance = pickData->vertexTolerance;
-	parentOb->baseInstanceData.edgeTolerance = pickData->edgeTolerance;
-	
-	return(kQ3Success);
-}
+	// Size the grid
+	theWidth  = E3Num_Max(theRect->max.x - theRect->min.x, 0.0f);
+	theHeight = E3Num_Max(theRect->max.y - theRect->min.y, 0.0f);
 
+	theBuffer->cellSize   = E3Num_Max(1.0f, E3Num_Max(theWidth, theHeight) / (float) kIDBufferMaxCells);
+	theBuffer->numColumns = E3Num_Max(1U, (TQ3Uns32) ceilf(theWidth  / theBuffer->cellSize));
+	theBuffer->numRows    = E3Num_Max(1U, (TQ3Uns32) ceilf(theHeight / theBuffer->cellSize));
+	theBuffer->origin     = theRect->min;
 
+	emptyCell.depth     = kQ3MaxFloat;
+	emptyCell.hitIndex  = kQ3ArrayIndexNULL;
+	emptyCell.faceIndex = kQ3ArrayIndexNULL;
+	theBuffer->cells.assign(theBuffer->numColumns * theBuffer->numRows, emptyCell);
 
 
 
-//=============================================================================
-//      e3pick_worldray_delete : World ray pick delete method.
-//-----------------------------------------------------------------------------
-static void
-e3pick_worldray_delete(TQ3Object theObject, void *privateData)
-{
+	// Save the transforms to and from the window, which are fixed for the pick
+	( (E3Camera*) E3View_AccessCamera(theView) )->GetWorldToView( &worldToView );
+	E3View_GetFrustumToWindowMatrixState(theView, &theBuffer->frustumToWindow);
+
+	theBuffer->windowToFrustum = Q3Invert( theBuffer->frustumToWindow );
+	theBuffer->frustumToWorld  = Q3Invert( worldToView * E3View_State_GetMatrixCameraToFrustum(theView) );
+
+	if (e3pick_viewer_location(thePick, theView, &theBuffer->viewerLocation) != kQ3Success)
+		theBuffer->viewerLocation.x = theBuffer->viewerLocation.y = theBuffer->viewerLocation.z = 0.0f;
+
+	theBuffer->isReady = true;
 }
 
 
@@ -845,26 +1104,45 @@ e3pick_worldray_delete(TQ3Object theObject, void *privateData)
 
 
 //=============================================================================
-//      e3pick_worldray_metahandler : World ray pick metahandler.
+//      e3pick_idbuffer_clip_polygon : Clip a polygon against a frustum plane.
 //-----------------------------------------------------------------------------
-static TQ3XFunctionPointer
-e3pick_worldray_metahandler(TQ3XMethodType methodType)
-{	TQ3XFunctionPointer		theMethod = nullptr;
+//		Note :	The plane is given by the coefficients of a linear function
+//				of the frustum-space coordinates, with the kept side being
+//				where the function is non-negative.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3pick_idbuffer_clip_polygon(const TQ3RationalPoint4D *inPoints, TQ3Uns32 numIn,
+								const TQ3RationalPoint4D &thePlane, TQ3RationalPoint4D *outPoints)
+{	float		distA, distB, t;
+	TQ3Uns32	n, numOut;
 
 
 
-	// Return our methods
-	switch (methodType) {
-		case kQ3XMethodTypeObjectNew:
-			theMethod = (TQ3XFunctionPointer) e3pick_worldray_new;
-			break;
+	// Clip each edge in turn
+	numOut = 0;
+	for (n = 0; n < numIn; n++)
+		{
+		const TQ3RationalPoint4D& ptA = inPoints[n];
+		const TQ3RationalPoint4D& ptB = inPoints[(n + 1) % numIn];
 
-		case kQ3XMethodTypeObjectDelete:
-			theMethod = (TQ3XFunctionPointer) e3pick_worldray_delete;
-			break;
+		distA = ptA.x * thePlane.x + ptA.y * thePlane.y + ptA.z * thePlane.z + ptA.w * thePlane.w;
+		distB = ptB.x * thePlane.x + ptB.y * thePlane.y + ptB.z * thePlane.z + ptB.w * thePlane.w;
+
+		if (distA >= 0.0f)
+			outPoints[numOut++] = ptA;
+
+		if ((distA >= 0.0f) != (distB >= 0.0f))
+			{
+			t = distA / (distA - distB);
+			outPoints[numOut].x = ptA.x + t * (ptB.x - ptA.x);
+			outPoints[numOut].y = ptA.y + t * (ptB.y - ptA.y);
+			outPoints[numOut].z = ptA.z + t * (ptB.z - ptA.z);
+			outPoints[numOut].w = ptA.w + t * (ptB.w - ptA.w);
+			numOut++;
+			}
 		}
-	
-	return(theMethod);
+
+	return(numOut);
 }
 
 
@@ -872,70 +1150,98 @@ e3pick_worldray_metahandler(TQ3XMethodType methodType)
 
 
 //=============================================================================
-//      e3shapepart_new : Shape part new method.
+//      e3pick_idbuffer_raster_triangle : Draw a triangle into the ID buffer.
 //-----------------------------------------------------------------------------
-#pragma mark -
-static TQ3Status
-e3shapepart_new(TQ3Object theObject, void *privateData, const void *paramData)
-{	TQ3ShapeObject			*instanceData = (TQ3ShapeObject *)       privateData;
-	const TQ3ShapeObject	*shape        = (const TQ3ShapeObject *) paramData;
-#pragma unused(theObject)
+//		Note :	The triangle is given in window coordinates, with z holding
+//				the depth. A cell is covered if its centre is inside the
+//				triangle, and is written if the triangle is nearer than what
+//				the cell already holds.
+//
+//				Returns the index of the nearest cell written for this hit,
+//				updating the index which was passed in.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3pick_idbuffer_raster_triangle(TQ3PickIDBuffer *theBuffer, const TQ3Point3D *thePoints,
+								TQ3Uns32 hitIndex, TQ3Uns32 faceIndex, TQ3Boolean cullBackface,
+								TQ3Uns32 nearestCell)
+{	float		theArea, invArea, minX, maxX, minY, maxY, cellX, cellY, b0, b1, b2, theDepth;
+	TQ3Int32	firstCol, lastCol, firstRow, lastRow, col, row;
+	TQ3Point2D	cellPts[3];
+	TQ3Uns32	n, cellIndex;
 
 
 
-	// Initialise our instance data
-	if (*shape)
-		*instanceData = Q3Shared_GetReference(*shape);
-	else
-		*instanceData = nullptr;
+	// Convert to cell coordinates, where cell centres fall on whole numbers
+	for (n = 0; n < 3; n++)
+		{
+		cellPts[n].x = (thePoints[n].x - theBuffer->origin.x) / theBuffer->cellSize - 0.5f;
+		cellPts[n].y = (thePoints[n].y - theBuffer->origin.y) / theBuffer->cellSize - 0.5f;
+		}
 
-	return(kQ3Success);
-}
 
 
+	// Find the orientation. Window y runs downwards, so a front face, which
+	// is counter-clockwise as seen by the camera, has a negative area.
+	theArea = (cellPts[1].x - cellPts[0].x) * (cellPts[2].y - cellPts[0].y) -
+			  (cellPts[1].y - cellPts[0].y) * (cellPts[2].x - cellPts[0].x);
 
+	if (fabsf(theArea) < kQ3RealZero || (cullBackface && theArea > 0.0f))
+		return(nearestCell);
 
+	invArea = 1.0f / theArea;
 
-//=============================================================================
-//      e3shapepart_delete : Shape part delete method.
-//-----------------------------------------------------------------------------
-static void
-e3shapepart_delete(TQ3Object theObject, void *privateData)
-{	TQ3ShapeObject			*instanceData = (TQ3ShapeObject *) privateData;
-#pragma unused(theObject)
 
 
+	// Find the cells which may be covered
+	minX = E3Num_Min(cellPts[0].x, E3Num_Min(cellPts[1].x, cellPts[2].x));
+	maxX = E3Num_Max(cellPts[0].x, E3Num_Max(cellPts[1].x, cellPts[2].x));
+	minY = E3Num_Min(cellPts[0].y, E3Num_Min(cellPts[1].y, cellPts[2].y));
+	maxY = E3Num_Max(cellPts[0].y, E3Num_Max(cellPts[1].y, cellPts[2].y));
 
-	// Dispose of our instance data
-	if (*instanceData)
-		Q3Object_Dispose(*instanceData);
-}
+	if (maxX < 0.0f || maxY < 0.0f ||
+		minX > (float) (theBuffer->numColumns - 1) || minY > (float) (theBuffer->numRows - 1))
+		return(nearestCell);
 
+	firstCol = (TQ3Int32) ceilf( E3Num_Max(minX, 0.0f) );
+	lastCol  = (TQ3Int32) floorf(E3Num_Min(maxX, (float) (theBuffer->numColumns - 1)));
+	firstRow = (TQ3Int32) ceilf( E3Num_Max(minY, 0.0f) );
+	lastRow  = (TQ3Int32) floorf(E3Num_Min(maxY, (float) (theBuffer->numRows - 1)));
 
 
 
+	// Test each cell centre against the edges of the triangle
+	for (row = firstRow; row <= lastRow; row++)
+		{
+		cellY = (float) row;
 
-//=============================================================================
-//      e3shapepart_metahandler : Shape part metahandler.
-//-----------------------------------------------------------------------------
-static TQ3XFunctionPointer
-e3shapepart_metahandler(TQ3XMethodType methodType)
-{	TQ3XFunctionPointer		theMethod = nullptr;
+		for (col = firstCol; col <= lastCol; col++)
+			{
+			cellX = (float) col;
 
+			b0 = ((cellPts[1].x - cellX) * (cellPts[2].y - cellY) - (cellPts[1].y - cellY) * (cellPts[2].x - cellX)) * invArea;
+			b1 = ((cellPts[2].x - cellX) * (cellPts[0].y - cellY) - (cellPts[2].y - cellY) * (cellPts[0].x - cellX)) * invArea;
+			b2 = 1.0f - b0 - b1;
 
+			if (b0 < 0.0f || b1 < 0.0f || b2 < 0.0f)
+				continue;
 
-	// Return our methods
-	switch (methodType) {
-		case kQ3XMethodTypeObjectNew:
-			theMethod = (TQ3XFunctionPointer) e3shapepart_new;
-			break;
+			theDepth  = b0 * thePoints[0].z + b1 * thePoints[1].z + b2 * thePoints[2].z;
+			cellIndex = (TQ3Uns32) row * theBuffer->numColumns + (TQ3Uns32) col;
 
-		case kQ3XMethodTypeObjectDelete:
-			theMethod = (TQ3XFunctionPointer) e3shapepart_delete;
-			break;
+			TQ3PickIDCell& theCell = theBuffer->cells[cellIndex];
+			if (theDepth >= theCell.depth)
+				continue;
+
+			theCell.depth     = theDepth;
+			theCell.hitIndex  = hitIndex;
+			theCell.faceIndex = faceIndex;
+
+			if (nearestCell == kQ3ArrayIndexNULL || theDepth < theBuffer->cells[nearestCell].depth)
+				nearestCell = cellIndex;
+			}
 		}
-	
-	return(theMethod);
+
+	return(nearestCell);
 }
 
 
@@ -943,19 +1249,435 @@ e3shapepart_metahandler(TQ3XMethodType methodType)
 
 
 //=============================================================================
-//      e3meshpart__new : Mesh part new method.
+//      e3pick_idbuffer_cell_to_world : Get the world point of a cell.
 //-----------------------------------------------------------------------------
-static TQ3Status
-e3meshpart__new(TQ3Object theObject, void *privateData, const void *paramData)
-{	TQ3MeshComponent			*instanceData = (TQ3MeshComponent *)       privateData;
-	const TQ3MeshComponent		*data         = (const TQ3MeshComponent *) paramData;
-#pragma unused(theObject)
+static void
+e3pick_idbuffer_cell_to_world(const TQ3PickIDBuffer *theBuffer, TQ3Uns32 cellIndex, TQ3Point3D *worldPoint)
+{	TQ3Point3D		windowPoint, frustumPoint;
 
 
 
-	// Initialise our instance data
-	*instanceData = *data;
-	return(kQ3Success);
+	// Find the centre of the cell in the window
+	windowPoint.x = theBuffer->origin.x + ((float) (cellIndex % theBuffer->numColumns) + 0.5f) * theBuffer->cellSize;
+	windowPoint.y = theBuffer->origin.y + ((float) (cellIndex / theBuffer->numColumns) + 0.5f) * theBuffer->cellSize;
+	windowPoint.z = 0.0f;
+
+
+
+	// Convert to frustum coordinates, restoring the depth, then to the world
+	Q3Point3D_Transform(&windowPoint, &theBuffer->windowToFrustum, &frustumPoint);
+	frustumPoint.z = -theBuffer->cells[cellIndex].depth;
+
+	Q3Point3D_Transform(&frustumPoint, &theBuffer->frustumToWorld, worldPoint);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_idbuffer_resolve : Remove the hits hidden in the ID buffer.
+//-----------------------------------------------------------------------------
+//		Note :	Hits recorded by the ID buffer which are not visible in any
+//				cell are removed. The others take their position and TriMesh
+//				face from their nearest visible cell.
+//-----------------------------------------------------------------------------
+static void
+e3pick_idbuffer_resolve(TQ3PickBaseData *instanceData, TQ3PickIDBuffer *theBuffer)
+{	TQ3Uns32		n, numHits, hitIndex, cellIndex, numKept;
+
+
+
+	// Find the nearest visible cell of each hit
+	TQ3PickHitStore*	theStore = instanceData->pickHits;
+	numHits = static_cast<TQ3Uns32>(theStore->hits.size());
+
+	std::vector<TQ3Uns32>	nearestCell(numHits, kQ3ArrayIndexNULL);
+	std::vector<bool>		keepHit(numHits, true);
+
+	for (n = 0; n < theBuffer->cells.size(); n++)
+		{
+		hitIndex = theBuffer->cells[n].hitIndex;
+		if (hitIndex < numHits &&
+			(nearestCell[hitIndex] == kQ3ArrayIndexNULL ||
+			 theBuffer->cells[n].depth < theBuffer->cells[nearestCell[hitIndex]].depth))
+			nearestCell[hitIndex] = n;
+		}
+
+
+
+	// Update or drop the hits from the buffer
+	for (TQ3Uns32 bufferedHit : theBuffer->bufferedHits)
+		{
+		if (bufferedHit >= numHits)
+			continue;
+
+		cellIndex = nearestCell[bufferedHit];
+		if (cellIndex == kQ3ArrayIndexNULL)
+			{
+			keepHit[bufferedHit] = false;
+			continue;
+			}
+
+		TQ3PickHit& theHit = theStore->hits[bufferedHit];
+		TQ3Point3D	worldPoint;
+		e3pick_idbuffer_cell_to_world(theBuffer, cellIndex, &worldPoint);
+
+		if (E3Bit_IsSet(theHit.validMask, kQ3PickDetailMaskXYZ))
+			theHit.hitXYZ = worldPoint;
+
+		if (E3Bit_IsSet(theHit.validMask, kQ3PickDetailMaskDistance))
+			theHit.hitDistance = Q3Point3D_Distance(&worldPoint, &theBuffer->viewerLocation);
+
+		if (E3Bit_IsSet(theHit.validMask, kQ3PickDetailMaskTriMeshFace))
+			theHit.hitTriMeshFaceIndex = theBuffer->cells[cellIndex].faceIndex;
+		}
+
+
+
+	// Compact the hit list
+	numKept = 0;
+	for (n = 0; n < numHits; n++)
+		{
+		if (keepHit[n])
+			{
+			if (numKept != n)
+				theStore->hits[numKept] = std::move(theStore->hits[n]);
+			numKept++;
+			}
+		}
+
+	theStore->hits.resize(numKept);
+	theStore->order.resize(numKept);
+	for (n = 0; n < numKept; n++)
+		theStore->order[n] = n;
+
+	instanceData->isSorted = false;
+
+
+
+	// Reset the buffer for the next pick
+	theBuffer->bufferedHits.clear();
+	theBuffer->isReady = false;
+}
+
+
+
+
+#pragma mark -
+//=============================================================================
+//      e3pick_worldray_new : World ray pick new method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3pick_worldray_new(TQ3Object theObject, void *privateData, const void *paramData)
+{
+	TQ3WorldRayPickSpecificData* instanceData = (TQ3WorldRayPickSpecificData *) privateData;
+	const TQ3WorldRayPickData	*pickData     = (const TQ3WorldRayPickData *) paramData;
+	E3Pick* parentOb = (E3Pick*) theObject;
+
+
+
+	// Initialise our instance data
+	instanceData->ray = pickData->ray;
+	parentOb->baseInstanceData.vertexTolerance = pickData->vertexTolerance;
+	parentOb->baseInstanceData.edgeTolerance = pickData->edgeTolerance;
+	
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldray_delete : World ray pick delete method.
+//-----------------------------------------------------------------------------
+static void
+e3pick_worldray_delete(TQ3Object theObject, void *privateData)
+{
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldray_metahandler : World ray pick metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3pick_worldray_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+		case kQ3XMethodTypeObjectNew:
+			theMethod = (TQ3XFunctionPointer) e3pick_worldray_new;
+			break;
+
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3pick_worldray_delete;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+#pragma mark -
+//=============================================================================
+//      e3pick_worldraybatch_set_rays : Set the rays of a world ray batch pick.
+//-----------------------------------------------------------------------------
+//		Note :	Ray directions are normalised, so that the distance along a
+//				ray is also the distance from its origin. Rays without a
+//				direction are never active, and so never hit anything.
+//-----------------------------------------------------------------------------
+static void
+e3pick_worldraybatch_set_rays(TQ3WorldRayBatchStore *theStore, TQ3Uns32 numRays, const TQ3Ray3D *rays)
+{	TQ3Vector3D		theDir;
+	float			theLength;
+	TQ3Uns32		n;
+
+
+
+	// Size the arrays
+	theStore->originX.resize(numRays);
+	theStore->originY.resize(numRays);
+	theStore->originZ.resize(numRays);
+	theStore->dirX.resize(numRays);
+	theStore->dirY.resize(numRays);
+	theStore->dirZ.resize(numRays);
+	theStore->invDirX.resize(numRays);
+	theStore->invDirY.resize(numRays);
+	theStore->invDirZ.resize(numRays);
+	theStore->bestDistance.resize(numRays);
+	theStore->hits.resize(numRays);
+	theStore->activeRays.clear();
+	theStore->levelStarts.assign(1, 0);
+
+
+
+	// Copy the rays, and make the valid rays active
+	for (n = 0; n < numRays; n++)
+		{
+		theDir    = rays[n].direction;
+		theLength = Q3FastVector3D_Length(&theDir);
+		if (theLength > kQ3RealZero)
+			{
+			theDir *= (1.0f / theLength);
+			theStore->activeRays.push_back(n);
+			}
+		else
+			theDir.x = theDir.y = theDir.z = 0.0f;
+
+		theStore->originX[n] = rays[n].origin.x;
+		theStore->originY[n] = rays[n].origin.y;
+		theStore->originZ[n] = rays[n].origin.z;
+		theStore->dirX[n]    = theDir.x;
+		theStore->dirY[n]    = theDir.y;
+		theStore->dirZ[n]    = theDir.z;
+
+		theStore->invDirX[n] = (fabsf(theDir.x) > kQ3RealZero) ? 1.0f / theDir.x : kRayBatchInfiniteInverse;
+		theStore->invDirY[n] = (fabsf(theDir.y) > kQ3RealZero) ? 1.0f / theDir.y : kRayBatchInfiniteInverse;
+		theStore->invDirZ[n] = (fabsf(theDir.z) > kQ3RealZero) ? 1.0f / theDir.z : kRayBatchInfiniteInverse;
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_empty_hits : Forget the hits of a batch pick.
+//-----------------------------------------------------------------------------
+static void
+e3pick_worldraybatch_empty_hits(TQ3WorldRayBatchStore *theStore)
+{	TQ3WorldRayBatchHit		noHit;
+
+
+
+	// Reset the hits
+	Q3Memory_Clear(&noHit, sizeof(noHit));
+	noHit.didHit              = kQ3False;
+	noHit.hitDistance         = kQ3MaxFloat;
+	noHit.hitTriMeshFaceIndex = kQ3ArrayIndexNULL;
+
+	std::fill(theStore->hits.begin(),         theStore->hits.end(),         noHit);
+	std::fill(theStore->bestDistance.begin(), theStore->bestDistance.end(), kQ3MaxFloat);
+
+
+
+	// Drop any bounds left over from an abandoned traversal
+	if (theStore->levelStarts.size() > 1)
+		{
+		theStore->activeRays.resize(theStore->levelStarts[1]);
+		theStore->levelStarts.resize(1);
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_new : World ray batch pick new method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3pick_worldraybatch_new(TQ3Object theObject, void *privateData, const void *paramData)
+{
+	TQ3WorldRayBatchPickSpecificData* instanceData = (TQ3WorldRayBatchPickSpecificData *) privateData;
+	const TQ3WorldRayBatchPickData	*pickData      = (const TQ3WorldRayBatchPickData *) paramData;
+#pragma unused(theObject)
+
+
+
+	// Initialise our instance data
+	instanceData->rayStore = new TQ3WorldRayBatchStore;
+	e3pick_worldraybatch_set_rays(instanceData->rayStore, pickData->numRays, pickData->rays);
+	e3pick_worldraybatch_empty_hits(instanceData->rayStore);
+	
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_delete : World ray batch pick delete method.
+//-----------------------------------------------------------------------------
+static void
+e3pick_worldraybatch_delete(TQ3Object theObject, void *privateData)
+{
+	TQ3WorldRayBatchPickSpecificData* instanceData = (TQ3WorldRayBatchPickSpecificData *) privateData;
+#pragma unused(theObject)
+
+
+
+	// Dispose of our instance data
+	delete instanceData->rayStore;
+	instanceData->rayStore = nullptr;
+}
+
+
+
+
+
+//=============================================================================
+//      e3pick_worldraybatch_metahandler : World ray batch pick metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3pick_worldraybatch_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+		case kQ3XMethodTypeObjectNew:
+			theMethod = (TQ3XFunctionPointer) e3pick_worldraybatch_new;
+			break;
+
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3pick_worldraybatch_delete;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+
+//=============================================================================
+//      e3shapepart_new : Shape part new method.
+//-----------------------------------------------------------------------------
+#pragma mark -
+static TQ3Status
+e3shapepart_new(TQ3Object theObject, void *privateData, const void *paramData)
+{	TQ3ShapeObject			*instanceData = (TQ3ShapeObject *)       privateData;
+	const TQ3ShapeObject	*shape        = (const TQ3ShapeObject *) paramData;
+#pragma unused(theObject)
+
+
+
+	// Initialise our instance data
+	if (*shape)
+		*instanceData = Q3Shared_GetReference(*shape);
+	else
+		*instanceData = nullptr;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3shapepart_delete : Shape part delete method.
+//-----------------------------------------------------------------------------
+static void
+e3shapepart_delete(TQ3Object theObject, void *privateData)
+{	TQ3ShapeObject			*instanceData = (TQ3ShapeObject *) privateData;
+#pragma unused(theObject)
+
+
+
+	// Dispose of our instance data
+	if (*instanceData)
+		Q3Object_Dispose(*instanceData);
+}
+
+
+
+
+
+//=============================================================================
+//      e3shapepart_metahandler : Shape part metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3shapepart_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+		case kQ3XMethodTypeObjectNew:
+			theMethod = (TQ3XFunctionPointer) e3shapepart_new;
+			break;
+
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3shapepart_delete;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+
+//=============================================================================
+//      e3meshpart__new : Mesh part new method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3meshpart__new(TQ3Object theObject, void *privateData, const void *paramData)
+{	TQ3MeshComponent			*instanceData = (TQ3MeshComponent *)       privateData;
+	const TQ3MeshComponent		*data         = (const TQ3MeshComponent *) paramData;
+#pragma unused(theObject)
+
+
+
+	// Initialise our instance data
+	*instanceData = *data;
+	return(kQ3Success);
 }
 
 
@@ -1146,6 +1868,11 @@ E3Pick_RegisterClass(void)
 		qd3dStatus = Q3_REGISTER_CLASS (	kQ3ClassNamePickWorldRay,
 											e3pick_worldray_metahandler,
 											E3WorldRayPick ) ;
+
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = Q3_REGISTER_CLASS (	kQ3ClassNamePickWorldRayBatch,
+											e3pick_worldraybatch_metahandler,
+											E3WorldRayBatchPick ) ;
 	
 	//----------------------------------------------------------------------------------
 	
@@ -1203,6 +1930,7 @@ E3Pick_UnregisterClass(void)
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3ShapePartTypeMeshPart,		kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3SharedTypeShapePart,		kQ3True)) && succeeded;
 
+	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWorldRayBatch,	kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWorldRay,			kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWindowRect,		kQ3True)) && succeeded;
 	succeeded = (kQ3Success == E3ClassTree::UnregisterClass(kQ3PickTypeWindowPoint,		kQ3True)) && succeeded;
@@ -1288,6 +2016,7 @@ E3Pick_SetData(TQ3PickObject thePick, const TQ3PickData *data)
 	baseData->commonData = *data;
 
 	e3pick_set_sort_mask(&baseData->commonData);
+	e3pick_update_closest_mode(baseData);
 
 	return(kQ3Success);
 }
@@ -1413,7 +2142,7 @@ E3Pick_GetNumHits(TQ3PickObject inPick, TQ3Uns32 *numHits)
 
 
 	// Get the field, clamping it if a limit was supplied
-	*numHits = static_cast<TQ3Uns32>(instanceData->pickHits->size());
+	*numHits = static_cast<TQ3Uns32>(instanceData->pickHits->hits.size());
 	
 	if (instanceData->commonData.numHitsToReturn != kQ3ReturnAllHits)
 	{
@@ -1439,16 +2168,22 @@ E3Pick_EmptyHitList(TQ3PickObject inPick)
 	TQ3PickBaseData	*instanceData = (TQ3PickBaseData *) &thePick->baseInstanceData;
 
 
-	// Dispose of the hit list
-	std::vector<TQ3PickHit*>::iterator endIt = instanceData->pickHits->end();
-	
-	for (std::vector<TQ3PickHit*>::iterator i = instanceData->pickHits->begin();
-		i != endIt; ++i)
-	{
-		delete *i;
-	}
-	
-	instanceData->pickHits->clear();
+	// Empty the hit list, keeping its storage for the next pick
+	instanceData->pickHits->hits.clear();
+	instanceData->pickHits->order.clear();
+	instanceData->pickHits->sources.clear();
+	instanceData->pickHits->positions.clear();
+	instanceData->closestHitDistance = kQ3MaxFloat;
+
+
+
+	// A batch pick keeps its hits with its rays
+	if (E3Pick_GetType( inPick ) == kQ3PickTypeWorldRayBatch)
+		{
+		TQ3WorldRayBatchStore* theStore = ( (E3WorldRayBatchPick*) thePick )->instanceData.rayStore;
+		if (theStore != nullptr)
+			e3pick_worldraybatch_empty_hits(theStore);
+		}
 
 	return(kQ3Success);
 }
@@ -1525,11 +2260,18 @@ E3Pick_GetPickDetailData(TQ3PickObject inPick, TQ3Uns32 index, TQ3PickDetail pic
 			*((TQ3Int32*)(detailData)) = theHit->pickedID;
 			break;
 		case kQ3PickDetailMaskPath:
-			qd3dStatus = e3pick_hit_duplicate_path(&theHit->pickedPath, (TQ3HitPath *) detailData);
+			{
+			TQ3PickHitSource& theSource = instanceData->pickHits->sources[ theHit->sourceIndex ];
+			TQ3HitPath sourcePath;
+			sourcePath.rootGroup = theSource.rootGroup.get();
+			sourcePath.depth     = theSource.depth;
+			sourcePath.positions = &instanceData->pickHits->positions[ theSource.firstPosition ];
+			qd3dStatus = e3pick_hit_duplicate_path(&sourcePath, (TQ3HitPath *) detailData);
+			}
 			break;
 		case kQ3PickDetailMaskObject:
 			*((TQ3SharedObject*)(detailData)) = Q3Shared_GetReference(
-				(TQ3SharedObject _Nonnull) theHit->pickedObject.get() );
+				(TQ3SharedObject _Nonnull) instanceData->pickHits->sources[ theHit->sourceIndex ].pickedObject.get() );
 			break;
 		case kQ3PickDetailMaskLocalToWorldMatrix:
 			*((TQ3Matrix4x4*)(detailData)) = theHit->localToWorld;
@@ -1623,34 +2365,171 @@ E3Pick_RecordHit(TQ3PickObject				inPick,
 	}
 	
 	
+	// If we only want the nearest hit, ignore anything which isn't nearer
+	// than the hit we have. Hits without a location sort as distance 0.
+	float	theDistance = 0.0f;
+	if (instanceData->closestHitOnly)
+	{
+		TQ3Point3D	viewerLocation;
+		if ( (hitXYZ != nullptr) &&
+			(e3pick_viewer_location( thePick, theView, &viewerLocation ) == kQ3Success) )
+		{
+			theDistance = Q3Point3D_Distance( hitXYZ, &viewerLocation );
+		}
+		
+		if ( (! instanceData->pickHits->hits.empty()) &&
+			(theDistance >= instanceData->closestHitDistance) )
+		{
+			return theStatus;
+		}
+	}
+	
+	
 	try
 	{
-		// Allocate another hit record
-		std::unique_ptr<TQ3PickHit>	theHit( new TQ3PickHit );
+		// Replace the previous nearest hit if that's all we're keeping
+		if (instanceData->closestHitOnly)
+		{
+			E3Pick_EmptyHitList( thePick );
+			instanceData->closestHitDistance = theDistance;
+		}
+
+
+
+		// Fill out the data for the hit
+		TQ3PickHitStore*	theStore = instanceData->pickHits;
+		TQ3PickHit			theHit;
+		
+		e3pick_hit_initialise( &theHit, theStore, thePick, theView, hitXYZ,
+			hitNormal, hitUV, hitShape, hitBarycentric, hitTriMeshFaceIndex);
+
+
+
+		// Save the hit at the end of the list
+		theStore->hits.push_back( std::move( theHit ) );
+		theStore->order.push_back( static_cast<TQ3Uns32>( theStore->hits.size() - 1 ) );
+	}
+	catch (...)
+	{
+		theStatus = kQ3Failure;
+	}
 
 
+	return theStatus;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Pick_GetClosestHitLimit : Get the distance a hit must beat.
+//-----------------------------------------------------------------------------
+//		Note :	Returns true if the pick only keeps its nearest hit and
+//				already has one, in which case any hit at or beyond the
+//				returned distance from the viewer location would be ignored.
+//
+//				Geometries can use this to skip the work of building hits
+//				which can't be recorded.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Pick_GetClosestHitLimit(TQ3PickObject		inPick,
+							TQ3ViewObject	theView,
+							TQ3Point3D		*viewerLocation,
+							float			*hitDistance)
+{
+	E3Pick* thePick = (E3Pick*) inPick;
+
+	TQ3PickBaseData	*instanceData = (TQ3PickBaseData *) &thePick->baseInstanceData;
+
+
+
+	// Check we have a limit
+	if (!instanceData->closestHitOnly || instanceData->pickHits->hits.empty())
+		return(kQ3False);
+
+	if (e3pick_viewer_location(inPick, theView, viewerLocation) != kQ3Success)
+		return(kQ3False);
+
+	*hitDistance = instanceData->closestHitDistance;
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      E3Pick_IsBoundsBeyondClosestHit : Can a bounding box be skipped?
+//-----------------------------------------------------------------------------
+//		Note :	Returns true if every point in a world-space bounding box is
+//				at least as far from the viewer as the nearest hit, when the
+//				pick only keeps its nearest hit.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3Pick_IsBoundsBeyondClosestHit(TQ3PickObject			thePick,
+								TQ3ViewObject			theView,
+								const TQ3BoundingBox	*worldBounds)
+{	TQ3Point3D		viewerLocation, nearestPoint;
+	float			hitDistance;
+
+
+
+	// Check we have a limit
+	if (worldBounds->isEmpty || !E3Pick_GetClosestHitLimit(thePick, theView, &viewerLocation, &hitDistance))
+		return(kQ3False);
+
+
+
+	// Find the nearest point of the box to the viewer
+	nearestPoint.x = E3Num_Clamp(viewerLocation.x, worldBounds->min.x, worldBounds->max.x);
+	nearestPoint.y = E3Num_Clamp(viewerLocation.y, worldBounds->min.y, worldBounds->max.y);
+	nearestPoint.z = E3Num_Clamp(viewerLocation.z, worldBounds->min.z, worldBounds->max.z);
+
+	return((TQ3Boolean) (Q3Point3D_DistanceSquared(&nearestPoint, &viewerLocation) >= hitDistance * hitDistance));
+}
+
+
+
+
+
+//=============================================================================
+//      E3Pick_BeginPicking : A view is starting to pick with a pick.
+//-----------------------------------------------------------------------------
+void
+E3Pick_BeginPicking(TQ3PickObject thePick)
+{
+	// Start a new ID buffer, which is set up when it's first drawn into
+	if (E3Pick_GetType(thePick) == kQ3PickTypeWindowRect)
+		{
+		TQ3PickIDBuffer* theBuffer = ( (E3WindowRectPick*) thePick )->instanceData.idBuffer;
+		if (theBuffer != nullptr)
+			{
+			theBuffer->bufferedHits.clear();
+			theBuffer->isReady = false;
+			}
+		}
+}
 
-		// Fill out the data for the hit
-		e3pick_hit_initialise( theHit.get(), thePick, theView, hitXYZ,
-			hitNormal, hitUV, hitShape, hitBarycentric, hitTriMeshFaceIndex);
 
 
 
-		// Save the hit at the end of the list
-		instanceData->pickHits->push_back( theHit.get() );
-		
-		
-		
-		// The hit is now owned by pickHits
-		theHit.release();
-	}
-	catch (...)
-	{
-		theStatus = kQ3Failure;
-	}
 
+//=============================================================================
+//      E3Pick_EndPicking : A view has finished picking with a pick.
+//-----------------------------------------------------------------------------
+void
+E3Pick_EndPicking(TQ3PickObject thePick)
+{
+	// Remove the hits which the ID buffer found to be hidden
+	if (E3Pick_GetType(thePick) == kQ3PickTypeWindowRect)
+		{
+		E3WindowRectPick* rectPick  = (E3WindowRectPick*) thePick;
+		TQ3PickIDBuffer*  theBuffer = rectPick->instanceData.idBuffer;
 
-	return theStatus;
+		if (theBuffer != nullptr && theBuffer->isReady)
+			e3pick_idbuffer_resolve(&rectPick->baseInstanceData, theBuffer);
+		}
 }
 
 
@@ -1739,6 +2618,7 @@ E3WindowPointPick_SetData(TQ3PickObject thePick, const TQ3WindowPointPickData *d
 	pick->baseInstanceData.edgeTolerance = data->edgeTolerance;
 
 	e3pick_set_sort_mask ( & pick->baseInstanceData.commonData ) ;
+	e3pick_update_closest_mode ( & pick->baseInstanceData ) ;
 
 	return kQ3Success ;
 }
@@ -1830,6 +2710,209 @@ E3WindowRectPick_SetData(TQ3PickObject thePick, const TQ3WindowRectPickData *dat
 
 
 
+//=============================================================================
+//      E3WindowRectPick_SetVisibleOnly : Sets the window rect pick's mode.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WindowRectPick_SetVisibleOnly(TQ3PickObject thePick, TQ3Boolean visibleOnly)
+{
+	E3WindowRectPick* pick = (E3WindowRectPick*) thePick;
+
+
+
+	// Create the ID buffer when it's first needed
+	if (visibleOnly && pick->instanceData.idBuffer == nullptr)
+		{
+		pick->instanceData.idBuffer = new TQ3PickIDBuffer;
+		pick->instanceData.idBuffer->isReady = false;
+		}
+
+
+
+	// Set the fields
+	pick->instanceData.visibleOnly          = visibleOnly;
+	pick->baseInstanceData.usesIDBuffer     = (visibleOnly == kQ3True);
+
+	e3pick_update_closest_mode( &pick->baseInstanceData );
+
+	return kQ3Success;
+}
+
+
+
+
+
+//=============================================================================
+//      E3WindowRectPick_GetVisibleOnly : Gets the window rect pick's mode.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WindowRectPick_GetVisibleOnly(TQ3PickObject thePick, TQ3Boolean *visibleOnly)
+{
+	// Get the field
+	*visibleOnly = ( (E3WindowRectPick*) thePick )->instanceData.visibleOnly;
+	return kQ3Success;
+}
+
+
+
+
+
+//=============================================================================
+//      E3WindowRectPick_UsesIDBuffer : Should geometries use the ID buffer?
+//-----------------------------------------------------------------------------
+//		Note :	The ID buffer interpolates depth linearly across the window,
+//				so it can't be used with the non-linear cameras.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3WindowRectPick_UsesIDBuffer(TQ3PickObject thePick, TQ3ViewObject theView)
+{
+	// Check the pick
+	if (E3Pick_GetType(thePick) != kQ3PickTypeWindowRect ||
+		!( (E3WindowRectPick*) thePick )->instanceData.visibleOnly)
+		return(kQ3False);
+
+
+
+	// Check the camera
+	TQ3CameraObject	theCamera = E3View_AccessCamera(theView);
+	if (theCamera == nullptr ||
+		E3FisheyeCamera::IsOfMyClass(theCamera) || E3AllSeeingCamera::IsOfMyClass(theCamera))
+		return(kQ3False);
+
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      E3WindowRectPick_RasterizeTriangles : Draw triangles into the ID buffer.
+//-----------------------------------------------------------------------------
+//		Note :	The triangles are clipped to the near and far planes of the
+//				frustum, and drawn into the ID buffer as one hit. The hit is
+//				recorded if any cell is written, and its details are fixed
+//				up when the pick ends.
+//
+//				Face indices are only recorded for TriMeshes.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WindowRectPick_RasterizeTriangles(TQ3PickObject					thePick,
+									TQ3ViewObject					theView,
+									TQ3Uns32						numTriangles,
+									const TQ3TriMeshTriangleData	*triangles,
+									TQ3Uns32						numPoints,
+									const TQ3Point3D				*localPoints,
+									TQ3Boolean						cullBackface,
+									TQ3Boolean						isTriMesh)
+{	TQ3RationalPoint4D			clipIn[kIDBufferMaxClipPoints], clipOut[kIDBufferMaxClipPoints];
+	const TQ3RationalPoint4D	nearPlane = { 0.0f, 0.0f, -1.0f, 0.0f };
+	const TQ3RationalPoint4D	farPlane  = { 0.0f, 0.0f,  1.0f, 1.0f };
+	TQ3Uns32					n, m, numClipped, hitIndex, faceIndex, nearestCell;
+	TQ3Point3D					frustumPoint, windowPoints[kIDBufferMaxClipPoints], worldPoint, fanPoints[3];
+	TQ3Status					qd3dStatus;
+
+
+
+	// Set up the buffer on the first use in this pick
+	E3WindowRectPick* rectPick  = (E3WindowRectPick*) thePick;
+	TQ3PickIDBuffer*  theBuffer = rectPick->instanceData.idBuffer;
+	Q3_ASSERT(theBuffer != nullptr);
+
+	if (!theBuffer->isReady)
+		e3pick_idbuffer_setup(theBuffer, &rectPick->instanceData.rect, thePick, theView);
+
+	if (numTriangles == 0 || numPoints == 0)
+		return(kQ3Success);
+
+
+
+	// Transform our points to frustum space, leaving the projection to
+	// be done after clipping
+	theBuffer->clipPoints.resize(numPoints);
+	Q3Point3D_To4DTransformArray(localPoints, &E3View_State_GetMatrixLocalToFrustum(theView),
+								 &theBuffer->clipPoints[0], numPoints,
+								 sizeof(TQ3Point3D), sizeof(TQ3RationalPoint4D));
+
+
+
+	// Draw the triangles. Cells are tagged with the index the hit will have
+	// once it's recorded.
+	hitIndex    = static_cast<TQ3Uns32>(rectPick->baseInstanceData.pickHits->hits.size());
+	nearestCell = kQ3ArrayIndexNULL;
+
+	for (n = 0; n < numTriangles; n++)
+		{
+		// Clip the triangle to the near plane (z <= 0) and far plane (z >= -w)
+		for (m = 0; m < 3; m++)
+			clipIn[m] = theBuffer->clipPoints[triangles[n].pointIndices[m]];
+
+		numClipped = e3pick_idbuffer_clip_polygon(clipIn,  3,          nearPlane, clipOut);
+		numClipped = e3pick_idbuffer_clip_polygon(clipOut, numClipped, farPlane,  clipIn);
+		if (numClipped < 3)
+			continue;
+
+
+
+		// Project to the window, keeping the depth from the near plane
+		for (m = 0; m < numClipped; m++)
+			{
+			frustumPoint.x = clipIn[m].x / clipIn[m].w;
+			frustumPoint.y = clipIn[m].y / clipIn[m].w;
+			frustumPoint.z = clipIn[m].z / clipIn[m].w;
+
+			Q3Point3D_Transform(&frustumPoint, &theBuffer->frustumToWindow, &windowPoints[m]);
+			windowPoints[m].z = -frustumPoint.z;
+			}
+
+
+
+		// Draw the clipped polygon as a fan
+		faceIndex    = isTriMesh ? n : kQ3ArrayIndexNULL;
+		fanPoints[0] = windowPoints[0];
+
+		for (m = 1; m + 1 < numClipped; m++)
+			{
+			fanPoints[1] = windowPoints[m];
+			fanPoints[2] = windowPoints[m + 1];
+			nearestCell  = e3pick_idbuffer_raster_triangle(theBuffer, fanPoints, hitIndex, faceIndex,
+															cullBackface, nearestCell);
+			}
+		}
+
+
+
+	// Record the hit if we were drawn
+	if (nearestCell == kQ3ArrayIndexNULL)
+		return(kQ3Success);
+
+	e3pick_idbuffer_cell_to_world(theBuffer, nearestCell, &worldPoint);
+	qd3dStatus = E3Pick_RecordHit(thePick, theView, &worldPoint, nullptr, nullptr, nullptr, nullptr,
+									theBuffer->cells[nearestCell].faceIndex);
+
+	if (rectPick->baseInstanceData.pickHits->hits.size() == hitIndex + 1)
+		theBuffer->bufferedHits.push_back(hitIndex);
+	else
+		{
+		// The hit wasn't recorded, so its cells must not be claimed by the next one
+		for (TQ3PickIDCell& theCell : theBuffer->cells)
+			{
+			if (theCell.hitIndex == hitIndex)
+				{
+				theCell.depth     = kQ3MaxFloat;
+				theCell.hitIndex  = kQ3ArrayIndexNULL;
+				theCell.faceIndex = kQ3ArrayIndexNULL;
+				}
+			}
+		}
+
+	return(qd3dStatus);
+}
+
+
+
+
+
 //=============================================================================
 //      E3WorldRayPick_New : Creates a new world ray pick.
 //-----------------------------------------------------------------------------
@@ -1913,6 +2996,80 @@ E3WorldRayPick_SetData(TQ3PickObject thePick, const TQ3WorldRayPickData *data)
 	
 
 	e3pick_set_sort_mask( & pick->baseInstanceData.commonData );
+	e3pick_update_closest_mode( & pick->baseInstanceData );
+
+	return kQ3Success ;
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_New : Creates a new world ray batch pick.
+//-----------------------------------------------------------------------------
+#pragma mark -
+TQ3PickObject
+E3WorldRayBatchPick_New(const TQ3WorldRayBatchPickData *data)
+{
+	// Create the object
+	return E3ClassTree::CreateInstance( kQ3PickTypeWorldRayBatch, kQ3True, data );
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_SetRays : Sets the world ray batch pick's rays.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_SetRays(TQ3PickObject thePick, TQ3Uns32 numRays, const TQ3Ray3D *rays)
+{
+	TQ3WorldRayBatchStore* theStore = ( (E3WorldRayBatchPick*) thePick )->instanceData.rayStore;
+
+
+
+	// Replace the rays, and forget the old hits
+	e3pick_worldraybatch_set_rays(theStore, numRays, rays);
+	e3pick_worldraybatch_empty_hits(theStore);
+
+	return kQ3Success ;
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_GetNumRays : Gets the world ray batch pick's ray count.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_GetNumRays(TQ3PickObject thePick, TQ3Uns32 *numRays)
+{
+	// Get the field
+	*numRays = static_cast<TQ3Uns32>( ( (E3WorldRayBatchPick*) thePick )->instanceData.rayStore->hits.size() );
+	return kQ3Success ;
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_GetHits : Gets the world ray batch pick's hits.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_GetHits(TQ3PickObject thePick, TQ3WorldRayBatchHit *hits)
+{
+	TQ3WorldRayBatchStore* theStore = ( (E3WorldRayBatchPick*) thePick )->instanceData.rayStore;
+
+
+
+	// Get the hits
+	if (!theStore->hits.empty())
+		Q3Memory_Copy(&theStore->hits[0], hits,
+						static_cast<TQ3Uns32>(theStore->hits.size() * sizeof(TQ3WorldRayBatchHit)));
 
 	return kQ3Success ;
 }
@@ -1921,6 +3078,299 @@ E3WorldRayPick_SetData(TQ3PickObject thePick, const TQ3WorldRayPickData *data)
 
 
 
+//=============================================================================
+//      E3WorldRayBatchPick_PushBounds : Enter a bounding box.
+//-----------------------------------------------------------------------------
+//		Note :	Finds the active rays which enter a world-space bounding box
+//				before their nearest hit so far, and makes them the active
+//				rays until the matching E3WorldRayBatchPick_PopBounds.
+//
+//				Returns false, and pushes nothing, if no ray can find a nearer
+//				hit inside the box. The contents of the box can then be
+//				skipped.
+//-----------------------------------------------------------------------------
+TQ3Boolean
+E3WorldRayBatchPick_PushBounds(TQ3PickObject thePick, const TQ3BoundingBox *worldBounds)
+{	float		tNear, tFar, t1, t2;
+	TQ3Uns32	n, r, levelStart, levelEnd;
+
+
+
+	// Find the current level
+	TQ3WorldRayBatchStore* theStore = ( (E3WorldRayBatchPick*) thePick )->instanceData.rayStore;
+	std::vector<TQ3Uns32>& activeRays = theStore->activeRays;
+
+	levelStart = theStore->levelStarts.back();
+	levelEnd   = static_cast<TQ3Uns32>(activeRays.size());
+
+	if (levelStart == levelEnd)
+		return(kQ3False);
+
+
+
+	// An empty box can't be used to reject anything, so keep every ray
+	if (worldBounds->isEmpty)
+		{
+		theStore->levelStarts.push_back(levelEnd);
+		for (n = levelStart; n < levelEnd; n++)
+			activeRays.push_back(activeRays[n]);
+
+		return(kQ3True);
+		}
+
+
+
+	// Slab test each active ray against the box. The new level is appended
+	// to the list, so the current level is read by index.
+	for (n = levelStart; n < levelEnd; n++)
+		{
+		r = activeRays[n];
+
+		t1    = (worldBounds->min.x - theStore->originX[r]) * theStore->invDirX[r];
+		t2    = (worldBounds->max.x - theStore->originX[r]) * theStore->invDirX[r];
+		tNear = std::min(t1, t2);
+		tFar  = std::max(t1, t2);
+
+		t1    = (worldBounds->min.y - theStore->originY[r]) * theStore->invDirY[r];
+		t2    = (worldBounds->max.y - theStore->originY[r]) * theStore->invDirY[r];
+		tNear = std::max(tNear, std::min(t1, t2));
+		tFar  = std::min(tFar,  std::max(t1, t2));
+
+		t1    = (worldBounds->min.z - theStore->originZ[r]) * theStore->invDirZ[r];
+		t2    = (worldBounds->max.z - theStore->originZ[r]) * theStore->invDirZ[r];
+		tNear = std::max(tNear, std::min(t1, t2));
+		tFar  = std::min(tFar,  std::max(t1, t2));
+
+		tNear = std::max(tNear, 0.0f);
+		if (tNear <= tFar && tNear < theStore->bestDistance[r])
+			activeRays.push_back(r);
+		}
+
+
+
+	// Push the new level if any rays survived
+	if (activeRays.size() == levelEnd)
+		return(kQ3False);
+
+	theStore->levelStarts.push_back(levelEnd);
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_PopBounds : Leave a bounding box.
+//-----------------------------------------------------------------------------
+void
+E3WorldRayBatchPick_PopBounds(TQ3PickObject thePick)
+{
+	TQ3WorldRayBatchStore* theStore = ( (E3WorldRayBatchPick*) thePick )->instanceData.rayStore;
+
+
+
+	// Restore the previous level
+	Q3_ASSERT(theStore->levelStarts.size() > 1);
+	if (theStore->levelStarts.size() > 1)
+		{
+		theStore->activeRays.resize(theStore->levelStarts.back());
+		theStore->levelStarts.pop_back();
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      E3WorldRayBatchPick_PickTriangles : Test the active rays against triangles.
+//-----------------------------------------------------------------------------
+//		Note :	The active rays are gathered into a packet, and each triangle
+//				is tested against the whole packet with the Moller-Trumbore
+//				test used by E3Ray3D_IntersectTriangle. The packet loop has no
+//				branches so the compiler can vectorise it; the rare rays which
+//				lie in the plane of a triangle are passed on to
+//				E3Ray3D_IntersectTriangle, which treats that case more
+//				carefully.
+//
+//				Face indices are only recorded for TriMeshes.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3WorldRayBatchPick_PickTriangles(TQ3PickObject					thePick,
+									TQ3ViewObject					theView,
+									TQ3Uns32						numTriangles,
+									const TQ3TriMeshTriangleData	*triangles,
+									const TQ3Point3D				*worldPoints,
+									TQ3Boolean						cullBackface,
+									TQ3Boolean						isTriMesh)
+{	float			e1x, e1y, e1z, e2x, e2y, e2z, px, py, pz, qx, qy, qz, tx, ty, tz;
+	float			det, invDet, u, v, t, minDet;
+	TQ3Uns32		n, i, r, levelStart, numRays, pickedID;
+	TQ3Uns8			anyFlags, theFlags;
+	TQ3PickData		pickData;
+	TQ3Param3D		theHit;
+	TQ3Ray3D		theRay;
+	bool			havePickID;
+
+
+
+	// Find the active rays
+	TQ3WorldRayBatchStore* theStore = ( (E3WorldRayBatchPick*) thePick )->instanceData.rayStore;
+
+	levelStart = theStore->levelStarts.back();
+	numRays    = static_cast<TQ3Uns32>(theStore->activeRays.size() - levelStart);
+	if (numRays == 0 || numTriangles == 0)
+		return(kQ3Success);
+
+
+
+	// Get the pick ID, if it's wanted
+	pickedID   = 0;
+	havePickID = false;
+	E3Pick_GetData(thePick, &pickData);
+	if (E3Bit_IsSet(pickData.mask, kQ3PickDetailMaskPickID))
+		havePickID = (Q3View_GetPickIDStyleState(theView, &pickedID) == kQ3Success);
+
+
+
+	// Gather the active rays into the packet
+	theStore->packetOX.resize(numRays);
+	theStore->packetOY.resize(numRays);
+	theStore->packetOZ.resize(numRays);
+	theStore->packetDX.resize(numRays);
+	theStore->packetDY.resize(numRays);
+	theStore->packetDZ.resize(numRays);
+	theStore->packetBest.resize(numRays);
+	theStore->packetT.resize(numRays);
+	theStore->packetU.resize(numRays);
+	theStore->packetV.resize(numRays);
+	theStore->packetFlags.resize(numRays);
+
+	float*   __restrict ox    = &theStore->packetOX[0];
+	float*   __restrict oy    = &theStore->packetOY[0];
+	float*   __restrict oz    = &theStore->packetOZ[0];
+	float*   __restrict dx    = &theStore->packetDX[0];
+	float*   __restrict dy    = &theStore->packetDY[0];
+	float*   __restrict dz    = &theStore->packetDZ[0];
+	float*   __restrict best  = &theStore->packetBest[0];
+	float*   __restrict hitT  = &theStore->packetT[0];
+	float*   __restrict hitU  = &theStore->packetU[0];
+	float*   __restrict hitV  = &theStore->packetV[0];
+	TQ3Uns8* __restrict flags = &theStore->packetFlags[0];
+
+	for (i = 0; i < numRays; i++)
+		{
+		r       = theStore->activeRays[levelStart + i];
+		ox[i]   = theStore->originX[r];
+		oy[i]   = theStore->originY[r];
+		oz[i]   = theStore->originZ[r];
+		dx[i]   = theStore->dirX[r];
+		dy[i]   = theStore->dirY[r];
+		dz[i]   = theStore->dirZ[r];
+		best[i] = theStore->bestDistance[r];
+		}
+
+
+
+	// Test each triangle against the packet
+	minDet = cullBackface ? kQ3RealZero : -kQ3MaxFloat;
+
+	for (n = 0; n < numTriangles; n++)
+		{
+		// Find the edges which share the first vertex
+		const TQ3Point3D& p0( worldPoints[triangles[n].pointIndices[0]] );
+		const TQ3Point3D& p1( worldPoints[triangles[n].pointIndices[1]] );
+		const TQ3Point3D& p2( worldPoints[triangles[n].pointIndices[2]] );
+
+		e1x = p1.x - p0.x;	e1y = p1.y - p0.y;	e1z = p1.z - p0.z;
+		e2x = p2.x - p0.x;	e2y = p2.y - p0.y;	e2z = p2.z - p0.z;
+
+
+
+		// Test the rays
+		anyFlags = 0;
+		for (i = 0; i < numRays; i++)
+			{
+			px  = dy[i] * e2z - dz[i] * e2y;
+			py  = dz[i] * e2x - dx[i] * e2z;
+			pz  = dx[i] * e2y - dy[i] * e2x;
+			det = e1x * px + e1y * py + e1z * pz;
+
+			bool isParallel = fabsf(det) < kQ3RealZero;
+			invDet = 1.0f / (isParallel ? 1.0f : det);
+
+			tx = ox[i] - p0.x;
+			ty = oy[i] - p0.y;
+			tz = oz[i] - p0.z;
+			u  = (tx * px + ty * py + tz * pz) * invDet;
+
+			qx = ty * e1z - tz * e1y;
+			qy = tz * e1x - tx * e1z;
+			qz = tx * e1y - ty * e1x;
+			v  = (dx[i] * qx + dy[i] * qy + dz[i] * qz) * invDet;
+			t  = (e2x * qx + e2y * qy + e2z * qz) * invDet;
+
+			bool isHit = !isParallel && det >= minDet &&
+						 u >= 0.0f && v >= 0.0f && (u + v) <= 1.0f &&
+						 t >= 0.0f && t < best[i];
+
+			hitT[i]   = t;
+			hitU[i]   = u;
+			hitV[i]   = v;
+			flags[i]  = (TQ3Uns8) ((isHit ? kRayBatchFlagHit : 0) | (isParallel ? kRayBatchFlagParallel : 0));
+			anyFlags |= flags[i];
+			}
+
+		if (anyFlags == 0)
+			continue;
+
+
+
+		// Record the hits
+		for (i = 0; i < numRays; i++)
+			{
+			theFlags = flags[i];
+			if (theFlags == 0)
+				continue;
+
+			if (theFlags & kRayBatchFlagParallel)
+				{
+				theRay.origin.x    = ox[i];
+				theRay.origin.y    = oy[i];
+				theRay.origin.z    = oz[i];
+				theRay.direction.x = dx[i];
+				theRay.direction.y = dy[i];
+				theRay.direction.z = dz[i];
+
+				if (!E3Ray3D_IntersectTriangle(theRay, p0, p1, p2, cullBackface, theHit) || theHit.w >= best[i])
+					continue;
+
+				hitT[i] = theHit.w;
+				hitU[i] = theHit.u;
+				hitV[i] = theHit.v;
+				}
+
+			best[i] = hitT[i];
+			r       = theStore->activeRays[levelStart + i];
+			theStore->bestDistance[r] = hitT[i];
+
+			TQ3WorldRayBatchHit& rayHit = theStore->hits[r];
+			rayHit.didHit              = kQ3True;
+			rayHit.hitDistance         = hitT[i];
+			rayHit.hitXYZ              = (1.0f - hitU[i] - hitV[i]) * p0 + hitU[i] * p1 + hitV[i] * p2;
+			rayHit.hitTriMeshFaceIndex = isTriMesh ? n : kQ3ArrayIndexNULL;
+			rayHit.pickedID            = havePickID ? pickedID : 0;
+			}
+		}
+
+	return(kQ3Success);
+}
+
+
+
+
+
 //=============================================================================
 //      E3ShapePart_New : Creates a new shape part.
 //		(Semi-private, no access to the 3rd party programmer)
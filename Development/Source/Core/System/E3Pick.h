@@ -93,6 +93,17 @@ TQ3Status				E3Pick_RecordHit(TQ3PickObject        		thePick,
 											const TQ3Param3D*		hitBarycentric = nullptr,
 											TQ3Uns32				hitTriMeshFaceIndex = kQ3ArrayIndexNULL );
 
+void					E3Pick_BeginPicking(TQ3PickObject thePick);
+void					E3Pick_EndPicking(TQ3PickObject thePick);
+
+TQ3Boolean				E3Pick_GetClosestHitLimit(TQ3PickObject		thePick,
+											TQ3ViewObject			theView,
+											TQ3Point3D				*viewerLocation,
+											float					*hitDistance);
+TQ3Boolean				E3Pick_IsBoundsBeyondClosestHit(TQ3PickObject	thePick,
+											TQ3ViewObject			theView,
+											const TQ3BoundingBox	*worldBounds);
+
 TQ3PickObject			E3WindowPointPick_New(const TQ3WindowPointPickData *data);
 TQ3Status				E3WindowPointPick_GetPoint(TQ3PickObject thePick, TQ3Point2D *point);
 TQ3Status				E3WindowPointPick_SetPoint(TQ3PickObject thePick, const TQ3Point2D *point);
@@ -104,6 +115,17 @@ TQ3Status				E3WindowRectPick_GetRect(TQ3PickObject thePick, TQ3Area *rect);
 TQ3Status				E3WindowRectPick_SetRect(TQ3PickObject thePick, const TQ3Area *rect);
 TQ3Status				E3WindowRectPick_GetData(TQ3PickObject thePick, TQ3WindowRectPickData *data);
 TQ3Status				E3WindowRectPick_SetData(TQ3PickObject thePick, const TQ3WindowRectPickData *data);
+TQ3Status				E3WindowRectPick_SetVisibleOnly(TQ3PickObject thePick, TQ3Boolean visibleOnly);
+TQ3Status				E3WindowRectPick_GetVisibleOnly(TQ3PickObject thePick, TQ3Boolean *visibleOnly);
+TQ3Boolean				E3WindowRectPick_UsesIDBuffer(TQ3PickObject thePick, TQ3ViewObject theView);
+TQ3Status				E3WindowRectPick_RasterizeTriangles(TQ3PickObject			thePick,
+											TQ3ViewObject					theView,
+											TQ3Uns32						numTriangles,
+											const TQ3TriMeshTriangleData	*triangles,
+											TQ3Uns32						numPoints,
+											const TQ3Point3D				*localPoints,
+											TQ3Boolean						cullBackface,
+											TQ3Boolean						isTriMesh);
 
 TQ3PickObject			E3WorldRayPick_New(const TQ3WorldRayPickData *data);
 TQ3Status				E3WorldRayPick_GetRay(TQ3PickObject thePick, TQ3Ray3D *ray);
@@ -111,6 +133,20 @@ TQ3Status				E3WorldRayPick_SetRay(TQ3PickObject thePick, const TQ3Ray3D *ray);
 TQ3Status				E3WorldRayPick_GetData(TQ3PickObject thePick, TQ3WorldRayPickData *data);
 TQ3Status				E3WorldRayPick_SetData(TQ3PickObject thePick, const TQ3WorldRayPickData *data);
 
+TQ3PickObject			E3WorldRayBatchPick_New(const TQ3WorldRayBatchPickData *data);
+TQ3Status				E3WorldRayBatchPick_SetRays(TQ3PickObject thePick, TQ3Uns32 numRays, const TQ3Ray3D *rays);
+TQ3Status				E3WorldRayBatchPick_GetNumRays(TQ3PickObject thePick, TQ3Uns32 *numRays);
+TQ3Status				E3WorldRayBatchPick_GetHits(TQ3PickObject thePick, TQ3WorldRayBatchHit *hits);
+TQ3Boolean				E3WorldRayBatchPick_PushBounds(TQ3PickObject thePick, const TQ3BoundingBox *worldBounds);
+void					E3WorldRayBatchPick_PopBounds(TQ3PickObject thePick);
+TQ3Status				E3WorldRayBatchPick_PickTriangles(TQ3PickObject				thePick,
+											TQ3ViewObject					theView,
+											TQ3Uns32						numTriangles,
+											const TQ3TriMeshTriangleData	*triangles,
+											const TQ3Point3D				*worldPoints,
+											TQ3Boolean						cullBackface,
+											TQ3Boolean						isTriMesh);
+
 TQ3MeshPartObject		E3MeshPart_New(const TQ3MeshComponent data);
 TQ3ObjectType			E3MeshPart_GetType(TQ3MeshPartObject meshPartObject);
 TQ3Status				E3MeshPart_GetComponent(TQ3MeshPartObject meshPartObject, TQ3MeshComponent *component);
@@ -0,0 +1,1054 @@
+/*  NAME:
+        E3ReadAheadStorage.cpp
+
+    DESCRIPTION:
+        Read-ahead storage, which prefetches from another storage on a
+        background thread.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2021, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+#include "E3Storage.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+const TQ3Uns32 kE3ReadAheadDefaultChunkSize					= 256 * 1024;
+const TQ3Uns32 kE3ReadAheadDefaultNumChunks					= 8;
+const TQ3Uns32 kE3ReadAheadMinChunkSize						= 4 * 1024;
+const TQ3Uns32 kE3ReadAheadMinNumChunks						= 2;
+
+
+// Chunk states
+enum
+{
+	kE3ReadAheadChunkEmpty			= 0,	// Holds no data
+	kE3ReadAheadChunkQueued			= 1,	// Waiting for the I/O thread
+	kE3ReadAheadChunkLoading		= 2,	// Being read by the I/O thread
+	kE3ReadAheadChunkReady			= 3,	// Holds valid data
+	kE3ReadAheadChunkFailed			= 4		// The read failed
+};
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+// A chunk of the ring
+struct TE3ReadAheadChunk
+{
+	uint64_t						start;
+	TQ3Uns32						length;
+	TQ3Uns32						state;
+	TQ3Uns32						lastUse;
+	TQ3Uns8*						data;
+};
+
+
+// The ring of chunks and the I/O thread which fills it.
+//
+// Only the I/O thread reads from the source while the ring is running, and
+// it does so without holding mLock, so decoding the current chunk overlaps
+// with reading the next ones. Foreground reads that miss the ring, and any
+// writes, take mSourceLock so the source is only ever used by one thread.
+class E3ReadAheadRing
+{
+public:
+									E3ReadAheadRing( TQ3StorageObject inSource,
+													TQ3Uns32 inChunkSize, TQ3Uns32 inNumChunks );
+									~E3ReadAheadRing();
+
+	void							Start( void );
+	void							Stop( void );
+
+	TQ3Status						Read( uint64_t offset, TQ3Uns32 dataSize,
+										unsigned char *data, TQ3Uns32 *sizeRead );
+	TQ3Status						Write( uint64_t offset, TQ3Uns32 dataSize,
+										const unsigned char *data, TQ3Uns32 *sizeWritten );
+	TQ3Status						GetSize( uint64_t *size );
+	void							Hint( uint64_t offset, TQ3Uns32 dataSize );
+
+private:
+	TQ3Int32						FindChunk( uint64_t chunkStart );
+	TQ3Int32						QueueChunk( uint64_t chunkStart, bool onDemand );
+	void							Prefetch( uint64_t chunkStart, TQ3Uns32 numChunks );
+	void							ThreadMain( void );
+
+	TQ3StorageObject				mSource;
+	TQ3XStorageReadData64Method		mReadMethod;
+	uint64_t						mSourceSize;
+	TQ3Uns32						mChunkSize;
+	std::vector<TE3ReadAheadChunk>	mChunks;
+	std::vector<TQ3Uns8>			mBuffer;
+	std::deque<TQ3Uns32>			mQueue;
+	TQ3Uns32						mClock;
+	uint64_t						mNextSequential;
+	bool							mStopping;
+	std::mutex						mLock;
+	std::mutex						mSourceLock;
+	std::condition_variable			mWorkReady;
+	std::condition_variable			mChunkDone;
+	std::thread						mThread;
+};
+
+
+// Read-ahead storage
+typedef struct TQ3ReadAheadStorageData {
+	TQ3StorageObject				source;
+	TQ3Uns32						chunkSize;
+	TQ3Uns32						numChunks;
+	TQ3Boolean						isOpen;
+	E3ReadAheadRing*				ring;			// Only while open for reading
+} TQ3ReadAheadStorageData;
+
+
+class E3ReadAheadStorage : public E3Storage  // This is a leaf class so no other classes use this,
+								// so it can be here in the .cpp file rather than in
+								// the .h file, hence all the fields can be public
+								// as nobody should be including this file
+	{
+	Q3_CLASS_ENUMS( kQ3StorageTypeReadAhead, E3ReadAheadStorage, E3Storage );
+
+public :
+	TQ3ReadAheadStorageData					instanceData ;
+	} ;
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      E3ReadAheadRing::E3ReadAheadRing : Constructor.
+//-----------------------------------------------------------------------------
+E3ReadAheadRing::E3ReadAheadRing( TQ3StorageObject inSource,
+								TQ3Uns32 inChunkSize, TQ3Uns32 inNumChunks )
+	: mSource( inSource )
+	, mReadMethod( ( (E3Storage*) inSource )->GetReadData64Method() )
+	, mSourceSize( 0 )
+	, mChunkSize( inChunkSize )
+	, mChunks( inNumChunks )
+	, mBuffer( (size_t) inChunkSize * inNumChunks )
+	, mClock( 0 )
+	, mNextSequential( 0 )
+	, mStopping( false )
+{
+	for (TQ3Uns32 n = 0; n < inNumChunks; ++n)
+	{
+		mChunks[n].start   = 0;
+		mChunks[n].length  = 0;
+		mChunks[n].state   = kE3ReadAheadChunkEmpty;
+		mChunks[n].lastUse = 0;
+		mChunks[n].data    = &mBuffer[ (size_t) n * inChunkSize ];
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::~E3ReadAheadRing : Destructor.
+//-----------------------------------------------------------------------------
+E3ReadAheadRing::~E3ReadAheadRing()
+{
+	Stop();
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::Start : Start the I/O thread.
+//-----------------------------------------------------------------------------
+//		Note :	The source size is taken once, since the I/O thread needs it
+//				to clip chunks and the source won't grow while we're reading.
+//-----------------------------------------------------------------------------
+void
+E3ReadAheadRing::Start( void )
+{
+	if (( (E3Storage*) mSource )->GetSize64( &mSourceSize ) != kQ3Success)
+		mSourceSize = 0;
+
+	mThread = std::thread( &E3ReadAheadRing::ThreadMain, this );
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::Stop : Stop the I/O thread.
+//-----------------------------------------------------------------------------
+void
+E3ReadAheadRing::Stop( void )
+{
+	if (! mThread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex>	guard( mLock );
+		mStopping = true;
+	}
+
+	mWorkReady.notify_all();
+	mThread.join();
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::ThreadMain : Fill queued chunks.
+//-----------------------------------------------------------------------------
+void
+E3ReadAheadRing::ThreadMain( void )
+{
+	std::unique_lock<std::mutex>	lock( mLock );
+
+	while (true)
+	{
+		mWorkReady.wait( lock, [this]() { return mStopping || ! mQueue.empty(); } );
+		if (mStopping)
+			break;
+
+
+		// Take the next chunk, and read it without holding the ring lock
+		TE3ReadAheadChunk&	theChunk = mChunks[ mQueue.front() ];
+		mQueue.pop_front();
+		theChunk.state = kE3ReadAheadChunkLoading;
+
+		uint64_t	theStart  = theChunk.start;
+		TQ3Uns32	theLength = theChunk.length;
+		TQ3Uns32	sizeRead  = 0;
+		TQ3Status	qd3dStatus;
+
+		lock.unlock();
+		{
+			std::lock_guard<std::mutex>	sourceGuard( mSourceLock );
+			qd3dStatus = mReadMethod( mSource, theStart, theLength, theChunk.data, &sizeRead );
+		}
+		lock.lock();
+
+
+		// Publish the result
+		if (qd3dStatus == kQ3Success)
+		{
+			theChunk.length = sizeRead;
+			theChunk.state  = kE3ReadAheadChunkReady;
+		}
+		else
+			theChunk.state = kE3ReadAheadChunkFailed;
+
+		mChunkDone.notify_all();
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::FindChunk : Find the chunk holding an offset.
+//-----------------------------------------------------------------------------
+//		Note :	Must be called with mLock held. Returns -1 if there is none.
+//-----------------------------------------------------------------------------
+TQ3Int32
+E3ReadAheadRing::FindChunk( uint64_t chunkStart )
+{
+	for (TQ3Uns32 n = 0; n < mChunks.size(); ++n)
+	{
+		if (mChunks[n].state != kE3ReadAheadChunkEmpty && mChunks[n].start == chunkStart)
+			return (TQ3Int32) n;
+	}
+
+	return -1;
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::QueueChunk : Queue a chunk to be read.
+//-----------------------------------------------------------------------------
+//		Note :	Must be called with mLock held. Empty chunks are used first,
+//				then the least recently used ready chunk. Returns -1 if every
+//				chunk is still waiting to be filled.
+//
+//				Demand reads go to the front of the queue, prefetches and
+//				hints to the back.
+//-----------------------------------------------------------------------------
+TQ3Int32
+E3ReadAheadRing::QueueChunk( uint64_t chunkStart, bool onDemand )
+{
+	TQ3Int32	theIndex = -1;
+
+
+
+	// Pick a chunk to reuse
+	for (TQ3Uns32 n = 0; n < mChunks.size(); ++n)
+	{
+		const TE3ReadAheadChunk&	theChunk = mChunks[n];
+
+		if (theChunk.state == kE3ReadAheadChunkEmpty)
+		{
+			theIndex = (TQ3Int32) n;
+			break;
+		}
+
+		if ((theChunk.state == kE3ReadAheadChunkReady || theChunk.state == kE3ReadAheadChunkFailed) &&
+			(theIndex == -1 || theChunk.lastUse < mChunks[theIndex].lastUse))
+			theIndex = (TQ3Int32) n;
+	}
+
+	if (theIndex == -1)
+		return -1;
+
+
+
+	// Queue it
+	TE3ReadAheadChunk&	theChunk = mChunks[theIndex];
+
+	theChunk.start   = chunkStart;
+	theChunk.length  = (TQ3Uns32) E3Num_Min( (uint64_t) mChunkSize, mSourceSize - chunkStart );
+	theChunk.state   = kE3ReadAheadChunkQueued;
+	theChunk.lastUse = ++mClock;
+
+	if (onDemand)
+		mQueue.push_front( (TQ3Uns32) theIndex );
+	else
+		mQueue.push_back( (TQ3Uns32) theIndex );
+
+	mWorkReady.notify_one();
+
+	return theIndex;
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::Prefetch : Queue the chunks following a chunk.
+//-----------------------------------------------------------------------------
+//		Note :	Must be called with mLock held.
+//-----------------------------------------------------------------------------
+void
+E3ReadAheadRing::Prefetch( uint64_t chunkStart, TQ3Uns32 numChunks )
+{
+	for (TQ3Uns32 n = 1; n <= numChunks; ++n)
+	{
+		uint64_t	nextStart = chunkStart + (uint64_t) n * mChunkSize;
+
+		if (nextStart >= mSourceSize)
+			break;
+
+		if (FindChunk( nextStart ) == -1 && QueueChunk( nextStart, false ) == -1)
+			break;
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::Read : Read data through the ring.
+//-----------------------------------------------------------------------------
+//		Note :	Sequential reads keep half the ring queued ahead of the read
+//				position. After a seek we only queue the next chunk, until we
+//				see the reader carry on from there.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3ReadAheadRing::Read( uint64_t offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+{
+	std::unique_lock<std::mutex>	lock( mLock );
+	bool							isSequential = (offset == mNextSequential);
+	uint64_t						chunkStart   = offset - (offset % mChunkSize);
+	TQ3Uns32						numCopied    = 0;
+	TQ3Status						qd3dStatus   = kQ3Success;
+
+
+
+	// Copy out of the ring, a chunk at a time
+	while (numCopied < dataSize && offset < mSourceSize)
+	{
+		chunkStart = offset - (offset % mChunkSize);
+
+
+		// Find or queue the chunk
+		TQ3Int32	theIndex = FindChunk( chunkStart );
+
+		if (theIndex == -1)
+			theIndex = QueueChunk( chunkStart, true );
+
+		else if (mChunks[theIndex].state == kE3ReadAheadChunkQueued)
+		{
+			// Move it to the front of the queue
+			mQueue.erase( std::find( mQueue.begin(), mQueue.end(), (TQ3Uns32) theIndex ) );
+			mQueue.push_front( (TQ3Uns32) theIndex );
+		}
+
+
+		// Wait for it to arrive
+		if (theIndex != -1)
+		{
+			TE3ReadAheadChunk&	theChunk = mChunks[theIndex];
+
+			mChunkDone.wait( lock, [&theChunk]() { return theChunk.state == kE3ReadAheadChunkReady ||
+															theChunk.state == kE3ReadAheadChunkFailed; } );
+
+			if (theChunk.state == kE3ReadAheadChunkFailed)
+			{
+				theChunk.state = kE3ReadAheadChunkEmpty;
+				theIndex       = -1;
+			}
+		}
+
+
+		// If the ring couldn't supply it, read the rest directly. This also
+		// lets the source post any error on the calling thread.
+		if (theIndex == -1)
+		{
+			TQ3Uns32	directRead = 0;
+
+			lock.unlock();
+			{
+				std::lock_guard<std::mutex>	sourceGuard( mSourceLock );
+				qd3dStatus = mReadMethod( mSource, offset, dataSize - numCopied, data + numCopied, &directRead );
+			}
+			lock.lock();
+
+			numCopied += directRead;
+			offset    += directRead;
+			break;
+		}
+
+
+		// Copy what we need
+		TE3ReadAheadChunk&	theChunk = mChunks[theIndex];
+		TQ3Uns32			theSkip  = (TQ3Uns32) (offset - chunkStart);
+
+		theChunk.lastUse = ++mClock;
+		if (theSkip >= theChunk.length)
+			break;
+
+		TQ3Uns32	theCopy = E3Num_Min( dataSize - numCopied, theChunk.length - theSkip );
+		Q3Memory_Copy( theChunk.data + theSkip, data + numCopied, theCopy );
+
+		numCopied += theCopy;
+		offset    += theCopy;
+	}
+
+
+
+	// Keep the ring filled ahead of the reader
+	mNextSequential = offset;
+	Prefetch( chunkStart, isSequential ? (TQ3Uns32) (mChunks.size() / 2) : 1 );
+
+	*sizeRead = numCopied;
+
+	return qd3dStatus;
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::Write : Write data to the source.
+//-----------------------------------------------------------------------------
+//		Note :	Any chunks overlapping the data are dropped, waiting for the
+//				I/O thread to finish with them first. We keep holding mLock
+//				until the write is done so they can't be queued again.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3ReadAheadRing::Write( uint64_t offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+{
+	std::unique_lock<std::mutex>	lock( mLock );
+	TQ3Status						qd3dStatus;
+
+
+
+	// Drop the overlapping chunks
+	for (TQ3Uns32 n = 0; n < mChunks.size(); ++n)
+	{
+		TE3ReadAheadChunk&	theChunk = mChunks[n];
+
+		if (theChunk.state == kE3ReadAheadChunkEmpty ||
+			theChunk.start >= offset + dataSize || theChunk.start + mChunkSize <= offset)
+			continue;
+
+		mChunkDone.wait( lock, [&theChunk]() { return theChunk.state != kE3ReadAheadChunkLoading; } );
+
+		if (theChunk.state == kE3ReadAheadChunkQueued)
+			mQueue.erase( std::find( mQueue.begin(), mQueue.end(), n ) );
+
+		theChunk.state = kE3ReadAheadChunkEmpty;
+	}
+
+
+
+	// Write the data
+	{
+		std::lock_guard<std::mutex>	sourceGuard( mSourceLock );
+		qd3dStatus = ( (E3Storage*) mSource )->SetData64( offset, dataSize, data, sizeWritten );
+	}
+
+	if (qd3dStatus == kQ3Success)
+		mSourceSize = E3Num_Max( mSourceSize, offset + *sizeWritten );
+
+	return qd3dStatus;
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::GetSize : Get the size of the source.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3ReadAheadRing::GetSize( uint64_t *size )
+{
+	std::lock_guard<std::mutex>	sourceGuard( mSourceLock );
+
+	return ( (E3Storage*) mSource )->GetSize64( size );
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadRing::Hint : Queue a range that will be read soon.
+//-----------------------------------------------------------------------------
+//		Note :	At most half the ring is given over to a hint, so that a
+//				large hint can't push out the chunks the reader is using.
+//-----------------------------------------------------------------------------
+void
+E3ReadAheadRing::Hint( uint64_t offset, TQ3Uns32 dataSize )
+{
+	std::lock_guard<std::mutex>	guard( mLock );
+	uint64_t					chunkStart = offset - (offset % mChunkSize);
+	TQ3Uns32					numChunks  = 0;
+
+
+
+	while (chunkStart < offset + dataSize && chunkStart < mSourceSize &&
+		   numChunks < mChunks.size() / 2)
+	{
+		if (FindChunk( chunkStart ) == -1 && QueueChunk( chunkStart, false ) == -1)
+			break;
+
+		chunkStart += mChunkSize;
+		numChunks++;
+	}
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_new : Read-ahead storage new method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_new(TQ3Object theObject, void *privateData, const void *paramData)
+{	TQ3ReadAheadStorageData			*instanceData = (TQ3ReadAheadStorageData *) privateData;
+	const TQ3ReadAheadStorageData	*initData     = (const TQ3ReadAheadStorageData *) paramData;
+
+
+
+	// Initialise our instance data
+	instanceData->source    = Q3Shared_GetReference( initData->source );
+	instanceData->chunkSize = initData->chunkSize;
+	instanceData->numChunks = initData->numChunks;
+	instanceData->isOpen    = kQ3False;
+	instanceData->ring      = nullptr;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_delete : Read-ahead storage delete method.
+//-----------------------------------------------------------------------------
+static void
+e3storage_readahead_delete(TQ3Object storage, void *privateData)
+{	TQ3ReadAheadStorageData		*instanceData = (TQ3ReadAheadStorageData *) privateData;
+#pragma unused(storage)
+
+
+
+	// Make sure the storage isn't open
+	if (instanceData->isOpen)
+		{
+		E3ErrorManager_PostError(kQ3ErrorFileIsOpen, kQ3False);
+		delete instanceData->ring;
+		}
+
+
+
+	// Dispose of our instance data
+	Q3Object_CleanDispose(&instanceData->source);
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_duplicate : Read-ahead storage duplicate method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_duplicate(	TQ3Object fromObject, const void *fromPrivateData,
+								TQ3Object toObject,   void       *toPrivateData)
+{	const TQ3ReadAheadStorageData	*fromInstanceData = (const TQ3ReadAheadStorageData *) fromPrivateData;
+	TQ3ReadAheadStorageData			*toInstanceData   = (TQ3ReadAheadStorageData *) toPrivateData;
+#pragma unused(fromObject)
+#pragma unused(toObject)
+
+
+
+	// Make sure the storage isn't open
+	toInstanceData->isOpen = kQ3False;
+	toInstanceData->ring   = nullptr;
+
+	if (fromInstanceData->isOpen)
+		{
+		toInstanceData->source = nullptr;
+		E3ErrorManager_PostError(kQ3ErrorFileIsOpen, kQ3False);
+		return(kQ3Failure);
+		}
+
+
+
+	// Duplicate the source
+	toInstanceData->source = Q3Object_Duplicate(fromInstanceData->source);
+	if (toInstanceData->source == nullptr)
+		return(kQ3Failure);
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_open : Open the storage object.
+//-----------------------------------------------------------------------------
+//		Note :	The ring is only used when reading. When writing we just pass
+//				everything through to the source.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_open ( E3ReadAheadStorage* storage, TQ3Boolean forWriting )
+	{
+	TQ3ReadAheadStorageData*	instanceData = &storage->instanceData ;
+
+
+
+	// Make sure the storage isn't already open
+	if ( instanceData->isOpen )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorFileAlreadyOpen, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+
+
+	// Open the source, and start reading ahead
+	if ( ( (E3Storage*) instanceData->source )->Open ( forWriting ) != kQ3Success )
+		return kQ3Failure ;
+
+	if ( ! forWriting )
+		{
+		instanceData->ring = new(std::nothrow) E3ReadAheadRing ( instanceData->source,
+												instanceData->chunkSize, instanceData->numChunks ) ;
+		if ( instanceData->ring != nullptr )
+			instanceData->ring->Start () ;
+		}
+
+	instanceData->isOpen = kQ3True ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_close : Close the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_close ( E3ReadAheadStorage* storage )
+	{
+	TQ3ReadAheadStorageData*	instanceData = &storage->instanceData ;
+
+
+
+	// Make sure the storage is open
+	if ( ! instanceData->isOpen )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorFileNotOpen, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+
+
+	// Stop reading ahead, and close the source
+	delete instanceData->ring ;
+	instanceData->ring   = nullptr ;
+	instanceData->isOpen = kQ3False ;
+
+	return ( (E3Storage*) instanceData->source )->Close () ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_getopenness : Check openness of the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_getopenness ( E3ReadAheadStorage* storage, TQ3StorageOpenness* outOpenness )
+	{
+	*outOpenness = storage->instanceData.isOpen ? kQ3StorageOpenness_Open : kQ3StorageOpenness_Closed ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_getsize64 : Get the size of the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_getsize64 ( E3ReadAheadStorage* storage, uint64_t *size )
+	{
+	if ( storage->instanceData.ring != nullptr )
+		return storage->instanceData.ring->GetSize ( size ) ;
+
+	return ( (E3Storage*) storage->instanceData.source )->GetSize64 ( size ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_getsize : Get the size of the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_getsize ( E3ReadAheadStorage* storage, TQ3Uns32 *size )
+	{
+	uint64_t	fullSize ;
+
+
+
+	if ( e3storage_readahead_getsize64 ( storage, &fullSize ) != kQ3Success )
+		return kQ3Failure ;
+
+	if ( fullSize > 0xFFFFFFFF )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorNotSupported, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+	*size = (TQ3Uns32) fullSize ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_read64 : Read data from the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_read64 ( E3ReadAheadStorage* storage, uint64_t offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+	{
+	if ( storage->instanceData.ring != nullptr )
+		return storage->instanceData.ring->Read ( offset, dataSize, data, sizeRead ) ;
+
+	return ( (E3Storage*) storage->instanceData.source )->GetData64 ( offset, dataSize, data, sizeRead ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_read : Read data from the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_read ( E3ReadAheadStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+	{
+	return e3storage_readahead_read64 ( storage, offset, dataSize, data, sizeRead ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_write64 : Write data to the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_write64 ( E3ReadAheadStorage* storage, uint64_t offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+	{
+	if ( storage->instanceData.ring != nullptr )
+		return storage->instanceData.ring->Write ( offset, dataSize, data, sizeWritten ) ;
+
+	return ( (E3Storage*) storage->instanceData.source )->SetData64 ( offset, dataSize, data, sizeWritten ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_write : Write data to the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_readahead_write ( E3ReadAheadStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+	{
+	return e3storage_readahead_write64 ( storage, offset, dataSize, data, sizeWritten ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_readahead_metahandler : Read-ahead storage metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3storage_readahead_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+		case kQ3XMethodTypeObjectNew:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_new;
+			break;
+
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_delete;
+			break;
+
+		case kQ3XMethodTypeObjectDuplicate:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_duplicate;
+			break;
+
+		case kQ3XMethodTypeStorageOpen:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_open;
+			break;
+
+		case kQ3XMethodTypeStorageClose:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_close;
+			break;
+
+		case kQ3XMethodTypeStorageGetOpenness:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_getopenness;
+			break;
+
+		case kQ3XMethodTypeStorageGetSize:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_getsize;
+			break;
+
+		case kQ3XMethodTypeStorageReadData:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_read;
+			break;
+
+		case kQ3XMethodTypeStorageWriteData:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_write;
+			break;
+
+		case kQ3XMethodTypeStorageGetSize64:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_getsize64;
+			break;
+
+		case kQ3XMethodTypeStorageReadData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_read64;
+			break;
+
+		case kQ3XMethodTypeStorageWriteData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_readahead_write64;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3ReadAheadStorage_RegisterClass : Register the class.
+//-----------------------------------------------------------------------------
+#pragma mark -
+TQ3Status
+E3ReadAheadStorage_RegisterClass(void)
+{	TQ3Status		qd3dStatus;
+
+
+
+	// Register the class
+	qd3dStatus = Q3_REGISTER_CLASS( kQ3ClassNameStorageReadAhead, e3storage_readahead_metahandler,
+		E3ReadAheadStorage );
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadStorage_UnregisterClass : Unregister the class.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3ReadAheadStorage_UnregisterClass(void)
+{	TQ3Status		qd3dStatus;
+
+
+
+	// Unregister the class
+	qd3dStatus = E3ClassTree::UnregisterClass(kQ3StorageTypeReadAhead, kQ3True);
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadStorage_New : Create a read-ahead storage object.
+//-----------------------------------------------------------------------------
+TQ3StorageObject
+E3ReadAheadStorage_New(TQ3StorageObject source, TQ3Uns32 chunkSize, TQ3Uns32 numChunks)
+	{
+	TQ3ReadAheadStorageData	initData ;
+
+
+
+	// Fill in the defaults
+	initData.source    = source ;
+	initData.chunkSize = ( chunkSize == 0 ) ? kE3ReadAheadDefaultChunkSize : E3Num_Max ( chunkSize, kE3ReadAheadMinChunkSize ) ;
+	initData.numChunks = ( numChunks == 0 ) ? kE3ReadAheadDefaultNumChunks : E3Num_Max ( numChunks, kE3ReadAheadMinNumChunks ) ;
+	initData.isOpen    = kQ3False ;
+	initData.ring      = nullptr ;
+
+
+
+	// Create the object
+	return E3ClassTree::CreateInstance ( kQ3StorageTypeReadAhead, kQ3False, &initData ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadStorage_GetSource : Get the storage being read ahead.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3ReadAheadStorage_GetSource(TQ3StorageObject storage, TQ3StorageObject *source)
+	{
+	// Return a new reference to the source
+	*source = Q3Shared_GetReference ( ( (E3ReadAheadStorage*) storage )->instanceData.source ) ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3ReadAheadStorage_Hint : Queue a range that will be read soon.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3ReadAheadStorage_Hint(TQ3StorageObject storage, uint64_t offset, TQ3Uns32 dataSize)
+	{
+	E3ReadAheadRing*	theRing = ( (E3ReadAheadStorage*) storage )->instanceData.ring ;
+
+
+
+	// Hints are ignored unless we're open for reading
+	if ( theRing != nullptr )
+		theRing->Hint ( offset, dataSize ) ;
+
+	return kQ3Success ;
+	}
@@ -50,6 +50,7 @@
 #include "E3Renderer.h"
 #include "E3Main.h"
 #include "E3Geometry.h"
+#include "E3Trace.h"
 #include "CQ3ObjectRef_Gets.h"
 #include "GLUtils.h"
 #include "QuesaMathOperators.hpp"
@@ -416,6 +417,7 @@ E3Renderer_Method_StartFrame(TQ3ViewObject theView, TQ3DrawContextObject theDraw
 TQ3Status
 E3Renderer_Method_StartPass(TQ3ViewObject theView, TQ3CameraObject theCamera, TQ3GroupObject theLights)
 	{
+	Q3_TRACE_SCOPE ( "StartPass" ) ;
 	E3Renderer* theRenderer = (E3Renderer*) E3View_AccessRenderer ( theView ) ;
 
 	// No-op if no renderer set
@@ -445,6 +447,7 @@ E3Renderer_Method_StartPass(TQ3ViewObject theView, TQ3CameraObject theCamera, TQ
 TQ3ViewStatus
 E3Renderer_Method_EndPass(TQ3ViewObject theView)
 	{
+	Q3_TRACE_SCOPE ( "EndPass" ) ;
 	E3Renderer* theRenderer = (E3Renderer*) E3View_AccessRenderer ( theView ) ;
 
 	// No-op if no renderer set
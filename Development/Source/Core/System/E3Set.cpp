@@ -73,7 +73,7 @@
 //=============================================================================
 //      Internal constants
 //-----------------------------------------------------------------------------
-const TQ3Uns32 kSetTableSize									= 8;
+const TQ3Uns32 kSetBuiltInAttributeMask						= (1 << (kQ3AttributeTypeNumTypes - 1)) - 1;
 
 
 
@@ -84,7 +84,11 @@ const TQ3Uns32 kSetTableSize									= 8;
 //-----------------------------------------------------------------------------
 #define e3attribute_type_to_mask(theType)												\
 			((theType > kQ3AttributeTypeNone && theType < kQ3AttributeTypeNumTypes) ?	\
-				(1 << (theType - 1)) : kQ3XAttributeMaskCustomAttribute)
+				(TQ3XAttributeMask) (1 << (theType - 1)) :						\
+				(TQ3XAttributeMask) kQ3XAttributeMaskCustomAttribute)
+
+#define e3attribute_data(_setData, _theType)												\
+			((void *) (((TQ3Uns8 *) &(_setData)->attributes) + kAttributeStorage[_theType].dataOffset))
 
 
 
@@ -97,12 +101,11 @@ const TQ3Uns32 kSetTableSize									= 8;
 typedef TQ3Status (*TQ3SetIterator)(TQ3SetData *instanceData, TQ3ObjectType theType, TQ3ElementObject theElement, void *userData);
 
 
-// Set iterator param info
-typedef struct TQ3SetIteratorParamInfo {
-	TQ3SetData			*setInstanceData;	// Set instance data
-	TQ3SetIterator		theIterator;		// Set iterator
-	void				*iteratorData;		// User data for the set iterator
-} TQ3SetIteratorParamInfo;
+// Built-in attribute storage within TQ3SetAttributes
+typedef struct TQ3SetAttributeStorage {
+	TQ3Uns32			dataOffset;			// Offset of the attribute data
+	TQ3Uns32			dataSize;			// Size of the attribute data
+} TQ3SetAttributeStorage;
 
 
 
@@ -116,6 +119,28 @@ typedef struct TQ3AttributeSetInheritParamInfo {
 
 
 
+// Storage of the built-in attributes, indexed by attribute type
+static const TQ3SetAttributeStorage kAttributeStorage[kQ3AttributeTypeNumTypes] = {
+	{ 0, 0 },																				// kQ3AttributeTypeNone
+	{ offsetof(TQ3SetAttributes, surfaceUV),         sizeof(TQ3Param2D)             },	// kQ3AttributeTypeSurfaceUV
+	{ offsetof(TQ3SetAttributes, shadingUV),         sizeof(TQ3Param2D)             },	// kQ3AttributeTypeShadingUV
+	{ offsetof(TQ3SetAttributes, normal),            sizeof(TQ3Vector3D)            },	// kQ3AttributeTypeNormal
+	{ offsetof(TQ3SetAttributes, ambientCoeficient), sizeof(float)                  },	// kQ3AttributeTypeAmbientCoefficient
+	{ offsetof(TQ3SetAttributes, diffuseColor),      sizeof(TQ3ColorRGB)            },	// kQ3AttributeTypeDiffuseColor
+	{ offsetof(TQ3SetAttributes, specularColor),     sizeof(TQ3ColorRGB)            },	// kQ3AttributeTypeSpecularColor
+	{ offsetof(TQ3SetAttributes, specularControl),   sizeof(float)                  },	// kQ3AttributeTypeSpecularControl
+	{ offsetof(TQ3SetAttributes, transparencyColor), sizeof(TQ3ColorRGB)            },	// kQ3AttributeTypeTransparencyColor
+	{ offsetof(TQ3SetAttributes, surfaceTangent),    sizeof(TQ3Tangent2D)           },	// kQ3AttributeTypeSurfaceTangent
+	{ offsetof(TQ3SetAttributes, highlightState),    sizeof(TQ3Switch)              },	// kQ3AttributeTypeHighlightState
+	{ offsetof(TQ3SetAttributes, surfaceShader),     sizeof(TQ3SurfaceShaderObject) },	// kQ3AttributeTypeSurfaceShader
+	{ offsetof(TQ3SetAttributes, emissiveColor),     sizeof(TQ3ColorRGB)            },	// kQ3AttributeTypeEmissiveColor
+	{ offsetof(TQ3SetAttributes, metallic),          sizeof(float)                  }	// kQ3AttributeTypeMetallic
+};
+
+
+
+
+
 class E3AttributeSet : public E3Set // This is a leaf class so no other classes use this,
 								// so it can be here in the .c file rather than in
 								// the .h file, hence all the fields can be public
@@ -378,6 +403,32 @@ e3element_new_class_info (
 
 
 
+//=============================================================================
+//      e3set_find_element : Find an element in a set.
+//-----------------------------------------------------------------------------
+//		Note :	Sets hold few custom elements, so a linear search of the table
+//				is cheaper than hashing the type.
+//-----------------------------------------------------------------------------
+static TQ3ElementObject
+e3set_find_element(const TQ3SetData *instanceData, TQ3ElementType theType)
+{	TQ3Uns32	n;
+
+
+
+	// Find the element
+	for (n = 0; n < instanceData->numElements; n++)
+		{
+		if (instanceData->theElements[n].theType == theType)
+			return(instanceData->theElements[n].theElement);
+		}
+	
+	return(nullptr);
+}
+
+
+
+
+
 //=============================================================================
 //      e3set_add_element : Add an element to a set.
 //-----------------------------------------------------------------------------
@@ -387,22 +438,25 @@ e3set_add_element(TQ3SetData *instanceData, TQ3ElementType theType, TQ3ElementOb
 
 
 
-	// Create our table if required
-	if (instanceData->theTable == nullptr)
-		instanceData->theTable = E3HashTable_Create(kSetTableSize);
+	// Make sure the element isn't already present
+	Q3_ASSERT(e3set_find_element(instanceData, theType) == nullptr);
 
 
 
-	// Make sure we have a table
-	if (instanceData->theTable == nullptr)
-		return(kQ3Failure);
+	// Grow the table
+	qd3dStatus = Q3Memory_Reallocate(&instanceData->theElements,
+						static_cast<TQ3Uns32>((instanceData->numElements + 1) * sizeof(TQ3SetElement)));
+	if (qd3dStatus != kQ3Success)
+		return(qd3dStatus);
 
 
 
 	// Add the element to the table
-	qd3dStatus = E3HashTable_Add(instanceData->theTable, theType, theElement);
+	instanceData->theElements[instanceData->numElements].theType    = theType;
+	instanceData->theElements[instanceData->numElements].theElement = theElement;
+	instanceData->numElements++;
 
-	return(qd3dStatus);
+	return(kQ3Success);
 }
 
 
@@ -412,24 +466,34 @@ e3set_add_element(TQ3SetData *instanceData, TQ3ElementType theType, TQ3ElementOb
 //=============================================================================
 //      e3set_remove_element : Remove an element to a set.
 //-----------------------------------------------------------------------------
+//		Note :	The last element is moved into the hole, so the order of the
+//				elements in the table is not preserved.
+//-----------------------------------------------------------------------------
 static TQ3ElementObject
 e3set_remove_element(TQ3SetData *instanceData, TQ3ElementType theType)
 {	TQ3ElementObject	theElement;
+	TQ3Uns32			n;
 
 
 
-	// Make sure we have a table
-	if (instanceData->theTable == nullptr)
-		return(nullptr);
+	// Find the appropriate element, and remove it
+	for (n = 0; n < instanceData->numElements; n++)
+		{
+		if (instanceData->theElements[n].theType == theType)
+			{
+			theElement = instanceData->theElements[n].theElement;
 
+			instanceData->numElements--;
+			instanceData->theElements[n] = instanceData->theElements[instanceData->numElements];
 
+			if (instanceData->numElements == 0)
+				Q3Memory_Free(&instanceData->theElements);
 
-	// Find the appropriate element, and remove it
-	theElement = (TQ3ElementObject) E3HashTable_Find(instanceData->theTable, theType);
-	if (theElement != nullptr)
-		E3HashTable_Remove(instanceData->theTable, theType);
+			return(theElement);
+			}
+		}
 
-	return(theElement);
+	return(nullptr);
 }
 
 
@@ -446,69 +510,9 @@ e3set_clear_elements(TQ3SetData *instanceData)
 {
 
 
-	// Recreate the table
-	if (instanceData->theTable != nullptr)
-		{
-		E3HashTable_Destroy(&instanceData->theTable);
-		instanceData->theTable = nullptr;
-		}
-
-}
-
-
-
-
-
-//=============================================================================
-//      e3set_find_element : Find an element in a set.
-//-----------------------------------------------------------------------------
-static TQ3ElementObject
-e3set_find_element(const TQ3SetData *instanceData, TQ3ElementType theType)
-{	TQ3ElementObject	theElement;
-
-
-
-	// Make sure we have a table
-	if (instanceData->theTable == nullptr)
-		return(nullptr);
-
-
-
-	// Find the element
-	theElement = (TQ3ElementObject) E3HashTable_Find(instanceData->theTable, theType);
-	
-	return(theElement);
-}
-
-
-
-
-
-//=============================================================================
-//      e3set_iterator : Set iterator glue.
-//-----------------------------------------------------------------------------
-static TQ3Status
-e3set_iterator(E3HashTablePtr theTable, TQ3ObjectType theKey, void *theItem, void *userData)
-{	TQ3SetData					*setInstanceData;
-	void						*iteratorData;
-	TQ3SetIterator				theIterator;
-	TQ3SetIteratorParamInfo		*paramInfo;
-	TQ3Status					qd3dStatus;
-
-
-
-	// Get our param info
-	paramInfo        = (TQ3SetIteratorParamInfo *) userData;
-	setInstanceData  = paramInfo->setInstanceData;
-	theIterator      = paramInfo->theIterator;
-	iteratorData     = paramInfo->iteratorData;
-
-
-
-	// Invoke the iterator
-	qd3dStatus = theIterator(setInstanceData, theKey, (TQ3ElementObject) theItem, iteratorData);
-
-	return(qd3dStatus);
+	// Release the table
+	Q3Memory_Free(&instanceData->theElements);
+	instanceData->numElements = 0;
 }
 
 
@@ -518,25 +522,22 @@ e3set_iterator(E3HashTablePtr theTable, TQ3ObjectType theKey, void *theItem, voi
 //=============================================================================
 //      e3set_iterate_elements : Iterate over the elements in a set.
 //-----------------------------------------------------------------------------
+//		Note :	Only visits the custom elements, built-in attributes are held
+//				in the attributes of the set and found through its mask.
+//-----------------------------------------------------------------------------
 static TQ3Status
 e3set_iterate_elements(TQ3SetData *instanceData, TQ3SetIterator theIterator, void *userData)
-{	TQ3Status					qd3dStatus;
-	TQ3SetIteratorParamInfo		paramInfo;
-
-
-
-	// Make sure we have a table
-	if (instanceData->theTable == nullptr)
-		return(kQ3Success); // it's OK to have an empty set, just do nothing
+{	TQ3Status	qd3dStatus = kQ3Success;
+	TQ3Uns32	n;
 
 
 
-	// Iterate over the table	
-	paramInfo.setInstanceData = instanceData;
-	paramInfo.theIterator     = theIterator;
-	paramInfo.iteratorData    = userData;
-	
-	qd3dStatus = E3HashTable_Iterate(instanceData->theTable, e3set_iterator, &paramInfo);
+	// Iterate over the table (it's OK to have an empty set, just do nothing)
+	for (n = 0; n < instanceData->numElements && qd3dStatus == kQ3Success; n++)
+		qd3dStatus = theIterator(instanceData,
+								 instanceData->theElements[n].theType,
+								 instanceData->theElements[n].theElement,
+								 userData);
 	
 	return(qd3dStatus);
 }
@@ -656,8 +657,7 @@ e3set_delete ( TQ3Object inObject, void *privateData )
 
 
 	// Dispose of our instance data
-	if (instanceData->theTable != nullptr)
-		E3HashTable_Destroy(&instanceData->theTable);
+	e3set_clear_elements(instanceData);
 
 	Q3Memory_Free(&instanceData->scanResults);
 }
@@ -689,7 +689,8 @@ e3set_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 
 
 	// Initialise the instance data of the new object
-	toInstanceData->theTable = nullptr;
+	toInstanceData->numElements = 0;
+	toInstanceData->theElements = nullptr;
 	toInstanceData->theMask = fromInstanceData->theMask;
 	toInstanceData->attributes = fromInstanceData->attributes;
 	if(toInstanceData->attributes.surfaceShader != nullptr)
@@ -699,16 +700,12 @@ e3set_duplicate(TQ3Object fromObject, const void *fromPrivateData,
 
 
 	// If there are any elements to copy, duplicate them
-	if (fromInstanceData->theTable != nullptr)
+	if (fromInstanceData->numElements != 0)
 		{
 		qd3dStatus = e3set_iterate_elements((TQ3SetData *) fromInstanceData, e3set_iterator_duplicate, toInstanceData);
 		if (qd3dStatus != kQ3Success)
 			{
 			toObject->Empty () ;
-
-			if (toInstanceData->theTable != nullptr)
-				E3HashTable_Destroy(&toInstanceData->theTable);
-
 			return(kQ3Failure);
 			}
 		}
@@ -777,7 +774,12 @@ e3attributeset_iterator_inherit(TQ3SetData *instanceData, TQ3ObjectType theType,
 			qd3dStatus = ( (E3Set*) theResult )->Add ( theType, theElement->FindLeafInstanceData () ) ;
 
 
-		// Handle custom attributes
+		// Handle custom attributes from the child, which are always copied
+		else if (isChild)
+			qd3dStatus = ( (E3Set*) theResult )->Add ( theType, theElement->FindLeafInstanceData () ) ;
+
+
+		// Handle custom attributes from the parent
 		else
 			{
 			// See if we need to inherit
@@ -2022,45 +2024,18 @@ E3Set::Add ( TQ3ElementType theType, const void *data )
 	if ( ( theType  < kQ3AttributeTypeNone ) || ( theType > kQ3AttributeTypeNumTypes ) )
 		theType = E3Attribute_ClassToAttributeType ( theType ) ;
 
+	// Built-in attributes are copied into their slot
+	if ( ( theType > kQ3AttributeTypeNone ) && ( theType < kQ3AttributeTypeNumTypes ) &&
+		 ( theType != kQ3AttributeTypeSurfaceShader ) )
+		{
+		Q3Memory_Copy ( data, e3attribute_data ( &setData, theType ), kAttributeStorage[theType].dataSize ) ;
+		setData.theMask |= e3attribute_type_to_mask ( theType ) ;
+		Q3Shared_Edited ( this ) ;
+		return kQ3Success ;
+		}
+
 	switch ( theType )
 		{
-		case kQ3AttributeTypeSurfaceUV:
-			setData.attributes.surfaceUV = * ( (TQ3Param2D*) data ) ;
-			break;
-		case kQ3AttributeTypeShadingUV:
-			setData.attributes.shadingUV = * ( (TQ3Param2D*) data ) ;
-			break;
-		case kQ3AttributeTypeNormal:
-			setData.attributes.normal = * ( (TQ3Vector3D*) data ) ;
-			break;
-		case kQ3AttributeTypeAmbientCoefficient:
-			setData.attributes.ambientCoeficient = * ( (float*) data ) ;
-			break;
-		case kQ3AttributeTypeDiffuseColor:
-			setData.attributes.diffuseColor = * ( (TQ3ColorRGB*) data ) ;
-			break;
-		case kQ3AttributeTypeSpecularColor:
-			setData.attributes.specularColor = * ( (TQ3ColorRGB*) data ) ;
-			break;
-		case kQ3AttributeTypeSpecularControl:
-			setData.attributes.specularControl = * ( (float*) data ) ;
-			break;
-		case kQ3AttributeTypeMetallic:
-			setData.attributes.metallic = * ( (float*) data ) ;
-			break;
-		case kQ3AttributeTypeTransparencyColor:
-			setData.attributes.transparencyColor = * ( (TQ3ColorRGB*) data ) ;
-			break;
-		case kQ3AttributeTypeSurfaceTangent:
-			setData.attributes.surfaceTangent = * ( (TQ3Tangent2D*) data ) ;
-			break;
-		case kQ3AttributeTypeHighlightState:
-			setData.attributes.highlightState = * ( (TQ3Switch*) data ) ;
-			break;
-		case kQ3AttributeTypeEmissiveColor:
-			setData.attributes.emissiveColor = * ( (TQ3ColorRGB*) data ) ;
-			break;
-			
 		case kQ3AttributeTypeSurfaceShader:
 			if ( setData.attributes.surfaceShader != nullptr )
 				Q3Object_Dispose ( setData.attributes.surfaceShader ) ;
@@ -2131,44 +2106,15 @@ E3Set::Get ( TQ3ElementType theType, void *data )
 		if ( ( setData.theMask & e3attribute_type_to_mask(theType) ) == 0 )
 			return kQ3Failure ;
 			
+	if ( ( theType > kQ3AttributeTypeNone ) && ( theType < kQ3AttributeTypeNumTypes ) &&
+		 ( theType != kQ3AttributeTypeSurfaceShader ) )
+		{
+		Q3Memory_Copy ( e3attribute_data ( &setData, theType ), data, kAttributeStorage[theType].dataSize ) ;
+		return kQ3Success ;
+		}
+
 	switch ( theType )
 		{
-		case kQ3AttributeTypeSurfaceUV:
-			* ( (TQ3Param2D*) data ) = setData.attributes.surfaceUV ;
-			break;
-		case kQ3AttributeTypeShadingUV:
-			* ( (TQ3Param2D*) data ) = setData.attributes.shadingUV ;
-			break;
-		case kQ3AttributeTypeNormal:
-			* ( (TQ3Vector3D*) data ) = setData.attributes.normal ;
-			break;
-		case kQ3AttributeTypeAmbientCoefficient:
-			* ( (float*) data ) = setData.attributes.ambientCoeficient ;
-			break;
-		case kQ3AttributeTypeDiffuseColor:
-			* ( (TQ3ColorRGB*) data ) = setData.attributes.diffuseColor ;
-			break;
-		case kQ3AttributeTypeSpecularColor:
-			* ( (TQ3ColorRGB*) data ) = setData.attributes.specularColor ;
-			break;
-		case kQ3AttributeTypeSpecularControl:
-			* ( (float*) data ) = setData.attributes.specularControl ;
-			break;
-		case kQ3AttributeTypeMetallic:
-			* ( (float*) data ) = setData.attributes.metallic ;
-			break;
-		case kQ3AttributeTypeTransparencyColor:
-			* ( (TQ3ColorRGB*) data ) = setData.attributes.transparencyColor ;
-			break;
-		case kQ3AttributeTypeEmissiveColor:
-			* ( (TQ3ColorRGB*) data ) = setData.attributes.emissiveColor ;
-			break;
-		case kQ3AttributeTypeSurfaceTangent:
-			* ( (TQ3Tangent2D*) data ) = setData.attributes.surfaceTangent ;
-			break;
-		case kQ3AttributeTypeHighlightState:
-			* ( (TQ3Switch*) data ) = setData.attributes.highlightState ;
-			break;
 		case kQ3AttributeTypeSurfaceShader:
 			* ( (TQ3SurfaceShaderObject*) data ) =
 				((E3Shared*)setData.attributes.surfaceShader)->GetReference();
@@ -2231,44 +2177,16 @@ E3Set::CopyElement ( TQ3ElementType theType, TQ3SetObject destSet )
 		if ( ( srcSet->setData.theMask & e3attribute_type_to_mask(theType) ) == 0 )
 			return kQ3Failure ;
 			
-	switch ( theType )
+	if ( ( theType > kQ3AttributeTypeNone ) && ( theType < kQ3AttributeTypeNumTypes ) &&
+		 ( theType != kQ3AttributeTypeSurfaceShader ) )
+		{
+		Q3Memory_Copy ( e3attribute_data ( &srcSet->setData, theType ),
+						e3attribute_data ( &dstSet->setData, theType ),
+						kAttributeStorage[theType].dataSize ) ;
+		}
+
+	else switch ( theType )
 		{
-		case kQ3AttributeTypeSurfaceUV:
-			dstSet->setData.attributes.surfaceUV = srcSet->setData.attributes.surfaceUV ;
-			break;
-		case kQ3AttributeTypeShadingUV:
-			dstSet->setData.attributes.shadingUV = srcSet->setData.attributes.shadingUV ;
-			break;
-		case kQ3AttributeTypeNormal:
-			dstSet->setData.attributes.normal = srcSet->setData.attributes.normal ;
-			break;
-		case kQ3AttributeTypeAmbientCoefficient:
-			dstSet->setData.attributes.ambientCoeficient = srcSet->setData.attributes.ambientCoeficient ;
-			break;
-		case kQ3AttributeTypeDiffuseColor:
-			dstSet->setData.attributes.diffuseColor = srcSet->setData.attributes.diffuseColor ;
-			break;
-		case kQ3AttributeTypeSpecularColor:
-			dstSet->setData.attributes.specularColor = srcSet->setData.attributes.specularColor ;
-			break;
-		case kQ3AttributeTypeSpecularControl:
-			dstSet->setData.attributes.specularControl = srcSet->setData.attributes.specularControl ;
-			break;
-		case kQ3AttributeTypeMetallic:
-			dstSet->setData.attributes.metallic = srcSet->setData.attributes.metallic ;
-			break;
-		case kQ3AttributeTypeTransparencyColor:
-			dstSet->setData.attributes.transparencyColor = srcSet->setData.attributes.transparencyColor ;
-			break;
-		case kQ3AttributeTypeEmissiveColor:
-			dstSet->setData.attributes.emissiveColor = srcSet->setData.attributes.emissiveColor ;
-			break;
-		case kQ3AttributeTypeSurfaceTangent:
-			dstSet->setData.attributes.surfaceTangent = srcSet->setData.attributes.surfaceTangent ;
-			break;
-		case kQ3AttributeTypeHighlightState:
-			dstSet->setData.attributes.highlightState = srcSet->setData.attributes.highlightState ;
-			break;
 		case kQ3AttributeTypeSurfaceShader:
 			if ( dstSet->setData.attributes.surfaceShader != nullptr )
 				Q3Object_Dispose ( dstSet->setData.attributes.surfaceShader ) ;
@@ -2296,6 +2214,15 @@ E3Set::CopyElement ( TQ3ElementType theType, TQ3SetObject destSet )
 			else
 				qd3dStatus = kQ3Failure ;
 			}
+
+
+
+	// Mark the element as present in the destination
+	if ( qd3dStatus != kQ3Failure )
+		{
+		dstSet->setData.theMask |= e3attribute_type_to_mask ( theType ) ;
+		Q3Shared_Edited ( destSet ) ;
+		}
 			
 	return qd3dStatus ;
 	}
@@ -2356,6 +2283,9 @@ E3Set::Clear ( TQ3ElementType theType )
 		{
 		Q3Object_Dispose ( theElement ) ;
 		Q3Shared_Edited ( this ) ;
+
+		if ( setData.numElements == 0 )
+			setData.theMask &= ~kQ3XAttributeMaskCustomAttribute ;
 		return kQ3Success ;
 		}
 	
@@ -2379,7 +2309,7 @@ E3Set::Empty ( void )
 		}
 
 	// Remove the elements from the set
-	if ( setData.theTable != nullptr )
+	if ( setData.numElements != 0 )
 		{
 		e3set_iterate_elements ( & setData, e3set_iterator_delete, nullptr ) ;
 		e3set_clear_elements ( & setData ) ;
@@ -2437,54 +2367,20 @@ E3Set::SubmitElements ( TQ3ViewObject inView )
 	{
 	TQ3Status qd3dStatus = kQ3Success ;
 
-	// Submit the elements in the set
+	// Submit the built-in attributes in the set
+	TQ3XAttributeMask mask = setData.theMask & kSetBuiltInAttributeMask ;
 
-	if ( setData.theMask != kQ3XAttributeMaskNone )
+	for ( TQ3AttributeType theType = kQ3AttributeTypeSurfaceUV ; mask != 0 && qd3dStatus == kQ3Success ; ++theType, mask >>= 1 )
 		{
-		TQ3XAttributeMask mask = setData.theMask ;
-		if ( ( ( mask & kQ3XAttributeMaskSurfaceUV ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSurfaceUV, &setData.attributes.surfaceUV ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskShadingUV ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeShadingUV, &setData.attributes.shadingUV ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskNormal ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeNormal, &setData.attributes.normal ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskAmbientCoefficient ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeAmbientCoefficient, &setData.attributes.ambientCoeficient ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskDiffuseColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeDiffuseColor, &setData.attributes.diffuseColor ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskSpecularColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSpecularColor, &setData.attributes.specularColor ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskSpecularControl ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSpecularControl, &setData.attributes.specularControl ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskMetallic ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeMetallic,
-				&setData.attributes.metallic ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskTransparencyColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeTransparencyColor, &setData.attributes.transparencyColor ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskEmissiveColor ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeEmissiveColor, &setData.attributes.emissiveColor ) ;
-
-		if ( ( ( mask & kQ3XAttributeMaskSurfaceTangent ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSurfaceTangent, &setData.attributes.surfaceTangent ) ;
+		if ( ( mask & 1 ) != 0 )
+			qd3dStatus = E3View_SubmitImmediate ( inView, E3Attribute_AttributeToClassType ( theType ),
+													e3attribute_data ( &setData, theType ) ) ;
+		}
 
-		if ( ( ( mask & kQ3XAttributeMaskHighlightState ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeHighlightState, &setData.attributes.highlightState ) ;
 
-		if ( ( ( mask & kQ3XAttributeMaskSurfaceShader ) != 0 ) && ( qd3dStatus == kQ3Success ) )
-			qd3dStatus = E3View_SubmitImmediate ( inView, kQ3ObjectTypeAttributeSurfaceShader, &setData.attributes.surfaceShader ) ;
 
-		}
-
-	if ( ( setData.theTable != nullptr ) && ( qd3dStatus == kQ3Success ) )
+	// Submit the custom elements
+	if ( ( setData.numElements != 0 ) && ( qd3dStatus == kQ3Success ) )
 		qd3dStatus = e3set_iterate_elements ( & setData, e3set_iterator_submit, &inView ) ;
 	
 	return qd3dStatus ;
@@ -2633,52 +2529,16 @@ E3AttributeSet_GetNextAttributeType(TQ3AttributeSet theSet, TQ3AttributeType *th
 		Q3Memory_Free(& set->setData.scanResults) ;
 		
 		// put in the built-in attributes
-		if ( set->setData.theMask != kQ3XAttributeMaskNone )
-			{
-			TQ3XAttributeMask mask = set->setData.theMask ;
-			if ( ( mask & kQ3XAttributeMaskSurfaceUV ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeSurfaceUV, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskShadingUV ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeShadingUV, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskNormal ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeNormal, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskAmbientCoefficient ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeAmbientCoefficient, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskDiffuseColor ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeDiffuseColor, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskSpecularColor ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeSpecularColor, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskSpecularControl ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeSpecularControl, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskMetallic ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeMetallic, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskTransparencyColor ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeTransparencyColor, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskSurfaceTangent ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeSurfaceTangent, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskHighlightState ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeHighlightState, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskSurfaceShader ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeSurfaceShader, nullptr, nullptr ) ;
-
-			if ( ( mask & kQ3XAttributeMaskEmissiveColor ) != 0 )
-				e3set_iterator_scan_types ( & set->setData , kQ3AttributeTypeEmissiveColor, nullptr, nullptr ) ;
+		TQ3XAttributeMask mask = set->setData.theMask & kSetBuiltInAttributeMask ;
 
+		for ( TQ3AttributeType attType = kQ3AttributeTypeSurfaceUV ; mask != 0 ; ++attType, mask >>= 1 )
+			{
+			if ( ( mask & 1 ) != 0 )
+				e3set_iterator_scan_types ( & set->setData , attType, nullptr, nullptr ) ;
 			}
 
 		// Build the array of types in the set
-		if ( set->setData.theTable != nullptr )
+		if ( set->setData.numElements != 0 )
 			e3set_iterate_elements ( & set->setData, e3set_iterator_scan_types, nullptr ) ;
 		}
 	
@@ -2822,13 +2682,9 @@ E3AttributeSet_Inherit(TQ3AttributeSet parent, TQ3AttributeSet child, TQ3Attribu
 			if ( resultSet->setData.attributes.surfaceShader != nullptr )
 				resultSet->setData.attributes.surfaceShader = Q3Shared_GetReference ( temp->setData.attributes.surfaceShader ) ;
 
-			// Iterate over any additional elements
-			if ( resultSet->setData.theTable != nullptr )
-				{
-				paramInfo.theResult = parent ;
-				paramInfo.isChild   = kQ3True ;
-				qd3dStatus = e3set_iterate_elements ( &temp->setData , e3attributeset_iterator_inherit , &paramInfo ) ;
-				}
+			// Copy any custom elements, which have already been inherited
+			if ( temp->setData.numElements != 0 )
+				qd3dStatus = e3set_iterate_elements ( &temp->setData , e3set_iterator_duplicate , &resultSet->setData ) ;
 			}
 		
 		// Now just need to destroy the intermediate result
@@ -2857,7 +2713,7 @@ E3AttributeSet_Inherit(TQ3AttributeSet parent, TQ3AttributeSet child, TQ3Attribu
 
 
 			// Iterate over any additional elements
-			if ( childSet->setData.theTable != nullptr )
+			if ( childSet->setData.numElements != 0 )
 				{
 				paramInfo.theResult = result ;
 				paramInfo.isChild   = kQ3True ;
@@ -2881,44 +2737,19 @@ E3AttributeSet_Inherit(TQ3AttributeSet parent, TQ3AttributeSet child, TQ3Attribu
 
 
 			// Copy those attributes to the result
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskSurfaceUV) )
-				resultSet->setData.attributes.surfaceUV = parentSet->setData.attributes.surfaceUV ;
-
-			if  (E3Bit_IsSet(theMask, kQ3XAttributeMaskShadingUV) )
-				resultSet->setData.attributes.shadingUV = parentSet->setData.attributes.shadingUV ;
-
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskNormal) )
-				resultSet->setData.attributes.normal = parentSet->setData.attributes.normal ;
+			TQ3XAttributeMask copyMask = theMask & kSetBuiltInAttributeMask & ~kQ3XAttributeMaskSurfaceShader ;
 
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskAmbientCoefficient) )
-				resultSet->setData.attributes.ambientCoeficient = parentSet->setData.attributes.ambientCoeficient ;
-
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskDiffuseColor) )
-				resultSet->setData.attributes.diffuseColor = parentSet->setData.attributes.diffuseColor ;
-
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskSpecularColor) )
-				resultSet->setData.attributes.specularColor = parentSet->setData.attributes.specularColor ;
-
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskSpecularControl) )
-				resultSet->setData.attributes.specularControl = parentSet->setData.attributes.specularControl ;
-
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskMetallic) )
-				resultSet->setData.attributes.metallic = parentSet->setData.attributes.metallic ;
-
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskTransparencyColor) )
-				resultSet->setData.attributes.transparencyColor = parentSet->setData.attributes.transparencyColor ;
-
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskSurfaceTangent) )
-				resultSet->setData.attributes.surfaceTangent = parentSet->setData.attributes.surfaceTangent ;
-
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskHighlightState) )
-				resultSet->setData.attributes.highlightState = parentSet->setData.attributes.highlightState ;
+			for ( TQ3AttributeType theType = kQ3AttributeTypeSurfaceUV ; copyMask != 0 ; ++theType, copyMask >>= 1 )
+				{
+				if ( ( copyMask & 1 ) != 0 )
+					Q3Memory_Copy ( e3attribute_data ( &parentSet->setData, theType ),
+									e3attribute_data ( &resultSet->setData, theType ),
+									kAttributeStorage[theType].dataSize ) ;
+				}
 
 			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskSurfaceShader) )
 				resultSet->setData.attributes.surfaceShader = Q3Shared_GetReference(parentSet->setData.attributes.surfaceShader ) ;
 
-			if ( E3Bit_IsSet(theMask, kQ3XAttributeMaskEmissiveColor) )
-				resultSet->setData.attributes.emissiveColor = parentSet->setData.attributes.emissiveColor ;
 
 
 			// Update the mask in the result
@@ -2928,7 +2759,7 @@ E3AttributeSet_Inherit(TQ3AttributeSet parent, TQ3AttributeSet child, TQ3Attribu
 
 
 		// Iterate over any additional elements
-		if  (parentSet->setData.theTable != nullptr )
+		if  (parentSet->setData.numElements != 0 )
 			{
 			paramInfo.theResult = result ;
 			paramInfo.isChild   = kQ3False ;
@@ -3073,61 +2904,9 @@ E3XAttributeSet_GetPointer(TQ3AttributeSet attributeSet, TQ3AttributeType attrib
 	
 	Q3_REQUIRE_OR_RESULT(Q3_VALID_PTR(attributeSet),   nullptr);
 	
-	switch (attributeType)
-		{
-		case kQ3AttributeTypeSurfaceUV:
-			data = ( set->setData.theMask & kQ3XAttributeMaskSurfaceUV ) == 0 ?
-					nullptr : &set->setData.attributes.surfaceUV ;
-			break;
-		case kQ3AttributeTypeShadingUV:
-			data = ( set->setData.theMask & kQ3XAttributeMaskShadingUV ) == 0 ?
-					nullptr : &set->setData.attributes.shadingUV ;
-			break;
-		case kQ3AttributeTypeNormal:
-			data = ( set->setData.theMask & kQ3XAttributeMaskNormal ) == 0 ?
-					nullptr : &set->setData.attributes.normal ;
-			break;
-		case kQ3AttributeTypeAmbientCoefficient:
-			data = ( set->setData.theMask & kQ3XAttributeMaskAmbientCoefficient ) == 0 ?
-					nullptr : &set->setData.attributes.ambientCoeficient ;
-			break;
-		case kQ3AttributeTypeDiffuseColor:
-			data = ( set->setData.theMask & kQ3XAttributeMaskDiffuseColor ) == 0 ?
-					nullptr : &set->setData.attributes.diffuseColor ;
-			break;
-		case kQ3AttributeTypeSpecularColor:
-			data = ( set->setData.theMask & kQ3XAttributeMaskSpecularColor ) == 0 ?
-					nullptr : &set->setData.attributes.specularColor ;
-			break;
-		case kQ3AttributeTypeSpecularControl:
-			data = ( set->setData.theMask & kQ3XAttributeMaskSpecularControl ) == 0 ?
-					nullptr : &set->setData.attributes.specularControl ;
-			break;
-		case kQ3AttributeTypeMetallic:
-			data = ( set->setData.theMask & kQ3XAttributeMaskMetallic ) == 0 ?
-					nullptr : &set->setData.attributes.metallic ;
-			break;
-		case kQ3AttributeTypeTransparencyColor:
-			data = ( set->setData.theMask & kQ3XAttributeMaskTransparencyColor ) == 0 ?
-					nullptr : &set->setData.attributes.transparencyColor ;
-			break;
-		case kQ3AttributeTypeSurfaceTangent:
-			data = ( set->setData.theMask & kQ3XAttributeMaskSurfaceTangent ) == 0 ?
-					nullptr : &set->setData.attributes.surfaceTangent ;
-			break;
-		case kQ3AttributeTypeHighlightState:
-			data = ( set->setData.theMask & kQ3XAttributeMaskHighlightState ) == 0 ?
-					nullptr : &set->setData.attributes.highlightState;
-			break;
-		case kQ3AttributeTypeSurfaceShader:
-			data = ( set->setData.theMask & kQ3XAttributeMaskSurfaceShader ) == 0 ?
-					nullptr : &set->setData.attributes.surfaceShader  ;
-			break;
-		case kQ3AttributeTypeEmissiveColor:
-			data = ( set->setData.theMask & kQ3XAttributeMaskEmissiveColor ) == 0 ?
-					nullptr : &set->setData.attributes.emissiveColor ;
-			break;
-		}
+	if ( (attributeType > kQ3AttributeTypeNone) && (attributeType < kQ3AttributeTypeNumTypes) &&
+		 ( set->setData.theMask & e3attribute_type_to_mask(attributeType) ) != 0 )
+		data = e3attribute_data ( &set->setData, attributeType ) ;
 		
 	return data ;
 }
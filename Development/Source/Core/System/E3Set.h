@@ -129,10 +129,19 @@ typedef struct TQ3SetAttributes {
 
 
 
+// Set element (custom elements are held in a flat side table)
+typedef struct TQ3SetElement {
+	TQ3ElementType		theType;			// Element type
+	TQ3ElementObject	theElement;			// Element object
+} TQ3SetElement;
+
+
+
 // Set instance data
 typedef struct TQ3SetData {
 	TQ3SetAttributes	attributes;			// Data for built-in attributes
-	E3HashTablePtr		theTable;			// Elements in set, keyed by type
+	TQ3Uns32			numElements;		// Number of custom elements
+	TQ3SetElement		*theElements;		// Custom elements in set
 	TQ3Uns32			scanEditIndex;		// Set edit index while scanning
 	TQ3Uns32			scanCount;			// Size of scanResults
 	TQ3Uns32			scanIndex;			// Current index into scanResults
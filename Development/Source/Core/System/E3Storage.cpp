@@ -62,6 +62,8 @@
 //-----------------------------------------------------------------------------
 #define kE3MemoryStorageDefaultGrowSize					1024
 #define kE3MemoryStorageMinimumGrowSize					32
+#define kE3PathStorageWriteBufferSize					(64 * 1024)
+#define kE3StorageMax32BitOffset						((uint64_t) 0xFFFFFFFF)
 
 
 
@@ -80,7 +82,10 @@ E3StorageInfo::E3StorageInfo	(
 		: E3SharedInfo ( newClassMetaHandler, newParent ) ,
 		getData_Method		( (TQ3XStorageReadDataMethod)		Find_Method ( kQ3XMethodTypeStorageReadData ) ) ,
 		setData_Method		( (TQ3XStorageWriteDataMethod)		Find_Method ( kQ3XMethodTypeStorageWriteData ) ) ,
-		getEOF_Method		( (TQ3XStorageGetSizeMethod)		Find_Method ( kQ3XMethodTypeStorageGetSize ) )	
+		getEOF_Method		( (TQ3XStorageGetSizeMethod)		Find_Method ( kQ3XMethodTypeStorageGetSize ) ) ,
+		getData64_Method	( (TQ3XStorageReadData64Method)		Find_Method ( kQ3XMethodTypeStorageReadData64 ) ) ,
+		setData64_Method	( (TQ3XStorageWriteData64Method)	Find_Method ( kQ3XMethodTypeStorageWriteData64 ) ) ,
+		getEOF64_Method		( (TQ3XStorageGetSize64Method)		Find_Method ( kQ3XMethodTypeStorageGetSize64 ) )
 		 	 
 	{
 	if ( getData_Method == nullptr
@@ -106,6 +111,161 @@ e3storage_new_class_info (
 
 
 
+//=============================================================================
+//      e3storage_size_to_32 : Narrow a 64-bit size for the 32-bit API.
+//-----------------------------------------------------------------------------
+//		Note :	Sizes which don't fit are an error rather than being silently
+//				truncated, callers that can handle them use GetSize64.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_size_to_32 ( uint64_t fullSize, TQ3Uns32 *size )
+	{
+	if ( fullSize > kE3StorageMax32BitOffset )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorNotSupported, kQ3False ) ;
+		*size = 0 ;
+		return kQ3Failure ;
+		}
+
+	*size = (TQ3Uns32) fullSize ;
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_stdio_seek : Seek a stdio file to a 64-bit offset.
+//-----------------------------------------------------------------------------
+static int
+e3storage_stdio_seek ( FILE* theFile, uint64_t offset, int whence )
+	{
+#if QUESA_OS_WIN32
+	return _fseeki64 ( theFile, (__int64) offset, whence ) ;
+#else
+	return fseeko ( theFile, (off_t) offset, whence ) ;
+#endif
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_stdio_tell : Get the 64-bit position of a stdio file.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_stdio_tell ( FILE* theFile, uint64_t *offset )
+	{
+#if QUESA_OS_WIN32
+	__int64	thePos = _ftelli64 ( theFile ) ;
+#else
+	off_t	thePos = ftello ( theFile ) ;
+#endif
+
+	if ( thePos < 0 )
+		return kQ3Failure ;
+
+	*offset = (uint64_t) thePos ;
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_stdio_getsize : Get the size of a stdio file.
+//-----------------------------------------------------------------------------
+//		Note :	The file position is preserved.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_stdio_getsize ( FILE* theFile, uint64_t *size )
+	{
+	fpos_t		oldPos ;
+
+
+
+	// Get the current position in the file
+	if ( fgetpos ( theFile, &oldPos ) )
+		return kQ3Failure ;
+
+
+
+	// Seek to the end and get the position there
+	if ( e3storage_stdio_seek ( theFile, 0, SEEK_END ) )
+		return kQ3Failure ;
+
+	if ( e3storage_stdio_tell ( theFile, size ) != kQ3Success )
+		return kQ3Failure ;
+
+
+
+	// Restore the previous position in the file
+	if ( fsetpos ( theFile, &oldPos ) )
+		return kQ3Failure ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_stdio_seek_for_read : Position a stdio file for a read.
+//-----------------------------------------------------------------------------
+//		Note :	Skips the seek if we are already there, since some standard
+//				libraries (e.g., CodeWarrior's on Windows) always flush the
+//				buffer in fseek.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_stdio_seek_for_read ( FILE* theFile, uint64_t offset )
+	{
+	uint64_t	thePos ;
+
+
+
+	if ( e3storage_stdio_tell ( theFile, &thePos ) == kQ3Success && thePos == offset )
+		return kQ3Success ;
+
+	if ( e3storage_stdio_seek ( theFile, offset, SEEK_SET ) )
+		return kQ3Failure ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_read64_via32 : 64-bit read shim for 32-bit storage classes.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_read64_via32 ( TQ3StorageObject storage, uint64_t offset, TQ3Uns32 dataSize, TQ3Uns8 *data, TQ3Uns32 *sizeRead )
+	{
+	return ( (E3Storage*) storage )->GetData64 ( offset, dataSize, data, sizeRead ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_write64_via32 : 64-bit write shim for 32-bit storage classes.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_write64_via32 ( TQ3StorageObject storage, uint64_t offset, TQ3Uns32 dataSize, const TQ3Uns8 *data, TQ3Uns32 *sizeWritten )
+	{
+	return ( (E3Storage*) storage )->SetData64 ( offset, dataSize, data, sizeWritten ) ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3storage_memory_read : Read data from the storage object.
 //-----------------------------------------------------------------------------
@@ -427,6 +587,57 @@ e3storage_memory_metahandler(TQ3XMethodType methodType)
 
 
 
+//=============================================================================
+//      e3storage_path_flush : Write out any buffered data.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_path_flush ( TQ3PathStorageData* pathDetails )
+	{
+	TQ3Status	qd3dStatus = kQ3Success ;
+
+
+
+	// Write the pending run in one go
+	if ( pathDetails->writeLength != 0 )
+		{
+		if ( e3storage_stdio_seek ( pathDetails->theFile, pathDetails->writeStart, SEEK_SET ) ||
+			fwrite ( pathDetails->writeBuffer, 1, pathDetails->writeLength, pathDetails->theFile ) != pathDetails->writeLength )
+			qd3dStatus = kQ3Failure ;
+
+		pathDetails->writeLength = 0 ;
+		}
+
+	return qd3dStatus ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_path_release_buffer : Flush and dispose of the write buffer.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_path_release_buffer ( TQ3PathStorageData* pathDetails )
+	{
+	TQ3Status	qd3dStatus = kQ3Success ;
+
+
+
+	if ( pathDetails->theFile != nullptr )
+		qd3dStatus = e3storage_path_flush ( pathDetails ) ;
+
+	Q3Memory_Free ( &pathDetails->writeBuffer ) ;
+	pathDetails->writeStart  = 0 ;
+	pathDetails->writeLength = 0 ;
+
+	return qd3dStatus ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3storage_path_new : Path storage new method.
 //-----------------------------------------------------------------------------
@@ -467,6 +678,8 @@ e3storage_path_delete(TQ3Object storage, void *privateData)
 	if (instanceData->theFile != nullptr)
 		E3ErrorManager_PostError(kQ3ErrorFileIsOpen, kQ3False);
 
+	e3storage_path_release_buffer(instanceData);
+
 
 	// If this is an owned path, reduce the owner count
 	if (instanceData->ownerCount != nullptr)
@@ -537,6 +750,9 @@ e3storage_path_duplicate(	TQ3Object fromObject, const void *fromPrivateData,
 	TQ3PathStorageData* toInstanceData = (TQ3PathStorageData *) toPrivateData;
 	
 	toInstanceData->theFile = nullptr;
+	toInstanceData->writeBuffer = nullptr;
+	toInstanceData->writeStart = 0;
+	toInstanceData->writeLength = 0;
 
 	// Make sure the file isn't open
 	if ( fromInstanceData->theFile != nullptr )
@@ -584,11 +800,13 @@ e3storage_path_close ( TQ3StorageObject inStorage )
 
 
 
-	// Close the file		
+	// Write out anything still buffered, and close the file
+	TQ3Status qd3dStatus = e3storage_path_release_buffer ( &storage->pathDetails ) ;
+
 	fclose ( storage->pathDetails.theFile ) ;
 	storage->pathDetails.theFile = nullptr ;
 
-	return kQ3Success ;
+	return qd3dStatus ;
 }
 
 
@@ -615,13 +833,12 @@ e3storage_path_getopenness( E3PathStorage* storage, TQ3StorageOpenness* outOpenn
 
 
 //=============================================================================
-//      e3storage_path_getsize : Get the size of the storage object.
+//      e3storage_path_getsize64 : Get the size of the storage object.
 //-----------------------------------------------------------------------------
 TQ3Status
-e3storage_path_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
+e3storage_path_getsize64 ( TQ3StorageObject inStorage, uint64_t *size )
 {
 	E3PathStorage* storage = (E3PathStorage*) inStorage;
-	fpos_t					oldPos;
 
 
 
@@ -634,30 +851,31 @@ e3storage_path_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
 
 
 
-	// Get the current position in the file
-	if ( fgetpos ( storage->pathDetails.theFile, &oldPos ) )
+	// Write out anything buffered, so the size includes it
+	if ( e3storage_path_flush ( &storage->pathDetails ) != kQ3Success )
 		return kQ3Failure ;
 
+	return e3storage_stdio_getsize ( storage->pathDetails.theFile, size ) ;
+}
 
 
-	// Seek to the end and get the position there. Not that using ftell rather
-	// than fgetpos limits us to 2147483647 byte files, but casting an fpos_t
-	// to a 32-bit integer is not valid on some Unix systems.
-	if ( fseek ( storage->pathDetails.theFile, 0, SEEK_END ) )
-		return kQ3Failure ;
 
-	*size = (TQ3Uns32) ftell ( storage->pathDetails.theFile ) ;
 
-	if ( fseek ( storage->pathDetails.theFile, 0, SEEK_SET ) )
-		return kQ3Failure ;
 
+//=============================================================================
+//      e3storage_path_getsize : Get the size of the storage object.
+//-----------------------------------------------------------------------------
+TQ3Status
+e3storage_path_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
+{
+	uint64_t	fullSize;
 
 
-	// Restore the previous position in the file
-	if ( fsetpos ( storage->pathDetails.theFile, &oldPos ) )
+
+	if ( e3storage_path_getsize64 ( inStorage, &fullSize ) != kQ3Success )
 		return kQ3Failure ;
 
-	return kQ3Success ;
+	return e3storage_size_to_32 ( fullSize, size ) ;
 }
 
 
@@ -665,12 +883,13 @@ e3storage_path_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
 
 
 //=============================================================================
-//      e3storage_path_read : Read data from the storage object.
+//      e3storage_path_read64 : Read data from the storage object.
 //-----------------------------------------------------------------------------
-//		Note : Currently unbuffered - may cause performance problems.
+//		Note : Reads are unbuffered apart from the stdio buffer, but any
+//				pending writes are flushed first so that we read them back.
 //-----------------------------------------------------------------------------
 TQ3Status
-e3storage_path_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+e3storage_path_read64 ( TQ3StorageObject inStorage, uint64_t offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
 {
 	E3PathStorage* storage = (E3PathStorage*) inStorage;
 	// Make sure the file is open
@@ -680,16 +899,14 @@ e3storage_path_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 data
 		return kQ3Failure ;
 		}
 
+	if ( e3storage_path_flush ( &storage->pathDetails ) != kQ3Success )
+		return kQ3Failure ;
+
 
 
 	// Seek to the offset, and read the data
-	// (The ftell is needed because in the Windows version of
-	// CodeWarrior's standard library, fseek always flushes the buffer.)
-	if ( (TQ3Int32) offset != ftell ( storage->pathDetails.theFile ) )
-		{
-		if ( fseek ( storage->pathDetails.theFile, (long) offset, SEEK_SET ) )
-			return kQ3Failure ;
-		}
+	if ( e3storage_stdio_seek_for_read ( storage->pathDetails.theFile, offset ) != kQ3Success )
+		return kQ3Failure ;
 
 	*sizeRead = static_cast<TQ3Uns32>(fread ( data, 1, dataSize, storage->pathDetails.theFile ));
 
@@ -701,15 +918,38 @@ e3storage_path_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 data
 
 
 //=============================================================================
-//      e3storage_path_write : Write data to the storage object.
+//      e3storage_path_read : Read data from the storage object.
 //-----------------------------------------------------------------------------
-//		Note : Currently unbuffered - may cause performance problems.
+TQ3Status
+e3storage_path_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+{
+	return e3storage_path_read64 ( inStorage, offset, dataSize, data, sizeRead ) ;
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_path_write64 : Write data to the storage object.
+//-----------------------------------------------------------------------------
+//		Note :	Writes are collected in a write-behind buffer, which is flushed
+//				when a write does not continue or overwrite the buffered run,
+//				before a read or size query, and on close.
+//
+//				Writers patch sizes and offsets by seeking back a few bytes,
+//				so overwrites inside the buffered run are applied in place.
 //-----------------------------------------------------------------------------
 TQ3Status
-e3storage_path_write ( E3PathStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+e3storage_path_write64 ( E3PathStorage* storage, uint64_t offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
 	{
+	TQ3PathStorageData*		pathDetails = &storage->pathDetails ;
+	TQ3Uns32				runOffset ;
+
+
+
 	// Make sure the file is open
-	if ( storage->pathDetails.theFile == nullptr )
+	if ( pathDetails->theFile == nullptr )
 		{
 		E3ErrorManager_PostError ( kQ3ErrorFileNotOpen, kQ3False ) ;
 		return kQ3Failure ;
@@ -717,8 +957,45 @@ e3storage_path_write ( E3PathStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSiz
 
 
 
-	// Seek to the offset, and write the data
-	if ( fseek ( storage->pathDetails.theFile, (long)offset, SEEK_SET ) )
+	// Allocate the buffer on first use. If we can't, we just write directly.
+	if ( pathDetails->writeBuffer == nullptr )
+		pathDetails->writeBuffer = (TQ3Uns8 *) Q3Memory_Allocate ( kE3PathStorageWriteBufferSize ) ;
+
+
+
+	// If the data continues or overwrites the buffered run, and fits, copy it in
+	if ( pathDetails->writeLength != 0 && offset >= pathDetails->writeStart &&
+		offset - pathDetails->writeStart <= pathDetails->writeLength &&
+		dataSize <= kE3PathStorageWriteBufferSize - (offset - pathDetails->writeStart) )
+		{
+		runOffset = (TQ3Uns32) (offset - pathDetails->writeStart) ;
+		Q3Memory_Copy ( data, pathDetails->writeBuffer + runOffset, dataSize ) ;
+
+		pathDetails->writeLength = E3Num_Max ( pathDetails->writeLength, runOffset + dataSize ) ;
+		*sizeWritten = dataSize ;
+		return kQ3Success ;
+		}
+
+
+
+	// Otherwise write out the run, and start a new one here
+	if ( e3storage_path_flush ( pathDetails ) != kQ3Success )
+		return kQ3Failure ;
+
+	if ( pathDetails->writeBuffer != nullptr && dataSize < kE3PathStorageWriteBufferSize )
+		{
+		Q3Memory_Copy ( data, pathDetails->writeBuffer, dataSize ) ;
+
+		pathDetails->writeStart  = offset ;
+		pathDetails->writeLength = dataSize ;
+		*sizeWritten = dataSize ;
+		return kQ3Success ;
+		}
+
+
+
+	// Large writes bypass the buffer. Seek to the offset, and write the data
+	if ( e3storage_stdio_seek ( storage->pathDetails.theFile, offset, SEEK_SET ) )
 		return kQ3Failure ;
 
 	*sizeWritten = static_cast<TQ3Uns32>(fwrite( data, 1, dataSize, storage->pathDetails.theFile ));
@@ -730,6 +1007,19 @@ e3storage_path_write ( E3PathStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSiz
 
 
 
+//=============================================================================
+//      e3storage_path_write : Write data to the storage object.
+//-----------------------------------------------------------------------------
+TQ3Status
+e3storage_path_write ( E3PathStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+	{
+	return e3storage_path_write64 ( storage, offset, dataSize, data, sizeWritten ) ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3storage_path_metahandler : Path storage metahandler.
 //-----------------------------------------------------------------------------
@@ -776,6 +1066,18 @@ e3storage_path_metahandler(TQ3XMethodType methodType)
 		case kQ3XMethodTypeStorageWriteData:
 			theMethod = (TQ3XFunctionPointer) e3storage_path_write;
 			break;
+
+		case kQ3XMethodTypeStorageGetSize64:
+			theMethod = (TQ3XFunctionPointer) e3storage_path_getsize64;
+			break;
+
+		case kQ3XMethodTypeStorageReadData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_path_read64;
+			break;
+
+		case kQ3XMethodTypeStorageWriteData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_path_write64;
+			break;
 		}
 	
 	return(theMethod);
@@ -805,13 +1107,12 @@ e3storage_stream_new(TQ3Object theObject, void *privateData, const void *paramDa
 
 
 //=============================================================================
-//      e3storage_stream_getsize : Get the size of the storage object.
+//      e3storage_stream_getsize64 : Get the size of the storage object.
 //-----------------------------------------------------------------------------
 TQ3Status
-e3storage_stream_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
+e3storage_stream_getsize64 ( TQ3StorageObject inStorage, uint64_t *size )
 {
 	E3FileStreamStorage* storage = (E3FileStreamStorage*) inStorage;
-	fpos_t					oldPos;
 
 
 
@@ -822,32 +1123,27 @@ e3storage_stream_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
 		return kQ3Failure;
 	}
 
-
-
-	// Get the current position in the file
-	if ( fgetpos( storage->mStream, &oldPos ) )
-		return kQ3Failure;
+	return e3storage_stdio_getsize( storage->mStream, size );
+}
 
 
 
-	// Seek to the end and get the position there. Note that using ftell rather
-	// than fgetpos limits us to 2147483647 byte files, but casting an fpos_t
-	// to a 32-bit integer is not valid on some Unix systems.
-	if ( fseek( storage->mStream, 0, SEEK_END ) )
-		return kQ3Failure;
 
-	*size = (TQ3Uns32) ftell( storage->mStream ) ;
 
-	if ( fseek( storage->mStream, 0, SEEK_SET ) )
-		return kQ3Failure ;
+//=============================================================================
+//      e3storage_stream_getsize : Get the size of the storage object.
+//-----------------------------------------------------------------------------
+TQ3Status
+e3storage_stream_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
+{
+	uint64_t	fullSize;
 
 
 
-	// Restore the previous position in the file
-	if ( fsetpos( storage->mStream, &oldPos ) )
-		return kQ3Failure ;
+	if ( e3storage_stream_getsize64( inStorage, &fullSize ) != kQ3Success )
+		return kQ3Failure;
 
-	return kQ3Success;
+	return e3storage_size_to_32( fullSize, size );
 }
 
 
@@ -855,12 +1151,12 @@ e3storage_stream_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size )
 
 
 //=============================================================================
-//      e3storage_stream_read : Read data from the storage object.
+//      e3storage_stream_read64 : Read data from the storage object.
 //-----------------------------------------------------------------------------
 //		Note : Currently unbuffered - may cause performance problems.
 //-----------------------------------------------------------------------------
 TQ3Status
-e3storage_stream_read( TQ3StorageObject inStorage, TQ3Uns32 offset,
+e3storage_stream_read64( TQ3StorageObject inStorage, uint64_t offset,
 						TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
 {
 	E3FileStreamStorage* storage = (E3FileStreamStorage*) inStorage;
@@ -874,13 +1170,8 @@ e3storage_stream_read( TQ3StorageObject inStorage, TQ3Uns32 offset,
 
 
 	// Seek to the offset, and read the data
-	// (The ftell is needed because in the Windows version of
-	// CodeWarrior's standard library, fseek always flushes the buffer.)
-	if ( (TQ3Int32) offset != ftell( storage->mStream ) )
-	{
-		if ( fseek( storage->mStream, (long) offset, SEEK_SET ) )
-			return kQ3Failure;
-	}
+	if ( e3storage_stdio_seek_for_read( storage->mStream, offset ) != kQ3Success )
+		return kQ3Failure;
 
 	*sizeRead = static_cast<TQ3Uns32>(fread( data, 1, dataSize, storage->mStream ));
 
@@ -892,12 +1183,26 @@ e3storage_stream_read( TQ3StorageObject inStorage, TQ3Uns32 offset,
 
 
 //=============================================================================
-//      e3storage_stream_write : Write data to the storage object.
+//      e3storage_stream_read : Read data from the storage object.
+//-----------------------------------------------------------------------------
+TQ3Status
+e3storage_stream_read( TQ3StorageObject inStorage, TQ3Uns32 offset,
+						TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+{
+	return e3storage_stream_read64( inStorage, offset, dataSize, data, sizeRead );
+}
+
+
+
+
+
+//=============================================================================
+//      e3storage_stream_write64 : Write data to the storage object.
 //-----------------------------------------------------------------------------
 //		Note : Currently unbuffered - may cause performance problems.
 //-----------------------------------------------------------------------------
 TQ3Status
-e3storage_stream_write( E3FileStreamStorage* storage, TQ3Uns32 offset,
+e3storage_stream_write64( E3FileStreamStorage* storage, uint64_t offset,
 						TQ3Uns32 dataSize, const unsigned char *data,
 						TQ3Uns32 *sizeWritten )
 {
@@ -911,7 +1216,7 @@ e3storage_stream_write( E3FileStreamStorage* storage, TQ3Uns32 offset,
 
 
 	// Seek to the offset, and write the data
-	if ( fseek( storage->mStream, (long)offset, SEEK_SET ) )
+	if ( e3storage_stdio_seek( storage->mStream, offset, SEEK_SET ) )
 		return kQ3Failure;
 
 	*sizeWritten = static_cast<TQ3Uns32>(fwrite( data, 1, dataSize, storage->mStream ));
@@ -923,6 +1228,21 @@ e3storage_stream_write( E3FileStreamStorage* storage, TQ3Uns32 offset,
 
 
 
+//=============================================================================
+//      e3storage_stream_write : Write data to the storage object.
+//-----------------------------------------------------------------------------
+TQ3Status
+e3storage_stream_write( E3FileStreamStorage* storage, TQ3Uns32 offset,
+						TQ3Uns32 dataSize, const unsigned char *data,
+						TQ3Uns32 *sizeWritten )
+{
+	return e3storage_stream_write64( storage, offset, dataSize, data, sizeWritten );
+}
+
+
+
+
+
 //=============================================================================
 //      e3storage_stream_metahandler : Stream storage metahandler.
 //-----------------------------------------------------------------------------
@@ -948,6 +1268,18 @@ e3storage_stream_metahandler(TQ3XMethodType methodType)
 		case kQ3XMethodTypeStorageWriteData:
 			theMethod = (TQ3XFunctionPointer) e3storage_stream_write;
 			break;
+
+		case kQ3XMethodTypeStorageGetSize64:
+			theMethod = (TQ3XFunctionPointer) e3storage_stream_getsize64;
+			break;
+
+		case kQ3XMethodTypeStorageReadData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_stream_read64;
+			break;
+
+		case kQ3XMethodTypeStorageWriteData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_stream_write64;
+			break;
 	}
 	
 	return theMethod;
@@ -1013,6 +1345,12 @@ E3Storage_RegisterClass(void)
 											E3FileStreamStorage,
 											mStream ) ;
 
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = E3ReadAheadStorage_RegisterClass();
+
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = E3CompressedStorage_RegisterClass();
+
 
 
 	// Register the platform specific classes
@@ -1042,6 +1380,8 @@ E3Storage_UnregisterClass(void)
 	E3ClassTree::UnregisterClass(kQ3StorageTypeMemory, kQ3True);
 	E3ClassTree::UnregisterClass(kQ3StorageTypePath,   kQ3True);
 	E3ClassTree::UnregisterClass(kQ3StorageTypeFileStream,   kQ3True);
+	E3ReadAheadStorage_UnregisterClass();
+	E3CompressedStorage_UnregisterClass();
 
 #if QUESA_OS_WIN32
 	E3Win32Storage_UnregisterClass();
@@ -1137,6 +1477,130 @@ E3Storage::SetData ( TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char* da
 
 
 
+//=============================================================================
+//      E3Storage::GetSize64 : Return the 64-bit size of a storage object.
+//-----------------------------------------------------------------------------
+//		Note :	Classes without 64-bit methods are limited to 4GB, and use
+//				their 32-bit methods.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Storage::GetSize64 ( uint64_t* size )
+	{
+	TQ3Uns32	smallSize ;
+	TQ3Status	result ;
+
+
+
+	if ( GetClass ()->getEOF64_Method != nullptr )
+		return GetClass ()->getEOF64_Method ( this, size ) ;
+
+	result = GetClass ()->getEOF_Method ( this, &smallSize ) ;
+	*size  = ( result == kQ3Success ) ? smallSize : 0 ;
+
+	return result ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Storage::GetData64 : Return the data at a 64-bit offset.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Storage::GetData64 ( uint64_t offset, TQ3Uns32 dataSize, unsigned char* data, TQ3Uns32* sizeRead )
+	{
+	if ( GetClass ()->getData64_Method != nullptr )
+		return GetClass ()->getData64_Method ( this, offset, dataSize, (TQ3Uns8*) data, sizeRead ) ;
+
+
+
+	// Fall back to the 32-bit method, which can't see past 4GB
+	if ( offset > kE3StorageMax32BitOffset )
+		{
+		*sizeRead = 0 ;
+		E3ErrorManager_PostError ( kQ3ErrorNotSupported, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+	dataSize = (TQ3Uns32) E3Num_Min ( (uint64_t) dataSize, kE3StorageMax32BitOffset - offset ) ;
+
+	return GetClass ()->getData_Method ( this, (TQ3Uns32) offset, dataSize, (TQ3Uns8*) data, sizeRead ) ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Storage::SetData64 : Set the data at a 64-bit offset.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3Storage::SetData64 ( uint64_t offset, TQ3Uns32 dataSize, const unsigned char* data, TQ3Uns32* sizeWritten )
+	{
+	TQ3Status	result ;
+
+
+
+	if ( GetClass ()->setData64_Method != nullptr )
+		result = GetClass ()->setData64_Method ( this, offset, dataSize, (const TQ3Uns8*) data, sizeWritten ) ;
+
+
+
+	// Fall back to the 32-bit method, which can't write past 4GB
+	else if ( offset + dataSize > kE3StorageMax32BitOffset )
+		{
+		*sizeWritten = 0 ;
+		E3ErrorManager_PostError ( kQ3ErrorNotSupported, kQ3False ) ;
+		return kQ3Failure ;
+		}
+	else
+		result = GetClass ()->setData_Method ( this, (TQ3Uns32) offset, dataSize, (const TQ3Uns8*) data, sizeWritten ) ;
+
+	Edited () ;
+	
+	return result ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Storage::GetReadData64Method : Get the 64-bit read method.
+//-----------------------------------------------------------------------------
+//		Note :	File formats call the method directly for each read, so we
+//				hand out a shim for classes which only have 32-bit methods.
+//-----------------------------------------------------------------------------
+TQ3XStorageReadData64Method
+E3Storage::GetReadData64Method ( void )
+	{
+	if ( GetClass ()->getData64_Method != nullptr )
+		return GetClass ()->getData64_Method ;
+
+	return e3storage_read64_via32 ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3Storage::GetWriteData64Method : Get the 64-bit write method.
+//-----------------------------------------------------------------------------
+TQ3XStorageWriteData64Method
+E3Storage::GetWriteData64Method ( void )
+	{
+	if ( GetClass ()->setData64_Method != nullptr )
+		return GetClass ()->setData64_Method ;
+
+	return e3storage_write64_via32 ;
+	}
+
+
+
+
+
 //=============================================================================
 //      E3Storage::Open : Open a storage object without aid of a File.
 //-----------------------------------------------------------------------------
@@ -1468,7 +1932,10 @@ E3PathStorage:: Set( const char *pathName )
 	// Clean up the instance data
 
 	if ( pathDetails.theFile != nullptr )
+		{
+		e3storage_path_release_buffer ( &pathDetails ) ;
 		fclose ( pathDetails.theFile ) ;
+		}
 
 	if (pathDetails.ownerCount != nullptr)
 	{
@@ -81,6 +81,9 @@ typedef struct TQ3PathStorageData {
 	char		*thePath;
 	FILE		*theFile;
 	TQ3Uns32*	ownerCount;
+	TQ3Uns8		*writeBuffer;		// Write-behind buffer, allocated on first write
+	uint64_t	writeStart;			// File offset of writeBuffer[0]
+	TQ3Uns32	writeLength;		// Number of bytes waiting to be written
 } TQ3PathStorageData;
 
 
@@ -91,6 +94,9 @@ class E3StorageInfo : public E3SharedInfo
 	const TQ3XStorageReadDataMethod		getData_Method ;
 	const TQ3XStorageWriteDataMethod	setData_Method ;
 	const TQ3XStorageGetSizeMethod		getEOF_Method ;
+	const TQ3XStorageReadData64Method	getData64_Method ;
+	const TQ3XStorageWriteData64Method	setData64_Method ;
+	const TQ3XStorageGetSize64Method	getEOF64_Method ;
 	
 public :
 
@@ -120,6 +126,11 @@ public :
 	TQ3Status						GetSize ( TQ3Uns32* size ) ;
 	TQ3Status						GetData ( TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char* data, TQ3Uns32* sizeRead ) ;
 	TQ3Status						SetData ( TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char* data, TQ3Uns32* sizeWritten ) ;
+	TQ3Status						GetSize64 ( uint64_t* size ) ;
+	TQ3Status						GetData64 ( uint64_t offset, TQ3Uns32 dataSize, unsigned char* data, TQ3Uns32* sizeRead ) ;
+	TQ3Status						SetData64 ( uint64_t offset, TQ3Uns32 dataSize, const unsigned char* data, TQ3Uns32* sizeWritten ) ;
+	TQ3XStorageReadData64Method		GetReadData64Method ( void ) ;
+	TQ3XStorageWriteData64Method	GetWriteData64Method ( void ) ;
 	
 	TQ3Status						Open( TQ3Boolean forWriting );
 	TQ3Status						Close();
@@ -162,8 +173,11 @@ public :
 	friend TQ3Status			e3storage_path_open ( TQ3StorageObject inStorage, TQ3Boolean forWriting ) ;
 	friend TQ3Status			e3storage_path_close ( TQ3StorageObject inStorage ) ;
 	friend TQ3Status			e3storage_path_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size ) ;
+	friend TQ3Status			e3storage_path_getsize64 ( TQ3StorageObject inStorage, uint64_t *size ) ;
 	friend TQ3Status			e3storage_path_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead ) ;
+	friend TQ3Status			e3storage_path_read64 ( TQ3StorageObject inStorage, uint64_t offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead ) ;
 	friend TQ3Status			e3storage_path_write ( E3PathStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten ) ;
+	friend TQ3Status			e3storage_path_write64 ( E3PathStorage* storage, uint64_t offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten ) ;
 	friend TQ3Status			e3storage_path_getopenness( E3PathStorage* storage,
 									TQ3StorageOpenness* outOpenness );
 	} ;
@@ -181,8 +195,11 @@ public:
 	FILE*						Get();
 
 	friend TQ3Status			e3storage_stream_getsize ( TQ3StorageObject inStorage, TQ3Uns32 *size ) ;
+	friend TQ3Status			e3storage_stream_getsize64 ( TQ3StorageObject inStorage, uint64_t *size ) ;
 	friend TQ3Status			e3storage_stream_read ( TQ3StorageObject inStorage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead ) ;
+	friend TQ3Status			e3storage_stream_read64 ( TQ3StorageObject inStorage, uint64_t offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead ) ;
 	friend TQ3Status			e3storage_stream_write ( E3FileStreamStorage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten ) ;
+	friend TQ3Status			e3storage_stream_write64 ( E3FileStreamStorage* storage, uint64_t offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten ) ;
 };
 
 
@@ -200,6 +217,17 @@ TQ3StorageObject	E3MemoryStorage_NewBuffer(unsigned char *buffer, TQ3Uns32 valid
 TQ3StorageObject	E3PathStorage_New(const char *pathName, TQ3Boolean owned);
 TQ3StorageObject	E3FileStreamStorage_New(FILE *stream);
 
+TQ3Status			E3ReadAheadStorage_RegisterClass(void);
+TQ3Status			E3ReadAheadStorage_UnregisterClass(void);
+TQ3StorageObject	E3ReadAheadStorage_New(TQ3StorageObject source, TQ3Uns32 chunkSize, TQ3Uns32 numChunks);
+TQ3Status			E3ReadAheadStorage_GetSource(TQ3StorageObject storage, TQ3StorageObject *source);
+TQ3Status			E3ReadAheadStorage_Hint(TQ3StorageObject storage, uint64_t offset, TQ3Uns32 dataSize);
+
+TQ3Status			E3CompressedStorage_RegisterClass(void);
+TQ3Status			E3CompressedStorage_UnregisterClass(void);
+TQ3StorageObject	E3CompressedStorage_New(TQ3StorageObject source, TQ3Uns32 blockSize);
+TQ3Status			E3CompressedStorage_GetSource(TQ3StorageObject storage, TQ3StorageObject *source);
+
 
 
 // Windows specific
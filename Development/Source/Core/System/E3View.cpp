@@ -56,11 +56,13 @@
 #include "E3Math_Intersect.h"
 #include "E3FastArray.h"
 #include "E3Math.h"
+#include "E3Trace.h"
 #include "QuesaMathOperators.hpp"
 
 #include "GLUtils.h"
 
 #include <stdint.h>
+#include <chrono>
 
 
 
@@ -173,6 +175,15 @@ typedef struct TQ3ViewStackItem {
 } TQ3ViewStackItem;
 
 
+// Frame statistics
+typedef struct TQ3ViewStatisticsState {
+	TQ3ViewFrameStatistics					totals;
+	E3FastArray<TQ3ViewTypeStatistics>		types;
+	TQ3Uns32								lastTypeIndex;
+	std::chrono::steady_clock::time_point	frameStart;
+} TQ3ViewStatisticsState;
+
+
 // View data
 typedef struct TQ3ViewData {
 	// View state
@@ -244,6 +255,15 @@ typedef struct TQ3ViewData {
 	const void					*idleData;
 	const void					*idleProgressData;
 	const void					*endFrameData;
+
+
+	// Frame statistics
+	TQ3ViewStatisticsState		*frameStatistics;		// Non-nullptr if statistics are enabled
+	TQ3ViewStatisticsState		*activeStatistics;		// Non-nullptr while rendering a frame
+
+
+	// Trace state
+	uint64_t					traversalStartTime;		// Non-zero while tracing a rendering pass
 } TQ3ViewData;
 
 
@@ -626,6 +646,113 @@ e3view_stack_update ( E3View* view, TQ3ViewStackState stateChange )
 
 
 
+//=============================================================================
+//      e3view_statistics_find_type : Find the statistics for a type.
+//-----------------------------------------------------------------------------
+//		Note :	Runs of the same type are common, so we check the type we
+//				found last time before searching. Types we have not seen in
+//				this frame are appended.
+//-----------------------------------------------------------------------------
+static TQ3ViewTypeStatistics *
+e3view_statistics_find_type ( TQ3ViewStatisticsState* theState, TQ3ObjectType theType )
+	{
+	TQ3Uns32		n ;
+
+
+
+	// Check the last type we found
+	if ( theState->lastTypeIndex < theState->types.size ()
+	&&	 theState->types[ theState->lastTypeIndex ].objectType == theType )
+		return &theState->types[ theState->lastTypeIndex ] ;
+
+
+
+	// Search for the type, adding it if it's new
+	for ( n = 0 ; n < theState->types.size () ; ++n )
+		{
+		if ( theState->types[ n ].objectType == theType )
+			break ;
+		}
+
+	if ( n == theState->types.size () )
+		{
+		TQ3ViewTypeStatistics newType = { theType, 0, 0 } ;
+		theState->types.push_back ( newType ) ;
+		}
+
+	theState->lastTypeIndex = n ;
+	return &theState->types[ n ] ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_statistics_count_submit : Count a submitted object.
+//-----------------------------------------------------------------------------
+static void
+e3view_statistics_count_submit ( TQ3ViewStatisticsState* theState, TQ3ObjectType theType )
+	{
+	theState->totals.objectsSubmitted++ ;
+	e3view_statistics_find_type ( theState, theType )->objectsSubmitted++ ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_statistics_begin_frame : Start collecting statistics for a frame.
+//-----------------------------------------------------------------------------
+static void
+e3view_statistics_begin_frame ( E3View* view )
+	{
+	TQ3ViewStatisticsState*		theState = view->instanceData.frameStatistics ;
+
+
+
+	// Reset the statistics, if they're enabled
+	if ( theState == nullptr )
+		return ;
+
+	Q3Memory_Clear ( &theState->totals, sizeof ( theState->totals ) ) ;
+	theState->totals.structureVersion = kQ3ViewFrameStatisticsStructureVersion ;
+	theState->types.clear () ;
+	theState->lastTypeIndex = 0 ;
+	theState->frameStart    = std::chrono::steady_clock::now () ;
+
+	view->instanceData.activeStatistics = theState ;
+	}
+
+
+
+
+
+//=============================================================================
+//      e3view_statistics_end_frame : Stop collecting statistics for a frame.
+//-----------------------------------------------------------------------------
+static void
+e3view_statistics_end_frame ( E3View* view )
+	{
+	TQ3ViewStatisticsState*		theState = view->instanceData.activeStatistics ;
+
+
+
+	// Record the time taken by the frame
+	if ( theState == nullptr )
+		return ;
+
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now () - theState->frameStart ;
+	theState->totals.elapsedMilliseconds = elapsed.count () ;
+
+	view->instanceData.activeStatistics = nullptr ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3view_stack_push : Push the view state stack.
 //-----------------------------------------------------------------------------
@@ -639,6 +766,9 @@ e3view_stack_push ( E3View* view )
 	Q3_ASSERT_VALID_PTR(view);
 	TQ3ViewData& instanceData( view->instanceData );
 
+	if ( instanceData.activeStatistics != nullptr )
+		instanceData.activeStatistics->totals.statePushes++ ;
+
 
 
 	// Grow the view stack to the hold the new item
@@ -1170,10 +1300,14 @@ e3view_submit_retained_render ( TQ3Object theView, TQ3Object theObject)
 	{
 	TQ3Status qd3dStatus = kQ3Success ;
 	E3Root* theClass = (E3Root*) theObject->GetClass () ;
+	TQ3ViewStatisticsState* theStatistics = ( (E3View*) theView )->instanceData.activeStatistics ;
 
 
 
 	// Submit the object
+	if ( theStatistics != nullptr )
+		e3view_statistics_count_submit ( theStatistics, theClass->GetType () ) ;
+
 	if (theClass->submitRenderMethod != nullptr)
 		qd3dStatus = theClass->submitRenderMethod ( theView, theClass->GetType (), theObject, theObject->FindLeafInstanceData () ) ;
 
@@ -1227,6 +1361,37 @@ e3view_submit_immediate_error ( TQ3ViewObject inView , TQ3ObjectType objectType
 
 
 
+//=============================================================================
+//      e3view_submit_immediate_render_class : Render immediate data.
+//-----------------------------------------------------------------------------
+//		Note :	Shared by e3view_submit_immediate_render and the resolved
+//				class fast path of E3View_SubmitImmediateClass, so that both
+//				count the submit in the frame statistics.
+//-----------------------------------------------------------------------------
+static inline TQ3Status
+e3view_submit_immediate_render_class ( TQ3ViewObject theView , E3Root* theClass , const void* objectData )
+	{
+	TQ3ViewStatisticsState* theStatistics = ( (E3View*) theView )->instanceData.activeStatistics ;
+
+
+
+	// Count the object
+	if ( theStatistics != nullptr )
+		e3view_statistics_count_submit ( theStatistics, theClass->GetType () ) ;
+
+
+
+	// Call the rendering submit method unless it is nullptr
+	if ( theClass->submitRenderMethod == nullptr )
+		return kQ3Success ;
+		
+	return theClass->submitRenderMethod ( theView, theClass->GetType (), nullptr, objectData ) ;
+	}
+
+
+
+
+
 //=============================================================================
 //      e3view_submit_immediate_render : viewMode == kQ3ViewModeDrawing.
 //-----------------------------------------------------------------------------
@@ -1241,12 +1406,7 @@ e3view_submit_immediate_render ( TQ3ViewObject theView , TQ3ObjectType objectTyp
 		return kQ3Failure ;
 		}
 
-
-	// Call the rendering submit method unless it is nullptr
-	if ( theClass->submitRenderMethod == nullptr )
-		return kQ3Success ;
-		
-	return theClass->submitRenderMethod ( theView, objectType, nullptr, objectData ) ;
+	return e3view_submit_immediate_render_class ( theView, theClass, objectData ) ;
 	}
 
 
@@ -1444,7 +1604,15 @@ e3view_submit_begin ( E3View* view, TQ3ViewMode viewMode )
 
 	// Push the first entry on the view stack
 	if ( qd3dStatus != kQ3Failure )
+		{
+		if ( view->instanceData.activeStatistics != nullptr )
+			view->instanceData.activeStatistics->totals.numPasses++ ;
+
+		if ( view->instanceData.viewMode == kQ3ViewModeDrawing )
+			view->instanceData.traversalStartTime = E3Trace_IsEnabled () ? E3Trace_Now () : 0 ;
+
 		qd3dStatus = e3view_stack_push ( view ) ;
+		}
 
 
 
@@ -1559,6 +1727,8 @@ e3view_submit_end ( E3View* view, TQ3ViewStatus submitStatus )
 		}
 	else
 		{
+		e3view_statistics_end_frame ( view ) ;
+
 		view->instanceData.viewState             = kQ3ViewStateInactive ;
 		view->instanceData.viewPass              = 0 ;
 		view->instanceData.submitRetainedMethod  = (TQ3XViewSubmitRetainedMethod) e3view_submit_retained_error ;
@@ -1603,6 +1773,7 @@ e3view_pick_begin ( E3View* view, TQ3PickObject thePick )
 	// Save a reference to the pick object
 	Q3_ASSERT( view->instanceData.thePick == nullptr);
 	view->instanceData.thePick = thePick ;
+	E3Pick_BeginPicking( thePick );
 
 
 
@@ -1678,7 +1849,9 @@ e3view_pick_end ( E3View* view )
 
 
 
-	// Forget our reference to the pick object (don't dispose of it, as picks aren't shared)
+	// Let the pick finish off its hits, then forget our reference to the pick
+	// object (don't dispose of it, as picks aren't shared)
+	E3Pick_EndPicking ( view->instanceData.thePick ) ;
 	view->instanceData.thePick = nullptr ;
 
 
@@ -1860,6 +2033,7 @@ e3view_delete ( TQ3ViewObject view, void *privateData )
 	Q3Object_CleanDispose(&instanceData->defaultAttributeSet);
 	Q3Object_CleanDispose(&instanceData->boundingPointsSlab);
 	delete instanceData->boundingPointsArray;
+	delete instanceData->frameStatistics;
 
 	e3view_stack_pop_clean ( (E3View*) view ) ;
 	
@@ -2120,6 +2294,40 @@ E3View_SubmitImmediate ( TQ3ViewObject theView , TQ3ObjectType objectType , cons
 
 
 
+//=============================================================================
+//      E3View_SubmitImmediateClass : Submit immediate data for a known class.
+//-----------------------------------------------------------------------------
+//		Note :	Fast path for callers which have already resolved the class
+//				of the data they submit. When drawing we call the class's
+//				cached render method directly, avoiding the class tree lookup
+//				made by E3View_SubmitImmediate. The submit is still counted
+//				in the frame statistics.
+//
+//				Other view modes need the bookkeeping performed by the mode's
+//				immediate submit method, so fall back to that.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_SubmitImmediateClass ( TQ3ViewObject theView , TQ3XObjectClass objectClass , const void* objectData )
+	{
+	E3View* view     = (E3View*) theView ;
+	E3Root* theClass = (E3Root*) objectClass ;
+
+
+
+	// Call the render method directly if we can
+	if ( view->instanceData.viewMode == kQ3ViewModeDrawing )
+		return e3view_submit_immediate_render_class ( theView, theClass, objectData ) ;
+
+
+
+	// Otherwise use the submit method for the mode
+	return view->instanceData.submitImmediateMethod ( theView , theClass->GetType () , objectData ) ;
+	}
+
+
+
+
+
 //=============================================================================
 //      E3View_CallIdleMethod : Call the idle method for a view.
 //-----------------------------------------------------------------------------
@@ -3992,6 +4200,7 @@ TQ3Status
 E3View_StartRendering(TQ3ViewObject theView)
 	{
 	TQ3DrawContextData		drawContextData;
+	Q3_TRACE_SCOPE ( "StartRendering" ) ;
 
 
 
@@ -4030,7 +4239,10 @@ E3View_StartRendering(TQ3ViewObject theView)
 
 
 
-	// Start the submit loop
+	// Start the submit loop, and the frame statistics if this is the first pass
+	if ( ( (E3View*) theView )->instanceData.viewState == kQ3ViewStateInactive )
+		e3view_statistics_begin_frame ( (E3View*) theView ) ;
+
 	TQ3Status qd3dStatus = e3view_submit_begin ( (E3View*) theView, kQ3ViewModeDrawing ) ;
 	if (qd3dStatus == kQ3Failure)
 	{
@@ -4118,6 +4330,15 @@ E3View_EndRendering(TQ3ViewObject theView)
 
 
 
+	// Record the time taken to submit the pass
+	if ( ( (E3View*) theView )->instanceData.traversalStartTime != 0 )
+		{
+		E3Trace_Record ( "Traversal", 0, ( (E3View*) theView )->instanceData.traversalStartTime ) ;
+		( (E3View*) theView )->instanceData.traversalStartTime = 0 ;
+		}
+
+
+
 	// If we're still in the submit loop, end the pass
 	if ( ( (E3View*) theView )->instanceData.viewState == kQ3ViewStateSubmitting )
 		viewStatus = E3Renderer_Method_EndPass ( theView ) ;
@@ -4749,6 +4970,196 @@ E3View_IsGroupCullingAllowed( TQ3ViewObject theView )
 
 
 
+//=============================================================================
+//      E3View_SetFrameStatisticsState : Turn frame statistics on or off.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_SetFrameStatisticsState( TQ3ViewObject theView, TQ3Boolean isEnabled )
+	{
+	TQ3ViewData&	instanceData = ( (E3View*) theView )->instanceData ;
+
+
+
+	// Turn statistics on
+	if ( isEnabled && instanceData.frameStatistics == nullptr )
+		{
+		try
+			{
+			instanceData.frameStatistics = new TQ3ViewStatisticsState ;
+			}
+		catch ( std::bad_alloc& )
+			{
+			E3ErrorManager_PostError ( kQ3ErrorOutOfMemory, kQ3False ) ;
+			return kQ3Failure ;
+			}
+
+		Q3Memory_Clear ( &instanceData.frameStatistics->totals, sizeof ( TQ3ViewFrameStatistics ) ) ;
+		instanceData.frameStatistics->totals.structureVersion = kQ3ViewFrameStatisticsStructureVersion ;
+		instanceData.frameStatistics->lastTypeIndex = 0 ;
+		}
+
+
+
+	// Turn statistics off
+	else if ( ! isEnabled && instanceData.frameStatistics != nullptr )
+		{
+		delete instanceData.frameStatistics ;
+		instanceData.frameStatistics  = nullptr ;
+		instanceData.activeStatistics = nullptr ;
+		}
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3View_GetFrameStatistics : Get the statistics for the last frame.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_GetFrameStatistics( TQ3ViewObject theView, TQ3ViewFrameStatistics* statistics )
+	{
+	TQ3ViewStatisticsState*		theState = ( (E3View*) theView )->instanceData.frameStatistics ;
+
+
+
+	// Make sure statistics are enabled and the structure is one we know
+	if ( theState == nullptr )
+		return kQ3Failure ;
+
+	if ( statistics->structureVersion != kQ3ViewFrameStatisticsStructureVersion )
+		{
+		E3ErrorManager_PostError ( kQ3ErrorInvalidParameter, kQ3False ) ;
+		return kQ3Failure ;
+		}
+
+
+
+	// Return the statistics. If we're still rendering, the frame hasn't finished.
+	*statistics = theState->totals ;
+	
+	if ( ( (E3View*) theView )->instanceData.activeStatistics != nullptr )
+		statistics->elapsedMilliseconds = 0.0f ;
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3View_GetFrameTypeStatistics : Get the per-type frame statistics.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_GetFrameTypeStatistics( TQ3ViewObject theView, TQ3Uns32 maxTypes,
+								TQ3Uns32* numTypes, TQ3ViewTypeStatistics* typeStatistics )
+	{
+	TQ3ViewStatisticsState*		theState = ( (E3View*) theView )->instanceData.frameStatistics ;
+	TQ3Uns32					n ;
+
+
+
+	// Make sure statistics are enabled
+	*numTypes = 0 ;
+
+	if ( theState == nullptr )
+		return kQ3Failure ;
+
+
+
+	// Return as many types as will fit
+	*numTypes = theState->types.size () ;
+
+	if ( typeStatistics != nullptr )
+		{
+		for ( n = 0 ; n < *numTypes && n < maxTypes ; ++n )
+			typeStatistics[ n ] = theState->types[ n ] ;
+		}
+
+	return kQ3Success ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3View_AccessFrameStatistics : Access the statistics being collected.
+//-----------------------------------------------------------------------------
+//		Note :	Returns nullptr unless statistics are enabled and a frame is
+//				being rendered, so callers can skip their counting cheaply.
+//-----------------------------------------------------------------------------
+TQ3ViewFrameStatistics *
+E3View_AccessFrameStatistics( TQ3ViewObject theView )
+	{
+	TQ3ViewStatisticsState*		theState = ( (E3View*) theView )->instanceData.activeStatistics ;
+
+	return ( theState != nullptr ) ? &theState->totals : nullptr ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3View_AccessFrameTypeStatistics : Access the statistics for a type.
+//-----------------------------------------------------------------------------
+//		Note :	Returns nullptr unless statistics are enabled and a frame is
+//				being rendered.
+//-----------------------------------------------------------------------------
+TQ3ViewTypeStatistics *
+E3View_AccessFrameTypeStatistics( TQ3ViewObject theView, TQ3ObjectType theType )
+	{
+	TQ3ViewStatisticsState*		theState = ( (E3View*) theView )->instanceData.activeStatistics ;
+
+	return ( theState != nullptr ) ? e3view_statistics_find_type ( theState, theType ) : nullptr ;
+	}
+
+
+
+
+
+//=============================================================================
+//      E3View_RecordUpload : Record data uploaded by the renderer.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3View_RecordUpload( TQ3ViewObject theView, TQ3XViewUploadType uploadType, TQ3Uns32 numBytes )
+	{
+	TQ3ViewFrameStatistics*		theStatistics = E3View_AccessFrameStatistics ( theView ) ;
+
+
+
+	// Count the upload, if we're collecting statistics
+	if ( theStatistics == nullptr )
+		return kQ3Success ;
+
+	switch ( uploadType )
+		{
+		case kQ3XViewUploadTypeBuffer:
+			theStatistics->buffersUploaded++ ;
+			theStatistics->bufferBytesUploaded += numBytes ;
+			break ;
+
+		case kQ3XViewUploadTypeTexture:
+			theStatistics->texturesUploaded++ ;
+			theStatistics->textureBytesUploaded += numBytes ;
+			break ;
+
+		default:
+			E3ErrorManager_PostError ( kQ3ErrorInvalidParameter, kQ3False ) ;
+			return kQ3Failure ;
+		}
+
+	return kQ3Success ;
+	}
+
+
+
+
+
 //=============================================================================
 //      E3View_TransformLocalToWorld : Transform a point from local->world.
 //-----------------------------------------------------------------------------
@@ -100,6 +100,7 @@ TQ3Status				E3View_RegisterClass(void);
 TQ3Status				E3View_UnregisterClass(void);
 TQ3Status				E3View_SubmitRetained(TQ3ViewObject theView, TQ3Object theObject);
 TQ3Status				E3View_SubmitImmediate(TQ3ViewObject theView, TQ3ObjectType objectType, const void *objectData);
+TQ3Status				E3View_SubmitImmediateClass(TQ3ViewObject theView, TQ3XObjectClass objectClass, const void *objectData);
 TQ3Status				E3View_CallIdleMethod(TQ3ViewObject theView, TQ3Uns32 current, TQ3Uns32 completed);
 TQ3PickObject			E3View_AccessPick(TQ3ViewObject theView);
 TQ3RendererObject		E3View_AccessRenderer(TQ3ViewObject theView);
@@ -210,6 +211,13 @@ TQ3Status				E3View_SetEndFrameMethod(TQ3ViewObject theView, TQ3ViewEndFrameMeth
 TQ3Boolean				E3View_IsBoundingBoxVisible(TQ3ViewObject theView, const TQ3BoundingBox *theBBox);
 TQ3Status				E3View_AllowAllGroupCulling(TQ3ViewObject theView, TQ3Boolean allowCulling);
 TQ3Boolean				E3View_IsGroupCullingAllowed( TQ3ViewObject theView );
+TQ3Status				E3View_SetFrameStatisticsState( TQ3ViewObject theView, TQ3Boolean isEnabled );
+TQ3Status				E3View_GetFrameStatistics( TQ3ViewObject theView, TQ3ViewFrameStatistics* statistics );
+TQ3Status				E3View_GetFrameTypeStatistics( TQ3ViewObject theView, TQ3Uns32 maxTypes,
+															TQ3Uns32* numTypes, TQ3ViewTypeStatistics* typeStatistics );
+TQ3ViewFrameStatistics*	E3View_AccessFrameStatistics( TQ3ViewObject theView );
+TQ3ViewTypeStatistics*	E3View_AccessFrameTypeStatistics( TQ3ViewObject theView, TQ3ObjectType theType );
+TQ3Status				E3View_RecordUpload( TQ3ViewObject theView, TQ3XViewUploadType uploadType, TQ3Uns32 numBytes );
 TQ3Status				E3View_TransformLocalToWorld(TQ3ViewObject theView, const TQ3Point3D *localPoint, TQ3Point3D *worldPoint);
 TQ3Status				E3View_TransformLocalToWindow(TQ3ViewObject theView, const TQ3Point3D *localPoint, TQ3Point2D *windowPoint);
 TQ3Status				E3View_TransformLocalToFrustum(TQ3ViewObject theView, const TQ3Point3D *localPoint, TQ3Point3D *frustumPoint);
@@ -46,13 +46,25 @@
 #include "E3Prefix.h"
 #include "E3IO.h"
 #include "E3IOFileFormat.h"
+#include "E3Storage.h"
 #include "E3FFR_3DMF.h"
+#include "E3Trace.h"
 #include "E3View.h"
 
 
 
 
 
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+const TQ3Uns32 kE3FileFormatTextBlockSize						= 256;
+const TQ3Uns32 kE3FileFormatSwapBlockSize						= 256;
+
+
+
+
+
 //=============================================================================
 //      Public functions
 //-----------------------------------------------------------------------------
@@ -136,6 +148,18 @@ E3FileFormat_Init(TQ3FileFormatObject theFileFormat, TQ3StorageObject storage)
 {
 	TQ3FFormatBaseData		*instanceData = (TQ3FFormatBaseData *) theFileFormat->FindLeafInstanceData () ;
 
+
+
+	// A format whose instance data is smaller than the base data was built
+	// against an earlier layout of TQ3FFormatBaseData, and can't be used.
+	if (theFileFormat->GetClass()->GetInstanceSize() < sizeof(TQ3FFormatBaseData))
+		{
+		E3ErrorManager_PostError(kQ3ErrorInvalidObjectClass, kQ3False);
+		return(kQ3Failure);
+		}
+
+	instanceData->baseDataVersion = kQ3FFormatBaseDataVersion;
+
 	E3Shared_Replace(&instanceData->storage, storage);
 
 	if( instanceData->storage != nullptr)
@@ -145,7 +169,7 @@ E3FileFormat_Init(TQ3FileFormatObject theFileFormat, TQ3StorageObject storage)
 	instanceData->readInGroup = kQ3True;
 
 	
-	if(Q3Storage_GetSize(storage, &instanceData->logicalEOF) == kQ3Failure)
+	if(( (E3Storage*) storage )->GetSize64(&instanceData->logicalEOF) == kQ3Failure)
 		return kQ3Failure;
 	}
 	
@@ -331,13 +355,13 @@ E3FileFormat_GenericReadBinary_StringPadded(TQ3FileFormatObject format, char* da
 	TQ3Uns32 					sizeRead = 0;
 	TQ3Status 					result = kQ3Failure;
 	TQ3FFormatBaseData			*instanceData = (TQ3FFormatBaseData *) format->FindLeafInstanceData () ;
-	TQ3Uns32					startOffset;
+	uint64_t					startOffset;
 	TQ3Uns32					bufferSize = *ioLength;
 	
 	char* 						dataPtr = data;
 	char 						lastChar;
 
-	TQ3XStorageReadDataMethod dataRead = (TQ3XStorageReadDataMethod) instanceData->storage->GetMethod ( kQ3XMethodTypeStorageReadData ) ;
+	TQ3XStorageReadData64Method dataRead = ( (E3Storage*) instanceData->storage )->GetReadData64Method () ;
 
 	*ioLength = 0;
 	
@@ -377,7 +401,7 @@ E3FileFormat_GenericReadBinary_StringPadded(TQ3FileFormatObject format, char* da
 		else  if (padTo4 == kQ3True){
 			// skip pad bytes
 			instanceData->currentStoragePosition = startOffset +
-				Q3Size_Pad( instanceData->currentStoragePosition - startOffset );
+				Q3Size_Pad( (TQ3Uns32) (instanceData->currentStoragePosition - startOffset) );
 		}
 		
 		if (lastChar == 0)
@@ -402,7 +426,7 @@ E3FileFormat_GenericReadBinary_Raw(TQ3FileFormatObject format, unsigned char* da
 	TQ3Status result = kQ3Failure;
 	TQ3FFormatBaseData		*instanceData = (TQ3FFormatBaseData *) format->FindLeafInstanceData ();
 
-	TQ3XStorageReadDataMethod dataRead = (TQ3XStorageReadDataMethod) instanceData->storage->GetMethod ( kQ3XMethodTypeStorageReadData ) ;
+	TQ3XStorageReadData64Method dataRead = ( (E3Storage*) instanceData->storage )->GetReadData64Method () ;
 
 	if( dataRead != nullptr)
 		result = dataRead(instanceData->storage,
@@ -532,17 +556,21 @@ E3FileFormat_GenericReadBinSwap_64(TQ3FileFormatObject format, TQ3Int64* data)
 //      E3FileFormat_GenericReadText_SkipBlanks : positions the currentPosition
 //							pointing to the first non blank char.
 //-----------------------------------------------------------------------------
+//		Note :	Reads the storage in blocks rather than a byte at a time, so
+//				long runs of indentation cost one read per block.
+//-----------------------------------------------------------------------------
 TQ3Status
 E3FileFormat_GenericReadText_SkipBlanks(TQ3FileFormatObject format)
 {	TQ3FFormatBaseData			*instanceData = (TQ3FFormatBaseData *) format->FindLeafInstanceData ();
 	TQ3Status					result        = kQ3Success;
 	TQ3Uns32					sizeRead      = 0;
-	char						buffer;
+	TQ3Uns32					n, blockSize;
+	TQ3Uns8						buffer[kE3FileFormatTextBlockSize];
 
 
 
 	// Get the read method
-	TQ3XStorageReadDataMethod dataRead = (TQ3XStorageReadDataMethod) instanceData->storage->GetMethod ( kQ3XMethodTypeStorageReadData ) ;
+	TQ3XStorageReadData64Method dataRead = ( (E3Storage*) instanceData->storage )->GetReadData64Method () ;
 	if (dataRead == nullptr)
 		return(kQ3Failure);
 
@@ -551,10 +579,19 @@ E3FileFormat_GenericReadText_SkipBlanks(TQ3FileFormatObject format)
 	// Skip until we find the end of the file or a non-blank character
 	while (result == kQ3Success && instanceData->currentStoragePosition < instanceData->logicalEOF)
 		{
-		result = dataRead(instanceData->storage, instanceData->currentStoragePosition, 1, (TQ3Uns8 *)&buffer, &sizeRead);
-		if (buffer <= 0x20 || buffer == 0x7F) 
-			instanceData->currentStoragePosition++;
-		else
+		blockSize = (TQ3Uns32) E3Num_Min( (uint64_t) sizeof(buffer), instanceData->logicalEOF - instanceData->currentStoragePosition );
+		result    = dataRead(instanceData->storage, instanceData->currentStoragePosition, blockSize, buffer, &sizeRead);
+		if (result != kQ3Success || sizeRead == 0)
+			break;
+
+		for (n = 0; n < sizeRead; n++)
+			{
+			if (buffer[n] > 0x20 && buffer[n] != 0x7F)
+				break;
+			}
+
+		instanceData->currentStoragePosition += n;
+		if (n < sizeRead)
 			break;
 		}
 
@@ -594,65 +631,71 @@ E3FileFormat_GenericReadText_ReadUntilChars(TQ3FileFormatObject format, char* bu
 											TQ3Int32* foundChar,TQ3Uns32 maxLen,
 											TQ3Uns32* charsRead)
 {
-	TQ3Boolean found;
-
 	TQ3Uns32 sizeRead = 0;
 	TQ3Uns32 index = 0;
 	TQ3Uns32 i;
 	TQ3Status result = kQ3Failure;
+	TQ3Boolean isStop[256] = { kQ3False };
+	TQ3Boolean stopOnNewline = kQ3False;
+	TQ3Uns8 theChar;
 	TQ3FFormatBaseData		*instanceData = (TQ3FFormatBaseData *) format->FindLeafInstanceData ();
 
 	if(foundChar)
 		*foundChar = -1;
 
-	TQ3XStorageReadDataMethod dataRead = (TQ3XStorageReadDataMethod) instanceData->storage->GetMethod ( kQ3XMethodTypeStorageReadData ) ;
+	TQ3XStorageReadData64Method dataRead = ( (E3Storage*) instanceData->storage )->GetReadData64Method () ;
 	
 	// The read method may post an error if we try to read beyond the end of file
-	maxLen = E3Num_Min( maxLen, instanceData->logicalEOF - instanceData->currentStoragePosition );
+	maxLen = (TQ3Uns32) E3Num_Min( (uint64_t) maxLen, instanceData->logicalEOF - instanceData->currentStoragePosition );
 
 	if( (dataRead != nullptr) && (maxLen > 0) )
 		{
-		found = kQ3False;
+		// Build the stop table, a CR stop also stops at a LF for unix files
+		for (i = 0; i < numChars; i++)
+			{
+			isStop[ (TQ3Uns8) chars[i] ] = kQ3True;
+			if (chars[i] == 0x0D)
+				{
+				isStop[ 0x0A ] = kQ3True;
+				stopOnNewline  = kQ3True;
+				}
+			}
+
+		if (blanks)
+			{
+			for (i = 0; i <= 0x20; i++)
+				isStop[ i ] = kQ3True;
+			}
+
 		result = dataRead(instanceData->storage,
 						instanceData->currentStoragePosition,
 						maxLen, (TQ3Uns8*)buffer, &sizeRead); // read all the data at once
 			
-		while((result == kQ3Success)
-				&& (instanceData->currentStoragePosition < instanceData->logicalEOF) 
-				&& (index < sizeRead) 
-				 )
+		if (result == kQ3Success)
 			{
-			instanceData->currentStoragePosition ++;
-			
-			if ((blanks == kQ3True) && (((TQ3Uns8)buffer[index]) <= 0x20))
+			// Scan for the first stop character
+			while (index < sizeRead && !isStop[ (TQ3Uns8) buffer[index] ])
+				index++;
+
+			instanceData->currentStoragePosition += index;
+
+			if (index < sizeRead)
 				{
+				theChar = (TQ3Uns8) buffer[index];
+				instanceData->currentStoragePosition++;
+
 				if (foundChar)
-					*foundChar = ((TQ3Uns8)buffer[index]);
+					*foundChar = theChar;
+
+				// Skip the LF of a windows line ending
+				if ((blanks == kQ3False || theChar > 0x20) && stopOnNewline &&
+					(theChar == 0x0D || theChar == 0x0A) &&
+					(index + 1 < sizeRead) && (buffer[index + 1] == 0x0A))
+					instanceData->currentStoragePosition++;
+
 				buffer[index] = 0;
-				break;
-				}
-			
-			for(i = 0; i< numChars; i++)
-				if((chars[i] == buffer[index]) ||
-					((chars[i] == 0x0D) && (buffer[index] == 0x0A)))// unix file
-					{
-					if(foundChar)
-						*foundChar = buffer[index];
-					if((chars[i] == 0x0D) && (buffer[index+1] == 0x0A))// windows file
-						instanceData->currentStoragePosition ++;
-					buffer[index] = 0;
-					found = kQ3True;
-					break;
-					}
-			
-			if(found == kQ3True)
-				break;
-			else
-				{
-				index++;
 				}
-			
-			};
+			}
 		}
 
 	if(charsRead)
@@ -715,6 +758,45 @@ E3FileFormat_GenericWriteBinary_64(TQ3FileFormatObject format, const TQ3Int64 *d
 
 
 
+//=============================================================================
+//      E3FileFormat_GenericWriteBinaryArray_8 : Writes array of 8 bit values to stream.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FileFormat_GenericWriteBinaryArray_8(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int8* data)
+{
+	return E3FileFormat_GenericWriteBinary_Raw (format, (const unsigned char*)data, numNums);
+}
+
+
+
+
+
+//=============================================================================
+//      E3FileFormat_GenericWriteBinaryArray_16 : Writes array of 16 bit values to stream.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FileFormat_GenericWriteBinaryArray_16(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int16* data)
+{
+	return E3FileFormat_GenericWriteBinary_Raw (format, (const unsigned char*)data, numNums * 2);
+}
+
+
+
+
+
+//=============================================================================
+//      E3FileFormat_GenericWriteBinaryArray_32 : Writes array of 32 bit values to stream.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FileFormat_GenericWriteBinaryArray_32(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int32* data)
+{
+	return E3FileFormat_GenericWriteBinary_Raw (format, (const unsigned char*)data, numNums * 4);
+}
+
+
+
+
+
 //=============================================================================
 //      E3FileFormat_GenericWriteBinary_String : Writes a zero terminated padded
 //												string to a stream.
@@ -760,7 +842,7 @@ E3FileFormat_GenericWriteBinary_Raw(TQ3FileFormatObject format,const unsigned ch
 	TQ3Status result = kQ3Failure;
 	TQ3FFormatBaseData		*instanceData = (TQ3FFormatBaseData *) format->FindLeafInstanceData ();
 
-	TQ3XStorageWriteDataMethod dataWrite = (TQ3XStorageWriteDataMethod) instanceData->storage->GetMethod ( kQ3XMethodTypeStorageWriteData ) ;
+	TQ3XStorageWriteData64Method dataWrite = ( (E3Storage*) instanceData->storage )->GetWriteData64Method () ;
 
 	if( dataWrite != nullptr)
 		result = dataWrite(instanceData->storage,
@@ -832,6 +914,76 @@ E3FileFormat_GenericWriteBinSwap_64(TQ3FileFormatObject format, const TQ3Int64 *
 
 
 
+
+
+//=============================================================================
+//      E3FileFormat_GenericWriteBinSwapArray_16 : Writes array of 16 bit values to stream,
+//												 swapping the byte order.
+//-----------------------------------------------------------------------------
+//		Note :	The values are swapped a block at a time into a local buffer,
+//				so each block takes a single storage write.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FileFormat_GenericWriteBinSwapArray_16(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int16* data)
+{
+	TQ3Int16		swappedData[kE3FileFormatSwapBlockSize];
+	TQ3Uns32	n, blockSize;
+	TQ3Status	result = kQ3Success;
+	
+	while (numNums != 0 && result == kQ3Success)
+	{
+		blockSize = E3Num_Min( numNums, kE3FileFormatSwapBlockSize );
+		for (n = 0; n < blockSize; ++n)
+		{
+			swappedData[n] = E3EndianSwap16( data[n] );
+		}
+		
+		result = E3FileFormat_GenericWriteBinary_Raw (format, (const unsigned char*)swappedData, blockSize * 2);
+		
+		data    += blockSize;
+		numNums -= blockSize;
+	}
+	
+	return result;
+}
+
+
+
+
+
+//=============================================================================
+//      E3FileFormat_GenericWriteBinSwapArray_32 : Writes array of 32 bit values to stream,
+//												 swapping the byte order.
+//-----------------------------------------------------------------------------
+//		Note :	The values are swapped a block at a time into a local buffer,
+//				so each block takes a single storage write.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FileFormat_GenericWriteBinSwapArray_32(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int32* data)
+{
+	TQ3Int32		swappedData[kE3FileFormatSwapBlockSize];
+	TQ3Uns32	n, blockSize;
+	TQ3Status	result = kQ3Success;
+	
+	while (numNums != 0 && result == kQ3Success)
+	{
+		blockSize = E3Num_Min( numNums, kE3FileFormatSwapBlockSize );
+		for (n = 0; n < blockSize; ++n)
+		{
+			swappedData[n] = E3EndianSwap32( data[n] );
+		}
+		
+		result = E3FileFormat_GenericWriteBinary_Raw (format, (const unsigned char*)swappedData, blockSize * 4);
+		
+		data    += blockSize;
+		numNums -= blockSize;
+	}
+	
+	return result;
+}
+
+
+
 //=============================================================================
 //      E3FileFormat_GetType : Return the type of a fileFormat.
 //-----------------------------------------------------------------------------
@@ -1105,6 +1257,7 @@ E3FileFormat_Method_SubmitObject(TQ3ViewObject	theView,
 								 
 	{
 	TQ3FileFormatObject theFormat = E3View_AccessFileFormat ( theView ) ;
+	Q3_TRACE_SCOPE_TYPE ( "FileWrite", objectType ) ;
 
 
 
@@ -143,6 +143,9 @@ TQ3Status				E3FileFormat_GenericWriteBinary_8(TQ3FileFormatObject format, const
 TQ3Status				E3FileFormat_GenericWriteBinary_16(TQ3FileFormatObject format, const TQ3Int16 *data);
 TQ3Status				E3FileFormat_GenericWriteBinary_32(TQ3FileFormatObject format, const TQ3Int32 *data);
 TQ3Status				E3FileFormat_GenericWriteBinary_64(TQ3FileFormatObject format, const TQ3Int64 *data);
+TQ3Status				E3FileFormat_GenericWriteBinaryArray_8(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int8 *data);
+TQ3Status				E3FileFormat_GenericWriteBinaryArray_16(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int16 *data);
+TQ3Status				E3FileFormat_GenericWriteBinaryArray_32(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int32 *data);
 TQ3Status				E3FileFormat_GenericWriteBinary_String(TQ3FileFormatObject format, 
 															const char* data, TQ3Uns32 *length);
 TQ3Status				E3FileFormat_GenericWriteBinary_Raw(TQ3FileFormatObject format, 
@@ -150,6 +153,8 @@ TQ3Status				E3FileFormat_GenericWriteBinary_Raw(TQ3FileFormatObject format,
 TQ3Status				E3FileFormat_GenericWriteBinSwap_16(TQ3FileFormatObject format, const TQ3Int16 *data);
 TQ3Status				E3FileFormat_GenericWriteBinSwap_32(TQ3FileFormatObject format, const TQ3Int32 *data);
 TQ3Status				E3FileFormat_GenericWriteBinSwap_64(TQ3FileFormatObject format, const TQ3Int64 *data);
+TQ3Status				E3FileFormat_GenericWriteBinSwapArray_16(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int16 *data);
+TQ3Status				E3FileFormat_GenericWriteBinSwapArray_32(TQ3FileFormatObject format, TQ3Uns32 numNums, const TQ3Int32 *data);
 
 //-----------------------------------------------------------------------------
 
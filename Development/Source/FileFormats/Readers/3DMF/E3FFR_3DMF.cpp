@@ -159,6 +159,32 @@ public :
 	
 
 
+class E3PackedAttributeArray : public OpaqueTQ3Object  // This is a leaf class so no other classes use this,
+								// so it can be here in the .c file rather than in
+								// the .h file, hence all the fields can be public
+								// as nobody should be including this file
+	{
+Q3_CLASS_ENUMS ( kQ3ObjectTypePackedAttributeArray, E3PackedAttributeArray, OpaqueTQ3Object )
+public :
+
+	// There is no extra data for this class
+	} ;
+	
+
+
+class E3PackedTriMesh : public OpaqueTQ3Object  // This is a leaf class so no other classes use this,
+								// so it can be here in the .c file rather than in
+								// the .h file, hence all the fields can be public
+								// as nobody should be including this file
+	{
+Q3_CLASS_ENUMS ( kQ3ObjectTypePackedTriMesh, E3PackedTriMesh, OpaqueTQ3Object )
+public :
+
+	// There is no extra data for this class
+	} ;
+	
+
+
 class E3TopCapSet : public OpaqueTQ3Object  // This is a leaf class so no other classes use this,
 								// so it can be here in the .c file rather than in
 								// the .h file, hence all the fields can be public
@@ -2187,6 +2213,243 @@ e3fformat_3dmf_attributearray_metahandler(TQ3XMethodType methodType)
 
 
 
+//=============================================================================
+//      e3fformat_3dmf_packedattributearray_read : reads a packed attribute array.
+//-----------------------------------------------------------------------------
+//		Note :	Like e3fformat_3dmf_attributearray_read, this fills in the
+//				TriMesh being read rather than creating an object. Normals
+//				are octahedral coded, UVs are quantised to 16 bits within
+//				their range.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3fformat_3dmf_packedattributearray_read ( TQ3FileObject inFile )
+{
+	E3File* theFile = (E3File*) inFile;
+	TQ3Int32 				attributeType;
+	TQ3Uns32				reserved, positionOfArray, positionInArray, i, numElems = 0;
+	TQ3TriMeshAttributeData *theAttribute = nullptr;
+	TQ3Param2D				*theUVs;
+	float					minU, minV, stepU, stepV;
+
+	TQ3FileFormatObject format = theFile->GetFileFormat () ;
+	TQ3TriMeshData* geomData = ( (TE3FFormat3DMF_Data*) format->FindLeafInstanceData () )->currentTriMesh;
+	
+	Q3_REQUIRE_OR_RESULT(geomData != nullptr, nullptr);
+	
+	
+	
+	// =========== read the header
+	Q3Int32_Read(&attributeType, theFile);
+	Q3Uns32_Read(&reserved, theFile);
+	Q3Uns32_Read(&positionOfArray, theFile);
+	Q3Uns32_Read(&positionInArray, theFile);
+	if (Q3Uns32_Read(&reserved, theFile) != kQ3Success)
+		return nullptr;
+	
+
+
+	// =========== choose Array Element
+	switch(positionOfArray){
+		case 0:					 //   triangleAttributeTypes
+			numElems = geomData->numTriangles;
+			Q3_REQUIRE_OR_RESULT(positionInArray < geomData->numTriangleAttributeTypes, nullptr);
+			theAttribute = &geomData->triangleAttributeTypes[positionInArray];
+			break;
+		case 1:					 //   edgeAttributeTypes
+			numElems = geomData->numEdges;
+			Q3_REQUIRE_OR_RESULT(positionInArray < geomData->numEdgeAttributeTypes, nullptr);
+			theAttribute = &geomData->edgeAttributeTypes[positionInArray];
+			break;
+		case 2:					 //   vertexAttributeTypes
+			numElems = geomData->numPoints;
+			Q3_REQUIRE_OR_RESULT(positionInArray < geomData->numVertexAttributeTypes, nullptr);
+			theAttribute = &geomData->vertexAttributeTypes[positionInArray];
+			break;
+		
+		default:
+			Q3_MESSAGE("Invalid positionOfArray");
+			return nullptr;
+		}
+	
+	Q3_REQUIRE_OR_RESULT(theAttribute->data == nullptr, nullptr);
+	
+	
+	
+	// ============ Read and unpack the attributes
+	std::vector<TQ3Uns16>	theCodes( numElems * 2 );
+
+	switch(attributeType){
+		case kQ3AttributeTypeNormal:			// TQ3Vector3D
+			theAttribute->data = Q3Memory_Allocate(sizeof(TQ3Vector3D) * numElems);
+			if(theAttribute->data == nullptr)
+				return nullptr;
+			if ((numElems != 0) &&
+				(Q3Uns16_ReadArray( numElems * 2, &theCodes[0], theFile ) == kQ3Failure))
+				{
+				Q3Memory_Free( &theAttribute->data );
+				return nullptr;
+				}
+			for (i = 0; i < numElems; i++)
+				{
+				TQ3Int16	theCode[2] = { (TQ3Int16) theCodes[i * 2], (TQ3Int16) theCodes[i * 2 + 1] };
+				E3FFormat_3DMF_OctahedralUnpack( theCode, ((TQ3Vector3D*) theAttribute->data)[i] );
+				}
+			break;
+
+		case kQ3AttributeTypeSurfaceUV: 		// TQ3Param2D
+		case kQ3AttributeTypeShadingUV:
+			Q3Float32_Read(&minU, theFile);
+			Q3Float32_Read(&minV, theFile);
+			Q3Float32_Read(&stepU, theFile);
+			if (Q3Float32_Read(&stepV, theFile) != kQ3Success)
+				return nullptr;
+			theAttribute->data = Q3Memory_Allocate(sizeof(TQ3Param2D) * numElems);
+			if(theAttribute->data == nullptr)
+				return nullptr;
+			if ((numElems != 0) &&
+				(Q3Uns16_ReadArray( numElems * 2, &theCodes[0], theFile ) == kQ3Failure))
+				{
+				Q3Memory_Free( &theAttribute->data );
+				return nullptr;
+				}
+			theUVs = (TQ3Param2D*) theAttribute->data;
+			for (i = 0; i < numElems; i++)
+				{
+				theUVs[i].u = minU + stepU * theCodes[i * 2];
+				theUVs[i].v = minV + stepV * theCodes[i * 2 + 1];
+				}
+			break;
+
+		default:
+			Q3_MESSAGE("Invalid packed attribute type");
+			return nullptr;
+		}
+
+	theAttribute->attributeType = attributeType;
+	
+	return nullptr; // never created
+}
+
+
+
+
+
+//=============================================================================
+//      e3fformat_3dmf_packedattributearray_write: Packed attribute array write method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3fformat_3dmf_packedattributearray_write(const TE3FFormat3DMF_AttributeArray_Data *data,
+				TQ3FileObject theFile)
+{
+	TQ3AttributeType		attType = data->attributeData->attributeType;
+	TQ3Uns32				i, numElems = data->arraySize;
+	std::vector<TQ3Uns16>	theCodes( numElems * 2 );
+	TQ3Int16				theCode[2];
+	
+	TQ3Status status = Q3Uns32_Write ( (TQ3Uns32) attType, theFile ) ;
+	
+	if ( status == kQ3Success )
+		status = Q3Uns32_Write ( 0, theFile ) ;
+	
+	if ( status == kQ3Success )
+		status = Q3Uns32_Write( data->whichArray, theFile );
+	
+	if ( status == kQ3Success )
+		status = Q3Uns32_Write( data->whichAttr, theFile );
+	
+	if ( status == kQ3Success )
+		status = Q3Uns32_Write ( 0, theFile ) ;
+
+
+
+	// Pack the attributes
+	if (attType == kQ3AttributeTypeNormal)
+	{
+		const TQ3Vector3D*	theNormals = (const TQ3Vector3D*) data->attributeData->data;
+		
+		for (i = 0; i < numElems; ++i)
+		{
+			E3FFormat_3DMF_OctahedralPack( theNormals[i], theCode );
+			theCodes[i * 2]     = (TQ3Uns16) theCode[0];
+			theCodes[i * 2 + 1] = (TQ3Uns16) theCode[1];
+		}
+	}
+	else
+	{
+		const TQ3Param2D*	theUVs = (const TQ3Param2D*) data->attributeData->data;
+		TQ3Param2D			minUV = { 0.0f, 0.0f }, maxUV = { 0.0f, 0.0f }, stepUV;
+		
+		if (numElems != 0)
+			minUV = maxUV = theUVs[0];
+		
+		for (i = 1; i < numElems; ++i)
+		{
+			minUV.u = E3Num_Min( minUV.u, theUVs[i].u );
+			minUV.v = E3Num_Min( minUV.v, theUVs[i].v );
+			maxUV.u = E3Num_Max( maxUV.u, theUVs[i].u );
+			maxUV.v = E3Num_Max( maxUV.v, theUVs[i].v );
+		}
+		
+		stepUV.u = (maxUV.u - minUV.u) / 65535.0f;
+		stepUV.v = (maxUV.v - minUV.v) / 65535.0f;
+		
+		for (i = 0; i < numElems; ++i)
+		{
+			theCodes[i * 2]     = (TQ3Uns16) ((stepUV.u > 0.0f) ?
+				lroundf( E3Num_Clamp( (theUVs[i].u - minUV.u) / stepUV.u, 0.0f, 65535.0f ) ) : 0);
+			theCodes[i * 2 + 1] = (TQ3Uns16) ((stepUV.v > 0.0f) ?
+				lroundf( E3Num_Clamp( (theUVs[i].v - minUV.v) / stepUV.v, 0.0f, 65535.0f ) ) : 0);
+		}
+		
+		if ( status == kQ3Success )
+			status = Q3Float32_Write( minUV.u, theFile );
+		if ( status == kQ3Success )
+			status = Q3Float32_Write( minUV.v, theFile );
+		if ( status == kQ3Success )
+			status = Q3Float32_Write( stepUV.u, theFile );
+		if ( status == kQ3Success )
+			status = Q3Float32_Write( stepUV.v, theFile );
+	}
+	
+	if ( (status == kQ3Success) && (numElems != 0) )
+		status = Q3Uns16_WriteArray( numElems * 2, &theCodes[0], theFile );
+	
+	
+	return status;
+}
+
+
+
+
+
+//=============================================================================
+//      e3fformat_3dmf_packedattributearray_metahandler : packed attributearray metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3fformat_3dmf_packedattributearray_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+
+		case kQ3XMethodTypeObjectRead:
+			theMethod = (TQ3XFunctionPointer) e3fformat_3dmf_packedattributearray_read;
+			break;
+
+		case kQ3XMethodTypeObjectWrite:
+			theMethod = (TQ3XFunctionPointer) e3fformat_3dmf_packedattributearray_write;
+			break;
+		}
+	
+	return(theMethod);
+}
+
+
+
+
+
 //=============================================================================
 //      e3fformat_3dmf_cameraplacement_read : Camera placement read object method.
 //-----------------------------------------------------------------------------
@@ -2663,6 +2926,16 @@ E3FFormat_3DMF_Reader_RegisterClass(void)
 											e3fformat_3dmf_attributearray_metahandler,
 											E3AttributeArray ) ;
 
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = Q3_REGISTER_CLASS_NO_DATA	(	kQ3ClassNamePackedAttributeArray,
+											e3fformat_3dmf_packedattributearray_metahandler,
+											E3PackedAttributeArray ) ;
+
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = Q3_REGISTER_CLASS_NO_DATA	(	kQ3ClassNamePackedTriMesh,
+											nullptr,
+											E3PackedTriMesh ) ;
+
 	if (qd3dStatus == kQ3Success)
 		qd3dStatus = Q3_REGISTER_CLASS	(	kQ3ClassNameTopCapAttributeSet,
 											nullptr,
@@ -2864,6 +3137,7 @@ E3FFormat_3DMF_Reader_RegisterClass(void)
 	E3ClassTree::AddMethod(kQ3GeometryTypeTorus,			kQ3XMethodTypeObjectRead, (TQ3XFunctionPointer) E3Read_3DMF_Geom_Torus);
 	E3ClassTree::AddMethod(kQ3GeometryTypeTriGrid,			kQ3XMethodTypeObjectRead, (TQ3XFunctionPointer) E3Read_3DMF_Geom_TriGrid);
 	E3ClassTree::AddMethod(kQ3GeometryTypeTriMesh,			kQ3XMethodTypeObjectRead, (TQ3XFunctionPointer) E3Read_3DMF_Geom_TriMesh);
+	E3ClassTree::AddMethod(kQ3ObjectTypePackedTriMesh,		kQ3XMethodTypeObjectRead, (TQ3XFunctionPointer) E3Read_3DMF_Geom_PackedTriMesh);
 	E3ClassTree::AddMethod(kQ3GeometryTypeTriangle,		kQ3XMethodTypeObjectRead, (TQ3XFunctionPointer) E3Read_3DMF_Geom_Triangle);
 	
 
@@ -2982,6 +3256,8 @@ E3FFormat_3DMF_Reader_UnregisterClass(void)
 
 	E3ClassTree::UnregisterClass(kQ3SharedTypeEndGroup,					kQ3True);
 	E3ClassTree::UnregisterClass(kQ3ObjectTypeAttributeArray,			kQ3True);
+	E3ClassTree::UnregisterClass(kQ3ObjectTypePackedAttributeArray,		kQ3True);
+	E3ClassTree::UnregisterClass(kQ3ObjectTypePackedTriMesh,			kQ3True);
 	E3ClassTree::UnregisterClass(kQ3ObjectTypeAttributeSetListVertex,	kQ3True);
 	E3ClassTree::UnregisterClass(kQ3ObjectTypeAttributeSetListFace,		kQ3True);
 	E3ClassTree::UnregisterClass(kQ3ObjectTypeAttributeSetListGeometry,	kQ3True);
@@ -3445,3 +3721,36 @@ E3FFormat_3DMF_ReadFlag(TQ3Uns32* flag, TQ3FileObject theFile, TQ3ObjectType hin
 	return (kQ3Failure);
 }
 
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_CheckObjectData : Check the object holds enough data.
+//-----------------------------------------------------------------------------
+//		Note :	Fixed-layout read methods call this once before reading their
+//				fields, rather than discovering a short object field by field
+//				and running on into the next object.
+//
+//				Only the binary reader knows the size of an object; the text
+//				reader leaves objectDataEnd at 0, and is always accepted.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FFormat_3DMF_CheckObjectData(TQ3FileObject theFile, TQ3Uns32 dataSize)
+{
+	TQ3FileFormatObject format = ( ( E3File*) theFile )->GetFileFormat () ;
+	TE3FFormat3DMF_Data* formatData = (TE3FFormat3DMF_Data*) format->FindLeafInstanceData () ;
+
+
+
+	// Check the data fits in what is left of the object
+	if (formatData->objectDataEnd != 0 &&
+		formatData->baseData.currentStoragePosition + dataSize > formatData->objectDataEnd)
+		{
+		E3ErrorManager_PostError(kQ3ErrorInvalidMetafileObject, kQ3False);
+		return(kQ3Failure);
+		}
+	
+	return(kQ3Success);
+}
+
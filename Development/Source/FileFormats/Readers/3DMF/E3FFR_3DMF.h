@@ -47,6 +47,7 @@
 //-----------------------------------------------------------------------------
 #include "E3IOFileFormat.h"
 #include <map>
+#include <vector>
 
 
 
@@ -87,6 +88,7 @@ typedef struct TE3FFormat3DMF_Data {
 	TQ3Boolean						noMoreObjectData;
 	TQ3Boolean						inContainer;
 	TQ3TriMeshData*					currentTriMesh;
+	uint64_t						objectDataEnd;		// 0 if the object's size is unknown
 } TE3FFormat3DMF_Data;
 
 // Stack data
@@ -102,15 +104,24 @@ typedef struct TQ33DMFWStackItem {
 } TQ33DMFWStackItem;
 
 typedef std::map< TQ3Object, TQ3Uns32 > TE3FFormatW3DMF_Map;
+typedef struct TE3FFormatW3DMF_Content {
+	TQ3Uns32						tocIndex;
+	std::vector<TQ3Uns8>			bytes;
+} TE3FFormatW3DMF_Content;
+
+typedef std::multimap< uint64_t, TE3FFormatW3DMF_Content > TE3FFormatW3DMF_ContentMap;
 
 typedef struct TE3FFormatW3DMF_Data {
 	TQ3FFormatBaseData				baseData;
 	TE3FFormat3DMF_TOC				*toc;
 	TE3FFormatW3DMF_Map				*index;
+	TE3FFormatW3DMF_ContentMap		*contentIndex;
 	TQ3FileMode						fileMode;
 	TQ3ObjectType					lastObjectType;
 	TQ3Object						lastObject;
 	TQ3Uns32						lastTocIndex;
+	TQ3Boolean						packGeometry;
+	TQ3Boolean						shareEqualObjects;
 	// objects stack
 	TQ3Uns32						stackCount;
 	TQ33DMFWStackItem				*stack;
@@ -174,6 +185,123 @@ typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XFFormat_3DMF_ReadFlagMethod)(TQ3Uns32*
 
 
 
+//=============================================================================
+//      Inline functions
+//-----------------------------------------------------------------------------
+// Convert between the hi/lo pairs 3DMF uses for file offsets and positions
+inline uint64_t
+E3FFormat_3DMF_Uns64ToOffset(const TQ3Uns64& theValue)
+{
+	return ((uint64_t) theValue.hi << 32) | theValue.lo;
+}
+
+inline TQ3Uns64
+E3FFormat_3DMF_OffsetToUns64(uint64_t theOffset)
+{
+	TQ3Uns64	theValue;
+
+	theValue.hi = (TQ3Uns32) (theOffset >> 32);
+	theValue.lo = (TQ3Uns32) (theOffset & 0xFFFFFFFF);
+	return theValue;
+}
+
+
+// Delta and variable length coding of packed TriMesh indices: the difference
+// from the previous index is zig-zag coded and then stored 7 bits per byte.
+inline void
+E3FFormat_3DMF_DeltaPack(TQ3Uns32 theValue, TQ3Uns32& ioPrevious, std::vector<TQ3Uns8>& ioBytes)
+{
+	TQ3Uns32	theDelta = theValue - ioPrevious;
+	TQ3Uns32	theCode  = (theDelta << 1) ^ (0U - (theDelta >> 31));
+
+	while (theCode >= 0x80)
+	{
+		ioBytes.push_back( (TQ3Uns8) (theCode | 0x80) );
+		theCode >>= 7;
+	}
+
+	ioBytes.push_back( (TQ3Uns8) theCode );
+	ioPrevious = theValue;
+}
+
+inline TQ3Boolean
+E3FFormat_3DMF_DeltaUnpack(const TQ3Uns8*& ioPos, const TQ3Uns8* inEnd, TQ3Uns32& ioPrevious)
+{
+	TQ3Uns32	theCode = 0, theShift = 0;
+	TQ3Uns8		theByte;
+
+	while (ioPos != inEnd && theShift < 35)
+	{
+		theByte  = *ioPos++;
+		theCode |= (TQ3Uns32) (theByte & 0x7F) << theShift;
+
+		if ((theByte & 0x80) == 0)
+		{
+			ioPrevious += (theCode >> 1) ^ (0U - (theCode & 1));
+			return kQ3True;
+		}
+
+		theShift += 7;
+	}
+
+	return kQ3False;
+}
+
+
+// Octahedral coding of packed TriMesh normals: the unit vector is projected
+// onto the octahedron |x| + |y| + |z| = 1, whose lower half is folded over
+// the upper half, and the resulting square is stored as two 16 bit values.
+inline void
+E3FFormat_3DMF_OctahedralPack(const TQ3Vector3D& theNormal, TQ3Int16 outCode[2])
+{
+	float	theSum = fabsf(theNormal.x) + fabsf(theNormal.y) + fabsf(theNormal.z);
+	float	u = 0.0f, v = 0.0f, foldU;
+
+	if (theSum > kQ3RealZero)
+	{
+		u = theNormal.x / theSum;
+		v = theNormal.y / theSum;
+
+		if (theNormal.z < 0.0f)
+		{
+			foldU = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+			v     = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+			u     = foldU;
+		}
+	}
+
+	u = (u < -1.0f) ? -1.0f : ((u > 1.0f) ? 1.0f : u);
+	v = (v < -1.0f) ? -1.0f : ((v > 1.0f) ? 1.0f : v);
+
+	outCode[0] = (TQ3Int16) lroundf(u * 32767.0f);
+	outCode[1] = (TQ3Int16) lroundf(v * 32767.0f);
+}
+
+inline void
+E3FFormat_3DMF_OctahedralUnpack(const TQ3Int16 inCode[2], TQ3Vector3D& outNormal)
+{
+	float	u = (float) inCode[0] / 32767.0f;
+	float	v = (float) inCode[1] / 32767.0f;
+	float	z = 1.0f - fabsf(u) - fabsf(v);
+	float	foldU, theLength;
+
+	if (z < 0.0f)
+	{
+		foldU = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+		v     = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+		u     = foldU;
+	}
+
+	theLength   = sqrtf(u * u + v * v + z * z);
+	outNormal.x = u / theLength;
+	outNormal.y = v / theLength;
+	outNormal.z = z / theLength;
+}
+
+
+
+
+
 //=============================================================================
 //      Function prototypes
 //-----------------------------------------------------------------------------
@@ -202,6 +330,7 @@ TQ3DisplayGroupState		E3FFormat_3DMF_DisplayGroupState_Get(TQ3Object theObject);
 TQ3AttributeSet				E3FFormat_3DMF_CapsAttributes_Get(TQ3Object theObject);
 
 TQ3Status               	E3FFormat_3DMF_ReadFlag(TQ3Uns32* flag,TQ3FileObject theFile, TQ3ObjectType hint);
+TQ3Status					E3FFormat_3DMF_CheckObjectData(TQ3FileObject theFile, TQ3Uns32 dataSize);
 
 
 
@@ -48,6 +48,7 @@
 #include "E3IO.h"
 #include "E3IOData.h"
 #include "E3FFR_3DMF_Geometry.h"
+#include "E3FFR_3DMF_Lazy.h"
 
 
 
@@ -195,7 +196,7 @@ e3read_3dmf_bin_readnextelement(TQ3AttributeSet parent, TQ3FileObject inFile )
 
 	TQ3XFFormatInt32ReadMethod int32Read = (TQ3XFFormatInt32ReadMethod) format->GetMethod ( kQ3XMethodTypeFFormatInt32Read ) ;
 
-	TQ3Uns32 elemLocation = fformatData->MFData.baseData.currentStoragePosition ;
+	uint64_t elemLocation = fformatData->MFData.baseData.currentStoragePosition ;
 	
 	TQ3Status status = int32Read ( format, &elemType ) ;
 	if(status == kQ3Success){
@@ -246,7 +247,10 @@ e3read_3dmf_bin_readnextelement(TQ3AttributeSet parent, TQ3FileObject inFile )
 				readDataMethod = (TQ3XObjectReadDataMethod) theClass->GetMethod ( kQ3XMethodTypeObjectReadData ) ;
 				if (readDataMethod != nullptr)
 					{
+					uint64_t previousDataEnd = fformatData->MFData.objectDataEnd;
+					fformatData->MFData.objectDataEnd = elemLocation + 8 + elemSize;
 					(void) readDataMethod(parent,theFile);
+					fformatData->MFData.objectDataEnd = previousDataEnd;
 					}
 				else
 					{
@@ -345,7 +349,7 @@ e3fformat_3dmf_bin_read_toc(TQ3FileFormatObject format)
 	TQ3Int32					tocType;
 	TQ3Int32					tocSize = 0;
 	TQ3Int32					tocSizeInFile;
-	TQ3Int64					nextToc;
+	TQ3Uns64					nextToc;
 	TQ3Int32					refSeed = 0;
 	TQ3Int32					typeSeed = 0;
 	TQ3Int32					tocEntryType = 0;
@@ -363,7 +367,7 @@ e3fformat_3dmf_bin_read_toc(TQ3FileFormatObject format)
 	tocSizeInFile = tocSize;
 	
 	if(status == kQ3Success)
-		status = int64Read(format, &nextToc);
+		status = int64Read(format, (TQ3Int64*)&nextToc);
 	
 	if(status == kQ3Success)
 		status = int32Read(format, &refSeed);
@@ -460,8 +464,8 @@ e3fformat_3dmf_bin_read_toc(TQ3FileFormatObject format)
 		}
 	
 	// continue with next TOC
-	if(nextToc.lo != 0UL){
-		instanceData->MFData.baseData.currentStoragePosition = nextToc.lo;
+	if(E3FFormat_3DMF_Uns64ToOffset(nextToc) != 0){
+		instanceData->MFData.baseData.currentStoragePosition = E3FFormat_3DMF_Uns64ToOffset(nextToc);
 		status = e3fformat_3dmf_bin_read_toc(format);
 		}
 		
@@ -485,6 +489,7 @@ e3fformat_3dmf_bin_read_header ( TQ3FileObject inFile )
 	TQ3Status						result;
 	TQ3Uns32 						head;
 	TQ3Uns64 						tocPosition;
+	uint64_t						lazyBudget = 0;
 
 	//initialize instanceData
 	instanceData->MFData.toc = nullptr;
@@ -492,10 +497,14 @@ e3fformat_3dmf_bin_read_header ( TQ3FileObject inFile )
 	instanceData->MFData.baseData.readInGroup = kQ3True;
 	instanceData->MFData.baseData.groupDeepCounter = 0;
 	instanceData->MFData.noMoreObjectData = kQ3False;
+	instanceData->MFData.objectDataEnd = 0;
 	instanceData->containerEnd = 0;
 	
 	instanceData->typesNum = 0;
 	instanceData->types = nullptr;
+	
+	instanceData->lazySource = nullptr;
+	instanceData->lazyContainerRoot = kQ3False;
 
 
 
@@ -525,9 +534,9 @@ e3fformat_3dmf_bin_read_header ( TQ3FileObject inFile )
 	if (result == kQ3Success)
 	{
 		result = (TQ3Status)(Q3Int64_Read((TQ3Int64*)&tocPosition, theFile) != kQ3Failure);
-		if((result == kQ3Success) && (tocPosition.lo != 0UL))
+		if((result == kQ3Success) && (E3FFormat_3DMF_Uns64ToOffset(tocPosition) != 0))
 		{
-			instanceData->MFData.baseData.currentStoragePosition = tocPosition.lo;
+			instanceData->MFData.baseData.currentStoragePosition = E3FFormat_3DMF_Uns64ToOffset(tocPosition);
 			result = (TQ3Status)(e3fformat_3dmf_bin_read_toc(format) != kQ3Failure);
 		}
 		
@@ -536,6 +545,14 @@ e3fformat_3dmf_bin_read_header ( TQ3FileObject inFile )
 		E3FFormat_3DMF_Bin_Check_MoreObjects(instanceData);
 	}
 	
+	
+	
+	// Geometries are read as proxies if the file has a lazy load budget
+	if (result == kQ3Success &&
+		Q3Object_GetProperty(inFile, kQ3FilePropertyLazyLoadBudget, sizeof(lazyBudget), nullptr, &lazyBudget) == kQ3Success &&
+		lazyBudget != 0)
+		instanceData->lazySource = E3FFormat_3DMF_LazySource_New(instanceData->MFData.baseData.storage, lazyBudget);
+	
 	return result;
 }
 
@@ -662,6 +679,52 @@ static void CopyElementsToShape( TQ3SetObject inSet, TQ3ShapeObject ioShape )
 
 
 
+//=============================================================================
+//      e3fformat_3dmf_bin_new_lazy : Create a lazy proxy without reading.
+//-----------------------------------------------------------------------------
+//		Note :	Only possible for geometries which store their bounds, others
+//				must be read and passed to e3fformat_3dmf_bin_make_lazy.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3fformat_3dmf_bin_new_lazy ( TQ3FileFormatObject format, TE3FFormat3DMF_Bin_Data* instanceData,
+								uint64_t objLocation, uint64_t objEnd, TQ3Boolean isContainerRoot )
+{
+	if ( instanceData->lazySource == nullptr || isContainerRoot )
+		return nullptr ;
+	
+	return E3FFormat_3DMF_Lazy_NewStoredProxy ( instanceData->lazySource, format,
+												objLocation, objEnd - objLocation ) ;
+}
+
+
+
+
+
+//=============================================================================
+//      e3fformat_3dmf_bin_make_lazy : Replace a geometry with a lazy proxy.
+//-----------------------------------------------------------------------------
+//		Note :	Only done for objects that were read by themselves, not for
+//				the root object of a container, since the proxy must re-read
+//				the container to get the root object's attributes back.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3fformat_3dmf_bin_make_lazy ( TE3FFormat3DMF_Bin_Data* instanceData, TQ3Object theObject,
+								uint64_t objLocation, uint64_t objEnd, TQ3Boolean isContainerRoot )
+{
+	if ( instanceData->lazySource == nullptr || isContainerRoot || theObject == nullptr )
+		return theObject ;
+	
+	if ( Q3Object_IsType ( theObject, kQ3ShapeTypeGeometry ) == kQ3False )
+		return theObject ;
+	
+	return E3FFormat_3DMF_Lazy_NewProxy ( instanceData->lazySource, instanceData, theObject,
+											objLocation, objEnd - objLocation ) ;
+}
+
+
+
+
+
 //=============================================================================
 //      e3fformat_3dmf_bin_readobject : Reads the next object from storage.
 //-----------------------------------------------------------------------------
@@ -671,7 +734,7 @@ e3fformat_3dmf_bin_readobject ( TQ3FileObject inFile )
 	E3File* theFile = (E3File*) inFile;
 	TQ3Object 				result = nullptr;
 	TQ3Object 				childObject = nullptr;
-	TQ3Uns32 				previousContainer;
+	uint64_t 				previousContainer;
 	TQ3XObjectReadMethod 	readMethod = nullptr;
 	TQ3XObjectReadDefaultMethod		readDefaultMethod = nullptr;
 	E3ClassInfoPtr			theClass = nullptr;
@@ -681,10 +744,13 @@ e3fformat_3dmf_bin_readobject ( TQ3FileObject inFile )
 	
 	TE3FFormat3DMF_Bin_Data* instanceData = e3read_3dmf_bin_getinstancedata ( format ) ;
 
+	TQ3Boolean isContainerRoot = instanceData->lazyContainerRoot ;
+	instanceData->lazyContainerRoot = kQ3False ;
+
 	
 	TQ3XFFormatInt32ReadMethod int32Read = (TQ3XFFormatInt32ReadMethod) format->GetMethod ( kQ3XMethodTypeFFormatInt32Read ) ;
 
-	TQ3Uns32 objLocation = instanceData->MFData.baseData.currentStoragePosition ;
+	uint64_t objLocation = instanceData->MFData.baseData.currentStoragePosition ;
 
 	TQ3ObjectType objectType ;
 	TQ3Status status = int32Read ( format, (TQ3Int32*) &objectType ) ;
@@ -709,7 +775,7 @@ e3fformat_3dmf_bin_readobject ( TQ3FileObject inFile )
 						else{
 							// still not read, read it
 							previousContainer = instanceData->MFData.baseData.currentStoragePosition;
-							instanceData->MFData.baseData.currentStoragePosition = instanceData->MFData.toc->tocEntries[i].objLocation.lo;
+							instanceData->MFData.baseData.currentStoragePosition = E3FFormat_3DMF_Uns64ToOffset(instanceData->MFData.toc->tocEntries[i].objLocation);
 							result = theFile->ReadObject();
 							instanceData->MFData.baseData.currentStoragePosition = previousContainer;
 							}
@@ -723,7 +789,7 @@ e3fformat_3dmf_bin_readobject ( TQ3FileObject inFile )
 		else{ // objectType != 0x7266726E /*rfrn - Reference*/
 			if(status == kQ3Success) for(i = 0; i < instanceData->MFData.toc->nEntries; i++)
 				{
-					if(instanceData->MFData.toc->tocEntries[i].objLocation.lo == objLocation){
+					if(E3FFormat_3DMF_Uns64ToOffset(instanceData->MFData.toc->tocEntries[i].objLocation) == objLocation){
 						tocEntryIndex = i;
 						break;
 						}
@@ -758,8 +824,19 @@ e3fformat_3dmf_bin_readobject ( TQ3FileObject inFile )
 			instanceData->containerEnd = instanceData->MFData.baseData.currentStoragePosition + objectSize;
 			instanceData->MFData.inContainer = kQ3True;
 			
+			// a container whose root stores its bounds can be proxied without reading it
+			if (objectType == 0x636E7472)
+				result = e3fformat_3dmf_bin_new_lazy(format, instanceData, objLocation,
+														instanceData->containerEnd, isContainerRoot);
+			
 			// read the root object, is its responsibility read its childs
-			result = theFile->ReadObject();
+			if (result == nullptr)
+				{
+				instanceData->lazyContainerRoot = kQ3True;
+				result = theFile->ReadObject();
+				result = e3fformat_3dmf_bin_make_lazy(instanceData, result, objLocation,
+														instanceData->containerEnd, isContainerRoot);
+				}
 			
 			if(result != nullptr && tocEntryIndex >= 0){
 				// save in TOC
@@ -851,8 +928,16 @@ e3fformat_3dmf_bin_readobject ( TQ3FileObject inFile )
 					}
 				else
 					{
+					// Let fixed-layout read methods check the object's size
+					uint64_t previousDataEnd = instanceData->MFData.objectDataEnd;
+					instanceData->MFData.objectDataEnd = objLocation + objectSize + 8;
+					
+					// Geometries which store their bounds can be proxied without reading them
+					result = e3fformat_3dmf_bin_new_lazy(format, instanceData, objLocation,
+															objLocation + objectSize + 8, isContainerRoot);
+					
 					// If there is no data, first try a default read method
-					if (objectSize == 0)
+					if (result == nullptr && objectSize == 0)
 						{
 						readDefaultMethod = (TQ3XObjectReadDefaultMethod) theClass->GetMethod ( kQ3XMethodTypeObjectReadDefault ) ;
 						
@@ -863,7 +948,7 @@ e3fformat_3dmf_bin_readobject ( TQ3FileObject inFile )
 						}
 						
 					// If there was no read default method, use the plain read method
-					if (readDefaultMethod == nullptr)
+					if (result == nullptr && readDefaultMethod == nullptr)
 						{
 						readMethod = (TQ3XObjectReadMethod) theClass->GetMethod ( kQ3XMethodTypeObjectRead ) ;
 						
@@ -872,9 +957,14 @@ e3fformat_3dmf_bin_readobject ( TQ3FileObject inFile )
 							result = readMethod(theFile);
 							}
 						}
+					
+					instanceData->MFData.objectDataEnd = previousDataEnd;
 
-					if ( (readMethod != nullptr) || (readDefaultMethod != nullptr) )
+					if ( (result != nullptr) || (readMethod != nullptr) || (readDefaultMethod != nullptr) )
 						{
+						result = e3fformat_3dmf_bin_make_lazy(instanceData, result, objLocation,
+																objLocation + objectSize + 8, isContainerRoot);
+						
 						if (result != nullptr && tocEntryIndex >= 0)
 							{
 							// save in TOC
@@ -944,7 +1034,7 @@ e3fformat_3dmf_bin_get_nexttype ( TQ3FileObject inFile )
 	
 	TQ3XFFormatInt32ReadMethod int32Read = (TQ3XFFormatInt32ReadMethod) format->GetMethod ( kQ3XMethodTypeFFormatInt32Read ) ;
 
-	TQ3Uns32 previousPosition = instanceData->MFData.baseData.currentStoragePosition ;
+	uint64_t previousPosition = instanceData->MFData.baseData.currentStoragePosition ;
 	
 	TQ3ObjectType result ;
 	int32Read ( format, (TQ3Int32*) &result ) ;
@@ -964,7 +1054,7 @@ e3fformat_3dmf_bin_get_nexttype ( TQ3FileObject inFile )
 					result = instanceData->MFData.toc->tocEntries[i].objType;
 				else{ // We have to read the object to get the type
 					// position the file mark
-					instanceData->MFData.baseData.currentStoragePosition = instanceData->MFData.toc->tocEntries[i].objLocation.lo;
+					instanceData->MFData.baseData.currentStoragePosition = E3FFormat_3DMF_Uns64ToOffset(instanceData->MFData.toc->tocEntries[i].objLocation);
 					result = e3fformat_3dmf_bin_get_nexttype (theFile);
 					// cache the result
 					instanceData->MFData.toc->tocEntries[i].objType = result;
@@ -1037,6 +1127,11 @@ e3fformat_3dmf_bin_close(TQ3FileFormatObject format, TQ3Boolean abort)
 		Q3Memory_Free(&instanceData->types);
 		}
 	
+	if(instanceData->lazySource != nullptr){
+		E3FFormat_3DMF_LazySource_Release(instanceData->lazySource);
+		instanceData->lazySource = nullptr;
+		}
+	
 	return (status);
 
 }
@@ -1313,6 +1408,10 @@ E3FFormat_3DMF_Bin_Reader_RegisterClass(void)
 											e3fformat_3dmf_binswap_metahandler,
 											E3SwappedBinary3DMF ) ;
 
+	// the proxies for lazily loaded geometries
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = E3FFormat_3DMF_Lazy_RegisterClass();
+
 	return(qd3dStatus);
 }
 
@@ -1330,6 +1429,7 @@ E3FFormat_3DMF_Bin_Reader_UnregisterClass(void)
 
 
 	// Unregister the classes
+	E3FFormat_3DMF_Lazy_UnregisterClass();
 	E3ClassTree::UnregisterClass(kQ3FFormatReaderType3DMFBin,        kQ3True);
 	E3ClassTree::UnregisterClass(kQ3FFormatReaderType3DMFBinSwapped, kQ3True);
 
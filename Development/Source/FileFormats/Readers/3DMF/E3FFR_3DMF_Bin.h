@@ -71,11 +71,15 @@ typedef struct TE3FFormat3DMF_TypeEntry {
 	char							typeName[kQ3StringMaximumLength];
 } TE3FFormat3DMF_TypeEntry;
 
+typedef struct TE3FFormat3DMF_LazySource TE3FFormat3DMF_LazySource;
+
 typedef struct TE3FFormat3DMF_Bin_Data {
 	TE3FFormat3DMF_Data				MFData;
-	TQ3Uns32						containerEnd;
+	uint64_t						containerEnd;
 	TQ3Uns32						typesNum;
 	TE3FFormat3DMF_TypeEntry*		types;
+	TE3FFormat3DMF_LazySource*		lazySource;
+	TQ3Boolean						lazyContainerRoot;
 } TE3FFormat3DMF_Bin_Data;
 
 
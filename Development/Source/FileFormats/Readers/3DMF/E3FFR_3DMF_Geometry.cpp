@@ -65,8 +65,7 @@ static TQ3Status
 e3read_3dmf_addfloats(TQ3Object attributeSet, TQ3AttributeType theType,
 						 TQ3Uns32  numFloats,    TQ3FileObject    theFile)
 {	float		theFloats[6];
-	TQ3Status	qd3dStatus = kQ3Success;
-	TQ3Uns32	n;
+	TQ3Status	qd3dStatus;
 
 
 
@@ -75,8 +74,10 @@ e3read_3dmf_addfloats(TQ3Object attributeSet, TQ3AttributeType theType,
 
 
 	// Read the floats
-	for (n = 0; n < numFloats;  n++)
-		qd3dStatus = E3Float32_Read(&theFloats[n], (E3File*)theFile);
+	qd3dStatus = E3FFormat_3DMF_CheckObjectData(theFile, numFloats * sizeof(TQ3Float32));
+	
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = E3Float32_ReadArray(numFloats, theFloats, (E3File*)theFile);
 
 
 
@@ -304,6 +305,70 @@ e3read_3dmf_spreadarray_uns8to32( TQ3Uns32 numNums, void* ioData )
 
 
 
+//=============================================================================
+//      e3read_3dmf_trimesh_finish : Read the subobjects of a TriMesh and create it.
+//-----------------------------------------------------------------------------
+//		Note :	Shared by the TriMesh and packed TriMesh read methods, once
+//				they have read the TriMesh data itself.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3read_3dmf_trimesh_finish( TQ3TriMeshData& geomData, TQ3FileObject theFile )
+{
+	TQ3Object				childObject;
+	TQ3Object	 			theObject;
+	TQ3Object				elementSet = nullptr;
+	
+	
+	
+	// allocate the arrays
+	if(geomData.numTriangleAttributeTypes != 0){
+		geomData.triangleAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numTriangleAttributeTypes);
+		if(geomData.triangleAttributeTypes == nullptr)
+			return nullptr;
+		}
+	if(geomData.numEdgeAttributeTypes != 0){
+		geomData.edgeAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numEdgeAttributeTypes);
+		if(geomData.edgeAttributeTypes == nullptr)
+			return nullptr;
+		}
+	if(geomData.numVertexAttributeTypes != 0){
+		geomData.vertexAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numVertexAttributeTypes);
+		if(geomData.vertexAttributeTypes == nullptr)
+			return nullptr;
+		}
+
+	// Read in the attributes
+	while(Q3File_IsEndOfContainer(theFile,nullptr) == kQ3False){
+		childObject = Q3File_ReadObject(theFile);
+		// the kE3attributearray objects, are read but not created
+		// thir read method just fills the currentTriMesh data
+		if(childObject != nullptr){
+			if(Q3Object_IsType (childObject, kQ3SetTypeAttribute))
+				{
+				geomData.triMeshAttributeSet = childObject;
+				}
+			else if ( Q3Object_IsType (childObject, kQ3SharedTypeSet) )
+				e3read_3dmf_merge_element_set( &elementSet, childObject );
+			else
+				Q3Object_Dispose(childObject);
+			}
+		}
+
+
+
+	// Create the geometry
+	theObject = Q3TriMesh_New(&geomData);
+
+
+	
+	// Apply any custom elements
+	E3Read_3DMF_Shape_Apply_Element_Set( theObject, elementSet );
+	
+	return theObject;
+}
+
+
+
 //=============================================================================
 //      e3read_3dmf_group_subobjects : read the subobjects of a BeginGroup object.
 //-----------------------------------------------------------------------------
@@ -1664,6 +1729,9 @@ E3Read_3DMF_Transform_Matrix(TQ3FileObject theFile)
 {
 	TQ3Matrix4x4 theMatrix;
 	
+	if (E3FFormat_3DMF_CheckObjectData(theFile, sizeof(TQ3Matrix4x4)) != kQ3Success)
+		return nullptr;
+	
 	Q3Matrix4x4_Read(&theMatrix,theFile);
 	
 	TQ3SetObject elements = E3Read_3DMF_Shape_Elements( theFile );
@@ -1688,6 +1756,9 @@ E3Read_3DMF_Transform_Rotate(TQ3FileObject theFile)
 {
 	TQ3RotateTransformData data;
 	
+	if (E3FFormat_3DMF_CheckObjectData(theFile, sizeof(TQ3Int32) + sizeof(TQ3Float32)) != kQ3Success)
+		return nullptr;
+	
 	TQ3FileFormatObject format = ( (E3File*) theFile )->GetFileFormat () ;
 	
 	if (Q3Object_IsType( format, kQ3FFormatReaderType3DMFText ))
@@ -1749,6 +1820,9 @@ E3Read_3DMF_Transform_RotateAboutPoint(TQ3FileObject theFile)
 	TQ3RotateAboutPointTransformData data;
 	TQ3Int32 tempAxis;
 	
+	if (E3FFormat_3DMF_CheckObjectData(theFile, sizeof(TQ3Int32) + sizeof(TQ3Float32) + sizeof(TQ3Point3D)) != kQ3Success)
+		return nullptr;
+	
 	Q3Int32_Read(&tempAxis, theFile);
 	data.axis = (TQ3Axis)tempAxis;
 	Q3Float32_Read(&data.radians, theFile);
@@ -1775,6 +1849,9 @@ E3Read_3DMF_Transform_RotateAboutAxis(TQ3FileObject theFile)
 {
 	TQ3RotateAboutAxisTransformData data;
 	
+	if (E3FFormat_3DMF_CheckObjectData(theFile, sizeof(TQ3Point3D) + sizeof(TQ3Vector3D) + sizeof(TQ3Float32)) != kQ3Success)
+		return nullptr;
+	
 	Q3Point3D_Read(&data.origin, theFile);
 	Q3Vector3D_Read(&data.orientation, theFile);
 	Q3Float32_Read(&data.radians, theFile);
@@ -1800,6 +1877,9 @@ E3Read_3DMF_Transform_Scale(TQ3FileObject theFile)
 {
 	TQ3Vector3D scale;
 	
+	if (E3FFormat_3DMF_CheckObjectData(theFile, sizeof(TQ3Vector3D)) != kQ3Success)
+		return nullptr;
+	
 	Q3Vector3D_Read(&scale, theFile);	
 	
 	TQ3TransformObject theTransform = Q3ScaleTransform_New (&scale);
@@ -1822,6 +1902,9 @@ E3Read_3DMF_Transform_Translate(TQ3FileObject theFile)
 {
 	TQ3Vector3D translate;
 	
+	if (E3FFormat_3DMF_CheckObjectData(theFile, sizeof(TQ3Vector3D)) != kQ3Success)
+		return nullptr;
+	
 	Q3Vector3D_Read(&translate, theFile);	
 	
 	TQ3TransformObject theTransform = Q3TranslateTransform_New (&translate);
@@ -1844,6 +1927,9 @@ E3Read_3DMF_Transform_Quaternion(TQ3FileObject theFile)
 {
 	TQ3Quaternion quaternion;
 	
+	if (E3FFormat_3DMF_CheckObjectData(theFile, sizeof(TQ3Quaternion)) != kQ3Success)
+		return nullptr;
+	
 	Q3RationalPoint4D_Read((TQ3RationalPoint4D*)&quaternion, theFile);	
 	// I know that a quaternion is not the same than a Rationale point 4D
 	// but bytes are trasferred the same no matter they are called w or x
@@ -2809,6 +2895,9 @@ E3Read_3DMF_Geom_Line(TQ3FileObject theFile)
 
 
 	// Read in the points
+	if (E3FFormat_3DMF_CheckObjectData(theFile, 2 * sizeof(TQ3Point3D)) != kQ3Success)
+		return(nullptr);
+
 	if (Q3Point3D_Read(&geomData.vertices[0].point,theFile) != kQ3Success)
 		Q3Point3D_Set( &geomData.vertices[0].point, 0.0f, 0.0f, 0.0f);
 	
@@ -3447,6 +3536,9 @@ E3Read_3DMF_Geom_Point(TQ3FileObject theFile)
 
 
 	// Read in the point
+	if (E3FFormat_3DMF_CheckObjectData(theFile, sizeof(TQ3Point3D)) != kQ3Success)
+		return(nullptr);
+
 	Q3Point3D_Read(&geomData.point,theFile);
 
 
@@ -3951,13 +4043,11 @@ cleanup:
 //-----------------------------------------------------------------------------
 TQ3Object
 E3Read_3DMF_Geom_TriMesh(TQ3FileObject theFile)
-{	TQ3Object				childObject;
-	TQ3Object	 			theObject = nullptr;
+{	TQ3Object	 			theObject = nullptr;
 	TQ3TriMeshData			geomData;
 	TQ3Uns16				temp16;
 	TQ3Uns8					temp8;
 	TQ3Uns32				i;
-	TQ3Object				elementSet = nullptr;
 	TQ3StorageObject		theStorage = nullptr;
 	TQ3Uns32				storageSize;
 
@@ -4188,59 +4278,192 @@ E3Read_3DMF_Geom_TriMesh(TQ3FileObject theFile)
 	Q3Uns32_Read(&i, theFile);
 	geomData.bBox.isEmpty = (TQ3Boolean)i;
 	
-	//================ Read in the attributes
+	//================ Read in the attributes and create the geometry
+	theObject = e3read_3dmf_trimesh_finish( geomData, theFile );
+
+
+
+	// Clean up
+cleanUp:
+	Q3TriMesh_EmptyData(&geomData);	// this is illegal in QD3D since we have allocated
+									// the memory, but since we're using the Quesa memory
+									// allocators it's fine to use it here
+		
+	((TE3FFormat3DMF_Data*) format->FindLeafInstanceData () )->currentTriMesh = nullptr;
+	return theObject;
+}
+
+
+
+
+
+//=============================================================================
+//      E3Read_3DMF_Geom_PackedTriMesh : Packed TriMesh read method for 3DMF.
+//-----------------------------------------------------------------------------
+//		Note :	Reads the compact TriMesh form written when a file has the
+//				kQ3FilePropertyPackGeometry property, and creates an ordinary
+//				TriMesh from it.
+//-----------------------------------------------------------------------------
+TQ3Object
+E3Read_3DMF_Geom_PackedTriMesh(TQ3FileObject theFile)
+{	TQ3Object	 			theObject = nullptr;
+	TQ3TriMeshData			geomData;
+	TQ3Point3D				theOrigin;
+	TQ3Vector3D				theStep;
+	TQ3Uns32				i, n, numBytes, prevPoint, prevTriangle;
+	TQ3StorageObject		theStorage = nullptr;
+	TQ3Uns32				storageSize;
+	std::vector<TQ3Uns8>	theBytes;
+	std::vector<TQ3Uns16>	thePoints;
+	const TQ3Uns8			*bytePos, *byteEnd;
+
+
+	// Initialise the geometry data
+	Q3Memory_Clear(&geomData, sizeof(geomData));
+
+
+
+	// let know the system we're reading a trimesh
+	TQ3FileFormatObject format = ( (E3File*) theFile )->GetFileFormat () ;
+	((TE3FFormat3DMF_Data*) format->FindLeafInstanceData () )->currentTriMesh = &geomData;
 	
-	// allocate the arrays
-	if(geomData.numTriangleAttributeTypes != 0){
-		geomData.triangleAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numTriangleAttributeTypes);
-		if(geomData.triangleAttributeTypes == nullptr)
-			goto cleanUp;
+	
+	
+	// Find the size of the storage, so we can do a sanity check before allocating memory.
+	Q3File_GetStorage( theFile, &theStorage );
+	Q3Storage_GetSize( theStorage, &storageSize );
+	Q3Object_CleanDispose( &theStorage );
+
+
+
+	// Read in the counts and the quantisation
+	Q3Uns32_Read(&geomData.numTriangles, theFile);
+	Q3Uns32_Read(&geomData.numTriangleAttributeTypes, theFile);
+	Q3Uns32_Read(&geomData.numEdges, theFile);
+	Q3Uns32_Read(&geomData.numEdgeAttributeTypes, theFile);
+	Q3Uns32_Read(&geomData.numPoints, theFile);
+	Q3Uns32_Read(&geomData.numVertexAttributeTypes, theFile);
+	Q3Point3D_Read(&theOrigin, theFile);
+	Q3Vector3D_Read(&theStep, theFile);
+
+	if ((geomData.numPoints == 0) || (geomData.numTriangles == 0))
+		goto cleanUp;
+	
+	//================ read the triangles
+	Q3Uns32_Read(&numBytes, theFile);
+	if ((numBytes > storageSize) || (geomData.numTriangles > numBytes / 3))	// an index takes at least 1 byte
+		{
+		E3ErrorManager_PostError(kQ3ErrorInvalidMetafile, kQ3False);
+		goto cleanUp;
 		}
-	if(geomData.numEdgeAttributeTypes != 0){
-		geomData.edgeAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numEdgeAttributeTypes);
-		if(geomData.edgeAttributeTypes == nullptr)
-			goto cleanUp;
+	theBytes.resize( Q3Size_Pad( numBytes ) );
+	if (Q3Uns8_ReadArray( static_cast<TQ3Uns32>(theBytes.size()), &theBytes[0], theFile ) != kQ3Success)
+		goto cleanUp;
+	
+	geomData.triangles = (TQ3TriMeshTriangleData *)Q3Memory_Allocate(sizeof(TQ3TriMeshTriangleData)*geomData.numTriangles);
+	if(geomData.triangles == nullptr)
+		goto cleanUp;
+	
+	bytePos   = &theBytes[0];
+	byteEnd   = bytePos + numBytes;
+	prevPoint = 0;
+	for (i = 0; i < geomData.numTriangles; i++)
+		{
+		for (n = 0; n < 3; n++)
+			{
+			if (!E3FFormat_3DMF_DeltaUnpack( bytePos, byteEnd, prevPoint ) ||
+				(prevPoint >= geomData.numPoints))
+				{
+				E3ErrorManager_PostError(kQ3ErrorInvalidMetafile, kQ3False);
+				goto cleanUp;
+				}
+			geomData.triangles[i].pointIndices[n] = prevPoint;
+			}
 		}
-	if(geomData.numVertexAttributeTypes != 0){
-		geomData.vertexAttributeTypes = (TQ3TriMeshAttributeData *)Q3Memory_AllocateClear(sizeof(TQ3TriMeshAttributeData) * geomData.numVertexAttributeTypes);
-		if(geomData.vertexAttributeTypes == nullptr)
+		
+	//================ read the edges
+	Q3Uns32_Read(&numBytes, theFile);
+	if ((numBytes > storageSize) || (geomData.numEdges > numBytes / 4))	// an edge takes at least 4 bytes
+		{
+		E3ErrorManager_PostError(kQ3ErrorInvalidMetafile, kQ3False);
+		goto cleanUp;
+		}
+	if (numBytes != 0)
+		{
+		theBytes.resize( Q3Size_Pad( numBytes ) );
+		if (Q3Uns8_ReadArray( static_cast<TQ3Uns32>(theBytes.size()), &theBytes[0], theFile ) != kQ3Success)
 			goto cleanUp;
 		}
-
-	// Read in the attributes
-	while(Q3File_IsEndOfContainer(theFile,nullptr) == kQ3False){
-		childObject = Q3File_ReadObject(theFile);
-		// the kE3attributearray objects, are read but not created
-		// thir read method just fills the currentTriMesh data
-		if(childObject != nullptr){
-			if(Q3Object_IsType (childObject, kQ3SetTypeAttribute))
+	
+	if (geomData.numEdges > 0)
+		{
+		geomData.edges = (TQ3TriMeshEdgeData *)Q3Memory_Allocate(sizeof(TQ3TriMeshEdgeData)*geomData.numEdges);
+		if(geomData.edges == nullptr)
+			goto cleanUp;
+		
+		bytePos      = &theBytes[0];
+		byteEnd      = bytePos + numBytes;
+		prevPoint    = 0;
+		prevTriangle = 0;
+		for (i = 0; i < geomData.numEdges; i++)
+			{
+			for (n = 0; n < 2; n++)
 				{
-				geomData.triMeshAttributeSet = childObject;
+				if (!E3FFormat_3DMF_DeltaUnpack( bytePos, byteEnd, prevPoint ))
+					{
+					E3ErrorManager_PostError(kQ3ErrorInvalidMetafile, kQ3False);
+					goto cleanUp;
+					}
+				geomData.edges[i].pointIndices[n] = prevPoint;
+				}
+			
+			for (n = 0; n < 2; n++)
+				{
+				if (!E3FFormat_3DMF_DeltaUnpack( bytePos, byteEnd, prevTriangle ))
+					{
+					E3ErrorManager_PostError(kQ3ErrorInvalidMetafile, kQ3False);
+					goto cleanUp;
+					}
+				geomData.edges[i].triangleIndices[n] = prevTriangle;
 				}
-			else if ( Q3Object_IsType (childObject, kQ3SharedTypeSet) )
-				e3read_3dmf_merge_element_set( &elementSet, childObject );
-			else
-				Q3Object_Dispose(childObject);
 			}
 		}
+		
+	// ================ read the points
+	if (geomData.numPoints > storageSize / (3 * sizeof(TQ3Uns16)))
+		{
+		E3ErrorManager_PostError(kQ3ErrorInvalidMetafile, kQ3False);
+		goto cleanUp;
+		}
+	thePoints.resize( Q3Size_Pad( geomData.numPoints * 3 * sizeof(TQ3Uns16) ) / sizeof(TQ3Uns16) );
+	if (Q3Uns16_ReadArray( static_cast<TQ3Uns32>(thePoints.size()), &thePoints[0], theFile ) != kQ3Success)
+		goto cleanUp;
+	
+	geomData.points = (TQ3Point3D *)Q3Memory_Allocate(sizeof(TQ3Point3D)*geomData.numPoints);
+	if(geomData.points == nullptr)
+		goto cleanUp;
+	
+	for (i = 0; i < geomData.numPoints; i++)
+		{
+		geomData.points[i].x = theOrigin.x + theStep.x * thePoints[i * 3];
+		geomData.points[i].y = theOrigin.y + theStep.y * thePoints[i * 3 + 1];
+		geomData.points[i].z = theOrigin.z + theStep.z * thePoints[i * 3 + 2];
+		}
 
-
-
-	// Create the geometry
-	theObject = Q3TriMesh_New(&geomData);
-
-
+	// ================ read the bBox
+	Q3Point3D_Read(&geomData.bBox.min, theFile);
+	Q3Point3D_Read(&geomData.bBox.max, theFile);
+	Q3Uns32_Read(&i, theFile);
+	geomData.bBox.isEmpty = (TQ3Boolean)i;
 	
-	// Apply any custom elements
-	E3Read_3DMF_Shape_Apply_Element_Set( theObject, elementSet );
+	//================ Read in the attributes and create the geometry
+	theObject = e3read_3dmf_trimesh_finish( geomData, theFile );
 
 
 
 	// Clean up
 cleanUp:
-	Q3TriMesh_EmptyData(&geomData);	// this is illegal in QD3D since we have allocated
-									// the memory, but since we're using the Quesa memory
-									// allocators it's fine to use it here
+	Q3TriMesh_EmptyData(&geomData);
 		
 	((TE3FFormat3DMF_Data*) format->FindLeafInstanceData () )->currentTriMesh = nullptr;
 	return theObject;
@@ -4258,6 +4481,7 @@ E3Read_3DMF_Geom_Triangle(TQ3FileObject theFile)
 {	TQ3Object			childObject;
 	TQ3Object 			theObject;
 	TQ3TriangleData		geomData;
+	TQ3Point3D			thePoints[3];
 	TQ3Uns32			i;
 	TQ3SetObject			elementSet = nullptr;
 
@@ -4265,13 +4489,20 @@ E3Read_3DMF_Geom_Triangle(TQ3FileObject theFile)
 
 	// Initialise the geometry data
 	Q3Memory_Clear(&geomData, sizeof(geomData));
+	Q3Memory_Clear(thePoints,  sizeof(thePoints));
 
 
 
 	// Read in the points
-	Q3Point3D_Read(&geomData.vertices[0].point, theFile);
-	Q3Point3D_Read(&geomData.vertices[1].point, theFile);
-	Q3Point3D_Read(&geomData.vertices[2].point, theFile);
+	//
+	// The points are contiguous in the file but not in the vertices, so we
+	// read them as a single array of floats and then copy them into place.
+	if (E3FFormat_3DMF_CheckObjectData(theFile, sizeof(thePoints)) != kQ3Success ||
+		E3Float32_ReadArray(9, (TQ3Float32 *) thePoints, (E3File *) theFile) != kQ3Success)
+		return(nullptr);
+
+	for (i = 0; i < 3; i++)
+		geomData.vertices[i].point = thePoints[i];
 
 
 
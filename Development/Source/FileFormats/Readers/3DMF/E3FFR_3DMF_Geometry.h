@@ -147,6 +147,7 @@ TQ3Object		E3Read_3DMF_Geom_Polyhedron(TQ3FileObject theFile);
 TQ3Object		E3Read_3DMF_Geom_Torus(TQ3FileObject theFile);
 TQ3Object		E3Read_3DMF_Geom_TriGrid(TQ3FileObject theFile);
 TQ3Object		E3Read_3DMF_Geom_TriMesh(TQ3FileObject theFile);
+TQ3Object		E3Read_3DMF_Geom_PackedTriMesh(TQ3FileObject theFile);
 TQ3Object		E3Read_3DMF_Geom_Triangle(TQ3FileObject theFile);
 
 TQ3Object		E3Read_3DMF_Geom_Box_Default(TQ3FileObject theFile);
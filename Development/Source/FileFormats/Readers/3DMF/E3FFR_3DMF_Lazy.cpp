@@ -0,0 +1,958 @@
+/*  NAME:
+        E3FFR_3DMF_Lazy.cpp
+
+    DESCRIPTION:
+        Lazily loaded geometries for the binary 3DMF reader.
+
+        When a file is read with a lazy load budget, geometries are replaced
+        by proxies that record where the geometry was found and its bounds.
+        A proxy reads its geometry back from the storage when it is first
+        decomposed, and keeps it as its cached representation until enough
+        other proxies from the same file have been loaded to push it out of
+        the budget.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2021, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3Prefix.h"
+#include "E3FFR_3DMF_Lazy.h"
+#include "E3ClassTree.h"
+#include "E3Geometry.h"
+#include "E3GeometryTriMesh.h"
+#include "E3IO.h"
+#include "E3Style.h"
+#include "E3View.h"
+#include "CQ3ObjectRef.h"
+
+#include <vector>
+#include <new>
+#include <cstring>
+
+
+
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Geometries stored in fewer bytes than this are cheaper to keep than to proxy
+const uint64_t kE3LazyGeometryMinSize						= 1024;
+
+// Size of a stored bounding box: min, max, and isEmpty
+const uint64_t kE3LazyBoundsSize							= 28;
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+typedef struct TE3LazyGeometryData {
+	TE3FFormat3DMF_LazySource		*theSource;
+	uint64_t						objLocation;
+	uint64_t						objSize;
+	TQ3BoundingBox					theBounds;
+	TQ3Object						*cachedGeom;	// Non-nullptr while loaded
+	struct TE3LazyGeometryData		*moreRecent;
+	struct TE3LazyGeometryData		*lessRecent;
+} TE3LazyGeometryData;
+
+
+
+struct TE3FFormat3DMF_LazySource {
+	TQ3Uns32								refCount;
+	TQ3StorageObject						theStorage;
+	TQ3ViewObject							boundsView;
+	std::vector<TE3FFormat3DMF_TypeEntry>	theTypes;
+	uint64_t								theBudget;
+	uint64_t								loadedSize;
+	TE3LazyGeometryData						*mostRecent;
+	TE3LazyGeometryData						*leastRecent;
+};
+
+
+
+class E3LazyGeometry : public E3Geometry // This is a leaf class so no other classes use this,
+								// so it can be here in the .c file rather than in
+								// the .h file, hence all the fields can be public
+								// as nobody should be including this file
+	{
+Q3_CLASS_ENUMS ( kQ3ObjectTypeLazyGeometry, E3LazyGeometry, E3Geometry )
+public :
+
+	TE3LazyGeometryData			instanceData ;
+
+	} ;
+
+
+
+
+
+//=============================================================================
+//      Internal functions
+//-----------------------------------------------------------------------------
+//      e3ffr_3dmf_lazy_unlink : Remove a loaded geometry from its source.
+//-----------------------------------------------------------------------------
+//		Note :	The cached geometry itself is left alone, the caller must
+//				dispose of it or leave it to the geometry base class.
+//-----------------------------------------------------------------------------
+static void
+e3ffr_3dmf_lazy_unlink(TE3LazyGeometryData *proxyData)
+{	TE3FFormat3DMF_LazySource	*theSource = proxyData->theSource;
+
+
+
+	// Nothing to do if we're not loaded
+	if (proxyData->cachedGeom == nullptr)
+		return;
+
+
+
+	// Remove us from the list
+	if (proxyData->moreRecent != nullptr)
+		proxyData->moreRecent->lessRecent = proxyData->lessRecent;
+	else
+		theSource->mostRecent = proxyData->lessRecent;
+
+	if (proxyData->lessRecent != nullptr)
+		proxyData->lessRecent->moreRecent = proxyData->moreRecent;
+	else
+		theSource->leastRecent = proxyData->moreRecent;
+
+	theSource->loadedSize -= proxyData->objSize;
+
+	proxyData->cachedGeom = nullptr;
+	proxyData->moreRecent = nullptr;
+	proxyData->lessRecent = nullptr;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffr_3dmf_lazy_link : Add a loaded geometry to its source.
+//-----------------------------------------------------------------------------
+static void
+e3ffr_3dmf_lazy_link(TE3LazyGeometryData *proxyData, TQ3Object *cachedGeom)
+{	TE3FFormat3DMF_LazySource	*theSource = proxyData->theSource;
+
+
+
+	// Add us as the most recently used geometry
+	proxyData->cachedGeom = cachedGeom;
+	proxyData->moreRecent = nullptr;
+	proxyData->lessRecent = theSource->mostRecent;
+
+	if (theSource->mostRecent != nullptr)
+		theSource->mostRecent->moreRecent = proxyData;
+	else
+		theSource->leastRecent = proxyData;
+
+	theSource->mostRecent  = proxyData;
+	theSource->loadedSize += proxyData->objSize;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffr_3dmf_lazy_evict : Release geometries until we're within budget.
+//-----------------------------------------------------------------------------
+//		Note :	The most recently used geometry is never released, so that a
+//				geometry larger than the budget can still be drawn.
+//-----------------------------------------------------------------------------
+static void
+e3ffr_3dmf_lazy_evict(TE3FFormat3DMF_LazySource *theSource)
+{	TE3LazyGeometryData		*proxyData;
+	TQ3Object				*cachedGeom;
+
+
+
+	// Release the least recently used geometries
+	while (theSource->loadedSize > theSource->theBudget &&
+		   theSource->leastRecent != theSource->mostRecent)
+		{
+		proxyData  = theSource->leastRecent;
+		cachedGeom = proxyData->cachedGeom;
+
+		e3ffr_3dmf_lazy_unlink(proxyData);
+		Q3Object_CleanDispose(cachedGeom);
+		}
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffr_3dmf_lazy_read : Read a geometry back from the storage.
+//-----------------------------------------------------------------------------
+//		Note :	A file is opened on the storage for each read and closed
+//				again afterwards, so the storage is only held open while a
+//				geometry is actually being loaded.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3ffr_3dmf_lazy_read(TE3FFormat3DMF_LazySource *theSource, uint64_t objLocation)
+{	TE3FFormat3DMF_Bin_Data		*formatData;
+	TQ3FileFormatObject			theFormat;
+	TQ3Object					theObject = nullptr;
+	TQ3Uns32					numTypes;
+
+
+
+	// Open a file on our storage
+	CQ3ObjectRef	fileRef( Q3File_New() );
+	if (! fileRef.isvalid())
+		return(nullptr);
+
+	if (Q3File_SetStorage(fileRef.get(), theSource->theStorage) == kQ3Failure ||
+		Q3File_OpenRead(fileRef.get(), nullptr)                  == kQ3Failure)
+		{
+		E3ErrorManager_PostError(kQ3ErrorFileNotOpen, kQ3False);
+		return(nullptr);
+		}
+
+
+
+	// Make sure the storage still holds a binary 3DMF file
+	E3File *theFile = (E3File *) fileRef.get();
+	theFormat       = theFile->GetFileFormat();
+
+	if (theFormat != nullptr &&
+		(Q3Object_IsType(theFormat, kQ3FFormatReaderType3DMFBin)        == kQ3True ||
+		 Q3Object_IsType(theFormat, kQ3FFormatReaderType3DMFBinSwapped) == kQ3True))
+		{
+		formatData = (TE3FFormat3DMF_Bin_Data *) theFormat->FindLeafInstanceData();
+
+
+
+		// Pass on any custom types which were declared before the geometry,
+		// since our reader will not see their declarations
+		numTypes = (TQ3Uns32) theSource->theTypes.size();
+		if (formatData->typesNum < numTypes)
+			{
+			if (Q3Memory_Reallocate(&formatData->types, static_cast<TQ3Uns32>(numTypes * sizeof(TE3FFormat3DMF_TypeEntry))) == kQ3Success)
+				{
+				memcpy(formatData->types, &theSource->theTypes[0], numTypes * sizeof(TE3FFormat3DMF_TypeEntry));
+				formatData->typesNum = numTypes;
+				}
+			}
+
+
+
+		// Read the object as if it was at the top level of the file
+		formatData->MFData.baseData.currentStoragePosition = objLocation;
+		formatData->MFData.baseData.noMoreObjects          = kQ3False;
+		formatData->MFData.inContainer                     = kQ3False;
+		formatData->containerEnd                           = 0;
+
+		theObject = theFile->ReadObject();
+		}
+
+
+
+	// Close the file, which also releases its TOC's reference to the
+	// object if it was shared
+	Q3File_Close(fileRef.get());
+
+	return(theObject);
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffr_3dmf_lazy_read_bounds : Read the bounds stored with a geometry.
+//-----------------------------------------------------------------------------
+//		Note :	TriMeshes, packed or not, store their bounding box after their
+//				points. We find it from the counts at the start of the object
+//				and read only the box, so the geometry is not decoded.
+//
+//				For a container, the bounds of its root object are used.
+//				Other geometries store no bounds, and fail.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3ffr_3dmf_lazy_read_bounds(TQ3FileFormatObject theFormat, uint64_t objLocation, uint64_t objEnd, TQ3BoundingBox *theBounds)
+{	TE3FFormat3DMF_Bin_Data		*formatData = (TE3FFormat3DMF_Bin_Data *) theFormat->FindLeafInstanceData();
+	uint64_t					*thePosition = &formatData->MFData.baseData.currentStoragePosition;
+	uint64_t					savedPosition = *thePosition;
+	uint64_t					dataEnd, boundsPos = 0;
+	TQ3Uns32					theCounts[6] = { 0 }, numBytes, pointSize, triangleSize, n;
+	TQ3Int32					objType = 0, isEmpty;
+	TQ3Size						objSize = 0;
+	TQ3Status					qd3dStatus;
+
+
+
+	// Get our methods
+	TQ3XFFormatInt32ReadMethod   int32Read   = (TQ3XFFormatInt32ReadMethod)   theFormat->GetMethod(kQ3XMethodTypeFFormatInt32Read);
+	TQ3XFFormatFloat32ReadMethod float32Read = (TQ3XFFormatFloat32ReadMethod) theFormat->GetMethod(kQ3XMethodTypeFFormatFloat32Read);
+
+	if (int32Read == nullptr || float32Read == nullptr)
+		return(kQ3Failure);
+
+
+
+	// Read the object header, stepping into a container to its root object
+	*thePosition = objLocation;
+	qd3dStatus   = int32Read(theFormat, &objType);
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = int32Read(theFormat, (TQ3Int32 *) &objSize);
+
+	if (qd3dStatus == kQ3Success && objType == 0x636E7472 /* cntr - Container */)
+		{
+		qd3dStatus = int32Read(theFormat, &objType);
+		if (qd3dStatus == kQ3Success)
+			qd3dStatus = int32Read(theFormat, (TQ3Int32 *) &objSize);
+		}
+
+	dataEnd = *thePosition + objSize;
+
+	if (qd3dStatus == kQ3Success && dataEnd > objEnd)
+		qd3dStatus = kQ3Failure;
+
+
+
+	// Read the counts, and find where the bounds are
+	if (qd3dStatus == kQ3Success &&
+		(objType == kQ3GeometryTypeTriMesh || objType == kQ3ObjectTypePackedTriMesh))
+		{
+		for (n = 0; n < 6 && qd3dStatus == kQ3Success; n++)
+			qd3dStatus = int32Read(theFormat, (TQ3Int32 *) &theCounts[n]);
+
+		const TQ3Uns32 numTriangles = theCounts[0];
+		const TQ3Uns32 numEdges     = theCounts[2];
+		const TQ3Uns32 numPoints    = theCounts[4];
+
+		if (numTriangles == 0 || numPoints == 0)
+			qd3dStatus = kQ3Failure;
+
+		if (qd3dStatus == kQ3Success && objType == kQ3GeometryTypeTriMesh)
+			{
+			// Indices are as wide as the number of points or triangles needs
+			pointSize    = (numPoints    >= 0x00010000U) ? 4 : ((numPoints    >= 0x00000100U) ? 2 : 1);
+			triangleSize = (numTriangles >= 0x00010000U) ? 4 : ((numTriangles >= 0x00000100U) ? 2 : 1);
+
+			boundsPos = *thePosition
+					  + (uint64_t) numTriangles * 3 * pointSize
+					  + (uint64_t) numEdges * 2 * (pointSize + triangleSize)
+					  + (uint64_t) numPoints * sizeof(TQ3Point3D);
+			}
+		else if (qd3dStatus == kQ3Success)
+			{
+			// Skip the quantisation, then the padded triangle and edge bytes
+			*thePosition += sizeof(TQ3Point3D) + sizeof(TQ3Vector3D);
+
+			for (n = 0; n < 2 && qd3dStatus == kQ3Success; n++)
+				{
+				qd3dStatus = int32Read(theFormat, (TQ3Int32 *) &numBytes);
+				*thePosition += Q3Size_Pad(numBytes);
+				}
+
+			boundsPos = *thePosition + ((uint64_t) numPoints * 3 * sizeof(TQ3Uns16) + 3) / 4 * 4;
+			}
+		}
+	else
+		qd3dStatus = kQ3Failure;
+
+
+
+	// Read the bounds
+	if (qd3dStatus == kQ3Success && boundsPos + kE3LazyBoundsSize <= dataEnd)
+		{
+		*thePosition = boundsPos;
+
+		float *theFloats = &theBounds->min.x;
+		for (n = 0; n < 3 && qd3dStatus == kQ3Success; n++)
+			qd3dStatus = float32Read(theFormat, &theFloats[n]);
+
+		theFloats = &theBounds->max.x;
+		for (n = 0; n < 3 && qd3dStatus == kQ3Success; n++)
+			qd3dStatus = float32Read(theFormat, &theFloats[n]);
+
+		if (qd3dStatus == kQ3Success)
+			qd3dStatus = int32Read(theFormat, &isEmpty);
+
+		if (qd3dStatus == kQ3Success && isEmpty != kQ3False)
+			qd3dStatus = kQ3Failure;
+
+		theBounds->isEmpty = kQ3False;
+		}
+	else
+		qd3dStatus = kQ3Failure;
+
+	*thePosition = savedPosition;
+
+	return(qd3dStatus);
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffr_3dmf_lazy_calc_bounds : Calculate the bounds of a geometry.
+//-----------------------------------------------------------------------------
+//		Note :	Used for geometries which had to be read because their bounds
+//				are not stored in the file. A TriMesh only gets here if its
+//				stored box was empty, and will have found its own when it was
+//				created. Other geometries are bounded through a view, using
+//				approximate bounds so that geometries which know their extent
+//				don't have to visit every point.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3ffr_3dmf_lazy_calc_bounds(TE3FFormat3DMF_LazySource *theSource, TQ3Object theGeom, TQ3BoundingBox *theBounds)
+{	TQ3SubdivisionStyleData		subData = { kQ3SubdivisionMethodConstant, 20.0f, 20.0f };
+	TQ3TriMeshData				*triMeshData;
+	TQ3ViewStatus				viewStatus;
+
+
+
+	// Use the bounding box of a TriMesh
+	if (Q3Geometry_GetType(theGeom) == kQ3GeometryTypeTriMesh)
+		{
+		if (E3TriMesh_LockData(theGeom, kQ3True, &triMeshData) == kQ3Failure)
+			return(kQ3Failure);
+
+		*theBounds = triMeshData->bBox;
+		E3TriMesh_UnlockData(theGeom);
+
+		return(theBounds->isEmpty ? kQ3Failure : kQ3Success);
+		}
+
+
+
+	// Create our view if we need to
+	if (theSource->boundsView == nullptr)
+		{
+		theSource->boundsView = Q3View_New();
+		if (theSource->boundsView == nullptr)
+			return(kQ3Failure);
+		}
+
+
+
+	// Calculate the bounds
+	//
+	// We submit a subdivision style, since not every geometry implements
+	// the default screen space subdivision.
+	if (Q3View_StartBoundingBox(theSource->boundsView, kQ3ComputeBoundsApproximate) == kQ3Failure)
+		return(kQ3Failure);
+
+	do
+		{
+		E3SubdivisionStyle_Submit(&subData, theSource->boundsView);
+		Q3Object_Submit(theGeom, theSource->boundsView);
+		viewStatus = Q3View_EndBoundingBox(theSource->boundsView, theBounds);
+		}
+	while (viewStatus == kQ3ViewStatusRetraverse);
+
+	if (viewStatus != kQ3ViewStatusDone || theBounds->isEmpty)
+		return(kQ3Failure);
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_lazy_new : Lazy geometry new method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_lazy_new(TQ3Object theObject, void *privateData, const void *paramData)
+{	TE3LazyGeometryData			*instanceData = (TE3LazyGeometryData *)       privateData;
+	const TE3LazyGeometryData	*proxyData    = (const TE3LazyGeometryData *) paramData;
+#pragma unused(theObject)
+
+
+
+	// Initialise our instance data
+	instanceData->theSource   = proxyData->theSource;
+	instanceData->objLocation = proxyData->objLocation;
+	instanceData->objSize     = proxyData->objSize;
+	instanceData->theBounds   = proxyData->theBounds;
+	instanceData->cachedGeom  = nullptr;
+	instanceData->moreRecent  = nullptr;
+	instanceData->lessRecent  = nullptr;
+
+	instanceData->theSource->refCount++;
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_lazy_delete : Lazy geometry delete method.
+//-----------------------------------------------------------------------------
+static void
+e3geom_lazy_delete(TQ3Object theObject, void *privateData)
+{	TE3LazyGeometryData		*instanceData = (TE3LazyGeometryData *) privateData;
+#pragma unused(theObject)
+
+
+
+	// Dispose of our instance data
+	//
+	// Our cached geometry is disposed of by the geometry base class.
+	e3ffr_3dmf_lazy_unlink(instanceData);
+	E3FFormat_3DMF_LazySource_Release(instanceData->theSource);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_lazy_duplicate : Lazy geometry duplicate method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_lazy_duplicate(TQ3Object fromObject, const void *fromPrivateData,
+						 TQ3Object toObject,   void       *toPrivateData)
+{	const TE3LazyGeometryData	*fromInstanceData = (const TE3LazyGeometryData *) fromPrivateData;
+	TE3LazyGeometryData			*toInstanceData   = (TE3LazyGeometryData *)       toPrivateData;
+#pragma unused(fromObject)
+
+
+
+	// Initialise the duplicate, which starts out unloaded
+	return(e3geom_lazy_new(toObject, toInstanceData, fromInstanceData));
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_lazy_cache_isvalid : Lazy geometry cache is valid method.
+//-----------------------------------------------------------------------------
+//		Note :	Our geometry never changes, so the cache is valid for as long
+//				as it stays loaded.  Each use makes it the most recently used.
+//-----------------------------------------------------------------------------
+static TQ3Boolean
+e3geom_lazy_cache_isvalid(TQ3ViewObject theView,
+							TQ3ObjectType objectType, TQ3GeometryObject theGeom,
+							const void   *geomData,   TQ3Object         cachedGeom)
+{	TE3LazyGeometryData		*instanceData = &( (E3LazyGeometry*) theGeom )->instanceData;
+	TQ3Object				*cachedSlot;
+#pragma unused(theView)
+#pragma unused(objectType)
+#pragma unused(geomData)
+
+
+
+	// Check we're loaded
+	if (cachedGeom == nullptr || instanceData->cachedGeom == nullptr)
+		return(kQ3False);
+
+
+
+	// Move to the front of the list
+	cachedSlot = instanceData->cachedGeom;
+
+	e3ffr_3dmf_lazy_unlink(instanceData);
+	e3ffr_3dmf_lazy_link(instanceData, cachedSlot);
+
+	return(kQ3True);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_lazy_cache_update : Lazy geometry cache update method.
+//-----------------------------------------------------------------------------
+static void
+e3geom_lazy_cache_update(TQ3ViewObject theView,
+							TQ3ObjectType objectType, TQ3GeometryObject theGeom,
+							const void   *geomData,   TQ3Object         *cachedGeom)
+{	TE3LazyGeometryData		*instanceData = &( (E3LazyGeometry*) theGeom )->instanceData;
+#pragma unused(theView)
+#pragma unused(objectType)
+#pragma unused(geomData)
+
+
+
+	// Get rid of the existing cached object, if any
+	e3ffr_3dmf_lazy_unlink(instanceData);
+	Q3Object_CleanDispose(cachedGeom);
+
+
+
+	// Read the geometry, and release others if we're over budget
+	*cachedGeom = e3ffr_3dmf_lazy_read(instanceData->theSource, instanceData->objLocation);
+	if (*cachedGeom == nullptr)
+		return;
+
+	e3ffr_3dmf_lazy_link(instanceData, cachedGeom);
+	e3ffr_3dmf_lazy_evict(instanceData->theSource);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_lazy_cache_new : Lazy geometry cache new method.
+//-----------------------------------------------------------------------------
+//		Note :	Used when the caller wants a decomposed geometry of its own,
+//				so we read a fresh copy which is not counted against the
+//				budget.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3geom_lazy_cache_new(TQ3ViewObject theView, TQ3GeometryObject theGeom, const void *geomData)
+{	const TE3LazyGeometryData	*instanceData = (const TE3LazyGeometryData *) geomData;
+#pragma unused(theView)
+#pragma unused(theGeom)
+
+
+
+	// Read the geometry
+	return(e3ffr_3dmf_lazy_read(instanceData->theSource, instanceData->objLocation));
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_lazy_bounds : Lazy geometry bounds method.
+//-----------------------------------------------------------------------------
+//		Note :	We submit the corners of the bounds we found when the file was
+//				read, so bounding never has to load the geometry.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3geom_lazy_bounds(TQ3ViewObject theView, TQ3ObjectType objectType, TQ3Object theObject, const void *objectData)
+{	const TE3LazyGeometryData	*instanceData = (const TE3LazyGeometryData *) objectData;
+	const TQ3Point3D			*theMin = &instanceData->theBounds.min;
+	const TQ3Point3D			*theMax = &instanceData->theBounds.max;
+	TQ3Point3D					thePoints[8];
+	TQ3Uns32					n;
+#pragma unused(objectType)
+#pragma unused(theObject)
+
+
+
+	// Calculate the corners of the box, and update the bounds
+	for (n = 0; n < 8; n++)
+		{
+		thePoints[n].x = (n & 1) ? theMax->x : theMin->x;
+		thePoints[n].y = (n & 2) ? theMax->y : theMin->y;
+		thePoints[n].z = (n & 4) ? theMax->z : theMin->z;
+		}
+
+	E3View_UpdateBounds(theView, 8, sizeof(TQ3Point3D), thePoints);
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3geom_lazy_metahandler : Lazy geometry metahandler.
+//-----------------------------------------------------------------------------
+static TQ3XFunctionPointer
+e3geom_lazy_metahandler(TQ3XMethodType methodType)
+{	TQ3XFunctionPointer		theMethod = nullptr;
+
+
+
+	// Return our methods
+	switch (methodType) {
+		case kQ3XMethodTypeObjectNew:
+			theMethod = (TQ3XFunctionPointer) e3geom_lazy_new;
+			break;
+
+		case kQ3XMethodTypeObjectDelete:
+			theMethod = (TQ3XFunctionPointer) e3geom_lazy_delete;
+			break;
+
+		case kQ3XMethodTypeObjectDuplicate:
+			theMethod = (TQ3XFunctionPointer) e3geom_lazy_duplicate;
+			break;
+
+		case kQ3XMethodTypeGeomCacheIsValid:
+			theMethod = (TQ3XFunctionPointer) e3geom_lazy_cache_isvalid;
+			break;
+
+		case kQ3XMethodTypeGeomCacheUpdate:
+			theMethod = (TQ3XFunctionPointer) e3geom_lazy_cache_update;
+			break;
+
+		case kQ3XMethodTypeGeomCacheNew:
+			theMethod = (TQ3XFunctionPointer) e3geom_lazy_cache_new;
+			break;
+
+		case kQ3XMethodTypeObjectSubmitBounds:
+			theMethod = (TQ3XFunctionPointer) e3geom_lazy_bounds;
+			break;
+		}
+
+	return(theMethod);
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffr_3dmf_lazy_new_proxy : Create a proxy for a stored geometry.
+//-----------------------------------------------------------------------------
+static TQ3Object
+e3ffr_3dmf_lazy_new_proxy(TE3FFormat3DMF_LazySource		*theSource,
+							const TE3FFormat3DMF_Bin_Data	*readerData,
+							const TQ3BoundingBox			&theBounds,
+							uint64_t						objLocation,
+							uint64_t						objSize)
+{	TE3LazyGeometryData		proxyData;
+
+
+
+	// Remember the custom types declared so far
+	if (theSource->theTypes.size() < readerData->typesNum)
+		{
+		try
+			{
+			theSource->theTypes.assign(readerData->types, readerData->types + readerData->typesNum);
+			}
+		catch (std::bad_alloc&)
+			{
+			return(nullptr);
+			}
+		}
+
+
+
+	// Create the proxy
+	Q3Memory_Clear(&proxyData, sizeof(proxyData));
+
+	proxyData.theSource   = theSource;
+	proxyData.objLocation = objLocation;
+	proxyData.objSize     = objSize;
+	proxyData.theBounds   = theBounds;
+
+	return(E3ClassTree::CreateInstance(kQ3ObjectTypeLazyGeometry, kQ3False, &proxyData));
+}
+
+
+
+
+
+//=============================================================================
+//      Public functions
+//-----------------------------------------------------------------------------
+//      E3FFormat_3DMF_Lazy_RegisterClass : Register the classes.
+//-----------------------------------------------------------------------------
+#pragma mark -
+TQ3Status
+E3FFormat_3DMF_Lazy_RegisterClass(void)
+{
+
+
+	// Register the class
+	return Q3_REGISTER_CLASS	(	kQ3ClassNameLazyGeometry,
+									e3geom_lazy_metahandler,
+									E3LazyGeometry ) ;
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_Lazy_UnregisterClass : Unregister the classes.
+//-----------------------------------------------------------------------------
+TQ3Status
+E3FFormat_3DMF_Lazy_UnregisterClass(void)
+{
+
+
+	// Unregister the class
+	return(E3ClassTree::UnregisterClass(kQ3ObjectTypeLazyGeometry, kQ3True));
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_LazySource_New : Create a lazy load source.
+//-----------------------------------------------------------------------------
+//		Note :	The source is shared by every proxy read from one file, and
+//				by the reader while the file is open.
+//-----------------------------------------------------------------------------
+TE3FFormat3DMF_LazySource *
+E3FFormat_3DMF_LazySource_New(TQ3StorageObject theStorage, uint64_t theBudget)
+{	TE3FFormat3DMF_LazySource		*theSource;
+
+
+
+	// Create the source
+	theSource = new(std::nothrow) TE3FFormat3DMF_LazySource;
+	if (theSource == nullptr)
+		return(nullptr);
+
+	theSource->refCount    = 1;
+	theSource->theStorage  = Q3Shared_GetReference(theStorage);
+	theSource->boundsView  = nullptr;
+	theSource->theBudget   = theBudget;
+	theSource->loadedSize  = 0;
+	theSource->mostRecent  = nullptr;
+	theSource->leastRecent = nullptr;
+
+	return(theSource);
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_LazySource_Release : Release a lazy load source.
+//-----------------------------------------------------------------------------
+void
+E3FFormat_3DMF_LazySource_Release(TE3FFormat3DMF_LazySource *theSource)
+{
+
+
+	// Dispose of the source once it's no longer used
+	Q3_ASSERT(theSource->refCount != 0);
+	theSource->refCount--;
+
+	if (theSource->refCount != 0)
+		return;
+
+	Q3_ASSERT(theSource->mostRecent == nullptr);
+	Q3Object_CleanDispose(&theSource->boundsView);
+	Q3Object_CleanDispose(&theSource->theStorage);
+
+	delete theSource;
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_Lazy_NewStoredProxy : Create a proxy without reading.
+//-----------------------------------------------------------------------------
+//		Note :	Returns nullptr if the object at objLocation does not store
+//				its bounds, in which case it must be read and passed to
+//				E3FFormat_3DMF_Lazy_NewProxy instead.
+//-----------------------------------------------------------------------------
+TQ3Object
+E3FFormat_3DMF_Lazy_NewStoredProxy(TE3FFormat3DMF_LazySource	*theSource,
+									TQ3FileFormatObject			theFormat,
+									uint64_t					objLocation,
+									uint64_t					objSize)
+{	TQ3BoundingBox		theBounds;
+
+
+
+	// Small geometries are kept as they are
+	if (objSize < kE3LazyGeometryMinSize)
+		return(nullptr);
+
+
+
+	// Read the bounds, and create the proxy
+	if (e3ffr_3dmf_lazy_read_bounds(theFormat, objLocation, objLocation + objSize, &theBounds) != kQ3Success)
+		return(nullptr);
+
+	return(e3ffr_3dmf_lazy_new_proxy(theSource, (const TE3FFormat3DMF_Bin_Data *) theFormat->FindLeafInstanceData(),
+										theBounds, objLocation, objSize));
+}
+
+
+
+
+
+//=============================================================================
+//      E3FFormat_3DMF_Lazy_NewProxy : Replace a geometry with a proxy.
+//-----------------------------------------------------------------------------
+//		Note :	Takes over the reference to theGeom, and returns either a new
+//				proxy or theGeom itself if it is not worth proxying.
+//-----------------------------------------------------------------------------
+TQ3Object
+E3FFormat_3DMF_Lazy_NewProxy(TE3FFormat3DMF_LazySource		*theSource,
+								const TE3FFormat3DMF_Bin_Data	*readerData,
+								TQ3Object						theGeom,
+								uint64_t						objLocation,
+								uint64_t						objSize)
+{	TQ3BoundingBox			theBounds;
+	TQ3Object				theProxy;
+
+
+
+	// Small geometries are kept as they are, as are markers since their
+	// bounds depend on the camera they are viewed with
+	if (objSize < kE3LazyGeometryMinSize ||
+		Q3Object_IsType(theGeom, kQ3ObjectTypeLazyGeometry)   ||
+		Q3Object_IsType(theGeom, kQ3GeometryTypeMarker)       ||
+		Q3Object_IsType(theGeom, kQ3GeometryTypePixmapMarker))
+		return(theGeom);
+
+
+
+	// Find the bounds, which the proxy will use without loading the geometry
+	if (e3ffr_3dmf_lazy_calc_bounds(theSource, theGeom, &theBounds) != kQ3Success)
+		return(theGeom);
+
+
+
+	// Create the proxy
+	theProxy = e3ffr_3dmf_lazy_new_proxy(theSource, readerData, theBounds, objLocation, objSize);
+	if (theProxy == nullptr)
+		return(theGeom);
+
+	Q3Object_Dispose(theGeom);
+
+	return(theProxy);
+}
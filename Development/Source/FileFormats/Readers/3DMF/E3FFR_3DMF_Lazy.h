@@ -0,0 +1,97 @@
+/*  NAME:
+        E3FFR_3DMF_Lazy.h
+
+    DESCRIPTION:
+        Header file for E3FFR_3DMF_Lazy.cpp.
+
+    COPYRIGHT:
+        Copyright (c) 1999-2021, Quesa Developers. All rights reserved.
+
+        For the current release of Quesa, please see:
+
+            <https://github.com/jwwalker/Quesa>
+        
+        Redistribution and use in source and binary forms, with or without
+        modification, are permitted provided that the following conditions
+        are met:
+        
+            o Redistributions of source code must retain the above copyright
+              notice, this list of conditions and the following disclaimer.
+        
+            o Redistributions in binary form must reproduce the above
+              copyright notice, this list of conditions and the following
+              disclaimer in the documentation and/or other materials provided
+              with the distribution.
+        
+            o Neither the name of Quesa nor the names of its contributors
+              may be used to endorse or promote products derived from this
+              software without specific prior written permission.
+        
+        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+        TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+        PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+        LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+        NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+        SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+    ___________________________________________________________________________
+*/
+#ifndef E3FFR_3DMF_LAZY_HDR
+#define E3FFR_3DMF_LAZY_HDR
+//=============================================================================
+//      Include files
+//-----------------------------------------------------------------------------
+#include "E3FFR_3DMF_Bin.h"
+
+
+
+
+
+//=============================================================================
+//		C++ preamble
+//-----------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+
+//=============================================================================
+//      Function prototypes
+//-----------------------------------------------------------------------------
+TQ3Status					E3FFormat_3DMF_Lazy_RegisterClass(void);
+TQ3Status					E3FFormat_3DMF_Lazy_UnregisterClass(void);
+
+TE3FFormat3DMF_LazySource	*E3FFormat_3DMF_LazySource_New(TQ3StorageObject theStorage, uint64_t theBudget);
+void						E3FFormat_3DMF_LazySource_Release(TE3FFormat3DMF_LazySource *theSource);
+
+TQ3Object					E3FFormat_3DMF_Lazy_NewStoredProxy(TE3FFormat3DMF_LazySource	*theSource,
+														TQ3FileFormatObject			theFormat,
+														uint64_t					objLocation,
+														uint64_t					objSize);
+
+TQ3Object					E3FFormat_3DMF_Lazy_NewProxy(TE3FFormat3DMF_LazySource		*theSource,
+														const TE3FFormat3DMF_Bin_Data	*readerData,
+														TQ3Object						theGeom,
+														uint64_t						objLocation,
+														uint64_t						objSize);
+
+
+
+
+
+//=============================================================================
+//		C++ postamble
+//-----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -55,8 +55,10 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <string.h>
 
 #include "E3IO.h"
+#include "E3Storage.h"
 #include "E3FFR_3DMF_Text.h"
 #include "E3FFR_3DMF_Geometry.h"
 #include "CQ3ObjectRef.h"
@@ -87,17 +89,65 @@
 
 
 
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Size of the window of text we buffer from storage
+const TQ3Uns32 kE3Text3DMFWindowSize							= 64 * 1024;
+
+// Length to pass when skipping text of any length
+const TQ3Uns32 kE3Text3DMFNoLimit								= 0xFFFFFFFF;
+
+
+// Character classes
+enum
+{
+	kE3TextCharBlank		= (1 << 0),		// Control characters and space
+	kE3TextCharDelete		= (1 << 1),		// DEL
+	kE3TextCharOpen			= (1 << 2),		// (
+	kE3TextCharClose		= (1 << 3),		// )
+	kE3TextCharNewline		= (1 << 4),		// CR or LF
+	kE3TextCharDigit		= (1 << 5),		// 0-9
+	kE3TextCharSkip			= kE3TextCharBlank | kE3TextCharDelete
+};
+
+
+
+
+
 //=============================================================================
 //      Types
 //-----------------------------------------------------------------------------
 namespace
 {
-	typedef	std::map< std::string, TQ3Uns32 >	LabelToOffsetMap;
+	struct TE3TextCharClassTable
+	{
+		TE3TextCharClassTable()
+		{
+			memset( classes, 0, sizeof(classes) );
+			
+			for (TQ3Uns32 c = 0; c <= 0x20; ++c)
+				classes[ c ] |= kE3TextCharBlank;
+
+			for (TQ3Uns32 c = '0'; c <= '9'; ++c)
+				classes[ c ] |= kE3TextCharDigit;
+
+			classes[ 0x7F ] |= kE3TextCharDelete;
+			classes[ '(' ]  |= kE3TextCharOpen;
+			classes[ ')' ]  |= kE3TextCharClose;
+			classes[ 0x0D ] |= kE3TextCharNewline;
+			classes[ 0x0A ] |= kE3TextCharNewline;
+		}
+		
+		TQ3Uns8		classes[256];
+	};
+
+	typedef	std::map< std::string, uint64_t >	LabelToOffsetMap;
 
 	struct TOCEntry
 	{
 		TQ3Uns32						refID;
-		TQ3Uns32						objLocation;
+		uint64_t						objLocation;
 		CQ3ObjectRef					object;
 	};
 
@@ -110,6 +160,9 @@ namespace
 		TQ3Uns32						containerLevel;
 		LabelToOffsetMap*				mLabelMap;
 		TOCVec*							mTOC;
+		TQ3Uns8*						mWindow;			// Text buffered from storage
+		uint64_t						mWindowStart;		// Storage offset of mWindow[0]
+		TQ3Uns32						mWindowLength;		// Number of valid bytes in mWindow
 	};
 }
 
@@ -137,6 +190,16 @@ static const char 	ContainerLabel[]  = "Container";
 static const char 	BeginGroupLabel[] = "BeginGroup";
 static const char 	ReferenceLabel[] = "Reference";
 
+static const TE3TextCharClassTable	sCharClasses;
+
+
+// Powers of ten which are exactly representable as doubles
+static const double	sExactPowersOfTen[] =
+{
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
 
 
 
@@ -144,53 +207,399 @@ static const char 	ReferenceLabel[] = "Reference";
 //=============================================================================
 //      Internal functions
 //-----------------------------------------------------------------------------
+//      e3fformat_3dmf_text_window_fill : Make the window cover the current position.
+//-----------------------------------------------------------------------------
+//		Note :	Returns the number of buffered bytes available from the current
+//				storage position, or 0 at the end of the file.
+//
+//				The window is keyed by storage offset, so callers may move
+//				currentStoragePosition freely. Moving inside the window costs
+//				nothing, moving outside it slides the window to start at the
+//				new position.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3fformat_3dmf_text_window_fill( E3Text3DMFReader* format )
+{
+	TE3FFormat3DMF_Text_Data&	instanceData( format->instanceData );
+	TQ3FFormatBaseData&			baseData( instanceData.MFData.baseData );
+	uint64_t					thePosition = baseData.currentStoragePosition;
+	TQ3Uns32					sizeRead    = 0;
+
+
+
+	// Use the current window if it covers the position
+	if ( (thePosition >= instanceData.mWindowStart) &&
+		(thePosition - instanceData.mWindowStart < instanceData.mWindowLength) )
+		return (TQ3Uns32) (instanceData.mWindowStart + instanceData.mWindowLength - thePosition);
+
+
+
+	// Otherwise slide the window to the position
+	instanceData.mWindowStart  = thePosition;
+	instanceData.mWindowLength = 0;
+
+	if (thePosition >= baseData.logicalEOF || instanceData.mWindow == nullptr)
+		return 0;
+
+	TQ3XStorageReadData64Method dataRead = ( (E3Storage*) baseData.storage )->GetReadData64Method () ;
+	if (dataRead == nullptr)
+		return 0;
+
+	if (dataRead( baseData.storage, thePosition,
+				  (TQ3Uns32) E3Num_Min( (uint64_t) kE3Text3DMFWindowSize, baseData.logicalEOF - thePosition ),
+				  instanceData.mWindow, &sizeRead ) != kQ3Success)
+		sizeRead = 0;
+
+	instanceData.mWindowLength = sizeRead;
+
+	return sizeRead;
+}
+
+
+
+
+
+//=============================================================================
+//      e3fformat_3dmf_text_window_text : Get the text at the current position.
+//-----------------------------------------------------------------------------
+//		Note :	Only valid after e3fformat_3dmf_text_window_fill has returned
+//				a non-zero length.
+//-----------------------------------------------------------------------------
+static inline const TQ3Uns8*
+e3fformat_3dmf_text_window_text( const E3Text3DMFReader* format )
+{
+	return format->instanceData.mWindow +
+			(format->instanceData.MFData.baseData.currentStoragePosition - format->instanceData.mWindowStart);
+}
+
+
+
+
+
+//=============================================================================
+//      e3fformat_3dmf_text_peekchar : Get the next character, if any.
+//-----------------------------------------------------------------------------
+static inline bool
+e3fformat_3dmf_text_peekchar( E3Text3DMFReader* format, TQ3Uns8& outChar )
+{
+	if (e3fformat_3dmf_text_window_fill( format ) == 0)
+		return false;
+
+	outChar = *e3fformat_3dmf_text_window_text( format );
+	return true;
+}
+
+
+
+
+
+//=============================================================================
+//      e3fformat_3dmf_text_skipblanks : Skip blank characters.
+//-----------------------------------------------------------------------------
+//		Note :	Buffered equivalent of E3FileFormat_GenericReadText_SkipBlanks.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3fformat_3dmf_text_skipblanks( E3Text3DMFReader* format )
+{
+	TQ3Uns32		numBuffered, n;
+	const TQ3Uns8	*theText;
+
+
+
+	// Scan the window until we find a non-blank character
+	while ((numBuffered = e3fformat_3dmf_text_window_fill( format )) != 0)
+		{
+		theText = e3fformat_3dmf_text_window_text( format );
+
+		for (n = 0; n < numBuffered; n++)
+			{
+			if ((sCharClasses.classes[ theText[n] ] & kE3TextCharSkip) == 0)
+				break;
+			}
+
+		format->instanceData.MFData.baseData.currentStoragePosition += n;
+		if (n < numBuffered)
+			break;
+		}
+
+	return(kQ3Success);
+}
+
+
+
+
+
+//=============================================================================
+//      e3fformat_3dmf_text_readuntil : Read text up to a stop character.
+//-----------------------------------------------------------------------------
+//		Note :	Buffered equivalent of E3FileFormat_GenericReadText_ReadUntilChars,
+//				with the stop characters given as a mask of character classes.
+//
+//				As with the generic version a newline stop also consumes the
+//				LF of a CR-LF pair, the stop character is replaced by a NUL,
+//				and we fail if there is nothing left to read.
+//
+//				If buffer is nullptr, the text is skipped rather than copied.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3fformat_3dmf_text_readuntil( E3Text3DMFReader* format, char* buffer, TQ3Uns32 stopClasses,
+								TQ3Int32* foundChar, TQ3Uns32 maxLen, TQ3Uns32* charsRead )
+{
+	TQ3FFormatBaseData&		baseData( format->instanceData.MFData.baseData );
+	TQ3Uns32				index = 0;
+	TQ3Uns32				numBuffered, n, bufferLen;
+	const TQ3Uns8			*theText;
+	TQ3Uns8					theChar, nextChar;
+	TQ3Status				result = kQ3Success;
+	bool					isFound = false;
+
+
+
+	// Initialise ourselves
+	if (foundChar != nullptr)
+		*foundChar = -1;
+
+	bufferLen = maxLen;
+	maxLen    = (TQ3Uns32) E3Num_Min( (uint64_t) maxLen, baseData.logicalEOF - baseData.currentStoragePosition );
+	if (maxLen == 0)
+		result = kQ3Failure;
+
+
+
+	// Scan the window until we find a stop character or run out of room
+	while (result == kQ3Success && index < maxLen)
+		{
+		numBuffered = e3fformat_3dmf_text_window_fill( format );
+		if (numBuffered == 0)
+			{
+			result = kQ3Failure;
+			break;
+			}
+
+		numBuffered = E3Num_Min( numBuffered, maxLen - index );
+		theText     = e3fformat_3dmf_text_window_text( format );
+
+		for (n = 0; n < numBuffered; n++)
+			{
+			if ((sCharClasses.classes[ theText[n] ] & stopClasses) != 0)
+				break;
+			}
+
+		if (buffer != nullptr)
+			memcpy( buffer + index, theText, n );
+
+		index                         += n;
+		baseData.currentStoragePosition += n;
+
+		if (n < numBuffered)
+			{
+			theChar = theText[n];
+			baseData.currentStoragePosition++;
+			isFound = true;
+
+			if (foundChar != nullptr)
+				*foundChar = theChar;
+
+			if (((stopClasses & kE3TextCharBlank) == 0) &&
+				((sCharClasses.classes[ theChar ] & kE3TextCharNewline) != 0) &&
+				e3fformat_3dmf_text_peekchar( format, nextChar ) && (nextChar == 0x0A))
+				baseData.currentStoragePosition++;
+			break;
+			}
+		}
+
+
+
+	// Terminate the text
+	if (buffer != nullptr && (isFound || index < bufferLen))
+		buffer[index] = 0;
+
+	if (charsRead != nullptr)
+		*charsRead = index;
+
+	return(result);
+}
+
+
+
+
+
+//=============================================================================
+//      e3fformat_3dmf_text_parse_int : Parse a decimal integer.
+//-----------------------------------------------------------------------------
+//		Note :	Like atoi, we skip leading blanks, accept a sign, and stop at
+//				the first character which is not a digit.
+//-----------------------------------------------------------------------------
+static TQ3Int32
+e3fformat_3dmf_text_parse_int( const char* theText )
+{
+	const TQ3Uns8	*theChar = (const TQ3Uns8 *) theText;
+	TQ3Uns32		theValue = 0;
+	bool			isNegative = false;
+
+
+
+	// Parse the sign
+	while ((sCharClasses.classes[ *theChar ] & kE3TextCharBlank) != 0 && *theChar != 0)
+		theChar++;
+
+	if (*theChar == '-' || *theChar == '+')
+		isNegative = (*theChar++ == '-');
+
+
+
+	// Parse the digits
+	while ((sCharClasses.classes[ *theChar ] & kE3TextCharDigit) != 0)
+		theValue = (theValue * 10) + (TQ3Uns32) (*theChar++ - '0');
+
+	return((TQ3Int32) (isNegative ? (0 - theValue) : theValue));
+}
+
+
+
+
+
+//=============================================================================
+//      e3fformat_3dmf_text_parse_float : Parse a floating point number.
+//-----------------------------------------------------------------------------
+//		Note :	Numbers written by our exporters have at most a few significant
+//				digits and a small exponent, so we can assemble an integer
+//				mantissa and scale it by an exactly representable power of ten,
+//				which gives the same correctly rounded result as strtod.
+//
+//				Anything outside that range (long mantissas, large exponents,
+//				inf, nan, hex floats) falls back to strtod.
+//-----------------------------------------------------------------------------
+static double
+e3fformat_3dmf_text_parse_float( const char* theText )
+{
+	const TQ3Uns8	*theChar = (const TQ3Uns8 *) theText;
+	uint64_t		theMantissa = 0;
+	TQ3Int32		numDigits = 0, theExponent = 0, expValue = 0;
+	bool			isNegative = false, isExpNegative = false, hasDigits = false;
+	double			theValue;
+
+
+
+	// Parse the sign
+	while ((sCharClasses.classes[ *theChar ] & kE3TextCharBlank) != 0 && *theChar != 0)
+		theChar++;
+
+	if (*theChar == '-' || *theChar == '+')
+		isNegative = (*theChar++ == '-');
+
+
+
+	// Parse the mantissa, ignoring leading zeros
+	while (*theChar == '0')
+		{
+		hasDigits = true;
+		theChar++;
+		}
+
+	while ((sCharClasses.classes[ *theChar ] & kE3TextCharDigit) != 0)
+		{
+		theMantissa = (theMantissa * 10) + (TQ3Uns32) (*theChar++ - '0');
+		numDigits++;
+		hasDigits = true;
+		}
+
+	if (*theChar == '.')
+		{
+		theChar++;
+
+		if (theMantissa == 0)
+			{
+			while (*theChar == '0')
+				{
+				hasDigits = true;
+				theExponent--;
+				theChar++;
+				}
+			}
+
+		while ((sCharClasses.classes[ *theChar ] & kE3TextCharDigit) != 0)
+			{
+			theMantissa = (theMantissa * 10) + (TQ3Uns32) (*theChar++ - '0');
+			numDigits++;
+			theExponent--;
+			hasDigits = true;
+			}
+		}
+
+	if (!hasDigits || numDigits > 15)
+		return(strtod( theText, nullptr ));
+
+
+
+	// Parse the exponent
+	if (*theChar == 'e' || *theChar == 'E')
+		{
+		theChar++;
+		if (*theChar == '-' || *theChar == '+')
+			isExpNegative = (*theChar++ == '-');
+
+		if ((sCharClasses.classes[ *theChar ] & kE3TextCharDigit) == 0)
+			return(strtod( theText, nullptr ));
+
+		while ((sCharClasses.classes[ *theChar ] & kE3TextCharDigit) != 0 && expValue < 1000)
+			expValue = (expValue * 10) + (*theChar++ - '0');
+
+		theExponent += (isExpNegative ? -expValue : expValue);
+		}
+
+
+
+	// Scale the mantissa, if both parts are exact and we used the whole token
+	if (theExponent < -22 || theExponent > 22 || *theChar != 0)
+		return(strtod( theText, nullptr ));
+
+	theValue = (double) theMantissa;
+	if (theExponent < 0)
+		theValue /= sExactPowersOfTen[ -theExponent ];
+	else
+		theValue *= sExactPowersOfTen[ theExponent ];
+
+	return(isNegative ? -theValue : theValue);
+}
+
+
+
+
+
+//=============================================================================
 //      e3fformat_3dmf_text_skipcomments : Skip comments.
 //-----------------------------------------------------------------------------
 static TQ3Status
 e3fformat_3dmf_text_skipcomments ( E3Text3DMFReader* format )
 	{
-	char							buffer[256], separators[] = {0x0D, 0x0A};
 	TQ3Status						result   = kQ3Success;
 	TQ3Boolean						found    = kQ3True;
-	TQ3Uns32						sizeRead = 0;
-	TQ3XStorageReadDataMethod		dataRead;
-
-
-
-	// Get the read method
-	dataRead = (TQ3XStorageReadDataMethod) format->instanceData.MFData.baseData.storage->GetMethod (  kQ3XMethodTypeStorageReadData)  ;
-	if (dataRead == nullptr)
-		return(kQ3Failure);
+	TQ3Uns8							theChar;
 
 
 
 	// Skip comments
 	while (result == kQ3Success && found &&
-			format->instanceData.MFData.baseData.currentStoragePosition < format->instanceData.MFData.baseData.logicalEOF)
+			e3fformat_3dmf_text_peekchar( format, theChar ))
 		{
 		found  = kQ3False;
-		result = dataRead( format->instanceData.MFData.baseData.storage,
-			format->instanceData.MFData.baseData.currentStoragePosition, 1,
-			(TQ3Uns8*)buffer, &sizeRead);
 		
-		if (result == kQ3Success)
+		// If find a comment, skip until newline
+		if (theChar == '#')
 			{
-			// If find a comment, skip until newline
-			if (buffer[0] == '#')
-				{
-				found  = kQ3True;
-				result = E3FileFormat_GenericReadText_ReadUntilChars(format,
-					buffer, separators, 2, kQ3False, nullptr, 256, &sizeRead);
-				if(result == kQ3Success)
-					result = E3FileFormat_GenericReadText_SkipBlanks (format);
-				}
-			else if(buffer[0] == ')')
-				{
-				format->instanceData.nestingLevel--;
-				format->instanceData.MFData.baseData.currentStoragePosition++;
-				found  = kQ3True;
-				result = E3FileFormat_GenericReadText_SkipBlanks(format);
-				}
+			found  = kQ3True;
+			result = e3fformat_3dmf_text_readuntil(format,
+				nullptr, kE3TextCharNewline, nullptr, kE3Text3DMFNoLimit, nullptr);
+			if(result == kQ3Success)
+				result = e3fformat_3dmf_text_skipblanks (format);
+			}
+		else if(theChar == ')')
+			{
+			format->instanceData.nestingLevel--;
+			format->instanceData.MFData.baseData.currentStoragePosition++;
+			found  = kQ3True;
+			result = e3fformat_3dmf_text_skipblanks(format);
 			}
 		}
 		
@@ -210,13 +619,11 @@ static TQ3Status
 e3fformat_3dmf_text_readobjecttype( E3Text3DMFReader* format, char* theItem, TQ3Uns32 maxLen, TQ3Uns32* charsRead )
 {
 	TQ3Int32 lastSeparator = 0;
-	char separators[] = "(\x0D\x0A";
-	char buffer[256];
 
 	TQ3Status result;
 
 	// Advance to something that's not blank and not a comment.
-	result = E3FileFormat_GenericReadText_SkipBlanks(format);
+	result = e3fformat_3dmf_text_skipblanks(format);
 	if (result == kQ3Success)
 		result = e3fformat_3dmf_text_skipcomments(format);
 
@@ -224,8 +631,8 @@ e3fformat_3dmf_text_readobjecttype( E3Text3DMFReader* format, char* theItem, TQ3
 	// Read until we see a left parenthesis or end of line.
 	*charsRead = 0;
 	if (result == kQ3Success)
-		result = E3FileFormat_GenericReadText_ReadUntilChars( format, theItem,
-			separators, 3, kQ3False, &lastSeparator, maxLen, charsRead );
+		result = e3fformat_3dmf_text_readuntil( format, theItem,
+			kE3TextCharOpen | kE3TextCharNewline, &lastSeparator, maxLen, charsRead );
 
 	if ( (*charsRead > 0) &&
 		((lastSeparator == '\x0D') || (lastSeparator == '\x0A')) &&
@@ -245,8 +652,8 @@ e3fformat_3dmf_text_readobjecttype( E3Text3DMFReader* format, char* theItem, TQ3
 	
 		while ((result == kQ3Success) && (lastSeparator != '('))
 		{ // skip spaces before '('
-			result = E3FileFormat_GenericReadText_ReadUntilChars( format, buffer,
-				separators, 1, kQ3False, &lastSeparator, sizeof(buffer), nullptr);
+			result = e3fformat_3dmf_text_readuntil( format, nullptr,
+				kE3TextCharOpen, &lastSeparator, kE3Text3DMFNoLimit, nullptr);
 			if (lastSeparator == '(')
 				format->instanceData.nestingLevel++;
 		}
@@ -263,7 +670,7 @@ e3fformat_3dmf_text_readobjecttype( E3Text3DMFReader* format, char* theItem, TQ3
 		// back to our caller - we read _something_, so we return OK.
 		if (result == kQ3Success)
 		{
-			result = E3FileFormat_GenericReadText_SkipBlanks(format);
+			result = e3fformat_3dmf_text_skipblanks(format);
 			if (result == kQ3Success)
 				result = e3fformat_3dmf_text_skipcomments(format);
 
@@ -290,14 +697,14 @@ e3fformat_3dmf_text_readitem ( E3Text3DMFReader* format, char* theItem, TQ3Uns32
 {
 	TQ3Int32 lastSeparator = 0;
 	
-	TQ3Status result = E3FileFormat_GenericReadText_SkipBlanks (format);
+	TQ3Status result = e3fformat_3dmf_text_skipblanks (format);
 	if(result == kQ3Success)
-		result = E3FileFormat_GenericReadText_ReadUntilChars (format, theItem, "()", 2, kQ3True, &lastSeparator, maxLen, charsRead);
+		result = e3fformat_3dmf_text_readuntil (format, theItem, kE3TextCharOpen | kE3TextCharClose | kE3TextCharBlank, &lastSeparator, maxLen, charsRead);
 	
 	if(lastSeparator == ')'){
 		format->instanceData.nestingLevel--;
 		}
-	E3FileFormat_GenericReadText_SkipBlanks (format);
+	e3fformat_3dmf_text_skipblanks (format);
 
 	e3fformat_3dmf_text_skipcomments (format);
 
@@ -395,7 +802,8 @@ e3read_3dmf_text_readflag(TQ3Uns32* flag, TQ3FileObject inFile, TQ3ObjectType hi
 										{kQ3ObjectTypeGeometryCaps,"BOTTOM",2},
 										{kQ3ObjectTypeGeometryCaps,"INTERIOR",4} };
 
-	TQ3Uns32                    i, charsRead, dictValues, saveStoragePos;
+	TQ3Uns32                    i, charsRead, dictValues;
+	uint64_t                    saveStoragePos;
 	TQ3FFormatBaseData			*formatInstanceData;
 	char						buffer[256];
 	TQ3Status					result;
@@ -480,13 +888,19 @@ e3fformat_3dmf_textreader_new(TQ3Object theObject, void *privateData, const void
 	
 	instanceData->mTOC = new(std::nothrow) TOCVec;
 	
-	TQ3Status	theStatus = ((instanceData->mLabelMap != nullptr) && (instanceData->mTOC != nullptr))?
+	instanceData->mWindow = new(std::nothrow) TQ3Uns8[ kE3Text3DMFWindowSize ];
+	instanceData->mWindowStart = 0;
+	instanceData->mWindowLength = 0;
+	
+	TQ3Status	theStatus = ((instanceData->mLabelMap != nullptr) && (instanceData->mTOC != nullptr) &&
+		(instanceData->mWindow != nullptr))?
 		kQ3Success : kQ3Failure;
 		
 	if (theStatus == kQ3Failure)
 	{
 		delete instanceData->mLabelMap;
 		delete instanceData->mTOC;
+		delete [] instanceData->mWindow;
 	}
 	
 	return theStatus;
@@ -507,6 +921,7 @@ e3fformat_3dmf_textreader_delete(TQ3Object theObject, void *privateData)
 	
 	delete instanceData->mLabelMap;
 	delete instanceData->mTOC;
+	delete [] instanceData->mWindow;
 }
 
 
@@ -544,7 +959,7 @@ e3fformat_3dmf_text_read_int8( TQ3FileFormatObject inFormat, TQ3Int8* data)
 	result = e3fformat_3dmf_text_readitem (format, buffer, 256, &charsRead);
 	
 	if(result == kQ3Success)
-		*data = (TQ3Int8) atoi(buffer);
+		*data = (TQ3Int8) e3fformat_3dmf_text_parse_int(buffer);
 		
 	return (result);
 }
@@ -567,7 +982,7 @@ e3fformat_3dmf_text_read_int16 ( TQ3FileFormatObject inFormat, TQ3Int16* data )
 	result = e3fformat_3dmf_text_readitem (format, buffer, 256, &charsRead);
 	
 	if(result == kQ3Success)
-		*data = (TQ3Int16) atoi(buffer);
+		*data = (TQ3Int16) e3fformat_3dmf_text_parse_int(buffer);
 		
 	return (result);
 }
@@ -590,7 +1005,7 @@ e3fformat_3dmf_text_read_int32 ( TQ3FileFormatObject inFormat, TQ3Int32* data )
 	result = e3fformat_3dmf_text_readitem (format, buffer, 256, &charsRead);
 	
 	if(result == kQ3Success)
-		*data = atoi(buffer);
+		*data = e3fformat_3dmf_text_parse_int(buffer);
 		
 	return (result);
 }
@@ -614,7 +1029,7 @@ e3fformat_3dmf_text_read_int64 ( TQ3FileFormatObject inFormat, TQ3Int64* data )
 	
 	if(result == kQ3Success){
 		data->hi = 0;
-		data->lo = (TQ3Uns32) atoi(buffer);
+		data->lo = (TQ3Uns32) e3fformat_3dmf_text_parse_int(buffer);
 		}
 		
 	return (result);
@@ -638,7 +1053,7 @@ e3fformat_3dmf_text_read_float32 ( TQ3FileFormatObject inFormat, TQ3Float32* dat
 	result = e3fformat_3dmf_text_readitem (format, buffer, 256, &charsRead);
 	
 	if(result == kQ3Success){
-		*data = (TQ3Float32) atof(buffer);
+		*data = (TQ3Float32) e3fformat_3dmf_text_parse_float(buffer);
 		}
 		
 	return (result);
@@ -662,7 +1077,7 @@ e3fformat_3dmf_text_read_float64 ( TQ3FileFormatObject inFormat, TQ3Float64* dat
 	result = e3fformat_3dmf_text_readitem (format, buffer, 256, &charsRead);
 	
 	if(result == kQ3Success){
-		*data = atof(buffer);
+		*data = e3fformat_3dmf_text_parse_float(buffer);
 		}
 		
 	return (result);
@@ -819,15 +1234,13 @@ e3fformat_3dmf_text_skip_to_level ( E3File* theFile, TQ3Uns32 nesting )
 	TQ3Status 				result = kQ3Success;
 	TQ3Uns32 				charsRead;
 	TQ3Int32 lastSeparator;
-	char separators[] = "()";
-	char buffer[256];
 	
 	E3Text3DMFReader* format = (E3Text3DMFReader*) theFile->GetFileFormat () ;
 
 	
 	while((result == kQ3Success) && (format->instanceData.nestingLevel > nesting))
 	{
-		result = E3FileFormat_GenericReadText_ReadUntilChars (format, buffer, separators, 2, kQ3False, &lastSeparator, 256, &charsRead);
+		result = e3fformat_3dmf_text_readuntil (format, nullptr, kE3TextCharOpen | kE3TextCharClose, &lastSeparator, kE3Text3DMFNoLimit, &charsRead);
 		if((result == kQ3Success) && (lastSeparator == '('))
 			{
 			format->instanceData.nestingLevel++;
@@ -889,42 +1302,30 @@ e3fformat_3dmf_text_canread(TQ3StorageObject storage, TQ3ObjectType* theFileForm
 //      e3fformat_3dmf_text_readlabels : Scan for labels and offsets.
 //-----------------------------------------------------------------------------
 static void
-e3fformat_3dmf_text_readlabels( TQ3FileFormatObject format, TE3FFormat3DMF_Text_Data* instanceData )
+e3fformat_3dmf_text_readlabels( E3Text3DMFReader* format, TE3FFormat3DMF_Text_Data* instanceData )
 {
 	char		buffer[256];
 	TQ3Uns32	charsRead;
-	TQ3Uns32	labelStartOffset;
+	uint64_t	labelStartOffset;
 	TQ3Uns8		firstNonBlank;
 	TQ3Status	result;
-	TQ3XStorageReadDataMethod		dataRead;
 
 	
-	// Get the read method
-	dataRead = (TQ3XStorageReadDataMethod) instanceData->MFData.baseData.storage->GetMethod ( 
-		kQ3XMethodTypeStorageReadData ) ;
-	if (dataRead == nullptr)
-		return;
-
-	while ( (kQ3Success == E3FileFormat_GenericReadText_SkipBlanks( format )) &&
-		(instanceData->MFData.baseData.currentStoragePosition < instanceData->MFData.baseData.logicalEOF) )
+	while ( (kQ3Success == e3fformat_3dmf_text_skipblanks( format )) &&
+		e3fformat_3dmf_text_peekchar( format, firstNonBlank ) )
 	{
 		labelStartOffset = instanceData->MFData.baseData.currentStoragePosition;
 		
-		result = dataRead(instanceData->MFData.baseData.storage, instanceData->MFData.baseData.currentStoragePosition,
-			1, &firstNonBlank, &charsRead );
-		if (result != kQ3Success)
-			break;
-		
 		if (firstNonBlank == '#')
 		{
-			result = E3FileFormat_GenericReadText_ReadUntilChars( format, buffer, "\x0D\x0A", 2, kQ3False, nullptr,
-				sizeof(buffer), &charsRead );
+			result = e3fformat_3dmf_text_readuntil( format, nullptr, kE3TextCharNewline, nullptr,
+				kE3Text3DMFNoLimit, &charsRead );
 			if (result != kQ3Success)
 				break;
 		}
 		else
 		{
-			result = E3FileFormat_GenericReadText_ReadUntilChars( format, buffer, nullptr, 0, kQ3True, nullptr,
+			result = e3fformat_3dmf_text_readuntil( format, buffer, kE3TextCharBlank, nullptr,
 				sizeof(buffer), &charsRead );
 			if (result != kQ3Success)
 				break;
@@ -957,7 +1358,7 @@ e3fformat_3dmf_text_read_toc ( E3Text3DMFReader* format, TE3FFormat3DMF_Text_Dat
 		LabelToOffsetMap::const_iterator	labelIter = instanceData->mLabelMap->find( tocLabel );
 		if (labelIter != instanceData->mLabelMap->end())
 		{
-			TQ3Uns32	tocOffset = static_cast<TQ3Uns32>(labelIter->second + tocLabel.size() + 1);
+			uint64_t	tocOffset = labelIter->second + tocLabel.size() + 1;
 			instanceData->MFData.baseData.currentStoragePosition = tocOffset;
 			char	buffer[256];
 			TQ3Uns32	charsRead;
@@ -1037,7 +1438,7 @@ e3fformat_3dmf_text_read_header ( TQ3FileObject inFile )
 	E3File* theFile = (E3File*) inFile;
 	E3Text3DMFReader* format = (E3Text3DMFReader*) theFile->GetFileFormat () ;
 	bool						result;
-	TQ3Uns32 						oldPosition;
+	uint64_t 						oldPosition;
 	char							header[64];
 	TQ3Uns32 						charsRead;
 	TQ3Int16 						major = 0;
@@ -1050,6 +1451,8 @@ e3fformat_3dmf_text_read_header ( TQ3FileObject inFile )
 	format->instanceData.MFData.baseData.groupDeepCounter = 0;
 	format->instanceData.MFData.noMoreObjectData = kQ3True;
 	format->instanceData.containerLevel = 0xFFFFFFFF;
+	format->instanceData.mWindowStart = 0;
+	format->instanceData.mWindowLength = 0;
 
 
 	if(format->instanceData.MFData.baseData.logicalEOF <= 24)
@@ -1149,7 +1552,7 @@ e3fformat_3dmf_text_skipobject ( E3File* theFile )
 //      e3fformat_3dmf_textreader_update_toc : Add an object to TOC if appropriate.
 //-----------------------------------------------------------------------------
 static void
-e3fformat_3dmf_textreader_update_toc( TQ3Object object, TQ3Uns32 objectOffset, TE3FFormat3DMF_Text_Data* instanceData )
+e3fformat_3dmf_textreader_update_toc( TQ3Object object, uint64_t objectOffset, TE3FFormat3DMF_Text_Data* instanceData )
 {
 	if (Q3Object_IsType( object, kQ3ObjectTypeShared ))
 	{
@@ -1206,7 +1609,7 @@ e3fformat_3dmf_text_readobject ( TQ3FileObject inFile )
 	TQ3Status 				status;
 	TQ3Object 				result = nullptr;
 	TQ3Object 				childObject = nullptr;
-	TQ3Uns32 				objLocation;
+	uint64_t 				objLocation;
 	TQ3Uns32 				oldContainer;
 	TQ3XObjectReadMethod 			readMethod = nullptr;
 	TQ3XObjectReadDefaultMethod		readDefaultMethod = nullptr;
@@ -1366,7 +1769,7 @@ e3read_3dmf_text_readnextelement ( TQ3AttributeSet parent, TQ3FileObject inFile
 	E3File* theFile = (E3File*) inFile;
 	TQ3ObjectType 				elemType;
 	TQ3Status 					status;
-	TQ3Uns32 					elemLocation;
+	uint64_t 					elemLocation;
 	TQ3Uns32 					oldContainer;
 	TQ3Object 					result = nullptr;
 	char 						objectType[64];
@@ -1484,7 +1887,7 @@ e3fformat_3dmf_text_get_nexttype ( TQ3FileObject inFile )
 	E3File* theFile = (E3File*) inFile;
 	TQ3ObjectType 				result = kQ3ObjectTypeInvalid;
 	char 						objectType[64];
-	TQ3Uns32 					oldPosition;
+	uint64_t 					oldPosition;
 	TQ3Uns32 					oldNesting;
 	TQ3Uns32 					oldContainer;
 	TQ3Uns32 					charsRead;
@@ -1567,37 +1970,24 @@ e3fformat_3dmf_text_read_string(TQ3FileFormatObject format, char* data, TQ3Uns32
 	
 	e3fformat_3dmf_text_skipcomments( textFormat );
 	
-	// Get the storage read method
-	TQ3XStorageReadDataMethod dataRead = (TQ3XStorageReadDataMethod)
-		instanceData.MFData.baseData.storage->GetMethod ( kQ3XMethodTypeStorageReadData ) ;
-	if (dataRead == nullptr)
-	{
-		return status;
-	}
-	
 	// Save the storage position, in case we need to reset it
-	TQ3Uns32 startOffset = instanceData.MFData.baseData.currentStoragePosition;
+	uint64_t startOffset = instanceData.MFData.baseData.currentStoragePosition;
 	
-	// Read bytes one at a time.  The first one we read had better be \".
-	TQ3Uns32 sizeRead;
-	char oneChar;
-	status = dataRead( instanceData.MFData.baseData.storage, startOffset, 1,
-		(TQ3Uns8*)&oneChar, &sizeRead );
-	if ( (status == kQ3Success) && (oneChar != '\"') )
+	// Read bytes one at a time from the window.  The first one we read had better be \".
+	TQ3Uns8 oneChar;
+	if ( (! e3fformat_3dmf_text_peekchar( textFormat, oneChar )) || (oneChar != '\"') )
 	{
-		status = kQ3Failure;
 		return status;
 	}
 	instanceData.MFData.baseData.currentStoragePosition += 1;
 	while (true)
 	{
-		status = dataRead( instanceData.MFData.baseData.storage,
-			instanceData.MFData.baseData.currentStoragePosition, 1,
-			(TQ3Uns8*)&oneChar, &sizeRead );
-		if (status != kQ3Success)
+		if (! e3fformat_3dmf_text_peekchar( textFormat, oneChar ))
 		{
+			status = kQ3Failure;
 			break;	// end of file
 		}
+		status = kQ3Success;
 		instanceData.MFData.baseData.currentStoragePosition += 1;
 		if ( (!haveBackslash) && (oneChar == '\"') )
 		{
@@ -1646,7 +2036,7 @@ e3fformat_3dmf_text_read_string(TQ3FileFormatObject format, char* data, TQ3Uns32
 	}
 	else if (status == kQ3Success)
 	{
-		status = E3FileFormat_GenericReadText_SkipBlanks( textFormat );
+		status = e3fformat_3dmf_text_skipblanks( textFormat );
 		
 		if (status == kQ3Success)
 		{
@@ -1814,12 +2204,12 @@ TQ3Status	E3FFormat_3DMF_Text_ReadEnumeratedConstant( TQ3FileFormatObject format
 	
 	e3fformat_3dmf_text_skipcomments( textFormat );
 	
-	TQ3Status	status = E3FileFormat_GenericReadText_ReadUntilChars( format,
-		data, "", 0, kQ3True, nullptr, *ioLength, ioLength );
+	TQ3Status	status = e3fformat_3dmf_text_readuntil( textFormat,
+		data, kE3TextCharBlank, nullptr, *ioLength, ioLength );
 	
 	if (status == kQ3Success)
 	{
-		status = E3FileFormat_GenericReadText_SkipBlanks( textFormat );
+		status = e3fformat_3dmf_text_skipblanks( textFormat );
 		
 		if (status == kQ3Success)
 		{
@@ -46,11 +46,42 @@
 #include "E3Prefix.h"
 #include "E3FFW_3DMFBin_Geometry.h"
 #include "E3FFW_3DMFBin_Writer.h"
+#include "E3View.h"
 #include "E3Set.h"
 #include "E3CustomElements.h"
 
 
 
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Number of values packed into a local buffer for each array write
+const TQ3Uns32 kE3FFW3DMFPackSize								= 256;
+
+// Largest value of a quantised packed TriMesh point coordinate
+const float kE3FFW3DMFPackedPointMax							= 65535.0f;
+
+
+
+
+
+//=============================================================================
+//      Internal types
+//-----------------------------------------------------------------------------
+// Packed TriMesh, see kQ3FilePropertyPackGeometry
+typedef struct TE3FFW3DMFPackedTriMesh {
+	const TQ3TriMeshData*			triMesh;
+	TQ3Point3D						origin;
+	TQ3Vector3D						step;
+	std::vector<TQ3Uns8>			triangleBytes;
+	std::vector<TQ3Uns8>			edgeBytes;
+	std::vector<TQ3Uns16>			points;
+} TE3FFW3DMFPackedTriMesh;
+
+
+
+
+
 //=============================================================================
 //      Private functions
 //-----------------------------------------------------------------------------
@@ -2029,16 +2060,27 @@ static TQ3Status
 e3ffw_3DMF_mesh_write( const TQ3MeshData *meshData,
 				TQ3FileObject theFile )
 {
-	TQ3Uns32 			i, j, k, numContours = 0;
+	TQ3Uns32 			i, j, k, blockSize, numContours = 0;
+	TQ3Float32			packedPoints[kE3FFW3DMFPackSize];
+	const TQ3Point3D	*thePoint;
 	TQ3Status			writeStatus = kQ3Failure;
 	
 	// write the numVertices
 	writeStatus = Q3Uns32_Write(meshData->numVertices, theFile );
 	
-	// write the vertices
-	for(i = 0; i < meshData->numVertices && writeStatus == kQ3Success; i++)
+	// write the vertices, packing their points into blocks of floats
+	for(i = 0; i < meshData->numVertices && writeStatus == kQ3Success; i += blockSize)
 		{
-		writeStatus = Q3Point3D_Write(&meshData->vertices[i].point, theFile);
+		blockSize = E3Num_Min( meshData->numVertices - i, kE3FFW3DMFPackSize / 3 );
+		for(k = 0; k < blockSize; k++)
+			{
+			thePoint = &meshData->vertices[i + k].point;
+			packedPoints[k * 3 + 0] = thePoint->x;
+			packedPoints[k * 3 + 1] = thePoint->y;
+			packedPoints[k * 3 + 2] = thePoint->z;
+			}
+		
+		writeStatus = Q3Float32_WriteArray(blockSize * 3, packedPoints, theFile);
 		}
 	
 	// write the numFaces and numContours
@@ -2066,10 +2108,9 @@ e3ffw_3DMF_mesh_write( const TQ3MeshData *meshData,
 				else
 					writeStatus = Q3Int32_Write(-((TQ3Int32)meshData->faces[i].contours[j].numVertices), theFile );
 					
-				for(k = 0; k < meshData->faces[i].contours[j].numVertices && writeStatus == kQ3Success; k++)
-					{
-					writeStatus = Q3Uns32_Write(meshData->faces[i].contours[j].vertexIndices[k], theFile);
-					}
+				if(meshData->faces[i].contours[j].numVertices != 0 && writeStatus == kQ3Success)
+					writeStatus = Q3Uns32_WriteArray(meshData->faces[i].contours[j].numVertices,
+								meshData->faces[i].contours[j].vertexIndices, theFile);
 			}
 		}
 	
@@ -3028,6 +3069,102 @@ e3ffw_3DMF_write_comp_num( TQ3Uns32 toWrite, TQ3Uns32 numBytes,
 	return status;
 }
 
+
+
+
+
+//=============================================================================
+//      e3ffw_3DMF_write_comp_array : Helper for TriMesh array compression.
+//-----------------------------------------------------------------------------
+//		Note :	Writes an array of indices with e3ffw_3DMF_write_comp_num's
+//				encoding, but as a few array writes rather than one write
+//				per index.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3ffw_3DMF_write_comp_array( TQ3Uns32 numNums, const TQ3Uns32* toWrite,
+	TQ3Uns32 numBytes, TQ3FileObject file )
+{
+	TQ3Uns8		packed8[kE3FFW3DMFPackSize];
+	TQ3Uns16	packed16[kE3FFW3DMFPackSize];
+	TQ3Uns32	n, blockSize;
+	TQ3Status	status = kQ3Success;
+	
+	
+	
+	// Full size indices can be written as they are
+	if (numNums == 0)
+		return kQ3Success;
+	
+	if (numBytes != 1 && numBytes != 2)
+		return Q3Uns32_WriteArray( numNums, toWrite, file );
+	
+	
+	
+	// Otherwise pack them a block at a time
+	while (numNums != 0 && status == kQ3Success)
+	{
+		blockSize = E3Num_Min( numNums, kE3FFW3DMFPackSize );
+		
+		if (numBytes == 1)
+		{
+			for (n = 0; n < blockSize; ++n)
+				packed8[n] = (TQ3Uns8) toWrite[n];
+			
+			status = Q3Uns8_WriteArray( blockSize, packed8, file );
+		}
+		else
+		{
+			for (n = 0; n < blockSize; ++n)
+				packed16[n] = (TQ3Uns16) toWrite[n];
+			
+			status = Q3Uns16_WriteArray( blockSize, packed16, file );
+		}
+		
+		toWrite += blockSize;
+		numNums -= blockSize;
+	}
+	
+	return status;
+}
+
+//=============================================================================
+//      e3ffw_3DMF_tm_attarray_packable : Can a TriMesh attribute array be packed?
+//-----------------------------------------------------------------------------
+//		Note :	Normals and UVs can be packed, unless only some of the elements
+//				have them.
+//-----------------------------------------------------------------------------
+static bool
+e3ffw_3DMF_tm_attarray_packable( const TQ3TriMeshAttributeData* inAttData )
+{
+	return (inAttData->attributeUseArray == nullptr) &&
+		((inAttData->attributeType == kQ3AttributeTypeNormal) ||
+		(inAttData->attributeType == kQ3AttributeTypeSurfaceUV) ||
+		(inAttData->attributeType == kQ3AttributeTypeShadingUV));
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffw_3DMF_packed_attarray_size : Size of a packed attribute array.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3ffw_3DMF_packed_attarray_size( const TQ3TriMeshAttributeData* inAttData, TQ3Uns32 inArraySize )
+{
+	// Header, then two 16 bit values per element, UVs also have their range
+	TQ3Uns32	size = 5 * sizeof(TQ3Uns32) + inArraySize * 2 * sizeof(TQ3Uns16);
+
+	if (inAttData->attributeType != kQ3AttributeTypeNormal)
+		size += 4 * sizeof(TQ3Float32);
+
+	return size;
+}
+
+
+
+
+
 //=============================================================================
 //      e3ffw_3DMF_submit_tm_attarray : Helper for e3ffw_3DMF_trimesh_traverse.
 //-----------------------------------------------------------------------------
@@ -3035,7 +3172,8 @@ static TQ3Status
 e3ffw_3DMF_submit_tm_attarray( TQ3ViewObject view,
 								TQ3TriMeshData *data,
 								TQ3Uns32 inWhichArray,
-								TQ3Uns32 inWhichAttr )
+								TQ3Uns32 inWhichAttr,
+								TQ3Boolean inPack )
 {
 	TQ3Status	status = kQ3Success;
 	TQ3Uns32	size;
@@ -3073,6 +3211,29 @@ e3ffw_3DMF_submit_tm_attarray( TQ3ViewObject view,
 	Q3XElementType_GetElementSize( attClassType, &attrSize );
 	
 	
+	// Pack the array if we can
+	if ( (inPack == kQ3True) && e3ffw_3DMF_tm_attarray_packable( theAttData ) )
+	{
+		attrArrayClass = Q3XObjectHierarchy_FindClassByType( kQ3ObjectTypePackedAttributeArray );
+		Q3_REQUIRE_OR_RESULT( attrArrayClass != nullptr, kQ3Failure );
+		
+		objectData = (TE3FFormat3DMF_AttributeArray_Data*)
+			Q3Memory_Allocate( sizeof(TE3FFormat3DMF_AttributeArray_Data) );
+		Q3_REQUIRE_OR_RESULT( objectData != nullptr, kQ3Failure );
+
+		objectData->attributeData = theAttData;
+		objectData->whichArray = inWhichArray;
+		objectData->whichAttr = inWhichAttr;
+		objectData->arraySize = arraySize;
+		objectData->attributeSize = attrSize;
+		
+		size = e3ffw_3DMF_packed_attarray_size( theAttData, arraySize );
+		
+		return Q3XView_SubmitSubObjectData( view, attrArrayClass, size, objectData,
+			E3FFW_3DMF_Default_Delete );
+	}
+	
+	
 	// Compute the size of the AttributeArray object.
 	size = 5 * sizeof(TQ3Uns32);	// header
 	
@@ -3129,6 +3290,256 @@ e3ffw_3DMF_submit_tm_attarray( TQ3ViewObject view,
 	return status;
 }
 
+//=============================================================================
+//      e3ffw_3DMF_write_pad : Pad packed TriMesh data to a 4 byte boundary.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3ffw_3DMF_write_pad( TQ3Uns32 numBytes, TQ3FileObject file )
+{
+	TQ3Uns8		zeroBytes[4] = { 0, 0, 0, 0 };
+	TQ3Uns32	padBytes = Q3Size_Pad( numBytes ) - numBytes;
+	
+	if (padBytes == 0)
+		return kQ3Success;
+	
+	return Q3Uns8_WriteArray( padBytes, zeroBytes, file );
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffw_3DMF_packedtrimesh_delete : Packed TriMesh delete method.
+//-----------------------------------------------------------------------------
+static void
+e3ffw_3DMF_packedtrimesh_delete( void *data )
+{
+	delete (TE3FFW3DMFPackedTriMesh*) data;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffw_3DMF_trimesh_size : Size of a TriMesh in raw form.
+//-----------------------------------------------------------------------------
+static TQ3Uns32
+e3ffw_3DMF_trimesh_size( const TQ3TriMeshData *data )
+{
+	TQ3Uns32	size, pointIndexBytes, triIndexBytes;
+
+
+
+	size = 6 * sizeof(TQ3Uns32);
+		// array of triangles
+	pointIndexBytes = e3ffw_3DMF_num_index_bytes( data->numPoints );
+	size += data->numTriangles * pointIndexBytes * 3;
+		// array of edges
+	triIndexBytes = e3ffw_3DMF_num_index_bytes( data->numTriangles );
+	size += data->numEdges * 2 * (pointIndexBytes + triIndexBytes);
+		// array of points
+	size += static_cast<TQ3Uns32>(data->numPoints * sizeof(TQ3Point3D));
+		// bounding box
+	size += Q3Size_Pad( sizeof(TQ3BoundingBox) );
+	
+	return size;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffw_3DMF_packing_saves_space : Is a packed TriMesh smaller?
+//-----------------------------------------------------------------------------
+//		Note :	Compares the raw and packed sizes of the TriMesh data and of
+//				the attribute arrays which would be packed with it. Small
+//				meshes can be larger packed, because of the quantisation
+//				origin and step and the padding.
+//-----------------------------------------------------------------------------
+static bool
+e3ffw_3DMF_packing_saves_space( const TQ3TriMeshData *data, TQ3Uns32 inPackedSize )
+{
+	const TQ3TriMeshAttributeData*	theArrays[3] = { data->triangleAttributeTypes,
+													 data->edgeAttributeTypes,
+													 data->vertexAttributeTypes };
+	const TQ3Uns32	numAttrs[3]  = { data->numTriangleAttributeTypes,
+									 data->numEdgeAttributeTypes,
+									 data->numVertexAttributeTypes };
+	const TQ3Uns32	arraySize[3] = { data->numTriangles, data->numEdges, data->numPoints };
+	TQ3Uns32		rawSize      = e3ffw_3DMF_trimesh_size( data );
+	TQ3Uns32		packedSize   = inPackedSize;
+	TQ3Uns32		attrSize;
+
+
+
+	for (TQ3Uns32 n = 0; n < 3; ++n)
+	{
+		for (TQ3Uns32 i = 0; i < numAttrs[n]; ++i)
+		{
+			const TQ3TriMeshAttributeData*	theAttData = &theArrays[n][i];
+			
+			if (e3ffw_3DMF_tm_attarray_packable( theAttData ))
+			{
+				Q3XElementType_GetElementSize( E3Attribute_AttributeToClassType(
+					theAttData->attributeType ), &attrSize );
+
+				rawSize    += 5 * sizeof(TQ3Uns32) + arraySize[n] * attrSize;
+				packedSize += e3ffw_3DMF_packed_attarray_size( theAttData, arraySize[n] );
+			}
+		}
+	}
+	
+	return packedSize < rawSize;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffw_3DMF_submit_packed_trimesh : Submit a TriMesh in packed form.
+//-----------------------------------------------------------------------------
+//		Note :	Quantises the points to 16 bits within their bounds, and
+//				delta codes the triangle and edge indices. If the TriMesh
+//				can't be packed, or would not be any smaller, outIsPacked is
+//				set to false and nothing is submitted.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3ffw_3DMF_submit_packed_trimesh( TQ3ViewObject view,
+								TE3FFormatW3DMF_Data *formatData,
+								const TQ3TriMeshData *data,
+								TQ3Boolean *outIsPacked )
+{
+	TQ3Point3D					minPoint, maxPoint;
+	TQ3Uns32					i, n, size, prevPoint, prevTriangle;
+	TQ3ObjectType				oldObjectType;
+	TE3FFW3DMFPackedTriMesh		*packedData;
+	TQ3Status					qd3dstatus;
+	
+	
+	
+	// Find the bounds of the points
+	*outIsPacked = kQ3False;
+	if ((data->numPoints == 0) || (data->numTriangles == 0))
+		return kQ3Success;
+	
+	minPoint = maxPoint = data->points[0];
+	for (i = 1; i < data->numPoints; ++i)
+	{
+		minPoint.x = E3Num_Min( minPoint.x, data->points[i].x );
+		minPoint.y = E3Num_Min( minPoint.y, data->points[i].y );
+		minPoint.z = E3Num_Min( minPoint.z, data->points[i].z );
+		maxPoint.x = E3Num_Max( maxPoint.x, data->points[i].x );
+		maxPoint.y = E3Num_Max( maxPoint.y, data->points[i].y );
+		maxPoint.z = E3Num_Max( maxPoint.z, data->points[i].z );
+	}
+	
+	if (!isfinite( maxPoint.x - minPoint.x ) || !isfinite( maxPoint.y - minPoint.y ) ||
+		!isfinite( maxPoint.z - minPoint.z ))
+		return kQ3Success;
+	
+	
+	
+	// Quantise the points
+	packedData = new(std::nothrow) TE3FFW3DMFPackedTriMesh;
+	Q3_REQUIRE_OR_RESULT( packedData != nullptr, kQ3Failure );
+	
+	packedData->triMesh = data;
+	packedData->origin  = minPoint;
+	packedData->step.x  = (maxPoint.x - minPoint.x) / kE3FFW3DMFPackedPointMax;
+	packedData->step.y  = (maxPoint.y - minPoint.y) / kE3FFW3DMFPackedPointMax;
+	packedData->step.z  = (maxPoint.z - minPoint.z) / kE3FFW3DMFPackedPointMax;
+	packedData->points.resize( data->numPoints * 3 );
+	
+	const float*	theOrigin = &packedData->origin.x;
+	const float*	theSteps  = &packedData->step.x;
+	const float*	theCoords = &data->points[0].x;
+	
+	for (i = 0; i < data->numPoints; ++i, theCoords += 3)
+	{
+		for (n = 0; n < 3; ++n)
+		{
+			float	theValue = 0.0f;
+			
+			if (theSteps[n] > 0.0f)
+				theValue = E3Num_Clamp( (theCoords[n] - theOrigin[n]) / theSteps[n],
+										0.0f, kE3FFW3DMFPackedPointMax );
+			
+			packedData->points[ i * 3 + n ] = (TQ3Uns16) lroundf( theValue );
+		}
+	}
+	
+	
+	
+	// Delta code the indices
+	prevPoint = 0;
+	packedData->triangleBytes.reserve( data->numTriangles * 3 );
+	for (i = 0; i < data->numTriangles; ++i)
+	{
+		for (n = 0; n < 3; ++n)
+			E3FFormat_3DMF_DeltaPack( data->triangles[i].pointIndices[n], prevPoint,
+				packedData->triangleBytes );
+	}
+	
+	prevPoint    = 0;
+	prevTriangle = 0;
+	packedData->edgeBytes.reserve( data->numEdges * 4 );
+	for (i = 0; i < data->numEdges; ++i)
+	{
+		for (n = 0; n < 2; ++n)
+			E3FFormat_3DMF_DeltaPack( data->edges[i].pointIndices[n], prevPoint,
+				packedData->edgeBytes );
+
+		for (n = 0; n < 2; ++n)
+			E3FFormat_3DMF_DeltaPack( data->edges[i].triangleIndices[n], prevTriangle,
+				packedData->edgeBytes );
+	}
+	
+	
+	
+	// Compute size of data
+	size = 6 * sizeof(TQ3Uns32);
+		// quantisation origin and step
+	size += sizeof(TQ3Point3D) + sizeof(TQ3Vector3D);
+		// triangle and edge indices
+	size += sizeof(TQ3Uns32) + Q3Size_Pad( static_cast<TQ3Uns32>(packedData->triangleBytes.size()) );
+	size += sizeof(TQ3Uns32) + Q3Size_Pad( static_cast<TQ3Uns32>(packedData->edgeBytes.size()) );
+		// array of points
+	size += Q3Size_Pad( static_cast<TQ3Uns32>(packedData->points.size() * sizeof(TQ3Uns16)) );
+		// bounding box
+	size += Q3Size_Pad( sizeof(TQ3BoundingBox) );
+	
+	if (! e3ffw_3DMF_packing_saves_space( data, size ))
+	{
+		delete packedData;
+		return kQ3Success;
+	}
+	
+	
+	
+	// Submit it as a packed TriMesh rather than a TriMesh
+	oldObjectType = formatData->lastObjectType;
+	formatData->lastObjectType = kQ3ObjectTypePackedTriMesh;
+	
+	qd3dstatus = Q3XView_SubmitWriteData( view, size, packedData, e3ffw_3DMF_packedtrimesh_delete );
+	
+	formatData->lastObjectType = oldObjectType;
+	
+	if (qd3dstatus == kQ3Success)
+		*outIsPacked = kQ3True;
+	else
+		delete packedData;
+	
+	return qd3dstatus;
+}
+
+
+
+
+
 //=============================================================================
 //      e3ffw_3DMF_trimesh_traverse : TriMesh traverse method.
 //-----------------------------------------------------------------------------
@@ -3137,8 +3548,11 @@ e3ffw_3DMF_trimesh_traverse(TQ3Object object,
 					 TQ3TriMeshData *data,
 					 TQ3ViewObject view)
 {
-	TQ3Status qd3dstatus;
-	TQ3Uns32	size, pointIndexBytes, triIndexBytes, i;
+	TQ3Status qd3dstatus = kQ3Success;
+	TQ3Uns32	size, i;
+	TQ3FileFormatObject		theFormat = E3View_AccessFileFormat( view );
+	TE3FFormatW3DMF_Data*	formatData = (TE3FFormatW3DMF_Data*) theFormat->FindLeafInstanceData();
+	TQ3Boolean				isPacked = kQ3False;
 	
 
 	// We don't want to write a stale cached triangle strip, but the triangle
@@ -3155,20 +3569,16 @@ e3ffw_3DMF_trimesh_traverse(TQ3Object object,
 	}
 
 
-	// Compute size of data
-	size = 6 * sizeof(TQ3Uns32);
-		// array of triangles
-	pointIndexBytes = e3ffw_3DMF_num_index_bytes( data->numPoints );
-	size += data->numTriangles * pointIndexBytes * 3;
-		// array of edges
-	triIndexBytes = e3ffw_3DMF_num_index_bytes( data->numTriangles );
-	size += data->numEdges * 2 * (pointIndexBytes + triIndexBytes);
-		// array of points
-	size += static_cast<TQ3Uns32>(data->numPoints * sizeof(TQ3Point3D));
-		// bounding box
-	size += Q3Size_Pad( sizeof(TQ3BoundingBox) );
+	// Use the packed form if the file asked for it
+	if (formatData->packGeometry == kQ3True)
+		qd3dstatus = e3ffw_3DMF_submit_packed_trimesh( view, formatData, data, &isPacked );
 	
-	qd3dstatus = Q3XView_SubmitWriteData (view, size, (void*)data, nullptr);
+	if ((qd3dstatus == kQ3Success) && (isPacked == kQ3False))
+	{
+		size = e3ffw_3DMF_trimesh_size( data );
+		
+		qd3dstatus = Q3XView_SubmitWriteData (view, size, (void*)data, nullptr);
+	}
 	
 	// Attribute array subobjects
 	
@@ -3176,21 +3586,21 @@ e3ffw_3DMF_trimesh_traverse(TQ3Object object,
 	for (i = 0; (qd3dstatus == kQ3Success) &&
 		(i < data->numTriangleAttributeTypes); ++i)
 	{
-		qd3dstatus = e3ffw_3DMF_submit_tm_attarray( view, data, 0, i );
+		qd3dstatus = e3ffw_3DMF_submit_tm_attarray( view, data, 0, i, isPacked );
 	}
 	
 	// Edge attributes
 	for (i = 0; (qd3dstatus == kQ3Success) &&
 		(i < data->numEdgeAttributeTypes); ++i)
 	{
-		qd3dstatus = e3ffw_3DMF_submit_tm_attarray( view, data, 1, i );
+		qd3dstatus = e3ffw_3DMF_submit_tm_attarray( view, data, 1, i, isPacked );
 	}
 	
 	// Vertex attributes
 	for (i = 0; (qd3dstatus == kQ3Success) &&
 		(i < data->numVertexAttributeTypes); ++i)
 	{
-		qd3dstatus = e3ffw_3DMF_submit_tm_attarray( view, data, 2, i );
+		qd3dstatus = e3ffw_3DMF_submit_tm_attarray( view, data, 2, i, isPacked );
 	}
 	
 	// Overall attribute set (don't write it unless it's nonempty)
@@ -3233,47 +3643,37 @@ e3ffw_3DMF_trimesh_write(const TQ3TriMeshData *object,
 	
 	// Array of triangles
 	pointIndexBytes = e3ffw_3DMF_num_index_bytes( object->numPoints );
-	for (i = 0; (i < object->numTriangles) && (writeStatus == kQ3Success); ++i)
-	{
-		writeStatus = e3ffw_3DMF_write_comp_num( object->triangles[i].pointIndices[0],
-			pointIndexBytes, theFile );
-		if (writeStatus == kQ3Failure)
-			break;
-		writeStatus = e3ffw_3DMF_write_comp_num( object->triangles[i].pointIndices[1],
-			pointIndexBytes, theFile );
-		if (writeStatus == kQ3Failure)
-			break;
-		writeStatus = e3ffw_3DMF_write_comp_num( object->triangles[i].pointIndices[2],
-			pointIndexBytes, theFile );
-	}
+	if (writeStatus == kQ3Success)
+		writeStatus = e3ffw_3DMF_write_comp_array( object->numTriangles * 3,
+			&object->triangles[0].pointIndices[0], pointIndexBytes, theFile );
 	
 	// Array of edges
 	triIndexBytes = e3ffw_3DMF_num_index_bytes( object->numTriangles );
-	for (i = 0; (i < object->numEdges) && (writeStatus == kQ3Success); ++i)
+	if ((pointIndexBytes == triIndexBytes) && (writeStatus == kQ3Success))
 	{
-		writeStatus = e3ffw_3DMF_write_comp_num( object->edges[i].pointIndices[0],
-			pointIndexBytes, theFile );
-		if (writeStatus == kQ3Failure)
-			break;
-		writeStatus = e3ffw_3DMF_write_comp_num( object->edges[i].pointIndices[1],
-			pointIndexBytes, theFile );
-		if (writeStatus == kQ3Failure)
-			break;
-		
-		writeStatus = e3ffw_3DMF_write_comp_num( object->edges[i].triangleIndices[0],
-			triIndexBytes, theFile );
-		if (writeStatus == kQ3Failure)
-			break;
-		writeStatus = e3ffw_3DMF_write_comp_num( object->edges[i].triangleIndices[1],
-			triIndexBytes, theFile );
+		// Each edge is 4 indices of the same width, so write them in one go
+		writeStatus = e3ffw_3DMF_write_comp_array( object->numEdges * 4,
+			&object->edges[0].pointIndices[0], pointIndexBytes, theFile );
 	}
-	
-	// Array of points
-	for (i = 0; (i < object->numPoints) && (writeStatus == kQ3Success); ++i)
+	else
 	{
-		writeStatus = Q3Point3D_Write( &object->points[i], theFile );
+		for (i = 0; (i < object->numEdges) && (writeStatus == kQ3Success); ++i)
+		{
+			writeStatus = e3ffw_3DMF_write_comp_array( 2, object->edges[i].pointIndices,
+				pointIndexBytes, theFile );
+			if (writeStatus == kQ3Failure)
+				break;
+			
+			writeStatus = e3ffw_3DMF_write_comp_array( 2, object->edges[i].triangleIndices,
+				triIndexBytes, theFile );
+		}
 	}
 	
+	// Array of points
+	if ((object->numPoints != 0) && (writeStatus == kQ3Success))
+		writeStatus = Q3Float32_WriteArray( object->numPoints * 3,
+			&object->points[0].x, theFile );
+	
 	// Bounding box
 	if (writeStatus == kQ3Success)
 		writeStatus = Q3Point3D_Write( &object->bBox.min, theFile );
@@ -3286,6 +3686,77 @@ e3ffw_3DMF_trimesh_write(const TQ3TriMeshData *object,
 }
 
 
+
+//=============================================================================
+//      e3ffw_3DMF_packedtrimesh_write : Packed TriMesh write method.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3ffw_3DMF_packedtrimesh_write(const TE3FFW3DMFPackedTriMesh *object,
+				TQ3FileObject theFile)
+{
+	const TQ3TriMeshData*	theTriMesh = object->triMesh;
+	TQ3Uns32				numTriangleBytes = static_cast<TQ3Uns32>(object->triangleBytes.size());
+	TQ3Uns32				numEdgeBytes     = static_cast<TQ3Uns32>(object->edgeBytes.size());
+	TQ3Uns32				numPointValues   = static_cast<TQ3Uns32>(object->points.size());
+	TQ3Status				writeStatus;
+	
+	writeStatus = Q3Uns32_Write( theTriMesh->numTriangles, theFile );
+	
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Uns32_Write( theTriMesh->numTriangleAttributeTypes, theFile );
+
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Uns32_Write( theTriMesh->numEdges, theFile );
+
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Uns32_Write( theTriMesh->numEdgeAttributeTypes, theFile );
+
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Uns32_Write( theTriMesh->numPoints, theFile );
+
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Uns32_Write( theTriMesh->numVertexAttributeTypes, theFile );
+	
+	// Quantisation origin and step
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Point3D_Write( &object->origin, theFile );
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Vector3D_Write( &object->step, theFile );
+	
+	// Array of triangles
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Uns32_Write( numTriangleBytes, theFile );
+	if ((numTriangleBytes != 0) && (writeStatus == kQ3Success))
+		writeStatus = Q3Uns8_WriteArray( numTriangleBytes, &object->triangleBytes[0], theFile );
+	if (writeStatus == kQ3Success)
+		writeStatus = e3ffw_3DMF_write_pad( numTriangleBytes, theFile );
+	
+	// Array of edges
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Uns32_Write( numEdgeBytes, theFile );
+	if ((numEdgeBytes != 0) && (writeStatus == kQ3Success))
+		writeStatus = Q3Uns8_WriteArray( numEdgeBytes, &object->edgeBytes[0], theFile );
+	if (writeStatus == kQ3Success)
+		writeStatus = e3ffw_3DMF_write_pad( numEdgeBytes, theFile );
+	
+	// Array of points
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Uns16_WriteArray( numPointValues, &object->points[0], theFile );
+	if (writeStatus == kQ3Success)
+		writeStatus = e3ffw_3DMF_write_pad( numPointValues * sizeof(TQ3Uns16), theFile );
+	
+	// Bounding box
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Point3D_Write( &theTriMesh->bBox.min, theFile );
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Point3D_Write( &theTriMesh->bBox.max, theFile );
+	if (writeStatus == kQ3Success)
+		writeStatus = Q3Uns32_Write( theTriMesh->bBox.isEmpty, theFile );
+
+	return writeStatus;
+}
+
+
 //=============================================================================
 //      Public functions
 //-----------------------------------------------------------------------------
@@ -3745,6 +4216,7 @@ E3FFW_3DMF_RegisterGeom(void)
 	
 	E3ClassTree::AddMethod(kQ3GeometryTypeTriMesh,kQ3XMethodTypeObjectTraverse,(TQ3XFunctionPointer)e3ffw_3DMF_trimesh_traverse);
 	E3ClassTree::AddMethod(kQ3GeometryTypeTriMesh,kQ3XMethodTypeObjectWrite,(TQ3XFunctionPointer)e3ffw_3DMF_trimesh_write);
+	E3ClassTree::AddMethod(kQ3ObjectTypePackedTriMesh,kQ3XMethodTypeObjectWrite,(TQ3XFunctionPointer)e3ffw_3DMF_packedtrimesh_write);
 
 	E3ClassTree::AddMethod(kQ3GeometryTypeEllipsoid,kQ3XMethodTypeObjectTraverse,(TQ3XFunctionPointer)e3ffw_3DMF_ellipsoid_traverse);
 	E3ClassTree::AddMethod(kQ3GeometryTypeEllipsoid,kQ3XMethodTypeObjectWrite,(TQ3XFunctionPointer)e3ffw_3DMF_ellipsoid_write);
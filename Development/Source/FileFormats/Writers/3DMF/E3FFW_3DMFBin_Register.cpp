@@ -548,6 +548,22 @@ e3ffw_3dmfbin_metahandler(TQ3XMethodType methodType)
 			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinary_Raw;
 			break;
 
+		case kQ3XMethodTypeFFormatFloat32WriteArray:
+			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinaryArray_32;
+			break;
+
+		case kQ3XMethodTypeFFormatInt8WriteArray:
+			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinaryArray_8;
+			break;
+
+		case kQ3XMethodTypeFFormatInt16WriteArray:
+			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinaryArray_16;
+			break;
+
+		case kQ3XMethodTypeFFormatInt32WriteArray:
+			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinaryArray_32;
+			break;
+
 		default: // get the common methods
 			theMethod = e3ffw_3dmf_metahandler (methodType);
 			break;
@@ -699,6 +715,18 @@ e3ffw_3dmfbin_swap_metahandler(TQ3XMethodType methodType)
 			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinSwap_32;
 			break;
 
+		case kQ3XMethodTypeFFormatFloat32WriteArray:
+			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinSwapArray_32;
+			break;
+
+		case kQ3XMethodTypeFFormatInt16WriteArray:
+			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinSwapArray_16;
+			break;
+
+		case kQ3XMethodTypeFFormatInt32WriteArray:
+			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinSwapArray_32;
+			break;
+
 		case kQ3XMethodTypeFFormatInt64Write:
 			theMethod = (TQ3XFunctionPointer) E3FileFormat_GenericWriteBinSwap_64;
 			break;
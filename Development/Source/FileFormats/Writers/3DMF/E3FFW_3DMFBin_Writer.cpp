@@ -47,6 +47,9 @@
 #include "E3View.h"
 #include "E3FFW_3DMFBin_Writer.h"
 #include "E3Main.h"
+#include "CQ3ObjectRef.h"
+
+#include <vector>
 
 
 
@@ -66,6 +69,19 @@
 
 
 
+
+
+//=============================================================================
+//      Internal constants
+//-----------------------------------------------------------------------------
+// Sizes of the parts of a binary 3DMF file, in bytes
+const TQ3Uns32 kFileHeaderSize		= 24;	// '3DMF', size, version, flags, TOC location
+const TQ3Uns32 kReferenceSize		= 12;	// 'rfrn', size, refID
+const TQ3Uns32 kTOCHeaderSize		= 36;	// 'toc ', size, next TOC, seeds, entry type, size and count
+const TQ3Uns32 kTOCEntrySize		= 16;	// refID, location, type
+
+
+
 static TQ3Status
 e3ffw_3DMF_TraverseObject_CheckRef(TQ3ViewObject			theView,
 					TE3FFormatW3DMF_Data		*fileFormatPrivate,
@@ -76,6 +92,153 @@ e3ffw_3DMF_TraverseObject_CheckRef(TQ3ViewObject			theView,
 
 
 
+//=============================================================================
+//      e3ffw_3DMF_serialise_object : Write an object to a byte array.
+//-----------------------------------------------------------------------------
+//		Note :	The object is written on its own to a stream mode file in
+//				memory, so objects with the same 3DMF data give the same bytes.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3ffw_3DMF_serialise_object( TQ3Object theObject, std::vector<TQ3Uns8>& outBytes )
+{
+	TQ3Status		qd3dStatus;
+	TQ3ViewStatus	viewStatus;
+	unsigned char	*theBuffer = nullptr;
+	TQ3Uns32		validSize = 0, bufferSize = 0;
+	
+	
+	
+	// Create the storage, file and view
+	CQ3ObjectRef	theStorage( Q3MemoryStorage_New( nullptr, 0 ) );
+	CQ3ObjectRef	theFile( Q3File_New() );
+	CQ3ObjectRef	theView( Q3View_New() );
+	
+	if (!theStorage.isvalid() || !theFile.isvalid() || !theView.isvalid())
+		return kQ3Failure;
+	
+	Q3File_SetStorage( theFile.get(), theStorage.get() );
+	if (Q3File_OpenWrite( theFile.get(), kQ3FileModeStream ) != kQ3Success)
+		return kQ3Failure;
+	
+	
+	
+	// Write the object
+	qd3dStatus = Q3View_StartWriting( theView.get(), theFile.get() );
+	if (qd3dStatus == kQ3Success)
+	{
+		do
+		{
+			qd3dStatus = Q3Object_Submit( theObject, theView.get() );
+			viewStatus = Q3View_EndWriting( theView.get() );
+		}
+		while (viewStatus == kQ3ViewStatusRetraverse);
+		
+		if (viewStatus != kQ3ViewStatusDone)
+			qd3dStatus = kQ3Failure;
+	}
+	
+	Q3File_Close( theFile.get() );
+	
+	
+	
+	// Grab the bytes
+	if (qd3dStatus == kQ3Success)
+		qd3dStatus = Q3MemoryStorage_GetBuffer( theStorage.get(), &theBuffer, &validSize, &bufferSize );
+	
+	if (qd3dStatus == kQ3Success)
+		outBytes.assign( theBuffer, theBuffer + validSize );
+	
+	return qd3dStatus;
+}
+
+
+
+
+
+//=============================================================================
+//      e3ffw_3DMF_find_equal_object : Find an equal object already in the TOC.
+//-----------------------------------------------------------------------------
+//		Note :	Objects are found by a hash of their serialised 3DMF data,
+//				and hash matches are then compared byte for byte against the
+//				data kept from when the other object was indexed.
+//
+//				An equal object is only used if writing a reference to it
+//				is smaller than writing the object again, counting the TOC
+//				entry and TOC header that the reference may need. If no
+//				equal object is used, the object is recorded under its hash
+//				as TOC entry newTocIndex.
+//-----------------------------------------------------------------------------
+static TQ3Boolean
+e3ffw_3DMF_find_equal_object( TE3FFormatW3DMF_Data *fileFormatPrivate, TQ3Object theObject,
+								TQ3Uns32 newTocIndex, TQ3Uns32 *outTocIndex )
+{
+	TE3FFormat3DMF_TOC		*toc = fileFormatPrivate->toc;
+	TE3FFormatW3DMF_Content	theContent;
+	uint64_t				theHash = 0xCBF29CE484222325ULL;
+	TQ3Uns32				objectSize, referenceSize;
+	
+	
+	
+	// Hash the object, using FNV-1a
+	if (e3ffw_3DMF_serialise_object( theObject, theContent.bytes ) != kQ3Success)
+		return kQ3False;
+	
+	for (std::vector<TQ3Uns8>::const_iterator i = theContent.bytes.begin(); i != theContent.bytes.end(); ++i)
+		theHash = (theHash ^ *i) * 0x100000001B3ULL;
+	
+	objectSize = static_cast<TQ3Uns32>(theContent.bytes.size()) - kFileHeaderSize;
+	
+	
+	
+	// Objects no bigger than a reference can never be worth sharing
+	if (objectSize <= kReferenceSize)
+		return kQ3False;
+	
+	
+	
+	// Look for an object with the same data
+	if (fileFormatPrivate->contentIndex == nullptr)
+		fileFormatPrivate->contentIndex = new TE3FFormatW3DMF_ContentMap;
+	
+	std::pair< TE3FFormatW3DMF_ContentMap::iterator, TE3FFormatW3DMF_ContentMap::iterator > theMatches =
+		fileFormatPrivate->contentIndex->equal_range( theHash );
+	
+	for (TE3FFormatW3DMF_ContentMap::iterator i = theMatches.first; i != theMatches.second; ++i)
+	{
+		TQ3Uns32	otherIndex = i->second.tocIndex;
+		
+		if ((Q3Object_GetLeafType( toc->tocEntries[ otherIndex ].object ) == Q3Object_GetLeafType( theObject )) &&
+			(i->second.bytes == theContent.bytes))
+		{
+			referenceSize = kReferenceSize;
+			
+			if (toc->tocEntries[ otherIndex ].refID == 0)
+				referenceSize += kTOCEntrySize;
+			
+			if (toc->refSeed == 1)
+				referenceSize += kTOCHeaderSize;
+			
+			if (objectSize <= referenceSize)
+				return kQ3False;
+			
+			*outTocIndex = otherIndex;
+			return kQ3True;
+		}
+	}
+	
+	TE3FFormatW3DMF_ContentMap::iterator theEntry = fileFormatPrivate->contentIndex->insert(
+		TE3FFormatW3DMF_ContentMap::value_type( theHash, TE3FFormatW3DMF_Content() ) );
+	
+	theEntry->second.tocIndex = newTocIndex;
+	theEntry->second.bytes.swap( theContent.bytes );
+	
+	return kQ3False;
+}
+
+
+
+
+
 //=============================================================================
 //      e3ffw_3DMF_filter_in_toc : Adds the object to the TOC if needed and
 //      returns a reference object
@@ -145,6 +308,24 @@ e3ffw_3DMF_filter_in_toc(TE3FFormatW3DMF_Data *fileFormatPrivate,  TQ3Object the
 	
 	std::pair< TE3FFormatW3DMF_Map::iterator, bool > insertResult =
 		fileFormatPrivate->index->insert( newRec );
+	
+	
+	// If asked to, a new object that is equal to one already in the table of
+	// contents is treated as if it were that object. Groups are left alone,
+	// since serialising them would serialise their contents over and over.
+	//
+	// The new object is not retained by the TOC, so it is taken back out of
+	// the index: once disposed its address could be reused by another object.
+	
+	if (insertResult.second && (createReference == kQ3True) &&
+		(fileFormatPrivate->shareEqualObjects == kQ3True) &&
+		!Q3Object_IsType( theObject, kQ3ShapeTypeGroup ) &&
+		e3ffw_3DMF_find_equal_object( fileFormatPrivate, theObject, toc->nEntries, &i ))
+	{
+		fileFormatPrivate->index->erase( insertResult.first );
+		insertResult.first = fileFormatPrivate->index->end();
+		insertResult.second = false;
+	}
 		
 	if (insertResult.second) // inserted a new entry, so it was not there before
 	{
@@ -183,7 +364,8 @@ e3ffw_3DMF_filter_in_toc(TE3FFormatW3DMF_Data *fileFormatPrivate,  TQ3Object the
 	}
 	else	// the object was already there
 	{
-		i = insertResult.first->second;
+		if (insertResult.first != fileFormatPrivate->index->end())
+			i = insertResult.first->second;
 		
 		if (createReference == kQ3True)
 		{
@@ -315,6 +497,22 @@ E3FFW_3DMF_StartFile(TQ3ViewObject				theView,
 						TQ3DrawContextObject	theDrawContext)
 {
 #pragma unused(theDrawContext)
+	TQ3Boolean	packGeometry = kQ3False;
+	TQ3Boolean	shareEqualObjects = kQ3False;
+	
+	
+	
+	// See whether the caller asked for packed geometry or shared equal objects
+	Q3Object_GetProperty( E3View_AccessFile( theView ), kQ3FilePropertyPackGeometry,
+		sizeof(TQ3Boolean), nullptr, &packGeometry );
+	fileFormatPrivate->packGeometry = packGeometry;
+	
+	Q3Object_GetProperty( E3View_AccessFile( theView ), kQ3FilePropertyShareEqualObjects,
+		sizeof(TQ3Boolean), nullptr, &shareEqualObjects );
+	fileFormatPrivate->shareEqualObjects = shareEqualObjects;
+	
+	
+	
   	TQ3Status status = fileFormatPrivate->baseData.currentStoragePosition > 0 ? kQ3Success :
   						E3FFW_3DMF_TraverseObject (theView, fileFormatPrivate, nullptr, kQ3ObjectType3DMF, fileFormatPrivate);
 	
@@ -344,18 +542,18 @@ E3FFW_3DMF_EndPass(TQ3ViewObject				theView,
 {
 	TQ3Status				status = kQ3Success;
 	TE3FFormat3DMF_TOC		*toc = fileFormatPrivate->toc;
-	TQ3Uns64 				pos = {0,0};
+	uint64_t 				pos = 0;
 	TQ3FileObject 			theFile = E3View_AccessFile (theView);
 	
 	if(toc != nullptr) // write the toc
 		{
-		pos.lo = fileFormatPrivate->baseData.currentStoragePosition;
+		pos = fileFormatPrivate->baseData.currentStoragePosition;
 		status = E3FFW_3DMF_TraverseObject (theView, fileFormatPrivate, nullptr, kQ3ObjectTypeTOC, fileFormatPrivate);
 		
-		if((status == kQ3Success) && (pos.lo != fileFormatPrivate->baseData.currentStoragePosition))// something has been written 
+		if((status == kQ3Success) && (pos != fileFormatPrivate->baseData.currentStoragePosition))// something has been written 
 			{
 				fileFormatPrivate->baseData.currentStoragePosition = 16;
-				Q3Uns64_Write(pos, theFile);
+				Q3Uns64_Write(E3FFormat_3DMF_OffsetToUns64(pos), theFile);
 			}
 		
 		}
@@ -468,6 +666,11 @@ E3FFW_3DMF_Close( TQ3FileFormatObject format, TQ3Boolean abort )
 	{
 		delete instanceData->index;
 	}
+	
+	if (instanceData->contentIndex != nullptr)
+	{
+		delete instanceData->contentIndex;
+	}
 		
 			
 	return status;
@@ -487,7 +690,7 @@ e3ffw_3DMF_write_objects(TE3FFormatW3DMF_Data *instanceData, TQ3FileObject theFi
 	TQ3ObjectType			container;
 	TQ3Uns32				lastLevel;
 #if Q3_DEBUG
-	TQ3Uns32 pos;
+	uint64_t pos;
 #endif
 
 	for(i=0; i<instanceData->stackCount; i++){
@@ -498,8 +701,8 @@ e3ffw_3DMF_write_objects(TE3FFormatW3DMF_Data *instanceData, TQ3FileObject theFi
 		
 			if(instanceData->stack[i].tocIndex != kQ3ArrayIndexNULL)
 				{ // fill in the object position in the TOC
-				instanceData->toc->tocEntries[instanceData->stack[i].tocIndex].objLocation.lo =
-							 instanceData->baseData.currentStoragePosition;
+				instanceData->toc->tocEntries[instanceData->stack[i].tocIndex].objLocation =
+							 E3FFormat_3DMF_OffsetToUns64(instanceData->baseData.currentStoragePosition);
 				}
 
 
@@ -101,11 +101,15 @@ e3storage_win32_new(TQ3Object theObject, void *privateData, const void *paramDat
 
 
 //=============================================================================
-//      e3storage_win32_getsize : Get the size of the storage object.
+//      e3storage_win32_getsize64 : Get the size of the storage object.
 //-----------------------------------------------------------------------------
 static TQ3Status
-e3storage_win32_getsize ( E3Win32Storage* storage, TQ3Uns32 *size )
+e3storage_win32_getsize64 ( E3Win32Storage* storage, uint64_t *size )
 	{
+	LARGE_INTEGER	fileSize;
+
+
+
 	// Make sure the file is open
 	if (storage->instanceData.theFile == NULL)
 		{
@@ -116,14 +120,13 @@ e3storage_win32_getsize ( E3Win32Storage* storage, TQ3Uns32 *size )
 
 
 	// Get the file size
-	DWORD fileSize = GetFileSize(storage->instanceData.theFile, NULL);
-	if (fileSize == 0xFFFFFFFF)
+	if (!GetFileSizeEx(storage->instanceData.theFile, &fileSize))
 		{
 		*size = 0;
 		return(kQ3Failure);
 		}
 
-	*size = (TQ3Uns32) fileSize;
+	*size = (uint64_t) fileSize.QuadPart;
 	
 	return(kQ3Success);
 	}
@@ -133,12 +136,63 @@ e3storage_win32_getsize ( E3Win32Storage* storage, TQ3Uns32 *size )
 
 
 //=============================================================================
-//      e3storage_win32_read : Read data from the storage object.
+//      e3storage_win32_getsize : Get the size of the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_win32_getsize ( E3Win32Storage* storage, TQ3Uns32 *size )
+	{
+	uint64_t	fullSize;
+
+
+
+	// Get the file size, which must fit in 32 bits
+	*size = 0;
+	if (e3storage_win32_getsize64(storage, &fullSize) != kQ3Success)
+		return(kQ3Failure);
+
+	if (fullSize > 0xFFFFFFFF)
+		{
+		E3ErrorManager_PostError(kQ3ErrorNotSupported, kQ3False);
+		return(kQ3Failure);
+		}
+
+	*size = (TQ3Uns32) fullSize;
+	
+	return(kQ3Success);
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_win32_seek : Seek the file to a 64-bit offset.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_win32_seek ( E3Win32Storage* storage, uint64_t offset )
+	{
+	LARGE_INTEGER	thePos;
+
+
+
+	thePos.QuadPart = (LONGLONG) offset;
+	if (!SetFilePointerEx(storage->instanceData.theFile, thePos, NULL, FILE_BEGIN))
+		return(kQ3Failure);
+	
+	return(kQ3Success);
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_win32_read64 : Read data from the storage object.
 //-----------------------------------------------------------------------------
 //		Note : Currently unbuffered - may cause performance problems.
 //-----------------------------------------------------------------------------
 static TQ3Status
-e3storage_win32_read ( E3Win32Storage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+e3storage_win32_read64 ( E3Win32Storage* storage, uint64_t offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
 	{
 	// Make sure the file is open
 	if (storage->instanceData.theFile == NULL)
@@ -150,8 +204,7 @@ e3storage_win32_read ( E3Win32Storage* storage, TQ3Uns32 offset, TQ3Uns32 dataSi
 
 
 	// Seek to the offset
-	DWORD newPos = SetFilePointer(storage->instanceData.theFile, offset, NULL, FILE_BEGIN);
-	if (newPos == 0xFFFFFFFF)
+	if (e3storage_win32_seek(storage, offset) != kQ3Success)
 		return(kQ3Failure);
 
 
@@ -169,12 +222,25 @@ e3storage_win32_read ( E3Win32Storage* storage, TQ3Uns32 offset, TQ3Uns32 dataSi
 
 
 //=============================================================================
-//      e3storage_win32_write : Write data to the storage object.
+//      e3storage_win32_read : Read data from the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_win32_read ( E3Win32Storage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, unsigned char *data, TQ3Uns32 *sizeRead )
+	{
+	return(e3storage_win32_read64(storage, offset, dataSize, data, sizeRead));
+	}
+
+
+
+
+
+//=============================================================================
+//      e3storage_win32_write64 : Write data to the storage object.
 //-----------------------------------------------------------------------------
 //		Note : Currently unbuffered - may cause performance problems.
 //-----------------------------------------------------------------------------
 static TQ3Status
-e3storage_win32_write ( E3Win32Storage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+e3storage_win32_write64 ( E3Win32Storage* storage, uint64_t offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
 	{
 	// Make sure the file is open
 	if (storage->instanceData.theFile == NULL)
@@ -186,8 +252,7 @@ e3storage_win32_write ( E3Win32Storage* storage, TQ3Uns32 offset, TQ3Uns32 dataS
 
 
 	// Seek to the offset
-	DWORD newPos = SetFilePointer(storage->instanceData.theFile, offset, NULL, FILE_BEGIN);
-	if (newPos == 0xFFFFFFFF)
+	if (e3storage_win32_seek(storage, offset) != kQ3Success)
 		return(kQ3Failure);
 
 
@@ -204,6 +269,19 @@ e3storage_win32_write ( E3Win32Storage* storage, TQ3Uns32 offset, TQ3Uns32 dataS
 
 
 
+//=============================================================================
+//      e3storage_win32_write : Write data to the storage object.
+//-----------------------------------------------------------------------------
+static TQ3Status
+e3storage_win32_write ( E3Win32Storage* storage, TQ3Uns32 offset, TQ3Uns32 dataSize, const unsigned char *data, TQ3Uns32 *sizeWritten )
+	{
+	return(e3storage_win32_write64(storage, offset, dataSize, data, sizeWritten));
+	}
+
+
+
+
+
 //=============================================================================
 //      e3storage_win32_metahandler : Win32 storage metahandler.
 //-----------------------------------------------------------------------------
@@ -230,6 +308,18 @@ e3storage_win32_metahandler(TQ3XMethodType methodType)
 		case kQ3XMethodTypeStorageWriteData:
 			theMethod = (TQ3XFunctionPointer) e3storage_win32_write;
 			break;
+
+		case kQ3XMethodTypeStorageGetSize64:
+			theMethod = (TQ3XFunctionPointer) e3storage_win32_getsize64;
+			break;
+
+		case kQ3XMethodTypeStorageReadData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_win32_read64;
+			break;
+
+		case kQ3XMethodTypeStorageWriteData64:
+			theMethod = (TQ3XFunctionPointer) e3storage_win32_write64;
+			break;
 		}
 	
 	return(theMethod);
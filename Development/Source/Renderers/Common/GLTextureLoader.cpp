@@ -56,6 +56,7 @@
 #include "E3Prefix.h"
 #include "E3Debug.h"
 #include "E3ErrorManager.h"
+#include "E3Trace.h"
 #include "E3Utils.h"
 #include "QORenderer.h"
 
@@ -909,7 +910,8 @@ static TQ3StorageObject CreateFileStorageFromMemoryStorage(
 static bool	LoadOpenGLWithPixmapTexture(
 								TQ3TextureObject inTexture,
 								bool inPremultiplyAlpha,
-								const QORenderer::GLFuncs& inFuncs )
+								const QORenderer::GLFuncs& inFuncs,
+								TQ3Uns32& outUploadBytes )
 {
 	bool	didLoad = false;
 	TQ3StoragePixmap	thePixmap;
@@ -938,6 +940,7 @@ static bool	LoadOpenGLWithPixmapTexture(
 				glTexImage2D( GL_TEXTURE_2D, 0, glInternalFormat,
 					theWidth, theHeight, 0, glFormat, GL_UNSIGNED_BYTE,
 					imageData );
+				outUploadBytes += theWidth * theHeight * 4;
 
 				inFuncs.glGenerateMipmapProc( GL_TEXTURE_2D );
 
@@ -954,7 +957,8 @@ static bool	LoadOpenGLWithPixmapTexture(
 
 static bool	LoadOpenGLWithMipmapTexture(
 								TQ3TextureObject inTexture,
-								bool inPremultiplyAlpha )
+								bool inPremultiplyAlpha,
+								TQ3Uns32& outUploadBytes )
 {
 	bool	didLoad = false;
 	TQ3Mipmap		theMipmap;
@@ -988,6 +992,7 @@ static bool	LoadOpenGLWithMipmapTexture(
 					glTexImage2D( GL_TEXTURE_2D, i, glInternalFormat,
 						theWidth, theHeight, 0, glFormat, GL_UNSIGNED_BYTE,
 						imageData );
+					outUploadBytes += theWidth * theHeight * 4;
 				}
 				else
 				{
@@ -1034,14 +1039,17 @@ static void MaybeCallBackAfterUpload( TQ3TextureObject inTexture )
 									texture data has an alpha channel and is NOT
 									set up with premultiplied alpha.
 	@param		inFuncs				OpenGL function pointers.
+	@param		inView				The view being rendered, or nullptr.
 	@result		An OpenGL texture "name", or 0 on failure.
 */
 GLuint	GLTextureLoader( TQ3TextureObject inTexture,
 							TQ3Boolean inPremultiplyAlpha,
-							const QORenderer::GLFuncs& inFuncs )
+							const QORenderer::GLFuncs& inFuncs,
+							TQ3ViewObject inView )
 {
 	GLuint	resultTextureName = 0;
 	Q3_ASSERT( inTexture != nullptr );
+	Q3_TRACE_SCOPE( "TextureUpload" );
 	
 	try
 	{
@@ -1057,23 +1065,28 @@ GLuint	GLTextureLoader( TQ3TextureObject inTexture,
 
 		TQ3ObjectType	theType = Q3Texture_GetType( inTexture );
 		bool	didLoad = false;
+		TQ3Uns32	uploadBytes = 0;
 		
 		switch (theType)
 		{
 			case kQ3TextureTypePixmap:
 				didLoad = LoadOpenGLWithPixmapTexture( inTexture,
 					inPremultiplyAlpha == kQ3True,
-					inFuncs );
+					inFuncs, uploadBytes );
 				break;
 			
 			case kQ3TextureTypeMipmap:
 				didLoad = LoadOpenGLWithMipmapTexture( inTexture,
-					inPremultiplyAlpha == kQ3True );
+					inPremultiplyAlpha == kQ3True, uploadBytes );
 				break;
 		}
 		
 		if (didLoad)
 		{
+			if (inView != nullptr)
+			{
+				Q3XView_RecordUpload( inView, kQ3XViewUploadTypeTexture, uploadBytes );
+			}
 			MaybeCallBackAfterUpload( inTexture );
 			resultTextureName = textureName;
 		}
@@ -70,11 +70,15 @@ namespace QORenderer
 									texture data has an alpha channel and is NOT
 									set up with premultiplied alpha.
 	@param		inFuncs				OpenGL function pointers.
+	@param		inView				The view being rendered, or nullptr.  If
+									not nullptr, the upload is recorded in the
+									view's frame statistics.
 	@result		An OpenGL texture "name", or 0 on failure.
 */
 GLuint	GLTextureLoader( TQ3TextureObject inTexture,
 						TQ3Boolean inPremultiplyAlpha,
-						const QORenderer::GLFuncs& inFuncs );
+						const QORenderer::GLFuncs& inFuncs,
+						TQ3ViewObject inView );
 
 
 
@@ -1025,6 +1025,12 @@ void				AddVBOToCache(
 			inNumIndices * sizeof(TQ3Uns32), dataAddr, GL_STATIC_DRAW );
 		(*inRenderer.Funcs().glBindBufferProc)( GL_ELEMENT_ARRAY_BUFFER, 0 );
 		RecordVBO( newVBO->mGLBufferNames[1], inGeom, inNumIndices * sizeof(TQ3Uns32), 0 );
+		
+		if (inRenderer.GetView() != nullptr)
+		{
+			Q3XView_RecordUpload( inRenderer.GetView(), kQ3XViewUploadTypeBuffer,
+				newVBO->mBufferBytes );
+		}
 	}
 }
 
@@ -181,6 +181,7 @@ void	QORenderer::GLFuncs::InitializeForBufferDelete()
 QORenderer::Renderer::Renderer( TQ3RendererObject inRenderer )
 	: mRendererObject( inRenderer )
 	, mDrawContextObject( nullptr )
+	, mViewObject( nullptr )
 	, mGLContext( nullptr )
 	, mCleanup( mGLContext )
 	, mSLFuncs()
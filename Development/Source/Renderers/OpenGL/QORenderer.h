@@ -273,6 +273,7 @@ public:
 	bool&					IsCachingShadows() { return mIsCachingShadows; }
 	ClientStates&			GetClientStates() { return mGLClientStates; }
 	TQ3RendererObject		GetQuesaRenderer() const { return mRendererObject; }
+	TQ3ViewObject			GetView() const { return mViewObject; }
 	float					LineWidth() const { return mLineWidth; }
 	
 	void					RefreshMaterials();
@@ -431,6 +432,7 @@ protected:
 	
 	TQ3RendererObject		mRendererObject;
 	TQ3DrawContextObject	mDrawContextObject;
+	TQ3ViewObject			mViewObject;		// view being rendered, or nullptr between frames
 	TQ3GLContext			mGLContext;
 	GLContextCleanup		mCleanup;
 	GLSLFuncs				mSLFuncs;
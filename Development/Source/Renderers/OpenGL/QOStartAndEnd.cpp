@@ -119,6 +119,9 @@ TQ3Status	QORenderer::Renderer::StartFrame(
 	// Save draw context for access from StartPass
 	mDrawContextObject = inDrawContext;
 	
+	// Save the view so that uploads can be recorded in its frame statistics
+	mViewObject = inView;
+	
 	// Update draw context validation flags
 	TQ3XDrawContextValidation		drawContextFlags;
 	Q3XDrawContext_GetValidationFlags( inDrawContext, &drawContextFlags );
@@ -534,5 +537,10 @@ TQ3ViewStatus		QORenderer::Renderer::EndPass(
 	Q3Object_SetProperty( mRendererObject, kQ3RendererPropertyPrimitivesRenderedCount,
 		sizeof(TQ3Uns64), &mNumPrimitivesRenderedInFrame );
 	
+	if (allDone == kQ3ViewStatusDone)
+	{
+		mViewObject = nullptr;
+	}
+	
 	return allDone;
 }
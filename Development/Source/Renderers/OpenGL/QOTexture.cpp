@@ -352,7 +352,8 @@ TQ3CachedTexturePtr		Texture::CacheTexture( TQ3TextureObject inTexture )
 	Q3Object_GetProperty( mRenderer.GetQuesaRenderer(), kQ3RendererPropertyConvertToPremultipliedAlpha,
 		sizeof(convertAlpha), nullptr, &convertAlpha );
 	
-	GLuint	textureName = GLTextureLoader( inTexture, convertAlpha, mRenderer.Funcs() );
+	GLuint	textureName = GLTextureLoader( inTexture, convertAlpha, mRenderer.Funcs(),
+		mRenderer.GetView() );
 	
 	if (textureName != 0)
 	{
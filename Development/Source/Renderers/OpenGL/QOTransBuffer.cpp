@@ -48,6 +48,7 @@
 #include "GLUtils.h"
 #include "E3Math.h"
 #include "E3Math_Intersect.h"
+#include "E3Trace.h"
 #include "GLImmediateVBO.h"
 #include "E3View.h"
 #include "QOGLShadingLanguage.h"
@@ -874,6 +875,7 @@ void	TransBuffer::SortIndices()
 {
 	if (mIsSortNeeded)
 	{
+		Q3_TRACE_SCOPE( "TransBufferSort" );
 		//Q3_LOG_FMT( "TransBuffer::SortIndices 1" );
 		SortBlocks();
 		//Q3_LOG_FMT( "TransBuffer::SortIndices 2" );
@@ -0,0 +1,362 @@
+/*
+ *  AttributeSets.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaExtension.h>
+#include <QuesaSet.h>
+
+#include <algorithm>
+
+namespace
+{
+	const TQ3ColorRGB	kRed = { 1.0f, 0.0f, 0.0f };
+	const TQ3ColorRGB	kBlue = { 0.0f, 0.0f, 1.0f };
+	const TQ3ColorRGB	kWhite = { 1.0f, 1.0f, 1.0f };
+	
+	/*!
+		@function	InheritingMetaHandler
+		
+		@abstract	Metahandler of a custom attribute which is inherited.
+	*/
+	TQ3XFunctionPointer InheritingMetaHandler( TQ3XMethodType inMethodType )
+	{
+		TQ3XFunctionPointer	theMethod = NULL;
+		
+		if (inMethodType == kQ3XMethodTypeAttributeInherit)
+		{
+			theMethod = (TQ3XFunctionPointer) kQ3True;
+		}
+		
+		return theMethod;
+	}
+	
+	/*!
+		@function	PlainMetaHandler
+		
+		@abstract	Metahandler of a custom attribute which is not inherited.
+	*/
+	TQ3XFunctionPointer PlainMetaHandler( TQ3XMethodType inMethodType )
+	{
+		(void) inMethodType;
+		return NULL;
+	}
+	
+	/*!
+		@struct		AttributeTypes
+		
+		@abstract	The custom attribute types used by the tests.
+	*/
+	struct AttributeTypes
+	{
+		TQ3AttributeType	inheriting;
+		TQ3AttributeType	plain;
+	};
+	
+	/*!
+		@function	SameColor
+	*/
+	bool SameColor( const TQ3ColorRGB& inA, const TQ3ColorRGB& inB )
+	{
+		return (inA.r == inB.r) && (inA.g == inB.g) && (inA.b == inB.b);
+	}
+	
+	/*!
+		@function	ListTypes
+		
+		@abstract	Get the sorted attribute types of a set.
+	*/
+	std::vector<TQ3AttributeType> ListTypes( TQ3AttributeSet inSet )
+	{
+		std::vector<TQ3AttributeType>	theTypes;
+		TQ3AttributeType	theType = kQ3AttributeTypeNone;
+		
+		while ( (Q3AttributeSet_GetNextAttributeType( inSet, &theType ) == kQ3Success) &&
+			(theType != kQ3AttributeTypeNone) )
+		{
+			theTypes.push_back( theType );
+		}
+		
+		std::sort( theTypes.begin(), theTypes.end() );
+		return theTypes;
+	}
+	
+	/*!
+		@function	CheckSet
+		
+		@abstract	Check that a set holds exactly the given attribute types,
+					that its mask agrees, and that the diffuse color and
+					custom attributes it holds have the expected values.
+					A custom value of 0 means the attribute is absent.
+	*/
+	bool CheckSet( TQ3AttributeSet inSet, const char* inLabel,
+					std::vector<TQ3AttributeType> inTypes,
+					const TQ3ColorRGB& inDiffuse,
+					const AttributeTypes& inCustom,
+					TQ3Uns32 inInheritingValue, TQ3Uns32 inPlainValue,
+					std::ostream& outLog )
+	{
+		TQ3XAttributeMask	expectedMask = kQ3XAttributeMaskNone;
+		bool				success = true;
+		
+		for (size_t i = 0; i < inTypes.size(); ++i)
+		{
+			if ( (inTypes[i] > kQ3AttributeTypeNone) && (inTypes[i] < kQ3AttributeTypeNumTypes) )
+			{
+				expectedMask |= (TQ3XAttributeMask) (1 << (inTypes[i] - 1));
+			}
+			else
+			{
+				expectedMask |= kQ3XAttributeMaskCustomAttribute;
+			}
+		}
+		
+		std::sort( inTypes.begin(), inTypes.end() );
+		if (ListTypes( inSet ) != inTypes)
+		{
+			outLog << inLabel << ": the set holds the wrong attribute types.\n";
+			success = false;
+		}
+		
+		if (Q3XAttributeSet_GetMask( inSet ) != expectedMask)
+		{
+			outLog << inLabel << ": the set has the wrong mask.\n";
+			success = false;
+		}
+		
+		TQ3ColorRGB	theColor;
+		if ( (Q3AttributeSet_Contains( inSet, kQ3AttributeTypeDiffuseColor ) == kQ3True) &&
+			( (Q3AttributeSet_Get( inSet, kQ3AttributeTypeDiffuseColor, &theColor ) != kQ3Success) ||
+			(! SameColor( theColor, inDiffuse )) ) )
+		{
+			outLog << inLabel << ": the diffuse color is wrong.\n";
+			success = false;
+		}
+		
+		const TQ3AttributeType	customTypes[] = { inCustom.inheriting, inCustom.plain };
+		const TQ3Uns32			customValues[] = { inInheritingValue, inPlainValue };
+		for (int i = 0; i < 2; ++i)
+		{
+			TQ3Uns32	theValue = 0;
+			
+			if (Q3AttributeSet_Contains( inSet, customTypes[i] ) == kQ3True)
+			{
+				Q3AttributeSet_Get( inSet, customTypes[i], &theValue );
+			}
+			
+			if (theValue != customValues[i])
+			{
+				outLog << inLabel << ": the " << (i == 0 ? "inheriting" : "plain")
+					<< " custom attribute is " << theValue << ", not "
+					<< customValues[i] << ".\n";
+				success = false;
+			}
+		}
+		
+		return success;
+	}
+	
+	/*!
+		@function	TestAddAndClear
+		
+		@abstract	Add built-in and custom attributes, replace one, then
+					remove them again.
+	*/
+	bool TestAddAndClear( const AttributeTypes& inCustom, std::ostream& outLog )
+	{
+		CQ3ObjectRef	theSet( Q3AttributeSet_New() );
+		TQ3Vector3D		theNormal = { 0.0f, 0.0f, 1.0f };
+		TQ3Uns32		inheritingValue = 1;
+		TQ3Uns32		plainValue = 2;
+		bool			success = theSet.isvalid();
+		
+		if (success)
+		{
+			Q3AttributeSet_Add( theSet.get(), kQ3AttributeTypeDiffuseColor, &kRed );
+			Q3AttributeSet_Add( theSet.get(), kQ3AttributeTypeNormal, &theNormal );
+			Q3AttributeSet_Add( theSet.get(), inCustom.inheriting, &inheritingValue );
+			Q3AttributeSet_Add( theSet.get(), inCustom.plain, &plainValue );
+			Q3AttributeSet_Add( theSet.get(), kQ3AttributeTypeDiffuseColor, &kBlue );
+			
+			success = CheckSet( theSet.get(), "Add",
+				{ kQ3AttributeTypeDiffuseColor, kQ3AttributeTypeNormal,
+				inCustom.inheriting, inCustom.plain },
+				kBlue, inCustom, 1, 2, outLog );
+		}
+		
+		if (success)
+		{
+			Q3AttributeSet_Clear( theSet.get(), kQ3AttributeTypeNormal );
+			Q3AttributeSet_Clear( theSet.get(), inCustom.inheriting );
+			
+			success = CheckSet( theSet.get(), "Clear",
+				{ kQ3AttributeTypeDiffuseColor, inCustom.plain },
+				kBlue, inCustom, 0, 2, outLog );
+		}
+		
+		if (success)
+		{
+			Q3AttributeSet_Clear( theSet.get(), inCustom.plain );
+			
+			success = CheckSet( theSet.get(), "Clear last custom",
+				{ kQ3AttributeTypeDiffuseColor },
+				kBlue, inCustom, 0, 0, outLog );
+		}
+		
+		if (success)
+		{
+			Q3AttributeSet_Add( theSet.get(), inCustom.plain, &plainValue );
+			Q3AttributeSet_Empty( theSet.get() );
+			
+			success = CheckSet( theSet.get(), "Empty", {},
+				kBlue, inCustom, 0, 0, outLog );
+		}
+		
+		return success;
+	}
+	
+	/*!
+		@function	TestInherit
+		
+		@abstract	Inherit into a new set, into the child and into the
+					parent.  The child's attributes always win, and the
+					parent only adds the attributes the child lacks, other
+					than custom attributes which are not inherited.
+	*/
+	bool TestInherit( const AttributeTypes& inCustom, std::ostream& outLog )
+	{
+		CQ3ObjectRef	parentSet( Q3AttributeSet_New() );
+		CQ3ObjectRef	childSet( Q3AttributeSet_New() );
+		CQ3ObjectRef	resultSet( Q3AttributeSet_New() );
+		TQ3Uns32		parentInheriting = 1, parentPlain = 2;
+		TQ3Uns32		childInheriting = 3, childPlain = 4;
+		
+		if ( (! parentSet.isvalid()) || (! childSet.isvalid()) || (! resultSet.isvalid()) )
+		{
+			outLog << "Could not create the attribute sets.\n";
+			return false;
+		}
+		
+		Q3AttributeSet_Add( parentSet.get(), kQ3AttributeTypeDiffuseColor, &kRed );
+		Q3AttributeSet_Add( parentSet.get(), kQ3AttributeTypeSpecularColor, &kWhite );
+		Q3AttributeSet_Add( parentSet.get(), inCustom.inheriting, &parentInheriting );
+		Q3AttributeSet_Add( parentSet.get(), inCustom.plain, &parentPlain );
+		
+		Q3AttributeSet_Add( childSet.get(), kQ3AttributeTypeDiffuseColor, &kBlue );
+		
+		
+		// The parent's inheriting attribute fills in for the child
+		bool	success = (Q3AttributeSet_Inherit( parentSet.get(), childSet.get(),
+			resultSet.get() ) == kQ3Success) &&
+			CheckSet( resultSet.get(), "Inherit from parent",
+				{ kQ3AttributeTypeDiffuseColor, kQ3AttributeTypeSpecularColor,
+				inCustom.inheriting },
+				kBlue, inCustom, 1, 0, outLog );
+		
+		
+		// The child's custom attributes are kept, whether inheriting or not
+		Q3AttributeSet_Add( childSet.get(), inCustom.inheriting, &childInheriting );
+		Q3AttributeSet_Add( childSet.get(), inCustom.plain, &childPlain );
+		
+		const std::vector<TQ3AttributeType>	allTypes = { kQ3AttributeTypeDiffuseColor,
+			kQ3AttributeTypeSpecularColor, inCustom.inheriting, inCustom.plain };
+		
+		success = success && (Q3AttributeSet_Inherit( parentSet.get(), childSet.get(),
+			resultSet.get() ) == kQ3Success) &&
+			CheckSet( resultSet.get(), "Inherit into result", allTypes,
+				kBlue, inCustom, 3, 4, outLog );
+		
+		
+		// Inheriting in place gives the same result
+		CQ3ObjectRef	childCopy( Q3Object_Duplicate( childSet.get() ) );
+		success = success && childCopy.isvalid() &&
+			(Q3AttributeSet_Inherit( parentSet.get(), childCopy.get(),
+			childCopy.get() ) == kQ3Success) &&
+			CheckSet( childCopy.get(), "Inherit into child", allTypes,
+				kBlue, inCustom, 3, 4, outLog );
+		
+		CQ3ObjectRef	parentCopy( Q3Object_Duplicate( parentSet.get() ) );
+		success = success && parentCopy.isvalid() &&
+			(Q3AttributeSet_Inherit( parentCopy.get(), childSet.get(),
+			parentCopy.get() ) == kQ3Success) &&
+			CheckSet( parentCopy.get(), "Inherit into parent", allTypes,
+				kBlue, inCustom, 3, 4, outLog );
+		
+		
+		// The sources are unchanged
+		success = success &&
+			CheckSet( parentSet.get(), "Parent after Inherit",
+				{ kQ3AttributeTypeDiffuseColor, kQ3AttributeTypeSpecularColor,
+				inCustom.inheriting, inCustom.plain },
+				kRed, inCustom, 1, 2, outLog ) &&
+			CheckSet( childSet.get(), "Child after Inherit",
+				{ kQ3AttributeTypeDiffuseColor, inCustom.inheriting, inCustom.plain },
+				kBlue, inCustom, 3, 4, outLog );
+		
+		return success;
+	}
+}
+
+/*!
+	@function	TestAttributeSets
+	
+	@abstract	Check adding, replacing, removing and inheriting built-in
+				and custom attributes.
+*/
+bool TestAttributeSets( const char* inModelsPath, std::ostream& outLog )
+{
+	(void) inModelsPath;
+	
+	AttributeTypes	theTypes;
+	TQ3XObjectClass	inheritingClass = Q3XAttributeClass_Register( &theTypes.inheriting,
+		"QuesaTests:InheritingAttribute", sizeof(TQ3Uns32), InheritingMetaHandler );
+	TQ3XObjectClass	plainClass = Q3XAttributeClass_Register( &theTypes.plain,
+		"QuesaTests:PlainAttribute", sizeof(TQ3Uns32), PlainMetaHandler );
+	bool			success = (inheritingClass != NULL) && (plainClass != NULL);
+	
+	if (! success)
+	{
+		outLog << "Could not register the custom attributes.\n";
+	}
+	else
+	{
+		bool	addOK = TestAddAndClear( theTypes, outLog );
+		bool	inheritOK = TestInherit( theTypes, outLog );
+		success = addOK && inheritOK;
+	}
+	
+	if (inheritingClass != NULL)
+	{
+		Q3XObjectHierarchy_UnregisterClass( inheritingClass );
+	}
+	
+	if (plainClass != NULL)
+	{
+		Q3XObjectHierarchy_UnregisterClass( plainClass );
+	}
+	
+	return success;
+}
@@ -0,0 +1,151 @@
+/*
+ *  CompressedStorage.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaStorage.h>
+
+#include <cstring>
+
+namespace
+{
+	const TQ3Uns32	kBlockSize = 4 * 1024;
+	const TQ3Uns32	kDataSize = 50 * kBlockSize + 123;
+	
+	/*!
+		@function	MakeData
+		
+		@abstract	Make data which compresses, but not into runs, with a
+					stretch of zeros which is left unwritten.
+	*/
+	void MakeData( std::vector<TQ3Uns8>& outData )
+	{
+		TQ3Uns32	seed = 12345;
+		outData.resize( kDataSize );
+		
+		for (TQ3Uns32 i = 0; i < kDataSize; ++i)
+		{
+			seed = seed * 1103515245 + 12345;
+			outData[i] = (TQ3Uns8) ("QuesaQuesaQuesa!"[ i % 16 ] + ((seed >> 16) & 3));
+		}
+		
+		std::memset( &outData[ 20 * kBlockSize ], 0, 3 * kBlockSize );
+	}
+	
+	/*!
+		@function	ReadAndCompare
+		
+		@abstract	Read part of a storage and compare it with the data.
+	*/
+	bool ReadAndCompare( TQ3StorageObject inStorage, const std::vector<TQ3Uns8>& inData,
+						TQ3Uns32 inOffset, TQ3Uns32 inSize, std::ostream& outLog )
+	{
+		std::vector<TQ3Uns8>	theBuffer( inSize + 1 );
+		TQ3Uns32	sizeRead = 0;
+		
+		if ( (Q3Storage_GetData( inStorage, inOffset, inSize, &theBuffer[0], &sizeRead ) != kQ3Success) ||
+			(sizeRead != inSize) ||
+			(std::memcmp( &theBuffer[0], &inData[ inOffset ], inSize ) != 0) )
+		{
+			outLog << "Wrong data read at offset " << inOffset << ".\n";
+			return false;
+		}
+		
+		return true;
+	}
+}
+
+/*!
+	@function	TestCompressedStorage
+	
+	@abstract	Write data through a compressed storage, then read it back
+				sequentially, which expands blocks on the worker thread, and
+				then out of order.
+*/
+bool TestCompressedStorage( const char* inModelsPath, std::ostream& outLog )
+{
+	(void) inModelsPath;
+	
+	std::vector<TQ3Uns8>	theData;
+	MakeData( theData );
+	
+	CQ3ObjectRef	memStorage( Q3MemoryStorage_New( NULL, 0 ) );
+	CQ3ObjectRef	theStorage( memStorage.isvalid()?
+		Q3CompressedStorage_New( memStorage.get(), kBlockSize ) : NULL );
+	if (! theStorage.isvalid())
+	{
+		outLog << "Could not create the storage.\n";
+		return false;
+	}
+	
+	
+	// Write the data in pieces which straddle blocks, skipping the zeros
+	TQ3Uns32	sizeWritten = 0;
+	bool	success = (Q3Storage_Open( theStorage.get(), kQ3True ) == kQ3Success);
+	for (TQ3Uns32 offset = 0; success && (offset < kDataSize); offset += 1000)
+	{
+		TQ3Uns32	pieceSize = (kDataSize - offset < 1000)? kDataSize - offset : 1000;
+		if ( (offset >= 20 * kBlockSize) && (offset + pieceSize <= 23 * kBlockSize) )
+		{
+			continue;
+		}
+		success = (Q3Storage_SetData( theStorage.get(), offset, pieceSize,
+			&theData[ offset ], &sizeWritten ) == kQ3Success);
+	}
+	if (Q3Storage_Close( theStorage.get() ) != kQ3Success)
+	{
+		success = false;
+	}
+	if (! success)
+	{
+		outLog << "Could not write the storage.\n";
+		return false;
+	}
+	
+	
+	// Read it back
+	if (Q3Storage_Open( theStorage.get(), kQ3False ) != kQ3Success)
+	{
+		outLog << "Could not open the storage for reading.\n";
+		return false;
+	}
+	
+	for (TQ3Uns32 offset = 0; success && (offset < kDataSize); offset += 777)
+	{
+		success = ReadAndCompare( theStorage.get(), theData, offset,
+			(kDataSize - offset < 777)? kDataSize - offset : 777, outLog );
+	}
+	
+	for (TQ3Uns32 i = 0; success && (i < 50); ++i)
+	{
+		TQ3Uns32	offset = (i * 7919 * 13) % (kDataSize - 5000);
+		success = ReadAndCompare( theStorage.get(), theData, offset, 5000, outLog );
+	}
+	
+	Q3Storage_Close( theStorage.get() );
+	
+	return success;
+}
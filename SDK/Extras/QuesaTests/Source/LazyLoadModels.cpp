@@ -0,0 +1,280 @@
+/*
+ *  LazyLoadModels.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaIO.h>
+#include <QuesaView.h>
+
+#include <dirent.h>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+namespace
+{
+	// Small enough that reading and drawing a model evicts geometries
+	const uint64_t	kLazyBudget = 4096;
+	
+	/*!
+		@function	FindModels
+		
+		@abstract	Find the 3DMF files in a folder and its subfolders.
+		@param		inModelsPath	Path of the folder of sample 3DMF models.
+		@param		inSubPath		Path of the folder to search within that
+									folder, or an empty string.
+		@param		outNames		Receives the paths of the files within
+									the models folder.
+	*/
+	void FindModels( const std::string& inModelsPath, const std::string& inSubPath,
+					std::vector<std::string>& outNames )
+	{
+		std::string	thePath( inSubPath.empty()? inModelsPath : inModelsPath + "/" + inSubPath );
+		DIR*	theDir = opendir( thePath.c_str() );
+		if (theDir == NULL)
+		{
+			return;
+		}
+		
+		struct dirent*	theEntry;
+		while ( (theEntry = readdir( theDir )) != NULL )
+		{
+			std::string	theName( theEntry->d_name );
+			if (theName[0] == '.')
+			{
+				continue;
+			}
+			
+			std::string	theSubPath( inSubPath.empty()? theName : inSubPath + "/" + theName );
+			DIR*	subDir = opendir( (inModelsPath + "/" + theSubPath).c_str() );
+			if (subDir != NULL)
+			{
+				closedir( subDir );
+				FindModels( inModelsPath, theSubPath, outNames );
+			}
+			else if ( (theName.size() > 5) &&
+				(strcasecmp( theName.c_str() + theName.size() - 5, ".3dmf" ) == 0) )
+			{
+				outNames.push_back( theSubPath );
+			}
+		}
+		
+		closedir( theDir );
+	}
+	
+	/*!
+		@function	ReadObjectsLazily
+		
+		@abstract	Read the top level objects of a 3DMF storage with a lazy
+					load budget.
+		@result		True if the storage could be read.
+	*/
+	bool ReadObjectsLazily( TQ3StorageObject inStorage, std::vector<CQ3ObjectRef>& outObjects )
+	{
+		CQ3ObjectRef	theFile( Q3File_New() );
+		TQ3FileMode		theMode = 0;
+		uint64_t		theBudget = kLazyBudget;
+		
+		outObjects.clear();
+		if (! theFile.isvalid())
+		{
+			return false;
+		}
+		
+		Q3File_SetStorage( theFile.get(), inStorage );
+		Q3Object_SetProperty( theFile.get(), kQ3FilePropertyLazyLoadBudget,
+			sizeof(theBudget), &theBudget );
+		if (Q3File_OpenRead( theFile.get(), &theMode ) != kQ3Success)
+		{
+			return false;
+		}
+		
+		while (Q3File_IsEndOfFile( theFile.get() ) == kQ3False)
+		{
+			CQ3ObjectRef	theObject( Q3File_ReadObject( theFile.get() ) );
+			if (theObject.isvalid())
+			{
+				outObjects.push_back( theObject );
+			}
+		}
+		
+		return (Q3File_Close( theFile.get() ) == kQ3Success);
+	}
+	
+	/*!
+		@function	GetBounds
+		
+		@abstract	Get the exact bounds of some objects in a view.
+	*/
+	TQ3BoundingBox GetBounds( TQ3ViewObject inView, const std::vector<CQ3ObjectRef>& inObjects )
+	{
+		TQ3BoundingBox	theBounds;
+		theBounds.isEmpty = kQ3True;
+		
+		if (Q3View_StartBoundingBox( inView, kQ3ComputeBoundsExact ) == kQ3Success)
+		{
+			do
+			{
+				for (size_t i = 0; i < inObjects.size(); ++i)
+				{
+					Q3Object_Submit( inObjects[i].get(), inView );
+				}
+			} while (Q3View_EndBoundingBox( inView, &theBounds ) == kQ3ViewStatusRetraverse);
+		}
+		
+		return theBounds;
+	}
+	
+	/*!
+		@function	Contains
+		
+		@abstract	Check whether one bounding box contains another, allowing
+					for rounding.
+	*/
+	bool Contains( const TQ3BoundingBox& inOuter, const TQ3BoundingBox& inInner )
+	{
+		if (inInner.isEmpty)
+		{
+			return true;
+		}
+		if (inOuter.isEmpty)
+		{
+			return false;
+		}
+		
+		const float*	outerMin = &inOuter.min.x;
+		const float*	outerMax = &inOuter.max.x;
+		const float*	innerMin = &inInner.min.x;
+		const float*	innerMax = &inInner.max.x;
+		
+		for (int i = 0; i < 3; ++i)
+		{
+			float	slop = 1.0e-4f + 1.0e-3f * std::fabs( innerMax[i] - innerMin[i] );
+			if ( (innerMin[i] < outerMin[i] - slop) || (innerMax[i] > outerMax[i] + slop) )
+			{
+				return false;
+			}
+		}
+		
+		return true;
+	}
+	
+	/*!
+		@function	RenderObjects
+		
+		@abstract	Render some objects, which makes lazy geometries load.
+	*/
+	void RenderObjects( TQ3ViewObject inView, const std::vector<CQ3ObjectRef>& inObjects )
+	{
+		if (Q3View_StartRendering( inView ) == kQ3Success)
+		{
+			do
+			{
+				for (size_t i = 0; i < inObjects.size(); ++i)
+				{
+					Q3Object_Submit( inObjects[i].get(), inView );
+				}
+			} while (Q3View_EndRendering( inView ) == kQ3ViewStatusRetraverse);
+		}
+	}
+}
+
+/*!
+	@function	TestLazyLoadModels
+	
+	@abstract	Read each of the sample models as binary 3DMF with a lazy load
+				budget, and check that it has the same top level objects as
+				when read in full, that its bounds cover the full model's
+				bounds, and that it can be drawn.
+*/
+bool TestLazyLoadModels( const char* inModelsPath, std::ostream& outLog )
+{
+	std::vector<std::string>	theNames;
+	FindModels( inModelsPath, std::string(), theNames );
+	if (theNames.empty())
+	{
+		outLog << "Found no models in " << inModelsPath << ".\n";
+		return false;
+	}
+	
+	std::vector<TQ3Uns32>	thePixels;
+	CQ3ObjectRef	theView( NewPixmapView( thePixels ) );
+	if (! theView.isvalid())
+	{
+		outLog << "Could not create a view.\n";
+		return false;
+	}
+	
+	bool	success = true;
+	for (size_t i = 0; i < theNames.size(); ++i)
+	{
+		const char*		theName = theNames[i].c_str();
+		CQ3ObjectRef	theModel( ReadModel( inModelsPath, theName ) );
+		std::vector<CQ3ObjectRef>	fullObjects, lazyObjects;
+		
+		if ( (! theModel.isvalid()) || (! ReadObjects( theModel.get(), fullObjects )) ||
+			fullObjects.empty() )
+		{
+			continue;
+		}
+		
+		
+		// The samples are text 3DMF, which is always read in full, so
+		// convert them to binary
+		std::vector<TQ3Object>	rawObjects;
+		for (size_t j = 0; j < fullObjects.size(); ++j)
+		{
+			rawObjects.push_back( fullObjects[j].get() );
+		}
+		
+		CQ3ObjectRef	binaryModel( WriteObjects( rawObjects, 0 ) );
+		if ( (! binaryModel.isvalid()) || (! ReadObjects( binaryModel.get(), fullObjects )) )
+		{
+			outLog << "Could not convert " << theName << " to binary.\n";
+			success = false;
+			continue;
+		}
+		
+		if ( (! ReadObjectsLazily( binaryModel.get(), lazyObjects )) ||
+			(lazyObjects.size() != fullObjects.size()) )
+		{
+			outLog << theName << " read " << lazyObjects.size() << " objects lazily, not "
+				<< fullObjects.size() << ".\n";
+			success = false;
+			continue;
+		}
+		
+		if (! Contains( GetBounds( theView.get(), lazyObjects ), GetBounds( theView.get(), fullObjects ) ))
+		{
+			outLog << theName << " has smaller bounds when read lazily.\n";
+			success = false;
+		}
+		
+		RenderObjects( theView.get(), lazyObjects );
+	}
+	
+	return success;
+}
@@ -0,0 +1,190 @@
+/*
+ *  PackedTriMesh.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaGeometry.h>
+#include <QuesaIO.h>
+#include <QuesaMath.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+	const int	kNumReads = 20;
+	
+	/*!
+		@function	NewSphereMesh
+		
+		@abstract	Create a UV sphere TriMesh.
+		@param		inNumSteps	The number of steps around and along the
+								sphere.
+		@param		inWithAttributes	Whether to give the vertices normals
+								and UVs.
+	*/
+	TQ3GeometryObject NewSphereMesh( TQ3Uns32 inNumSteps, bool inWithAttributes )
+	{
+		const TQ3Uns32	numRows = inNumSteps + 1;
+		std::vector<TQ3Point3D>		thePoints( numRows * numRows );
+		std::vector<TQ3Vector3D>	theNormals( thePoints.size() );
+		std::vector<TQ3Param2D>		theUVs( thePoints.size() );
+		std::vector<TQ3TriMeshTriangleData>	theTriangles;
+		
+		for (TQ3Uns32 row = 0; row < numRows; ++row)
+		{
+			for (TQ3Uns32 col = 0; col < numRows; ++col)
+			{
+				TQ3Uns32	n = row * numRows + col;
+				float	u = (float) col / inNumSteps;
+				float	v = (float) row / inNumSteps;
+				float	theta = u * 6.2831853f;
+				float	phi = v * 3.1415927f;
+				
+				theNormals[n].x = std::sin( phi ) * std::cos( theta );
+				theNormals[n].y = std::cos( phi );
+				theNormals[n].z = std::sin( phi ) * std::sin( theta );
+				thePoints[n].x = 10.0f * theNormals[n].x;
+				thePoints[n].y = 10.0f * theNormals[n].y;
+				thePoints[n].z = 10.0f * theNormals[n].z;
+				theUVs[n].u = u;
+				theUVs[n].v = v;
+				
+				if ( (row < inNumSteps) && (col < inNumSteps) )
+				{
+					TQ3TriMeshTriangleData	tri1 = { { n, n + numRows, n + 1 } };
+					TQ3TriMeshTriangleData	tri2 = { { n + 1, n + numRows, n + numRows + 1 } };
+					theTriangles.push_back( tri1 );
+					theTriangles.push_back( tri2 );
+				}
+			}
+		}
+		
+		TQ3TriMeshAttributeData	vertexAtts[2] =
+		{
+			{ kQ3AttributeTypeNormal, &theNormals[0], NULL },
+			{ kQ3AttributeTypeSurfaceUV, &theUVs[0], NULL }
+		};
+		TQ3TriMeshData	meshData;
+		meshData.triMeshAttributeSet = NULL;
+		meshData.numTriangles = (TQ3Uns32) theTriangles.size();
+		meshData.triangles = &theTriangles[0];
+		meshData.numTriangleAttributeTypes = 0;
+		meshData.triangleAttributeTypes = NULL;
+		meshData.numEdges = 0;
+		meshData.edges = NULL;
+		meshData.numEdgeAttributeTypes = 0;
+		meshData.edgeAttributeTypes = NULL;
+		meshData.numPoints = (TQ3Uns32) thePoints.size();
+		meshData.points = &thePoints[0];
+		meshData.numVertexAttributeTypes = inWithAttributes? 2 : 0;
+		meshData.vertexAttributeTypes = vertexAtts;
+		Q3BoundingBox_SetFromPoints3D( &meshData.bBox, &thePoints[0],
+			meshData.numPoints, sizeof(TQ3Point3D) );
+		
+		return Q3TriMesh_New( &meshData );
+	}
+	
+	/*!
+		@function	TimeReads
+		
+		@abstract	Time reading a storage back.
+		@result		Milliseconds per read, or a negative number on failure.
+	*/
+	double TimeReads( TQ3StorageObject inStorage )
+	{
+		std::vector<CQ3ObjectRef>	theObjects;
+		auto startTime = std::chrono::steady_clock::now();
+		
+		for (int i = 0; i < kNumReads; ++i)
+		{
+			if ( (! ReadObjects( inStorage, theObjects )) || (theObjects.size() != 1) )
+			{
+				return -1.0;
+			}
+		}
+		
+		std::chrono::duration<double, std::milli> elapsed =
+			std::chrono::steady_clock::now() - startTime;
+		
+		return elapsed.count() / kNumReads;
+	}
+}
+
+/*!
+	@function	BenchmarkPackedTriMesh
+	
+	@abstract	Compare the file size and read time of TriMeshes written in
+				the raw and packed forms, for a large mesh and for one small
+				enough that the writer should keep the raw form.
+*/
+bool BenchmarkPackedTriMesh( const char* inModelsPath, std::ostream& outLog )
+{
+	(void) inModelsPath;
+	
+	const TQ3Uns32	kSizes[] = { 256, 1 };
+	
+	for (TQ3Uns32 i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); ++i)
+	{
+		bool	withAttributes = (kSizes[i] > 1);
+		CQ3ObjectRef	theMesh( NewSphereMesh( kSizes[i], withAttributes ) );
+		std::vector<TQ3Object>	theObjects( 1, theMesh.get() );
+		CQ3ObjectRef	rawStorage( WriteObjects( theObjects, 0 ) );
+		CQ3ObjectRef	packedStorage( WriteObjects( theObjects,
+			kQ3FilePropertyPackGeometry ) );
+		if ( (! theMesh.isvalid()) || (! rawStorage.isvalid()) || (! packedStorage.isvalid()) )
+		{
+			outLog << "Could not write the mesh.\n";
+			return false;
+		}
+		
+		double	rawTime = TimeReads( rawStorage.get() );
+		double	packedTime = TimeReads( packedStorage.get() );
+		if ( (rawTime < 0.0) || (packedTime < 0.0) )
+		{
+			outLog << "Could not read the mesh back.\n";
+			return false;
+		}
+		
+		outLog << std::fixed << std::setprecision(3) <<
+			"Sphere of " << 2 * kSizes[i] * kSizes[i] << " triangles" <<
+			(withAttributes? " with normals and UVs: " : ": ") <<
+			"raw " << StorageSize( rawStorage.get() ) << " bytes, " <<
+			rawTime << " ms to read; packed " <<
+			StorageSize( packedStorage.get() ) << " bytes, " <<
+			packedTime << " ms to read\n";
+		
+		// A small mesh should not get larger
+		if (StorageSize( packedStorage.get() ) > StorageSize( rawStorage.get() ))
+		{
+			outLog << "Packing made the file larger.\n";
+			return false;
+		}
+	}
+	
+	return true;
+}
@@ -0,0 +1,62 @@
+/*
+ *  QuesaTests.h
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef QUESATESTS_HDR
+#define QUESATESTS_HDR
+
+#include <Quesa.h>
+#include <CQ3ObjectRef.h>
+
+#include <ostream>
+#include <vector>
+
+/*!
+	@typedef	TestFunc
+	
+	@abstract	A test or benchmark.
+	
+	@param		inModelsPath	Path of the folder of sample 3DMF models.
+	@param		outLog			Receives progress and failure messages.
+	@result		True if the test passed, or the benchmark ran.
+*/
+typedef bool (*TestFunc)( const char* inModelsPath, std::ostream& outLog );
+
+TQ3ViewObject NewPixmapView( std::vector<TQ3Uns32>& outPixels );
+TQ3StorageObject WriteObjects( const std::vector<TQ3Object>& inObjects,
+								TQ3ObjectType inProperty );
+bool ReadObjects( TQ3StorageObject inStorage, std::vector<CQ3ObjectRef>& outObjects );
+TQ3Uns32 StorageSize( TQ3StorageObject inStorage );
+TQ3StorageObject ReadModel( const char* inModelsPath, const char* inName );
+
+bool TestSubmitStatistics( const char* inModelsPath, std::ostream& outLog );
+bool TestCompressedStorage( const char* inModelsPath, std::ostream& outLog );
+bool TestTraceWrite( const char* inModelsPath, std::ostream& outLog );
+bool TestShareEqualObjects( const char* inModelsPath, std::ostream& outLog );
+bool TestLazyLoadModels( const char* inModelsPath, std::ostream& outLog );
+bool TestAttributeSets( const char* inModelsPath, std::ostream& outLog );
+bool BenchmarkImmediateSubmit( const char* inModelsPath, std::ostream& outLog );
+bool BenchmarkPackedTriMesh( const char* inModelsPath, std::ostream& outLog );
+
+#endif
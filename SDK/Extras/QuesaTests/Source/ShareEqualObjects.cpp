@@ -0,0 +1,203 @@
+/*
+ *  ShareEqualObjects.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaGeometry.h>
+#include <QuesaIO.h>
+#include <QuesaStorage.h>
+#include <QuesaView.h>
+
+namespace
+{
+	const TQ3Uns32	kNumVertices = 8;
+	
+	/*!
+		@function	NewPolyLine
+		
+		@abstract	Create a PolyLine, big enough to be worth sharing, whose
+					vertices lie at the given height.
+	*/
+	TQ3GeometryObject NewPolyLine( float inY )
+	{
+		TQ3Vertex3D		theVertices[ kNumVertices ];
+		
+		for (TQ3Uns32 i = 0; i < kNumVertices; ++i)
+		{
+			theVertices[i].point.x = (float) i;
+			theVertices[i].point.y = inY;
+			theVertices[i].point.z = 0.0f;
+			theVertices[i].attributeSet = NULL;
+		}
+		
+		TQ3PolyLineData		lineData = { kNumVertices, theVertices, NULL, NULL };
+		
+		return Q3PolyLine_New( &lineData );
+	}
+	
+	/*!
+		@function	LineHeight
+		
+		@abstract	Get the height of the first vertex of a PolyLine, or -1
+					if the object is not a PolyLine.
+	*/
+	float LineHeight( const CQ3ObjectRef& inObject )
+	{
+		TQ3Point3D	thePoint = { 0.0f, -1.0f, 0.0f };
+		
+		if (Q3Object_IsType( inObject.get(), kQ3GeometryTypePolyLine ))
+		{
+			Q3PolyLine_GetVertexPosition( inObject.get(), 0, &thePoint );
+		}
+		
+		return thePoint.y;
+	}
+	
+	/*!
+		@function	TestDisposedDuringWrite
+		
+		@abstract	Write two equal PolyLines and then a different one,
+					disposing the second before creating the third so that
+					the third is likely to reuse its address.  The third must
+					not be written as a reference to the first.
+	*/
+	bool TestDisposedDuringWrite( std::ostream& outLog )
+	{
+		CQ3ObjectRef	theStorage( Q3MemoryStorage_New( NULL, 0 ) );
+		CQ3ObjectRef	theFile( Q3File_New() );
+		CQ3ObjectRef	firstLine( NewPolyLine( 1.0f ) );
+		TQ3ViewObject	theView = Q3View_New();
+		TQ3Boolean		isOn = kQ3True;
+		bool			reusedAddress = false;
+		bool			success = theStorage.isvalid() && theFile.isvalid() &&
+									firstLine.isvalid() && (theView != NULL);
+		
+		if (success)
+		{
+			Q3File_SetStorage( theFile.get(), theStorage.get() );
+			Q3Object_SetProperty( theFile.get(), kQ3FilePropertyShareEqualObjects,
+				sizeof(isOn), &isOn );
+			success = (Q3File_OpenWrite( theFile.get(), kQ3FileModeNormal ) == kQ3Success) &&
+				(Q3View_StartWriting( theView, theFile.get() ) == kQ3Success);
+		}
+		
+		if (success)
+		{
+			do
+			{
+				Q3Object_Submit( firstLine.get(), theView );
+				
+				TQ3GeometryObject	secondLine = NewPolyLine( 1.0f );
+				Q3Object_Submit( secondLine, theView );
+				Q3Object_Dispose( secondLine );
+				
+				CQ3ObjectRef	thirdLine( NewPolyLine( 2.0f ) );
+				reusedAddress = (thirdLine.get() == secondLine);
+				Q3Object_Submit( thirdLine.get(), theView );
+			} while (Q3View_EndWriting( theView ) == kQ3ViewStatusRetraverse);
+			
+			success = (Q3File_Close( theFile.get() ) == kQ3Success);
+		}
+		
+		if (theView != NULL)
+		{
+			Q3Object_Dispose( theView );
+		}
+		
+		std::vector<CQ3ObjectRef>	theObjects;
+		if ( (! success) || (! ReadObjects( theStorage.get(), theObjects )) )
+		{
+			outLog << "Could not write and read back the PolyLines.\n";
+			return false;
+		}
+		
+		if ( (theObjects.size() != 3) || (LineHeight( theObjects[0] ) != 1.0f) ||
+			(LineHeight( theObjects[1] ) != 1.0f) || (LineHeight( theObjects[2] ) != 2.0f) )
+		{
+			outLog << "The PolyLines read back wrongly"
+				<< (reusedAddress? " after an address was reused.\n" : ".\n");
+			return false;
+		}
+		
+		return true;
+	}
+	
+	/*!
+		@function	TestSampleSize
+		
+		@abstract	Sharing objects whose references would cost more than the
+					objects themselves must not make a file bigger.
+	*/
+	bool TestSampleSize( const char* inModelsPath, std::ostream& outLog )
+	{
+		CQ3ObjectRef	theModel( ReadModel( inModelsPath, "Styles/WriteSwitchStyle.3dmf" ) );
+		std::vector<CQ3ObjectRef>	theObjects;
+		
+		if ( (! theModel.isvalid()) || (! ReadObjects( theModel.get(), theObjects )) )
+		{
+			outLog << "Could not read Styles/WriteSwitchStyle.3dmf.\n";
+			return false;
+		}
+		
+		std::vector<TQ3Object>	theRawObjects;
+		for (size_t i = 0; i < theObjects.size(); ++i)
+		{
+			theRawObjects.push_back( theObjects[i].get() );
+		}
+		
+		CQ3ObjectRef	plainStorage( WriteObjects( theRawObjects, 0 ) );
+		CQ3ObjectRef	sharedStorage( WriteObjects( theRawObjects,
+			kQ3FilePropertyShareEqualObjects ) );
+		if ( (! plainStorage.isvalid()) || (! sharedStorage.isvalid()) )
+		{
+			outLog << "Could not write Styles/WriteSwitchStyle.3dmf.\n";
+			return false;
+		}
+		
+		if (StorageSize( sharedStorage.get() ) > StorageSize( plainStorage.get() ))
+		{
+			outLog << "Sharing equal objects grew Styles/WriteSwitchStyle.3dmf from "
+				<< StorageSize( plainStorage.get() ) << " to "
+				<< StorageSize( sharedStorage.get() ) << " bytes.\n";
+			return false;
+		}
+		
+		return true;
+	}
+}
+
+/*!
+	@function	TestShareEqualObjects
+	
+	@abstract	Check writing binary 3DMF with kQ3FilePropertyShareEqualObjects.
+*/
+bool TestShareEqualObjects( const char* inModelsPath, std::ostream& outLog )
+{
+	bool	disposedOK = TestDisposedDuringWrite( outLog );
+	bool	sizeOK = TestSampleSize( inModelsPath, outLog );
+	
+	return disposedOK && sizeOK;
+}
@@ -0,0 +1,118 @@
+/*
+ *  SubmitBenchmark.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaGeometry.h>
+#include <QuesaStyle.h>
+#include <QuesaTransform.h>
+#include <QuesaView.h>
+
+#include <chrono>
+#include <iomanip>
+
+namespace
+{
+	const int	kNumSubmits = 1000000;
+	
+	/*!
+		@function	TimeSubmits
+		
+		@abstract	Time a loop of submits in a bounding box loop, which needs
+					no draw context or renderer, so that the time is spent in
+					submit dispatch rather than in drawing.
+		@result		Nanoseconds per submit.
+	*/
+	template <typename Submitter>
+	double TimeSubmits( TQ3ViewObject inView, const Submitter& inSubmit )
+	{
+		TQ3BoundingBox	bounds;
+		auto startTime = std::chrono::steady_clock::now();
+		
+		if (Q3View_StartBoundingBox( inView, kQ3ComputeBoundsApproximate ) == kQ3Success)
+		{
+			do
+			{
+				for (int i = 0; i < kNumSubmits; ++i)
+				{
+					inSubmit( inView );
+				}
+			} while (Q3View_EndBoundingBox( inView, &bounds ) == kQ3ViewStatusRetraverse);
+		}
+		
+		std::chrono::duration<double, std::nano> elapsed =
+			std::chrono::steady_clock::now() - startTime;
+		
+		return elapsed.count() / kNumSubmits;
+	}
+}
+
+/*!
+	@function	BenchmarkImmediateSubmit
+	
+	@abstract	Measure the cost of submitting geometries, transforms and
+				styles, which is dominated by looking up their class methods.
+*/
+bool BenchmarkImmediateSubmit( const char* inModelsPath, std::ostream& outLog )
+{
+	(void) inModelsPath;
+	
+	CQ3ObjectRef theView( Q3View_New() );
+	if (! theView.isvalid())
+	{
+		outLog << "Q3View_New failed.\n";
+		return false;
+	}
+	
+	TQ3TriangleData triData =
+	{
+		{
+			{ { 0.0f, 0.0f, 0.0f }, NULL },
+			{ { 1.0f, 0.0f, 0.0f }, NULL },
+			{ { 0.0f, 1.0f, 0.0f }, NULL }
+		},
+		NULL
+	};
+	CQ3ObjectRef theTriangle( Q3Triangle_New( &triData ) );
+	TQ3Vector3D	offset = { 1.0f, 2.0f, 3.0f };
+	
+	double triangleTime = TimeSubmits( theView.get(),
+		[&]( TQ3ViewObject inView ) { Q3Triangle_Submit( &triData, inView ); } );
+	double retainedTime = TimeSubmits( theView.get(),
+		[&]( TQ3ViewObject inView ) { Q3Object_Submit( theTriangle.get(), inView ); } );
+	double transformTime = TimeSubmits( theView.get(),
+		[&]( TQ3ViewObject inView ) { Q3TranslateTransform_Submit( &offset, inView ); } );
+	double styleTime = TimeSubmits( theView.get(),
+		[&]( TQ3ViewObject inView ) { Q3BackfacingStyle_Submit( kQ3BackfacingStyleRemove, inView ); } );
+	
+	outLog << std::fixed << std::setprecision(1) <<
+		"Nanoseconds per submit: immediate triangle " << triangleTime <<
+		", retained triangle " << retainedTime <<
+		", translate transform " << transformTime <<
+		", backfacing style " << styleTime << "\n";
+	
+	return true;
+}
@@ -0,0 +1,114 @@
+/*
+ *  SubmitStatistics.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaExtension.h>
+#include <QuesaGeometry.h>
+#include <QuesaView.h>
+
+#include <vector>
+
+/*!
+	@function	TestSubmitStatistics
+	
+	@abstract	Check that the frame statistics count immediate submits made
+				through both Q3Triangle_Submit and the resolved class fast path
+				Q3XView_SubmitImmediateClass.
+*/
+bool TestSubmitStatistics( const char* inModelsPath, std::ostream& outLog )
+{
+	(void) inModelsPath;
+	
+	std::vector<TQ3Uns32>	pixels;
+	CQ3ObjectRef theView( NewPixmapView( pixels ) );
+	TQ3XObjectClass theClass = Q3XObjectHierarchy_FindClassByType( kQ3GeometryTypeTriangle );
+	if ( (! theView.isvalid()) || (theClass == NULL) )
+	{
+		outLog << "Could not create the view.\n";
+		return false;
+	}
+	Q3View_SetFrameStatisticsState( theView.get(), kQ3True );
+	
+	TQ3TriangleData triData =
+	{
+		{
+			{ { 0.0f, 0.0f, 0.0f }, NULL },
+			{ { 1.0f, 0.0f, 0.0f }, NULL },
+			{ { 0.0f, 1.0f, 0.0f }, NULL }
+		},
+		NULL
+	};
+	
+	if (Q3View_StartRendering( theView.get() ) != kQ3Success)
+	{
+		outLog << "Q3View_StartRendering failed.\n";
+		return false;
+	}
+	do
+	{
+		Q3Triangle_Submit( &triData, theView.get() );
+		Q3XView_SubmitImmediateClass( theView.get(), theClass, &triData );
+		Q3XView_SubmitImmediateClass( theView.get(), theClass, &triData );
+	} while (Q3View_EndRendering( theView.get() ) == kQ3ViewStatusRetraverse);
+	
+	// Expect one pass, so that each submit is counted once
+	TQ3ViewFrameStatistics	theStats;
+	theStats.structureVersion = kQ3ViewFrameStatisticsStructureVersion;
+	if ( (Q3View_GetFrameStatistics( theView.get(), &theStats ) != kQ3Success) ||
+		(theStats.numPasses != 1) )
+	{
+		outLog << "Expected a single rendering pass.\n";
+		return false;
+	}
+	
+	TQ3Uns32	numTypes = 0;
+	Q3View_GetFrameTypeStatistics( theView.get(), 0, &numTypes, NULL );
+	std::vector<TQ3ViewTypeStatistics>	typeStats( numTypes + 1 );
+	if (Q3View_GetFrameTypeStatistics( theView.get(), numTypes + 1, &numTypes,
+		&typeStats[0] ) != kQ3Success)
+	{
+		outLog << "Q3View_GetFrameTypeStatistics failed.\n";
+		return false;
+	}
+	
+	TQ3Uns32	numTriangles = 0;
+	for (TQ3Uns32 i = 0; i < numTypes; ++i)
+	{
+		if (typeStats[i].objectType == kQ3GeometryTypeTriangle)
+		{
+			numTriangles = typeStats[i].objectsSubmitted;
+		}
+	}
+	
+	if (numTriangles != 3)
+	{
+		outLog << "Counted " << numTriangles << " triangle submits, expected 3.\n";
+		return false;
+	}
+	
+	return true;
+}
@@ -0,0 +1,174 @@
+/*
+ *  TestFiles.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaIO.h>
+#include <QuesaStorage.h>
+#include <QuesaView.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+/*!
+	@function	WriteObjects
+	
+	@abstract	Write objects to a new memory storage as binary 3DMF.
+	@param		inObjects		The objects to write.
+	@param		inProperty		A TQ3Boolean file property to set to true before
+								writing, or 0 for none.
+	@result		The new storage, or NULL on failure.
+*/
+TQ3StorageObject WriteObjects( const std::vector<TQ3Object>& inObjects,
+								TQ3ObjectType inProperty )
+{
+	CQ3ObjectRef	theStorage( Q3MemoryStorage_New( NULL, 0 ) );
+	CQ3ObjectRef	theFile( Q3File_New() );
+	TQ3ViewObject	theView = Q3View_New();
+	TQ3Boolean		isOn = kQ3True;
+	bool			success = theStorage.isvalid() && theFile.isvalid() &&
+								(theView != NULL);
+	
+	if (success)
+	{
+		Q3File_SetStorage( theFile.get(), theStorage.get() );
+		if (inProperty != 0)
+		{
+			Q3Object_SetProperty( theFile.get(), inProperty, sizeof(isOn), &isOn );
+		}
+		success = (Q3File_OpenWrite( theFile.get(), kQ3FileModeNormal ) == kQ3Success);
+	}
+	
+	if (success)
+	{
+		if (Q3View_StartWriting( theView, theFile.get() ) == kQ3Success)
+		{
+			do
+			{
+				for (size_t i = 0; i < inObjects.size(); ++i)
+				{
+					Q3Object_Submit( inObjects[i], theView );
+				}
+			} while (Q3View_EndWriting( theView ) == kQ3ViewStatusRetraverse);
+		}
+		else
+		{
+			success = false;
+		}
+		
+		if (Q3File_Close( theFile.get() ) != kQ3Success)
+		{
+			success = false;
+		}
+	}
+	
+	if (theView != NULL)
+	{
+		Q3Object_Dispose( theView );
+	}
+	
+	return success? Q3Shared_GetReference( theStorage.get() ) : NULL;
+}
+
+/*!
+	@function	ReadObjects
+	
+	@abstract	Read the top level objects of a 3DMF storage.
+	@param		inStorage		The storage to read.
+	@param		outObjects		Receives the objects.
+	@result		True if the storage could be read.
+*/
+bool ReadObjects( TQ3StorageObject inStorage, std::vector<CQ3ObjectRef>& outObjects )
+{
+	CQ3ObjectRef	theFile( Q3File_New() );
+	TQ3FileMode		theMode = 0;
+	
+	outObjects.clear();
+	if (! theFile.isvalid())
+	{
+		return false;
+	}
+	
+	Q3File_SetStorage( theFile.get(), inStorage );
+	if (Q3File_OpenRead( theFile.get(), &theMode ) != kQ3Success)
+	{
+		return false;
+	}
+	
+	while (Q3File_IsEndOfFile( theFile.get() ) == kQ3False)
+	{
+		CQ3ObjectRef	theObject( Q3File_ReadObject( theFile.get() ) );
+		if (theObject.isvalid())
+		{
+			outObjects.push_back( theObject );
+		}
+	}
+	
+	return (Q3File_Close( theFile.get() ) == kQ3Success);
+}
+
+/*!
+	@function	StorageSize
+	
+	@abstract	Get the size of a storage, or 0 if it is unknown.
+*/
+TQ3Uns32 StorageSize( TQ3StorageObject inStorage )
+{
+	TQ3Uns32	theSize = 0;
+	
+	if (Q3Storage_GetSize( inStorage, &theSize ) != kQ3Success)
+	{
+		theSize = 0;
+	}
+	
+	return theSize;
+}
+
+/*!
+	@function	ReadModel
+	
+	@abstract	Load one of the sample models into a new memory storage.
+	@param		inModelsPath	Path of the folder of sample 3DMF models.
+	@param		inName			Path of the model within that folder.
+	@result		The new storage, or NULL if the model could not be read.
+*/
+TQ3StorageObject ReadModel( const char* inModelsPath, const char* inName )
+{
+	std::string		thePath( std::string( inModelsPath ) + "/" + inName );
+	std::ifstream	theStream( thePath.c_str(), std::ios::binary );
+	
+	if (! theStream)
+	{
+		return NULL;
+	}
+	
+	std::vector<unsigned char>	theBytes( (std::istreambuf_iterator<char>( theStream )),
+		std::istreambuf_iterator<char>() );
+	
+	return Q3MemoryStorage_New( theBytes.empty()? NULL : &theBytes[0],
+		(TQ3Uns32) theBytes.size() );
+}
@@ -0,0 +1,96 @@
+/*
+ *  TestViews.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaCamera.h>
+#include <QuesaDrawContext.h>
+#include <QuesaRenderer.h>
+#include <QuesaView.h>
+
+/*!
+	@function	NewPixmapView
+	
+	@abstract	Create a view which renders with the generic renderer into a
+				small pixmap, so that tests can run rendering loops without a
+				window.
+	@param		outPixels	Receives the pixel storage, which must outlive the
+							view.
+	@result		A new view, or NULL on failure.
+*/
+TQ3ViewObject NewPixmapView( std::vector<TQ3Uns32>& outPixels )
+{
+	const TQ3Uns32	kWidth = 16;
+	outPixels.resize( kWidth * kWidth );
+	
+	TQ3PixmapDrawContextData	contextData;
+	contextData.drawContextData.clearImageMethod = kQ3ClearMethodWithColor;
+	contextData.drawContextData.clearImageColor.a = 1.0f;
+	contextData.drawContextData.clearImageColor.r = 0.0f;
+	contextData.drawContextData.clearImageColor.g = 0.0f;
+	contextData.drawContextData.clearImageColor.b = 0.0f;
+	contextData.drawContextData.paneState = kQ3False;
+	contextData.drawContextData.maskState = kQ3False;
+	contextData.drawContextData.doubleBufferState = kQ3False;
+	contextData.pixmap.image = &outPixels[0];
+	contextData.pixmap.width = kWidth;
+	contextData.pixmap.height = kWidth;
+	contextData.pixmap.rowBytes = kWidth * 4;
+	contextData.pixmap.pixelSize = 32;
+	contextData.pixmap.pixelType = kQ3PixelTypeARGB32;
+	contextData.pixmap.bitOrder = kQ3EndianBig;
+	contextData.pixmap.byteOrder = kQ3EndianBig;
+	
+	TQ3ViewAngleAspectCameraData	cameraData =
+	{
+		{
+			{ { 0.0f, 0.0f, 5.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+			{ 0.1f, 10.0f },
+			{ { -1.0f, 1.0f }, 2.0f, 2.0f }
+		},
+		1.0f,
+		1.0f
+	};
+	
+	CQ3ObjectRef theContext( Q3PixmapDrawContext_New( &contextData ) );
+	CQ3ObjectRef theRenderer( Q3Renderer_NewFromType( kQ3RendererTypeGeneric ) );
+	CQ3ObjectRef theCamera( Q3ViewAngleAspectCamera_New( &cameraData ) );
+	if ( (! theContext.isvalid()) || (! theRenderer.isvalid()) || (! theCamera.isvalid()) )
+	{
+		return NULL;
+	}
+	
+	// Views are not shared, so the caller gets the only reference
+	TQ3ViewObject theView = Q3View_New();
+	if (theView != NULL)
+	{
+		Q3View_SetDrawContext( theView, theContext.get() );
+		Q3View_SetRenderer( theView, theRenderer.get() );
+		Q3View_SetCamera( theView, theCamera.get() );
+	}
+	
+	return theView;
+}
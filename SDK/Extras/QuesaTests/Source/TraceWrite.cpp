@@ -0,0 +1,188 @@
+/*
+ *  TraceWrite.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <CQ3ObjectRef.h>
+#include <QuesaStorage.h>
+#include <QuesaView.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace
+{
+	/*!
+		@function	CheckTrace
+		
+		@abstract	Check that a written trace is a complete JSON array of
+					named events, with times measured from the start of the
+					trace.
+		@param		inJSON		The trace.
+		@param		inMaxTime	Microseconds since the trace was started.
+		@param		outLog		Receives failure messages.
+	*/
+	bool CheckTrace( const std::string& inJSON, double inMaxTime, std::ostream& outLog )
+	{
+		const char* kStart = "{\"traceEvents\":[";
+		const char* kEnd = "\n],\"displayTimeUnit\":\"ms\"}\n";
+		
+		if ( (inJSON.compare( 0, std::strlen( kStart ), kStart ) != 0) ||
+			(inJSON.size() < std::strlen( kEnd )) ||
+			(inJSON.compare( inJSON.size() - std::strlen( kEnd ), std::string::npos, kEnd ) != 0) )
+		{
+			outLog << "Trace is not a complete JSON object.\n";
+			return false;
+		}
+		
+		for (std::string::size_type i = inJSON.find( "{\"name\":\"" );
+			i != std::string::npos; i = inJSON.find( "{\"name\":\"", i + 1 ))
+		{
+			std::string::size_type lineEnd = inJSON.find( '\n', i );
+			std::string theEvent( inJSON, i, lineEnd - i );
+			
+			if ( (theEvent.compare( 9, 2, "\",") == 0) ||
+				(theEvent.find( "(null)" ) != std::string::npos) )
+			{
+				outLog << "Trace has an unnamed event: " << theEvent << "\n";
+				return false;
+			}
+			
+			std::string::size_type ts = theEvent.find( "\"ts\":" );
+			if ( (ts == std::string::npos) ||
+				(std::strtod( theEvent.c_str() + ts + 5, NULL ) > inMaxTime) )
+			{
+				outLog << "Trace event has a bad time: " << theEvent << "\n";
+				return false;
+			}
+		}
+		
+		return true;
+	}
+}
+
+/*!
+	@function	TestTraceWrite
+	
+	@abstract	Check that a trace written while another thread is recording
+				events contains only complete events, timed from when tracing
+				was turned on.
+	
+	@discussion	Only one thread at a time may create or dispose Quesa
+				objects, and rendering creates objects.  So the storages
+				are all created before the render thread starts and disposed
+				after it stops, leaving this thread to call only
+				Q3Trace_Write while it runs.
+*/
+bool TestTraceWrite( const char* inModelsPath, std::ostream& outLog )
+{
+	(void) inModelsPath;
+	
+	const int	kNumWrites = 200;
+	
+	std::vector<TQ3Uns32>	pixels;
+	CQ3ObjectRef theView( NewPixmapView( pixels ) );
+	if (! theView.isvalid())
+	{
+		outLog << "Could not create the view.\n";
+		return false;
+	}
+	
+	std::vector<CQ3ObjectRef>	theStorages;
+	for (int i = 0; i < kNumWrites; ++i)
+	{
+		theStorages.push_back( CQ3ObjectRef( Q3MemoryStorage_New( NULL, 0 ) ) );
+		if (! theStorages.back().isvalid())
+		{
+			outLog << "Could not create the storages.\n";
+			return false;
+		}
+	}
+	
+	// Wait a while, so that times measured from before the trace was started
+	// would stand out
+	std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+	Q3Trace_Clear();
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	Q3Trace_SetState( kQ3True );
+	
+	// Render frames, each of which records trace events, in another thread
+	std::atomic_bool	isDone( false );
+	std::atomic_int		numFrames( 0 );
+	std::thread	renderThread( [&]()
+		{
+			while (! isDone.load())
+			{
+				if (Q3View_StartRendering( theView.get() ) == kQ3Success)
+				{
+					while (Q3View_EndRendering( theView.get() ) == kQ3ViewStatusRetraverse)
+					{
+					}
+				}
+				++numFrames;
+			}
+		} );
+	
+	while (numFrames.load() < 10)
+	{
+		std::this_thread::yield();
+	}
+	
+	bool	success = true;
+	for (int i = 0; (i < kNumWrites) && success; ++i)
+	{
+		TQ3StorageObject	theStorage = theStorages[i].get();
+		TQ3Uns32	bytesWritten = 0;
+		TQ3Uns8*	theBuffer = NULL;
+		TQ3Uns32	validSize = 0, bufferSize = 0;
+		
+		success = (Q3Trace_Write( theStorage, &bytesWritten ) == kQ3Success) &&
+			(Q3MemoryStorage_GetBuffer( theStorage, &theBuffer, &validSize,
+				&bufferSize ) == kQ3Success);
+		
+		if (! success)
+		{
+			outLog << "Could not write the trace.\n";
+		}
+		else
+		{
+			std::chrono::duration<double, std::micro> maxTime =
+				std::chrono::steady_clock::now() - startTime;
+			success = CheckTrace( std::string( (const char*) theBuffer, validSize ),
+				maxTime.count(), outLog );
+		}
+	}
+	
+	isDone.store( true );
+	renderThread.join();
+	Q3Trace_SetState( kQ3False );
+	Q3Trace_Clear();
+	
+	return success;
+}
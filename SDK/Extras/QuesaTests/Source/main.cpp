@@ -0,0 +1,114 @@
+/*
+ *  main.cpp
+ *  QuesaTests
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "QuesaTests.h"
+
+#include <Quesa.h>
+
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+namespace
+{
+	struct TestInfo
+	{
+		const char*		name;
+		TestFunc		func;
+		bool			isBenchmark;
+	};
+	
+	const TestInfo	kTests[] =
+	{
+		{ "SubmitStatistics", TestSubmitStatistics, false },
+		{ "TraceWrite", TestTraceWrite, false },
+		{ "CompressedStorage", TestCompressedStorage, false },
+		{ "ShareEqualObjects", TestShareEqualObjects, false },
+		{ "LazyLoadModels", TestLazyLoadModels, false },
+		{ "AttributeSets", TestAttributeSets, false },
+		{ "ImmediateSubmit", BenchmarkImmediateSubmit, true },
+		{ "PackedTriMesh", BenchmarkPackedTriMesh, true },
+		{ NULL, NULL, false }
+	};
+}
+
+static int Usage()
+{
+	cerr << "Usage: QuesaTests [--bench] [models folder]\n" <<
+			"Runs the regression tests, or with --bench the benchmarks.  The\n" <<
+			"models folder defaults to ../../Models/Test.\n";
+	return 1;
+}
+
+int main (int argc, char * const argv[])
+{
+	bool runBenchmarks = false;
+	const char* modelsPath = "../../Models/Test";
+	int argIndex = 1;
+	
+	if ( (argIndex < argc) && (0 == std::strcmp( argv[ argIndex ], "--bench" )) )
+	{
+		runBenchmarks = true;
+		++argIndex;
+	}
+	
+	if (argIndex < argc)
+	{
+		modelsPath = argv[ argIndex ];
+		++argIndex;
+	}
+	
+	if ( (argIndex < argc) || (modelsPath[0] == '-') )
+	{
+		return Usage();
+	}
+	
+	if (Q3Initialize() != kQ3Success)
+	{
+		cerr << "Q3Initialize failed.\n";
+		return 2;
+	}
+	
+	int numFailed = 0;
+	
+	for (const TestInfo* theTest = kTests; theTest->name != NULL; ++theTest)
+	{
+		if (theTest->isBenchmark == runBenchmarks)
+		{
+			bool success = theTest->func( modelsPath, cout );
+			cout << (success? "passed " : "FAILED ") << theTest->name << endl;
+			
+			if (! success)
+			{
+				++numFailed;
+			}
+		}
+	}
+	
+	Q3Exit();
+
+	return (numFailed == 0)? 0 : 3;
+}
@@ -0,0 +1,625 @@
+/*
+ *  BinaryIO.cpp
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "BinaryIO.h"
+
+#include "ByteStreams.h"
+#include "TranscodeException.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+	const uint32_t	kHeaderLength = 16;
+	const uint64_t	kHeaderEnd = 8 + kHeaderLength;
+	const size_t	kFloatChunk = 1024;
+
+	uint32_t	PadLength( uint32_t inLength )
+	{
+		return (inLength + 3) & ~3U;
+	}
+
+	uint16_t	Decode16( const uint8_t* inBytes, bool inBigEndian )
+	{
+		return inBigEndian?
+			static_cast<uint16_t>( (inBytes[0] << 8) | inBytes[1] ) :
+			static_cast<uint16_t>( (inBytes[1] << 8) | inBytes[0] );
+	}
+
+	uint32_t	Decode32( const uint8_t* inBytes, bool inBigEndian )
+	{
+		return inBigEndian?
+			((uint32_t)inBytes[0] << 24) | ((uint32_t)inBytes[1] << 16) |
+				((uint32_t)inBytes[2] << 8) | inBytes[3] :
+			((uint32_t)inBytes[3] << 24) | ((uint32_t)inBytes[2] << 16) |
+				((uint32_t)inBytes[1] << 8) | inBytes[0];
+	}
+
+	void	Encode16( uint16_t inValue, uint8_t* outBytes, bool inBigEndian )
+	{
+		outBytes[ inBigEndian? 0 : 1 ] = static_cast<uint8_t>( inValue >> 8 );
+		outBytes[ inBigEndian? 1 : 0 ] = static_cast<uint8_t>( inValue );
+	}
+
+	void	Encode32( uint32_t inValue, uint8_t* outBytes, bool inBigEndian )
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			outBytes[ inBigEndian? 3 - i : i ] = static_cast<uint8_t>( inValue >> (8 * i) );
+		}
+	}
+
+	std::string	MakeLabel( const char* inPrefix, uint64_t inNumber )
+	{
+		std::ostringstream ss;
+		ss << inPrefix << inNumber;
+		return ss.str();
+	}
+}
+
+#pragma mark BinaryReader
+
+BinaryReader::BinaryReader( InputStream& inStream, bool inBigEndian )
+	: mStream( inStream )
+	, mBigEndian( inBigEndian )
+	, mFileLength( inStream.Length() )
+	, mTOCOffset( 0 )
+	, mObjectEnd( 0 )
+{
+}
+
+void	BinaryReader::Need( uint64_t inLength )
+{
+	if (mStream.Position() + inLength > mObjectEnd)
+	{
+		throw TranscodeException( "Object data too short", mStream.Position() );
+	}
+}
+
+void	BinaryReader::ScanTOCs()
+{
+	mStream.Seek( 16 );
+	mObjectEnd = kHeaderEnd;
+	uint64_t tocOffset = Uns64();
+	uint32_t tocIndex = 0;
+
+	while ( (tocOffset != 0) && (mLabels.count( tocOffset ) == 0) )
+	{
+		if (tocOffset + 8 + 28 > mFileLength)
+		{
+			throw TranscodeException( "Table of contents out of range", tocOffset );
+		}
+		mLabels[ tocOffset ] = MakeLabel( "tableofcontents", tocIndex++ );
+
+		mStream.Seek( tocOffset );
+		mObjectEnd = mFileLength;
+		uint32_t theType = Uns32();
+		uint32_t dataLen = Uns32();
+		if ( (theType != 'toc ') || (tocOffset + 8 + dataLen > mFileLength) )
+		{
+			throw TranscodeException( "Bad table of contents", tocOffset );
+		}
+		mObjectEnd = tocOffset + 8 + dataLen;
+
+		uint64_t nextTOC = Uns64();
+		Uns32();	// reference seed
+		Uns32();	// type seed
+		uint32_t entryType = Uns32();
+		uint32_t entrySize = Uns32();
+		uint32_t numEntries = Uns32();
+		if ( (entryType > 1) || (entrySize != 12 + 4 * entryType) )
+		{
+			throw TranscodeException( "Bad table of contents entry type", tocOffset );
+		}
+
+		for (uint32_t i = 0; i < numEntries; ++i)
+		{
+			uint32_t refID = Uns32();
+			uint64_t location = Uns64();
+			if (entryType == 1)
+			{
+				Uns32();
+			}
+			if (mLabels.count( location ) == 0)
+			{
+				mLabels[ location ] = MakeLabel( "ref", refID );
+			}
+		}
+
+		tocOffset = nextTOC;
+	}
+
+	mStream.Seek( 0 );
+}
+
+void	BinaryReader::BeginHeader()
+{
+	mStream.Seek( 0 );
+	mObjectEnd = kHeaderEnd;
+	Uns32();	// '3DMF' in either byte order, already checked
+	if (Uns32() != kHeaderLength)
+	{
+		throw TranscodeException( "Unexpected header length", 4 );
+	}
+}
+
+void	BinaryReader::EndHeader()
+{
+	mStream.Seek( kHeaderEnd );
+}
+
+bool	BinaryReader::NextItem( ItemHeader& outItem )
+{
+	uint64_t here = mStream.Position();
+
+	if ( (! mContainerEnds.empty()) && (here >= mContainerEnds.back()) )
+	{
+		mContainerEnds.pop_back();
+		outItem.kind = ItemHeader::kContainerEnd;
+		outItem.offset = here;
+		return true;
+	}
+
+	uint64_t limit = mContainerEnds.empty()? mFileLength : mContainerEnds.back();
+	if (here >= limit)
+	{
+		return false;
+	}
+
+	mObjectEnd = limit;
+	outItem.offset = here;
+	outItem.typeCode = Uns32();
+	uint32_t dataLen = Uns32();
+	if (mStream.Position() + dataLen > limit)
+	{
+		throw TranscodeException( "Chunk length too long", here );
+	}
+	mObjectEnd = mStream.Position() + dataLen;
+
+	outItem.className.clear();
+	std::map<uint64_t, std::string>::const_iterator found = mLabels.find( here );
+	if (found != mLabels.end())
+	{
+		outItem.label = found->second;
+	}
+	else
+	{
+		outItem.label.clear();
+	}
+
+	if ( (outItem.typeCode == 'cntr') || (outItem.typeCode == 'bgng') )
+	{
+		outItem.kind = ItemHeader::kContainer;
+		mContainerEnds.push_back( mObjectEnd );
+	}
+	else
+	{
+		outItem.kind = ItemHeader::kObject;
+	}
+	return true;
+}
+
+uint64_t	BinaryReader::TrailingBytes()
+{
+	return mObjectEnd - mStream.Position();
+}
+
+bool	BinaryReader::EndObject()
+{
+	uint64_t trailing = TrailingBytes();
+	bool onlyPadding = (trailing < 4);
+
+	while (onlyPadding && (mStream.Position() < mObjectEnd))
+	{
+		onlyPadding = (mStream.GetByte() == 0);
+	}
+	mStream.Seek( mObjectEnd );
+
+	return onlyPadding;
+}
+
+uint64_t	BinaryReader::Offset()
+{
+	return mStream.Position();
+}
+
+bool	BinaryReader::AtEnd()
+{
+	return mStream.Position() >= mObjectEnd;
+}
+
+uint8_t		BinaryReader::Uns8()
+{
+	Need( 1 );
+	return static_cast<uint8_t>( mStream.GetByte() );
+}
+
+uint16_t	BinaryReader::Uns16()
+{
+	uint8_t bytes[2];
+	Need( 2 );
+	mStream.Read( bytes, 2 );
+	return Decode16( bytes, mBigEndian );
+}
+
+uint32_t	BinaryReader::Uns32()
+{
+	uint8_t bytes[4];
+	Need( 4 );
+	mStream.Read( bytes, 4 );
+	return Decode32( bytes, mBigEndian );
+}
+
+uint64_t	BinaryReader::Uns64()
+{
+	uint64_t first = Uns32();
+	uint64_t second = Uns32();
+	return mBigEndian? (first << 32) | second : (second << 32) | first;
+}
+
+int32_t		BinaryReader::Int32()
+{
+	return static_cast<int32_t>( Uns32() );
+}
+
+float		BinaryReader::Float32()
+{
+	uint32_t bits = Uns32();
+	float value;
+	memcpy( &value, &bits, sizeof(value) );
+	return value;
+}
+
+void	BinaryReader::Float32Array( float* outValues, uint32_t inCount )
+{
+	Need( 4 * (uint64_t)inCount );
+
+	uint8_t bytes[ 4 * kFloatChunk ];
+	while (inCount > 0)
+	{
+		uint32_t chunk = (inCount < kFloatChunk)? inCount : kFloatChunk;
+		mStream.Read( bytes, 4 * chunk );
+		for (uint32_t i = 0; i < chunk; ++i)
+		{
+			uint32_t bits = Decode32( &bytes[ 4 * i ], mBigEndian );
+			memcpy( &outValues[i], &bits, sizeof(float) );
+		}
+		outValues += chunk;
+		inCount -= chunk;
+	}
+}
+
+uint32_t	BinaryReader::Index( uint32_t inBytes )
+{
+	uint32_t result;
+
+	if (inBytes == 1)
+	{
+		result = Uns8();
+		if (result == 0xFF)
+		{
+			result = 0xFFFFFFFFUL;
+		}
+	}
+	else if (inBytes == 2)
+	{
+		result = Uns16();
+		if (result == 0xFFFF)
+		{
+			result = 0xFFFFFFFFUL;
+		}
+	}
+	else
+	{
+		result = Uns32();
+	}
+
+	return result;
+}
+
+uint32_t	BinaryReader::Enum( const KeywordTable& )
+{
+	return Uns32();
+}
+
+std::string	BinaryReader::String()
+{
+	std::string result;
+	int theChar;
+
+	for (;;)
+	{
+		Need( 1 );
+		theChar = mStream.GetByte();
+		if (theChar == 0)
+		{
+			break;
+		}
+		result += static_cast<char>( theChar );
+	}
+
+	RawPadding( static_cast<uint32_t>( result.size() + 1 ) );
+
+	return result;
+}
+
+void	BinaryReader::RawData( uint8_t* outData, uint32_t inLength )
+{
+	Need( inLength );
+	mStream.Read( outData, inLength );
+}
+
+void	BinaryReader::RawPadding( uint32_t inLength )
+{
+	uint64_t padBytes = PadLength( inLength ) - inLength;
+	if (padBytes > TrailingBytes())
+	{
+		padBytes = TrailingBytes();
+	}
+	mStream.Skip( padBytes );
+}
+
+std::string	BinaryReader::Location()
+{
+	uint64_t location = Uns64();
+	std::string result;
+
+	if (location != 0)
+	{
+		std::map<uint64_t, std::string>::const_iterator found = mLabels.find( location );
+		result = (found != mLabels.end())? found->second :
+			MakeLabel( "offset", location );
+	}
+
+	return result;
+}
+
+uint32_t	BinaryReader::ObjectType()
+{
+	return Uns32();
+}
+
+#pragma mark BinaryWriter
+
+BinaryWriter::BinaryWriter( OutputStream& inStream, bool inBigEndian,
+							std::ostream& inErrStream )
+	: mStream( inStream )
+	, mBigEndian( inBigEndian )
+	, mErrStream( inErrStream )
+	, mHeaderStart( 0 )
+{
+}
+
+void	BinaryWriter::BeginHeader()
+{
+	mHeaderStart = mStream.Position();
+	Uns32( '3DMF' );
+	Uns32( kHeaderLength );
+}
+
+void	BinaryWriter::EndHeader()
+{
+	if (mStream.Position() != mHeaderStart + kHeaderEnd)
+	{
+		throw TranscodeException( "Bad header length", mHeaderStart );
+	}
+}
+
+void	BinaryWriter::BeginObject( uint32_t inType, const std::string&,
+									const std::string& inLabel )
+{
+	if (! inLabel.empty())
+	{
+		mAnchors[ inLabel ] = mStream.Position();
+	}
+	Uns32( inType );
+	mSizeOffsets.push_back( mStream.Position() );
+	Uns32( 0 );
+}
+
+void	BinaryWriter::EndObject()
+{
+	uint64_t sizeOffset = mSizeOffsets.back();
+	mSizeOffsets.pop_back();
+
+	uint64_t dataLen = mStream.Position() - (sizeOffset + 4);
+	if (dataLen > 0xFFFFFFFFUL)
+	{
+		throw TranscodeException( "Object too large for binary 3DMF", sizeOffset - 4 );
+	}
+
+	uint8_t bytes[4];
+	Encode32( static_cast<uint32_t>( dataLen ), bytes, mBigEndian );
+	mStream.Patch( sizeOffset, bytes, 4 );
+}
+
+void	BinaryWriter::BeginContainer( uint32_t inType, const std::string& inClassName,
+									const std::string& inLabel )
+{
+	BeginObject( inType, inClassName, inLabel );
+}
+
+void	BinaryWriter::EndContainer()
+{
+	EndObject();
+}
+
+void	BinaryWriter::Finish()
+{
+	for (std::vector<Fixup>::const_iterator i = mFixups.begin(); i != mFixups.end(); ++i)
+	{
+		std::map<std::string, uint64_t>::const_iterator found = mAnchors.find( i->label );
+		if (found == mAnchors.end())
+		{
+			// Text files conventionally point the header at a table of
+			// contents even when they have none, so that is not worth a
+			// warning.
+			if ( (i->label != "none") && (i->label.compare( 0, 15, "tableofcontents" ) != 0) )
+			{
+				mErrStream << "Unresolved location '" << i->label << "'.\n";
+			}
+			continue;
+		}
+
+		uint8_t bytes[8];
+		uint32_t first = static_cast<uint32_t>( found->second >> 32 );
+		uint32_t second = static_cast<uint32_t>( found->second );
+		Encode32( mBigEndian? first : second, &bytes[0], mBigEndian );
+		Encode32( mBigEndian? second : first, &bytes[4], mBigEndian );
+		mStream.Patch( i->offset, bytes, 8 );
+	}
+	mFixups.clear();
+
+	mStream.Flush();
+}
+
+void	BinaryWriter::Uns8( uint8_t inValue )
+{
+	mStream.Put( static_cast<char>( inValue ) );
+}
+
+void	BinaryWriter::Uns16( uint16_t inValue )
+{
+	uint8_t bytes[2];
+	Encode16( inValue, bytes, mBigEndian );
+	mStream.Write( bytes, 2 );
+}
+
+void	BinaryWriter::Uns32( uint32_t inValue )
+{
+	uint8_t bytes[4];
+	Encode32( inValue, bytes, mBigEndian );
+	mStream.Write( bytes, 4 );
+}
+
+void	BinaryWriter::Uns64( uint64_t inValue )
+{
+	uint32_t first = static_cast<uint32_t>( inValue >> 32 );
+	uint32_t second = static_cast<uint32_t>( inValue );
+	Uns32( mBigEndian? first : second );
+	Uns32( mBigEndian? second : first );
+}
+
+void	BinaryWriter::Int32( int32_t inValue )
+{
+	Uns32( static_cast<uint32_t>( inValue ) );
+}
+
+void	BinaryWriter::Float32( float inValue )
+{
+	uint32_t bits;
+	memcpy( &bits, &inValue, sizeof(bits) );
+	Uns32( bits );
+}
+
+void	BinaryWriter::Float32Array( const float* inValues, uint32_t inCount,
+									uint32_t )
+{
+	uint8_t bytes[ 4 * kFloatChunk ];
+	while (inCount > 0)
+	{
+		uint32_t chunk = (inCount < kFloatChunk)? inCount : kFloatChunk;
+		for (uint32_t i = 0; i < chunk; ++i)
+		{
+			uint32_t bits;
+			memcpy( &bits, &inValues[i], sizeof(bits) );
+			Encode32( bits, &bytes[ 4 * i ], mBigEndian );
+		}
+		mStream.Write( bytes, 4 * chunk );
+		inValues += chunk;
+		inCount -= chunk;
+	}
+}
+
+void	BinaryWriter::Index( uint32_t inValue, uint32_t inBytes )
+{
+	if (inBytes == 1)
+	{
+		Uns8( static_cast<uint8_t>( inValue ) );
+	}
+	else if (inBytes == 2)
+	{
+		Uns16( static_cast<uint16_t>( inValue ) );
+	}
+	else
+	{
+		Uns32( inValue );
+	}
+}
+
+void	BinaryWriter::Enum( uint32_t inValue, const KeywordTable& )
+{
+	Uns32( inValue );
+}
+
+void	BinaryWriter::String( const std::string& inValue )
+{
+	mStream.Write( inValue.c_str(), inValue.size() + 1 );
+	RawPadding( static_cast<uint32_t>( inValue.size() + 1 ) );
+}
+
+void	BinaryWriter::RawData( const uint8_t* inData, uint32_t inLength )
+{
+	mStream.Write( inData, inLength );
+}
+
+void	BinaryWriter::RawPadding( uint32_t inLength )
+{
+	static const uint8_t kZeros[4] = { 0, 0, 0, 0 };
+	mStream.Write( kZeros, PadLength( inLength ) - inLength );
+}
+
+void	BinaryWriter::Location( const std::string& inLabel )
+{
+	uint64_t location = 0;
+
+	if (! inLabel.empty())
+	{
+		std::map<std::string, uint64_t>::const_iterator found = mAnchors.find( inLabel );
+		if (found != mAnchors.end())
+		{
+			location = found->second;
+		}
+		else
+		{
+			Fixup theFixup;
+			theFixup.offset = mStream.Position();
+			theFixup.label = inLabel;
+			mFixups.push_back( theFixup );
+		}
+	}
+
+	Uns64( location );
+}
+
+void	BinaryWriter::ObjectType( uint32_t inType )
+{
+	Uns32( inType );
+}
+
+void	BinaryWriter::LineBreak()
+{
+}
@@ -0,0 +1,152 @@
+/*
+ *  BinaryIO.h
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#pragma once
+
+#include "ObjectIO.h"
+
+#include <map>
+#include <ostream>
+#include <vector>
+
+class InputStream;
+class OutputStream;
+
+
+/*!
+	@class		BinaryReader
+
+	@abstract	Reads a binary 3DMF stream of either byte order.
+
+	@discussion	Before the header is read, ScanTOCs walks the chain of
+				tables of contents and gives a label to each location they
+				mention.  That label table is the only state that grows with
+				the size of the file.
+*/
+class BinaryReader : public ObjectReader
+{
+public:
+						BinaryReader( InputStream& inStream, bool inBigEndian );
+
+	void				ScanTOCs();
+
+	// ObjectReader
+	virtual void		BeginHeader();
+	virtual void		EndHeader();
+	virtual bool		NextItem( ItemHeader& outItem );
+	virtual uint64_t	TrailingBytes();
+	virtual bool		EndObject();
+	virtual uint64_t	Offset();
+
+	// FieldReader
+	virtual bool		AtEnd();
+	virtual uint8_t		Uns8();
+	virtual uint16_t	Uns16();
+	virtual uint32_t	Uns32();
+	virtual int32_t		Int32();
+	virtual float		Float32();
+	virtual void		Float32Array( float* outValues, uint32_t inCount );
+	virtual uint32_t	Index( uint32_t inBytes );
+	virtual uint32_t	Enum( const KeywordTable& inTable );
+	virtual std::string	String();
+	virtual void		RawData( uint8_t* outData, uint32_t inLength );
+	virtual void		RawPadding( uint32_t inLength );
+	virtual std::string	Location();
+	virtual uint32_t	ObjectType();
+
+private:
+	void				Need( uint64_t inLength );
+	uint64_t			Uns64();
+
+	InputStream&					mStream;
+	bool							mBigEndian;
+	uint64_t						mFileLength;
+	uint64_t						mTOCOffset;
+	uint64_t						mObjectEnd;
+	std::vector<uint64_t>			mContainerEnds;
+	std::map<uint64_t, std::string>	mLabels;
+};
+
+
+/*!
+	@class		BinaryWriter
+
+	@abstract	Writes a binary 3DMF stream of either byte order.
+
+	@discussion	Chunk sizes are written as placeholders and patched when the
+				object ends.  Locations of objects that have not been written
+				yet are patched by Finish.
+*/
+class BinaryWriter : public ObjectWriter
+{
+public:
+						BinaryWriter( OutputStream& inStream, bool inBigEndian,
+									std::ostream& inErrStream );
+
+	// ObjectWriter
+	virtual void		BeginHeader();
+	virtual void		EndHeader();
+	virtual void		BeginObject( uint32_t inType, const std::string& inClassName,
+									const std::string& inLabel );
+	virtual void		EndObject();
+	virtual void		BeginContainer( uint32_t inType, const std::string& inClassName,
+									const std::string& inLabel );
+	virtual void		EndContainer();
+	virtual void		Finish();
+
+	// FieldWriter
+	virtual void		Uns8( uint8_t inValue );
+	virtual void		Uns16( uint16_t inValue );
+	virtual void		Uns32( uint32_t inValue );
+	virtual void		Int32( int32_t inValue );
+	virtual void		Float32( float inValue );
+	virtual void		Float32Array( const float* inValues, uint32_t inCount,
+									uint32_t inPerLine );
+	virtual void		Index( uint32_t inValue, uint32_t inBytes );
+	virtual void		Enum( uint32_t inValue, const KeywordTable& inTable );
+	virtual void		String( const std::string& inValue );
+	virtual void		RawData( const uint8_t* inData, uint32_t inLength );
+	virtual void		RawPadding( uint32_t inLength );
+	virtual void		Location( const std::string& inLabel );
+	virtual void		ObjectType( uint32_t inType );
+	virtual void		LineBreak();
+
+private:
+	struct Fixup
+	{
+		uint64_t		offset;
+		std::string		label;
+	};
+
+	void				Uns64( uint64_t inValue );
+
+	OutputStream&					mStream;
+	bool							mBigEndian;
+	std::ostream&					mErrStream;
+	uint64_t						mHeaderStart;
+	std::vector<uint64_t>			mSizeOffsets;
+	std::map<std::string, uint64_t>	mAnchors;
+	std::vector<Fixup>				mFixups;
+};
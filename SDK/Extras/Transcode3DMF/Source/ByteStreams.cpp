@@ -0,0 +1,218 @@
+/*
+ *  ByteStreams.cpp
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "ByteStreams.h"
+
+#include "TranscodeException.h"
+
+#include <cstring>
+#include <sys/types.h>
+
+namespace
+{
+	const size_t	kBufferSize = 64 * 1024;
+}
+
+InputStream::InputStream( FILE* inFile )
+	: mFile( inFile )
+	, mBuffer( kBufferSize )
+	, mBufferStart( 0 )
+	, mBufferPos( 0 )
+	, mBufferLen( 0 )
+{
+}
+
+bool	InputStream::Fill()
+{
+	mBufferStart += mBufferLen;
+	mBufferPos = 0;
+	mBufferLen = fread( &mBuffer[0], 1, mBuffer.size(), mFile );
+	return mBufferLen > 0;
+}
+
+void	InputStream::Seek( uint64_t inOffset )
+{
+	if ( (inOffset >= mBufferStart) && (inOffset <= mBufferStart + mBufferLen) )
+	{
+		mBufferPos = static_cast<size_t>( inOffset - mBufferStart );
+	}
+	else
+	{
+		if (fseeko( mFile, static_cast<off_t>( inOffset ), SEEK_SET ) != 0)
+		{
+			throw TranscodeException( "Cannot seek in input", inOffset );
+		}
+		mBufferStart = inOffset;
+		mBufferPos = 0;
+		mBufferLen = 0;
+	}
+}
+
+uint64_t	InputStream::Length()
+{
+	off_t here = ftello( mFile );
+	if ( (here < 0) || (fseeko( mFile, 0, SEEK_END ) != 0) )
+	{
+		throw TranscodeException( "Input is not seekable", Position() );
+	}
+	off_t fileLen = ftello( mFile );
+	fseeko( mFile, here, SEEK_SET );
+	return static_cast<uint64_t>( fileLen );
+}
+
+int		InputStream::PeekByte()
+{
+	if ( (mBufferPos == mBufferLen) && ! Fill() )
+	{
+		return EOF;
+	}
+	return mBuffer[ mBufferPos ];
+}
+
+int		InputStream::GetByte()
+{
+	if ( (mBufferPos == mBufferLen) && ! Fill() )
+	{
+		return EOF;
+	}
+	return mBuffer[ mBufferPos++ ];
+}
+
+void	InputStream::Read( void* outData, size_t inLength )
+{
+	uint8_t* dest = static_cast<uint8_t*>( outData );
+
+	while (inLength > 0)
+	{
+		if ( (mBufferPos == mBufferLen) && ! Fill() )
+		{
+			throw TranscodeException( "Unexpected end of input", Position() );
+		}
+		size_t chunk = mBufferLen - mBufferPos;
+		if (chunk > inLength)
+		{
+			chunk = inLength;
+		}
+		memcpy( dest, &mBuffer[ mBufferPos ], chunk );
+		mBufferPos += chunk;
+		dest += chunk;
+		inLength -= chunk;
+	}
+}
+
+void	InputStream::Skip( uint64_t inLength )
+{
+	if (inLength <= mBufferLen - mBufferPos)
+	{
+		mBufferPos += static_cast<size_t>( inLength );
+	}
+	else
+	{
+		Seek( Position() + inLength );
+	}
+}
+
+
+
+OutputStream::OutputStream( FILE* inFile )
+	: mFile( inFile )
+	, mBufferStart( 0 )
+{
+	mBuffer.reserve( kBufferSize );
+}
+
+OutputStream::~OutputStream()
+{
+	try
+	{
+		Flush();
+	}
+	catch (...)
+	{
+	}
+}
+
+void	OutputStream::Write( const void* inData, size_t inLength )
+{
+	if (mBuffer.size() + inLength > kBufferSize)
+	{
+		Flush();
+	}
+	if (inLength >= kBufferSize)
+	{
+		if (fwrite( inData, 1, inLength, mFile ) != inLength)
+		{
+			throw TranscodeException( "Cannot write output", Position() );
+		}
+		mBufferStart += inLength;
+	}
+	else
+	{
+		const char* src = static_cast<const char*>( inData );
+		mBuffer.insert( mBuffer.end(), src, src + inLength );
+	}
+}
+
+void	OutputStream::Put( char inChar )
+{
+	if (mBuffer.size() == kBufferSize)
+	{
+		Flush();
+	}
+	mBuffer.push_back( inChar );
+}
+
+void	OutputStream::Patch( uint64_t inOffset, const void* inData, size_t inLength )
+{
+	if (inOffset >= mBufferStart)
+	{
+		memcpy( &mBuffer[ static_cast<size_t>( inOffset - mBufferStart ) ],
+			inData, inLength );
+	}
+	else
+	{
+		Flush();
+		if ( (fseeko( mFile, static_cast<off_t>( inOffset ), SEEK_SET ) != 0) ||
+			(fwrite( inData, 1, inLength, mFile ) != inLength) ||
+			(fseeko( mFile, static_cast<off_t>( mBufferStart ), SEEK_SET ) != 0) )
+		{
+			throw TranscodeException( "Cannot patch output; it must be a seekable file",
+				inOffset );
+		}
+	}
+}
+
+void	OutputStream::Flush()
+{
+	if (! mBuffer.empty())
+	{
+		if (fwrite( &mBuffer[0], 1, mBuffer.size(), mFile ) != mBuffer.size())
+		{
+			throw TranscodeException( "Cannot write output", mBufferStart );
+		}
+		mBufferStart += mBuffer.size();
+		mBuffer.clear();
+	}
+}
@@ -0,0 +1,96 @@
+/*
+ *  ByteStreams.h
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*!
+	@class		InputStream
+
+	@abstract	Buffered sequential reader over a stdio file.
+
+	@discussion	Only a fixed-size window of the file is held in memory.  Seek
+				is only needed for binary input, which must therefore come
+				from a seekable file.
+*/
+class InputStream
+{
+public:
+	explicit		InputStream( FILE* inFile );
+
+	uint64_t		Position() const { return mBufferStart + mBufferPos; }
+	void			Seek( uint64_t inOffset );
+	uint64_t		Length();
+
+	int				PeekByte();
+	int				GetByte();
+	void			Read( void* outData, size_t inLength );
+	void			Skip( uint64_t inLength );
+
+private:
+	bool			Fill();
+
+	FILE*					mFile;
+	std::vector<uint8_t>	mBuffer;
+	uint64_t				mBufferStart;
+	size_t					mBufferPos;
+	size_t					mBufferLen;
+};
+
+
+/*!
+	@class		OutputStream
+
+	@abstract	Buffered sequential writer over a stdio file.
+
+	@discussion	Patch rewrites bytes that were already written.  Patches that
+				fall inside the unflushed buffer are applied in memory, so
+				only the chunk sizes of large objects and forward TOC
+				references cost a seek.
+*/
+class OutputStream
+{
+public:
+	explicit		OutputStream( FILE* inFile );
+					~OutputStream();
+
+	uint64_t		Position() const { return mBufferStart + mBuffer.size(); }
+
+	void			Write( const void* inData, size_t inLength );
+	void			Write( const std::string& inText )
+							{ Write( inText.data(), inText.size() ); }
+	void			Put( char inChar );
+	void			Patch( uint64_t inOffset, const void* inData, size_t inLength );
+	void			Flush();
+
+private:
+	FILE*				mFile;
+	std::vector<char>	mBuffer;
+	uint64_t			mBufferStart;
+};
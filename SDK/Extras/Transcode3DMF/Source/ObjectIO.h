@@ -0,0 +1,221 @@
+/*
+ *  ObjectIO.h
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+/*!
+	@struct		Keyword
+	@abstract	One symbolic value of an enumerated or flag field.
+*/
+struct Keyword
+{
+	const char*		name;
+	uint32_t		value;
+};
+
+/*!
+	@struct		KeywordTable
+
+	@abstract	The symbolic values of an enumerated or flag field.
+
+	@discussion	When writing text the first keyword with a matching value is
+				used, so later entries may serve as aliases that are only
+				accepted on input.  For a mask, each set bit is written as its
+				own keyword joined with "|", and zero uses the entry whose
+				value is 0.
+*/
+struct KeywordTable
+{
+	const Keyword*	keywords;
+	uint32_t		count;
+	bool			isMask;
+};
+
+#define	KEYWORD_TABLE( inArray, inIsMask )	\
+	{ inArray, sizeof(inArray) / sizeof(inArray[0]), inIsMask }
+
+
+/*!
+	@class		TypeNamer
+
+	@abstract	Maps between binary type codes and text class names, taking
+				into account custom types declared by 'type' objects.
+*/
+class TypeNamer
+{
+public:
+	virtual				~TypeNamer() {}
+
+	virtual std::string	NameForType( uint32_t inType ) = 0;
+	virtual uint32_t	TypeForName( const std::string& inName ) = 0;
+};
+
+
+/*!
+	@class		FieldReader
+
+	@abstract	Reads the fields of one object, in either binary or text form.
+
+	@discussion	Codecs see a 3DMF object as a sequence of typed fields, which
+				is the same in both forms: binary field order is text token
+				order.  Problems are reported by throwing TranscodeException.
+*/
+class FieldReader
+{
+public:
+	virtual				~FieldReader() {}
+
+	virtual bool		AtEnd() = 0;
+
+	virtual uint8_t		Uns8() = 0;
+	virtual uint16_t	Uns16() = 0;
+	virtual uint32_t	Uns32() = 0;
+	virtual int32_t		Int32() = 0;
+	virtual float		Float32() = 0;
+	virtual void		Float32Array( float* outValues, uint32_t inCount ) = 0;
+
+	// TriMesh index, stored in 1, 2 or 4 bytes in binary.
+	virtual uint32_t	Index( uint32_t inBytes ) = 0;
+
+	virtual uint32_t	Enum( const KeywordTable& inTable ) = 0;
+	virtual std::string	String() = 0;
+	virtual void		RawData( uint8_t* outData, uint32_t inLength ) = 0;
+	virtual void		RawPadding( uint32_t inLength ) = 0;
+
+	// Label of the object at a file location, or empty for none.
+	virtual std::string	Location() = 0;
+	virtual uint32_t	ObjectType() = 0;
+};
+
+
+/*!
+	@class		FieldWriter
+
+	@abstract	Writes the fields of one object, in either binary or text form.
+*/
+class FieldWriter
+{
+public:
+	virtual				~FieldWriter() {}
+
+	virtual void		Uns8( uint8_t inValue ) = 0;
+	virtual void		Uns16( uint16_t inValue ) = 0;
+	virtual void		Uns32( uint32_t inValue ) = 0;
+	virtual void		Int32( int32_t inValue ) = 0;
+	virtual void		Float32( float inValue ) = 0;
+
+	// In text, inPerLine values are written on each line, or all on the
+	// current line if inPerLine is 0.
+	virtual void		Float32Array( const float* inValues, uint32_t inCount,
+									uint32_t inPerLine ) = 0;
+	virtual void		Index( uint32_t inValue, uint32_t inBytes ) = 0;
+
+	virtual void		Enum( uint32_t inValue, const KeywordTable& inTable ) = 0;
+	virtual void		String( const std::string& inValue ) = 0;
+	virtual void		RawData( const uint8_t* inData, uint32_t inLength ) = 0;
+	virtual void		RawPadding( uint32_t inLength ) = 0;
+
+	virtual void		Location( const std::string& inLabel ) = 0;
+	virtual void		ObjectType( uint32_t inType ) = 0;
+
+	// Start a new line in text; ignored in binary.
+	virtual void		LineBreak() = 0;
+};
+
+
+/*!
+	@struct		ItemHeader
+	@abstract	Describes the next item of the object stream.
+*/
+struct ItemHeader
+{
+	enum Kind
+	{
+		kObject,
+		kContainer,			// 'cntr' or 'bgng', whose children follow
+		kContainerEnd
+	};
+
+	Kind			kind;
+	uint32_t		typeCode;	// binary input only, else 0
+	std::string		className;	// text input only, else empty
+	std::string		label;		// target of a TOC entry, or empty
+	uint64_t		offset;		// input offset, for messages
+};
+
+
+/*!
+	@class		ObjectReader
+
+	@abstract	Reads a 3DMF stream as a header followed by a sequence of
+				items.  The fields of each object are read through the
+				FieldReader interface between NextItem and EndObject.
+*/
+class ObjectReader : public FieldReader
+{
+public:
+	virtual void		BeginHeader() = 0;
+	virtual void		EndHeader() = 0;
+
+	virtual bool		NextItem( ItemHeader& outItem ) = 0;
+
+	// Bytes of binary data not consumed by the codec.
+	virtual uint64_t	TrailingBytes() = 0;
+
+	// Finish the current object, returning false if data other than
+	// padding had to be skipped.
+	virtual bool		EndObject() = 0;
+
+	virtual uint64_t	Offset() = 0;
+};
+
+
+/*!
+	@class		ObjectWriter
+
+	@abstract	Writes a 3DMF stream.  Between BeginObject and EndObject, the
+				fields of the object are written through the FieldWriter
+				interface.
+*/
+class ObjectWriter : public FieldWriter
+{
+public:
+	virtual void		BeginHeader() = 0;
+	virtual void		EndHeader() = 0;
+
+	virtual void		BeginObject( uint32_t inType, const std::string& inClassName,
+									const std::string& inLabel ) = 0;
+	virtual void		EndObject() = 0;
+
+	virtual void		BeginContainer( uint32_t inType, const std::string& inClassName,
+									const std::string& inLabel ) = 0;
+	virtual void		EndContainer() = 0;
+
+	// Resolve forward references and flush.
+	virtual void		Finish() = 0;
+};
@@ -0,0 +1,810 @@
+/*
+ *  TextIO.cpp
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "TextIO.h"
+
+#include "ByteStreams.h"
+#include "TranscodeException.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+namespace
+{
+	bool	IsBlank( int inChar )
+	{
+		return (inChar == ' ') || (inChar == '\t') || (inChar == '\r') ||
+			(inChar == '\n') || (inChar == '\f') || (inChar == '\v');
+	}
+
+	bool	IsDelimiter( int inChar )
+	{
+		return IsBlank( inChar ) || (inChar == '(') || (inChar == ')') ||
+			(inChar == '|') || (inChar == '"') || (inChar == EOF);
+	}
+
+	// Quesa reads a number up to the first character that cannot continue
+	// it, so hand-written files sometimes separate numbers with commas.
+	bool	IsNumberEnd( const char* inText )
+	{
+		return (inText[0] == '\0') || ( (inText[0] == ',') && (inText[1] == '\0') );
+	}
+
+	void	Trim( std::string& ioText )
+	{
+		std::string::size_type start = 0;
+		while ( (start < ioText.size()) && IsBlank( ioText[start] ) )
+		{
+			++start;
+		}
+		std::string::size_type end = ioText.size();
+		while ( (end > start) && IsBlank( ioText[end - 1] ) )
+		{
+			--end;
+		}
+		ioText = ioText.substr( start, end - start );
+	}
+
+	int		HexValue( char inChar )
+	{
+		if ( (inChar >= '0') && (inChar <= '9') )
+		{
+			return inChar - '0';
+		}
+		if ( (inChar >= 'a') && (inChar <= 'f') )
+		{
+			return inChar - 'a' + 10;
+		}
+		if ( (inChar >= 'A') && (inChar <= 'F') )
+		{
+			return inChar - 'A' + 10;
+		}
+		return -1;
+	}
+
+	bool	LooksNumeric( const std::string& inText )
+	{
+		return (! inText.empty()) && ( isdigit( (unsigned char) inText[0] ) ||
+			(inText[0] == '-') || (inText[0] == '+') || (inText[0] == '.') );
+	}
+}
+
+#pragma mark TextReader
+
+TextReader::TextReader( InputStream& inStream, TypeNamer& inNamer )
+	: mStream( inStream )
+	, mNamer( inNamer )
+	, mHavePeek( false )
+	, mContainerDepth( 0 )
+	, mHexPos( 0 )
+{
+}
+
+void	TextReader::SkipBlanks()
+{
+	for (;;)
+	{
+		int theChar = mStream.PeekByte();
+		if (IsBlank( theChar ))
+		{
+			mStream.GetByte();
+		}
+		else if (theChar == '#')
+		{
+			do
+			{
+				theChar = mStream.GetByte();
+			} while ( (theChar != '\n') && (theChar != '\r') && (theChar != EOF) );
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+void	TextReader::ReadQuoted( std::string& outText )
+{
+	mStream.GetByte();	// opening quote
+
+	for (;;)
+	{
+		int theChar = mStream.GetByte();
+		if (theChar == EOF)
+		{
+			throw TranscodeException( "Unterminated string", mStream.Position() );
+		}
+		if (theChar == '"')
+		{
+			break;
+		}
+		if (theChar == '\\')
+		{
+			theChar = mStream.GetByte();
+			switch (theChar)
+			{
+				case 'n':	theChar = '\n';	break;
+				case 'r':	theChar = '\r';	break;
+				case 't':	theChar = '\t';	break;
+				case EOF:
+					throw TranscodeException( "Unterminated string", mStream.Position() );
+			}
+		}
+		outText += static_cast<char>( theChar );
+	}
+}
+
+const TextReader::Token&	TextReader::PeekToken()
+{
+	if (! mHavePeek)
+	{
+		SkipBlanks();
+
+		mToken.text.clear();
+		mToken.isQuoted = false;
+		mToken.offset = mStream.Position();
+
+		int theChar = mStream.PeekByte();
+		if (theChar == '"')
+		{
+			mToken.isQuoted = true;
+			ReadQuoted( mToken.text );
+		}
+		else if ( (theChar == '(') || (theChar == ')') || (theChar == '|') )
+		{
+			mToken.text = static_cast<char>( mStream.GetByte() );
+		}
+		else
+		{
+			while (! IsDelimiter( mStream.PeekByte() ))
+			{
+				mToken.text += static_cast<char>( mStream.GetByte() );
+			}
+		}
+		mHavePeek = true;
+	}
+	return mToken;
+}
+
+const TextReader::Token&	TextReader::NextToken()
+{
+	PeekToken();
+	mHavePeek = false;
+	return mToken;
+}
+
+bool	TextReader::IsCloseToken( const Token& inToken ) const
+{
+	return (! inToken.isQuoted) && ( inToken.text.empty() || (inToken.text == ")") );
+}
+
+const TextReader::Token&	TextReader::NextFieldToken()
+{
+	if (IsCloseToken( PeekToken() ))
+	{
+		throw TranscodeException( "Object data too short", mToken.offset );
+	}
+	return NextToken();
+}
+
+void	TextReader::BeginHeader()
+{
+	ItemHeader header;
+	if ( (! NextItem( header )) || (header.className != "3DMetafile") )
+	{
+		throw TranscodeException( "Not a 3DMF file", 0 );
+	}
+}
+
+void	TextReader::EndHeader()
+{
+	EndObject();
+}
+
+bool	TextReader::NextItem( ItemHeader& outItem )
+{
+	outItem.typeCode = 0;
+	outItem.label.clear();
+	mHexDigits.clear();
+	mHexPos = 0;
+
+	for (;;)
+	{
+		SkipBlanks();
+		outItem.offset = mStream.Position();
+
+		int theChar = mStream.PeekByte();
+		if (theChar == EOF)
+		{
+			if (mContainerDepth > 0)
+			{
+				throw TranscodeException( "Unexpected end of input in container",
+					outItem.offset );
+			}
+			return false;
+		}
+		if (theChar == ')')
+		{
+			mStream.GetByte();
+			if (mContainerDepth == 0)
+			{
+				throw TranscodeException( "Unbalanced parenthesis", outItem.offset );
+			}
+			mContainerDepth -= 1;
+			outItem.kind = ItemHeader::kContainerEnd;
+			return true;
+		}
+
+		// Class names may contain spaces, so read up to the parenthesis.
+		std::string name;
+		while ( (theChar != '(') && (theChar != '\n') && (theChar != '\r') &&
+			(theChar != '#') && (theChar != EOF) )
+		{
+			name += static_cast<char>( mStream.GetByte() );
+			theChar = mStream.PeekByte();
+		}
+		Trim( name );
+
+		std::string::size_type wordEnd = name.find_first_of( " \t" );
+		std::string firstWord( name, 0, wordEnd );
+		if ( (! firstWord.empty()) && (firstWord[ firstWord.size() - 1 ] == ':') )
+		{
+			outItem.label = firstWord.substr( 0, firstWord.size() - 1 );
+			name.erase( 0, firstWord.size() );
+			Trim( name );
+			if (name.empty())
+			{
+				continue;
+			}
+		}
+
+		SkipBlanks();
+		if ( name.empty() || (mStream.GetByte() != '(') )
+		{
+			throw TranscodeException( "Expected an object", outItem.offset );
+		}
+		outItem.className = name;
+
+		if ( (name == "Container") || (name == "BeginGroup") )
+		{
+			outItem.kind = ItemHeader::kContainer;
+			outItem.typeCode = (name == "Container")? 'cntr' : 'bgng';
+			mContainerDepth += 1;
+		}
+		else
+		{
+			outItem.kind = ItemHeader::kObject;
+		}
+		return true;
+	}
+}
+
+uint64_t	TextReader::TrailingBytes()
+{
+	return 0;
+}
+
+bool	TextReader::EndObject()
+{
+	bool onlyPadding = true;
+
+	for (; mHexPos < mHexDigits.size(); ++mHexPos)
+	{
+		onlyPadding = onlyPadding && (mHexDigits[ mHexPos ] == '0');
+	}
+
+	for (;;)
+	{
+		const Token& theToken = NextToken();
+		if (IsCloseToken( theToken ))
+		{
+			if (theToken.text.empty())
+			{
+				throw TranscodeException( "Unexpected end of input", theToken.offset );
+			}
+			break;
+		}
+		onlyPadding = false;
+	}
+
+	return onlyPadding;
+}
+
+uint64_t	TextReader::Offset()
+{
+	return mHavePeek? mToken.offset : mStream.Position();
+}
+
+bool	TextReader::AtEnd()
+{
+	return IsCloseToken( PeekToken() );
+}
+
+int64_t		TextReader::Integer()
+{
+	const Token& theToken = NextFieldToken();
+	const char* start = theToken.text.c_str();
+	char* end = NULL;
+	int64_t value;
+
+	if ( (start[0] == '0') && ( (start[1] == 'x') || (start[1] == 'X') ) )
+	{
+		value = static_cast<int64_t>( strtoull( start, &end, 16 ) );
+	}
+	else if (start[0] == '-')
+	{
+		value = strtoll( start, &end, 10 );
+	}
+	else
+	{
+		value = static_cast<int64_t>( strtoull( start, &end, 10 ) );
+	}
+
+	if ( (end == start) || (! IsNumberEnd( end )) )
+	{
+		throw TranscodeException( "Expected an integer, found '" + theToken.text + "'",
+			theToken.offset );
+	}
+
+	return value;
+}
+
+uint8_t		TextReader::Uns8()
+{
+	return static_cast<uint8_t>( Integer() );
+}
+
+uint16_t	TextReader::Uns16()
+{
+	return static_cast<uint16_t>( Integer() );
+}
+
+uint32_t	TextReader::Uns32()
+{
+	return static_cast<uint32_t>( Integer() );
+}
+
+int32_t		TextReader::Int32()
+{
+	return static_cast<int32_t>( Integer() );
+}
+
+float		TextReader::Float32()
+{
+	const Token& theToken = NextFieldToken();
+	const char* start = theToken.text.c_str();
+	char* end = NULL;
+	float value = static_cast<float>( strtod( start, &end ) );
+
+	if ( (end == start) || (! IsNumberEnd( end )) )
+	{
+		throw TranscodeException( "Expected a number, found '" + theToken.text + "'",
+			theToken.offset );
+	}
+
+	return value;
+}
+
+void	TextReader::Float32Array( float* outValues, uint32_t inCount )
+{
+	for (uint32_t i = 0; i < inCount; ++i)
+	{
+		outValues[i] = Float32();
+	}
+}
+
+uint32_t	TextReader::Index( uint32_t )
+{
+	return Uns32();
+}
+
+uint32_t	TextReader::Enum( const KeywordTable& inTable )
+{
+	uint32_t result = 0;
+
+	for (;;)
+	{
+		if (LooksNumeric( PeekToken().text ) && ! mToken.isQuoted)
+		{
+			result |= static_cast<uint32_t>( Integer() );
+		}
+		else
+		{
+			const Token& theToken = NextFieldToken();
+			uint32_t i;
+			for (i = 0; i < inTable.count; ++i)
+			{
+				if (strcasecmp( theToken.text.c_str(), inTable.keywords[i].name ) == 0)
+				{
+					result |= inTable.keywords[i].value;
+					break;
+				}
+			}
+			if (i == inTable.count)
+			{
+				throw TranscodeException( "Unknown keyword '" + theToken.text + "'",
+					theToken.offset );
+			}
+		}
+
+		if ( (! inTable.isMask) || (PeekToken().text != "|") || mToken.isQuoted )
+		{
+			break;
+		}
+		NextToken();
+	}
+
+	return result;
+}
+
+std::string	TextReader::String()
+{
+	return NextFieldToken().text;
+}
+
+void	TextReader::RawData( uint8_t* outData, uint32_t inLength )
+{
+	for (uint32_t i = 0; i < inLength; ++i)
+	{
+		if (mHexPos >= mHexDigits.size())
+		{
+			const Token& theToken = NextFieldToken();
+			if ( (theToken.text.size() < 2) || (theToken.text[0] != '0') ||
+				( (theToken.text[1] != 'x') && (theToken.text[1] != 'X') ) )
+			{
+				throw TranscodeException( "Expected hexadecimal data", theToken.offset );
+			}
+			mHexDigits.assign( theToken.text, 2, std::string::npos );
+			mHexPos = 0;
+			if ( (mHexDigits.size() % 2) != 0 )
+			{
+				throw TranscodeException( "Odd number of hexadecimal digits",
+					theToken.offset );
+			}
+		}
+
+		int high = HexValue( mHexDigits[ mHexPos ] );
+		int low = HexValue( mHexDigits[ mHexPos + 1 ] );
+		if ( (high < 0) || (low < 0) )
+		{
+			throw TranscodeException( "Bad hexadecimal digit", mStream.Position() );
+		}
+		outData[i] = static_cast<uint8_t>( (high << 4) | low );
+		mHexPos += 2;
+	}
+}
+
+void	TextReader::RawPadding( uint32_t )
+{
+}
+
+std::string	TextReader::Location()
+{
+	const Token& theToken = NextFieldToken();
+	if ( theToken.isQuoted || theToken.text.empty() ||
+		(theToken.text[ theToken.text.size() - 1 ] != '>') )
+	{
+		throw TranscodeException( "Expected a location, found '" + theToken.text + "'",
+			theToken.offset );
+	}
+	return theToken.text.substr( 0, theToken.text.size() - 1 );
+}
+
+uint32_t	TextReader::ObjectType()
+{
+	if (LooksNumeric( PeekToken().text ))
+	{
+		return static_cast<uint32_t>( Integer() );
+	}
+
+	const Token& theToken = NextFieldToken();
+	uint32_t theType = mNamer.TypeForName( theToken.text );
+	if (theType == 0)
+	{
+		throw TranscodeException( "Unknown class '" + theToken.text + "'",
+			theToken.offset );
+	}
+	return theType;
+}
+
+#pragma mark TextWriter
+
+TextWriter::TextWriter( OutputStream& inStream, TypeNamer& inNamer )
+	: mStream( inStream )
+	, mNamer( inNamer )
+	, mDepth( 0 )
+	, mNeedBreak( false )
+	, mMultiLine( false )
+	, mRawColumn( 0 )
+{
+}
+
+void	TextWriter::Indent( uint32_t inExtra )
+{
+	for (uint32_t i = 0; i < mDepth + inExtra; ++i)
+	{
+		mStream.Put( '\t' );
+	}
+}
+
+void	TextWriter::BeginField()
+{
+	if (mNeedBreak)
+	{
+		mStream.Put( '\n' );
+		Indent( 1 );
+		mNeedBreak = false;
+		mMultiLine = true;
+	}
+	else
+	{
+		mStream.Put( ' ' );
+	}
+	mRawColumn = 0;
+}
+
+void	TextWriter::WriteLabel( const std::string& inLabel )
+{
+	if (! inLabel.empty())
+	{
+		Indent( 0 );
+		mStream.Write( inLabel );
+		mStream.Write( ":\n", 2 );
+	}
+}
+
+void	TextWriter::BeginHeader()
+{
+	BeginObject( 0, "3DMetafile", std::string() );
+}
+
+void	TextWriter::EndHeader()
+{
+	EndObject();
+}
+
+void	TextWriter::BeginObject( uint32_t, const std::string& inClassName,
+									const std::string& inLabel )
+{
+	WriteLabel( inLabel );
+	Indent( 0 );
+	mStream.Write( inClassName );
+	mStream.Write( " (", 2 );
+
+	mNeedBreak = false;
+	mMultiLine = false;
+	mRawColumn = 0;
+}
+
+void	TextWriter::EndObject()
+{
+	if (mMultiLine)
+	{
+		mStream.Put( '\n' );
+		Indent( 0 );
+		mStream.Write( ")\n", 2 );
+	}
+	else
+	{
+		mStream.Write( " )\n", 3 );
+	}
+}
+
+void	TextWriter::BeginContainer( uint32_t, const std::string& inClassName,
+									const std::string& inLabel )
+{
+	WriteLabel( inLabel );
+	Indent( 0 );
+	mStream.Write( inClassName );
+	mStream.Write( " (\n", 3 );
+	mDepth += 1;
+}
+
+void	TextWriter::EndContainer()
+{
+	mDepth -= 1;
+	Indent( 0 );
+	mStream.Write( ")\n", 2 );
+}
+
+void	TextWriter::Finish()
+{
+	mStream.Flush();
+}
+
+void	TextWriter::Uns8( uint8_t inValue )
+{
+	Uns32( inValue );
+}
+
+void	TextWriter::Uns16( uint16_t inValue )
+{
+	Uns32( inValue );
+}
+
+void	TextWriter::Uns32( uint32_t inValue )
+{
+	char buffer[16];
+	int len = snprintf( buffer, sizeof(buffer), "%lu", (unsigned long) inValue );
+	BeginField();
+	mStream.Write( buffer, len );
+}
+
+void	TextWriter::Int32( int32_t inValue )
+{
+	char buffer[16];
+	int len = snprintf( buffer, sizeof(buffer), "%ld", (long) inValue );
+	BeginField();
+	mStream.Write( buffer, len );
+}
+
+void	TextWriter::Float32( float inValue )
+{
+	// Use the shortest of the two forms that reads back exactly.
+	char buffer[32];
+	int len = snprintf( buffer, sizeof(buffer), "%.7g", inValue );
+	if (static_cast<float>( strtod( buffer, NULL ) ) != inValue)
+	{
+		len = snprintf( buffer, sizeof(buffer), "%.9g", inValue );
+	}
+	BeginField();
+	mStream.Write( buffer, len );
+}
+
+void	TextWriter::Float32Array( const float* inValues, uint32_t inCount,
+									uint32_t inPerLine )
+{
+	for (uint32_t i = 0; i < inCount; ++i)
+	{
+		if ( (inPerLine != 0) && ((i % inPerLine) == 0) )
+		{
+			LineBreak();
+		}
+		Float32( inValues[i] );
+	}
+}
+
+void	TextWriter::Index( uint32_t inValue, uint32_t )
+{
+	Uns32( inValue );
+}
+
+void	TextWriter::Enum( uint32_t inValue, const KeywordTable& inTable )
+{
+	const char* zeroName = NULL;
+	uint32_t remaining = inValue;
+	bool wroteSomething = false;
+
+	for (uint32_t i = 0; i < inTable.count; ++i)
+	{
+		const Keyword& theKeyword( inTable.keywords[i] );
+		if (inTable.isMask)
+		{
+			if (theKeyword.value == 0)
+			{
+				if (zeroName == NULL)
+				{
+					zeroName = theKeyword.name;
+				}
+			}
+			else if ( (remaining & theKeyword.value) == theKeyword.value )
+			{
+				if (wroteSomething)
+				{
+					mStream.Write( " |", 2 );
+				}
+				BeginField();
+				mStream.Write( theKeyword.name, strlen( theKeyword.name ) );
+				remaining &= ~theKeyword.value;
+				wroteSomething = true;
+			}
+		}
+		else if (theKeyword.value == inValue)
+		{
+			BeginField();
+			mStream.Write( theKeyword.name, strlen( theKeyword.name ) );
+			return;
+		}
+	}
+
+	if ( inTable.isMask && (remaining == 0) && (! wroteSomething) && (zeroName != NULL) )
+	{
+		BeginField();
+		mStream.Write( zeroName, strlen( zeroName ) );
+	}
+	else if ( (! inTable.isMask) || (remaining != 0) || (! wroteSomething) )
+	{
+		// No keyword for (the rest of) the value, so write it as a number.
+		if (wroteSomething)
+		{
+			mStream.Write( " |", 2 );
+		}
+		Uns32( remaining );
+	}
+}
+
+void	TextWriter::String( const std::string& inValue )
+{
+	BeginField();
+	mStream.Put( '"' );
+
+	for (std::string::const_iterator i = inValue.begin(); i != inValue.end(); ++i)
+	{
+		switch (*i)
+		{
+			case '"':	mStream.Write( "\\\"", 2 );	break;
+			case '\t':	mStream.Write( "\\t", 2 );	break;
+			case '\r':	mStream.Write( "\\r", 2 );	break;
+			case '\n':	mStream.Write( "\\n", 2 );	break;
+			case '\\':	mStream.Write( "\\\\", 2 );	break;
+			default:	mStream.Put( *i );			break;
+		}
+	}
+
+	mStream.Put( '"' );
+}
+
+void	TextWriter::RawData( const uint8_t* inData, uint32_t inLength )
+{
+	static const char kHexDigits[] = "0123456789ABCDEF";
+
+	for (uint32_t i = 0; i < inLength; ++i)
+	{
+		if ( (mRawColumn % 16) == 0 )
+		{
+			LineBreak();
+			BeginField();
+			mStream.Write( "0x", 2 );
+		}
+		mStream.Put( kHexDigits[ inData[i] >> 4 ] );
+		mStream.Put( kHexDigits[ inData[i] & 0x0F ] );
+		mRawColumn += 1;
+	}
+}
+
+void	TextWriter::RawPadding( uint32_t )
+{
+}
+
+void	TextWriter::Location( const std::string& inLabel )
+{
+	BeginField();
+	mStream.Write( inLabel.empty()? std::string( "none" ) : inLabel );
+	mStream.Put( '>' );
+}
+
+void	TextWriter::ObjectType( uint32_t inType )
+{
+	BeginField();
+	mStream.Write( mNamer.NameForType( inType ) );
+}
+
+void	TextWriter::LineBreak()
+{
+	mNeedBreak = true;
+}
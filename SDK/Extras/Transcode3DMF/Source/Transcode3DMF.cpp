@@ -0,0 +1,525 @@
+/*
+ *  Transcode3DMF.cpp
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "Transcode3DMF.h"
+
+#include "BinaryIO.h"
+#include "ByteStreams.h"
+#include "TextIO.h"
+#include "TranscodeException.h"
+#include "TypeCodecs.h"
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+
+namespace
+{
+	const uint32_t	kRawChunk = 4096;
+
+	std::string	TypeCodeString( uint32_t inType )
+	{
+		// Custom types have negative codes, which are rarely printable.
+		if (static_cast<int32_t>( inType ) < 0)
+		{
+			std::ostringstream ss;
+			ss << static_cast<int32_t>( inType );
+			return ss.str();
+		}
+
+		std::string result( 1, '\'' );
+		for (int shift = 24; shift >= 0; shift -= 8)
+		{
+			result += static_cast<char>( inType >> shift );
+		}
+		result += '\'';
+		return result;
+	}
+
+
+	/*!
+		@class		TypeRegistry
+
+		@abstract	Class names of the known codecs, plus those of custom
+					types declared by 'type' objects in binary input.
+	*/
+	class TypeRegistry : public TypeNamer
+	{
+	public:
+		void					Declare( uint32_t inType, const std::string& inName )
+									{ mCustomNames[ inType ] = inName; }
+		std::string				CustomName( uint32_t inType ) const;
+		const TypeCodecInfo*	CodecForType( uint32_t inType ) const;
+
+		virtual std::string		NameForType( uint32_t inType );
+		virtual uint32_t		TypeForName( const std::string& inName );
+
+	private:
+		std::map<uint32_t, std::string>		mCustomNames;
+	};
+
+
+	/*!
+		@class		Transcoder
+
+		@abstract	Drives the copy of a 3DMF stream from a reader to a
+					writer, handling the objects that no codec describes.
+	*/
+	class Transcoder
+	{
+	public:
+					Transcoder( ObjectReader& inReader, ObjectWriter& inWriter,
+								TypeRegistry& inRegistry,
+								bool inBinaryIn, bool inBigEndianIn,
+								bool inBinaryOut, bool inBigEndianOut,
+								std::ostream& inErrStream );
+
+		void		Run();
+
+	private:
+		void		TranscodeObject( const ItemHeader& inItem );
+		void		TranscodeTypeDeclaration( const ItemHeader& inItem );
+		void		TranscodeUnknownBinary( const ItemHeader& inItem );
+		void		TranscodeUnknownBinaryText( const ItemHeader& inItem );
+		void		TranscodeUnknownBinaryType( const ItemHeader& inItem );
+		void		DeclareType( uint32_t inType, const std::string& inName );
+		void		CopyRaw( uint64_t inLength );
+		void		EndObject( const std::string& inClassName, uint64_t inOffset );
+		void		Warn( const std::string& inMessage, uint64_t inOffset );
+
+		ObjectReader&		mReader;
+		ObjectWriter&		mWriter;
+		TypeRegistry&		mRegistry;
+		bool				mBinaryIn;
+		bool				mBigEndianIn;
+		bool				mBinaryOut;
+		bool				mBigEndianOut;
+		std::ostream&		mErrStream;
+		CodecContext		mContext;
+		std::set<uint32_t>	mDeclaredTypes;
+		std::set<uint32_t>	mReportedTypes;
+		uint32_t			mLastUnknownType;
+	};
+}
+
+#pragma mark TypeRegistry
+
+std::string	TypeRegistry::CustomName( uint32_t inType ) const
+{
+	std::map<uint32_t, std::string>::const_iterator found = mCustomNames.find( inType );
+	return (found == mCustomNames.end())? std::string() : found->second;
+}
+
+const TypeCodecInfo*	TypeRegistry::CodecForType( uint32_t inType ) const
+{
+	// Custom type codes are only meaningful within one file, so prefer the
+	// declared name to the code.
+	std::string customName( CustomName( inType ) );
+	if (! customName.empty())
+	{
+		const TypeCodecInfo* codec = FindCodecByName( customName );
+		if (codec != NULL)
+		{
+			return codec;
+		}
+	}
+	return FindCodecByType( inType );
+}
+
+std::string	TypeRegistry::NameForType( uint32_t inType )
+{
+	const TypeCodecInfo* codec = CodecForType( inType );
+	if (codec != NULL)
+	{
+		return codec->className;
+	}
+
+	std::string customName( CustomName( inType ) );
+	if (! customName.empty())
+	{
+		return customName;
+	}
+
+	std::ostringstream ss;
+	ss << static_cast<int32_t>( inType );
+	return ss.str();
+}
+
+uint32_t	TypeRegistry::TypeForName( const std::string& inName )
+{
+	const TypeCodecInfo* codec = FindCodecByName( inName );
+	if (codec != NULL)
+	{
+		return codec->typeCode;
+	}
+
+	for (std::map<uint32_t, std::string>::const_iterator i = mCustomNames.begin();
+		i != mCustomNames.end(); ++i)
+	{
+		if (i->second == inName)
+		{
+			return i->first;
+		}
+	}
+
+	return 0;
+}
+
+#pragma mark Transcoder
+
+Transcoder::Transcoder( ObjectReader& inReader, ObjectWriter& inWriter,
+						TypeRegistry& inRegistry,
+						bool inBinaryIn, bool inBigEndianIn,
+						bool inBinaryOut, bool inBigEndianOut,
+						std::ostream& inErrStream )
+	: mReader( inReader )
+	, mWriter( inWriter )
+	, mRegistry( inRegistry )
+	, mBinaryIn( inBinaryIn )
+	, mBigEndianIn( inBigEndianIn )
+	, mBinaryOut( inBinaryOut )
+	, mBigEndianOut( inBigEndianOut )
+	, mErrStream( inErrStream )
+	, mLastUnknownType( 0 )
+{
+}
+
+void	Transcoder::Warn( const std::string& inMessage, uint64_t inOffset )
+{
+	mErrStream << inMessage << " at offset " << inOffset << ".\n";
+}
+
+void	Transcoder::Run()
+{
+	mReader.BeginHeader();
+	mWriter.BeginHeader();
+	TranscodeHeader( mReader, mWriter );
+	mReader.EndHeader();
+	mWriter.EndHeader();
+
+	ItemHeader item;
+
+	while (mReader.NextItem( item ))
+	{
+		switch (item.kind)
+		{
+			case ItemHeader::kContainer:
+				mWriter.BeginContainer( item.typeCode,
+					(item.typeCode == 'cntr')? "Container" : "BeginGroup", item.label );
+				break;
+
+			case ItemHeader::kContainerEnd:
+				mWriter.EndContainer();
+				break;
+
+			case ItemHeader::kObject:
+				TranscodeObject( item );
+				break;
+		}
+	}
+
+	mWriter.Finish();
+}
+
+void	Transcoder::TranscodeObject( const ItemHeader& inItem )
+{
+	const TypeCodecInfo* codec = NULL;
+
+	if (mBinaryIn)
+	{
+		if (inItem.typeCode == 'type')
+		{
+			TranscodeTypeDeclaration( inItem );
+			return;
+		}
+
+		codec = mRegistry.CodecForType( inItem.typeCode );
+		if (codec == NULL)
+		{
+			TranscodeUnknownBinary( inItem );
+			return;
+		}
+	}
+	else
+	{
+		if (inItem.className == "UnknownBinary")
+		{
+			TranscodeUnknownBinaryText( inItem );
+			return;
+		}
+		if (inItem.className == "UnknownBinaryType")
+		{
+			TranscodeUnknownBinaryType( inItem );
+			return;
+		}
+
+		codec = FindCodecByName( inItem.className );
+		if (codec == NULL)
+		{
+			Warn( "Skipped unknown class '" + inItem.className + "'", inItem.offset );
+			mReader.EndObject();
+			return;
+		}
+	}
+
+	// Keep the code of binary input, since a custom type code must match
+	// the file's 'type' declaration.
+	uint32_t outType = mBinaryIn? inItem.typeCode : codec->typeCode;
+	DeclareType( outType, codec->className );
+
+	mWriter.BeginObject( outType, codec->className, inItem.label );
+	codec->codec( mReader, mWriter, mContext );
+
+	uint64_t trailing = mReader.TrailingBytes();
+	if ( mBinaryOut && (trailing > 0) )
+	{
+		if (trailing >= 4)
+		{
+			std::ostringstream ss;
+			ss << "Copied " << trailing << " bytes of unrecognized data at the end of " <<
+				codec->className;
+			Warn( ss.str(), inItem.offset );
+		}
+		CopyRaw( trailing );
+	}
+
+	EndObject( codec->className, inItem.offset );
+	mWriter.EndObject();
+}
+
+void	Transcoder::EndObject( const std::string& inClassName, uint64_t inOffset )
+{
+	if (! mReader.EndObject())
+	{
+		Warn( "Skipped unrecognized data at the end of " + inClassName, inOffset );
+	}
+}
+
+void	Transcoder::CopyRaw( uint64_t inLength )
+{
+	uint8_t buffer[ kRawChunk ];
+
+	while (inLength > 0)
+	{
+		uint32_t chunk = (inLength < kRawChunk)? static_cast<uint32_t>( inLength ) : kRawChunk;
+		mReader.RawData( buffer, chunk );
+		mWriter.RawData( buffer, chunk );
+		inLength -= chunk;
+	}
+}
+
+// Binary output must declare a custom type before its first use.
+void	Transcoder::DeclareType( uint32_t inType, const std::string& inName )
+{
+	if ( mBinaryOut && (static_cast<int32_t>( inType ) < 0) &&
+		(mDeclaredTypes.count( inType ) == 0) )
+	{
+		mWriter.BeginObject( 'type', "Type", std::string() );
+		mWriter.Int32( static_cast<int32_t>( inType ) );
+		mWriter.String( inName );
+		mWriter.EndObject();
+		mDeclaredTypes.insert( inType );
+	}
+}
+
+void	Transcoder::TranscodeTypeDeclaration( const ItemHeader& inItem )
+{
+	uint32_t theType = static_cast<uint32_t>( mReader.Int32() );
+	std::string theName( mReader.String() );
+	EndObject( "Type", inItem.offset );
+
+	mRegistry.Declare( theType, theName );
+	DeclareType( theType, theName );
+}
+
+void	Transcoder::TranscodeUnknownBinary( const ItemHeader& inItem )
+{
+	uint64_t dataLen = mReader.TrailingBytes();
+	std::string customName( mRegistry.CustomName( inItem.typeCode ) );
+
+	if (mReportedTypes.count( inItem.typeCode ) == 0)
+	{
+		mReportedTypes.insert( inItem.typeCode );
+		std::string message( "Unknown object type " + TypeCodeString( inItem.typeCode ) );
+		if (! customName.empty())
+		{
+			message += " '" + customName + "'";
+		}
+		if ( mBinaryOut && (mBigEndianIn != mBigEndianOut) )
+		{
+			message += " copied without swapping bytes";
+		}
+		Warn( message, inItem.offset );
+	}
+
+	if (mBinaryOut)
+	{
+		mWriter.BeginObject( inItem.typeCode, customName, inItem.label );
+		CopyRaw( dataLen );
+		mWriter.EndObject();
+	}
+	else
+	{
+		mWriter.BeginObject( 0, "UnknownBinary", inItem.label );
+		mWriter.Int32( static_cast<int32_t>( inItem.typeCode ) );
+		mWriter.Uns32( static_cast<uint32_t>( dataLen ) );
+		mWriter.Enum( mBigEndianIn? 0 : 1, kByteOrderKeywords );
+		CopyRaw( dataLen );
+		mWriter.EndObject();
+
+		if (! customName.empty())
+		{
+			mWriter.BeginObject( 0, "UnknownBinaryType", std::string() );
+			mWriter.String( customName );
+			mWriter.EndObject();
+		}
+	}
+
+	mReader.EndObject();
+}
+
+void	Transcoder::TranscodeUnknownBinaryText( const ItemHeader& inItem )
+{
+	uint32_t theType = static_cast<uint32_t>( mReader.Int32() );
+	uint32_t dataLen = mReader.Uns32();
+	uint32_t byteOrder = mReader.Enum( kByteOrderKeywords );
+	mLastUnknownType = theType;
+
+	if (mBinaryOut)
+	{
+		if ( (byteOrder == 0) != mBigEndianOut )
+		{
+			Warn( "Unknown object type " + TypeCodeString( theType ) +
+				" copied without swapping bytes", inItem.offset );
+		}
+		mWriter.BeginObject( theType, std::string(), inItem.label );
+		CopyRaw( dataLen );
+		mWriter.EndObject();
+	}
+	else
+	{
+		mWriter.BeginObject( 0, inItem.className, inItem.label );
+		mWriter.Int32( static_cast<int32_t>( theType ) );
+		mWriter.Uns32( dataLen );
+		mWriter.Enum( byteOrder, kByteOrderKeywords );
+		CopyRaw( dataLen );
+		mWriter.EndObject();
+	}
+
+	EndObject( inItem.className, inItem.offset );
+}
+
+void	Transcoder::TranscodeUnknownBinaryType( const ItemHeader& inItem )
+{
+	std::string theName( mReader.String() );
+	EndObject( inItem.className, inItem.offset );
+
+	if (mBinaryOut)
+	{
+		// Too late to help a reader with the preceding object, but it keeps
+		// the class name in the file.
+		DeclareType( mLastUnknownType, theName );
+	}
+	else
+	{
+		mWriter.BeginObject( 0, inItem.className, inItem.label );
+		mWriter.String( theName );
+		mWriter.EndObject();
+	}
+}
+
+#pragma mark Transcode3DMF
+
+bool	Transcode3DMF( FILE* inInput,
+						FILE* inOutput,
+						ETranscodeForm inForm,
+						std::ostream& inErrStream )
+{
+	InputStream input( inInput );
+	OutputStream output( inOutput );
+	TypeRegistry registry;
+	std::unique_ptr<ObjectReader> reader;
+	bool success = false;
+
+	try
+	{
+		uint8_t magic[4] = { 0, 0, 0, 0 };
+		for (int i = 0; (i < 4) && (input.PeekByte() != EOF); ++i)
+		{
+			magic[i] = static_cast<uint8_t>( input.GetByte() );
+		}
+		input.Seek( 0 );
+
+		bool binaryIn = (memcmp( magic, "3DMF", 4 ) == 0) ||
+			(memcmp( magic, "FMD3", 4 ) == 0);
+		bool bigEndianIn = (memcmp( magic, "3DMF", 4 ) == 0);
+
+		if (binaryIn)
+		{
+			BinaryReader* binaryReader = new BinaryReader( input, bigEndianIn );
+			reader.reset( binaryReader );
+			binaryReader->ScanTOCs();
+		}
+		else
+		{
+			reader.reset( new TextReader( input, registry ) );
+		}
+
+		if (inForm == kTranscodeToOtherForm)
+		{
+			inForm = binaryIn? kTranscodeToText : kTranscodeToBigEndian;
+		}
+		bool binaryOut = (inForm != kTranscodeToText);
+		bool bigEndianOut = (inForm == kTranscodeToBigEndian);
+
+		std::unique_ptr<ObjectWriter> writer;
+		if (binaryOut)
+		{
+			writer.reset( new BinaryWriter( output, bigEndianOut, inErrStream ) );
+		}
+		else
+		{
+			writer.reset( new TextWriter( output, registry ) );
+		}
+
+		Transcoder transcoder( *reader, *writer, registry, binaryIn, bigEndianIn,
+			binaryOut, bigEndianOut, inErrStream );
+		transcoder.Run();
+		success = true;
+	}
+	catch (const TranscodeException& excep)
+	{
+		uint64_t offset = excep.Offset();
+		if ( (offset == 0) && (reader.get() != NULL) )
+		{
+			offset = reader->Offset();
+		}
+		inErrStream << excep.Message() << " at offset " << offset << "!\n";
+	}
+
+	return success;
+}
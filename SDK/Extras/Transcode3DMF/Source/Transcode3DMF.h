@@ -0,0 +1,61 @@
+/*
+ *  Transcode3DMF.h
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#pragma once
+
+#include <cstdio>
+#include <ostream>
+
+enum ETranscodeForm
+{
+	kTranscodeToText,
+	kTranscodeToBigEndian,
+	kTranscodeToLittleEndian,
+	kTranscodeToOtherForm		// binary to text, text to big-endian binary
+};
+
+/*!
+	@function	Transcode3DMF
+
+	@abstract	Convert a 3DMF stream between text, big-endian binary and
+				little-endian binary, one object at a time.
+
+	@discussion	Objects are copied field by field without building any Quesa
+				objects, so memory use does not depend on the size of the
+				file, apart from one entry per table of contents entry.
+
+				Binary input and binary output must be seekable files.  Text
+				input and text output may be pipes.
+
+	@param		inInput			The input file, positioned at its start.
+	@param		inOutput		The output file, positioned at its start.
+	@param		inForm			The form to write.
+	@param		inErrStream		Stream for warnings and errors.
+	@result		True if the whole input was converted.
+*/
+bool	Transcode3DMF( FILE* inInput,
+						FILE* inOutput,
+						ETranscodeForm inForm,
+						std::ostream& inErrStream );
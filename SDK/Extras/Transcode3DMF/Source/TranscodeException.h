@@ -0,0 +1,51 @@
+/*
+ *  TranscodeException.h
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+/*!
+	@class		TranscodeException
+
+	@abstract	Thrown when the input cannot be transcoded, either because it
+				is malformed or because of an I/O failure.
+*/
+class TranscodeException
+{
+public:
+					TranscodeException( const std::string& inMessage,
+										uint64_t inOffset )
+						: mMessage( inMessage )
+						, mOffset( inOffset ) {}
+
+	const std::string&	Message() const { return mMessage; }
+	uint64_t			Offset() const { return mOffset; }
+
+private:
+	std::string		mMessage;
+	uint64_t		mOffset;
+};
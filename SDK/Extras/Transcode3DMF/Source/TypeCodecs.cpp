@@ -0,0 +1,897 @@
+/*
+ *  TypeCodecs.cpp
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "TypeCodecs.h"
+
+#include "TranscodeException.h"
+
+#include <map>
+
+namespace
+{
+	const uint32_t	kFloatChunk = 1024;
+	const uint32_t	kRawChunk = 4096;
+
+	const Keyword	kBoolean[] =
+	{
+		{ "False", 0 }, { "True", 1 }, { "Off", 0 }, { "On", 1 }
+	};
+	const Keyword	kSwitch[] =
+	{
+		{ "Off", 0 }, { "On", 1 }, { "False", 0 }, { "True", 1 }
+	};
+	const Keyword	kFileMode[] =
+	{
+		{ "Normal", 0 }, { "Stream", 1 }, { "Database", 2 }
+	};
+	const Keyword	kByteOrder[] =
+	{
+		{ "BigEndian", 0 }, { "LittleEndian", 1 }
+	};
+	const Keyword	kPixelType[] =
+	{
+		{ "RGB32", 0 }, { "ARGB32", 1 }, { "RGB16", 2 }, { "ARGB16", 3 },
+		{ "RGB16_565", 4 }, { "RGB24", 5 }
+	};
+	const Keyword	kBoundary[] =
+	{
+		{ "Wrap", 0 }, { "Clamp", 1 }, { "Mirror", 2 }
+	};
+	const Keyword	kAntialiasMode[] =
+	{
+		{ "None", 0 }, { "Edges", 1 }, { "Filled", 2 }, { "FullScreen", 4 }
+	};
+	const Keyword	kBackfacing[] =
+	{
+		{ "Both", 0 }, { "Culled", 1 }, { "Flipped", 2 }, { "CullFront", 3 }
+	};
+	const Keyword	kFill[] =
+	{
+		{ "Filled", 0 }, { "Edges", 1 }, { "Points", 2 }
+	};
+	const Keyword	kFogMode[] =
+	{
+		{ "Linear", 0 }, { "Exponential", 1 }, { "ExponentialSquared", 2 },
+		{ "Alpha", 3 }
+	};
+	const Keyword	kInterpolation[] =
+	{
+		{ "None", 0 }, { "Vertex", 1 }, { "Pixel", 2 }
+	};
+	const Keyword	kOrientation[] =
+	{
+		{ "CounterClockwise", 0 }, { "Clockwise", 1 }
+	};
+	const Keyword	kPickParts[] =
+	{
+		{ "Object", 0 }, { "Face", 1 }, { "Edge", 2 }, { "Vertex", 4 }
+	};
+	const Keyword	kSubdivision[] =
+	{
+		{ "Constant", 0 }, { "WorldSpace", 1 }, { "ScreenSpace", 2 }
+	};
+	const Keyword	kAxis[] =
+	{
+		{ "X", 0 }, { "Y", 1 }, { "Z", 2 }
+	};
+	const Keyword	kFalloff[] =
+	{
+		{ "None", 0 }, { "Linear", 1 }, { "Exponential", 2 }, { "Cosine", 3 },
+		{ "SmoothCubic", 4 }
+	};
+	const Keyword	kCaps[] =
+	{
+		{ "None", 0 }, { "Top", 1 }, { "Bottom", 2 }, { "Interior", 4 }
+	};
+	const Keyword	kPolygonHint[] =
+	{
+		{ "Complex", 0 }, { "Concave", 1 }, { "Convex", 2 }
+	};
+	const Keyword	kPacking[] =
+	{
+		{ "include", 0 }, { "exclude", 1 }
+	};
+	const Keyword	kGroupState[] =
+	{
+		{ "None", 0 }, { "Inline", 1 }, { "DoNotDraw", 2 }, { "NoBoundingBox", 4 },
+		{ "NoBoundingSphere", 8 }, { "DoNotPick", 16 }, { "DoNotBound", 32 },
+		{ "IsInline", 1 }
+	};
+	const Keyword	kTriangleEdges[] =
+	{
+		{ "None", 0 }, { "Edge01", 1 }, { "Edge12", 2 }, { "Edge20", 4 }
+	};
+
+	const KeywordTable	kBooleanKeywords = KEYWORD_TABLE( kBoolean, false );
+	const KeywordTable	kSwitchKeywords = KEYWORD_TABLE( kSwitch, false );
+	const KeywordTable	kFileModeKeywords = KEYWORD_TABLE( kFileMode, true );
+	const KeywordTable	kPixelTypeKeywords = KEYWORD_TABLE( kPixelType, false );
+	const KeywordTable	kBoundaryKeywords = KEYWORD_TABLE( kBoundary, false );
+	const KeywordTable	kAntialiasModeKeywords = KEYWORD_TABLE( kAntialiasMode, true );
+	const KeywordTable	kBackfacingKeywords = KEYWORD_TABLE( kBackfacing, false );
+	const KeywordTable	kFillKeywords = KEYWORD_TABLE( kFill, false );
+	const KeywordTable	kFogModeKeywords = KEYWORD_TABLE( kFogMode, false );
+	const KeywordTable	kInterpolationKeywords = KEYWORD_TABLE( kInterpolation, false );
+	const KeywordTable	kOrientationKeywords = KEYWORD_TABLE( kOrientation, false );
+	const KeywordTable	kPickPartsKeywords = KEYWORD_TABLE( kPickParts, true );
+	const KeywordTable	kSubdivisionKeywords = KEYWORD_TABLE( kSubdivision, false );
+	const KeywordTable	kAxisKeywords = KEYWORD_TABLE( kAxis, false );
+	const KeywordTable	kFalloffKeywords = KEYWORD_TABLE( kFalloff, false );
+	const KeywordTable	kCapsKeywords = KEYWORD_TABLE( kCaps, true );
+	const KeywordTable	kPolygonHintKeywords = KEYWORD_TABLE( kPolygonHint, false );
+	const KeywordTable	kPackingKeywords = KEYWORD_TABLE( kPacking, false );
+	const KeywordTable	kGroupStateKeywords = KEYWORD_TABLE( kGroupState, true );
+	const KeywordTable	kTriangleEdgesKeywords = KEYWORD_TABLE( kTriangleEdges, true );
+
+
+	// Attribute types that may appear in an AttributeArray
+	enum
+	{
+		kAttributeTypeSurfaceUV = 1,
+		kAttributeTypeShadingUV,
+		kAttributeTypeNormal,
+		kAttributeTypeAmbientCoefficient,
+		kAttributeTypeDiffuseColor,
+		kAttributeTypeSpecularColor,
+		kAttributeTypeSpecularControl,
+		kAttributeTypeTransparencyColor,
+		kAttributeTypeSurfaceTangent,
+		kAttributeTypeHighlightState,
+		kAttributeTypeSurfaceShader,
+		kAttributeTypeEmissiveColor
+	};
+}
+
+const KeywordTable	kByteOrderKeywords = KEYWORD_TABLE( kByteOrder, false );
+
+
+#pragma mark Helpers
+
+static void	CopyFloats( FieldReader& inReader, FieldWriter& inWriter,
+						uint64_t inCount, uint32_t inPerLine )
+{
+	float values[ kFloatChunk ];
+	const uint32_t kChunkLen = (inPerLine == 0)? kFloatChunk :
+		kFloatChunk - (kFloatChunk % inPerLine);
+
+	while (inCount > 0)
+	{
+		uint32_t chunk = (inCount < kChunkLen)? static_cast<uint32_t>( inCount ) : kChunkLen;
+		inReader.Float32Array( values, chunk );
+		inWriter.Float32Array( values, chunk, inPerLine );
+		inCount -= chunk;
+	}
+}
+
+// Geometries such as Box may omit their data to get the default shape.
+static void	CopyOptionalFloats( FieldReader& inReader, FieldWriter& inWriter,
+								uint32_t inCount, uint32_t inPerLine )
+{
+	for (uint32_t i = 0; (i < inCount) && ! inReader.AtEnd(); ++i)
+	{
+		if ( (i % inPerLine) == 0 )
+		{
+			inWriter.LineBreak();
+		}
+		inWriter.Float32( inReader.Float32() );
+	}
+}
+
+static void	CopyRaw( FieldReader& inReader, FieldWriter& inWriter, uint64_t inLength )
+{
+	if (inLength > 0xFFFFFFFFUL)
+	{
+		throw TranscodeException( "Image data too large", 0 );
+	}
+
+	uint8_t buffer[ kRawChunk ];
+	uint64_t remaining = inLength;
+
+	while (remaining > 0)
+	{
+		uint32_t chunk = (remaining < kRawChunk)? static_cast<uint32_t>( remaining ) : kRawChunk;
+		inReader.RawData( buffer, chunk );
+		inWriter.RawData( buffer, chunk );
+		remaining -= chunk;
+	}
+
+	inReader.RawPadding( static_cast<uint32_t>( inLength ) );
+	inWriter.RawPadding( static_cast<uint32_t>( inLength ) );
+}
+
+static uint32_t	CopyUns32( FieldReader& inReader, FieldWriter& inWriter )
+{
+	uint32_t value = inReader.Uns32();
+	inWriter.Uns32( value );
+	return value;
+}
+
+static int32_t	CopyInt32( FieldReader& inReader, FieldWriter& inWriter )
+{
+	int32_t value = inReader.Int32();
+	inWriter.Int32( value );
+	return value;
+}
+
+static uint32_t	CopyEnum( FieldReader& inReader, FieldWriter& inWriter,
+						const KeywordTable& inTable )
+{
+	uint32_t value = inReader.Enum( inTable );
+	inWriter.Enum( value, inTable );
+	return value;
+}
+
+static void	CopyIndex( FieldReader& inReader, FieldWriter& inWriter, uint32_t inBytes )
+{
+	inWriter.Index( inReader.Index( inBytes ), inBytes );
+}
+
+// The TriMesh index size rule of the binary format.
+static uint32_t	IndexBytes( uint32_t inNumItems )
+{
+	return (inNumItems <= 0xFF)? 1 : ( (inNumItems <= 0xFFFF)? 2 : 4 );
+}
+
+static void	CopyUns32Array( FieldReader& inReader, FieldWriter& inWriter,
+							uint64_t inCount, uint32_t inPerLine )
+{
+	for (uint64_t i = 0; i < inCount; ++i)
+	{
+		if ( (i % inPerLine) == 0 )
+		{
+			inWriter.LineBreak();
+		}
+		CopyUns32( inReader, inWriter );
+	}
+}
+
+#pragma mark Simple codecs
+
+static void	Codec_Empty( FieldReader&, FieldWriter&, CodecContext& )
+{
+}
+
+template <uint32_t N>
+static void	Codec_Floats( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyFloats( inReader, inWriter, N, (N > 4)? ((N % 3 == 0)? 3 : 4) : 0 );
+}
+
+template <uint32_t N>
+static void	Codec_OptionalFloats( FieldReader& inReader, FieldWriter& inWriter,
+								CodecContext& )
+{
+	CopyOptionalFloats( inReader, inWriter, N, 3 );
+}
+
+static void	Codec_Uns32( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyUns32( inReader, inWriter );
+}
+
+static void	Codec_Boolean( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kBooleanKeywords );
+}
+
+static void	Codec_String( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	inWriter.String( inReader.String() );
+}
+
+#pragma mark Styles
+
+static void	Codec_Antialias( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kSwitchKeywords );
+	CopyEnum( inReader, inWriter, kAntialiasModeKeywords );
+	inWriter.Float32( inReader.Float32() );
+}
+
+static void	Codec_Backfacing( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kBackfacingKeywords );
+}
+
+static void	Codec_Fill( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kFillKeywords );
+}
+
+static void	Codec_Fog( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kSwitchKeywords );
+	CopyEnum( inReader, inWriter, kFogModeKeywords );
+	inWriter.LineBreak();
+	CopyFloats( inReader, inWriter, 3, 0 );		// start, end, density
+	inWriter.LineBreak();
+	CopyFloats( inReader, inWriter, 4, 0 );		// ARGB color
+}
+
+static void	Codec_Interpolation( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kInterpolationKeywords );
+}
+
+static void	Codec_Orientation( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kOrientationKeywords );
+}
+
+static void	Codec_PickParts( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kPickPartsKeywords );
+}
+
+static void	Codec_Subdivision( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	if (CopyEnum( inReader, inWriter, kSubdivisionKeywords ) == 0)
+	{
+		CopyUns32( inReader, inWriter );
+		CopyUns32( inReader, inWriter );
+	}
+	else
+	{
+		inWriter.Float32( inReader.Float32() );
+	}
+}
+
+#pragma mark Transforms
+
+static void	Codec_Rotate( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kAxisKeywords );
+	inWriter.Float32( inReader.Float32() );
+}
+
+static void	Codec_RotateAboutPoint( FieldReader& inReader, FieldWriter& inWriter,
+									CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kAxisKeywords );
+	inWriter.Float32( inReader.Float32() );
+	CopyFloats( inReader, inWriter, 3, 0 );
+}
+
+#pragma mark Lights
+
+static void	Codec_DirectionalLight( FieldReader& inReader, FieldWriter& inWriter,
+									CodecContext& )
+{
+	CopyFloats( inReader, inWriter, 3, 0 );		// direction
+	CopyEnum( inReader, inWriter, kBooleanKeywords );
+}
+
+static void	Codec_LightData( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kBooleanKeywords );
+	inWriter.Float32( inReader.Float32() );		// intensity
+	CopyFloats( inReader, inWriter, 3, 0 );		// color
+}
+
+static void	Codec_PointLight( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyFloats( inReader, inWriter, 6, 3 );		// location, attenuation
+	inWriter.LineBreak();
+	CopyEnum( inReader, inWriter, kBooleanKeywords );
+}
+
+static void	Codec_SpotLight( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyFloats( inReader, inWriter, 6, 3 );		// location, orientation
+	inWriter.LineBreak();
+	CopyEnum( inReader, inWriter, kBooleanKeywords );
+	CopyFloats( inReader, inWriter, 3, 3 );		// attenuation
+	inWriter.LineBreak();
+	CopyFloats( inReader, inWriter, 2, 0 );		// hot angle, outer angle
+	CopyEnum( inReader, inWriter, kFalloffKeywords );
+}
+
+#pragma mark Shaders and groups
+
+static void	Codec_Shader( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kBoundaryKeywords );
+	CopyEnum( inReader, inWriter, kBoundaryKeywords );
+}
+
+static void	Codec_PixmapTexture( FieldReader& inReader, FieldWriter& inWriter,
+								CodecContext& )
+{
+	inWriter.LineBreak();
+	CopyUns32( inReader, inWriter );							// width
+	uint64_t height = CopyUns32( inReader, inWriter );
+	uint64_t rowBytes = CopyUns32( inReader, inWriter );
+	CopyUns32( inReader, inWriter );							// pixelSize
+	inWriter.LineBreak();
+	CopyEnum( inReader, inWriter, kPixelTypeKeywords );
+	CopyEnum( inReader, inWriter, kByteOrderKeywords );		// bit order
+	CopyEnum( inReader, inWriter, kByteOrderKeywords );		// byte order
+	CopyRaw( inReader, inWriter, rowBytes * height );
+}
+
+static void	Codec_DisplayGroupState( FieldReader& inReader, FieldWriter& inWriter,
+									CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kGroupStateKeywords );
+}
+
+static void	Codec_AttributeSetList( FieldReader& inReader, FieldWriter& inWriter,
+									CodecContext& )
+{
+	CopyUns32( inReader, inWriter );							// nObjects
+	CopyEnum( inReader, inWriter, kPackingKeywords );
+	uint32_t numIndices = CopyUns32( inReader, inWriter );
+	CopyUns32Array( inReader, inWriter, numIndices, 10 );
+}
+
+#pragma mark Geometries
+
+static void	Codec_Caps( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kCapsKeywords );
+}
+
+static void	Codec_GeneralPolygonHint( FieldReader& inReader, FieldWriter& inWriter,
+									CodecContext& )
+{
+	CopyEnum( inReader, inWriter, kPolygonHintKeywords );
+}
+
+static void	Codec_PointList( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	uint64_t numPoints = CopyUns32( inReader, inWriter );
+	CopyFloats( inReader, inWriter, 3 * numPoints, 3 );
+}
+
+static void	Codec_GeneralPolygon( FieldReader& inReader, FieldWriter& inWriter,
+								CodecContext& )
+{
+	uint32_t numContours = CopyUns32( inReader, inWriter );
+	for (uint32_t i = 0; i < numContours; ++i)
+	{
+		inWriter.LineBreak();
+		uint64_t numPoints = CopyUns32( inReader, inWriter );
+		CopyFloats( inReader, inWriter, 3 * numPoints, 3 );
+	}
+}
+
+static void	Codec_Mesh( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	uint64_t numVertices = CopyUns32( inReader, inWriter );
+	CopyFloats( inReader, inWriter, 3 * numVertices, 3 );
+
+	inWriter.LineBreak();
+	uint64_t numRecords = CopyUns32( inReader, inWriter );		// faces
+	numRecords += CopyUns32( inReader, inWriter );				// contours
+
+	// Each face or contour is a count, negative for a contour, then indices.
+	for (uint64_t i = 0; i < numRecords; ++i)
+	{
+		inWriter.LineBreak();
+		int32_t count = CopyInt32( inReader, inWriter );
+		uint32_t numIndices = (count < 0)? static_cast<uint32_t>( -(int64_t)count ) :
+			static_cast<uint32_t>( count );
+		for (uint32_t j = 0; j < numIndices; ++j)
+		{
+			CopyUns32( inReader, inWriter );
+		}
+	}
+}
+
+static void	Codec_NURBCurve( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	uint64_t order = CopyUns32( inReader, inWriter );
+	uint64_t numPoints = CopyUns32( inReader, inWriter );
+	CopyFloats( inReader, inWriter, 4 * numPoints, 4 );
+	inWriter.LineBreak();
+	CopyFloats( inReader, inWriter, numPoints + order, 0 );	// knots
+}
+
+static void	Codec_NURBPatch( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	uint64_t uOrder = CopyUns32( inReader, inWriter );
+	uint64_t vOrder = CopyUns32( inReader, inWriter );
+	uint64_t numRows = CopyUns32( inReader, inWriter );
+	uint64_t numColumns = CopyUns32( inReader, inWriter );
+	CopyFloats( inReader, inWriter, 4 * numRows * numColumns, 4 );
+	inWriter.LineBreak();
+	CopyFloats( inReader, inWriter, uOrder + numColumns, 0 );	// u knots
+	inWriter.LineBreak();
+	CopyFloats( inReader, inWriter, vOrder + numRows, 0 );		// v knots
+}
+
+static void	Codec_Marker( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	CopyFloats( inReader, inWriter, 3, 0 );		// location
+	inWriter.LineBreak();
+	CopyInt32( inReader, inWriter );			// xOffset
+	CopyInt32( inReader, inWriter );			// yOffset
+	CopyUns32( inReader, inWriter );			// width
+	uint64_t height = CopyUns32( inReader, inWriter );
+	uint64_t rowBytes = CopyUns32( inReader, inWriter );
+	CopyEnum( inReader, inWriter, kByteOrderKeywords );		// bit order
+	CopyRaw( inReader, inWriter, rowBytes * height );
+}
+
+static void	Codec_PixmapMarker( FieldReader& inReader, FieldWriter& inWriter,
+								CodecContext& )
+{
+	CopyFloats( inReader, inWriter, 3, 0 );		// location
+	inWriter.LineBreak();
+	CopyInt32( inReader, inWriter );			// xOffset
+	CopyInt32( inReader, inWriter );			// yOffset
+	CopyUns32( inReader, inWriter );			// width
+	uint64_t height = CopyUns32( inReader, inWriter );
+	uint64_t rowBytes = CopyUns32( inReader, inWriter );
+	CopyUns32( inReader, inWriter );			// pixelSize
+	inWriter.LineBreak();
+	CopyEnum( inReader, inWriter, kPixelTypeKeywords );
+	CopyEnum( inReader, inWriter, kByteOrderKeywords );		// bit order
+	CopyEnum( inReader, inWriter, kByteOrderKeywords );		// byte order
+	CopyRaw( inReader, inWriter, rowBytes * height );
+}
+
+static void	Codec_Polyhedron( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	uint64_t numVertices = CopyUns32( inReader, inWriter );
+	uint64_t numEdges = CopyUns32( inReader, inWriter );
+	uint32_t numTriangles = CopyUns32( inReader, inWriter );
+
+	CopyFloats( inReader, inWriter, 3 * numVertices, 3 );
+	CopyUns32Array( inReader, inWriter, 4 * numEdges, 4 );
+
+	for (uint32_t i = 0; i < numTriangles; ++i)
+	{
+		CopyUns32Array( inReader, inWriter, 3, 3 );
+		CopyEnum( inReader, inWriter, kTriangleEdgesKeywords );
+	}
+}
+
+static void	Codec_TriGrid( FieldReader& inReader, FieldWriter& inWriter, CodecContext& )
+{
+	uint64_t numRows = CopyUns32( inReader, inWriter );
+	uint64_t numColumns = CopyUns32( inReader, inWriter );
+	CopyFloats( inReader, inWriter, 3 * numRows * numColumns, 3 );
+}
+
+static void	Codec_TriMesh( FieldReader& inReader, FieldWriter& inWriter,
+							CodecContext& ioContext )
+{
+	inWriter.LineBreak();
+	ioContext.triMeshFaces = CopyUns32( inReader, inWriter );
+	CopyUns32( inReader, inWriter );		// face attribute count
+	ioContext.triMeshEdges = CopyUns32( inReader, inWriter );
+	CopyUns32( inReader, inWriter );		// edge attribute count
+	ioContext.triMeshPoints = CopyUns32( inReader, inWriter );
+	CopyUns32( inReader, inWriter );		// point attribute count
+
+	const uint32_t kPointIndexBytes = IndexBytes( ioContext.triMeshPoints );
+	const uint32_t kFaceIndexBytes = IndexBytes( ioContext.triMeshFaces );
+
+	for (uint32_t i = 0; i < ioContext.triMeshFaces; ++i)
+	{
+		inWriter.LineBreak();
+		CopyIndex( inReader, inWriter, kPointIndexBytes );
+		CopyIndex( inReader, inWriter, kPointIndexBytes );
+		CopyIndex( inReader, inWriter, kPointIndexBytes );
+	}
+
+	for (uint32_t i = 0; i < ioContext.triMeshEdges; ++i)
+	{
+		inWriter.LineBreak();
+		CopyIndex( inReader, inWriter, kPointIndexBytes );
+		CopyIndex( inReader, inWriter, kPointIndexBytes );
+		CopyIndex( inReader, inWriter, kFaceIndexBytes );
+		CopyIndex( inReader, inWriter, kFaceIndexBytes );
+	}
+
+	CopyFloats( inReader, inWriter, 3 * (uint64_t)ioContext.triMeshPoints, 3 );
+
+	inWriter.LineBreak();
+	CopyFloats( inReader, inWriter, 6, 0 );		// bounding box
+	CopyEnum( inReader, inWriter, kBooleanKeywords );
+}
+
+static void	Codec_AttributeArray( FieldReader& inReader, FieldWriter& inWriter,
+								CodecContext& ioContext )
+{
+	int32_t attType = CopyInt32( inReader, inWriter );
+	CopyUns32( inReader, inWriter );		// reserved
+	uint32_t positionOfArray = CopyUns32( inReader, inWriter );
+	CopyUns32( inReader, inWriter );		// position in array
+	uint32_t useFlag = CopyUns32( inReader, inWriter );
+
+	uint32_t elementCount;
+	switch (positionOfArray)
+	{
+		case 0:		elementCount = ioContext.triMeshFaces;	break;
+		case 1:		elementCount = ioContext.triMeshEdges;	break;
+		case 2:		elementCount = ioContext.triMeshPoints;	break;
+		default:
+			throw TranscodeException( "Bad AttributeArray position", 0 );
+	}
+
+	switch (attType)
+	{
+		case kAttributeTypeAmbientCoefficient:
+		case kAttributeTypeSpecularControl:
+			CopyFloats( inReader, inWriter, elementCount, 1 );
+			break;
+
+		case kAttributeTypeSurfaceUV:
+		case kAttributeTypeShadingUV:
+			CopyFloats( inReader, inWriter, 2 * (uint64_t)elementCount, 2 );
+			break;
+
+		case kAttributeTypeNormal:
+		case kAttributeTypeDiffuseColor:
+		case kAttributeTypeSpecularColor:
+		case kAttributeTypeTransparencyColor:
+		case kAttributeTypeEmissiveColor:
+			CopyFloats( inReader, inWriter, 3 * (uint64_t)elementCount, 3 );
+			break;
+
+		case kAttributeTypeSurfaceTangent:
+			CopyFloats( inReader, inWriter, 6 * (uint64_t)elementCount, 6 );
+			break;
+
+		case kAttributeTypeHighlightState:
+			for (uint32_t i = 0; i < elementCount; ++i)
+			{
+				inWriter.LineBreak();
+				CopyEnum( inReader, inWriter, kSwitchKeywords );
+			}
+			break;
+
+		default:
+			// Surface shaders and custom attributes follow as separate objects.
+			break;
+	}
+
+	if (useFlag != 0)
+	{
+		for (uint32_t i = 0; i < elementCount; ++i)
+		{
+			if ( (i % 16) == 0 )
+			{
+				inWriter.LineBreak();
+			}
+			inWriter.Uns8( inReader.Uns8() );
+		}
+	}
+}
+
+#pragma mark Miscellaneous
+
+static void	Codec_TableOfContents( FieldReader& inReader, FieldWriter& inWriter,
+									CodecContext& )
+{
+	inWriter.LineBreak();
+	inWriter.Location( inReader.Location() );		// next TOC
+	CopyUns32( inReader, inWriter );				// reference seed
+	CopyInt32( inReader, inWriter );				// type seed
+	uint32_t entryType = CopyUns32( inReader, inWriter );
+	CopyUns32( inReader, inWriter );				// entry size
+	uint32_t numEntries = CopyUns32( inReader, inWriter );
+
+	for (uint32_t i = 0; i < numEntries; ++i)
+	{
+		inWriter.LineBreak();
+		CopyUns32( inReader, inWriter );			// reference ID
+		inWriter.Location( inReader.Location() );
+		if (entryType == 1)
+		{
+			inWriter.ObjectType( inReader.ObjectType() );
+		}
+	}
+}
+
+
+namespace
+{
+	const TypeCodecInfo	kCodecs[] =
+	{
+		// Attributes
+		{ 'camb', "AmbientCoefficient", Codec_Floats<1> },
+		{ 'kdif', "DiffuseColor", Codec_Floats<3> },
+		{ 'kemi', "Quesa:EmissiveColor", Codec_Floats<3> },
+		{ 'hlst', "HighlightState", Codec_Boolean },
+		{ 'nrml', "Normal", Codec_Floats<3> },
+		{ 'shuv', "ShadingUV", Codec_Floats<2> },
+		{ 'kspc', "SpecularColor", Codec_Floats<3> },
+		{ 'cspc', "SpecularControl", Codec_Floats<1> },
+		{ 'srtn', "SurfaceTangent", Codec_Floats<6> },
+		{ 'sruv', "SurfaceUV", Codec_Floats<2> },
+		{ 'kxpr', "TransparencyColor", Codec_Floats<3> },
+
+		// Attribute sets and lists
+		{ 'attr', "AttributeSet", Codec_Empty },
+		{ 'bcas', "BottomCapAttributeSet", Codec_Empty },
+		{ 'fcas', "FaceCapAttributeSet", Codec_Empty },
+		{ 'icas', "InteriorCapAttributeSet", Codec_Empty },
+		{ 'tcas', "TopCapAttributeSet", Codec_Empty },
+		{ 'fasl', "FaceAttributeSetList", Codec_AttributeSetList },
+		{ 'gasl', "GeometryAttributeSetList", Codec_AttributeSetList },
+		{ 'vasl', "VertexAttributeSetList", Codec_AttributeSetList },
+
+		// Cameras
+		{ 'cmpl', "CameraPlacement", Codec_Floats<9> },
+		{ 'cmrg', "CameraRange", Codec_Floats<2> },
+		{ 'cmvp', "CameraViewPort", Codec_Floats<4> },
+		{ 'orth', "OrthographicCamera", Codec_Floats<4> },
+		{ 'vana', "ViewAngleAspectCamera", Codec_Floats<2> },
+		{ 'vwpl', "ViewPlaneCamera", Codec_Floats<5> },
+
+		// Geometries
+		{ 'atar', "AttributeArray", Codec_AttributeArray },
+		{ 'box ', "Box", Codec_OptionalFloats<12> },
+		{ 'caps', "Caps", Codec_Caps },
+		{ 'cone', "Cone", Codec_OptionalFloats<16> },
+		{ 'cyln', "Cylinder", Codec_OptionalFloats<16> },
+		{ 'disk', "Disk", Codec_OptionalFloats<13> },
+		{ 'elps', "Ellipse", Codec_OptionalFloats<11> },
+		{ 'elpd', "Ellipsoid", Codec_OptionalFloats<16> },
+		{ 'gpgn', "GeneralPolygon", Codec_GeneralPolygon },
+		{ 'gplh', "GeneralPolygonHint", Codec_GeneralPolygonHint },
+		{ 'line', "Line", Codec_Floats<6> },
+		{ 'mrkr', "Marker", Codec_Marker },
+		{ 'mesh', "Mesh", Codec_Mesh },
+		{ 'nrbc', "NURBCurve", Codec_NURBCurve },
+		{ 'nrbp', "NURBPatch", Codec_NURBPatch },
+		{ 'mrkp', "PixmapMarker", Codec_PixmapMarker },
+		{ 'pnt ', "Point", Codec_Floats<3> },
+		{ 'plyg', "Polygon", Codec_PointList },
+		{ 'plhd', "Polyhedron", Codec_Polyhedron },
+		{ 'plyl', "PolyLine", Codec_PointList },
+		{ 'tors', "Torus", Codec_OptionalFloats<17> },
+		{ 'trng', "Triangle", Codec_Floats<9> },
+		{ 'trig', "TriGrid", Codec_TriGrid },
+		{ 'tmsh', "TriMesh", Codec_TriMesh },
+
+		// Groups
+		{ 'dspg', "DisplayGroup", Codec_Empty },
+		{ 'dgbb', "DisplayGroupBBox", Codec_Floats<6> },
+		{ 'dgst', "DisplayGroupState", Codec_DisplayGroupState },
+		{ 'endg', "EndGroup", Codec_Empty },
+		{ 'grup', "Group", Codec_Empty },
+		{ 'info', "InfoGroup", Codec_Empty },
+		{ 'iopx', "IOProxyDisplayGroup", Codec_Empty },
+		{ 'lghg', "LightGroup", Codec_Empty },
+		{ 'ordg', "OrderedDisplayGroup", Codec_Empty },
+
+		// Lights
+		{ 'ambn', "AmbientLight", Codec_Empty },
+		{ 'drct', "DirectionalLight", Codec_DirectionalLight },
+		{ 'lida', "LightData", Codec_LightData },
+		{ 'pntl', "PointLight", Codec_PointLight },
+		{ 'spot', "SpotLight", Codec_SpotLight },
+
+		// Miscellaneous
+		{ 'strc', "CString", Codec_String },
+		{ static_cast<uint32_t>( '\360ena' ), "Apple Computer, Inc.:NameElement", Codec_Empty },
+		{ 'rfrn', "Reference", Codec_Uns32 },
+		{ static_cast<uint32_t>( '\360esm' ), "Quesa:ShininessElement", Codec_Empty },
+		{ 'toc ', "TableOfContents", Codec_TableOfContents },
+
+		// Renderers and view objects
+		{ 'gnrr', "GenericRenderer", Codec_Empty },
+		{ 'imcc', "ImageClearColor", Codec_Floats<4> },
+		{ 'vwhn', "ViewHints", Codec_Empty },
+
+		// Shaders
+		{ 'lmil', "LambertIllumination", Codec_Empty },
+		{ 'nuil', "NULLIllumination", Codec_Empty },
+		{ 'phil', "PhongIllumination", Codec_Empty },
+		{ 'txpm', "PixmapTexture", Codec_PixmapTexture },
+		{ 'txsu', "TextureShader", Codec_Empty },
+		{ 'shdr', "Shader", Codec_Shader },
+
+		// Styles
+		{ 'anti', "AntialiasStyle", Codec_Antialias },
+		{ 'bckf', "BackfacingStyle", Codec_Backfacing },
+		{ 'cash', "CastShadowsStyle", Codec_Boolean },
+		{ 'dpra', "DepthRangeStyle", Codec_Floats<2> },
+		{ 'fist', "FillStyle", Codec_Fill },
+		{ 'fogg', "FogStyle", Codec_Fog },
+		{ 'high', "HighlightStyle", Codec_Empty },
+		{ 'intp', "InterpolationStyle", Codec_Interpolation },
+		{ 'lnwd', "LineWidthStyle", Codec_Floats<1> },
+		{ 'ofdr', "OrientationStyle", Codec_Orientation },
+		{ 'pkid', "PickIDStyle", Codec_Uns32 },
+		{ 'pkpt', "PickPartsStyle", Codec_PickParts },
+		{ 'rcsh', "ReceiveShadowsStyle", Codec_Boolean },
+		{ 'sbdv', "SubdivisionStyle", Codec_Subdivision },
+		{ 'wrsw', "WriteSwitchStyle", Codec_Uns32 },
+
+		// Transforms
+		{ 'mtrx', "Matrix", Codec_Floats<16> },
+		{ 'qtrn', "Quaternion", Codec_Floats<4> },
+		{ 'rast', "Quesa:Transform:Camera:Rasterize", Codec_Empty },
+		{ 'rset', "Reset", Codec_Empty },
+		{ 'rott', "Rotate", Codec_Rotate },
+		{ 'rtaa', "RotateAboutAxis", Codec_Floats<7> },
+		{ 'rtap', "RotateAboutPoint", Codec_RotateAboutPoint },
+		{ 'scal', "Scale", Codec_Floats<3> },
+		{ 'sduv', "ShaderUVTransform", Codec_Floats<9> },
+		{ 'trns', "Translate", Codec_Floats<3> }
+	};
+
+	const size_t	kNumCodecs = sizeof(kCodecs) / sizeof(kCodecs[0]);
+
+	typedef std::map< uint32_t, const TypeCodecInfo* >		TypeToCodecMap;
+	typedef std::map< std::string, const TypeCodecInfo* >	NameToCodecMap;
+
+	const TypeToCodecMap&	TypeMap()
+	{
+		static TypeToCodecMap	sMap;
+		if (sMap.empty())
+		{
+			for (size_t i = 0; i < kNumCodecs; ++i)
+			{
+				sMap[ kCodecs[i].typeCode ] = &kCodecs[i];
+			}
+		}
+		return sMap;
+	}
+
+	const NameToCodecMap&	NameMap()
+	{
+		static NameToCodecMap	sMap;
+		if (sMap.empty())
+		{
+			for (size_t i = 0; i < kNumCodecs; ++i)
+			{
+				sMap[ kCodecs[i].className ] = &kCodecs[i];
+			}
+		}
+		return sMap;
+	}
+}
+
+const TypeCodecInfo*	FindCodecByType( uint32_t inType )
+{
+	TypeToCodecMap::const_iterator found = TypeMap().find( inType );
+	return (found == TypeMap().end())? NULL : found->second;
+}
+
+const TypeCodecInfo*	FindCodecByName( const std::string& inClassName )
+{
+	NameToCodecMap::const_iterator found = NameMap().find( inClassName );
+	return (found == NameMap().end())? NULL : found->second;
+}
+
+/*!
+	@function	TranscodeHeader
+
+	@abstract	Copy the fields of the 3DMF header: version, file mode and
+				the location of the first table of contents.
+*/
+void	TranscodeHeader( FieldReader& inReader, FieldWriter& inWriter )
+{
+	inWriter.Uns16( inReader.Uns16() );		// major version
+	inWriter.Uns16( inReader.Uns16() );		// minor version
+	CopyEnum( inReader, inWriter, kFileModeKeywords );
+	inWriter.Location( inReader.Location() );
+}
@@ -0,0 +1,73 @@
+/*
+ *  TypeCodecs.h
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#pragma once
+
+#include "ObjectIO.h"
+
+/*!
+	@struct		CodecContext
+
+	@abstract	State that one object's codec leaves for a later one.  An
+				AttributeArray needs the counts of the preceding TriMesh to
+				know how many elements it holds.
+*/
+struct CodecContext
+{
+					CodecContext()
+						: triMeshFaces( 0 )
+						, triMeshEdges( 0 )
+						, triMeshPoints( 0 ) {}
+
+	uint32_t		triMeshFaces;
+	uint32_t		triMeshEdges;
+	uint32_t		triMeshPoints;
+};
+
+
+/*!
+	@typedef	TypeCodec
+
+	@abstract	Copies the data of one object, field by field, from a reader
+				to a writer.  The reader and writer may use different forms,
+				so a codec never looks at bytes or tokens directly.
+*/
+typedef void (*TypeCodec)( FieldReader& inReader, FieldWriter& inWriter,
+							CodecContext& ioContext );
+
+struct TypeCodecInfo
+{
+	uint32_t		typeCode;
+	const char*		className;
+	TypeCodec		codec;
+};
+
+
+const TypeCodecInfo*	FindCodecByType( uint32_t inType );
+const TypeCodecInfo*	FindCodecByName( const std::string& inClassName );
+
+void					TranscodeHeader( FieldReader& inReader, FieldWriter& inWriter );
+
+extern const KeywordTable	kByteOrderKeywords;
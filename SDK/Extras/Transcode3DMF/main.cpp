@@ -0,0 +1,104 @@
+/*
+ *  main.cpp
+ *  Transcode3DMF
+ *
+ *  Copyright (c) 2026 Quesa Developers.
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from the
+ *  use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it
+ *  freely, subject to the following restrictions:
+ *
+ *    1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in a
+ *    product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ *    2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ *    3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include "Transcode3DMF.h"
+
+#include <iostream>
+#include <cstdio>
+#include <string>
+
+using namespace std;
+
+static int Usage()
+{
+	cerr << "Usage: Transcode3DMF [--text | --big | --little] in.3dmf out.3dmf\n" <<
+			"Without an option, binary input becomes text and text input becomes\n" <<
+			"big-endian binary.  A path of - means standard input or output,\n" <<
+			"which is only possible for text.\n";
+	return 1;
+}
+
+int main (int argc, char * const argv[])
+{
+	ETranscodeForm form = kTranscodeToOtherForm;
+	int argIndex = 1;
+
+	if ( (argc == 4) && (argv[1][0] == '-') && (argv[1][1] == '-') )
+	{
+		string option( argv[1] );
+		if (option == "--text")
+		{
+			form = kTranscodeToText;
+		}
+		else if (option == "--big")
+		{
+			form = kTranscodeToBigEndian;
+		}
+		else if (option == "--little")
+		{
+			form = kTranscodeToLittleEndian;
+		}
+		else
+		{
+			return Usage();
+		}
+		argIndex = 2;
+	}
+	else if (argc != 3)
+	{
+		return Usage();
+	}
+
+	string inPath( argv[ argIndex ] );
+	string outPath( argv[ argIndex + 1 ] );
+
+	FILE* inFile = (inPath == "-")? stdin : fopen( inPath.c_str(), "rb" );
+	if (inFile == NULL)
+	{
+		cerr << "Cannot open input file '" << inPath << "'\n";
+		return 2;
+	}
+
+	FILE* outFile = (outPath == "-")? stdout : fopen( outPath.c_str(), "w+b" );
+	if (outFile == NULL)
+	{
+		cerr << "Cannot open output file '" << outPath << "'\n";
+		return 2;
+	}
+
+	bool success = Transcode3DMF( inFile, outFile, form, cerr );
+
+	if (inFile != stdin)
+	{
+		fclose( inFile );
+	}
+	if ( (outFile != stdout) && (fclose( outFile ) != 0) )
+	{
+		cerr << "Error writing output file '" << outPath << "'\n";
+		success = false;
+	}
+
+	return success? 0 : 3;
+}
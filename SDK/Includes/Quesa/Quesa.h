@@ -641,6 +641,7 @@ enum QUESA_ENUM_BASE(TQ3Int32) {
         kQ3PickTypeWindowPoint                  = Q3_OBJECT_TYPE('p', 'k', 'w', 'p'),
         kQ3PickTypeWindowRect                   = Q3_OBJECT_TYPE('p', 'k', 'w', 'r'),
         kQ3PickTypeWorldRay                     = Q3_OBJECT_TYPE('p', 'k', 'r', 'y'),
+        kQ3PickTypeWorldRayBatch                = Q3_OBJECT_TYPE('p', 'k', 'r', 'b'),
     kQ3ObjectTypeShared                         = Q3_OBJECT_TYPE('s', 'h', 'r', 'd'),
         kQ3SharedTypeRenderer                   = Q3_OBJECT_TYPE('r', 'd', 'd', 'r'),
             kQ3RendererTypeWireFrame            = Q3_OBJECT_TYPE('w', 'r', 'f', 'r'),
@@ -759,6 +760,8 @@ enum QUESA_ENUM_BASE(TQ3Int32) {
                 kQ3MemoryStorageTypeHandle      = Q3_OBJECT_TYPE('h', 'n', 'd', 'l'),
             kQ3StorageTypePath                  = Q3_OBJECT_TYPE('Q', 's', 't', 'p'),
             kQ3StorageTypeFileStream            = Q3_OBJECT_TYPE('Q', 's', 'f', 's'),
+            kQ3StorageTypeReadAhead             = Q3_OBJECT_TYPE('Q', 's', 'r', 'a'),
+            kQ3StorageTypeCompressed            = Q3_OBJECT_TYPE('Q', 's', 'c', 'b'),
             kQ3StorageTypeUnix                  = Q3_OBJECT_TYPE('u', 'x', 's', 't'),
                 kQ3UnixStorageTypePath          = Q3_OBJECT_TYPE('u', 'n', 'i', 'x'),
             kQ3StorageTypeMacintosh             = Q3_OBJECT_TYPE('m', 'a', 'c', 'n'),
@@ -2930,6 +2933,113 @@ Q3Bitmap_SetBit (
 #endif // QUESA_ALLOW_QD3D_EXTENSIONS
 
 
+
+/*!
+ *  @function
+ *      Q3Trace_SetState
+ *  @discussion
+ *      Turn the recording of trace events on or off.
+ *
+ *      While recording, Quesa times its major phases (rendering frames and
+ *      passes, geometry cache rebuilds, transparency sorting, texture
+ *      uploads, and reading or writing each object) into a fixed-size
+ *      buffer. Once the buffer is full the oldest events are discarded.
+ *
+ *      Recording is off by default, in which case each traced phase costs
+ *      a single test. Event times are measured from when recording was
+ *      turned on with no events recorded, i.e., the first time or after
+ *      Q3Trace_Clear.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param isEnabled        Whether trace events should be recorded.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Trace_SetState (
+    TQ3Boolean                    isEnabled
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Trace_GetState
+ *  @discussion
+ *      Test whether trace events are being recorded.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @result                 True if trace events are being recorded.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Boolean  )
+Q3Trace_GetState (
+    void
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Trace_Clear
+ *  @discussion
+ *      Discard any recorded trace events.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Trace_Clear (
+    void
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Trace_Write
+ *  @discussion
+ *      Write the recorded trace events to a storage object.
+ *
+ *      The events are written as Chrome trace event JSON, which can be
+ *      viewed with chrome://tracing or the Perfetto UI. Events for an
+ *      object are named after its class, e.g., "FileRead: TriMesh".
+ *
+ *      Recording should be turned off before writing, since events which
+ *      other threads are still recording when the trace is written are
+ *      left out.
+ *      A path storage must be opened with Q3Storage_Open first.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param storage          The storage to write to, starting at offset 0.
+ *  @param bytesWritten     Receives the number of bytes written.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Trace_Write (
+    TQ3StorageObject _Nonnull             storage,
+    TQ3Uns32                      * _Nonnull bytesWritten
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
 // Work around a HeaderDoc bug
 /*!
 	@functiongroup
@@ -492,6 +492,42 @@ Q3XObject_GetClass (
 
 
 
+/*!
+ *  @function
+ *      Q3XView_SubmitImmediateClass
+ *  @discussion
+ *      Submit immediate mode data of a known class to a view.
+ *
+ *      Equivalent to the Q3xxx_Submit function for the class, but takes a
+ *      class previously obtained from Q3XObjectHierarchy_FindClassByType
+ *      rather than a type. When drawing, the class's render method is
+ *      invoked directly without looking the class up in the class tree.
+ *
+ *      Intended for trusted callers which submit many objects per frame.
+ *      The view and class are only validated in debug builds, and the error
+ *      manager is not reset between calls: use Q3Error_Get after a batch of
+ *      submits to check for errors.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param view             The view to submit to.
+ *  @param objectClass      The class of the data.
+ *  @param objectData       The data for the class, e.g., a TQ3TriMeshData.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3XView_SubmitImmediateClass (
+    TQ3ViewObject _Nonnull                 view,
+    TQ3XObjectClass _Nonnull               objectClass,
+    const void * _Nullable                 objectData
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
  *  @function
  *      Q3XSharedLibrary_Register
@@ -229,10 +229,14 @@ enum QUESA_ENUM_BASE(TQ3Int32) {
 
     // Used for Q3XXX_WriteMethods, no strict need to override to implement a new format
     kQ3XMethodTypeFFormatFloat32Write           = Q3_METHOD_TYPE('F', 'f', '3', 'w'),
+    kQ3XMethodTypeFFormatFloat32WriteArray      = Q3_METHOD_TYPE('F', 'f', '3', 'W'),
     kQ3XMethodTypeFFormatFloat64Write           = Q3_METHOD_TYPE('F', 'f', '6', 'w'),
     kQ3XMethodTypeFFormatInt8Write              = Q3_METHOD_TYPE('F', 'i', '8', 'w'),
+    kQ3XMethodTypeFFormatInt8WriteArray         = Q3_METHOD_TYPE('F', 'i', '8', 'W'),
     kQ3XMethodTypeFFormatInt16Write             = Q3_METHOD_TYPE('F', 'i', '1', 'w'),
+    kQ3XMethodTypeFFormatInt16WriteArray        = Q3_METHOD_TYPE('F', 'i', '1', 'W'),
     kQ3XMethodTypeFFormatInt32Write             = Q3_METHOD_TYPE('F', 'i', '3', 'w'),
+    kQ3XMethodTypeFFormatInt32WriteArray        = Q3_METHOD_TYPE('F', 'i', '3', 'W'),
     kQ3XMethodTypeFFormatInt64Write             = Q3_METHOD_TYPE('F', 'i', '6', 'w'),
     kQ3XMethodTypeFFormatStringWrite            = Q3_METHOD_TYPE('F', 's', 't', 'w'),
     kQ3XMethodTypeFFormatRawWrite               = Q3_METHOD_TYPE('F', 'r', 'w', 'w')
@@ -259,6 +263,81 @@ enum QUESA_ENUM_BASE(TQ3Int32) {
 };
 
 
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+/*!
+	@enum	File&nbsp;Property&nbsp;Types
+
+	@abstract	Object properties that may be set on file objects.
+
+	@constant	kQ3FilePropertyPackGeometry
+						When this property is set to kQ3True on a file before
+						writing, the binary 3DMF writer stores TriMeshes in a
+						compact Quesa-specific form: points are quantised to 16
+						bits relative to their bounding box, triangle and edge
+						indices are delta and variable length coded, and vertex
+						normals and UVs are quantised (normals by octahedral
+						mapping).  The encoding is lossy, and files that use it
+						can only be read by Quesa.  Quesa reads such files back
+						as ordinary TriMeshes whether or not the property is set.
+
+						<em>This property is not available in QD3D.</em>
+
+						Data type: TQ3Boolean.  Default value: kQ3False.
+
+	@constant	kQ3FilePropertyShareEqualObjects
+						Normally the binary 3DMF writer only writes a shared
+						object once if the very same object is submitted more
+						than once.  When this property is set to kQ3True on a
+						file before writing, shared objects (other than groups)
+						whose 3DMF data is identical to one already written are
+						also replaced by references to it when the reference is
+						smaller than the object, which can make files built by
+						importers much smaller.  This has no effect in stream
+						modes, which cannot contain references, and it makes
+						writing slower and uses more memory, since each shared
+						object is serialised an extra time and its data kept
+						for comparison until the file is closed.
+
+						<em>This property is not available in QD3D.</em>
+
+						Data type: TQ3Boolean.  Default value: kQ3False.
+
+	@constant	kQ3FilePropertyLazyLoadBudget
+						When this property is set to a non-zero value on a file
+						before it is opened for reading, the binary 3DMF reader
+						returns large geometries as lightweight proxies which
+						only record where the geometry lives in the storage and
+						its bounding box.  A proxy reads its geometry back from
+						the storage the first time it is rendered, picked, or
+						written, and the value of the property is the number
+						of bytes of stored geometry data that the proxies read
+						from one file may keep loaded at once.  When the budget
+						is exceeded, the least recently used geometries are
+						released, and will be read again when next needed.
+
+						The proxies keep the storage, and open it through a
+						file object of their own when they first need to read
+						from it.  Storage which can only be opened once, such
+						as path storage, must therefore be closed by the file
+						that was read before the proxies are submitted, and
+						will remain open until the last proxy is disposed.
+						Text 3DMF files are always read in full.
+
+						<em>This property is not available in QD3D.</em>
+
+						Data type: uint64_t.  Default value: 0.
+*/
+enum QUESA_ENUM_BASE(TQ3Int32)
+{
+	kQ3FilePropertyPackGeometry                     = Q3_OBJECT_TYPE('p', 'k', 'g', 'm'),
+	kQ3FilePropertyShareEqualObjects                = Q3_OBJECT_TYPE('s', 'h', 'e', 'q'),
+	kQ3FilePropertyLazyLoadBudget                   = Q3_OBJECT_TYPE('l', 'z', 'l', 'd')
+};
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
 
 
 
@@ -719,6 +798,21 @@ typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XFFormatFloat32WriteMethod)(
 	TQ3FileFormatObject _Nonnull format, const TQ3Float32 * _Nonnull data);
 
 
+/*!
+ *  @typedef
+ *      TQ3XFFormatFloat32WriteArrayMethod
+ *  @discussion
+ *      Write an array of 32-bit floats to a file.
+ *
+ *  @param format           The file format.
+ *  @param numFloats        The number of floats to write.
+ *  @param data             The data to write.
+ *  @result                 Success or failure of the operation.
+ */
+typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XFFormatFloat32WriteArrayMethod)(
+	TQ3FileFormatObject _Nonnull format, TQ3Uns32 numFloats, const TQ3Float32 * _Nonnull data);
+
+
 /*!
  *  @typedef
  *      TQ3XFFormatFloat64WriteMethod
@@ -747,6 +841,21 @@ typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XFFormatInt8WriteMethod)(
 	TQ3FileFormatObject _Nonnull format, const TQ3Int8 * _Nonnull data);
 
 
+/*!
+ *  @typedef
+ *      TQ3XFFormatInt8WriteArrayMethod
+ *  @discussion
+ *      Write an array of 8-bit integers to a file.
+ *
+ *  @param format           The file format.
+ *  @param numNums          The number of numbers to write.
+ *  @param data             The data to write.
+ *  @result                 Success or failure of the operation.
+ */
+typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XFFormatInt8WriteArrayMethod)(
+	TQ3FileFormatObject _Nonnull format, TQ3Uns32 numNums, const TQ3Int8 * _Nonnull data);
+
+
 /*!
  *  @typedef
  *      TQ3XFFormatInt16WriteMethod
@@ -761,6 +870,21 @@ typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XFFormatInt16WriteMethod)(
 	TQ3FileFormatObject _Nonnull format, const TQ3Int16 * _Nonnull data);
 
 
+/*!
+ *  @typedef
+ *      TQ3XFFormatInt16WriteArrayMethod
+ *  @discussion
+ *      Write an array of 16-bit integers to a file.
+ *
+ *  @param format           The file format.
+ *  @param numNums          The number of numbers to write.
+ *  @param data             The data to write.
+ *  @result                 Success or failure of the operation.
+ */
+typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XFFormatInt16WriteArrayMethod)(
+	TQ3FileFormatObject _Nonnull format, TQ3Uns32 numNums, const TQ3Int16 * _Nonnull data);
+
+
 /*!
  *  @typedef
  *      TQ3XFFormatInt32WriteMethod
@@ -775,6 +899,21 @@ typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XFFormatInt32WriteMethod)(
 	TQ3FileFormatObject _Nonnull format, const TQ3Int32 * _Nonnull data);
 
 
+/*!
+ *  @typedef
+ *      TQ3XFFormatInt32WriteArrayMethod
+ *  @discussion
+ *      Write an array of 32-bit integers to a file.
+ *
+ *  @param format           The file format.
+ *  @param numNums          The number of numbers to write.
+ *  @param data             The data to write.
+ *  @result                 Success or failure of the operation.
+ */
+typedef Q3_CALLBACK_API_C(TQ3Status, TQ3XFFormatInt32WriteArrayMethod)(
+	TQ3FileFormatObject _Nonnull format, TQ3Uns32 numNums, const TQ3Int32 * _Nonnull data);
+
+
 /*!
  *  @typedef
  *      TQ3XFFormatInt64WriteMethod
@@ -832,6 +971,19 @@ typedef Q3_CALLBACK_API_C(TQ3Status, TQ3FileIdleMethod) (
 	TQ3FileObject _Nonnull theFile, const void * _Nonnull idlerData);
 
 
+/*!
+ *  @enum
+ *      TQ3FFormatBaseDataVersion
+ *  @discussion
+ *      The layout version of TQ3FFormatBaseData.
+ *
+ *  @constant kQ3FFormatBaseDataVersion    The current layout version.
+ */
+enum QUESA_ENUM_BASE(TQ3Uns32) {
+    kQ3FFormatBaseDataVersion                   = 2
+};
+
+
 /*!
  *  @struct
  *      TQ3FFormatBaseData
@@ -844,17 +996,25 @@ typedef Q3_CALLBACK_API_C(TQ3Status, TQ3FileIdleMethod) (
  *      are initialised automatically by Quesa. Remaining fields must be initialised
  *      by the importer.
  *
- *  @field baseDataVersion           The base data version.
+ *      Version 2 of this structure widened currentStoragePosition and logicalEOF
+ *      to 64 bits, which moved every field after them. A plug-in built against
+ *      the earlier layout must be rebuilt; it can check baseDataVersion against
+ *      kQ3FFormatBaseDataVersion to detect the mismatch. Earlier versions of
+ *      Quesa left baseDataVersion set to 0.
+ *
+ *  @field baseDataVersion           The base data version, set to kQ3FFormatBaseDataVersion.
  *  @field storage                   The storage object.
  *  @field currentStoragePosition    The current position within the storage object.
+ *                                   This is 64 bits wide, so storage larger than 4GB
+ *                                   can be read and written.
  *  @field logicalEOF                The number of bytes in the storage object.
  */
 typedef struct TQ3FFormatBaseData {
     // Initialised by Quesa
     TQ3Uns32                                    baseDataVersion;
     TQ3StorageObject _Nonnull                   storage;
-    TQ3Uns32                                    currentStoragePosition;
-    TQ3Uns32                                    logicalEOF;
+    uint64_t                                    currentStoragePosition;
+    uint64_t                                    logicalEOF;
 
 
     // Initialised by the importer
@@ -3355,6 +3515,126 @@ Q3Uns8_ReadArray (
 #endif // QUESA_ALLOW_QD3D_EXTENSIONS
 
 
+
+/*!
+ *  @function
+ *      Q3Float32_WriteArray
+ *  @discussion
+ *      Write an array of 32-bit floating point numbers to a file object.
+ *
+ *      Calling this function has much less overhead than calling
+ *      Q3Float32_Write repeatedly, since formats which support it write
+ *      the whole array with a single storage write.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param	numFloats		Number of numbers to write.
+ *  @param	floatArray		Address of the numbers to write.
+ *	@param	theFile			A file object.
+ *  @result    Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Float32_WriteArray (
+	TQ3Uns32					numFloats,
+	const TQ3Float32*	_Nonnull		floatArray,
+	TQ3FileObject _Nonnull          	theFile
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Uns32_WriteArray
+ *  @discussion
+ *      Write an array of 32-bit unsigned integers to a file object.
+ *
+ *      Calling this function has much less overhead than calling
+ *      Q3Uns32_Write repeatedly, since formats which support it write
+ *      the whole array with a single storage write.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param	numNums			Number of numbers to write.
+ *  @param	intArray		Address of the numbers to write.
+ *	@param	theFile			A file object.
+ *  @result    Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Uns32_WriteArray (
+	TQ3Uns32					numNums,
+	const TQ3Uns32*	_Nonnull		intArray,
+	TQ3FileObject _Nonnull          	theFile
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Uns16_WriteArray
+ *  @discussion
+ *      Write an array of 16-bit unsigned integers to a file object.
+ *
+ *      Calling this function has much less overhead than calling
+ *      Q3Uns16_Write repeatedly, since formats which support it write
+ *      the whole array with a single storage write.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param	numNums			Number of numbers to write.
+ *  @param	intArray		Address of the numbers to write.
+ *	@param	theFile			A file object.
+ *  @result    Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Uns16_WriteArray (
+	TQ3Uns32					numNums,
+	const TQ3Uns16*	_Nonnull		intArray,
+	TQ3FileObject _Nonnull          	theFile
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Uns8_WriteArray
+ *  @discussion
+ *      Write an array of 8-bit unsigned integers to a file object.
+ *
+ *      Calling this function has much less overhead than calling
+ *      Q3Uns8_Write repeatedly, since formats which support it write
+ *      the whole array with a single storage write.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param	numNums			Number of numbers to write.
+ *  @param	intArray		Address of the numbers to write.
+ *	@param	theFile			A file object.
+ *  @result    Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Uns8_WriteArray (
+	TQ3Uns32					numNums,
+	const TQ3Uns8*	_Nonnull		intArray,
+	TQ3FileObject _Nonnull          	theFile
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
 /*!
 	@functiongroup View Hints
 */
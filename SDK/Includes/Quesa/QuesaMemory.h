@@ -76,7 +76,7 @@ extern "C" {
 	@constant	kQ3MemoryStatisticsStructureVersion
 	@abstract	Current version of TQ3MemoryStatistics structure.
 */
-#define	kQ3MemoryStatisticsStructureVersion	1
+#define	kQ3MemoryStatisticsStructureVersion	2
 
 
 
@@ -95,6 +95,13 @@ extern "C" {
 	@field		currentBytes		Current number of memory bytes allocated by Quesa.
 	@field		maxBytes			Maximum number of memory bytes allocated by Quesa
 									("high-water mark").
+	@field		poolAllocations		Current number of objects allocated from Quesa's
+									object pools.  Version 2 and later.
+	@field		poolCapacity		Number of objects the object pools can hold without
+									growing.  Version 2 and later.
+	@field		poolBytes			Number of memory bytes held by the object pools.
+									These bytes are also counted in currentBytes.
+									Version 2 and later.
 */
 typedef struct TQ3MemoryStatistics
 {
@@ -103,6 +110,9 @@ typedef struct TQ3MemoryStatistics
 	TQ3Uns32	maxAllocations;
 	TQ3Int64	currentBytes;
 	TQ3Int64	maxBytes;
+	TQ3Uns32	poolAllocations;
+	TQ3Uns32	poolCapacity;
+	TQ3Int64	poolBytes;
 } TQ3MemoryStatistics;
 
 
@@ -516,6 +526,9 @@ Q3Memory_DumpRecording(
  *
  *      <em>This function is not available in QD3D.</em>
  *
+ *		Structures initialized to version 1 receive every field except the
+ *		object pool occupancy.
+ *
  *	@param		info		Structure to receive memory statistics.  You must initialize
  *							the structureVersion field to kQ3MemoryStatisticsStructureVersion.
  *	@result		Success or failure of the operation.
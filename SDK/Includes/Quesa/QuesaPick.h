@@ -192,6 +192,11 @@ typedef TQ3Uns32 TQ3PickDetail;
  *  @field mask             The type of pick information to be returned.
  *  @field numHitsToReturn  The number of hits to return. Set to <code>kQ3ReturnAllHits</code>
  *                          to retrieve all hits.
+ *
+ *                          If only the nearest hit is requested (a <code>sort</code> of
+ *                          <code>kQ3PickSortNearToFar</code> and a <code>numHitsToReturn</code>
+ *                          of 1), the pick keeps just its nearest hit and objects which lie
+ *                          farther away are skipped without being tested.
  */
 typedef struct TQ3PickData {
     TQ3PickSort                                 sort;
@@ -257,6 +262,56 @@ typedef struct TQ3WorldRayPickData {
 } TQ3WorldRayPickData;
 
 
+/*!
+ *  @struct
+ *      TQ3WorldRayBatchPickData
+ *  @discussion
+ *      Describes the state for a world-ray batch pick object.
+ *
+ *      A batch pick traces many world rays through a single traversal
+ *      of the scene, and keeps the nearest hit of each ray.  Only exact
+ *      hits on Triangle and TriMesh geometries are reported.
+ *
+ *  @field data             The common state for the pick.  Only the
+ *                          kQ3PickDetailMaskPickID flag of the mask is
+ *                          used, the sort and hit count are ignored.
+ *  @field numRays          The number of rays in the rays array.
+ *  @field rays             The pick rays in world coordinates.  The rays
+ *                          are copied by the pick object.
+ */
+typedef struct TQ3WorldRayBatchPickData {
+    TQ3PickData                                 data;
+    TQ3Uns32                                    numRays;
+    const TQ3Ray3D                              * _Nullable rays;
+} TQ3WorldRayBatchPickData;
+
+
+/*!
+ *  @struct
+ *      TQ3WorldRayBatchHit
+ *  @discussion
+ *      The nearest hit of one ray of a world-ray batch pick.
+ *
+ *  @field didHit               Whether the ray hit anything.  The other
+ *                              fields are only valid if this is kQ3True.
+ *  @field hitDistance          The world-space distance from the ray origin
+ *                              to the hit.
+ *  @field hitXYZ               The world-space hit point.
+ *  @field hitTriMeshFaceIndex  The index of the TriMesh face that was hit,
+ *                              or kQ3ArrayIndexNULL if the hit was not on
+ *                              a TriMesh.
+ *  @field pickedID             The pick ID of the hit object, if the pick
+ *                              mask includes kQ3PickDetailMaskPickID.
+ */
+typedef struct TQ3WorldRayBatchHit {
+    TQ3Boolean                                  didHit;
+    float                                       hitDistance;
+    TQ3Point3D                                  hitXYZ;
+    TQ3Uns32                                    hitTriMeshFaceIndex;
+    TQ3Uns32                                    pickedID;
+} TQ3WorldRayBatchHit;
+
+
 /*!
  *  @struct
  *      TQ3HitPath
@@ -777,6 +832,57 @@ Q3WindowRectPick_SetData (
 );
 
 
+
+/*!
+ *  @function
+ *      Q3WindowRectPick_SetVisibleOnly
+ *  @discussion
+ *      Choose whether a window-rect pick only reports visible objects.
+ *
+ *      By default a window-rect pick reports every object which overlaps
+ *      the pick rect, whether or not it is hidden behind other objects.
+ *
+ *      In visible-only mode, Triangle and TriMesh geometries are drawn
+ *      into a small depth-tested ID buffer covering the pick rect, and
+ *      only those which are visible in the buffer are reported.  The
+ *      buffer is at most 128 cells on a side, so the cost depends on the
+ *      size of the rect rather than on the number of triangles, and
+ *      objects smaller than a cell of a large rect may be missed.  The
+ *      hit position and TriMesh face of each hit are taken from its
+ *      nearest visible cell.  Other geometries are picked as before.
+ *
+ *      Visible-only mode is not supported by the fisheye and all-seeing
+ *      cameras, which are picked as before.
+ *
+ *  @param pick             The pick object to update.
+ *  @param visibleOnly      Whether to only report visible objects.
+ *  @result                 Success or failure of the operation.
+ */
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WindowRectPick_SetVisibleOnly (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Boolean                            visibleOnly
+);
+
+
+
+/*!
+ *  @function
+ *      Q3WindowRectPick_GetVisibleOnly
+ *  @discussion
+ *      Find whether a window-rect pick only reports visible objects.
+ *
+ *  @param pick             The pick object to query.
+ *  @param visibleOnly      Receives whether the pick only reports visible objects.
+ *  @result                 Success or failure of the operation.
+ */
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WindowRectPick_GetVisibleOnly (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Boolean                    * _Nonnull visibleOnly
+);
+
+
 /*!
 	@functiongroup	World Ray Picking
 */
@@ -868,6 +974,95 @@ Q3WorldRayPick_SetData (
     const TQ3WorldRayPickData     * _Nonnull data
 );
 
+
+
+/*!
+	@functiongroup	World Ray Batch Picking
+*/
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_New
+ *  @discussion
+ *      Create a new world-ray batch pick object.
+ *
+ *      A batch pick is submitted like any other pick, but instead of a hit
+ *      list it collects the nearest hit of each of its rays.  Rays which
+ *      miss the bounding box of a display group or TriMesh are not tested
+ *      against its contents.
+ *
+ *  @param data             The data for the pick object.
+ *  @result                 The new pick object.
+ */
+Q3_EXTERN_API_C ( TQ3PickObject _Nullable )
+Q3WorldRayBatchPick_New (
+    const TQ3WorldRayBatchPickData * _Nonnull data
+);
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_SetRays
+ *  @discussion
+ *      Replace the rays of a world-ray batch pick object.
+ *
+ *      The hits of the previous rays are discarded.
+ *
+ *  @param pick             The pick object to update.
+ *  @param numRays          The number of rays.
+ *  @param rays             The new rays for the pick object, in world
+ *                          coordinates.
+ *  @result                 Success or failure of the operation.
+ */
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_SetRays (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Uns32                              numRays,
+    const TQ3Ray3D                * _Nullable rays
+);
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_GetNumRays
+ *  @discussion
+ *      Get the number of rays of a world-ray batch pick object.
+ *
+ *  @param pick             The pick object to query.
+ *  @param numRays          Receives the number of rays.
+ *  @result                 Success or failure of the operation.
+ */
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_GetNumRays (
+    TQ3PickObject _Nonnull                pick,
+    TQ3Uns32                      * _Nonnull numRays
+);
+
+
+
+/*!
+ *  @function
+ *      Q3WorldRayBatchPick_GetHits
+ *  @discussion
+ *      Get the nearest hit of each ray of a world-ray batch pick object.
+ *
+ *      Hits are kept until Q3Pick_EmptyHitList is called or the rays are
+ *      changed, so a scene may be picked in several passes, with each pass
+ *      only replacing hits which it finds to be nearer.
+ *
+ *  @param pick             The pick object to query.
+ *  @param hits             Receives one hit per ray, in the order of
+ *                          the rays.
+ *  @result                 Success or failure of the operation.
+ */
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3WorldRayBatchPick_GetHits (
+    TQ3PickObject _Nonnull                pick,
+    TQ3WorldRayBatchHit           * _Nonnull hits
+);
+
 /*!
 	@functiongroup	Object Parts
 */
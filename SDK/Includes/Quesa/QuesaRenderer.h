@@ -448,6 +448,24 @@ typedef enum TQ3XDrawContextValidationMasks QUESA_ENUM_BASE(TQ3Uns32) {
 } TQ3XDrawContextValidationMasks;
 
 
+/*!
+ *  @enum
+ *      TQ3XViewUploadType
+ *  @discussion
+ *      Kinds of data a renderer can report uploading with Q3XView_RecordUpload.
+ *
+ *  @constant kQ3XViewUploadTypeBuffer      Vertex or index buffer data.
+ *  @constant kQ3XViewUploadTypeTexture     Texture image data.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+typedef enum TQ3XViewUploadType QUESA_ENUM_BASE(TQ3Uns32) {
+    kQ3XViewUploadTypeBuffer                    = 0,
+    kQ3XViewUploadTypeTexture                   = 1,
+    kQ3XViewUploadTypeSize32                    = 0xFFFFFFFF
+} TQ3XViewUploadType;
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
 /*!
  *  @enum
  *      TQ3XMethodTypeRenderer
@@ -1866,6 +1884,38 @@ Q3XView_EndFrame (
 
 
 
+/*!
+ *  @function
+ *      Q3XView_RecordUpload
+ *  @discussion
+ *      Record data uploaded by a renderer in the view's frame statistics.
+ *
+ *      Does nothing unless frame statistics have been turned on with
+ *      Q3View_SetFrameStatisticsState, so renderers may call it for every
+ *      upload.
+ *
+ *      This function should only be called from renderer plug-ins.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param view             The view being rendered.
+ *  @param uploadType       The kind of data uploaded.
+ *  @param numBytes         The number of bytes uploaded.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3XView_RecordUpload (
+    TQ3ViewObject _Nonnull                view,
+    TQ3XViewUploadType            uploadType,
+    TQ3Uns32                      numBytes
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
  *  @function
  *      Q3XDrawContext_ClearValidationFlags
@@ -212,6 +212,104 @@ Q3Storage_SetData (
 
 
 
+/*!
+ *  @function
+ *      Q3Storage_GetSize64
+ *  @discussion
+ *      Get the size of the data in a storage object, as a 64-bit value.
+ *
+ *      Equivalent to Q3Storage_GetSize, but can describe storage larger
+ *      than 4GB. Q3Storage_GetSize fails with kQ3ErrorNotSupported for
+ *      such storage rather than returning a truncated size.
+ *
+ *      Memory storage is limited to 4GB, but can still be used with the
+ *      64-bit functions.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param storage          The storage object.
+ *  @param size             On output, receives the size.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Storage_GetSize64 (
+    TQ3StorageObject _Nonnull             storage,
+    uint64_t                      * _Nonnull size
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Storage_GetData64
+ *  @discussion
+ *      Read some data from a storage object, at a 64-bit offset.
+ *
+ *      Equivalent to Q3Storage_GetData, but can read beyond the first 4GB
+ *      of a storage object.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param storage          The storage object.
+ *  @param offset           Starting offset of the data to be retrieved.
+ *  @param dataSize         Number of bytes of data to get.
+ *  @param data             Buffer to receive the data.
+ *  @param sizeRead         On output, number of bytes actually received.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Storage_GetData64 (
+    TQ3StorageObject _Nonnull             storage,
+    uint64_t                      offset,
+    TQ3Uns32                      dataSize,
+    unsigned char                 * _Nonnull data,
+    TQ3Uns32                      * _Nonnull sizeRead
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3Storage_SetData64
+ *  @discussion
+ *      Write some data to a storage object, at a 64-bit offset.
+ *
+ *      Equivalent to Q3Storage_SetData, but can write beyond the first 4GB
+ *      of a storage object.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param storage          The storage object.
+ *  @param offset           The offset at which to begin writing new data.
+ *  @param dataSize         Number of bytes of data to be written.
+ *  @param data             Data to be written.
+ *  @param sizeWritten      On output, number of bytes actually written,
+ *							normally the same as dataSize.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3Storage_SetData64 (
+    TQ3StorageObject _Nonnull             storage,
+    uint64_t                      offset,
+    TQ3Uns32                      dataSize,
+    const unsigned char           * _Nonnull data,
+    TQ3Uns32                      * _Nonnull sizeWritten
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
 	@function			Q3Storage_Open
 	@abstract			Open a storage for reading or writing of raw data.
@@ -636,6 +734,175 @@ Q3FileStreamStorage_Set (
 
 
 
+/*!
+	@functiongroup Read-Ahead Storage
+*/
+
+
+/*!
+	@function	Q3ReadAheadStorage_New
+	@abstract	Create a storage object which reads ahead of another storage.
+	
+	@discussion	While a read-ahead storage is open for reading, a background
+				thread keeps a ring of chunks of the source storage filled
+				ahead of the reader, so that I/O overlaps with decoding.
+				Reads which continue on from the previous read keep half the
+				ring queued ahead; after a seek only the next chunk is queued
+				until the reader carries on from there.
+				
+				Opening and closing the read-ahead storage opens and closes
+				the source. When opened for writing, all data is passed
+				straight through to the source.
+				
+				The source is only used by one thread at a time, but you
+				should not use it directly while the read-ahead storage is
+				open.
+				
+				<em>This function is not available in QD3D.</em>
+	
+	@param		theSource		The storage to read from. A new reference
+								is taken to it.
+	@param		chunkSize		The size of each chunk in bytes, or 0 for
+								the default of 256K.
+	@param		numChunks		The number of chunks in the ring, or 0 for
+								the default of 8.
+	@result		The new storage object.
+*/
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3StorageObject _Nullable )
+Q3ReadAheadStorage_New (
+    TQ3StorageObject _Nonnull             theSource,
+    TQ3Uns32                              chunkSize,
+    TQ3Uns32                              numChunks
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+	@function	Q3ReadAheadStorage_GetSource
+	@discussion	Get the storage which a read-ahead storage reads from.
+	
+				<em>This function is not available in QD3D.</em>
+	
+	@param		theStorage		A read-ahead storage object.
+	@param		theSource		Receives a new reference to the source storage.
+	@result		Success or failure of the operation.
+*/
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3ReadAheadStorage_GetSource (
+    TQ3StorageObject _Nonnull             theStorage,
+    TQ3StorageObject _Nullable * _Nonnull theSource
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+	@function	Q3ReadAheadStorage_Hint
+	@discussion	Tell a read-ahead storage that a range will be read soon, for
+				example the location of an object found in a table of
+				contents. The range is queued behind any reads already
+				pending, and is limited to half the ring.
+				
+				Hints are ignored unless the storage is open for reading.
+				
+				<em>This function is not available in QD3D.</em>
+	
+	@param		theStorage		A read-ahead storage object.
+	@param		offset			The offset of the range.
+	@param		dataSize		The size of the range.
+	@result		Success or failure of the operation.
+*/
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3ReadAheadStorage_Hint (
+    TQ3StorageObject _Nonnull             theStorage,
+    uint64_t                              offset,
+    TQ3Uns32                              dataSize
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+	@functiongroup Compressed Storage
+*/
+
+
+/*!
+	@function	Q3CompressedStorage_New
+	@abstract	Create a storage object which compresses its data into another
+				storage.
+	
+	@discussion	The data is split into fixed-size blocks, each compressed on
+				its own in the LZ4 block format, with an index of the blocks
+				at the end of the source. Any offset within the data maps to
+				a block and an offset within that block, so readers can seek
+				freely (e.g., to objects found in a 3DMF table of contents)
+				and only the blocks they touch are expanded. When reading
+				sequentially, the next block is expanded on a worker thread
+				while the current one is used.
+				
+				Data written to the storage only becomes readable by a new
+				reader once the storage is closed, since that is when the
+				index is written. Opening the storage for reading fails with
+				kQ3ErrorInvalidMetafile if the source does not hold a
+				compressed container.
+				
+				To overlap network or disk reads with expansion as well,
+				use a read-ahead storage as the source.
+				
+				<em>This function is not available in QD3D.</em>
+	
+	@param		theSource		The storage which holds the compressed data.
+								A new reference is taken to it.
+	@param		blockSize		The uncompressed size of each block when
+								writing, or 0 for the default of 64K. When
+								reading, the size recorded in the data is used.
+	@result		The new storage object.
+*/
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3StorageObject _Nullable )
+Q3CompressedStorage_New (
+    TQ3StorageObject _Nonnull             theSource,
+    TQ3Uns32                              blockSize
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+	@function	Q3CompressedStorage_GetSource
+	@discussion	Get the storage which holds the data of a compressed storage.
+	
+				<em>This function is not available in QD3D.</em>
+	
+	@param		theStorage		A compressed storage object.
+	@param		theSource		Receives a new reference to the source storage.
+	@result		Success or failure of the operation.
+*/
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3CompressedStorage_GetSource (
+    TQ3StorageObject _Nonnull             theStorage,
+    TQ3StorageObject _Nullable * _Nonnull theSource
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 
 
 
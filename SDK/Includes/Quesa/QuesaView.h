@@ -116,6 +116,14 @@ typedef enum TQ3ViewStatus QUESA_ENUM_BASE(TQ3Uns32) {
 #define kQ3ViewDefaultSubdivisionC2             20.0f
 
 
+/*!
+ *  @constant kQ3ViewFrameStatisticsStructureVersion
+ *  @discussion
+ *      Current version of the TQ3ViewFrameStatistics structure.
+ */
+#define kQ3ViewFrameStatisticsStructureVersion  1
+
+
 
 
 
@@ -170,6 +178,69 @@ typedef Q3_CALLBACK_API_C(void,                TQ3ViewEndFrameMethod)(
                             void                * _Nonnull endFrameData);
 
 
+/*!
+ *  @struct
+ *      TQ3ViewFrameStatistics
+ *  @discussion
+ *      Parameter structure for Q3View_GetFrameStatistics.
+ *
+ *      Counts are accumulated over every pass of a rendering loop, from the
+ *      first call to Q3View_StartRendering until Q3View_EndRendering returns
+ *      kQ3ViewStatusDone.
+ *
+ *  @field structureVersion         Version of this structure. Initialize to
+ *                                  kQ3ViewFrameStatisticsStructureVersion.
+ *  @field numPasses                Number of rendering passes.
+ *  @field objectsSubmitted         Number of objects submitted, in retained
+ *                                  or immediate mode.
+ *  @field groupsSubmitted          Number of display groups traversed.
+ *  @field groupsCulled             Number of display groups skipped because
+ *                                  their bounding box was not visible.
+ *  @field statePushes              Number of pushes of the view state stack.
+ *  @field cacheRebuilds            Number of geometry caches rebuilt.
+ *  @field buffersUploaded          Number of vertex buffers uploaded by the
+ *                                  renderer.
+ *  @field bufferBytesUploaded      Number of bytes of vertex buffer data
+ *                                  uploaded by the renderer.
+ *  @field texturesUploaded         Number of textures uploaded by the renderer.
+ *  @field textureBytesUploaded     Number of bytes of texture data uploaded by
+ *                                  the renderer.
+ *  @field elapsedMilliseconds      Wall clock time taken by the frame.
+ */
+typedef struct TQ3ViewFrameStatistics {
+    TQ3Uns32                                    structureVersion;
+    TQ3Uns32                                    numPasses;
+    TQ3Uns32                                    objectsSubmitted;
+    TQ3Uns32                                    groupsSubmitted;
+    TQ3Uns32                                    groupsCulled;
+    TQ3Uns32                                    statePushes;
+    TQ3Uns32                                    cacheRebuilds;
+    TQ3Uns32                                    buffersUploaded;
+    TQ3Uns32                                    bufferBytesUploaded;
+    TQ3Uns32                                    texturesUploaded;
+    TQ3Uns32                                    textureBytesUploaded;
+    float                                       elapsedMilliseconds;
+} TQ3ViewFrameStatistics;
+
+
+/*!
+ *  @struct
+ *      TQ3ViewTypeStatistics
+ *  @discussion
+ *      Per-type counts returned by Q3View_GetFrameTypeStatistics.
+ *
+ *  @field objectType               The leaf type of the objects counted.
+ *  @field objectsSubmitted         Number of objects of this type submitted.
+ *  @field cacheRebuilds            Number of geometry caches of this type
+ *                                  rebuilt.
+ */
+typedef struct TQ3ViewTypeStatistics {
+    TQ3ObjectType                               objectType;
+    TQ3Uns32                                    objectsSubmitted;
+    TQ3Uns32                                    cacheRebuilds;
+} TQ3ViewTypeStatistics;
+
+
 
 
 
@@ -817,6 +888,103 @@ Q3View_AllowAllGroupCulling (
 
 
 
+/*!
+ *  @function
+ *      Q3View_SetFrameStatisticsState
+ *  @discussion
+ *      Turn the collection of frame statistics on or off.
+ *
+ *      Statistics are off by default, in which case collecting them costs
+ *      a pointer test per counted event. Turning statistics on takes effect
+ *      from the start of the next frame.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param view             The view to update.
+ *  @param isEnabled        Whether statistics should be collected.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3View_SetFrameStatisticsState (
+    TQ3ViewObject _Nonnull                view,
+    TQ3Boolean                    isEnabled
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3View_GetFrameStatistics
+ *  @discussion
+ *      Get the statistics for the most recent frame rendered by a view.
+ *
+ *      If called within a rendering loop, the counts for the frame so far
+ *      are returned and elapsedMilliseconds is 0.
+ *
+ *      Fails if statistics collection has not been turned on with
+ *      Q3View_SetFrameStatisticsState.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param view             The view to query.
+ *  @param statistics       Receives the statistics.  You must initialize the
+ *                          structureVersion field to
+ *                          kQ3ViewFrameStatisticsStructureVersion.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3View_GetFrameStatistics (
+    TQ3ViewObject _Nonnull                view,
+    TQ3ViewFrameStatistics        * _Nonnull statistics
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
+/*!
+ *  @function
+ *      Q3View_GetFrameTypeStatistics
+ *  @discussion
+ *      Get the per-type breakdown of the statistics for the most recent
+ *      frame rendered by a view.
+ *
+ *      Types are returned in the order they were first counted within the
+ *      frame. If the array is too small to hold every type, the first
+ *      maxTypes types are returned; numTypes always receives the total.
+ *      Pass 0 and nullptr to query the number of types.
+ *
+ *      Fails if statistics collection has not been turned on with
+ *      Q3View_SetFrameStatisticsState.
+ *
+ *      <em>This function is not available in QD3D.</em>
+ *
+ *  @param view             The view to query.
+ *  @param maxTypes         The number of entries in typeStatistics.
+ *  @param numTypes         Receives the number of types counted in the frame.
+ *  @param typeStatistics   Receives the per-type statistics.
+ *  @result                 Success or failure of the operation.
+ */
+#if QUESA_ALLOW_QD3D_EXTENSIONS
+
+Q3_EXTERN_API_C ( TQ3Status  )
+Q3View_GetFrameTypeStatistics (
+    TQ3ViewObject _Nonnull                view,
+    TQ3Uns32                      maxTypes,
+    TQ3Uns32                      * _Nonnull numTypes,
+    TQ3ViewTypeStatistics         * _Nullable typeStatistics
+);
+
+#endif // QUESA_ALLOW_QD3D_EXTENSIONS
+
+
+
 /*!
  *  @function
  *      Q3View_TransformLocalToWorld